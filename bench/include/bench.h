@@ -0,0 +1,39 @@
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define BENCH_NS_PER_S 1000000000.0
+
+/**
+ * An `Allocator` which counts calls and memory into `counters`
+ * (a `BenchCounters *`), only usable where cap.h is included.
+ */
+#define BENCH_COUNTING_ALLOCATOR(counters) ((Allocator) { \
+    bench_counting_alloc, bench_counting_realloc, bench_counting_free, \
+    (counters) })
+
+/**
+ * Statistics gathered by the counting allocator.
+ */
+typedef struct {
+    /// number of allocations and reallocations
+    size_t mAllocations;
+    /// bytes currently allocated
+    size_t mLiveBytes;
+    /// largest value of `mLiveBytes` so far, may be reset by the caller
+    size_t mPeakBytes;
+} BenchCounters;
+
+uint64_t bench_now_ns();
+void bench_record(
+    const char * name, const char * metric, double value, const char * unit);
+void bench_consume(const void * pointer);
+long bench_peak_rss_kb();
+void bench_reset_peak_rss();
+void * bench_counting_alloc(size_t size, void * context);
+void * bench_counting_realloc(void * memory, size_t size, void * context);
+void bench_counting_free(void * memory, void * context);
+
+#endif
@@ -0,0 +1,113 @@
+#define _XOPEN_SOURCE 700
+
+#include "bench.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <time.h>
+
+// every block is prefixed with its size, so that freed bytes can be counted
+typedef union {
+    size_t mSize;
+    long double mAlign;
+} BlockHeader;
+
+static void _bench_count(BenchCounters * counters, size_t size) {
+    ++counters -> mAllocations;
+    counters -> mLiveBytes += size;
+    if (counters -> mLiveBytes > counters -> mPeakBytes) {
+        counters -> mPeakBytes = counters -> mLiveBytes;
+    }
+}
+
+uint64_t bench_now_ns() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t) t.tv_sec * 1000000000u + (uint64_t) t.tv_nsec;
+}
+
+void bench_record(
+        const char * name, const char * metric, double value,
+        const char * unit) {
+    // one JSON object per line, so results can be collected and compared
+    // across versions by other tools
+    printf(
+        "{\"bench\": \"%s\", \"metric\": \"%s\", \"value\": %.3f, "
+        "\"unit\": \"%s\"}\n", name, metric, value, unit);
+}
+
+void bench_consume(const void * pointer) {
+    // the value escapes through a volatile, so the compiler cannot drop the
+    // work that produced it
+    static const void * volatile sink;
+    sink = pointer;
+    (void) sink;
+}
+
+long bench_peak_rss_kb() {
+    // Linux reports the peak which `bench_reset_peak_rss` resets here
+    FILE * file = fopen("/proc/self/status", "r");
+    if (file) {
+        char line[256];
+        long peak = -1;
+        while (fgets(line, sizeof(line), file)) {
+            if (sscanf(line, "VmHWM: %ld kB", &peak) == 1) {
+                break;
+            }
+        }
+        fclose(file);
+        if (peak >= 0) {
+            return peak;
+        }
+    }
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage)) {
+        return -1;
+    }
+    // kilobytes on Linux, bytes on macOS
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+void bench_reset_peak_rss() {
+    // Linux resets the peak to the current resident set size when "5" is
+    // written to this file. Elsewhere, the peak of the whole process is kept.
+    FILE * file = fopen("/proc/self/clear_refs", "w");
+    if (file) {
+        fputs("5", file);
+        fclose(file);
+    }
+}
+
+void * bench_counting_alloc(size_t size, void * context) {
+    BlockHeader * block = (BlockHeader *) malloc(sizeof(BlockHeader) + size);
+    block -> mSize = size;
+    _bench_count((BenchCounters *) context, size);
+    return block + 1;
+}
+
+void * bench_counting_realloc(void * memory, size_t size, void * context) {
+    if (!memory) {
+        return bench_counting_alloc(size, context);
+    }
+    BlockHeader * block = (BlockHeader *) memory - 1;
+    ((BenchCounters *) context) -> mLiveBytes -= block -> mSize;
+    block = (BlockHeader *) realloc(block, sizeof(BlockHeader) + size);
+    block -> mSize = size;
+    _bench_count((BenchCounters *) context, size);
+    return block + 1;
+}
+
+void bench_counting_free(void * memory, void * context) {
+    if (!memory) {
+        return;
+    }
+    BlockHeader * block = (BlockHeader *) memory - 1;
+    ((BenchCounters *) context) -> mLiveBytes -= block -> mSize;
+    free(block);
+}
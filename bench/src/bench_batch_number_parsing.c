@@ -0,0 +1,133 @@
+#include "cap.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Converts a command line of a million numeric words in batches, using each
+ * instruction set which the processor supports, and parses the same words as
+ * variadic `DT_INT` and `DT_DOUBLE` positionals.
+ */
+
+#define WORD_COUNT 1000000
+#define WORD_SIZE 24u
+#define ITERATIONS 5
+
+static uint64_t _random_state = 0x9e3779b97f4a7c15u;
+
+static uint64_t _random() {
+    // xorshift64*
+    _random_state ^= _random_state >> 12;
+    _random_state ^= _random_state << 25;
+    _random_state ^= _random_state >> 27;
+    return _random_state * 2685821657736338717u;
+}
+
+static void _make_argv(const char ** argv, char * storage, bool doubles) {
+    argv[0] = "prog";
+    for (int i = 1; i < WORD_COUNT; ++i) {
+        char * word = storage + (size_t) i * WORD_SIZE;
+        const uint64_t r = _random();
+        if (doubles) {
+            // fixed-point values like coordinates and weights
+            snprintf(
+                word, WORD_SIZE, "%.*f", (int) (r % 7u),
+                (double) (r >> 20) / (double) (1u << 24));
+        } else {
+            snprintf(word, WORD_SIZE, "%d", (int) (r >> 33) >> (r % 24u));
+        }
+        argv[i] = word;
+    }
+}
+
+static void _report(const char * name, uint64_t best) {
+    bench_record(name, "ns_per_word", (double) best / WORD_COUNT, "ns");
+    bench_record(
+        name, "throughput", WORD_COUNT / ((double) best / BENCH_NS_PER_S) / 1e6,
+        "Mwords/s");
+}
+
+static void _run_conversion(
+        const char ** argv, const char * limit, bool doubles,
+        _CapSimdLevel level) {
+    static const char * NAMES[2][3] = {
+        {
+            "batch int parsing: scalar", "batch int parsing: SSE4.1",
+            "batch int parsing: AVX2"
+        },
+        {
+            "batch double parsing: scalar", "batch double parsing: SSE4.1",
+            "batch double parsing: AVX2"
+        }
+    };
+    static union {
+        int asInts[WORD_COUNT];
+        double asDoubles[WORD_COUNT];
+    } values;
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < ITERATIONS; ++i) {
+        WordConversionResult result;
+        const uint64_t start = bench_now_ns();
+        const size_t converted = doubles
+            ? _cap_parse_double_batch_with(
+                argv + 1, WORD_COUNT - 1, limit, values.asDoubles, &result,
+                level)
+            : _cap_parse_int_batch_with(
+                argv + 1, WORD_COUNT - 1, limit, values.asInts, &result,
+                level);
+        const uint64_t elapsed = bench_now_ns() - start;
+        if (converted != WORD_COUNT - 1) {
+            fprintf(
+                stderr, "bench: cannot convert '%s'\n", argv[converted + 1]);
+            exit(1);
+        }
+        bench_consume(&values);
+        best = elapsed < best ? elapsed : best;
+    }
+    _report(NAMES[doubles][level], best);
+}
+
+static void _run_parser(const char ** argv, bool doubles) {
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_enable_packed_values(p, true);
+    cap_parser_enable_exact_allocation(p, true);
+    cap_parser_add_positional(
+        p, "values", doubles ? DT_DOUBLE : DT_INT, true, true, NULL, NULL);
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < ITERATIONS; ++i) {
+        const uint64_t start = bench_now_ns();
+        ParsingResult res = cap_parser_parse_noexit(p, WORD_COUNT, argv);
+        const uint64_t elapsed = bench_now_ns() - start;
+        if (res.mError != PER_NO_ERROR) {
+            fprintf(stderr, "bench: parsing failed\n");
+            exit(1);
+        }
+        bench_consume(res.mArguments);
+        cap_pa_destroy(res.mArguments);
+        best = elapsed < best ? elapsed : best;
+    }
+    cap_parser_destroy(p);
+    _report(doubles
+        ? "batch double parsing: variadic DT_DOUBLE positional"
+        : "batch int parsing: variadic DT_INT positional", best);
+}
+
+int main() {
+    const char ** argv = (const char **) malloc(
+        WORD_COUNT * sizeof(const char *));
+    char * storage = (char *) malloc((size_t) WORD_COUNT * WORD_SIZE);
+    for (int doubles = 0; doubles < 2; ++doubles) {
+        _make_argv(argv, storage, doubles);
+        for (int level = 0; level <= (int) _cap_simd_level(); ++level) {
+            _run_conversion(
+                argv, storage + (size_t) WORD_COUNT * WORD_SIZE, doubles,
+                (_CapSimdLevel) level);
+        }
+        _run_parser(argv, doubles);
+    }
+    free(storage);
+    free(argv);
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include "cap.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Measures shell completion of a generated program with many flags. A
+ * completion runs the program once, so the time of configuring the parser is
+ * measured together with completing one word. The time of completing a word
+ * with a parser which has already sorted its names is measured separately.
+ * Like generated programs would, the parser keeps its names without copying
+ * them.
+ */
+
+#define FLAG_COUNT 5000
+#define INVOCATION_COUNT 50
+#define COMPLETION_COUNT 10000
+#define ITERATIONS 5
+
+static char _flags[FLAG_COUNT][24];
+static char _aliases[FLAG_COUNT][24];
+
+static ArgumentParser * _make_parser() {
+    ArgumentParser * p = cap_parser_make_default();
+    cap_parser_enable_completion(p, true);
+    cap_parser_enable_static_strings(p, true);
+    for (int i = 0; i < FLAG_COUNT; ++i) {
+        cap_parser_add_flag(
+            p, _flags[i], i % 2 ? DT_STRING : DT_PRESENCE, 0, 1, NULL,
+            "a generated flag");
+        cap_parser_add_flag_alias(p, _flags[i], _aliases[i]);
+    }
+    return p;
+}
+
+int main() {
+    for (int i = 0; i < FLAG_COUNT; ++i) {
+        snprintf(_flags[i], sizeof(_flags[i]), "--generated-option%d", i);
+        snprintf(_aliases[i], sizeof(_aliases[i]), "-g%d", i);
+    }
+    FILE * file = fopen("/dev/null", "w");
+    if (!file) {
+        fprintf(stderr, "bench: cannot open /dev/null\n");
+        return 1;
+    }
+    const char * argv[3] = { "prog", "-v", "--generated-option12" };
+
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < ITERATIONS; ++i) {
+        const uint64_t start = bench_now_ns();
+        for (int j = 0; j < INVOCATION_COUNT; ++j) {
+            ArgumentParser * p = _make_parser();
+            cap_parser_complete(p, 3, argv, 2u, file);
+            cap_parser_destroy(p);
+        }
+        const uint64_t elapsed = bench_now_ns() - start;
+        best = elapsed < best ? elapsed : best;
+    }
+    bench_record(
+        "completion", "ns_per_invocation", (double) best / INVOCATION_COUNT,
+        "ns");
+
+    ArgumentParser * p = _make_parser();
+    best = UINT64_MAX;
+    for (int i = 0; i < ITERATIONS; ++i) {
+        const uint64_t start = bench_now_ns();
+        for (int j = 0; j < COMPLETION_COUNT; ++j) {
+            cap_parser_complete(p, 3, argv, 2u, file);
+        }
+        const uint64_t elapsed = bench_now_ns() - start;
+        best = elapsed < best ? elapsed : best;
+    }
+    cap_parser_destroy(p);
+    fclose(file);
+    bench_record(
+        "completion", "ns_per_completion", (double) best / COMPLETION_COUNT,
+        "ns");
+    return 0;
+}
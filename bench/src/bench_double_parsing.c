@@ -0,0 +1,147 @@
+#include "cap.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Converts hundreds of thousands of double words, using `sscanf` followed by
+ * `strlen` (as the parser used to), using `strtod`, and using the dedicated
+ * double parser, and parses the same words as a variadic `DT_DOUBLE`
+ * positional.
+ */
+
+#define WORD_COUNT 500000
+#define WORD_SIZE 32u
+#define ITERATIONS 5
+
+static uint64_t _random_state = 0x9e3779b97f4a7c15u;
+
+static uint64_t _random() {
+    // xorshift64*
+    _random_state ^= _random_state >> 12;
+    _random_state ^= _random_state << 25;
+    _random_state ^= _random_state >> 27;
+    return _random_state * 2685821657736338717u;
+}
+
+static void _make_argv(const char ** argv, char * storage) {
+    // typical simulation parameters: short fixed-point values, and values
+    // printed with full precision
+    argv[0] = "prog";
+    for (int i = 1; i < WORD_COUNT; ++i) {
+        char * word = storage + (size_t) i * WORD_SIZE;
+        const double v = (double) (_random() >> 11) / (double) (1ull << 53);
+        switch (i % 3) {
+            case 0:
+                snprintf(word, WORD_SIZE, "%.3f", v * 1000.0);
+                break;
+            case 1:
+                snprintf(word, WORD_SIZE, "%.17g", v);
+                break;
+            default:
+                snprintf(word, WORD_SIZE, "%.6e", v * 1e-5);
+                break;
+        }
+        argv[i] = word;
+    }
+}
+
+static bool _sscanf_double(const char * word, double * value) {
+    double v;
+    int c;
+    long long int n;
+    c = sscanf(word, "%lf%lln", &v, &n);
+    if (c != 1 || (unsigned long long int) n != strlen(word)) {
+        return false;
+    }
+    *value = v;
+    return true;
+}
+
+static void _report(const char * name, uint64_t best) {
+    bench_record(name, "ns_per_word", (double) best / WORD_COUNT, "ns");
+    bench_record(
+        name, "throughput", WORD_COUNT / ((double) best / BENCH_NS_PER_S) / 1e6,
+        "Mwords/s");
+}
+
+static bool _strtod_double(const char * word, double * value) {
+    char * end;
+    *value = strtod(word, &end);
+    return end != word && !*end;
+}
+
+static void _run_conversion(const char ** argv, int method) {
+    static const char * NAMES[] = {
+        "double parsing: sscanf and strlen",
+        "double parsing: strtod",
+        "double parsing: dedicated parser"
+    };
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < ITERATIONS; ++i) {
+        double sum = 0.0;
+        const uint64_t start = bench_now_ns();
+        for (int j = 1; j < WORD_COUNT; ++j) {
+            double v = 0.0;
+            bool ok;
+            switch (method) {
+                case 0:
+                    ok = _sscanf_double(argv[j], &v);
+                    break;
+                case 1:
+                    ok = _strtod_double(argv[j], &v);
+                    break;
+                default:
+                    ok = _cap_parse_double(argv[j], &v) == WCR_OK;
+                    break;
+            }
+            if (!ok) {
+                fprintf(stderr, "bench: cannot convert '%s'\n", argv[j]);
+                exit(1);
+            }
+            sum += v;
+        }
+        const uint64_t elapsed = bench_now_ns() - start;
+        bench_consume(&sum);
+        best = elapsed < best ? elapsed : best;
+    }
+    _report(NAMES[method], best);
+}
+
+static void _run_parser(const char ** argv) {
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_enable_exact_allocation(p, true);
+    cap_parser_add_positional(
+        p, "values", DT_DOUBLE, true, true, NULL, NULL);
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < ITERATIONS; ++i) {
+        const uint64_t start = bench_now_ns();
+        ParsingResult res = cap_parser_parse_noexit(p, WORD_COUNT, argv);
+        const uint64_t elapsed = bench_now_ns() - start;
+        if (res.mError != PER_NO_ERROR) {
+            fprintf(stderr, "bench: parsing failed\n");
+            exit(1);
+        }
+        bench_consume(res.mArguments);
+        cap_pa_destroy(res.mArguments);
+        best = elapsed < best ? elapsed : best;
+    }
+    cap_parser_destroy(p);
+    _report("double parsing: variadic DT_DOUBLE positional", best);
+}
+
+int main() {
+    const char ** argv = (const char **) malloc(
+        WORD_COUNT * sizeof(const char *));
+    char * storage = (char *) malloc((size_t) WORD_COUNT * WORD_SIZE);
+    _make_argv(argv, storage);
+    for (int method = 0; method < 3; ++method) {
+        _run_conversion(argv, method);
+    }
+    _run_parser(argv);
+    free(storage);
+    free(argv);
+    return 0;
+}
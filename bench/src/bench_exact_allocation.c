@@ -0,0 +1,69 @@
+#include "cap.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Parses a command line with a large variadic positional, with and without 
+ * exact allocation, and reports time and the memory owned by the results.
+ */
+
+#define WORD_COUNT 100000
+#define ITERATIONS 20
+
+static void _make_argv(const char ** argv, char * storage) {
+    argv[0] = "prog";
+    argv[1] = "--verbose";
+    for (int i = 2; i < WORD_COUNT; ++i) {
+        char * word = storage + (size_t) i * 16u;
+        snprintf(word, 16u, "file%07d.txt", i);
+        argv[i] = word;
+    }
+}
+
+static void _run(const char ** argv, bool exact, bool borrow) {
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_enable_exact_allocation(p, exact);
+    cap_parser_enable_borrowed_strings(p, borrow);
+    cap_parser_add_flag(p, "--verbose", DT_PRESENCE, 0, -1, NULL, NULL);
+    cap_parser_add_positional(p, "files", DT_STRING, true, true, NULL, NULL);
+
+    size_t arena_size = 0u;
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < ITERATIONS; ++i) {
+        const uint64_t start = bench_now_ns();
+        ParsingResult res = cap_parser_parse_noexit(p, WORD_COUNT, argv);
+        const uint64_t elapsed = bench_now_ns() - start;
+        if (res.mError != PER_NO_ERROR) {
+            fprintf(stderr, "bench: parsing failed\n");
+            exit(1);
+        }
+        bench_consume(res.mArguments);
+        arena_size = cap_arena_size(res.mArguments -> mArena);
+        cap_pa_destroy(res.mArguments);
+        best = elapsed < best ? elapsed : best;
+    }
+    cap_parser_destroy(p);
+
+    char name[64];
+    snprintf(
+        name, sizeof(name), "exact allocation: %s, %s strings", 
+        exact ? "two passes" : "one pass", borrow ? "borrowed" : "copied");
+    bench_record(name, "ns_per_word", (double) best / WORD_COUNT, "ns");
+    bench_record(name, "result_memory", arena_size / 1024.0, "KiB");
+}
+
+int main() {
+    const char ** argv = (const char **) malloc(
+        WORD_COUNT * sizeof(const char *));
+    char * storage = (char *) malloc((size_t) WORD_COUNT * 16u);
+    _make_argv(argv, storage);
+    for (int borrow = 0; borrow < 2; ++borrow) {
+        _run(argv, false, borrow);
+        _run(argv, true, borrow);
+    }
+    free(storage);
+    free(argv);
+    return 0;
+}
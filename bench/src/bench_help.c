@@ -0,0 +1,69 @@
+#include "cap.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Measures printing the help message and the usage string of a generated
+ * program with many flags. Unless they are prepared using
+ * `cap_parser_prepare_help`, each print renders the messages, prepared ones
+ * are only written.
+ */
+
+#define FLAG_COUNT 5000
+#define PRINT_COUNT 200
+#define ITERATIONS 5
+
+static char _flags[FLAG_COUNT][24];
+static char _aliases[FLAG_COUNT][24];
+
+static ArgumentParser * _make_parser() {
+    ArgumentParser * p = cap_parser_make_default();
+    cap_parser_set_description(p, "A generated program with many flags");
+    for (int i = 0; i < FLAG_COUNT; ++i) {
+        cap_parser_add_flag(
+            p, _flags[i], i % 2 ? DT_STRING : DT_PRESENCE, 0, 1, NULL,
+            "a generated flag");
+        cap_parser_add_flag_alias(p, _flags[i], _aliases[i]);
+    }
+    return p;
+}
+
+int main() {
+    for (int i = 0; i < FLAG_COUNT; ++i) {
+        snprintf(_flags[i], sizeof(_flags[i]), "--generated-option%d", i);
+        snprintf(_aliases[i], sizeof(_aliases[i]), "-g%d", i);
+    }
+    FILE * file = fopen("/dev/null", "w");
+    if (!file) {
+        fprintf(stderr, "bench: cannot open /dev/null\n");
+        return 1;
+    }
+
+    uint64_t rendered = UINT64_MAX;
+    uint64_t prepared = UINT64_MAX;
+    for (int i = 0; i < ITERATIONS; ++i) {
+        ArgumentParser * p = _make_parser();
+        uint64_t start = bench_now_ns();
+        cap_parser_print_usage(p, file, "prog");
+        cap_parser_print_help(p, file);
+        uint64_t elapsed = bench_now_ns() - start;
+        rendered = elapsed < rendered ? elapsed : rendered;
+
+        cap_parser_prepare_help(p);
+        start = bench_now_ns();
+        for (int j = 0; j < PRINT_COUNT; ++j) {
+            cap_parser_print_usage(p, file, "prog");
+            cap_parser_print_help(p, file);
+        }
+        elapsed = bench_now_ns() - start;
+        prepared = elapsed < prepared ? elapsed : prepared;
+        cap_parser_destroy(p);
+    }
+    fclose(file);
+    bench_record("help", "rendered_print", (double) rendered, "ns");
+    bench_record(
+        "help", "prepared_print", (double) prepared / PRINT_COUNT, "ns");
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include "cap.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Converts millions of integer words, using `sscanf` followed by `strlen` (as
+ * the parser used to) and using the dedicated integer parser, and parses the
+ * same words as a variadic `DT_INT` positional.
+ */
+
+#define WORD_COUNT 2000000
+#define WORD_SIZE 16u
+#define ITERATIONS 5
+
+static void _make_argv(const char ** argv, char * storage) {
+    argv[0] = "prog";
+    for (int i = 1; i < WORD_COUNT; ++i) {
+        char * word = storage + (size_t) i * WORD_SIZE;
+        switch (i % 4) {
+            case 0:
+                snprintf(word, WORD_SIZE, "%d", i);
+                break;
+            case 1:
+                snprintf(word, WORD_SIZE, "%d", i % 100);
+                break;
+            case 2:
+                snprintf(
+                    word, WORD_SIZE, "0x%x", (unsigned) i * 2654435761u >> 1);
+                break;
+            default:
+                snprintf(word, WORD_SIZE, "+%d", i * 977);
+                break;
+        }
+        argv[i] = word;
+    }
+}
+
+static bool _sscanf_int(const char * word, int * value) {
+    int v, c;
+    long long int n;
+    c = sscanf(word, "%i%lln", &v, &n);
+    if (c != 1 || (unsigned long long int) n != strlen(word)) {
+        return false;
+    }
+    *value = v;
+    return true;
+}
+
+static void _report(const char * name, uint64_t best) {
+    bench_record(name, "ns_per_word", (double) best / WORD_COUNT, "ns");
+    bench_record(
+        name, "throughput", WORD_COUNT / ((double) best / BENCH_NS_PER_S) / 1e6,
+        "Mwords/s");
+}
+
+static void _run_conversion(const char ** argv, bool use_sscanf) {
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < ITERATIONS; ++i) {
+        long long int sum = 0;
+        const uint64_t start = bench_now_ns();
+        for (int j = 1; j < WORD_COUNT; ++j) {
+            int v = 0;
+            const bool ok = use_sscanf
+                ? _sscanf_int(argv[j], &v)
+                : _cap_parse_int(argv[j], &v) == WCR_OK;
+            if (!ok) {
+                fprintf(stderr, "bench: cannot convert '%s'\n", argv[j]);
+                exit(1);
+            }
+            sum += v;
+        }
+        const uint64_t elapsed = bench_now_ns() - start;
+        bench_consume(&sum);
+        best = elapsed < best ? elapsed : best;
+    }
+    _report(use_sscanf
+        ? "int parsing: sscanf and strlen"
+        : "int parsing: dedicated parser", best);
+}
+
+static void _run_parser(const char ** argv) {
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_enable_exact_allocation(p, true);
+    cap_parser_add_positional(p, "nums", DT_INT, true, true, NULL, NULL);
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < ITERATIONS; ++i) {
+        const uint64_t start = bench_now_ns();
+        ParsingResult res = cap_parser_parse_noexit(p, WORD_COUNT, argv);
+        const uint64_t elapsed = bench_now_ns() - start;
+        if (res.mError != PER_NO_ERROR) {
+            fprintf(stderr, "bench: parsing failed\n");
+            exit(1);
+        }
+        bench_consume(res.mArguments);
+        cap_pa_destroy(res.mArguments);
+        best = elapsed < best ? elapsed : best;
+    }
+    cap_parser_destroy(p);
+    _report("int parsing: variadic DT_INT positional", best);
+}
+
+int main() {
+    const char ** argv = (const char **) malloc(
+        WORD_COUNT * sizeof(const char *));
+    char * storage = (char *) malloc((size_t) WORD_COUNT * WORD_SIZE);
+    _make_argv(argv, storage);
+    _run_conversion(argv, true);
+    _run_conversion(argv, false);
+    _run_parser(argv);
+    free(storage);
+    free(argv);
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "cap.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Sums a million numeric words of a variadic `DT_INT` positional, once by
+ * parsing them into a `ParsedArguments` and once by pulling them from
+ * a `ParserIterator`. Memory allocated by the library is counted by an
+ * installed allocator, which reports its peak.
+ */
+
+#define WORD_COUNT 1000000
+#define WORD_SIZE 16u
+#define ITERATIONS 5
+
+/// memory allocated by the library
+static BenchCounters _counters = { 0u, 0u, 0u };
+
+static void _make_argv(const char ** argv, char * storage) {
+    argv[0] = "prog";
+    for (int i = 1; i < WORD_COUNT; ++i) {
+        char * word = storage + (size_t) i * WORD_SIZE;
+        snprintf(word, WORD_SIZE, "%u", (unsigned) i * 7919u % 100000u);
+        argv[i] = word;
+    }
+}
+
+static void _report(const char * name, uint64_t best, size_t peak) {
+    bench_record(name, "ns_per_word", (double) best / WORD_COUNT, "ns");
+    bench_record(name, "peak_memory", (double) peak / 1024.0, "KiB");
+}
+
+static long long _sum_parsed(ArgumentParser * parser, const char ** argv) {
+    ParsingResult res = cap_parser_parse_noexit(parser, WORD_COUNT, argv);
+    if (res.mError != PER_NO_ERROR) {
+        fprintf(stderr, "bench: parsing failed\n");
+        exit(1);
+    }
+    size_t count;
+    const int * values = cap_pa_get_positional_ints(
+        res.mArguments, "values", &count);
+    long long sum = 0;
+    for (size_t i = 0u; i < count; ++i) {
+        sum += values[i];
+    }
+    cap_pa_destroy(res.mArguments);
+    return sum;
+}
+
+static long long _sum_iterated(ArgumentParser * parser, const char ** argv) {
+    ParserIterator * iter = cap_parser_iter_begin(parser, WORD_COUNT, argv);
+    ParsedItem item;
+    long long sum = 0;
+    while (cap_parser_iter_next_noexit(iter, &item)) {
+        sum += cap_tu_as_int(&(item.mValue));
+    }
+    if (cap_parser_iter_result(iter).mError != PER_NO_ERROR) {
+        fprintf(stderr, "bench: parsing failed\n");
+        exit(1);
+    }
+    cap_parser_iter_end(iter);
+    return sum;
+}
+
+static void _run(
+        const char * name, ArgumentParser * parser, const char ** argv,
+        long long (* sum)(ArgumentParser *, const char **)) {
+    uint64_t best = UINT64_MAX;
+    const size_t base = _counters.mLiveBytes;
+    _counters.mPeakBytes = base;
+    for (int i = 0; i < ITERATIONS; ++i) {
+        const uint64_t start = bench_now_ns();
+        long long total = sum(parser, argv);
+        const uint64_t elapsed = bench_now_ns() - start;
+        bench_consume(&total);
+        best = elapsed < best ? elapsed : best;
+    }
+    _report(name, best, _counters.mPeakBytes - base);
+}
+
+int main() {
+    const Allocator counting = BENCH_COUNTING_ALLOCATOR(&_counters);
+    cap_allocator_set(&counting);
+    const char ** argv = (const char **) malloc(
+        WORD_COUNT * sizeof(const char *));
+    char * storage = (char *) malloc((size_t) WORD_COUNT * WORD_SIZE);
+    _make_argv(argv, storage);
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_enable_packed_values(p, true);
+    cap_parser_add_positional(p, "values", DT_INT, true, true, NULL, NULL);
+    _run("parser iterator: ParsedArguments", p, argv, _sum_parsed);
+    _run("parser iterator: ParserIterator", p, argv, _sum_iterated);
+    cap_parser_destroy(p);
+    cap_allocator_set(NULL);
+    free(storage);
+    free(argv);
+    return 0;
+}
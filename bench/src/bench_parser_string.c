@@ -0,0 +1,68 @@
+#include "cap.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Parses a short command a million times, once from a command string split
+ * in place by `cap_parser_parse_string_noexit` and once from words which are
+ * already split, to show the cost of splitting. Strings are borrowed in both
+ * cases.
+ */
+
+#define COMMAND "resize --pool 'pool a' --size 10 --verbose"
+#define COMMAND_COUNT 1000000
+#define ITERATIONS 5
+
+static void _report(const char * name, uint64_t best) {
+    bench_record(
+        name, "ns_per_command", (double) best / COMMAND_COUNT, "ns");
+}
+
+static void _check(ParsingResult res) {
+    if (res.mError != PER_NO_ERROR) {
+        fprintf(stderr, "bench: parsing failed\n");
+        exit(1);
+    }
+    bench_consume(res.mArguments);
+    cap_pa_destroy(res.mArguments);
+}
+
+int main() {
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_enable_borrowed_strings(p, true);
+    cap_parser_add_flag(p, "--pool", DT_STRING, 1, 1, NULL, NULL);
+    cap_parser_add_flag(p, "--size", DT_INT, 0, 1, NULL, NULL);
+    cap_parser_add_flag(p, "--verbose", DT_PRESENCE, 0, 1, NULL, NULL);
+    cap_parser_add_positional(p, "command", DT_STRING, true, false, NULL, NULL);
+    uint64_t best = UINT64_MAX;
+    char buffer[sizeof(COMMAND)];
+    for (int i = 0; i < ITERATIONS; ++i) {
+        const uint64_t start = bench_now_ns();
+        for (int j = 0; j < COMMAND_COUNT; ++j) {
+            memcpy(buffer, COMMAND, sizeof(COMMAND));
+            _check(cap_parser_parse_string_noexit(
+                p, buffer, sizeof(COMMAND) - 1u));
+        }
+        const uint64_t elapsed = bench_now_ns() - start;
+        best = elapsed < best ? elapsed : best;
+    }
+    _report("parser string: command string", best);
+    const char * argv[7] = {
+        "prog", "resize", "--pool", "pool a", "--size", "10", "--verbose"
+    };
+    best = UINT64_MAX;
+    for (int i = 0; i < ITERATIONS; ++i) {
+        const uint64_t start = bench_now_ns();
+        for (int j = 0; j < COMMAND_COUNT; ++j) {
+            _check(cap_parser_parse_noexit(p, 7, argv));
+        }
+        const uint64_t elapsed = bench_now_ns() - start;
+        best = elapsed < best ? elapsed : best;
+    }
+    _report("parser string: split words", best);
+    cap_parser_destroy(p);
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "cap.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Parses four million numeric words of a variadic `DT_INT` and of a variadic
+ * `DT_DOUBLE` positional with 1, 2, 4, 8 and 16 conversion threads (see
+ * `cap_parser_set_thread_count`). Speedups are bounded by the number of
+ * processors of the machine.
+ */
+
+#define WORD_COUNT 4000000
+#define WORD_SIZE 24u
+#define ITERATIONS 5
+
+static void _report(const char * name, size_t threads, uint64_t best) {
+    char bench[64];
+    snprintf(
+        bench, sizeof(bench), "%s, %zu thread%s", name, threads,
+        threads == 1u ? "" : "s");
+    bench_record(bench, "ns_per_word", (double) best / WORD_COUNT, "ns");
+}
+
+static void _make_argv(const char ** argv, char * storage, bool doubles) {
+    argv[0] = "prog";
+    for (int i = 1; i < WORD_COUNT; ++i) {
+        char * word = storage + (size_t) i * WORD_SIZE;
+        const unsigned value = (unsigned) i * 7919u % 1000000u;
+        if (doubles) {
+            snprintf(word, WORD_SIZE, "%u.%03ue-%u", value, value % 1000u,
+                value % 10u);
+        }
+        else {
+            snprintf(word, WORD_SIZE, "%u", value);
+        }
+        argv[i] = word;
+    }
+}
+
+static void _run(const char * name, DataType type, const char ** argv) {
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_enable_packed_values(p, true);
+    cap_parser_add_positional(p, "values", type, true, true, NULL, NULL);
+    for (size_t threads = 1u; threads <= 16u; threads *= 2u) {
+        cap_parser_set_thread_count(p, threads);
+        uint64_t best = UINT64_MAX;
+        for (int i = 0; i < ITERATIONS; ++i) {
+            const uint64_t start = bench_now_ns();
+            ParsingResult res = cap_parser_parse_noexit(p, WORD_COUNT, argv);
+            const uint64_t elapsed = bench_now_ns() - start;
+            if (res.mError != PER_NO_ERROR) {
+                fprintf(stderr, "bench: parsing failed\n");
+                exit(1);
+            }
+            bench_consume(res.mArguments);
+            cap_pa_destroy(res.mArguments);
+            best = elapsed < best ? elapsed : best;
+        }
+        _report(name, threads, best);
+    }
+    cap_parser_destroy(p);
+}
+
+int main() {
+    const char ** argv = (const char **) malloc(
+        WORD_COUNT * sizeof(const char *));
+    char * storage = (char *) malloc((size_t) WORD_COUNT * WORD_SIZE);
+    _make_argv(argv, storage, false);
+    _run("parser threads: int", DT_INT, argv);
+    _make_argv(argv, storage, true);
+    _run("parser threads: double", DT_DOUBLE, argv);
+    free(storage);
+    free(argv);
+    return 0;
+}
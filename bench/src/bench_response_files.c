@@ -0,0 +1,86 @@
+#include "cap.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Parses a list of a million file names given as a variadic `DT_STRING`
+ * positional, once on the command line and once in a response file delimited
+ * by newlines or by null characters. Strings are borrowed, so the cost of
+ * a response file is reading and splitting it.
+ */
+
+#define WORD_COUNT 1000000
+#define WORD_SIZE 32u
+#define ITERATIONS 5
+#define PATH "bench/bin/response_file.txt"
+
+static void _report(const char * name, uint64_t best) {
+    bench_record(name, "ns_per_word", (double) best / WORD_COUNT, "ns");
+}
+
+static void _make_words(const char ** argv, char * storage) {
+    argv[0] = "prog";
+    for (int i = 1; i < WORD_COUNT; ++i) {
+        char * word = storage + (size_t) i * WORD_SIZE;
+        snprintf(word, WORD_SIZE, "src/module_%03d/file_%06d.c", i % 997, i);
+        argv[i] = word;
+    }
+}
+
+static void _write_file(const char ** argv, char delimiter) {
+    FILE * file = fopen(PATH, "wb");
+    if (!file) {
+        fprintf(stderr, "bench: cannot write '%s'\n", PATH);
+        exit(1);
+    }
+    for (int i = 1; i < WORD_COUNT; ++i) {
+        fputs(argv[i], file);
+        fputc(delimiter, file);
+    }
+    fclose(file);
+}
+
+static uint64_t _run(
+        ArgumentParser * parser, int argc, const char ** argv) {
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < ITERATIONS; ++i) {
+        const uint64_t start = bench_now_ns();
+        ParsingResult res = cap_parser_parse_noexit(parser, argc, argv);
+        const uint64_t elapsed = bench_now_ns() - start;
+        if (res.mError != PER_NO_ERROR
+                || cap_pa_positional_count(res.mArguments, "files")
+                    != WORD_COUNT - 1) {
+            fprintf(stderr, "bench: parsing failed\n");
+            exit(1);
+        }
+        bench_consume(res.mArguments);
+        cap_pa_destroy(res.mArguments);
+        best = elapsed < best ? elapsed : best;
+    }
+    return best;
+}
+
+int main() {
+    const char ** argv = (const char **) malloc(
+        WORD_COUNT * sizeof(const char *));
+    char * storage = (char *) malloc((size_t) WORD_COUNT * WORD_SIZE);
+    _make_words(argv, storage);
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_enable_borrowed_strings(p, true);
+    cap_parser_enable_response_files(p, true);
+    cap_parser_add_positional(p, "files", DT_STRING, true, true, NULL, NULL);
+    _report("response files: command line", _run(p, WORD_COUNT, argv));
+    const char * file_argv[2] = { "prog", "@" PATH };
+    _write_file(argv, '\n');
+    _report("response files: newline-delimited file", _run(p, 2, file_argv));
+    _write_file(argv, '\0');
+    _report("response files: null-delimited file", _run(p, 2, file_argv));
+    remove(PATH);
+    cap_parser_destroy(p);
+    free(storage);
+    free(argv);
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include "cap.h"
+#include "bench.h"
+
+#include <stdlib.h>
+
+/**
+ * Parses a short command line many times, creating a new `ParsedArguments`
+ * for every parse or reusing a single one, and reports the time per parse.
+ */
+
+#define ITERATIONS 200000
+
+static const char * ARGV[] = {
+    "prog", "--verbose", "--level", "3", "--name", "request", "input.txt",
+    "output.txt", "--ratio", "0.5"
+};
+static const int ARGC = (int) (sizeof(ARGV) / sizeof(ARGV[0]));
+
+static void _report(const char * name, uint64_t elapsed) {
+    bench_record(name, "ns_per_parse", (double) elapsed / ITERATIONS, "ns");
+}
+
+int main() {
+    ArgumentParser * p = cap_parser_make_default();
+    cap_parser_add_flag(p, "--verbose", DT_PRESENCE, 0, -1, NULL, NULL);
+    cap_parser_add_flag(p, "--level", DT_INT, 0, 1, NULL, NULL);
+    cap_parser_add_flag(p, "--name", DT_STRING, 0, 1, NULL, NULL);
+    cap_parser_add_flag(p, "--ratio", DT_DOUBLE, 0, 1, NULL, NULL);
+    cap_parser_add_positional(p, "input", DT_STRING, true, false, NULL, NULL);
+    cap_parser_add_positional(p, "output", DT_STRING, true, false, NULL, NULL);
+
+    uint64_t start = bench_now_ns();
+    for (int i = 0; i < ITERATIONS; ++i) {
+        ParsingResult res = cap_parser_parse_noexit(p, ARGC, ARGV);
+        bench_consume(res.mArguments);
+        cap_pa_destroy(res.mArguments);
+    }
+    _report("reuse: new ParsedArguments per parse", bench_now_ns() - start);
+
+    ParsedArguments * pa = cap_pa_make_empty();
+    start = bench_now_ns();
+    for (int i = 0; i < ITERATIONS; ++i) {
+        ParsingResult res = cap_parser_parse_into_noexit(p, pa, ARGC, ARGV);
+        bench_consume(res.mArguments);
+    }
+    _report("reuse: reused ParsedArguments", bench_now_ns() - start);
+    cap_pa_destroy(pa);
+    cap_parser_destroy(p);
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "cap.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Measures the start-up of a short-lived invocation of a program with many
+ * subcommands: configuring the parser, parsing one subcommand, and destroying
+ * the parser. Parsers of subcommands are built lazily by
+ * `cap_parser_add_subcommand`; for comparison, the same parsers are also all
+ * configured up front, as a program without lazy subcommands would do.
+ */
+
+#define SUBCOMMAND_COUNT 120
+#define FLAGS_PER_SUBCOMMAND 30
+#define INVOCATION_COUNT 2000
+#define ITERATIONS 5
+
+static char _names[SUBCOMMAND_COUNT][16];
+static char _flags[FLAGS_PER_SUBCOMMAND][16];
+
+static void _make_subcommand(ArgumentParser * parser, void * context) {
+    (void) context;
+    for (int i = 0; i < FLAGS_PER_SUBCOMMAND; ++i) {
+        cap_parser_add_flag(
+            parser, _flags[i], i % 2 ? DT_STRING : DT_PRESENCE, 0, 1, NULL,
+            "a flag of the subcommand");
+    }
+}
+
+static ArgumentParser * _make_parser() {
+    ArgumentParser * p = cap_parser_make_default();
+    cap_parser_add_flag(p, "--verbose", DT_PRESENCE, 0, 1, NULL, NULL);
+    for (int i = 0; i < SUBCOMMAND_COUNT; ++i) {
+        cap_parser_add_subcommand(
+            p, _names[i], _make_subcommand, NULL, "a subcommand");
+    }
+    return p;
+}
+
+static void _check(ParsingResult res) {
+    if (res.mError != PER_NO_ERROR) {
+        fprintf(stderr, "bench: parsing failed\n");
+        exit(1);
+    }
+    bench_consume(res.mArguments);
+    cap_pa_destroy(res.mArguments);
+}
+
+int main() {
+    for (int i = 0; i < SUBCOMMAND_COUNT; ++i) {
+        snprintf(_names[i], sizeof(_names[i]), "command%d", i);
+    }
+    for (int i = 0; i < FLAGS_PER_SUBCOMMAND; ++i) {
+        snprintf(_flags[i], sizeof(_flags[i]), "--option%d", i);
+    }
+    const char * argv[5] = {
+        "prog", "--verbose", "command97", "--option1", "value"
+    };
+
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < ITERATIONS; ++i) {
+        const uint64_t start = bench_now_ns();
+        for (int j = 0; j < INVOCATION_COUNT; ++j) {
+            ArgumentParser * p = _make_parser();
+            _check(cap_parser_parse_noexit(p, 5, argv));
+            cap_parser_destroy(p);
+        }
+        const uint64_t elapsed = bench_now_ns() - start;
+        best = elapsed < best ? elapsed : best;
+    }
+    bench_record(
+        "subcommands: lazily built", "ns_per_invocation",
+        (double) best / INVOCATION_COUNT, "ns");
+
+    ArgumentParser * all[SUBCOMMAND_COUNT];
+    best = UINT64_MAX;
+    for (int i = 0; i < ITERATIONS; ++i) {
+        const uint64_t start = bench_now_ns();
+        for (int j = 0; j < INVOCATION_COUNT; ++j) {
+            ArgumentParser * p = _make_parser();
+            for (int k = 0; k < SUBCOMMAND_COUNT; ++k) {
+                all[k] = cap_parser_make_default();
+                _make_subcommand(all[k], NULL);
+            }
+            _check(cap_parser_parse_noexit(p, 5, argv));
+            for (int k = 0; k < SUBCOMMAND_COUNT; ++k) {
+                cap_parser_destroy(all[k]);
+            }
+            cap_parser_destroy(p);
+        }
+        const uint64_t elapsed = bench_now_ns() - start;
+        best = elapsed < best ? elapsed : best;
+    }
+    bench_record(
+        "subcommands: configured up front", "ns_per_invocation",
+        (double) best / INVOCATION_COUNT, "ns");
+    return 0;
+}
@@ -0,0 +1,204 @@
+#include "cap.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Measures the hot paths of the library, so that results can be compared
+ * across versions. Every case reports the time per word, the number of
+ * allocations made by the library per run, and the peak resident set size,
+ * each as one JSON object per line (see `bench_record`). For parsing, a word
+ * is a command line word. For the construction of a parser it is a configured
+ * flag name or alias, for accessors it is a value which is read, and for
+ * help messages it is a flag which is rendered.
+ */
+
+#define ITERATIONS 5
+
+#define CONSTRUCTION_FLAG_COUNT 1000
+#define FLAG_COUNT 64
+#define FLAG_WORD_COUNT 4096
+#define POSITIONAL_COUNT 256
+#define VARIADIC_WORD_COUNT 65536
+#define HELP_FLAG_COUNT 1000
+
+/// allocations made by the library
+static BenchCounters _counters = { 0u, 0u, 0u };
+
+typedef struct {
+    ArgumentParser * mParser;
+    ParsedArguments * mArguments;
+    int mArgc;
+    const char ** mArgv;
+    char (* mNames)[24];
+} Case;
+
+static char _construction_names[2 * CONSTRUCTION_FLAG_COUNT][24];
+static char _flag_names[FLAG_COUNT][24];
+static char _help_names[HELP_FLAG_COUNT][24];
+
+static void _run(
+        const char * name, void (* function)(Case *), Case * c, size_t runs,
+        size_t words) {
+    bench_reset_peak_rss();
+    uint64_t best = UINT64_MAX;
+    size_t allocations = 0u;
+    for (int i = 0; i < ITERATIONS; ++i) {
+        _counters.mAllocations = 0u;
+        const uint64_t start = bench_now_ns();
+        for (size_t j = 0u; j < runs; ++j) {
+            function(c);
+        }
+        const uint64_t elapsed = bench_now_ns() - start;
+        best = elapsed < best ? elapsed : best;
+        allocations = _counters.mAllocations;
+    }
+    bench_record(
+        name, "ns_per_word", (double) best / (double) (runs * words), "ns");
+    bench_record(
+        name, "allocations_per_run", (double) allocations / (double) runs,
+        "allocations");
+    bench_record(name, "peak_rss", (double) bench_peak_rss_kb(), "kB");
+}
+
+static void _parse(Case * c) {
+    ParsingResult res = cap_parser_parse_noexit(
+        c -> mParser, c -> mArgc, c -> mArgv);
+    if (res.mError != PER_NO_ERROR) {
+        fprintf(stderr, "bench: parsing failed\n");
+        exit(1);
+    }
+    bench_consume(res.mArguments);
+    cap_pa_destroy(res.mArguments);
+}
+
+static void _construct(Case * c) {
+    ArgumentParser * p = cap_parser_make_default();
+    for (int i = 0; i < CONSTRUCTION_FLAG_COUNT; ++i) {
+        cap_parser_add_flag(
+            p, c -> mNames[2 * i], i % 2 ? DT_INT : DT_PRESENCE, 0, 1, NULL,
+            "a generated flag");
+        cap_parser_add_flag_alias(
+            p, c -> mNames[2 * i], c -> mNames[2 * i + 1]);
+    }
+    bench_consume(p);
+    cap_parser_destroy(p);
+}
+
+static void _access(Case * c) {
+    long sum = 0;
+    for (int i = 0; i < FLAG_COUNT; ++i) {
+        const size_t count = cap_pa_flag_count(
+            c -> mArguments, c -> mNames[i]);
+        for (size_t j = 0u; j < count; ++j) {
+            sum += cap_tu_as_int(
+                cap_pa_get_flag_i(c -> mArguments, c -> mNames[i], j));
+        }
+    }
+    bench_consume((const void *) sum);
+}
+
+static void _render(Case * c) {
+    static char buffer[1u << 17];
+    // the messages are not prepared, so each call renders them
+    cap_parser_format_usage(c -> mParser, "prog", buffer, sizeof(buffer));
+    cap_parser_format_help(c -> mParser, buffer, sizeof(buffer));
+    bench_consume(buffer);
+}
+
+static Case _make_variadic(
+        DataType type, const char ** argv, const char * word) {
+    Case c = {
+        cap_parser_make_default(), NULL, VARIADIC_WORD_COUNT + 1, argv, NULL
+    };
+    cap_parser_add_positional(
+        c.mParser, "values", type, true, true, NULL, NULL);
+    argv[0] = "prog";
+    for (int i = 1; i <= VARIADIC_WORD_COUNT; ++i) {
+        argv[i] = word;
+    }
+    return c;
+}
+
+int main() {
+    const Allocator counting = BENCH_COUNTING_ALLOCATOR(&_counters);
+    cap_allocator_set(&counting);
+    const char ** argv = (const char **) malloc(
+        (VARIADIC_WORD_COUNT + 1) * sizeof(const char *));
+    if (!argv) {
+        fprintf(stderr, "bench: out of memory\n");
+        return 1;
+    }
+
+    // parser construction
+    for (int i = 0; i < CONSTRUCTION_FLAG_COUNT; ++i) {
+        snprintf(_construction_names[2 * i], 24, "--generated-option%d", i);
+        snprintf(_construction_names[2 * i + 1], 24, "-g%d", i);
+    }
+    Case c = { NULL, NULL, 0, NULL, _construction_names };
+    _run("construction", _construct, &c, 20u, 2u * CONSTRUCTION_FLAG_COUNT);
+
+    // flag-heavy command line
+    c = (Case) {
+        cap_parser_make_default(), NULL, FLAG_WORD_COUNT + 1, argv, _flag_names
+    };
+    for (int i = 0; i < FLAG_COUNT; ++i) {
+        snprintf(_flag_names[i], 24, "--option%d", i);
+        cap_parser_add_flag(
+            c.mParser, _flag_names[i], DT_INT, 0, -1, NULL, NULL);
+    }
+    argv[0] = "prog";
+    for (int i = 0; i < FLAG_WORD_COUNT / 2; ++i) {
+        argv[2 * i + 1] = _flag_names[(i * 7) % FLAG_COUNT];
+        argv[2 * i + 2] = "42";
+    }
+    _run("flag_argv", _parse, &c, 200u, FLAG_WORD_COUNT);
+
+    // accessors of the parsed flags
+    ParsingResult res = cap_parser_parse_noexit(c.mParser, c.mArgc, c.mArgv);
+    c.mArguments = res.mArguments;
+    _run("accessors", _access, &c, 200u, FLAG_WORD_COUNT / 2);
+    cap_pa_destroy(c.mArguments);
+    cap_parser_destroy(c.mParser);
+
+    // positional-heavy command line
+    static char positional_names[POSITIONAL_COUNT][24];
+    c = (Case) {
+        cap_parser_make_default(), NULL, POSITIONAL_COUNT + 1, argv, NULL
+    };
+    for (int i = 0; i < POSITIONAL_COUNT; ++i) {
+        snprintf(positional_names[i], 24, "positional%d", i);
+        cap_parser_add_positional(
+            c.mParser, positional_names[i], i % 2 ? DT_INT : DT_STRING, true,
+            false, NULL, NULL);
+        argv[i + 1] = i % 2 ? "17" : "value";
+    }
+    _run("positional_argv", _parse, &c, 2000u, POSITIONAL_COUNT);
+    cap_parser_destroy(c.mParser);
+
+    // long variadic command lines, and conversion of numbers
+    c = _make_variadic(DT_STRING, argv, "a/file/name.txt");
+    _run("variadic_argv", _parse, &c, 20u, VARIADIC_WORD_COUNT);
+    cap_parser_destroy(c.mParser);
+    c = _make_variadic(DT_INT, argv, "1234567");
+    _run("int_conversion", _parse, &c, 20u, VARIADIC_WORD_COUNT);
+    cap_parser_destroy(c.mParser);
+    c = _make_variadic(DT_DOUBLE, argv, "3.14159e2");
+    _run("double_conversion", _parse, &c, 20u, VARIADIC_WORD_COUNT);
+    cap_parser_destroy(c.mParser);
+
+    // help and usage rendering
+    c = (Case) { cap_parser_make_default(), NULL, 0, NULL, NULL };
+    for (int i = 0; i < HELP_FLAG_COUNT; ++i) {
+        snprintf(_help_names[i], 24, "--generated-option%d", i);
+        cap_parser_add_flag(
+            c.mParser, _help_names[i], i % 2 ? DT_INT : DT_PRESENCE, 0, 1,
+            NULL, "a generated flag");
+    }
+    _run("help_rendering", _render, &c, 100u, HELP_FLAG_COUNT);
+    cap_parser_destroy(c.mParser);
+
+    free(argv);
+    return 0;
+}
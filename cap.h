@@ -0,0 +1,11341 @@
+#ifndef __CAP_H__
+#define __CAP_H__
+
+#include <assert.h>
+#include <errno.h>
+#include <float.h>
+#include <limits.h>
+#include <locale.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @file
+ *
+ * All memory used by the library is allocated through a process-wide
+ * `Allocator`. By default, it forwards to `malloc`, `realloc` and `free`. A
+ * custom allocator can be installed using `cap_allocator_set`, e.g. to route
+ * allocations through a pool allocator or to account for the memory used by
+ * the library.
+ *
+ * The allocator should be installed before any object of the library is
+ * created, and it must not be changed while such objects exist, because
+ * memory is always released through the allocator which is installed at that
+ * time. Installing an allocator is not thread-safe.
+ *
+ * Memory returned by functions of the library which the caller is supposed
+ * to release (e.g. strings returned by `copy_string`) must be released using
+ * `cap_free`.
+ */
+
+// ============================================================================
+// === ALLOCATOR ==============================================================
+// ============================================================================
+
+/**
+ * Set of functions used by the library to manage memory.
+ *
+ * The functions have the same semantics as `malloc`, `realloc` and `free`,
+ * except that they receive `mContext` as an additional argument.
+ */
+typedef struct {
+    /// allocates `size` bytes
+    void * (* mAlloc)(size_t size, void * context);
+    /// resizes `memory` (which may be `NULL`) to `size` bytes
+    void * (* mRealloc)(void * memory, size_t size, void * context);
+    /// releases `memory`, which may be `NULL`
+    void (* mFree)(void * memory, void * context);
+    /// passed to every call of the functions above
+    void * mContext;
+} Allocator;
+
+// ============================================================================
+// === ALLOCATOR: DECLARATION OF PRIVATE FUNCTIONS ============================
+// ============================================================================
+
+static void * _cap_default_alloc(size_t size, void * context);
+static void * _cap_default_realloc(void * memory, size_t size, void * context);
+static void _cap_default_free(void * memory, void * context);
+
+/// the installed allocator
+static Allocator _cap_allocator = {
+    .mAlloc = _cap_default_alloc,
+    .mRealloc = _cap_default_realloc,
+    .mFree = _cap_default_free,
+    .mContext = NULL
+};
+
+// ============================================================================
+// === ALLOCATOR FUNCTIONS ====================================================
+// ============================================================================
+
+/**
+ * Installs an allocator.
+ *
+ * All memory allocated by the library from now on is managed by `allocator`.
+ * See the description of this file for restrictions.
+ *
+ * @param allocator allocator to install. It is copied. If it is `NULL`, the
+ *        default allocator (using `malloc`, `realloc` and `free`) is
+ *        installed.
+ */
+void cap_allocator_set(const Allocator * allocator) {
+    if (!allocator) {
+        _cap_allocator = (Allocator) {
+            .mAlloc = _cap_default_alloc,
+            .mRealloc = _cap_default_realloc,
+            .mFree = _cap_default_free,
+            .mContext = NULL
+        };
+        return;
+    }
+    _cap_allocator = *allocator;
+}
+
+/**
+ * Gets the installed allocator.
+ *
+ * @return copy of the installed allocator
+ */
+Allocator cap_allocator_get() {
+    return _cap_allocator;
+}
+
+/**
+ * Allocates memory using the installed allocator.
+ *
+ * @param size number of bytes to allocate
+ * @return pointer to the allocated memory
+ */
+void * cap_malloc(size_t size) {
+    return _cap_allocator.mAlloc(size, _cap_allocator.mContext);
+}
+
+/**
+ * Resizes memory using the installed allocator.
+ *
+ * @param memory memory to resize, or `NULL`
+ * @param size required number of bytes
+ * @return pointer to the resized memory
+ */
+void * cap_realloc(void * memory, size_t size) {
+    return _cap_allocator.mRealloc(memory, size, _cap_allocator.mContext);
+}
+
+/**
+ * Releases memory using the installed allocator.
+ *
+ * @param memory memory to release. If it is `NULL`, nothing happens.
+ */
+void cap_free(void * memory) {
+    if (!memory) {
+        return;
+    }
+    _cap_allocator.mFree(memory, _cap_allocator.mContext);
+}
+
+// ============================================================================
+// === ALLOCATOR: IMPLEMENTATION OF PRIVATE FUNCTIONS =========================
+// ============================================================================
+
+static void * _cap_default_alloc(size_t size, void * context) {
+    (void) context;
+    return malloc(size);
+}
+
+static void * _cap_default_realloc(
+        void * memory, size_t size, void * context) {
+    (void) context;
+    return realloc(memory, size);
+}
+
+static void _cap_default_free(void * memory, void * context) {
+    (void) context;
+    free(memory);
+}
+
+/** @file */
+
+// ============================================================================
+// === DATA TYPE IDENTIFICATION ===============================================
+// ============================================================================
+
+/**
+ * Identifies data type of parsed values
+ * 
+ * For the purposes of the `cap` library, every value has a data type. That
+ * type is, however, not known at compile-time (because parsers are created by
+ * the user at run-time). Values are stored as Typed Unions,
+ * and their type is represented by DataType.
+ * @see TypedUnion
+ * @ingroup typed_union
+ */
+typedef enum {
+    /// integer value, corresponds to the `int` type
+    DT_INT,
+    /// real value, corresponds to the `double` type
+    DT_DOUBLE,
+    /// character string value, corresponds to a null-terminated string
+    DT_STRING,
+    /// used for flags that do not store any information other than their 
+    /// presence or absence
+    DT_PRESENCE  
+} DataType;
+
+/** @file */
+
+// ============================================================================
+// === HELPER FUNCTIONS =======================================================
+// ============================================================================
+
+/**
+ * Creates a copy of a string
+ * 
+ * Copies the given null-terminated string into newly allocated memory. 
+ * The caller becomes the owner of that memoroy and should deallocate it
+ * using `cap_free` when it is no longer needed. If `NULL` is given, `NULL` is 
+ * also returned.
+ * 
+ * @param string original null-terminated string
+ * @return pointer to the copy of the given string 
+ */
+char * copy_string(const char * string) {
+    if (!string) {
+        return NULL;
+    }
+    const int len = strlen(string);
+    char * copy = (char *) cap_malloc((len + 1) * sizeof(char));
+    memcpy(copy, string, len + 1);
+    return copy;
+}
+
+/**
+ * Replaces a string with a new value.
+ * 
+ * Replaces a string stored in `*property` with a copy of `value`. If 
+ * `*property` is a string already, it is first deleted using 
+ * `delete_string_property`. The caller must be the owner of the original 
+ * string. The original must have been allocated using `cap_malloc`.
+ * 
+ * The new value must be either `NULL`, or a null-terminated string. If it is 
+ * not `NULL`, a copy is created and stored. The owner of `property` becomes 
+ * the owner of the copy.
+ * 
+ * @param property pointer to a string that should be repalced
+ * @param value null-terminated string, or `NULL`
+ */
+void set_string_property(char ** property, const char * value) {
+    if (!property) {
+        return;
+    }
+    if (*property) {
+        cap_free(*property);
+    }
+    // copy_string returns NULL if its argument is NULL
+    *property = copy_string(value);
+}
+
+/**
+ * Deletes a string stored in `*property`
+ * 
+ * Deallocates a string and replaces it with `NULL`. The string in question 
+ * must be owned by the caller and it must have been previously allocated 
+ * using `cap_malloc`.
+ * 
+ * @param property pointer to a string that should be deleted
+ */
+void delete_string_property(char ** property) {
+    set_string_property(property, NULL);
+}
+
+// ============================================================================
+// === DESCRIPTION PROVIDERS ==================================================
+// ============================================================================
+
+/**
+ * Supplies a text of a help message on demand.
+ * 
+ * Instead of a description, a function of this type can be configured, e.g.
+ * using `cap_parser_set_flag_description_provider`. It is only called when
+ * a help message is rendered, so texts which are expensive to produce (e.g.
+ * translated ones) cost nothing unless help is requested. It is called each
+ * time the message is printed or formatted, since a help message which uses
+ * providers is never kept by the parser (see `cap_parser_prepare_help`).
+ *
+ * @param context the pointer configured together with the function
+ * @return null-terminated text, or `NULL` if there is none. It is copied into
+ *         the rendered message.
+ */
+typedef const char * (* DescriptionProvider)(void * context);
+
+/**
+ * Gets a text of a help message.
+ * 
+ * @param text configured text, or `NULL`
+ * @param provider configured provider, or `NULL`
+ * @param context pointer passed to `provider`
+ * @return the text given by `provider` if there is one, `text` otherwise
+ */
+static const char * cap_describe(
+        const char * text, DescriptionProvider provider, void * context) {
+    return provider ? provider(context) : text;
+}
+
+// ============================================================================
+// === TEXT BUFFERS ===========================================================
+// ============================================================================
+
+/**
+ * Growing buffer of text.
+ *
+ * Help and usage messages are rendered into objects of this type, so they can
+ * be written with a single call. An object with all members zero is an empty
+ * buffer. Once anything is appended, `mData` is null-terminated and should be
+ * deallocated using `cap_free`.
+ */
+typedef struct {
+    char * mData;
+    size_t mLength;
+    size_t mAlloc;
+} TextBuffer;
+
+/**
+ * Appends characters to a text buffer.
+ *
+ * @param text buffer to append to
+ * @param string characters to append, need not be null-terminated
+ * @param length number of characters to append
+ */
+static void cap_text_append(
+        TextBuffer * text, const char * string, size_t length) {
+    if (text -> mLength + length + 1u > text -> mAlloc) {
+        size_t alloc_size = text -> mAlloc ? text -> mAlloc * 2u : 256u;
+        while (alloc_size < text -> mLength + length + 1u) {
+            alloc_size *= 2u;
+        }
+        text -> mData = (char *) cap_realloc(text -> mData, alloc_size);
+        text -> mAlloc = alloc_size;
+    }
+    memcpy(text -> mData + text -> mLength, string, length);
+    text -> mLength += length;
+    text -> mData[text -> mLength] = '\0';
+}
+
+/**
+ * Appends a null-terminated string to a text buffer.
+ *
+ * @param text buffer to append to
+ * @param string null-terminated string to append
+ */
+static void cap_text_append_string(TextBuffer * text, const char * string) {
+    cap_text_append(text, string, strlen(string));
+}
+
+/**
+ * Appends a single character to a text buffer.
+ *
+ * @param text buffer to append to
+ * @param c character to append
+ */
+static void cap_text_append_char(TextBuffer * text, char c) {
+    cap_text_append(text, &c, 1u);
+}
+
+/**
+ * Get an string representation of type.
+ *
+ * Returns a null-terminated string representing the given data type. If 
+ * DT_PRESENCE is given, returns NULL instead. This should be used in help and
+ * usage messages.
+ *
+ * @param type data type to display
+ * @return string representation of the type, or NULL if type is  DT_PRESENCE 
+ */
+static const char * cap_type_metavar(DataType type) {
+    const char * type_metavar;
+    switch (type) {
+        case DT_DOUBLE:
+            type_metavar = "DOUBLE";
+            break;
+        case DT_INT:
+            type_metavar = "INT";
+            break;
+        case DT_STRING:
+            type_metavar = "STRING";
+            break;
+        case DT_PRESENCE:
+        default:
+            type_metavar = NULL;
+    }
+    return type_metavar;
+}
+
+/**
+ * @file
+ *
+ * `Arena` is a bump allocator. Memory is handed out from large chunks by
+ * advancing a pointer, and individual allocations are never freed. Instead,
+ * all memory is released at once when the arena is destroyed. It is used
+ * internally, e.g. by `ParsedArguments`, so that a single parse needs only a
+ * few allocations and a single deallocation (unless the arena grows).
+ * Users of the library never need to interact with it directly. Functions
+ * related to this type are prefixed with `cap_arena_`.
+ *
+ * An arena can also be rewound to a previously taken mark using
+ * `cap_arena_rewind`. Everything allocated after the mark is released, but
+ * the chunks are kept and reused by later allocations. Repeating the same
+ * allocations after rewinding therefore does not allocate any memory.
+ *
+ * Functions which allocate memory accept a `NULL` arena. In that case they
+ * fall back to `cap_malloc`, `cap_realloc` and `cap_free`. This allows
+ * containers to be backed by an arena optionally, using the same code.
+ */
+
+// ============================================================================
+// === ARENA ==================================================================
+// ============================================================================
+
+/**
+ * A chunk of memory owned by an `Arena`.
+ *
+ * The usable memory of a chunk follows directly after this header.
+ */
+typedef struct ArenaChunk {
+    /// next chunk, or `NULL`
+    struct ArenaChunk * mNext;
+    /// number of usable bytes in this chunk
+    size_t mSize;
+    /// number of bytes already handed out
+    size_t mUsed;
+} ArenaChunk;
+
+/**
+ * Heap memory adopted by an `Arena`, see `cap_arena_adopt`.
+ */
+typedef struct ArenaAdopted {
+    /// previously adopted memory, or `NULL`
+    struct ArenaAdopted * mPrevious;
+    /// memory to pass to `cap_free` when the arena is destroyed
+    void * mMemory;
+} ArenaAdopted;
+
+/**
+ * Bump allocator.
+ *
+ * The first chunk is allocated in the same block as the arena itself. Chunks
+ * form a list in the order in which they were allocated, chunks after
+ * `mCurrent` are empty and are reused before allocating new ones.
+ */
+typedef struct {
+    /// chunk from which memory is currently handed out
+    ArenaChunk * mCurrent;
+    /// heap memory to free when the arena is destroyed
+    ArenaAdopted * mAdopted;
+    /// most recent allocation, which can be resized in place
+    void * mLast;
+    /// number of bytes of the most recent allocation
+    size_t mLastSize;
+} Arena;
+
+/**
+ * Position in an `Arena`, see `cap_arena_mark`.
+ */
+typedef struct {
+    /// chunk which was current when the mark was taken
+    ArenaChunk * mChunk;
+    /// number of bytes used in `mChunk` at that time
+    size_t mUsed;
+    /// most recently adopted memory at that time
+    ArenaAdopted * mAdopted;
+} ArenaMark;
+
+/// type with the strictest alignment requirement of all fundamental types
+typedef union {
+    long double mLongDouble;
+    long long mLongLong;
+    double mDouble;
+    void * mPointer;
+    void (* mFunction)(void);
+} _CapArenaMaxAlign;
+
+/// alignment of every allocation handed out by an `Arena`
+#define _CAP_ARENA_ALIGN (sizeof(_CapArenaMaxAlign))
+
+// ============================================================================
+// === ARENA: DECLARATION OF PRIVATE FUNCTIONS ================================
+// ============================================================================
+
+static size_t _cap_arena_round_up(size_t size);
+static ArenaChunk * _cap_arena_first_chunk(const Arena * arena);
+static char * _cap_arena_chunk_data(ArenaChunk * chunk);
+static ArenaChunk * _cap_arena_chunk_make(size_t size, void * memory);
+
+// ============================================================================
+// === ARENA FUNCTIONS ========================================================
+// ============================================================================
+
+/**
+ * Creates a new `Arena`.
+ *
+ * Allocates the arena together with its first chunk in a single block. If
+ * more than `size` bytes are requested from the arena, more chunks are
+ * allocated as needed.
+ *
+ * The caller becomes the owner of the new object and should dispose of it
+ * using `cap_arena_destroy`.
+ *
+ * @param size number of usable bytes in the first chunk
+ * @return new object
+ */
+Arena * cap_arena_make(size_t size) {
+    size = _cap_arena_round_up(size);
+    const size_t header = _cap_arena_round_up(sizeof(Arena))
+        + _cap_arena_round_up(sizeof(ArenaChunk));
+    char * block = (char *) cap_malloc(header + size);
+    Arena * arena = (Arena *) block;
+    *arena = (Arena) {
+        .mCurrent = _cap_arena_chunk_make(
+            size, block + _cap_arena_round_up(sizeof(Arena))),
+        .mAdopted = NULL,
+        .mLast = NULL,
+        .mLastSize = 0u
+    };
+    return arena;
+}
+
+/**
+ * Destroys an `Arena`.
+ *
+ * Releases all memory handed out by the arena, memory adopted by it, and the
+ * arena itself.
+ *
+ * @param arena object to destroy. If it is `NULL`, nothing happens.
+ */
+void cap_arena_destroy(Arena * arena) {
+    if (!arena) {
+        return;
+    }
+    for (ArenaAdopted * a = arena -> mAdopted; a; a = a -> mPrevious) {
+        cap_free(a -> mMemory);
+    }
+    // the first chunk lives in the same block as the arena
+    ArenaChunk * chunk = _cap_arena_first_chunk(arena) -> mNext;
+    while (chunk) {
+        ArenaChunk * next = chunk -> mNext;
+        cap_free(chunk);
+        chunk = next;
+    }
+    cap_free(arena);
+}
+
+/**
+ * Allocates memory.
+ *
+ * Returns `size` bytes of uninitialized memory, suitably aligned for any
+ * fundamental type. The memory is valid until the arena is destroyed, or
+ * rewound to a mark taken before this call.
+ *
+ * @param arena arena to allocate from. If it is `NULL`, `cap_malloc` is
+ *        used instead.
+ * @param size number of bytes to allocate
+ * @return pointer to the allocated memory
+ */
+void * cap_arena_alloc(Arena * arena, size_t size) {
+    if (!arena) {
+        return cap_malloc(size);
+    }
+    const size_t rounded = _cap_arena_round_up(size);
+    ArenaChunk * chunk = arena -> mCurrent;
+    while (chunk -> mSize - chunk -> mUsed < rounded) {
+        if (!chunk -> mNext) {
+            // each new chunk is at least twice as large as the previous one
+            size_t chunk_size = chunk -> mSize * 2u;
+            if (chunk_size < rounded) {
+                chunk_size = rounded;
+            }
+            chunk -> mNext = _cap_arena_chunk_make(
+                chunk_size,
+                cap_malloc(
+                    _cap_arena_round_up(sizeof(ArenaChunk)) + chunk_size));
+        }
+        chunk = chunk -> mNext;
+    }
+    arena -> mCurrent = chunk;
+    void * memory = _cap_arena_chunk_data(chunk) + chunk -> mUsed;
+    chunk -> mUsed += rounded;
+    arena -> mLast = memory;
+    arena -> mLastSize = rounded;
+    return memory;
+}
+
+/**
+ * Resizes memory.
+ *
+ * Resizes memory previously returned by `cap_arena_alloc` or
+ * `cap_arena_realloc`. If `memory` is the most recent allocation, it is
+ * resized in place when possible. Otherwise new memory is allocated and the
+ * contents are copied. The old memory is not reused.
+ *
+ * @param arena arena to allocate from. If it is `NULL`, `realloc` is used
+ *        instead.
+ * @param memory memory to resize, or `NULL`
+ * @param old_size number of bytes currently allocated at `memory`
+ * @param new_size required number of bytes
+ * @return pointer to the resized memory
+ */
+void * cap_arena_realloc(
+    Arena * arena, void * memory, size_t old_size, size_t new_size)
+{
+    if (!arena) {
+        return cap_realloc(memory, new_size);
+    }
+    if (memory && memory == arena -> mLast) {
+        ArenaChunk * chunk = arena -> mCurrent;
+        const size_t rounded = _cap_arena_round_up(new_size);
+        const size_t start = chunk -> mUsed - arena -> mLastSize;
+        if (rounded <= chunk -> mSize - start) {
+            chunk -> mUsed = start + rounded;
+            arena -> mLastSize = rounded;
+            return memory;
+        }
+    }
+    void * new_memory = cap_arena_alloc(arena, new_size);
+    if (memory) {
+        memcpy(new_memory, memory, old_size < new_size ? old_size : new_size);
+    }
+    return new_memory;
+}
+
+/**
+ * Releases memory.
+ *
+ * Memory allocated from an arena is only released when the arena is
+ * destroyed, so this function does nothing unless `arena` is `NULL`.
+ *
+ * @param arena arena from which `memory` was allocated. If it is `NULL`,
+ *        `cap_free` is used.
+ * @param memory memory to release
+ */
+void cap_arena_free(Arena * arena, void * memory) {
+    if (!arena) {
+        cap_free(memory);
+    }
+}
+
+/**
+ * Remembers the current position of an arena.
+ *
+ * @param arena object to inspect
+ * @return mark which can be passed to `cap_arena_rewind`
+ */
+ArenaMark cap_arena_mark(const Arena * arena) {
+    return (ArenaMark) {
+        .mChunk = arena -> mCurrent,
+        .mUsed = arena -> mCurrent -> mUsed,
+        .mAdopted = arena -> mAdopted
+    };
+}
+
+/**
+ * Rewinds an arena to a mark.
+ *
+ * Releases everything allocated and adopted since `mark` was taken. Memory
+ * allocated before that remains valid. The chunks of the arena are kept, so
+ * that later allocations can reuse them without allocating memory.
+ *
+ * @param arena object to rewind
+ * @param mark mark previously returned by `cap_arena_mark` for `arena`. The
+ *        arena must not have been rewound to an earlier mark since then.
+ */
+void cap_arena_rewind(Arena * arena, ArenaMark mark) {
+    while (arena -> mAdopted != mark.mAdopted) {
+        ArenaAdopted * adopted = arena -> mAdopted;
+        arena -> mAdopted = adopted -> mPrevious;
+        cap_free(adopted -> mMemory);
+    }
+    for (ArenaChunk * c = mark.mChunk -> mNext; c; c = c -> mNext) {
+        c -> mUsed = 0u;
+    }
+    mark.mChunk -> mUsed = mark.mUsed;
+    arena -> mCurrent = mark.mChunk;
+    arena -> mLast = NULL;
+    arena -> mLastSize = 0u;
+}
+
+/**
+ * Gets the number of bytes an allocation takes from an arena.
+ *
+ * Allocations are padded to keep following allocations aligned. This can be
+ * used to compute the exact size of an arena which is large enough for a
+ * known set of allocations.
+ *
+ * @param size number of bytes requested from `cap_arena_alloc`
+ * @return number of bytes used up in the arena by the allocation
+ */
+size_t cap_arena_footprint(size_t size) {
+    return _cap_arena_round_up(size);
+}
+
+/**
+ * Gets the number of bytes owned by an arena.
+ *
+ * @param arena object to measure
+ * @return total number of usable bytes of all chunks, or zero if `arena` is
+ *         `NULL`
+ */
+size_t cap_arena_size(const Arena * arena) {
+    size_t size = 0u;
+    if (!arena) {
+        return size;
+    }
+    for (const ArenaChunk * c = _cap_arena_first_chunk(arena); c;
+            c = c -> mNext) {
+        size += c -> mSize;
+    }
+    return size;
+}
+
+/**
+ * Gets the number of bytes handed out by an arena.
+ *
+ * @param arena object to measure
+ * @return number of bytes allocated from all chunks (including padding), or
+ *         zero if `arena` is `NULL`
+ */
+size_t cap_arena_used(const Arena * arena) {
+    size_t used = 0u;
+    if (!arena) {
+        return used;
+    }
+    for (const ArenaChunk * c = _cap_arena_first_chunk(arena); c;
+            c = c -> mNext) {
+        used += c -> mUsed;
+    }
+    return used;
+}
+
+/**
+ * Takes ownership of heap memory.
+ *
+ * Makes `arena` the owner of `memory`, which must have been allocated using
+ * `cap_malloc`. It is freed when the arena is destroyed. This is used when
+ * a caller hands over ownership of an existing allocation, so that it does
+ * not need to be copied.
+ *
+ * @param arena new owner of `memory`. If it is `NULL`, nothing happens and 
+ *        the caller remains the owner.
+ * @param memory memory to adopt. If it is `NULL`, nothing happens.
+ */
+void cap_arena_adopt(Arena * arena, void * memory) {
+    if (!arena || !memory) {
+        return;
+    }
+    ArenaAdopted * adopted = (ArenaAdopted *) cap_arena_alloc(
+        arena, sizeof(ArenaAdopted));
+    *adopted = (ArenaAdopted) {
+        .mPrevious = arena -> mAdopted,
+        .mMemory = memory
+    };
+    arena -> mAdopted = adopted;
+}
+
+/**
+ * Creates a copy of a string.
+ *
+ * @param arena arena to allocate the copy from. If it is `NULL`,
+ *        `cap_malloc` is used.
+ * @param string original null-terminated string
+ * @return copy of `string`, or `NULL` if `string` is `NULL`
+ */
+char * cap_arena_copy_string(Arena * arena, const char * string) {
+    if (!string) {
+        return NULL;
+    }
+    const size_t size = strlen(string) + 1u;
+    char * copy = (char *) cap_arena_alloc(arena, size);
+    memcpy(copy, string, size);
+    return copy;
+}
+
+// ============================================================================
+// === ARENA: IMPLEMENTATION OF PRIVATE FUNCTIONS =============================
+// ============================================================================
+
+static size_t _cap_arena_round_up(size_t size) {
+    return (size + _CAP_ARENA_ALIGN - 1u) / _CAP_ARENA_ALIGN * _CAP_ARENA_ALIGN;
+}
+
+static ArenaChunk * _cap_arena_first_chunk(const Arena * arena) {
+    return (ArenaChunk *) ((char *) arena + _cap_arena_round_up(sizeof(Arena)));
+}
+
+static char * _cap_arena_chunk_data(ArenaChunk * chunk) {
+    return (char *) chunk + _cap_arena_round_up(sizeof(ArenaChunk));
+}
+
+static ArenaChunk * _cap_arena_chunk_make(size_t size, void * memory) {
+    ArenaChunk * chunk = (ArenaChunk *) memory;
+    *chunk = (ArenaChunk) {
+        .mNext = NULL,
+        .mSize = size,
+        .mUsed = 0u
+    };
+    return chunk;
+}
+
+/**
+ * @file
+ *
+ * `StringIndex` is a hash table which maps null-terminated strings to `size_t`
+ * values. It is used internally, e.g. by `ArgumentParser` to look up flags by
+ * their names and aliases in constant time on average. Users of the library
+ * never need to interact with it directly. Functions related to this type are
+ * prefixed with `cap_si_`.
+ *
+ * The index does not own its keys. Every key must remain valid (and must not
+ * be modified) for as long as it is stored in the index. Typically, keys are
+ * strings owned by the same object which owns the index.
+ *
+ * An index can be backed by an `Arena`, in which case it is allocated from
+ * the arena and released together with it.
+ */
+
+// ============================================================================
+// === STRING INDEX ===========================================================
+// ============================================================================
+
+/**
+ * A single entry of a `StringIndex`.
+ *
+ * A slot is empty if its key is `NULL`.
+ */
+typedef struct {
+    /// borrowed key, or `NULL` if the slot is empty
+    const char * mKey;
+    /// cached hash of `mKey`
+    size_t mHash;
+    /// value associated with `mKey`
+    size_t mValue;
+} StringIndexSlot;
+
+/**
+ * Hash table mapping null-terminated strings to `size_t` values.
+ *
+ * Collisions are resolved using linear probing. The number of slots is always
+ * zero or a power of two.
+ */
+typedef struct {
+    StringIndexSlot * mSlots;
+    size_t mCount;
+    size_t mAlloc;
+    /// arena which owns the index, or `NULL` if it is allocated on the heap
+    Arena * mArena;
+} StringIndex;
+
+// ============================================================================
+// === STRING INDEX: DECLARATION OF PRIVATE FUNCTIONS =========================
+// ============================================================================
+
+static size_t _cap_si_hash(const char * key);
+static size_t _cap_si_find_slot(
+    const StringIndex * si, const char * key, size_t hash);
+static size_t _cap_si_slots_for(size_t alloc, size_t count);
+static void _cap_si_resize(StringIndex * si, size_t alloc);
+
+// ============================================================================
+// === STRING INDEX FUNCTIONS =================================================
+// ============================================================================
+
+/**
+ * Creates a new empty `StringIndex` backed by an arena.
+ *
+ * The index and its slots are allocated from `arena`. The index is released
+ * when the arena is destroyed, `cap_si_destroy` may still be called but has
+ * no effect.
+ *
+ * @param arena arena to allocate from. If it is `NULL`, this is equivalent to
+ *        `cap_si_make_empty()`.
+ * @return new object
+ */
+StringIndex * cap_si_make_in(Arena * arena) {
+    StringIndex * si = (StringIndex *) cap_arena_alloc(
+        arena, sizeof(StringIndex));
+    *si = (StringIndex) {
+        .mSlots = NULL,
+        .mCount = 0u,
+        .mAlloc = 0u,
+        .mArena = arena
+    };
+    return si;
+}
+
+/**
+ * Creates a new empty `StringIndex`.
+ *
+ * The caller becomes the owner of the new object and should dispose of it
+ * using `cap_si_destroy`.
+ *
+ * @return new object
+ */
+StringIndex * cap_si_make_empty() {
+    return cap_si_make_in(NULL);
+}
+
+/**
+ * Destroys a `StringIndex`.
+ *
+ * Deallocates the index. Keys stored in it are not owned by the index, so they
+ * are not affected.
+ *
+ * @param si object to destroy. If it is `NULL`, nothing happens.
+ */
+void cap_si_destroy(StringIndex * si) {
+    if (!si) {
+        return;
+    }
+    cap_arena_free(si -> mArena, si -> mSlots);
+    cap_arena_free(si -> mArena, si);
+}
+
+/**
+ * Reserves space for keys.
+ *
+ * Makes sure that `count` keys can be stored in `si` without growing it. 
+ *
+ * @param si object to modify. If it is `NULL`, nothing happens.
+ * @param count number of keys to make room for
+ */
+void cap_si_reserve(StringIndex * si, size_t count) {
+    if (!si || !count) {
+        return;
+    }
+    const size_t alloc = _cap_si_slots_for(si -> mAlloc, count);
+    if (alloc != si -> mAlloc) {
+        _cap_si_resize(si, alloc);
+    }
+}
+
+/**
+ * Gets the number of bytes allocated for the slots of an index.
+ *
+ * Computes how many bytes are allocated for slots when `cap_si_reserve` is 
+ * called with `count` on an empty index.
+ *
+ * @param count number of keys to make room for
+ * @return size of the slot array in bytes
+ */
+size_t cap_si_reserved_size(size_t count) {
+    if (!count) {
+        return 0u;
+    }
+    return _cap_si_slots_for(0u, count) * sizeof(StringIndexSlot);
+}
+
+/**
+ * Gets the number of keys stored in a `StringIndex`.
+ *
+ * @param si object to measure
+ * @return number of keys, or zero if `si` is `NULL`
+ */
+size_t cap_si_length(const StringIndex * si) {
+    if (!si) {
+        return 0u;
+    }
+    return si -> mCount;
+}
+
+/**
+ * Looks up a key.
+ *
+ * Finds the value associated with `key`. If it is found and `value` is not
+ * `NULL`, the value is stored into `*value`.
+ *
+ * @param si object to search
+ * @param key null-terminated key to look for
+ * @param value output parameter for the found value, may be `NULL`
+ * @return `true` if `key` is stored in `si`. If `si` or `key` are `NULL`,
+ *         returns `false`.
+ */
+bool cap_si_find(const StringIndex * si, const char * key, size_t * value) {
+    if (!si || !key || !si -> mCount) {
+        return false;
+    }
+    const size_t slot = _cap_si_find_slot(si, key, _cap_si_hash(key));
+    const StringIndexSlot * s = si -> mSlots + slot;
+    if (!s -> mKey) {
+        return false;
+    }
+    if (value) {
+        *value = s -> mValue;
+    }
+    return true;
+}
+
+/**
+ * Associates a key with a value.
+ *
+ * Stores `key` in `si` with `value`. If `key` is already present, its value is
+ * replaced. Only the pointer `key` is stored, so the string must outlive its
+ * entry in the index.
+ *
+ * @param si object to insert into. If it is `NULL`, nothing happens.
+ * @param key null-terminated key. If it is `NULL`, nothing happens.
+ * @param value value to associate with `key`
+ */
+void cap_si_insert(StringIndex * si, const char * key, size_t value) {
+    if (!si || !key) {
+        return;
+    }
+    // keep the load factor below 0.7
+    if ((si -> mCount + 1u) * 10u > si -> mAlloc * 7u) {
+        cap_si_reserve(si, si -> mCount + 1u);
+    }
+    const size_t hash = _cap_si_hash(key);
+    StringIndexSlot * s = si -> mSlots + _cap_si_find_slot(si, key, hash);
+    if (!s -> mKey) {
+        ++si -> mCount;
+    }
+    *s = (StringIndexSlot) { .mKey = key, .mHash = hash, .mValue = value };
+}
+
+/**
+ * Removes a key.
+ *
+ * Removes `key` and its value from `si`. If the key is not present, nothing
+ * happens.
+ *
+ * @param si object to remove from
+ * @param key null-terminated key to remove
+ */
+void cap_si_remove(StringIndex * si, const char * key) {
+    if (!si || !key || !si -> mCount) {
+        return;
+    }
+    const size_t mask = si -> mAlloc - 1u;
+    size_t hole = _cap_si_find_slot(si, key, _cap_si_hash(key));
+    if (!si -> mSlots[hole].mKey) {
+        return;
+    }
+    // backward-shift deletion: move following entries of the same probe
+    // sequence into the hole so that no tombstones are needed
+    size_t i = hole;
+    while (true) {
+        i = (i + 1u) & mask;
+        const StringIndexSlot * s = si -> mSlots + i;
+        if (!s -> mKey) {
+            break;
+        }
+        const size_t home = s -> mHash & mask;
+        // the entry may only move if its home slot is not in (hole, i]
+        const bool stays = hole <= i
+            ? (hole < home && home <= i)
+            : (hole < home || home <= i);
+        if (stays) {
+            continue;
+        }
+        si -> mSlots[hole] = *s;
+        hole = i;
+    }
+    si -> mSlots[hole].mKey = NULL;
+    --si -> mCount;
+}
+
+// ============================================================================
+// === STRING INDEX: IMPLEMENTATION OF PRIVATE FUNCTIONS ======================
+// ============================================================================
+
+static size_t _cap_si_hash(const char * key) {
+    // 64-bit FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (const unsigned char * c = (const unsigned char *) key; *c; ++c) {
+        hash ^= *c;
+        hash *= 1099511628211ull;
+    }
+    return (size_t) (hash ^ (hash >> 32));
+}
+
+static size_t _cap_si_find_slot(
+        const StringIndex * si, const char * key, size_t hash) {
+    // returns the slot containing `key`, or the empty slot where it belongs
+    const size_t mask = si -> mAlloc - 1u;
+    size_t i = hash & mask;
+    while (true) {
+        const StringIndexSlot * s = si -> mSlots + i;
+        if (!s -> mKey) {
+            return i;
+        }
+        if (s -> mHash == hash && !strcmp(s -> mKey, key)) {
+            return i;
+        }
+        i = (i + 1u) & mask;
+    }
+}
+
+static size_t _cap_si_slots_for(size_t alloc, size_t count) {
+    static const size_t INIT_ALLOC = 16u;
+    alloc = alloc ? alloc : INIT_ALLOC;
+    // keep the load factor below 0.7
+    while (count * 10u > alloc * 7u) {
+        alloc *= 2u;
+    }
+    return alloc;
+}
+
+static void _cap_si_resize(StringIndex * si, size_t alloc) {
+    const size_t old_alloc = si -> mAlloc;
+    StringIndexSlot * old_slots = si -> mSlots;
+
+    si -> mAlloc = alloc;
+    si -> mSlots = (StringIndexSlot *) cap_arena_alloc(
+        si -> mArena, alloc * sizeof(StringIndexSlot));
+    memset(si -> mSlots, 0, alloc * sizeof(StringIndexSlot));
+    for (size_t i = 0u; i < old_alloc; ++i) {
+        const StringIndexSlot * s = old_slots + i;
+        if (!s -> mKey) {
+            continue;
+        }
+        size_t j = s -> mHash & (si -> mAlloc - 1u);
+        while (si -> mSlots[j].mKey) {
+            j = (j + 1u) & (si -> mAlloc - 1u);
+        }
+        si -> mSlots[j] = *s;
+    }
+    cap_arena_free(si -> mArena, old_slots);
+}
+
+/**
+ * @file
+ * @defgroup typed_union Data Types and Typed Unions
+ * 
+ * The `TypedUnion` structure is a cell of data marked with its type. This way,
+ * it is possible to store arbitrary data without using the exact type in code,
+ * (which would otherwise be necessary, since C is a statically typed language.)
+ * The actual type of data can be an integer (`int`), real number (`double`), or
+ * null-terminated string (`char *`). A special type is what this library calls
+ * "presence". It is used to identify the existence of something (e.g. a command
+ * line flag) which does not store an explicit value. The presence or absence of
+ * it itself *is* the information.
+ *
+ * The type of the value stored in a `TypedUnion` object corresponds to the
+ * value of a  `DataType` enum. Those values are `DT_INT`, `DT_DOUBLE`,
+ * `DT_STRING` and `DT_PRESENCE`. These identifiers are useful in other parts of
+ * the API as well.
+ * 
+ * `TypedUnion` instances should not be created directly. Insted, factory 
+ * functions such as `cap_tu_make_presence()` should be used. Similarly, when no
+ * longer needed, `TypedUnion`s should be deleted using `cap_tu_destroy()`.
+ * Descriptions of these functions is at the end of this section. Keep in mind
+ * that, `TypedUnion`s should only be destroyed by the part of the code which
+ * "owns" them. The user almost never needs to explicitly create (and own) those
+ * objects, and therefore does not directly call the `cap_tu_destroy()`
+ * function.
+ *
+ * Information can be extracted out of a `TypedUnion` using functions such as
+ * `cap_tu_is_double()` (to check if the given object has type `DT_DOUBLE`) or
+ * `cap_tu_as_double()` (to return the stored `double` value.)
+ */
+
+/**
+ * @addtogroup typed_union
+ * @{
+ */
+
+// ============================================================================
+// === TYPED UNION ============================================================
+// ============================================================================
+
+/**
+ * Elementary storage of values whose type is not known at compile-time.
+ * 
+ * For the purposes of the `cap` library, every value has a data type. That
+ * type is, however, not known at compile-time (because parsers are created by
+ * the user at run-time). Values are stored in a union type and marked with
+ * their type using the DataType enum.
+ * @see DataType.
+ * 
+ * The type of a TypedUnion should always be inspected using functions such as
+ * `cap_tu_is_double()`, and values from them should only be extracted using
+ * functions such as `cap_tu_as_double()`, and after checking the type.
+ * @see cap_tu_is_double
+ * @see cap_tu_is_int
+ * @see cap_tu_is_presence
+ * @see cap_tu_is_string
+ * @see cap_tu_as_double
+ * @see cap_tu_as_int
+ * @see cap_tu_as_string
+ * 
+ * `TypedUnion` objects should always be created using factory functions such
+ * as `cap_tu_make_double()`.
+ * @see cap_tu_make_double
+ * @see cap_tu_make_int
+ * @see cap_tu_make_presence
+ * @see cap_tu_make_string
+ */
+typedef struct {
+    /// type of the stored value
+    DataType mType;
+    union {
+        /// stores the value for DT_INT type
+        int asInt;
+        /// stores the value for DT_DOUBLE type
+        double asDouble;
+        /// stores the value for DT_STRING type
+        char * asString;
+    } mValue;
+} TypedUnion;
+
+// ============================================================================
+// === TYPED UNION CREATION AND DESTRUCTION ===================================
+// ============================================================================
+
+/**
+ * Create a new `TypedUnion` of type `double`
+ */
+TypedUnion cap_tu_make_double(double value) {
+    return (TypedUnion) { .mType = DT_DOUBLE, .mValue = { .asDouble = value } };
+}
+
+/**
+ * Create a new `TypedUnion` of type `int`
+ */
+TypedUnion cap_tu_make_int(int value) {
+    return (TypedUnion) { .mType = DT_INT, .mValue = { .asInt = value } };
+}
+
+/**
+ * Create a new `TypedUnion` of type `presence`
+ * 
+ * The presence type is used for flags that do not store any explicit value.
+ */
+TypedUnion cap_tu_make_presence() {
+    return (TypedUnion) { .mType = DT_PRESENCE };
+}
+
+/**
+ * Create a new `TypedUnion` of type `string`
+ * 
+ * `TypedUnion`s created by this factory contain a dynamically allocated copy
+ * of the string used to create them. The owner of this object should dispose
+ * of it using the function `cap_tu_destroy`. `TypedUnion` objects are usually 
+ * owned by a `ParsedArguments` object so users of the `cap` library do not 
+ * need to call `cap_du_destroy` directly.
+ */
+TypedUnion cap_tu_make_string(const char * value) {
+    char * const value_copy = copy_string(value);
+    return (TypedUnion) { .mType = DT_STRING, .mValue = { .asString = value_copy } };
+}
+
+/**
+ * Destroys a `TypedUnion` object
+ * 
+ * Destroys a `TypedUnion` object when it is no longer needed. Destruction only 
+ * has effect if the type is `DT_STRING`, as only that type contains 
+ * dynamically allocated memory that must be freed.
+ * 
+ * @param tu `TypedUnion` to destroy. This function does nothing if `tu` is 
+ *        NULL`.
+ */
+void cap_tu_destroy(TypedUnion * tu) {
+    if (!tu) return;
+    if (tu -> mType != DT_STRING) {
+        return;
+    }
+    cap_free(tu -> mValue.asString);
+    tu -> mValue.asString = NULL;
+}
+
+// ============================================================================
+// === TYPED UNION CHECKS =====================================================
+// ============================================================================
+
+/**
+ * Checks if `tu` has type `DT_DOUBLE`.
+ */
+bool cap_tu_is_double(const TypedUnion * tu) {
+    return tu -> mType == DT_DOUBLE;
+}
+
+/**
+ * Checks if `tu` has type `DT_INT`.
+ */
+bool cap_tu_is_int(const TypedUnion * tu) {
+    return tu -> mType == DT_INT;
+}
+
+/**
+ * Checks if `tu` has type `DT_PRESENCE`.
+ */
+bool cap_tu_is_presence(const TypedUnion * tu) {
+    return tu -> mType == DT_PRESENCE;
+}
+
+/**
+ * Checks if `tu` has type `DT_STRING`.
+ */
+bool cap_tu_is_string(const TypedUnion * tu) {
+    return tu -> mType == DT_STRING;
+}
+
+// ============================================================================
+// === TYPED UNION CONVERSIONS ================================================
+// ============================================================================
+
+/**
+ * Retrieves a `double` value.
+ * 
+ * @param tu typed union to take the value from. It must be of type DT_DOUBLE.
+ *        The type is checked using an `assert` statement.
+ * @return `double` value stored int `tu`
+ */
+double cap_tu_as_double(const TypedUnion * tu) {
+    assert(tu -> mType == DT_DOUBLE);
+    return tu -> mValue.asDouble;
+}
+
+/**
+ * Retrieves an `int` value.
+ * 
+ * @param tu typed union to take the value from. It must be of type `DT_INT`.
+ *        The type is checked using an `assert` statement.
+ * @return `int` value stored int `tu`
+ */
+int cap_tu_as_int(const TypedUnion * tu) {
+    assert(tu -> mType == DT_INT);
+    return tu -> mValue.asInt;
+}
+
+/**
+ * Retrieves a string value.
+ * 
+ * Retrieves a pointer to the null-terminated string stored in `tu`. Note that, 
+ * `tu` remains the owner of the string returned. Most importantly, the 
+ * returned pointer becomes invalid after `tu` is destroyed using
+ * `cap_tu_destroy`.
+ * 
+ * @param tu typed union to take the value from. It must be of type 
+ *        `DT_STRING`. The type is checked using an `assert` statement.
+ * @return Pointer to the string stored in `tu`.
+ */
+const char * cap_tu_as_string(const TypedUnion * tu) {
+    assert(tu -> mType == DT_STRING);
+    return tu -> mValue.asString;
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @file
+ * @defgroup named_values Data Storage as Named Values
+ * 
+ * The `NamedValues` structure associates one or more values associated with a
+ * string identifier. It is used internally in a `ParsedArguments` object and
+ * users never need to interact with it directly. The library offers several
+ * functions for creating, deleting, and modifying `NamedValues` objects. They
+ * are prefixed with `cap_nv_`.
+ * 
+ * `TypedUnion` objects are used to store data. The name is stored as a
+ * null-terminated string, and it is owned by the `NamedValues` object. For that
+ * reason instances of `NamedValues` should be created using `cap_nv_make()`
+ * or `cap_nv_make_empty()` and destroyed using `cap_nv_destroy()`. Calling the
+ * destructor function ivalidates all data obtained from the object, e.g.
+ * pointers to `TypedUnion`s.
+ * 
+ * A `NamedValues` stored in a `NamedValuesArray` may be backed by an `Arena`. 
+ * Its name, values, and strings stored in the values are then owned by the 
+ * arena and released together with it.
+ * 
+ * Most flags and positionals have a single value, so the first value is stored
+ * inline in the `NamedValues` object itself. A separate array is only
+ * allocated once more values are added.
+ *
+ * Values are normally stored as an array of `TypedUnion`s. If packing is
+ * enabled (it is by parsers configured using
+ * `cap_parser_enable_packed_values`), all values of one flag or positional
+ * normally have the same type, which is then recorded once, and the values
+ * are stored as a packed native array (`int[]`, `double[]` or `char *[]`).
+ * Functions such as `cap_nv_get_ints` return such an array directly. The
+ * first value is kept inline as well, so `cap_nv_get_value` always finds it,
+ * while `cap_nv_get_value_i` fails for the following packed values (except
+ * for `DT_PRESENCE` values, which are all the same). Values of different
+ * types can still be stored in one object, they are then kept as
+ * `TypedUnion`s.
+ */
+
+/**
+ * @addtogroup named_values
+ * @{
+ */
+
+/// number of values stored inline in a `NamedValues` before allocating
+#define _CAP_NV_INLINE_VALUES 1u
+
+// ============================================================================
+// === NAMED VALUES ===========================================================
+// ============================================================================
+
+/**
+ * Stores values for a flag or positional argument in a `ParsedArguments`
+ * object.
+ * 
+ * Stores the values associated with a single flag or positional in
+ * a `ParsedArguments` object. Objects of this type should never be directly
+ * created or accessed by the user.
+ * 
+ * @see ParsedArguments
+ * @see TypedUnion
+ */
+typedef struct {
+    /// Name of the flag or posittional. The object should be considered the
+    /// 'owner' of this string.
+    char * mName;
+    /// Type of all stored values, valid once a value is stored
+    DataType mType;
+    /// `true` if `mValues` holds `TypedUnion`s, because packing is disabled or
+    /// values of different types were stored
+    bool mMixed;
+    /// `true` if values of one type may be stored in a packed array
+    bool mPack;
+    /// Packed array of stored values, e.g. `int[]` for `DT_INT`, or `NULL`
+    /// while the values fit into `mInline`. This object should be considered
+    /// the owner of these values.
+    void * mValues;
+    /// Number of values stored for this flag/positional
+    size_t mValueCount;
+    /// Number of bytes allocated for `mValues`
+    size_t mValueAlloc;
+    /// Storage for the first values, used while `mValues` is not allocated.
+    /// Once the values are packed, the first one is still kept here.
+    TypedUnion mInline[_CAP_NV_INLINE_VALUES];
+    /// Arena which owns the name, values, and strings stored in the values, 
+    /// or `NULL` if they are allocated on the heap
+    Arena * mArena;
+} NamedValues;
+
+// ============================================================================
+// === NAMED VALUES: DECLARATION OF PRIVATE FUNCTIONS =========================
+// ============================================================================
+
+static NamedValues * _cap_nv_make_empty_inner(const char * name);
+static size_t _cap_nv_value_size(DataType type);
+static size_t _cap_nv_element_size(const NamedValues * nv);
+static bool _cap_nv_is_packed(const NamedValues * nv);
+static TypedUnion _cap_nv_load(const NamedValues * nv, size_t index);
+static void _cap_nv_store(
+    NamedValues * nv, size_t index, const TypedUnion value);
+static const void * _cap_nv_span(
+    const NamedValues * nv, DataType type, size_t * count);
+static void _cap_nv_enable_packing(NamedValues * nv, bool enable);
+static size_t _cap_nv_reserved_size(DataType type, size_t count, bool pack);
+static void _cap_nv_append_value_inner(
+    NamedValues * nv, const TypedUnion value);
+static void _cap_nv_append_value_copy(NamedValues * nv, const TypedUnion value);
+static void * _cap_nv_extend(NamedValues * nv, DataType type, size_t count);
+static void _cap_nv_commit(NamedValues * nv, size_t count);
+static void _cap_nv_pack(NamedValues * nv);
+static void _cap_nv_mix(NamedValues * nv);
+static void _cap_nv_reserve(NamedValues * nv, size_t size);
+
+// ============================================================================
+// === NAMED VALUES ===========================================================
+// ============================================================================
+
+/**
+ * Creates a new empty NamedValues object
+ * 
+ * Creates a new empty NamedValues object with the name `name` and, of course,
+ * no values. Objects created this way should be disposed of using
+ * `cap_nv_destroy`. 
+ * 
+ * @param name null-terminated name of the object. A copy of this string is
+ *        stored in the object; if it is `NULL`, nothing happens.
+ * @return new object
+ */
+NamedValues * cap_nv_make_empty(const char * name) {
+    if (!name) {
+        return NULL;
+    }
+    return _cap_nv_make_empty_inner(name);
+}
+
+/**
+ * Creates a new NamedValues object initialized with a value
+ * 
+ * Creates a new `NamedValues` object with the name `name` and containing
+ * `value` as the only value. Objects created this way should be disposed of
+ * using `cap_nv_destroy`. 
+ * 
+ * @param name null-terminated name of the object. A copy of this string is
+ *        stored in the object; if it is `NULL`, nothing happens.
+ * @param value value to initialize the new object with
+ * @return new object
+ */
+NamedValues * cap_nv_make(const char * name, const TypedUnion value) {
+    if (!name) {
+        return NULL;
+    }
+    NamedValues * nv = _cap_nv_make_empty_inner(name);
+    nv -> mType = value.mType;
+    nv -> mInline[0] = value;
+    nv -> mValueCount = 1u;
+    return nv;
+}
+
+/**
+ * Removes all values stored in `nv`
+ * 
+ * Destrys all values tored in `nv` and de-allocates the storage array.
+ * 
+ * @param nv object to remove values from
+ */
+void cap_nv_clear_values(NamedValues * nv) {
+    if (!nv) {
+        return;
+    }
+    if (!nv -> mArena) {
+        for (size_t i = 0u; i < nv -> mValueCount; ++i) {
+            TypedUnion value = _cap_nv_load(nv, i);
+            cap_tu_destroy(&value);
+        }
+    }
+    if (nv -> mValues) {
+        cap_arena_free(nv -> mArena, nv -> mValues);
+        nv -> mValues = NULL;
+    }
+    nv -> mValueCount = nv -> mValueAlloc = 0u;
+    nv -> mMixed = !nv -> mPack;
+}
+
+/**
+ * Destroys a namedValues instance
+ * 
+ * Destroys a given `NamedValues` object. Its name and all values stored in it
+ * are also destroyed, and references to values obtained from this are
+ * no longer valid.
+ * 
+ * @param nv object to destroy; if if is `NULL`, nothing happens.
+ */
+void cap_nv_destroy(NamedValues * nv) {
+    if (!nv) {
+        return;
+    }
+    cap_nv_clear_values(nv);
+    cap_arena_free(nv -> mArena, nv -> mName);
+    nv -> mName = NULL;
+}
+
+/**
+ * Adds a new value to a NamedValues object
+ * 
+ * Adds a new value `value` to the `NamedValues` object `nv`. `nv` becomes the
+ * owner of `value`. Only newly created `TypedUnion` values should be given
+ * to this function.
+ * 
+ * 
+ * 
+ * If `nv` is backed by an arena, the arena takes over ownership of a string
+ * stored in `value`.
+ * 
+ * @param nv object to append to; if if is `NULL`, nothing happens.
+ * @param value value to add
+ */
+void cap_nv_append_value(NamedValues * nv, const TypedUnion value) {
+    if (!nv) {
+        return;
+    }
+    if (value.mType == DT_STRING) {
+        cap_arena_adopt(nv -> mArena, value.mValue.asString);
+    }
+    _cap_nv_append_value_inner(nv, value);
+}
+
+/**
+ * Number of values stored
+ * 
+ * Returns the number of values tored in `nv`. If `nv` is NULL, returns zero.
+ * 
+ * @param nv object to search; if it is NULL, zero is returned.
+ */
+size_t cap_nv_value_count(const NamedValues * nv) {
+    if (!nv) {
+        return 0u;
+    }
+    return nv -> mValueCount;
+}
+
+/**
+ * Gets a stored value at a given index.
+ * 
+ * Returns a pointer to a value stored in `nv` at the positiona `index`.
+ * NULL is returned if `nv` is NULL or if `index` is out of range. The values
+ * are stored in a contiguous array, so the pointer can be used to access the
+ * following values as well.
+ * 
+ * If packing is enabled and the values are stored in a packed array, there
+ * are no `TypedUnion`s to point to, so only the first value (which is also
+ * kept inline) is returned, and NULL for the other indices. These values are
+ * accessed using functions such as `cap_nv_get_ints` instead. `DT_PRESENCE`
+ * values carry no data, so a pointer to the first one is returned for any
+ * index. The returned pointer can then not be used to access the following
+ * values. This function never modifies `nv`, so it may be called from
+ * several threads at once.
+ * 
+ * @param nv object to search; if it is NULL, NULL is returned
+ * @param index index of the value to return, starting at zero; if it is out of
+ *        range (i.e. `index >= # of values in nv`), NULL is returned
+ * @return pointer to the referenced value, or NULL
+ */
+const TypedUnion * cap_nv_get_value_i(const NamedValues * nv, size_t index) {
+    if (!nv || nv -> mValueCount <= index) {
+        return NULL;
+    }
+    if (!_cap_nv_is_packed(nv)) {
+        return nv -> mInline + index;
+    }
+    if (nv -> mMixed) {
+        return (const TypedUnion *) nv -> mValues + index;
+    }
+    if (!index || nv -> mType == DT_PRESENCE) {
+        return nv -> mInline;
+    }
+    return NULL;
+}
+
+/**
+ * Gets the first stored value
+ * 
+ * Returns the first value stored in `nv`, or NULL if `nv` is NULL. If no 
+ * values are stored in `nv`, also returns NULL. This behaviour is identical 
+ * to `cap_nv_get_value_i(nv, 0u)`.
+ * 
+ * @param nv object to search; if it is NULL, NULL is returned
+ * @return pointer to the first value stored, or NULL if there are no values
+ */
+const TypedUnion * cap_nv_get_value(const NamedValues * nv) {
+    return cap_nv_get_value_i(nv, 0u);
+}
+
+/**
+ * Gets all stored values of type `DT_INT` as an array
+ * 
+ * Returns the values stored in `nv` as a contiguous array of `int`, and
+ * stores their number in `count`. Returns `NULL` (and stores zero) if `nv` is
+ * `NULL`, empty, if packing is not enabled for it, or if not all of its 
+ * values have type `DT_INT`. The array is owned by `nv` and valid until 
+ * values are added to it.
+ * 
+ * @param nv object to search
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const int * cap_nv_get_ints(const NamedValues * nv, size_t * count) {
+    return (const int *) _cap_nv_span(nv, DT_INT, count);
+}
+
+/**
+ * Gets all stored values of type `DT_DOUBLE` as an array
+ * 
+ * The same as `cap_nv_get_ints`, for values of type `DT_DOUBLE`.
+ * 
+ * @param nv object to search
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const double * cap_nv_get_doubles(const NamedValues * nv, size_t * count) {
+    return (const double *) _cap_nv_span(nv, DT_DOUBLE, count);
+}
+
+/**
+ * Gets all stored values of type `DT_STRING` as an array
+ * 
+ * The same as `cap_nv_get_ints`, for values of type `DT_STRING`. The strings
+ * are owned by `nv` as well.
+ * 
+ * @param nv object to search
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const char * const * cap_nv_get_strings(
+        const NamedValues * nv, size_t * count) {
+    return (const char * const *) _cap_nv_span(nv, DT_STRING, count);
+}
+
+// ============================================================================
+// === NAMED VALUES: IMPLEMENTATION OF PRIVATE FUNCTIONS ======================
+// ============================================================================
+
+static NamedValues * _cap_nv_make_empty_inner(const char * name) {
+    NamedValues * nv = (NamedValues *) cap_malloc(sizeof(NamedValues));
+    *nv = (NamedValues) {
+        .mName = copy_string(name),
+        .mMixed = true,
+        .mPack = false,
+        .mValues = NULL,
+        .mValueCount = 0u,
+        .mValueAlloc = 0u,
+        .mArena = NULL
+    };
+    return nv;
+}
+
+static size_t _cap_nv_value_size(DataType type) {
+    // size of one value in a packed array
+    switch (type) {
+        case DT_INT:
+            return sizeof(int);
+        case DT_DOUBLE:
+            return sizeof(double);
+        case DT_STRING:
+            return sizeof(char *);
+        default:
+            return 0u;
+    }
+}
+
+static size_t _cap_nv_element_size(const NamedValues * nv) {
+    return nv -> mMixed ? sizeof(TypedUnion) : _cap_nv_value_size(nv -> mType);
+}
+
+static bool _cap_nv_is_packed(const NamedValues * nv) {
+    // presence values need no storage, so `mValues` may stay `NULL`
+    return nv -> mValues || nv -> mValueCount > _CAP_NV_INLINE_VALUES;
+}
+
+static TypedUnion _cap_nv_load(const NamedValues * nv, size_t index) {
+    if (!_cap_nv_is_packed(nv)) {
+        return nv -> mInline[index];
+    }
+    if (nv -> mMixed) {
+        return ((const TypedUnion *) nv -> mValues)[index];
+    }
+    switch (nv -> mType) {
+        case DT_INT:
+            return cap_tu_make_int(((const int *) nv -> mValues)[index]);
+        case DT_DOUBLE:
+            return cap_tu_make_double(((const double *) nv -> mValues)[index]);
+        case DT_STRING:
+            return (TypedUnion) {
+                .mType = DT_STRING,
+                .mValue = { .asString = ((char **) nv -> mValues)[index] }
+            };
+        default:
+            return cap_tu_make_presence();
+    }
+}
+
+static void _cap_nv_store(
+        NamedValues * nv, size_t index, const TypedUnion value) {
+    if (!index) {
+        nv -> mInline[0] = value;
+    }
+    if (nv -> mMixed) {
+        ((TypedUnion *) nv -> mValues)[index] = value;
+        return;
+    }
+    switch (nv -> mType) {
+        case DT_INT:
+            ((int *) nv -> mValues)[index] = value.mValue.asInt;
+            break;
+        case DT_DOUBLE:
+            ((double *) nv -> mValues)[index] = value.mValue.asDouble;
+            break;
+        case DT_STRING:
+            ((char **) nv -> mValues)[index] = value.mValue.asString;
+            break;
+        default:
+            break;
+    }
+}
+
+static const void * _cap_nv_span(
+        const NamedValues * nv, DataType type, size_t * count) {
+    const bool found = nv && nv -> mValueCount && !nv -> mMixed
+        && nv -> mType == type;
+    if (count) {
+        *count = found ? nv -> mValueCount : 0u;
+    }
+    if (!found) {
+        return NULL;
+    }
+    if (_cap_nv_is_packed(nv)) {
+        return nv -> mValues;
+    }
+    // a single value is an array as well
+    const TypedUnion * value = nv -> mInline;
+    switch (type) {
+        case DT_INT:
+            return &(value -> mValue.asInt);
+        case DT_DOUBLE:
+            return &(value -> mValue.asDouble);
+        default:
+            return &(value -> mValue.asString);
+    }
+}
+
+static void _cap_nv_enable_packing(NamedValues * nv, bool enable) {
+    // only called for empty objects, their values are not converted
+    nv -> mPack = enable;
+    nv -> mMixed = !enable;
+}
+
+static size_t _cap_nv_reserved_size(DataType type, size_t count, bool pack) {
+    // bytes `_cap_nv_reserve` needs for `count` values of type `type` in an
+    // empty object, packed or as `TypedUnion`s
+    return count > _CAP_NV_INLINE_VALUES 
+        ? count * (pack ? _cap_nv_value_size(type) : sizeof(TypedUnion))
+        : 0u;
+}
+
+static void _cap_nv_append_value_inner(
+        NamedValues * nv, const TypedUnion value) {
+    if (!nv -> mValueCount && !nv -> mMixed) {
+        nv -> mType = value.mType;
+    }
+    else if (value.mType != nv -> mType && !nv -> mMixed) {
+        _cap_nv_mix(nv);
+    }
+    if (!_cap_nv_is_packed(nv)) {
+        if (nv -> mValueCount < _CAP_NV_INLINE_VALUES) {
+            nv -> mInline[nv -> mValueCount++] = value;
+            return;
+        }
+        _cap_nv_pack(nv);
+    }
+    const size_t size = _cap_nv_element_size(nv);
+    if ((nv -> mValueCount + 1u) * size > nv -> mValueAlloc) {
+        const size_t alloc = nv -> mValueAlloc / size;
+        _cap_nv_reserve(
+            nv, (alloc > nv -> mValueCount ? alloc : nv -> mValueCount) 
+                * 2u * size);
+    }
+    _cap_nv_store(nv, nv -> mValueCount++, value);
+}
+
+static void * _cap_nv_extend(NamedValues * nv, DataType type, size_t count) {
+    // makes room for `count` more packed values of type `type` and returns
+    // it, so that they can be written directly. The caller then passes the
+    // number of values it wrote to `_cap_nv_commit`. Returns `NULL` if the
+    // values cannot be packed (or need not be, because they fit inline).
+    if (!nv -> mValueCount && !nv -> mMixed) {
+        nv -> mType = type;
+    }
+    const size_t size = _cap_nv_value_size(type);
+    if (nv -> mMixed || nv -> mType != type || !size) {
+        return NULL;
+    }
+    if (!_cap_nv_is_packed(nv)) {
+        if (nv -> mValueCount + count <= _CAP_NV_INLINE_VALUES) {
+            return NULL;
+        }
+        _cap_nv_pack(nv);
+    }
+    const size_t needed = (nv -> mValueCount + count) * size;
+    if (needed > nv -> mValueAlloc) {
+        const size_t doubled = 2u * nv -> mValueCount * size;
+        _cap_nv_reserve(nv, needed > doubled ? needed : doubled);
+    }
+    return (char *) nv -> mValues + nv -> mValueCount * size;
+}
+
+static void _cap_nv_commit(NamedValues * nv, size_t count) {
+    // adds `count` values written into the array returned by `_cap_nv_extend`
+    const bool first = !nv -> mValueCount && count;
+    nv -> mValueCount += count;
+    if (first) {
+        nv -> mInline[0] = _cap_nv_load(nv, 0u);
+    }
+}
+
+static void _cap_nv_pack(NamedValues * nv) {
+    // moves the inline values into a packed array
+    const size_t size = _cap_nv_element_size(nv);
+    _cap_nv_reserve(nv, 2u * _CAP_NV_INLINE_VALUES * size);
+    if (!nv -> mValues) {
+        // presence values take no space, they are packed once there are
+        // more of them than fit inline
+        return;
+    }
+    for (size_t i = 0u; i < nv -> mValueCount; ++i) {
+        _cap_nv_store(nv, i, nv -> mInline[i]);
+    }
+}
+
+static void _cap_nv_mix(NamedValues * nv) {
+    // converts the values to `TypedUnion`s, so that values of another type
+    // can be added
+    if (_cap_nv_is_packed(nv)) {
+        const size_t count = nv -> mValueCount;
+        TypedUnion * values = (TypedUnion *) cap_arena_alloc(
+            nv -> mArena, (count ? count : 1u) * 2u * sizeof(TypedUnion));
+        for (size_t i = 0u; i < count; ++i) {
+            values[i] = _cap_nv_load(nv, i);
+        }
+        cap_arena_free(nv -> mArena, nv -> mValues);
+        nv -> mValues = values;
+        nv -> mValueAlloc = (count ? count : 1u) * 2u * sizeof(TypedUnion);
+    }
+    nv -> mMixed = true;
+}
+
+static void _cap_nv_reserve(NamedValues * nv, size_t size) {
+    // makes room for exactly `size` bytes of packed values in total
+    if (size <= nv -> mValueAlloc) {
+        return;
+    }
+    nv -> mValues = cap_arena_realloc(
+        nv -> mArena, nv -> mValues, nv -> mValueAlloc, size);
+    nv -> mValueAlloc = size;
+}
+
+static void _cap_nv_append_value_copy(
+        NamedValues * nv, const TypedUnion value) {
+    // appends a value whose string (if any) is not owned by anyone yet
+    TypedUnion copy = value;
+    if (value.mType == DT_STRING) {
+        copy.mValue.asString = cap_arena_copy_string(
+            nv -> mArena, value.mValue.asString);
+    }
+    _cap_nv_append_value_inner(nv, copy);
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @file
+ * @addtogroup named_values
+ * 
+ * `NamedValuesArray` stores several `NamedValues` objects, implementing a
+ * primitive multi-map of `string --> TypedUnion`. `NamedValuesArray` objects
+ * are used internally by `ParsedArguments` and users of the library never needs
+ * to interact with them directly. Regardless, the API offers several functions
+ * for creating, deleting, and modifying these objects. These functions are
+ * prefixed with `cap_nva_`.
+ * 
+ * `NamedValuesArray` objects should be created using `cap_nva_make_empty()` and
+ * deleted using `cap_nva_destroy()`. After destroying the object, all
+ * information obtained from it is invalid. e.g. pointers to stored
+ * `TypedUnion`s.
+ * 
+ * A `NamedValuesArray` created using `cap_nva_make_in` is backed by an `Arena`
+ * and so is everything stored in it. Such objects are released together with 
+ * the arena.
+ */
+
+/**
+ * @addtogroup named_values
+ * @{
+ */
+
+// ============================================================================
+// === NAMED VALUES ARRAY =====================================================
+// ============================================================================
+
+/**
+ * List of NamedValues instances.
+ * 
+ * Stores a list of NamedValues instances in a contiguous array of slots. Each 
+ * slot has a stable position, which does not change when other slots are 
+ * added. Slots can be looked up by name, using an index, or by position.
+ * 
+ * A slot may be empty (i.e. have no name and no values) if it was reserved 
+ * using `cap_nva_make_reserved` and no value has been stored in it yet.
+ */
+typedef struct {
+    /// slots, each storing values for a single name
+    NamedValues * mItems;
+    /// number of slots, including empty ones
+    size_t mCount;
+    /// number of slots that can be stored in `mItems`
+    size_t mAlloc;
+    /// maps names of non-empty slots to their position in `mItems`
+    StringIndex * mIndex;
+    /// arena which owns the object and all data stored in it, or `NULL` if
+    /// they are allocated on the heap
+    Arena * mArena;
+    /// `true` if values stored in new slots may be packed, see
+    /// `_cap_nva_enable_packing`
+    bool mPackValues;
+} NamedValuesArray;
+
+// ============================================================================
+// === NAMED VALUES ARRAY: DECLARATION OF PRIVATE FUNCTIONS ===================
+// ============================================================================
+
+static size_t _cap_nva_add_slots(NamedValuesArray * nva, size_t count);
+static void _cap_nva_append_parsed_value_at(
+    NamedValuesArray * nva, size_t position, const char * name,
+    const TypedUnion value, bool borrow);
+static NamedValues * _cap_nva_named_slot_at(
+    NamedValuesArray * nva, size_t position, const char * name);
+static void _cap_nva_name_slot(
+    NamedValuesArray * nva, size_t position, const char * name);
+static void _cap_nva_enable_packing(NamedValuesArray * nva, bool enable);
+
+// ============================================================================
+// === NAMED VALUES ARRAY FUNCTIONS ===========================================
+// ============================================================================
+
+/**
+ * Creates a new NamedValuesArray object backed by an arena
+ * 
+ * Behaves like `cap_nva_make_reserved`, but the new object and everything 
+ * stored in it are allocated from `arena`. The arena also takes over 
+ * ownership of strings stored in values added to the object. The object is released when the arena 
+ * is destroyed, `cap_nva_destroy` may still be called but has no effect.
+ * 
+ * @param arena arena to allocate from; if it is NULL, the object is allocated
+ *        on the heap
+ * @param count number of slots to reserve
+ * @return new object
+ */
+NamedValuesArray * cap_nva_make_in(Arena * arena, size_t count) {
+    NamedValuesArray * nva = (NamedValuesArray *) cap_arena_alloc(
+        arena, sizeof(NamedValuesArray));
+    // reserved slots are allocated exactly, so that the size of an arena
+    // for a known number of slots can be computed
+    nva -> mItems = count ? (NamedValues *) cap_arena_alloc(
+        arena, count * sizeof(NamedValues)) : NULL;
+    nva -> mCount = 0u;
+    nva -> mAlloc = count;
+    nva -> mArena = arena;
+    nva -> mPackValues = false;
+    nva -> mIndex = cap_si_make_in(arena);
+    cap_si_reserve(nva -> mIndex, count);
+    _cap_nva_add_slots(nva, count);
+    return nva;
+}
+
+/**
+ * Creates a new NamedValuesArray object with reserved slots
+ * 
+ * Creates and returns a new NamedValuesArray object containing `count` empty 
+ * slots at positions `0` to `count - 1`. These slots can be filled using 
+ * `cap_nva_append_value_at`. Slots for other names can still be added by 
+ * `cap_nva_append_value` and `cap_nva_set_value`, their positions follow 
+ * after the reserved ones. Instances created this way should be disposed of
+ * using `cap_nva_destroy`.
+ * 
+ * @param count number of slots to reserve
+ * @return new object
+ */
+NamedValuesArray * cap_nva_make_reserved(size_t count) {
+    return cap_nva_make_in(NULL, count);
+}
+
+/**
+ * Creates a new empty NamedValuesArray object
+ * 
+ * Creates and returns a new empty NamdeValuesArray object. Instances created
+ * this way should be disposed of using `cap_nva_destroy`.
+ */
+NamedValuesArray * cap_nva_make_empty() {
+    return cap_nva_make_reserved(0u);
+}
+
+/**
+ * Destroys a `NamedValuesArray` object
+ * 
+ * Destroys a `NamedValuesArray` object and all data stored in it. Any pointers
+ * obtained from `nva` before this call become invalid.
+ * 
+ * @param nva object to destroy; if it is NULL, nothing happens
+ */
+void cap_nva_destroy(NamedValuesArray * nva) {
+    if (!nva) {
+        return;
+    }
+    if (nva -> mArena) {
+        // everything is released together with the arena
+        return;
+    }
+    for (size_t i = 0u; i < nva -> mCount; ++i) {
+        cap_nv_destroy(nva -> mItems + i);
+    }
+    cap_free(nva -> mItems);
+    cap_si_destroy(nva -> mIndex);
+    cap_free(nva);
+}
+
+/**
+ * Gets the number of slots in a NamedValuesArray object
+ * 
+ * Returns the number of slots (`NamedValues` objects) stored in `nva`, 
+ * including empty reserved slots. If `nva` is NULL, always returns zero.
+ * 
+ * @param nva object to measure
+ * @return number of slots, or zero if `nva` is NULL
+ */
+size_t cap_nva_length(const NamedValuesArray * nva) {
+    if (!nva) {
+        return 0u;
+    }
+    return nva -> mCount;
+}
+
+/**
+ * Gets a `NamedValues` with a given name
+ * 
+ * Returns a `NamedValues` object stored in `nva` with the name `name`. 
+ * If `nva` or `name` are NULL, returns NULL. If no object named `name` is
+ * present also returns NULL.
+ * 
+ * @param nva object to search
+ * @param name of the item to look for
+ * @return pointer to the NamedValues with the name `name`, or NULL if no such
+ *         object is stored
+ */
+NamedValues * cap_nva_get(const NamedValuesArray * nva, const char * name) {
+    size_t position;
+    if (!nva || !cap_si_find(nva -> mIndex, name, &position)) {
+        return NULL;
+    }
+    return nva -> mItems + position;
+}
+
+/**
+ * Gets a `NamedValues` at a given position
+ * 
+ * Returns the `NamedValues` object stored in `nva` at `position`. If `nva` is 
+ * NULL, `position` is out of range, or the slot at `position` is empty, 
+ * returns NULL.
+ * 
+ * @param nva object to search
+ * @param position position of the slot
+ * @return pointer to the NamedValues at `position`, or NULL
+ */
+NamedValues * cap_nva_get_at(const NamedValuesArray * nva, size_t position) {
+    if (!nva || position >= nva -> mCount) {
+        return NULL;
+    }
+    NamedValues * item = nva -> mItems + position;
+    return item -> mName ? item : NULL;
+}
+
+/**
+ * Appends a value to a `NamedValues` with a given name
+ * 
+ * Attempts to find a `NamedValues` object stored in `nva`. If it is found, 
+ * appends `value` to it. Else a new `NamedValues` is created with the given 
+ * `name` and `value` and it is stored in `nva`.
+ * 
+ * If `nva` or `name` are NULL, nothing happens.
+ * 
+ * @param nva object to search
+ * @param name name of the `NamedValues` to append to
+ * @param value value to append to the object found
+ */
+void cap_nva_append_value(
+    NamedValuesArray * nva, const char * name, const TypedUnion value)
+{
+    if (!nva || !name) {
+        return;
+    }
+    size_t position;
+    if (!cap_si_find(nva -> mIndex, name, &position)) {
+        // insert a new item at the end
+        position = _cap_nva_add_slots(nva, 1u);
+        _cap_nva_name_slot(nva, position, name);
+    }
+    cap_nv_append_value(nva -> mItems + position, value);
+}
+
+/**
+ * Appends a value to a `NamedValues` at a given position
+ * 
+ * Appends `value` to the slot at `position`. If the slot is empty, it is 
+ * given the name `name` first. If the slot already has a name, `name` is 
+ * ignored. 
+ * 
+ * If `nva` or `name` are NULL, or `position` is out of range, nothing 
+ * happens. The caller must make sure that the name of an empty slot is not
+ * already used by another slot.
+ * 
+ * @param nva object to modify
+ * @param position position of the slot
+ * @param name name for the slot if it is empty
+ * @param value value to append
+ */
+void cap_nva_append_value_at(
+    NamedValuesArray * nva, size_t position, const char * name,
+    const TypedUnion value)
+{
+    if (!nva || !name || position >= nva -> mCount) {
+        return;
+    }
+    NamedValues * item = nva -> mItems + position;
+    if (!item -> mName) {
+        _cap_nva_name_slot(nva, position, name);
+    }
+    cap_nv_append_value(item, value);
+}
+
+/**
+ * Sets a value for a `NamedValues` with a given name
+ * 
+ * Attempts to find a `NamedValues` object stored in `nva`. If it is found, 
+ * replaces its value(s) with a new given `value`. If it is not found, a new
+ * `NamedValues` is created with `name` and `value`.
+ * 
+ * If `nva` or `name` are NULL, nothing happens.
+ * 
+ * @param nva object to search
+ * @param name name of the `NamedValues` to set a value for
+ * @param value value to set
+ */
+void cap_nva_set_value(
+    NamedValuesArray * nva, const char * name, const TypedUnion value) 
+{
+    if (!nva || !name) {
+        return;
+    }
+    NamedValues * item = cap_nva_get(nva, name);
+    if (item) {
+        cap_nv_clear_values(item);
+    }
+    cap_nva_append_value(nva, name, value);
+}
+
+// ============================================================================
+// === NAMED VALUES ARRAY: IMPLEMENTATION OF PRIVATE FUNCTIONS ================
+// ============================================================================
+
+static size_t _cap_nva_add_slots(NamedValuesArray * nva, size_t count) {
+    static const size_t INIT_ALLOC = 4u;
+    const size_t first = nva -> mCount;
+    size_t alloc = nva -> mAlloc;
+    if (first + count > alloc) {
+        alloc = alloc ? alloc : INIT_ALLOC;
+        while (first + count > alloc) {
+            alloc *= 2;
+        }
+        nva -> mItems = (NamedValues *) cap_arena_realloc(
+            nva -> mArena, nva -> mItems, 
+            nva -> mAlloc * sizeof(NamedValues), alloc * sizeof(NamedValues));
+        nva -> mAlloc = alloc;
+    }
+    for (size_t i = first; i < first + count; ++i) {
+        nva -> mItems[i] = (NamedValues) {
+            .mName = NULL,
+            .mMixed = !nva -> mPackValues,
+            .mPack = nva -> mPackValues,
+            .mValues = NULL,
+            .mValueCount = 0u,
+            .mValueAlloc = 0u,
+            .mArena = nva -> mArena
+        };
+    }
+    nva -> mCount += count;
+    return first;
+}
+
+static void _cap_nva_append_parsed_value_at(
+        NamedValuesArray * nva, size_t position, const char * name,
+        const TypedUnion value, bool borrow) {
+    // like cap_nva_append_value_at, but a string stored in `value` is not
+    // owned by anyone. It is either copied, or borrowed as it is (the caller
+    // guarantees that it outlives `nva` then).
+    NamedValues * item = _cap_nva_named_slot_at(nva, position, name);
+    if (borrow) {
+        _cap_nv_append_value_inner(item, value);
+    }
+    else {
+        _cap_nv_append_value_copy(item, value);
+    }
+}
+
+static NamedValues * _cap_nva_named_slot_at(
+        NamedValuesArray * nva, size_t position, const char * name) {
+    // the reserved slot at `position`, named `name` if it is still unused
+    NamedValues * item = nva -> mItems + position;
+    if (!item -> mName) {
+        _cap_nva_name_slot(nva, position, name);
+    }
+    return item;
+}
+
+static void _cap_nva_name_slot(
+        NamedValuesArray * nva, size_t position, const char * name) {
+    NamedValues * item = nva -> mItems + position;
+    item -> mName = cap_arena_copy_string(nva -> mArena, name);
+    // the index borrows the name owned by the slot
+    cap_si_insert(nva -> mIndex, item -> mName, position);
+}
+
+static void _cap_nva_enable_packing(NamedValuesArray * nva, bool enable) {
+    // applies to all slots, which must still be empty, and to slots added
+    // later
+    nva -> mPackValues = enable;
+    for (size_t i = 0u; i < nva -> mCount; ++i) {
+        _cap_nv_enable_packing(nva -> mItems + i, enable);
+    }
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @file
+ * @defgroup response_file Response Files
+ *
+ * A response file contains command line words, and is named on the command
+ * line as `@path`. When enabled using `cap_parser_enable_response_files`, the
+ * parser reads the words of such files in place of the `@path` argument.
+ * Users of the library never need to use a `ResponseFile` directly.
+ *
+ * The file is memory-mapped (or read into memory on systems without `mmap`)
+ * and split into words in place, in a single pass over its contents:
+ * - If it contains a null character, words are delimited by null characters,
+ *   like the output of `find -print0`. No quoting is applied then. Splitting
+ *   stops at the first null character, and the bytes before it, which were
+ *   already split, are read from the file again.
+ * - Otherwise words are delimited by whitespace. Single quotes preserve
+ *   everything up to the next single quote, double quotes everything up to
+ *   the next double quote except that `\"` and `\\` are escapes, and
+ *   a backslash outside of quotes escapes the following character.
+ *
+ * The words are stored consecutively, each followed by a null character, in
+ * the private copy-on-write mapping. They are never copied, and the parser
+ * reads them directly from there.
+ */
+
+#if defined(__unix__) || defined(__APPLE__)
+#define _CAP_POSIX 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @addtogroup response_file
+ * @{
+ */
+
+// ============================================================================
+// === RESPONSE FILE ==========================================================
+// ============================================================================
+
+/**
+ * Words of a response file, read for one argument of a command line.
+ */
+typedef struct {
+    /// argument which named the file, including the `@`
+    const char * mArgument;
+    /// index of that argument on the command line
+    int mIndex;
+    /// contents of the file, a sequence of null-terminated words once it is
+    /// split
+    char * mData;
+    /// end of the last word (after its terminating null character)
+    const char * mWordsEnd;
+    /// size of the mapping at `mData`, or zero if the contents were read into
+    /// memory allocated using `cap_malloc`
+    size_t mMapSize;
+} ResponseFile;
+
+/**
+ * Reasons why a response file cannot be used.
+ */
+typedef enum {
+    /// the file was read
+    RFE_NO_ERROR,
+    /// the file cannot be opened or read
+    RFE_CANNOT_READ,
+    /// a quote is not closed
+    RFE_UNTERMINATED_QUOTE
+} ResponseFileError;
+
+/// classes of characters when splitting a file: whitespace (the same as
+/// `isspace` in the "C" locale) is 1, quotes, backslashes and null
+/// characters are 2
+static const unsigned char _CAP_RF_CHAR_CLASS[256] = {
+    [' '] = 1u, ['\t'] = 1u, ['\n'] = 1u, ['\v'] = 1u, ['\f'] = 1u,
+    ['\r'] = 1u, ['\''] = 2u, ['"'] = 2u, ['\\'] = 2u, ['\0'] = 2u
+};
+
+// ============================================================================
+// === RESPONSE FILE: DECLARATION OF PRIVATE FUNCTIONS ========================
+// ============================================================================
+
+static ResponseFileError _cap_rf_open(
+    ResponseFile * file, const char * argument, int index);
+static void _cap_rf_close(ResponseFile * file);
+static bool _cap_rf_contains(const ResponseFile * file, const char * word);
+static bool _cap_rf_read(ResponseFile * file, const char * path, size_t * size);
+static ResponseFileError _cap_rf_split(ResponseFile * file, size_t size);
+static bool _cap_rf_split_quoted(
+    char * data, size_t size, char ** words_end, const char ** null_char);
+static bool _cap_rf_restore(const ResponseFile * file, size_t size);
+static long _cap_rf_read_fd(int fd, char * buffer, size_t size);
+
+// ============================================================================
+// === RESPONSE FILE: IMPLEMENTATION OF PRIVATE FUNCTIONS =====================
+// ============================================================================
+
+static ResponseFileError _cap_rf_open(
+        ResponseFile * file, const char * argument, int index) {
+    // reads and splits the file named by `argument` ("@path")
+    *file = (ResponseFile) {
+        .mArgument = argument,
+        .mIndex = index,
+        .mData = NULL,
+        .mWordsEnd = NULL,
+        .mMapSize = 0u
+    };
+    size_t size;
+    if (!_cap_rf_read(file, argument + 1, &size)) {
+        return RFE_CANNOT_READ;
+    }
+    const ResponseFileError error = _cap_rf_split(file, size);
+    if (error != RFE_NO_ERROR) {
+        _cap_rf_close(file);
+    }
+    return error;
+}
+
+static void _cap_rf_close(ResponseFile * file) {
+#if defined(_CAP_POSIX)
+    if (file -> mMapSize) {
+        munmap(file -> mData, file -> mMapSize);
+        file -> mData = NULL;
+        return;
+    }
+#endif
+    cap_free(file -> mData);
+    file -> mData = NULL;
+}
+
+static bool _cap_rf_contains(const ResponseFile * file, const char * word) {
+    // if `word` is one of the words of `file`
+    return file -> mData && word
+        && word >= file -> mData && word < file -> mWordsEnd;
+}
+
+static bool _cap_rf_read(
+        ResponseFile * file, const char * path, size_t * size) {
+    // the contents are followed by at least one null character, so that the
+    // last word can be terminated in place
+#if defined(_CAP_POSIX)
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat status;
+    if (fstat(fd, &status) || !S_ISREG(status.st_mode)) {
+        close(fd);
+        return false;
+    }
+    *size = (size_t) status.st_size;
+    const size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    // the rest of the last page is filled with zeros. If there is no rest,
+    // the file is read instead.
+    if (*size % page) {
+        void * data = mmap(
+            NULL, *size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            close(fd);
+            file -> mData = (char *) data;
+            file -> mMapSize = *size;
+            return true;
+        }
+    }
+    close(fd);
+#endif
+    FILE * stream = fopen(path, "rb");
+    if (!stream) {
+        return false;
+    }
+    size_t alloc = 4096u;
+    char * data = (char *) cap_malloc(alloc);
+    *size = 0u;
+    size_t read;
+    while ((read = fread(data + *size, 1u, alloc - *size - 1u, stream))) {
+        *size += read;
+        if (alloc - *size == 1u) {
+            alloc *= 2u;
+            data = (char *) cap_realloc(data, alloc);
+        }
+    }
+    const bool failed = ferror(stream);
+    fclose(stream);
+    if (failed) {
+        cap_free(data);
+        return false;
+    }
+    data[*size] = '\0';
+    file -> mData = data;
+    return true;
+}
+
+static ResponseFileError _cap_rf_split(ResponseFile * file, size_t size) {
+    // splits the contents into null-terminated words in place
+    char * const data = file -> mData;
+    char * words_end = data;
+    const char * null_char;
+    const bool split = _cap_rf_split_quoted(
+        data, size, &words_end, &null_char);
+    if (!null_char) {
+        file -> mWordsEnd = words_end;
+        return split ? RFE_NO_ERROR : RFE_UNTERMINATED_QUOTE;
+    }
+    // the words are delimited by null characters instead, so quotes do not
+    // matter. They are terminated already, except for the last one which is
+    // followed by the padding, but the ones before the first null character
+    // were split.
+    const size_t split_size = (size_t) (null_char - data);
+    if (split_size && !_cap_rf_restore(file, split_size)) {
+        return RFE_CANNOT_READ;
+    }
+    file -> mWordsEnd = data + size + (data[size - 1u] != '\0');
+    return RFE_NO_ERROR;
+}
+
+static bool _cap_rf_split_quoted(
+        char * data, size_t size, char ** words_end, const char ** null_char) {
+    // splits `size` bytes at `data` into null-terminated words in place, at
+    // whitespace and applying quotes. `data[size]` must be writable. Returns
+    // `false` if a quote is not closed. The data ends early at the first null
+    // character, whose position is stored in `null_char` (`NULL` if there is
+    // none).
+    const char * r = data;
+    const char * end = data + size;
+    char * w = data;
+    *null_char = NULL;
+    while (true) {
+        while (r < end && _CAP_RF_CHAR_CLASS[(unsigned char) *r] == 1u) {
+            ++r;
+        }
+        if (r < end && !*r) {
+            *null_char = end = r;
+        }
+        if (r == end) {
+            break;
+        }
+        while (true) {
+            // runs of plain characters are only moved once a quote or
+            // a backslash was removed before them
+            const char * plain = r;
+            while (r < end && !_CAP_RF_CHAR_CLASS[(unsigned char) *r]) {
+                ++r;
+            }
+            if (w != plain) {
+                memmove(w, plain, (size_t) (r - plain));
+            }
+            w += r - plain;
+            if (r < end && !*r) {
+                *null_char = end = r;
+            }
+            if (r == end || _CAP_RF_CHAR_CLASS[(unsigned char) *r] == 1u) {
+                break;
+            }
+            if (*r == '\\') {
+                if (++r < end && !*r) {
+                    *null_char = end = r;
+                }
+                *w++ = r < end ? *r++ : '\\';
+                continue;
+            }
+            const char quote = *r++;
+            while (r < end && *r != quote) {
+                if (!*r) {
+                    *null_char = end = r;
+                    break;
+                }
+                if (quote == '"' && *r == '\\' && r + 1 < end
+                        && (r[1] == '"' || r[1] == '\\')) {
+                    ++r;
+                }
+                *w++ = *r++;
+            }
+            if (r == end) {
+                return false;
+            }
+            ++r;
+        }
+        // the delimiter is consumed first, `w` may point to it
+        if (r < end) {
+            ++r;
+        }
+        *w++ = '\0';
+    }
+    *words_end = w;
+    return true;
+}
+
+static bool _cap_rf_restore(const ResponseFile * file, size_t size) {
+    // reads the first `size` bytes of the file into `mData` again, after
+    // splitting changed them
+    FILE * stream = fopen(file -> mArgument + 1, "rb");
+    if (!stream) {
+        return false;
+    }
+    const bool restored = fread(file -> mData, 1u, size, stream) == size;
+    fclose(stream);
+    return restored;
+}
+
+static long _cap_rf_read_fd(int fd, char * buffer, size_t size) {
+    // reads up to `size` bytes from a file descriptor. Returns the number of
+    // bytes read, zero at the end of the input, or -1 if it cannot be read.
+#if defined(_CAP_POSIX)
+    while (true) {
+        const ssize_t read_size = read(fd, buffer, size);
+        if (read_size >= 0) {
+            return (long) read_size;
+        }
+        if (errno != EINTR) {
+            return -1;
+        }
+    }
+#else
+    (void) fd;
+    (void) buffer;
+    (void) size;
+    return -1;
+#endif
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @file
+ * @defgroup parsed_arguments ParsedArguments: Storage of Parsed Flags and Arguments
+ * 
+ * `ParsedArguments` is the result of parsing arguments given on the command
+ * line. An object of this type is usually returned from a configured
+ * `ArgumentParser` after successful parsing. It should contain information
+ * about all configured flags and arguments that were found on the command line.
+ * The library offers several functions for creating, deleting, modifying and
+ * querying these objects. They are prefixed with `cap_pa_`.
+ * 
+ * `ParsedArguments` objects are able to store arguments of two kinds: flags and
+ * positional arguments (also called positionals). Each stored argument has a
+ * string name and a set of values. The name is most commonly used to query the
+ * `ParsedArguments` for the given argument (e.g. if it is present). Values are
+ * stored as `TypedUnion` objects, and pointers to those objects can be returned
+ * from a search function call on the `ParsedArguments`, e.g. `cap_pa_get_flag`.
+ * This way, `ParsedArguments` implements a pair of primitive multi-sets of
+ * `string --> TypedUnion` (one such mapping for flags and one for positionals.)
+ * 
+ * Besides by name, flags and positionals can also be accessed by their id, 
+ * using functions such as `cap_pa_get_flag_by_id`. When a `ParsedArguments` is
+ * created by a parser, the id of a flag or a positional is the one returned by
+ * `cap_parser_add_flag` or `cap_parser_add_positional` respectively. Access by
+ * id takes constant time and does not compare any strings, so it is preferable
+ * in performance-sensitive code. For objects created using 
+ * `cap_pa_make_empty()` and filled using e.g. `cap_pa_add_flag`, ids are 
+ * assigned in the order in which names were first added, starting at zero.
+ * 
+ * An empty `ParsedArguments` object can be created using `cap_pa_make_empty()`.
+ * This is normally done at parse-time by the parser so users do not need to
+ * create it manually. Objects should be disposed of using `cap_pa_destroy` when
+ * no longer needed. This call invalidates all information obtained from the
+ * object, e.g. pointers to `TypedUnion`s that were stored as argument values.
+ * 
+ * If the parser was configured using `cap_parser_enable_packed_values`, values
+ * of one flag or positional are stored in a packed array of their native 
+ * type, e.g. `int[]` for `DT_INT`, instead of as `TypedUnion`s. Functions such
+ * as `cap_pa_get_positional_ints` return that array directly, which is the 
+ * most efficient way to access many values. Functions returning a 
+ * `TypedUnion`, such as `cap_pa_get_flag`, still find the first value (and
+ * any `DT_PRESENCE` value), but `cap_pa_get_flag_i` and similar functions
+ * return `NULL` for the following packed values.
+ * 
+ * Functions which only read a `ParsedArguments` never modify it, so one object
+ * may be read from several threads at once.
+ * 
+ * A `ParsedArguments` and everything it owns (names, values, and strings 
+ * stored in values) are allocated from a single `Arena`. A parse therefore 
+ * needs only a few allocations, and `cap_pa_destroy` releases everything at
+ * once.
+ */
+
+/**
+ * @addtogroup parsed_arguments
+ * @{
+ */
+
+// ============================================================================
+// === PARSED ARGUMENTS =======================================================
+// ============================================================================
+
+/**
+ * Stores all information about command line arguments after successful
+ * parsing.
+ * 
+ * This structure is the main result of parsing command line arguments by a
+ * configured parser. All flags and positional arguments are stored with their
+ * values as `TypedUnion` objects. Objects of this type should not be created 
+ * directly. The function `cap_parser_parse` should be used instead. Similarly, 
+ * information about flags and positionals should be obtained using functions 
+ * such as `cap_pa_has_flag` or `cap_pa_get_positional`. 
+ * 
+ * Once created using the `cap_parser_parse` or `cap_pa_make_empty` functions,
+ * the caller owns this object and should dispose of it using `cap_pa_destroy`
+ * once it is no longer needed. The object itself lives in its own arena, so
+ * the pointer must not be passed to `free`. `cap_pa_destroy` also deletes all
+ * data contained in it, including names of flags, and `TypedUnion`s and
+ * strings contained in them. If any data obtained from a `ParsedArguments` should be usable 
+ * after destroying the object, it must be properly copied.
+ * 
+ * @see ParsedFlag
+ * @see ParsedPositional
+ * @see cap_pa_make_empty
+ * @see cap_pa_destroy
+ * @see cap_pa_has_flag
+ * @see cap_pa_flag_count
+ * @see cap_pa_get_flag
+ * @see cap_pa_get_flag_i
+ * @see cap_pa_has_positional
+ * @see cap_pa_get_positional
+ */
+typedef struct ParsedArguments {
+    /// Information about individual parsed flags, the position of each flag 
+    /// is its id
+    NamedValuesArray * mFlags;
+    /// Information about individual positional arguments, the position of each
+    /// positional is its id
+    NamedValuesArray * mPositionals;
+    /// Arena from which this object and all data stored in it are allocated
+    Arena * mArena;
+    /// Position of `mArena` right after this object, `cap_pa_reset` rewinds
+    /// the arena to it
+    ArenaMark mResetMark;
+    /// Response files whose words were parsed into this object. Values may
+    /// point into them, so they are released together with the values.
+    ResponseFile * mResponseFiles;
+    size_t mResponseFileCount;
+    /// Name of the subcommand which was parsed, or `NULL`
+    char * mSubcommand;
+    /// Arguments of the subcommand, owned by this object, or `NULL`
+    struct ParsedArguments * mSubcommandArguments;
+    /// Parser of the subcommand if it was built only for this parse (see
+    /// `cap_parser_build_subcommands`), or `NULL`. It is owned by this object
+    /// and destroyed using `mReleaseSubparser`.
+    void * mSubparser;
+    void (* mReleaseSubparser)(void * parser);
+} ParsedArguments;
+
+// ============================================================================
+// === DECLARATION OF PRIVATE FUNCTIONS =======================================
+// ============================================================================
+
+NamedValues * _cap_pa_get_flag(const ParsedArguments * args, const char * flag);
+NamedValues * _cap_pa_get_positional(
+    const ParsedArguments * args, const char * name);
+static const NamedValues * _cap_pa_flag_at(
+    const ParsedArguments * args, size_t id);
+static const NamedValues * _cap_pa_positional_at(
+    const ParsedArguments * args, size_t id);
+static ParsedArguments * _cap_pa_make_in(
+    Arena * arena, size_t flag_count, size_t positional_count);
+static void _cap_pa_make_containers(
+    ParsedArguments * args, size_t flag_count, size_t positional_count);
+static void _cap_pa_reset_reserved(
+    ParsedArguments * args, size_t flag_count, size_t positional_count);
+static void _cap_pa_adopt_response_files(
+    ParsedArguments * args, ResponseFile * files, size_t count);
+static void _cap_pa_add_response_file(
+    ParsedArguments * args, ResponseFile file);
+static void _cap_pa_release_response_files(ParsedArguments * args);
+static void _cap_pa_set_subcommand(
+    ParsedArguments * args, const char * name,
+    ParsedArguments * subcommand_args, void * subparser,
+    void (* release_subparser)(void * parser));
+static void _cap_pa_release_subcommand(ParsedArguments * args);
+static void _cap_pa_reserve_values(
+    ParsedArguments * args, const size_t * flag_value_sizes,
+    const size_t * positional_value_sizes);
+static size_t _cap_pa_container_size(
+    size_t flag_count, size_t positional_count);
+static size_t _cap_pa_arena_size(size_t flag_count, size_t positional_count);
+static void _cap_pa_enable_packing(ParsedArguments * args, bool enable);
+static ParsedArguments * _cap_pa_make_exact(
+    size_t flag_count, const size_t * flag_value_sizes,
+    size_t positional_count, const size_t * positional_value_sizes,
+    size_t extra_size, bool pack);
+static void _cap_pa_add_parsed_flag_at(
+    ParsedArguments * args, size_t id, const char * flag, TypedUnion value,
+    bool borrow);
+static NamedValues * _cap_pa_positional_slot_at(
+    ParsedArguments * args, size_t id, const char * name);
+static void _cap_pa_append_parsed_positional_at(
+    ParsedArguments * args, size_t id, const char * name, TypedUnion value,
+    bool borrow);
+
+// ============================================================================
+// === FACTORY FUNCTIONS ======================================================
+// ============================================================================
+
+/**
+ * Creates an empty `ParsedArguments` object with reserved ids
+ * 
+ * Creates a `ParsedArguments` containing no flags or positionals, in which 
+ * flag ids `0` to `flag_count - 1` and positional ids `0` to 
+ * `positional_count - 1` are reserved. Values for them can be stored using 
+ * `cap_pa_add_flag_at` and `cap_pa_append_positional_at`. This is done by 
+ * parsers, users normally do not need to call this function.
+ * 
+ * @param flag_count number of flag ids to reserve
+ * @param positional_count number of positional ids to reserve
+ * @return new object
+ */
+ParsedArguments * cap_pa_make_reserved(
+    size_t flag_count, size_t positional_count)
+{
+    Arena * arena = cap_arena_make(
+        _cap_pa_arena_size(flag_count, positional_count));
+    return _cap_pa_make_in(arena, flag_count, positional_count);
+}
+
+/**
+ * Creates an empty `ParsedArguments` object
+ * 
+ * Creates a `ParsedArguments` containing no flags or positionals.
+ */
+ParsedArguments * cap_pa_make_empty() {
+    return cap_pa_make_reserved(0u, 0u);
+}
+
+// ============================================================================
+// === DISPOSAL ===============================================================
+// ============================================================================
+
+/**
+ * Destroys a `ParsedArguments` object
+ * 
+ * Destroys a `ParsedArguments` and all data contained in it. All pointers 
+ * obtained from the given object become invalid.
+ * 
+ * @param args object to destroy. If it is `NULL`, this function does nothing.
+ */
+void cap_pa_destroy(ParsedArguments * args) {
+    if (!args) return;
+    _cap_pa_release_response_files(args);
+    _cap_pa_release_subcommand(args);
+    // the object itself and everything it owns live in the arena
+    cap_arena_destroy(args -> mArena);
+}
+
+// ============================================================================
+// === REUSE ==================================================================
+// ============================================================================
+
+/**
+ * Removes all flags and positionals from a `ParsedArguments` object
+ * 
+ * Empties `args`, so that it can be filled again, e.g. by 
+ * `cap_parser_parse_into_noexit`. Reserved ids stay reserved. Memory owned by
+ * `args` is kept and reused, so filling it with a similar amount of data again
+ * does not allocate any memory. All pointers obtained from `args` before this
+ * call become invalid.
+ * 
+ * @param args object to empty. If it is `NULL`, this function does nothing.
+ */
+void cap_pa_reset(ParsedArguments * args) {
+    if (!args) {
+        return;
+    }
+    _cap_pa_reset_reserved(
+        args, cap_nva_length(args -> mFlags), 
+        cap_nva_length(args -> mPositionals));
+}
+
+// ============================================================================
+// === ACCESS TO PARSED FLAGS =================================================
+// ============================================================================
+
+/**
+ * Checks if a flag is present.
+ * 
+ * @param args `ParsedArguments` object to search
+ * @param flag null-terminated string name of the flag, including any leading 
+ *        flag prefix characters (such as '-').
+ * @return `true` if `flag` is present
+ */
+bool cap_pa_has_flag(const ParsedArguments * args, const char * flag) {
+    return (bool) _cap_pa_get_flag(args, flag);
+}
+
+/**
+ * Returns the number of times a flag was given.
+ * 
+ * If `flag` is not present in `args`, returns zero. If a `ParsedArgument` is 
+ * only modified using library functions (such as `cap_pa_add_flag`), it is not 
+ * possible to create a flag with no values. Therefore, `cap_pa_flag_count` 
+ * returning zero is equivalent to `cap_pa_has_flag` returning false.
+ * 
+ * @param args `ParsedArguments` object to search
+ * @param flag null-terminated string representing the flag name including any
+ *        leading flag prefix characters (such as '-').
+ * @return number of values stored for the given flag
+ */
+size_t cap_pa_flag_count(const ParsedArguments * args, const char * flag) {
+    const NamedValues * pf = _cap_pa_get_flag(args, flag);
+    if (!pf) return 0u;
+    return pf -> mValueCount;
+}
+
+/**
+ * Retrieves a value stored in the given flag, or `NULL` if it is absent.
+ * 
+ * Returns a pointer to the first value stored for the given flag. If the flag 
+ * is absent, returns `NULL` instead. If a valid pointer to a `TypedUnion` 
+ * object is returned, `args` remains the owner of that object.
+ * 
+ * @param args `ParsedArguments` object to search
+ * @param flag name of the falg to look up including any flag prefix characters 
+ *        (such as '-').
+ * @return pointer to the first value for this flag, or `NULL`.
+ */
+const TypedUnion * cap_pa_get_flag(
+        const ParsedArguments * args, const char * flag) {
+    const NamedValues * pf = _cap_pa_get_flag(args, flag);
+    return cap_nv_get_value(pf);
+}
+
+/**
+ * Retrieves a value stored in the given flag, at the given position.
+ * 
+ * Returns a pointer to the value stored for the given flag located at the 
+ * given position. If there are too few values, returns `NULL` instead. If 
+ * a valid pointer to a `TypedUnion`  object is returned, `args` remains the 
+ * owner of that object.
+ * 
+ * @param args `ParsedArguments` object to search
+ * @param flag name of the falg to look up including any flag prefix characters 
+ *        (such as '-').
+ * @param index position of the value
+ * @return pointer to the value for this flag indicated by `index`, or `NULL`.
+ */
+const TypedUnion * cap_pa_get_flag_i(
+        const ParsedArguments * args, const char * flag, size_t index) {
+    const NamedValues * pf = _cap_pa_get_flag(args, flag);
+    return cap_nv_get_value_i(pf, index);
+}
+
+/**
+ * Inserts a new value for the given flag.
+ * 
+ * Appends a new value for the given flag to its list of values. `args` becomes 
+ * the owner of `value`. If the flag is not yet present, it is created. In this 
+ * process, the flag name is copied and `args` becomes the owner of this copy.
+ * 
+ * @param args `ParsedArguments` object to add the flag into. If it is `NULL`,
+ *        the function does nothing.
+ * @param flag null-terminated name of the flag in question including any flag 
+ *        prefix characters. If it is `NULL`, the function does nothing.
+ * @param value value to store for the flag
+ */
+void cap_pa_add_flag(
+        ParsedArguments * args, const char * flag, TypedUnion value) {
+    if (!args || !flag) return;
+    cap_nva_append_value(args -> mFlags, flag, value);
+}
+
+/**
+ * Inserts a new value for the flag with the given id.
+ * 
+ * Behaves like `cap_pa_add_flag`, but the flag is identified by `id`. If no 
+ * value has been stored for `id` yet, the flag is given the name `flag`. 
+ * Otherwise `flag` is ignored. The id must have been reserved by
+ * `cap_pa_make_reserved`, or created by adding a flag by name.
+ * 
+ * @param args `ParsedArguments` object to add the flag into. If it is `NULL`,
+ *        the function does nothing.
+ * @param id id of the flag
+ * @param flag null-terminated name of the flag
+ * @param value value to store for the flag
+ */
+void cap_pa_add_flag_at(
+        ParsedArguments * args, size_t id, const char * flag,
+        TypedUnion value) {
+    if (!args) return;
+    cap_nva_append_value_at(args -> mFlags, id, flag, value);
+}
+
+// ============================================================================
+// === ACCESS TO PARSED FLAGS BY ID ===========================================
+// ============================================================================
+
+/**
+ * Checks if the flag with the given id is present.
+ * 
+ * @param args `ParsedArguments` object to search
+ * @param id id of the flag
+ * @return `true` if the flag is present
+ */
+bool cap_pa_has_flag_by_id(const ParsedArguments * args, size_t id) {
+    return args && cap_nva_get_at(args -> mFlags, id);
+}
+
+/**
+ * Returns the number of times the flag with the given id was given.
+ * 
+ * @param args `ParsedArguments` object to search
+ * @param id id of the flag
+ * @return number of values stored for the flag, or zero if it is absent
+ */
+size_t cap_pa_flag_count_by_id(const ParsedArguments * args, size_t id) {
+    if (!args) return 0u;
+    return cap_nv_value_count(cap_nva_get_at(args -> mFlags, id));
+}
+
+/**
+ * Retrieves the first value stored for the flag with the given id.
+ * 
+ * Same as `cap_pa_get_flag`, but the flag is identified by its id.
+ * 
+ * @param args `ParsedArguments` object to search
+ * @param id id of the flag
+ * @return pointer to the first value for this flag, or `NULL`.
+ */
+const TypedUnion * cap_pa_get_flag_by_id(
+        const ParsedArguments * args, size_t id) {
+    if (!args) return NULL;
+    return cap_nv_get_value(cap_nva_get_at(args -> mFlags, id));
+}
+
+/**
+ * Retrieves a value stored for the flag with the given id at a position.
+ * 
+ * Same as `cap_pa_get_flag_i`, but the flag is identified by its id.
+ * 
+ * @param args `ParsedArguments` object to search
+ * @param id id of the flag
+ * @param index position of the value
+ * @return pointer to the value for this flag indicated by `index`, or `NULL`.
+ */
+const TypedUnion * cap_pa_get_flag_i_by_id(
+        const ParsedArguments * args, size_t id, size_t index) {
+    if (!args) return NULL;
+    return cap_nv_get_value_i(cap_nva_get_at(args -> mFlags, id), index);
+}
+
+// ============================================================================
+// === ACCESS TO PARSED POSITIONAL ARGUMENTS ==================================
+// ============================================================================
+
+/**
+ * Checks if a positinal argument with this name exists.
+ * 
+ * Checks if `args` contains a positional argument with the name `name`. If `args` or `name` are `NULL`, always returns `false`.
+ * 
+ * @param args object to search
+ * @param name null-terminated argument name
+ * @return `true` if a positional argument `name` exists
+ */
+bool cap_pa_has_positional(const ParsedArguments * args, const char * name) {
+    return (bool) _cap_pa_get_positional(args, name);
+}
+
+/**
+ * Get the number of values stored for a positional.
+ * 
+ * Checks if `args` contains a positional argument with the name `name`. If
+ * `args` or `name` are `NULL`, or if `name` is not contained in `args`, 
+ * returns zero. Else returns the number of values stored for `name`.
+ * 
+ * @param args object to search
+ * @param name null-terminated name of the argument
+ * @return number of values stored for `name`
+ */
+size_t cap_pa_positional_count(
+    const ParsedArguments * args, const char * name)
+{
+    const NamedValues * pp = _cap_pa_get_positional(args, name);
+    return cap_nv_value_count(pp);
+}
+
+/**
+ * Retrieves a positional argument with the given name.
+ * 
+ * Checks if `args` contains a positional argument named `name` and, if it is 
+ * present, returns a pointer to its value. Returns `NULL` if no such 
+ * positional argument exists or if `args` or `name` are `NULL`. Do note that, 
+ * if a valid pointer to a `TypedUnion` object is returned, `args` remains the 
+ * owner of that object.
+ * 
+ * @param args object to search
+ * @param name null-terminated name of the positional argument
+ * @returns pointer to the argument's value, or `NULL` if it is not found.
+ */
+const TypedUnion * cap_pa_get_positional(
+    const ParsedArguments * args, const char * name) 
+{
+    const NamedValues * pp =  _cap_pa_get_positional(args, name);
+    return cap_nv_get_value(pp);
+}
+
+/**
+ * Retrieves a positional argument with the given name at the given index.
+ * 
+ * Checks if `args` contains a positional argument named `name`. If it is 
+ * present and there are at least `index + 1` values stored for it returns 
+ * the value at position `index` (starting at zero). Returns `NULL` if that 
+ * argument does not exist or there are not enough values. Also returns `NULL`
+ * if `args` or `name` are `NULL`. Do note that, if a valid pointer to 
+ * a `TypedUnion` object is returned, `args` remains the owner of that object.
+ * 
+ * @param args object to search
+ * @param name null-terminated name of the positional argument
+ * @param index index of the requested value
+ * @return pointer to the argument's value at `index`, or `NULL` if it is
+ *         not found.
+ */
+const TypedUnion * cap_pa_get_positional_i(
+    const ParsedArguments * args, const char * name, size_t index) 
+{
+    const NamedValues * pp =  _cap_pa_get_positional(args, name);
+    return cap_nv_get_value_i(pp, index);
+}
+
+/**
+ * Sets a value for the given argument.
+ * 
+ * Finds a positional argument with the given name and replaces its value with 
+ * `value`.
+ * In this process, `args` becomes the owner of `value`. Only newly created 
+ * `TypedUnion` objects should be passed to this functions. Passing a (shallow) 
+ * copy of a `TypedUnion` with dynamic memory (such as the string type) that is 
+ * already owned by a `ParsedArguments` will lead to double-free faults.
+ * 
+ * If no positional argument with the name `name` exists in `args`, it is 
+ * created. A copy of `name` is made when creating the argument in `args`.
+ * 
+ * @param args object to set the new value in
+ * @param name null-terminated name of the positional argument to set a new value for
+ * @param value the new value. `args` becomes the owner of this object.
+ */
+void cap_pa_set_positional(
+    ParsedArguments * args, const char * name, const TypedUnion value)
+{
+    if (!args || !name) {
+        return;
+    }
+    cap_nva_set_value(args -> mPositionals, name, value);
+}
+
+/**
+ * Adds a value for a positional
+ * 
+ * Adds a new value for a stored positional argument in `args`. If no such
+ * positional exists, it gets also created.
+ * 
+ * In this process, `args` becomes the owner of `value`. Only newly created 
+ * `TypedUnion` objects should be passed to this functions. Passing a (shallow)
+ * copy of a `TypedUnion` with dynamic memory (such as the string type) that is
+ * already owned by a `ParsedArguments` will lead to double-free faults.
+ * 
+ * @param args object to add a value to
+ * @param name null-terminated name of the positional
+ * @param value value to store for this positional
+ */
+void cap_pa_append_positional(
+    ParsedArguments * args, const char * name, const TypedUnion value)
+{
+    if (!args || !name) {
+        return;
+    }
+    cap_nva_append_value(args -> mPositionals, name, value);
+}
+
+/**
+ * Adds a value for the positional with the given id
+ * 
+ * Behaves like `cap_pa_append_positional`, but the positional is identified by
+ * `id`. If no value has been stored for `id` yet, the positional is given the 
+ * name `name`. Otherwise `name` is ignored. The id must have been reserved by
+ * `cap_pa_make_reserved`, or created by adding a positional by name.
+ * 
+ * @param args object to add a value to
+ * @param id id of the positional
+ * @param name null-terminated name of the positional
+ * @param value value to store for this positional
+ */
+void cap_pa_append_positional_at(
+    ParsedArguments * args, size_t id, const char * name,
+    const TypedUnion value)
+{
+    if (!args) {
+        return;
+    }
+    cap_nva_append_value_at(args -> mPositionals, id, name, value);
+}
+
+// ============================================================================
+// === ACCESS TO PARSED POSITIONAL ARGUMENTS BY ID ============================
+// ============================================================================
+
+/**
+ * Checks if the positional with the given id is present.
+ * 
+ * @param args object to search
+ * @param id id of the positional
+ * @return `true` if at least one value is stored for the positional
+ */
+bool cap_pa_has_positional_by_id(const ParsedArguments * args, size_t id) {
+    return args && cap_nva_get_at(args -> mPositionals, id);
+}
+
+/**
+ * Get the number of values stored for the positional with the given id.
+ * 
+ * @param args object to search
+ * @param id id of the positional
+ * @return number of values stored for the positional
+ */
+size_t cap_pa_positional_count_by_id(
+    const ParsedArguments * args, size_t id)
+{
+    if (!args) {
+        return 0u;
+    }
+    return cap_nv_value_count(cap_nva_get_at(args -> mPositionals, id));
+}
+
+/**
+ * Retrieves the value of the positional with the given id.
+ * 
+ * Same as `cap_pa_get_positional`, but the positional is identified by its id.
+ * 
+ * @param args object to search
+ * @param id id of the positional
+ * @returns pointer to the argument's value, or `NULL` if it is not found.
+ */
+const TypedUnion * cap_pa_get_positional_by_id(
+    const ParsedArguments * args, size_t id)
+{
+    if (!args) {
+        return NULL;
+    }
+    return cap_nv_get_value(cap_nva_get_at(args -> mPositionals, id));
+}
+
+/**
+ * Retrieves a value of the positional with the given id at the given index.
+ * 
+ * Same as `cap_pa_get_positional_i`, but the positional is identified by its
+ * id.
+ * 
+ * @param args object to search
+ * @param id id of the positional
+ * @param index index of the requested value
+ * @return pointer to the argument's value at `index`, or `NULL` if it is
+ *         not found.
+ */
+const TypedUnion * cap_pa_get_positional_i_by_id(
+    const ParsedArguments * args, size_t id, size_t index) 
+{
+    if (!args) {
+        return NULL;
+    }
+    return cap_nv_get_value_i(
+        cap_nva_get_at(args -> mPositionals, id), index);
+}
+
+// ============================================================================
+// === PARSED ARGUMENTS: VALUES AS ARRAYS =====================================
+// ============================================================================
+
+/**
+ * Retrieves all values of the given flag as an array of `int`.
+ * 
+ * If `args` contains the flag `flag` and all of its values have type 
+ * `DT_INT`, returns them as a contiguous array and stores their number in 
+ * `count`. Otherwise returns `NULL` and stores zero. The values must be 
+ * stored packed (see `cap_parser_enable_packed_values`), so no copies are 
+ * made, otherwise `NULL` is returned as well. `args` remains the owner of the
+ * array, which is valid until values are added to the flag.
+ * 
+ * @param args object to search
+ * @param flag null-terminated name of the flag
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const int * cap_pa_get_flag_ints(
+        const ParsedArguments * args, const char * flag, size_t * count) {
+    return cap_nv_get_ints(_cap_pa_get_flag(args, flag), count);
+}
+
+/**
+ * Retrieves all values of the given flag as an array of `double`.
+ * 
+ * Same as `cap_pa_get_flag_ints`, for values of type `DT_DOUBLE`.
+ * 
+ * @param args object to search
+ * @param flag null-terminated name of the flag
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const double * cap_pa_get_flag_doubles(
+        const ParsedArguments * args, const char * flag, size_t * count) {
+    return cap_nv_get_doubles(_cap_pa_get_flag(args, flag), count);
+}
+
+/**
+ * Retrieves all values of the given flag as an array of strings.
+ * 
+ * Same as `cap_pa_get_flag_ints`, for values of type `DT_STRING`.
+ * 
+ * @param args object to search
+ * @param flag null-terminated name of the flag
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const char * const * cap_pa_get_flag_strings(
+        const ParsedArguments * args, const char * flag, size_t * count) {
+    return cap_nv_get_strings(_cap_pa_get_flag(args, flag), count);
+}
+
+/**
+ * Retrieves all values of the flag with the given id as an array.
+ * 
+ * Same as `cap_pa_get_flag_ints`, but the flag is identified by its id.
+ * 
+ * @param args object to search
+ * @param id id of the flag
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const int * cap_pa_get_flag_ints_by_id(
+        const ParsedArguments * args, size_t id, size_t * count) {
+    return cap_nv_get_ints(_cap_pa_flag_at(args, id), count);
+}
+
+/**
+ * Retrieves all values of the flag with the given id as an array.
+ * 
+ * Same as `cap_pa_get_flag_doubles`, but the flag is identified by its id.
+ * 
+ * @param args object to search
+ * @param id id of the flag
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const double * cap_pa_get_flag_doubles_by_id(
+        const ParsedArguments * args, size_t id, size_t * count) {
+    return cap_nv_get_doubles(_cap_pa_flag_at(args, id), count);
+}
+
+/**
+ * Retrieves all values of the flag with the given id as an array.
+ * 
+ * Same as `cap_pa_get_flag_strings`, but the flag is identified by its id.
+ * 
+ * @param args object to search
+ * @param id id of the flag
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const char * const * cap_pa_get_flag_strings_by_id(
+        const ParsedArguments * args, size_t id, size_t * count) {
+    return cap_nv_get_strings(_cap_pa_flag_at(args, id), count);
+}
+
+/**
+ * Retrieves all values of the given positional argument as an array of `int`.
+ * 
+ * If `args` contains the positional argument `name` and all of its values have type 
+ * `DT_INT`, returns them as a contiguous array and stores their number in 
+ * `count`. Otherwise returns `NULL` and stores zero. The values must be 
+ * stored packed (see `cap_parser_enable_packed_values`), so no copies are 
+ * made, otherwise `NULL` is returned as well. `args` remains the owner of the
+ * array, which is valid until values are added to the positional.
+ * 
+ * @param args object to search
+ * @param name null-terminated name of the positional
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const int * cap_pa_get_positional_ints(
+        const ParsedArguments * args, const char * name, size_t * count) {
+    return cap_nv_get_ints(_cap_pa_get_positional(args, name), count);
+}
+
+/**
+ * Retrieves all values of the given positional argument as an array of `double`.
+ * 
+ * Same as `cap_pa_get_positional_ints`, for values of type `DT_DOUBLE`.
+ * 
+ * @param args object to search
+ * @param name null-terminated name of the positional
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const double * cap_pa_get_positional_doubles(
+        const ParsedArguments * args, const char * name, size_t * count) {
+    return cap_nv_get_doubles(_cap_pa_get_positional(args, name), count);
+}
+
+/**
+ * Retrieves all values of the given positional argument as an array of strings.
+ * 
+ * Same as `cap_pa_get_positional_ints`, for values of type `DT_STRING`.
+ * 
+ * @param args object to search
+ * @param name null-terminated name of the positional
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const char * const * cap_pa_get_positional_strings(
+        const ParsedArguments * args, const char * name, size_t * count) {
+    return cap_nv_get_strings(_cap_pa_get_positional(args, name), count);
+}
+
+/**
+ * Retrieves all values of the positional argument with the given id as an array.
+ * 
+ * Same as `cap_pa_get_positional_ints`, but the positional is identified by its id.
+ * 
+ * @param args object to search
+ * @param id id of the positional
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const int * cap_pa_get_positional_ints_by_id(
+        const ParsedArguments * args, size_t id, size_t * count) {
+    return cap_nv_get_ints(_cap_pa_positional_at(args, id), count);
+}
+
+/**
+ * Retrieves all values of the positional argument with the given id as an array.
+ * 
+ * Same as `cap_pa_get_positional_doubles`, but the positional is identified by its id.
+ * 
+ * @param args object to search
+ * @param id id of the positional
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const double * cap_pa_get_positional_doubles_by_id(
+        const ParsedArguments * args, size_t id, size_t * count) {
+    return cap_nv_get_doubles(_cap_pa_positional_at(args, id), count);
+}
+
+/**
+ * Retrieves all values of the positional argument with the given id as an array.
+ * 
+ * Same as `cap_pa_get_positional_strings`, but the positional is identified by its id.
+ * 
+ * @param args object to search
+ * @param id id of the positional
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const char * const * cap_pa_get_positional_strings_by_id(
+        const ParsedArguments * args, size_t id, size_t * count) {
+    return cap_nv_get_strings(_cap_pa_positional_at(args, id), count);
+}
+
+// ============================================================================
+// === PARSED ARGUMENTS: SUBCOMMANDS ==========================================
+// ============================================================================
+
+/**
+ * Retrieves the name of the parsed subcommand.
+ * 
+ * If the parser has subcommands (see `cap_parser_add_subcommand`), the
+ * subcommand given on the command line is stored together with the flags
+ * which preceded it.
+ * 
+ * @param args object to search
+ * @return name of the subcommand, or `NULL` if `args` has none
+ */
+const char * cap_pa_get_subcommand(const ParsedArguments * args) {
+    return args ? args -> mSubcommand : NULL;
+}
+
+/**
+ * Retrieves the arguments of the parsed subcommand.
+ * 
+ * The returned object holds the flags and positionals which followed the
+ * subcommand, as parsed by its parser. It is owned by `args` and destroyed
+ * together with it, so it must not be passed to `cap_pa_destroy`.
+ * 
+ * @param args object to search
+ * @return arguments of the subcommand, or `NULL` if `args` has none
+ */
+const ParsedArguments * cap_pa_get_subcommand_arguments(
+        const ParsedArguments * args) {
+    return args ? args -> mSubcommandArguments : NULL;
+}
+
+// ============================================================================
+// === IMPLEMENTATION OF PRIVATE FUNCTIONS ====================================
+// ============================================================================
+
+NamedValues * _cap_pa_get_flag(
+    const ParsedArguments * args, const char * flag)
+{
+    if (!args) {
+        return NULL;
+    }
+    return cap_nva_get(args -> mFlags, flag);
+}
+
+NamedValues * _cap_pa_get_positional(
+    const ParsedArguments * args, const char * name)
+{
+    if (!args) {
+        return NULL;
+    }
+    return cap_nva_get(args -> mPositionals, name);
+}
+
+static const NamedValues * _cap_pa_flag_at(
+        const ParsedArguments * args, size_t id) {
+    return args ? cap_nva_get_at(args -> mFlags, id) : NULL;
+}
+
+static const NamedValues * _cap_pa_positional_at(
+        const ParsedArguments * args, size_t id) {
+    return args ? cap_nva_get_at(args -> mPositionals, id) : NULL;
+}
+
+static ParsedArguments * _cap_pa_make_in(
+        Arena * arena, size_t flag_count, size_t positional_count) {
+    ParsedArguments * pa = (ParsedArguments *) cap_arena_alloc(
+        arena, sizeof(ParsedArguments));
+    *pa = (ParsedArguments) {
+        .mFlags = NULL,
+        .mPositionals = NULL,
+        .mArena = arena,
+        .mResetMark = cap_arena_mark(arena),
+        .mResponseFiles = NULL,
+        .mResponseFileCount = 0u,
+        .mSubcommand = NULL,
+        .mSubcommandArguments = NULL,
+        .mSubparser = NULL,
+        .mReleaseSubparser = NULL
+    };
+    _cap_pa_make_containers(pa, flag_count, positional_count);
+    return pa;
+}
+
+static void _cap_pa_make_containers(
+        ParsedArguments * args, size_t flag_count, size_t positional_count) {
+    args -> mFlags = cap_nva_make_in(args -> mArena, flag_count);
+    args -> mPositionals = cap_nva_make_in(args -> mArena, positional_count);
+}
+
+static void _cap_pa_reset_reserved(
+        ParsedArguments * args, size_t flag_count, size_t positional_count) {
+    // everything except the object itself is allocated after the mark, so
+    // the containers are rebuilt in memory the arena already owns
+    _cap_pa_release_response_files(args);
+    _cap_pa_release_subcommand(args);
+    const bool pack = args -> mFlags -> mPackValues;
+    cap_arena_rewind(args -> mArena, args -> mResetMark);
+    _cap_pa_make_containers(args, flag_count, positional_count);
+    _cap_pa_enable_packing(args, pack);
+}
+
+static void _cap_pa_adopt_response_files(
+        ParsedArguments * args, ResponseFile * files, size_t count) {
+    // takes ownership of `files`, an array allocated using `cap_malloc`
+    _cap_pa_release_response_files(args);
+    args -> mResponseFiles = files;
+    args -> mResponseFileCount = count;
+}
+
+static void _cap_pa_add_response_file(
+        ParsedArguments * args, ResponseFile file) {
+    // takes ownership of the data of one more file
+    const size_t count = args -> mResponseFileCount;
+    args -> mResponseFiles = (ResponseFile *) (args -> mResponseFiles
+        ? cap_realloc(
+            args -> mResponseFiles, (count + 1u) * sizeof(ResponseFile))
+        : cap_malloc(sizeof(ResponseFile)));
+    args -> mResponseFiles[count] = file;
+    args -> mResponseFileCount = count + 1u;
+}
+
+static void _cap_pa_release_response_files(ParsedArguments * args) {
+    for (size_t i = 0u; i < args -> mResponseFileCount; ++i) {
+        _cap_rf_close(args -> mResponseFiles + i);
+    }
+    cap_free(args -> mResponseFiles);
+    args -> mResponseFiles = NULL;
+    args -> mResponseFileCount = 0u;
+}
+
+static void _cap_pa_set_subcommand(
+        ParsedArguments * args, const char * name,
+        ParsedArguments * subcommand_args, void * subparser,
+        void (* release_subparser)(void * parser)) {
+    // takes ownership of `subcommand_args` and of `subparser` (if it is not
+    // `NULL`), the name is copied so that `args` stays independent of the
+    // parser
+    _cap_pa_release_subcommand(args);
+    const size_t size = strlen(name) + 1u;
+    args -> mSubcommand = (char *) memcpy(
+        cap_arena_alloc(args -> mArena, size), name, size);
+    args -> mSubcommandArguments = subcommand_args;
+    args -> mSubparser = subparser;
+    args -> mReleaseSubparser = release_subparser;
+}
+
+static void _cap_pa_release_subcommand(ParsedArguments * args) {
+    // the arguments of the subcommand do not point into its parser, so they
+    // may be destroyed in any order
+    cap_pa_destroy(args -> mSubcommandArguments);
+    if (args -> mSubparser) {
+        args -> mReleaseSubparser(args -> mSubparser);
+    }
+    args -> mSubcommand = NULL;
+    args -> mSubcommandArguments = NULL;
+    args -> mSubparser = NULL;
+    args -> mReleaseSubparser = NULL;
+}
+
+static void _cap_pa_reserve_values(
+        ParsedArguments * args, const size_t * flag_value_sizes,
+        const size_t * positional_value_sizes) {
+    for (size_t i = 0u; i < cap_nva_length(args -> mFlags); ++i) {
+        _cap_nv_reserve(args -> mFlags -> mItems + i, flag_value_sizes[i]);
+    }
+    for (size_t i = 0u; i < cap_nva_length(args -> mPositionals); ++i) {
+        _cap_nv_reserve(
+            args -> mPositionals -> mItems + i, positional_value_sizes[i]);
+    }
+}
+
+static void _cap_pa_enable_packing(ParsedArguments * args, bool enable) {
+    // used by parsers before any values are stored
+    _cap_nva_enable_packing(args -> mFlags, enable);
+    _cap_nva_enable_packing(args -> mPositionals, enable);
+}
+
+static size_t _cap_pa_container_size(
+        size_t flag_count, size_t positional_count) {
+    // exact number of arena bytes used by _cap_pa_make_in
+    const size_t counts[2] = { flag_count, positional_count };
+    size_t size = cap_arena_footprint(sizeof(ParsedArguments));
+    for (size_t i = 0u; i < 2u; ++i) {
+        size += cap_arena_footprint(sizeof(NamedValuesArray))
+            + cap_arena_footprint(sizeof(StringIndex))
+            + cap_arena_footprint(counts[i] * sizeof(NamedValues))
+            + cap_arena_footprint(cap_si_reserved_size(counts[i]));
+    }
+    return size;
+}
+
+static size_t _cap_pa_arena_size(size_t flag_count, size_t positional_count) {
+    // a guess that fits typical command lines into the first chunk: the
+    // containers, and some room for names and values of each id
+    static const size_t PER_ID = 2u * sizeof(TypedUnion) + 32u;
+    static const size_t BASE = 512u;
+    return BASE + _cap_pa_container_size(flag_count, positional_count)
+        + (flag_count + positional_count) * PER_ID;
+}
+
+static ParsedArguments * _cap_pa_make_exact(
+        size_t flag_count, const size_t * flag_value_sizes,
+        size_t positional_count, const size_t * positional_value_sizes,
+        size_t extra_size, bool pack) {
+    // creates an object whose arena fits the containers, the given number
+    // of bytes of values for each id (see `_cap_nv_reserved_size`), and 
+    // `extra_size` more bytes (for names and strings), so that storing them
+    // does not need any allocations
+    size_t size = _cap_pa_container_size(flag_count, positional_count)
+        + extra_size;
+    for (size_t i = 0u; i < flag_count; ++i) {
+        size += cap_arena_footprint(flag_value_sizes[i]);
+    }
+    for (size_t i = 0u; i < positional_count; ++i) {
+        size += cap_arena_footprint(positional_value_sizes[i]);
+    }
+    ParsedArguments * pa = _cap_pa_make_in(
+        cap_arena_make(size), flag_count, positional_count);
+    _cap_pa_enable_packing(pa, pack);
+    _cap_pa_reserve_values(pa, flag_value_sizes, positional_value_sizes);
+    return pa;
+}
+
+static void _cap_pa_add_parsed_flag_at(
+        ParsedArguments * args, size_t id, const char * flag,
+        TypedUnion value, bool borrow) {
+    // used by parsers, `value` may point to a word of the command line
+    _cap_nva_append_parsed_value_at(args -> mFlags, id, flag, value, borrow);
+}
+
+static NamedValues * _cap_pa_positional_slot_at(
+        ParsedArguments * args, size_t id, const char * name) {
+    // used by parsers to store values directly
+    return _cap_nva_named_slot_at(args -> mPositionals, id, name);
+}
+
+static void _cap_pa_append_parsed_positional_at(
+        ParsedArguments * args, size_t id, const char * name,
+        TypedUnion value, bool borrow) {
+    // used by parsers, `value` may point to a word of the command line
+    _cap_nva_append_parsed_value_at(
+        args -> mPositionals, id, name, value, borrow);
+}
+
+/**
+ * @}
+ */
+
+/** @file */
+
+// ============================================================================
+// === FLAG INFO ==============================================================
+// ============================================================================
+
+/**
+ * Configuration of a flag in an `ArgumentParser`
+ */
+typedef struct {
+    char * mName;
+    char * mMetaVar;
+    char * mDescription;
+    DataType mType;
+    int mMinCount;
+    int mMaxCount;
+    char ** mAliases;
+    size_t mAliasCount;
+    size_t mAliasAlloc;
+    /// the shortest of `mName` and `mAliases`, used in usage messages
+    const char * mShortestName;
+    /// if `true`, all strings (including aliases) are borrowed from the
+    /// caller and are not released
+    bool mStaticStrings;
+    /// supplies the description instead of `mDescription`, or `NULL`
+    DescriptionProvider mDescriptionProvider;
+    void * mDescriptionContext;
+} FlagInfo;
+
+/**
+ * Get a text representation of this flag's argument.
+ *
+ * Returns a metavar for this flag, according to its type. If available, the 
+ * string is taken from the explicit value mMetaVar in fi. Else, the name of 
+ * the flag's type is used. If the given flag has type DT_PRSENCE (meaning it
+ * takes no value), returns NULL.
+ * 
+ * @param fi object to get the representation of
+ * @return string representation of the flag's value
+ */
+static const char * cap_get_flag_metavar(const FlagInfo * fi) {
+    if (!fi || fi -> mType == DT_PRESENCE) {
+        return NULL;
+    }
+    if (fi -> mMetaVar) {
+        return fi -> mMetaVar;
+    }
+    return cap_type_metavar(fi -> mType);
+}
+
+/**
+ * Factory for FlagInfo objects.
+ *
+ * Allocates a new FlagInfo object and initializes it using given data. The 
+ * caller is the owner of the new object and should dispose of it using
+ *cap_flag_info_destroy.
+ *
+ * All strings given to this function are copied into the new object (if they
+ * are not NULL), unless `static_strings` is `true`. In that case, the object
+ * stores the pointers themselves, so the strings must outlive it (e.g. string
+ * literals). Aliases added later are handled the same way.
+ *
+ * @param name null-terminated name of the flag
+ * @param meta_var optional null-terminated representation of the flag's value.
+ *        When creating DT_PRESENCE flags, this parameter should be NULL. This 
+ *        identifier is used in help messages.
+ * @param description optional null-terminated description of the flag to be 
+ *        used in help messages. 
+ * @param type data type of the flag's value
+ * @param min_count minimum number of times the flag should be present. Must be
+ *        at least zero.
+ * @param max_count maximum number of times the flag should be present. Must
+ *        not be less than min_count, or a negative number. If a negative 
+ *        number is given, there is no upper limit.
+ * @param static_strings if the strings should be borrowed instead of copied
+ * @return new FlagInfo object
+ */
+static FlagInfo * cap_flag_info_make(
+        const char * name, const char * meta_var, const char * description,
+        DataType type, int min_count, int max_count, bool static_strings) {
+    FlagInfo * info = (FlagInfo *) cap_malloc(sizeof(FlagInfo));
+    // borrowed strings are never modified, nor released
+    *info = (FlagInfo) {
+        .mName = static_strings ? (char *) name : copy_string(name),
+        .mMetaVar = static_strings ? (char *) meta_var : copy_string(meta_var),
+	.mDescription = static_strings
+            ? (char *) description : copy_string(description),
+        .mType = type,
+        .mMinCount = min_count,
+        .mMaxCount = max_count,
+        .mAliases = NULL,
+        .mAliasCount = 0,
+        .mAliasAlloc = 0,
+        .mShortestName = NULL,
+        .mStaticStrings = static_strings,
+        .mDescriptionProvider = NULL,
+        .mDescriptionContext = NULL
+    };
+    info -> mShortestName = info -> mName;
+    return info;
+}
+
+/**
+ * Registers an alias of a flag.
+ *
+ * Stores a copy of `alias` among the aliases of `info` (or `alias` itself if
+ * the strings of `info` are static). If the alias is 
+ * shorter than all other names of the flag, it also becomes its shortest name.
+ * Validity of the alias (e.g. uniqueness) is not checked here.
+ *
+ * @param info flag to add the alias to
+ * @param alias null-terminated alias
+ * @return the alias stored in `info`
+ */
+static const char * cap_flag_info_add_alias(
+        FlagInfo * info, const char * alias) {
+    if (info -> mAliasCount >= info -> mAliasAlloc) {
+        info -> mAliasAlloc = info -> mAliasAlloc ? 2 * info -> mAliasAlloc : 1u;
+        info -> mAliases = (char **) cap_realloc(
+            info -> mAliases, info -> mAliasAlloc * sizeof(char *));
+    }
+    char * alias_copy = info -> mStaticStrings
+        ? (char *) alias : copy_string(alias);
+    info -> mAliases[info -> mAliasCount++] = alias_copy;
+    if (strlen(alias_copy) < strlen(info -> mShortestName)) {
+        info -> mShortestName = alias_copy;
+    }
+    return alias_copy;
+}
+
+/**
+ * Destructor for FlagInfo objects
+ *
+ * Destroys and de-allocates a flagInfo object. The caller should be the owner
+ * of this object.
+ *
+ * @param info object to destroy
+ */
+static void cap_flag_info_destroy(FlagInfo * info) {
+    if (!info) {
+        return;
+    }
+    if (!info -> mStaticStrings) {
+        delete_string_property(&(info -> mName));
+        delete_string_property(&(info -> mMetaVar));
+        delete_string_property(&(info -> mDescription));
+        for (size_t i = 0u; i < info -> mAliasCount; ++i) {
+            delete_string_property(info -> mAliases + i);
+        }
+    }
+    cap_free(info -> mAliases);
+    info -> mAliases = NULL;
+    cap_free(info);
+}
+
+/**
+ * Displays a FlagInfo object
+ *
+ * Appends a FlagInfo to a given text buffer. The format is suitable for help
+ * messages.
+ *
+ * @param text buffer to display into
+ * @flag object to display
+ */
+static void cap_format_flag_info(TextBuffer * text, const FlagInfo * flag) {
+    const char * metavar = flag -> mType == DT_PRESENCE ? NULL : cap_get_flag_metavar(flag);
+    cap_text_append_string(text, flag -> mName);
+    cap_text_append_char(text, ' ');
+    if (metavar) {
+        cap_text_append_string(text, metavar);
+    }
+    cap_text_append_char(text, '\n');
+    for (size_t i = 0u; i < flag -> mAliasCount; ++i) {
+        cap_text_append_string(text, flag -> mAliases[i]);
+        cap_text_append_char(text, ' ');
+        if (metavar) {
+            cap_text_append_string(text, metavar);
+        }
+        cap_text_append_char(text, '\n');
+    }
+    const char * description = cap_describe(
+        flag -> mDescription, flag -> mDescriptionProvider,
+        flag -> mDescriptionContext);
+    if (description) {
+        cap_text_append_char(text, '\t');
+        cap_text_append_string(text, description);
+        cap_text_append_char(text, '\n');
+    }
+}
+
+/** @file */
+
+// ============================================================================
+// === POSITIONAL INFO ========================================================
+// ============================================================================
+
+/**
+ * Configuration of a positional argument in an `ArgumentParser`
+ */
+typedef struct {
+    char * mName;
+    char * mMetaVar;
+    char * mDescription;
+    DataType mType;
+    bool mRequired;
+    bool mVariadic;
+    /// if `true`, all strings are borrowed from the caller and are not
+    /// released
+    bool mStaticStrings;
+    /// supplies the description instead of `mDescription`, or `NULL`
+    DescriptionProvider mDescriptionProvider;
+    void * mDescriptionContext;
+} PositionalInfo;
+
+/**
+ * Gets the argument's metavar.
+ *
+ * Returns a string representing the argument, e.g. in help messages. If 
+ * available, this is the explicit value stored in mMetaVar. If it is not 
+ * evailable, the argument name is returned.
+ *
+ * @param pi info about the positional argument
+ * @return text representation of pi
+ */
+const char * cap_get_posit_metavar(const PositionalInfo * pi) {
+    if (!pi) {
+        return NULL;
+    }
+    if (pi -> mMetaVar) {
+        return pi -> mMetaVar;
+    }
+    return pi -> mName;
+}
+
+/**
+ * Factory for PositionalInfo objects.
+ *
+ * Allocates a new PositionalInfo object and initializes it using provided 
+ * data. The caller is the owner of this new object and should dispose of it 
+ * using cap_positional_info_destroy.
+ *
+ * @param name null-terminated name of the positional. This string is copied 
+ *        into the new object.
+ * @param meta_var optional null-terminated human-readable representation of
+ *        the argument. If not NULL, a copy is created and stored in the new 
+ *        object.
+ * @param description optional null-terminated short description of the 
+ *        argument for use in help messages. A copy is created and stored in 
+ *        the new object.
+ * @param type data type of this argument
+ * @param required if the positional is required
+ * @param variadic if the positional is variadic (can take multiple values)
+ * @param static_strings if `true`, the strings are not copied, the object
+ *        stores the given pointers instead. The strings must then outlive it.
+ * @return a new PositionalInfo object
+ */
+PositionalInfo * cap_positional_info_make(
+    const char * name, const char * meta_var, const char * description,
+    DataType type, bool required, bool variadic, bool static_strings)
+{
+    PositionalInfo * info = (PositionalInfo *) cap_malloc(sizeof(PositionalInfo));
+    // borrowed strings are never modified, nor released
+    *info = (PositionalInfo) {
+        .mName = static_strings ? (char *) name : copy_string(name),
+	.mMetaVar = static_strings ? (char *) meta_var : copy_string(meta_var),
+	.mDescription = static_strings
+            ? (char *) description : copy_string(description),
+	.mType = type,
+    .mRequired = required,
+    .mVariadic = variadic,
+    .mStaticStrings = static_strings,
+    .mDescriptionProvider = NULL,
+    .mDescriptionContext = NULL
+    };
+    return info;
+}
+
+/**
+ * Desctuctor for PositionalInfo objects.
+ *
+ * Destroys and de-allocates a PositionalInfo object. Should only be called by 
+ * the owner of that object.
+ *
+ * @param info object to destroy
+ */
+void cap_positional_info_destroy(PositionalInfo * info) {
+    if (!info) {
+        return;
+    }
+    if (!info -> mStaticStrings) {
+        delete_string_property(&(info -> mName));
+        delete_string_property(&(info -> mMetaVar));
+        delete_string_property(&(info -> mDescription));
+    }
+    cap_free(info);
+}
+
+/**
+ * Display a positional info object.
+ *
+ * Prints a PositionalInfo to a given file. The format is similar to 
+ * conventional help messages. 
+ *
+ * @param file file to print into
+ * @info object to display
+ */
+void cap_print_positional_info(
+        FILE * file, const PositionalInfo * info) {
+    fprintf(file, "%s\n", cap_get_posit_metavar(info));
+    const char * description = cap_describe(
+        info -> mDescription, info -> mDescriptionProvider,
+        info -> mDescriptionContext);
+    if (description) {
+        fprintf(file, "\t%s\n", description);
+    }
+}
+
+/**
+ * Display a positional info object.
+ *
+ * Appends a PositionalInfo to a given text buffer, in the same format as
+ * `cap_print_positional_info`.
+ *
+ * @param text buffer to display into
+ * @info object to display
+ */
+void cap_format_positional_info(
+        TextBuffer * text, const PositionalInfo * info) {
+    cap_text_append_string(text, cap_get_posit_metavar(info));
+    cap_text_append_char(text, '\n');
+    const char * description = cap_describe(
+        info -> mDescription, info -> mDescriptionProvider,
+        info -> mDescriptionContext);
+    if (description) {
+        cap_text_append_char(text, '\t');
+        cap_text_append_string(text, description);
+        cap_text_append_char(text, '\n');
+    }
+}
+
+/**
+ * @file
+ *
+ * Conversion of command line words to numbers. The functions in this file are
+ * used internally by `ArgumentParser` to parse values of `DT_INT` and
+ * `DT_DOUBLE` flags and positionals. Users of the library never need to call
+ * them directly.
+ *
+ * The conversions do not depend on the current locale, the decimal separator
+ * is always `.`. Doubles are correctly rounded: a decimal significand of up
+ * to 19 digits is converted using the algorithm by Clinger if the result is
+ * exact, and using the algorithm by Eisel and Lemire otherwise. Words which
+ * these cannot handle (hexadecimal floating point numbers, infinities, NaNs,
+ * and rare long significands) fall back to `strtod`.
+ */
+
+// ============================================================================
+// === NUMBER PARSING =========================================================
+// ============================================================================
+
+/**
+ * Result of converting a word to a number.
+ */
+typedef enum {
+    /// the word was converted
+    WCR_OK,
+    /// the word is not a number of the requested type
+    WCR_INVALID,
+    /// the word is a number, but it cannot be represented by the type
+    WCR_OUT_OF_RANGE
+} WordConversionResult;
+
+/// unsigned 128-bit integer
+typedef struct {
+    uint64_t mHigh;
+    uint64_t mLow;
+} _CapUint128;
+
+/// decimal number `mSignificand * 10^mExponent` read from a word
+typedef struct {
+    /// the first 19 significant digits
+    uint64_t mSignificand;
+    int64_t mExponent;
+    /// `true` if non-zero digits did not fit into `mSignificand`
+    bool mTruncated;
+} _CapDecimal;
+
+/// the smallest decimal exponent of a non-zero double
+#define _CAP_MIN_DECIMAL_EXPONENT (-342)
+/// the largest decimal exponent of a finite double
+#define _CAP_MAX_DECIMAL_EXPONENT 308
+/// the biased binary exponent of infinity
+#define _CAP_INFINITE_EXPONENT 0x7FF
+/// the number of explicit bits of the significand of a double
+#define _CAP_MANTISSA_BITS 52
+
+// ============================================================================
+// === NUMBER PARSING: DECLARATION OF PRIVATE FUNCTIONS =======================
+// ============================================================================
+
+static WordConversionResult _cap_parse_int(const char * word, int * value);
+static WordConversionResult _cap_parse_double(
+    const char * word, double * value);
+
+static const unsigned char * _cap_skip_space(const char * word);
+static bool _cap_scan_decimal(const unsigned char * c, _CapDecimal * decimal);
+static bool _cap_scan_special_double(const unsigned char * c);
+static bool _cap_is_word_nocase(const unsigned char * c, const char * word);
+static bool _cap_decimal_to_double(
+    const _CapDecimal * decimal, bool negative, double * value,
+    WordConversionResult * result);
+static bool _cap_decimal_to_double_fast(
+    const _CapDecimal * decimal, double * value);
+static uint64_t _cap_eisel_lemire(int64_t exponent, uint64_t significand);
+static _CapUint128 _cap_multiply_u64(uint64_t a, uint64_t b);
+static int _cap_leading_zeros_u64(uint64_t value);
+static WordConversionResult _cap_parse_double_fallback(
+    const char * word, double * value);
+
+static const uint64_t _CAP_POWERS_OF_FIVE[
+    _CAP_MAX_DECIMAL_EXPONENT - _CAP_MIN_DECIMAL_EXPONENT + 1][2];
+
+// ============================================================================
+// === NUMBER PARSING: IMPLEMENTATION OF PRIVATE FUNCTIONS ====================
+// ============================================================================
+
+static WordConversionResult _cap_parse_int(const char * word, int * value) {
+    // accepts the same words as `sscanf("%i")` consuming the whole word:
+    // leading white space, an optional sign, and a decimal, octal (leading
+    // `0`) or hexadecimal (leading `0x` or `0X`) number
+    const unsigned char * c = _cap_skip_space(word);
+    const bool negative = *c == '-';
+    if (*c == '-' || *c == '+') {
+        ++c;
+    }
+    unsigned int base = 10u;
+    if (*c == '0') {
+        base = 8u;
+        if ((c[1] | 0x20) == 'x') {
+            base = 16u;
+            c += 2;
+        }
+    }
+    const unsigned long long int limit = negative
+        ? (unsigned long long int) INT_MAX + 1u
+        : (unsigned long long int) INT_MAX;
+    unsigned long long int v = 0u;
+    bool overflow = false;
+    const unsigned char * first = c;
+    for (;; ++c) {
+        unsigned int digit = (unsigned int) (*c - '0');
+        if (digit > 9u && base == 16u) {
+            // maps both 'a' to 'f' and 'A' to 'F' to 10 to 15
+            digit = (unsigned int) ((*c | 0x20) - 'a') + 10u;
+            if (digit < 10u) {
+                break;
+            }
+        }
+        if (digit >= base) {
+            break;
+        }
+        // `v` never exceeds `limit`, so this cannot overflow. Decimal numbers
+        // are the common case, multiplying by a constant is cheaper.
+        v = (base == 10u ? v * 10u : v * base) + digit;
+        if (v > limit) {
+            overflow = true;
+            v = limit;
+        }
+    }
+    if (c == first || *c) {
+        return WCR_INVALID;
+    }
+    if (overflow) {
+        return WCR_OUT_OF_RANGE;
+    }
+    *value = negative ? (int) -(long long int) v : (int) v;
+    return WCR_OK;
+}
+
+static WordConversionResult _cap_parse_double(
+        const char * word, double * value) {
+    // accepts the same words as `strtod` in the "C" locale consuming the whole
+    // word. Finite numbers which overflow, or which are not zero but round to
+    // zero, are out of range.
+    const unsigned char * c = _cap_skip_space(word);
+    const bool negative = *c == '-';
+    if (*c == '-' || *c == '+') {
+        ++c;
+    }
+    _CapDecimal decimal;
+    if (!_cap_scan_decimal(c, &decimal)) {
+        return _cap_scan_special_double(c)
+            ? _cap_parse_double_fallback(word, value)
+            : WCR_INVALID;
+    }
+    WordConversionResult result;
+    if (!_cap_decimal_to_double(&decimal, negative, value, &result)) {
+        return _cap_parse_double_fallback(word, value);
+    }
+    return result;
+}
+
+static bool _cap_decimal_to_double(
+        const _CapDecimal * decimal, bool negative, double * value,
+        WordConversionResult * result) {
+    // returns `false` if the result cannot be determined because the decimal
+    // was truncated
+    *result = WCR_OK;
+    if (!decimal -> mSignificand) {
+        *value = negative ? -0.0 : 0.0;
+        return true;
+    }
+    double v;
+    if (!_cap_decimal_to_double_fast(decimal, &v)) {
+        uint64_t bits = _cap_eisel_lemire(
+            decimal -> mExponent, decimal -> mSignificand);
+        // the true significand lies between the truncated one and the next
+        // integer, the result is only known if both round to the same double
+        if (decimal -> mTruncated && bits != _cap_eisel_lemire(
+                decimal -> mExponent, decimal -> mSignificand + 1u)) {
+            return false;
+        }
+        if (!bits || bits
+                == (uint64_t) _CAP_INFINITE_EXPONENT << _CAP_MANTISSA_BITS) {
+            *result = WCR_OUT_OF_RANGE;
+            return true;
+        }
+        memcpy(&v, &bits, sizeof(v));
+    }
+    *value = negative ? -v : v;
+    return true;
+}
+
+static const unsigned char * _cap_skip_space(const char * word) {
+    // white space of the "C" locale
+    const unsigned char * c = (const unsigned char *) word;
+    while (*c == ' ' || (*c >= '\t' && *c <= '\r')) {
+        ++c;
+    }
+    return c;
+}
+
+static bool _cap_scan_decimal(const unsigned char * c, _CapDecimal * decimal) {
+    // reads digits, an optional fraction and an optional exponent. Returns
+    // `false` if these do not make up the rest of the word.
+    static const int MAX_DIGITS = 19;
+    uint64_t significand = 0u;
+    int64_t exponent = 0;
+    int digits = 0;
+    bool truncated = false;
+    bool any_digit = false;
+    for (; *c >= '0' && *c <= '9'; ++c) {
+        any_digit = true;
+        const unsigned int digit = (unsigned int) (*c - '0');
+        if (digits < MAX_DIGITS) {
+            significand = significand * 10u + digit;
+            // leading zeros are not significant
+            digits += significand != 0u;
+        } else {
+            ++exponent;
+            truncated |= digit != 0u;
+        }
+    }
+    if (*c == '.') {
+        for (++c; *c >= '0' && *c <= '9'; ++c) {
+            any_digit = true;
+            const unsigned int digit = (unsigned int) (*c - '0');
+            if (digits < MAX_DIGITS) {
+                significand = significand * 10u + digit;
+                digits += significand != 0u;
+                --exponent;
+            } else {
+                truncated |= digit != 0u;
+            }
+        }
+    }
+    if (!any_digit) {
+        return false;
+    }
+    if (*c == 'e' || *c == 'E') {
+        ++c;
+        const bool negative = *c == '-';
+        if (*c == '-' || *c == '+') {
+            ++c;
+        }
+        if (*c < '0' || *c > '9') {
+            return false;
+        }
+        // larger exponents lead to zero or infinity anyway
+        static const int64_t MAX_EXPONENT = 100000;
+        int64_t e = 0;
+        for (; *c >= '0' && *c <= '9'; ++c) {
+            if (e < MAX_EXPONENT) {
+                e = e * 10 + (*c - '0');
+            }
+        }
+        exponent += negative ? -e : e;
+    }
+    if (*c) {
+        return false;
+    }
+    *decimal = (_CapDecimal) {
+        .mSignificand = significand,
+        .mExponent = exponent,
+        .mTruncated = truncated
+    };
+    return true;
+}
+
+static bool _cap_scan_special_double(const unsigned char * c) {
+    // checks for an infinity, a NaN or a hexadecimal floating point number,
+    // the rest of the word must match
+    if (_cap_is_word_nocase(c, "inf") || _cap_is_word_nocase(c, "infinity")) {
+        return true;
+    }
+    if ((c[0] | 0x20) == 'n' && (c[1] | 0x20) == 'a' && (c[2] | 0x20) == 'n') {
+        c += 3;
+        if (!*c) {
+            return true;
+        }
+        if (*c++ != '(') {
+            return false;
+        }
+        while (*c == '_' || (*c >= '0' && *c <= '9')
+                || ((*c | 0x20) >= 'a' && (*c | 0x20) <= 'z')) {
+            ++c;
+        }
+        return c[0] == ')' && !c[1];
+    }
+    if (c[0] != '0' || (c[1] | 0x20) != 'x') {
+        return false;
+    }
+    c += 2;
+    bool any_digit = false;
+    bool point = false;
+    for (;; ++c) {
+        const bool is_hex_letter = (*c | 0x20) >= 'a' && (*c | 0x20) <= 'f';
+        if ((*c >= '0' && *c <= '9') || is_hex_letter) {
+            any_digit = true;
+        } else if (*c == '.' && !point) {
+            point = true;
+        } else {
+            break;
+        }
+    }
+    if (!any_digit) {
+        return false;
+    }
+    if ((*c | 0x20) == 'p') {
+        ++c;
+        if (*c == '-' || *c == '+') {
+            ++c;
+        }
+        if (*c < '0' || *c > '9') {
+            return false;
+        }
+        while (*c >= '0' && *c <= '9') {
+            ++c;
+        }
+    }
+    return !*c;
+}
+
+static bool _cap_is_word_nocase(const unsigned char * c, const char * word) {
+    // `word` must be in lower case
+    for (; *word; ++c, ++word) {
+        if ((*c | 0x20) != (unsigned char) *word) {
+            return false;
+        }
+    }
+    return !*c;
+}
+
+static bool _cap_decimal_to_double_fast(
+        const _CapDecimal * decimal, double * value) {
+    // Clinger's fast path: if both the significand and the power of ten are
+    // exactly representable, a single rounding operation gives the result
+#if FLT_EVAL_METHOD == 0
+    static const double POWERS_OF_TEN[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    static const int64_t MAX_EXACT_EXPONENT = 22;
+    static const uint64_t MAX_EXACT_SIGNIFICAND
+        = (uint64_t) 1u << (_CAP_MANTISSA_BITS + 1);
+    if (decimal -> mTruncated
+            || decimal -> mSignificand > MAX_EXACT_SIGNIFICAND
+            || decimal -> mExponent < -MAX_EXACT_EXPONENT
+            || decimal -> mExponent > MAX_EXACT_EXPONENT) {
+        return false;
+    }
+    const double v = (double) decimal -> mSignificand;
+    *value = decimal -> mExponent < 0
+        ? v / POWERS_OF_TEN[-decimal -> mExponent]
+        : v * POWERS_OF_TEN[decimal -> mExponent];
+    return true;
+#else
+    // with excess precision the result would be rounded twice
+    (void) decimal;
+    (void) value;
+    return false;
+#endif
+}
+
+static uint64_t _cap_eisel_lemire(int64_t exponent, uint64_t significand) {
+    // Converts `significand * 10^exponent` (with a non-zero significand) to
+    // the bits of a positive double, rounding to nearest, ties to even. See
+    // Lemire, "Number Parsing at a Gigabyte per Second" (2021), and Mushtak
+    // and Lemire, "Fast Number Parsing Without Fallback" (2023) for the proof
+    // that the 128-bit product is always precise enough.
+    if (exponent < _CAP_MIN_DECIMAL_EXPONENT) {
+        return 0u;
+    }
+    if (exponent > _CAP_MAX_DECIMAL_EXPONENT) {
+        return (uint64_t) _CAP_INFINITE_EXPONENT << _CAP_MANTISSA_BITS;
+    }
+    const int leading_zeros = _cap_leading_zeros_u64(significand);
+    significand <<= leading_zeros;
+
+    // the product needs 55 correct bits: the mantissa, the implicit bit, one
+    // bit for rounding and one because the product may not be normalized
+    const uint64_t * power
+        = _CAP_POWERS_OF_FIVE[exponent - _CAP_MIN_DECIMAL_EXPONENT];
+    _CapUint128 product = _cap_multiply_u64(significand, power[0]);
+    static const uint64_t PRECISION_MASK = UINT64_MAX >> 55;
+    if ((product.mHigh & PRECISION_MASK) == PRECISION_MASK) {
+        const _CapUint128 second = _cap_multiply_u64(significand, power[1]);
+        product.mLow += second.mHigh;
+        if (second.mHigh > product.mLow) {
+            ++product.mHigh;
+        }
+    }
+
+    const int upper_bit = (int) (product.mHigh >> 63);
+    const int shift = upper_bit + 64 - _CAP_MANTISSA_BITS - 3;
+    uint64_t mantissa = product.mHigh >> shift;
+    // floor(exponent * log2(10)) + 63, the shift is arithmetic in practice
+    static const int EXPONENT_BIAS = 1023;
+    int64_t binary_exponent = ((217706 * exponent) >> 16) + 63
+        + upper_bit - leading_zeros + EXPONENT_BIAS;
+
+    if (binary_exponent <= 0) {
+        // subnormal number
+        if (-binary_exponent + 1 >= 64) {
+            return 0u;
+        }
+        mantissa >>= -binary_exponent + 1;
+        mantissa += mantissa & 1u;
+        mantissa >>= 1;
+        // rounding may have produced the smallest normal number, whose
+        // implicit bit becomes the lowest bit of the exponent
+        return mantissa;
+    }
+    // a tie: the product is exact and exactly halfway between two doubles.
+    // This is only possible for small exponents.
+    if (product.mLow <= 1u && exponent >= -4 && exponent <= 23
+            && (mantissa & 3u) == 1u
+            && (mantissa << shift) == product.mHigh) {
+        mantissa &= ~(uint64_t) 1u;
+    }
+    mantissa += mantissa & 1u;
+    mantissa >>= 1;
+    if (mantissa >= (uint64_t) 2u << _CAP_MANTISSA_BITS) {
+        mantissa = (uint64_t) 1u << _CAP_MANTISSA_BITS;
+        ++binary_exponent;
+    }
+    mantissa &= ~((uint64_t) 1u << _CAP_MANTISSA_BITS);
+    if (binary_exponent >= _CAP_INFINITE_EXPONENT) {
+        return (uint64_t) _CAP_INFINITE_EXPONENT << _CAP_MANTISSA_BITS;
+    }
+    return mantissa | (uint64_t) binary_exponent << _CAP_MANTISSA_BITS;
+}
+
+static _CapUint128 _cap_multiply_u64(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 uint128;
+    const uint128 product = (uint128) a * b;
+    return (_CapUint128) {
+        .mHigh = (uint64_t) (product >> 64),
+        .mLow = (uint64_t) product
+    };
+#else
+    const uint64_t a_low = (uint32_t) a, a_high = a >> 32;
+    const uint64_t b_low = (uint32_t) b, b_high = b >> 32;
+    const uint64_t low_low = a_low * b_low;
+    const uint64_t high_low = a_high * b_low;
+    const uint64_t low_high = a_low * b_high;
+    const uint64_t high_high = a_high * b_high;
+    const uint64_t middle = (low_low >> 32) + (uint32_t) high_low + low_high;
+    return (_CapUint128) {
+        .mHigh = high_high + (high_low >> 32) + (middle >> 32),
+        .mLow = (middle << 32) | (uint32_t) low_low
+    };
+#endif
+}
+
+static int _cap_leading_zeros_u64(uint64_t value) {
+    // `value` must not be zero
+#if defined(__GNUC__)
+    return __builtin_clzll(value);
+#else
+    int count = 0;
+    while (!(value & ((uint64_t) 1u << 63))) {
+        value <<= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+static WordConversionResult _cap_parse_double_fallback(
+        const char * word, double * value) {
+    // `strtod` for words which have already been checked to be well-formed.
+    // It depends on the locale, so `.` is replaced by the decimal point of
+    // the current locale first.
+    const char * point = localeconv() -> decimal_point;
+    const size_t point_length = strlen(point);
+    const size_t size = strlen(word) * point_length + 1u;
+    char buffer[64];
+    char * copy = size <= sizeof(buffer) ? buffer : (char *) cap_malloc(size);
+    char * out = copy;
+    for (const char * c = word; *c; ++c) {
+        if (*c == '.') {
+            memcpy(out, point, point_length);
+            out += point_length;
+        } else {
+            *out++ = *c;
+        }
+    }
+    *out = '\0';
+
+    char * end;
+    errno = 0;
+    const double v = strtod(copy, &end);
+    const bool consumed = !*end;
+    const bool range_error = errno == ERANGE
+        && (v == 0.0 || v > DBL_MAX || v < -DBL_MAX);
+    if (copy != buffer) {
+        cap_free(copy);
+    }
+    if (!consumed) {
+        return WCR_INVALID;
+    }
+    if (range_error) {
+        return WCR_OUT_OF_RANGE;
+    }
+    *value = v;
+    return WCR_OK;
+}
+
+// ============================================================================
+// === NUMBER PARSING: POWERS OF FIVE =========================================
+// ============================================================================
+
+/// 128-bit approximations of 5^q for q from -342 to 308, normalized so that
+/// the most significant bit is set. Negative powers are rounded up, others
+/// are truncated.
+static const uint64_t _CAP_POWERS_OF_FIVE[
+        _CAP_MAX_DECIMAL_EXPONENT - _CAP_MIN_DECIMAL_EXPONENT + 1][2] = {
+    {0xeef453d6923bd65au, 0x113faa2906a13b3fu},
+    {0x9558b4661b6565f8u, 0x4ac7ca59a424c507u},
+    {0xbaaee17fa23ebf76u, 0x5d79bcf00d2df649u},
+    {0xe95a99df8ace6f53u, 0xf4d82c2c107973dcu},
+    {0x91d8a02bb6c10594u, 0x79071b9b8a4be869u},
+    {0xb64ec836a47146f9u, 0x9748e2826cdee284u},
+    {0xe3e27a444d8d98b7u, 0xfd1b1b2308169b25u},
+    {0x8e6d8c6ab0787f72u, 0xfe30f0f5e50e20f7u},
+    {0xb208ef855c969f4fu, 0xbdbd2d335e51a935u},
+    {0xde8b2b66b3bc4723u, 0xad2c788035e61382u},
+    {0x8b16fb203055ac76u, 0x4c3bcb5021afcc31u},
+    {0xaddcb9e83c6b1793u, 0xdf4abe242a1bbf3du},
+    {0xd953e8624b85dd78u, 0xd71d6dad34a2af0du},
+    {0x87d4713d6f33aa6bu, 0x8672648c40e5ad68u},
+    {0xa9c98d8ccb009506u, 0x680efdaf511f18c2u},
+    {0xd43bf0effdc0ba48u, 0x0212bd1b2566def2u},
+    {0x84a57695fe98746du, 0x014bb630f7604b57u},
+    {0xa5ced43b7e3e9188u, 0x419ea3bd35385e2du},
+    {0xcf42894a5dce35eau, 0x52064cac828675b9u},
+    {0x818995ce7aa0e1b2u, 0x7343efebd1940993u},
+    {0xa1ebfb4219491a1fu, 0x1014ebe6c5f90bf8u},
+    {0xca66fa129f9b60a6u, 0xd41a26e077774ef6u},
+    {0xfd00b897478238d0u, 0x8920b098955522b4u},
+    {0x9e20735e8cb16382u, 0x55b46e5f5d5535b0u},
+    {0xc5a890362fddbc62u, 0xeb2189f734aa831du},
+    {0xf712b443bbd52b7bu, 0xa5e9ec7501d523e4u},
+    {0x9a6bb0aa55653b2du, 0x47b233c92125366eu},
+    {0xc1069cd4eabe89f8u, 0x999ec0bb696e840au},
+    {0xf148440a256e2c76u, 0xc00670ea43ca250du},
+    {0x96cd2a865764dbcau, 0x380406926a5e5728u},
+    {0xbc807527ed3e12bcu, 0xc605083704f5ecf2u},
+    {0xeba09271e88d976bu, 0xf7864a44c633682eu},
+    {0x93445b8731587ea3u, 0x7ab3ee6afbe0211du},
+    {0xb8157268fdae9e4cu, 0x5960ea05bad82964u},
+    {0xe61acf033d1a45dfu, 0x6fb92487298e33bdu},
+    {0x8fd0c16206306babu, 0xa5d3b6d479f8e056u},
+    {0xb3c4f1ba87bc8696u, 0x8f48a4899877186cu},
+    {0xe0b62e2929aba83cu, 0x331acdabfe94de87u},
+    {0x8c71dcd9ba0b4925u, 0x9ff0c08b7f1d0b14u},
+    {0xaf8e5410288e1b6fu, 0x07ecf0ae5ee44dd9u},
+    {0xdb71e91432b1a24au, 0xc9e82cd9f69d6150u},
+    {0x892731ac9faf056eu, 0xbe311c083a225cd2u},
+    {0xab70fe17c79ac6cau, 0x6dbd630a48aaf406u},
+    {0xd64d3d9db981787du, 0x092cbbccdad5b108u},
+    {0x85f0468293f0eb4eu, 0x25bbf56008c58ea5u},
+    {0xa76c582338ed2621u, 0xaf2af2b80af6f24eu},
+    {0xd1476e2c07286faau, 0x1af5af660db4aee1u},
+    {0x82cca4db847945cau, 0x50d98d9fc890ed4du},
+    {0xa37fce126597973cu, 0xe50ff107bab528a0u},
+    {0xcc5fc196fefd7d0cu, 0x1e53ed49a96272c8u},
+    {0xff77b1fcbebcdc4fu, 0x25e8e89c13bb0f7au},
+    {0x9faacf3df73609b1u, 0x77b191618c54e9acu},
+    {0xc795830d75038c1du, 0xd59df5b9ef6a2417u},
+    {0xf97ae3d0d2446f25u, 0x4b0573286b44ad1du},
+    {0x9becce62836ac577u, 0x4ee367f9430aec32u},
+    {0xc2e801fb244576d5u, 0x229c41f793cda73fu},
+    {0xf3a20279ed56d48au, 0x6b43527578c1110fu},
+    {0x9845418c345644d6u, 0x830a13896b78aaa9u},
+    {0xbe5691ef416bd60cu, 0x23cc986bc656d553u},
+    {0xedec366b11c6cb8fu, 0x2cbfbe86b7ec8aa8u},
+    {0x94b3a202eb1c3f39u, 0x7bf7d71432f3d6a9u},
+    {0xb9e08a83a5e34f07u, 0xdaf5ccd93fb0cc53u},
+    {0xe858ad248f5c22c9u, 0xd1b3400f8f9cff68u},
+    {0x91376c36d99995beu, 0x23100809b9c21fa1u},
+    {0xb58547448ffffb2du, 0xabd40a0c2832a78au},
+    {0xe2e69915b3fff9f9u, 0x16c90c8f323f516cu},
+    {0x8dd01fad907ffc3bu, 0xae3da7d97f6792e3u},
+    {0xb1442798f49ffb4au, 0x99cd11cfdf41779cu},
+    {0xdd95317f31c7fa1du, 0x40405643d711d583u},
+    {0x8a7d3eef7f1cfc52u, 0x482835ea666b2572u},
+    {0xad1c8eab5ee43b66u, 0xda3243650005eecfu},
+    {0xd863b256369d4a40u, 0x90bed43e40076a82u},
+    {0x873e4f75e2224e68u, 0x5a7744a6e804a291u},
+    {0xa90de3535aaae202u, 0x711515d0a205cb36u},
+    {0xd3515c2831559a83u, 0x0d5a5b44ca873e03u},
+    {0x8412d9991ed58091u, 0xe858790afe9486c2u},
+    {0xa5178fff668ae0b6u, 0x626e974dbe39a872u},
+    {0xce5d73ff402d98e3u, 0xfb0a3d212dc8128fu},
+    {0x80fa687f881c7f8eu, 0x7ce66634bc9d0b99u},
+    {0xa139029f6a239f72u, 0x1c1fffc1ebc44e80u},
+    {0xc987434744ac874eu, 0xa327ffb266b56220u},
+    {0xfbe9141915d7a922u, 0x4bf1ff9f0062baa8u},
+    {0x9d71ac8fada6c9b5u, 0x6f773fc3603db4a9u},
+    {0xc4ce17b399107c22u, 0xcb550fb4384d21d3u},
+    {0xf6019da07f549b2bu, 0x7e2a53a146606a48u},
+    {0x99c102844f94e0fbu, 0x2eda7444cbfc426du},
+    {0xc0314325637a1939u, 0xfa911155fefb5308u},
+    {0xf03d93eebc589f88u, 0x793555ab7eba27cau},
+    {0x96267c7535b763b5u, 0x4bc1558b2f3458deu},
+    {0xbbb01b9283253ca2u, 0x9eb1aaedfb016f16u},
+    {0xea9c227723ee8bcbu, 0x465e15a979c1cadcu},
+    {0x92a1958a7675175fu, 0x0bfacd89ec191ec9u},
+    {0xb749faed14125d36u, 0xcef980ec671f667bu},
+    {0xe51c79a85916f484u, 0x82b7e12780e7401au},
+    {0x8f31cc0937ae58d2u, 0xd1b2ecb8b0908810u},
+    {0xb2fe3f0b8599ef07u, 0x861fa7e6dcb4aa15u},
+    {0xdfbdcece67006ac9u, 0x67a791e093e1d49au},
+    {0x8bd6a141006042bdu, 0xe0c8bb2c5c6d24e0u},
+    {0xaecc49914078536du, 0x58fae9f773886e18u},
+    {0xda7f5bf590966848u, 0xaf39a475506a899eu},
+    {0x888f99797a5e012du, 0x6d8406c952429603u},
+    {0xaab37fd7d8f58178u, 0xc8e5087ba6d33b83u},
+    {0xd5605fcdcf32e1d6u, 0xfb1e4a9a90880a64u},
+    {0x855c3be0a17fcd26u, 0x5cf2eea09a55067fu},
+    {0xa6b34ad8c9dfc06fu, 0xf42faa48c0ea481eu},
+    {0xd0601d8efc57b08bu, 0xf13b94daf124da26u},
+    {0x823c12795db6ce57u, 0x76c53d08d6b70858u},
+    {0xa2cb1717b52481edu, 0x54768c4b0c64ca6eu},
+    {0xcb7ddcdda26da268u, 0xa9942f5dcf7dfd09u},
+    {0xfe5d54150b090b02u, 0xd3f93b35435d7c4cu},
+    {0x9efa548d26e5a6e1u, 0xc47bc5014a1a6dafu},
+    {0xc6b8e9b0709f109au, 0x359ab6419ca1091bu},
+    {0xf867241c8cc6d4c0u, 0xc30163d203c94b62u},
+    {0x9b407691d7fc44f8u, 0x79e0de63425dcf1du},
+    {0xc21094364dfb5636u, 0x985915fc12f542e4u},
+    {0xf294b943e17a2bc4u, 0x3e6f5b7b17b2939du},
+    {0x979cf3ca6cec5b5au, 0xa705992ceecf9c42u},
+    {0xbd8430bd08277231u, 0x50c6ff782a838353u},
+    {0xece53cec4a314ebdu, 0xa4f8bf5635246428u},
+    {0x940f4613ae5ed136u, 0x871b7795e136be99u},
+    {0xb913179899f68584u, 0x28e2557b59846e3fu},
+    {0xe757dd7ec07426e5u, 0x331aeada2fe589cfu},
+    {0x9096ea6f3848984fu, 0x3ff0d2c85def7621u},
+    {0xb4bca50b065abe63u, 0x0fed077a756b53a9u},
+    {0xe1ebce4dc7f16dfbu, 0xd3e8495912c62894u},
+    {0x8d3360f09cf6e4bdu, 0x64712dd7abbbd95cu},
+    {0xb080392cc4349decu, 0xbd8d794d96aacfb3u},
+    {0xdca04777f541c567u, 0xecf0d7a0fc5583a0u},
+    {0x89e42caaf9491b60u, 0xf41686c49db57244u},
+    {0xac5d37d5b79b6239u, 0x311c2875c522ced5u},
+    {0xd77485cb25823ac7u, 0x7d633293366b828bu},
+    {0x86a8d39ef77164bcu, 0xae5dff9c02033197u},
+    {0xa8530886b54dbdebu, 0xd9f57f830283fdfcu},
+    {0xd267caa862a12d66u, 0xd072df63c324fd7bu},
+    {0x8380dea93da4bc60u, 0x4247cb9e59f71e6du},
+    {0xa46116538d0deb78u, 0x52d9be85f074e608u},
+    {0xcd795be870516656u, 0x67902e276c921f8bu},
+    {0x806bd9714632dff6u, 0x00ba1cd8a3db53b6u},
+    {0xa086cfcd97bf97f3u, 0x80e8a40eccd228a4u},
+    {0xc8a883c0fdaf7df0u, 0x6122cd128006b2cdu},
+    {0xfad2a4b13d1b5d6cu, 0x796b805720085f81u},
+    {0x9cc3a6eec6311a63u, 0xcbe3303674053bb0u},
+    {0xc3f490aa77bd60fcu, 0xbedbfc4411068a9cu},
+    {0xf4f1b4d515acb93bu, 0xee92fb5515482d44u},
+    {0x991711052d8bf3c5u, 0x751bdd152d4d1c4au},
+    {0xbf5cd54678eef0b6u, 0xd262d45a78a0635du},
+    {0xef340a98172aace4u, 0x86fb897116c87c34u},
+    {0x9580869f0e7aac0eu, 0xd45d35e6ae3d4da0u},
+    {0xbae0a846d2195712u, 0x8974836059cca109u},
+    {0xe998d258869facd7u, 0x2bd1a438703fc94bu},
+    {0x91ff83775423cc06u, 0x7b6306a34627ddcfu},
+    {0xb67f6455292cbf08u, 0x1a3bc84c17b1d542u},
+    {0xe41f3d6a7377eecau, 0x20caba5f1d9e4a93u},
+    {0x8e938662882af53eu, 0x547eb47b7282ee9cu},
+    {0xb23867fb2a35b28du, 0xe99e619a4f23aa43u},
+    {0xdec681f9f4c31f31u, 0x6405fa00e2ec94d4u},
+    {0x8b3c113c38f9f37eu, 0xde83bc408dd3dd04u},
+    {0xae0b158b4738705eu, 0x9624ab50b148d445u},
+    {0xd98ddaee19068c76u, 0x3badd624dd9b0957u},
+    {0x87f8a8d4cfa417c9u, 0xe54ca5d70a80e5d6u},
+    {0xa9f6d30a038d1dbcu, 0x5e9fcf4ccd211f4cu},
+    {0xd47487cc8470652bu, 0x7647c3200069671fu},
+    {0x84c8d4dfd2c63f3bu, 0x29ecd9f40041e073u},
+    {0xa5fb0a17c777cf09u, 0xf468107100525890u},
+    {0xcf79cc9db955c2ccu, 0x7182148d4066eeb4u},
+    {0x81ac1fe293d599bfu, 0xc6f14cd848405530u},
+    {0xa21727db38cb002fu, 0xb8ada00e5a506a7cu},
+    {0xca9cf1d206fdc03bu, 0xa6d90811f0e4851cu},
+    {0xfd442e4688bd304au, 0x908f4a166d1da663u},
+    {0x9e4a9cec15763e2eu, 0x9a598e4e043287feu},
+    {0xc5dd44271ad3cdbau, 0x40eff1e1853f29fdu},
+    {0xf7549530e188c128u, 0xd12bee59e68ef47cu},
+    {0x9a94dd3e8cf578b9u, 0x82bb74f8301958ceu},
+    {0xc13a148e3032d6e7u, 0xe36a52363c1faf01u},
+    {0xf18899b1bc3f8ca1u, 0xdc44e6c3cb279ac1u},
+    {0x96f5600f15a7b7e5u, 0x29ab103a5ef8c0b9u},
+    {0xbcb2b812db11a5deu, 0x7415d448f6b6f0e7u},
+    {0xebdf661791d60f56u, 0x111b495b3464ad21u},
+    {0x936b9fcebb25c995u, 0xcab10dd900beec34u},
+    {0xb84687c269ef3bfbu, 0x3d5d514f40eea742u},
+    {0xe65829b3046b0afau, 0x0cb4a5a3112a5112u},
+    {0x8ff71a0fe2c2e6dcu, 0x47f0e785eaba72abu},
+    {0xb3f4e093db73a093u, 0x59ed216765690f56u},
+    {0xe0f218b8d25088b8u, 0x306869c13ec3532cu},
+    {0x8c974f7383725573u, 0x1e414218c73a13fbu},
+    {0xafbd2350644eeacfu, 0xe5d1929ef90898fau},
+    {0xdbac6c247d62a583u, 0xdf45f746b74abf39u},
+    {0x894bc396ce5da772u, 0x6b8bba8c328eb783u},
+    {0xab9eb47c81f5114fu, 0x066ea92f3f326564u},
+    {0xd686619ba27255a2u, 0xc80a537b0efefebdu},
+    {0x8613fd0145877585u, 0xbd06742ce95f5f36u},
+    {0xa798fc4196e952e7u, 0x2c48113823b73704u},
+    {0xd17f3b51fca3a7a0u, 0xf75a15862ca504c5u},
+    {0x82ef85133de648c4u, 0x9a984d73dbe722fbu},
+    {0xa3ab66580d5fdaf5u, 0xc13e60d0d2e0ebbau},
+    {0xcc963fee10b7d1b3u, 0x318df905079926a8u},
+    {0xffbbcfe994e5c61fu, 0xfdf17746497f7052u},
+    {0x9fd561f1fd0f9bd3u, 0xfeb6ea8bedefa633u},
+    {0xc7caba6e7c5382c8u, 0xfe64a52ee96b8fc0u},
+    {0xf9bd690a1b68637bu, 0x3dfdce7aa3c673b0u},
+    {0x9c1661a651213e2du, 0x06bea10ca65c084eu},
+    {0xc31bfa0fe5698db8u, 0x486e494fcff30a62u},
+    {0xf3e2f893dec3f126u, 0x5a89dba3c3efccfau},
+    {0x986ddb5c6b3a76b7u, 0xf89629465a75e01cu},
+    {0xbe89523386091465u, 0xf6bbb397f1135823u},
+    {0xee2ba6c0678b597fu, 0x746aa07ded582e2cu},
+    {0x94db483840b717efu, 0xa8c2a44eb4571cdcu},
+    {0xba121a4650e4ddebu, 0x92f34d62616ce413u},
+    {0xe896a0d7e51e1566u, 0x77b020baf9c81d17u},
+    {0x915e2486ef32cd60u, 0x0ace1474dc1d122eu},
+    {0xb5b5ada8aaff80b8u, 0x0d819992132456bau},
+    {0xe3231912d5bf60e6u, 0x10e1fff697ed6c69u},
+    {0x8df5efabc5979c8fu, 0xca8d3ffa1ef463c1u},
+    {0xb1736b96b6fd83b3u, 0xbd308ff8a6b17cb2u},
+    {0xddd0467c64bce4a0u, 0xac7cb3f6d05ddbdeu},
+    {0x8aa22c0dbef60ee4u, 0x6bcdf07a423aa96bu},
+    {0xad4ab7112eb3929du, 0x86c16c98d2c953c6u},
+    {0xd89d64d57a607744u, 0xe871c7bf077ba8b7u},
+    {0x87625f056c7c4a8bu, 0x11471cd764ad4972u},
+    {0xa93af6c6c79b5d2du, 0xd598e40d3dd89bcfu},
+    {0xd389b47879823479u, 0x4aff1d108d4ec2c3u},
+    {0x843610cb4bf160cbu, 0xcedf722a585139bau},
+    {0xa54394fe1eedb8feu, 0xc2974eb4ee658828u},
+    {0xce947a3da6a9273eu, 0x733d226229feea32u},
+    {0x811ccc668829b887u, 0x0806357d5a3f525fu},
+    {0xa163ff802a3426a8u, 0xca07c2dcb0cf26f7u},
+    {0xc9bcff6034c13052u, 0xfc89b393dd02f0b5u},
+    {0xfc2c3f3841f17c67u, 0xbbac2078d443ace2u},
+    {0x9d9ba7832936edc0u, 0xd54b944b84aa4c0du},
+    {0xc5029163f384a931u, 0x0a9e795e65d4df11u},
+    {0xf64335bcf065d37du, 0x4d4617b5ff4a16d5u},
+    {0x99ea0196163fa42eu, 0x504bced1bf8e4e45u},
+    {0xc06481fb9bcf8d39u, 0xe45ec2862f71e1d6u},
+    {0xf07da27a82c37088u, 0x5d767327bb4e5a4cu},
+    {0x964e858c91ba2655u, 0x3a6a07f8d510f86fu},
+    {0xbbe226efb628afeau, 0x890489f70a55368bu},
+    {0xeadab0aba3b2dbe5u, 0x2b45ac74ccea842eu},
+    {0x92c8ae6b464fc96fu, 0x3b0b8bc90012929du},
+    {0xb77ada0617e3bbcbu, 0x09ce6ebb40173744u},
+    {0xe55990879ddcaabdu, 0xcc420a6a101d0515u},
+    {0x8f57fa54c2a9eab6u, 0x9fa946824a12232du},
+    {0xb32df8e9f3546564u, 0x47939822dc96abf9u},
+    {0xdff9772470297ebdu, 0x59787e2b93bc56f7u},
+    {0x8bfbea76c619ef36u, 0x57eb4edb3c55b65au},
+    {0xaefae51477a06b03u, 0xede622920b6b23f1u},
+    {0xdab99e59958885c4u, 0xe95fab368e45ecedu},
+    {0x88b402f7fd75539bu, 0x11dbcb0218ebb414u},
+    {0xaae103b5fcd2a881u, 0xd652bdc29f26a119u},
+    {0xd59944a37c0752a2u, 0x4be76d3346f0495fu},
+    {0x857fcae62d8493a5u, 0x6f70a4400c562ddbu},
+    {0xa6dfbd9fb8e5b88eu, 0xcb4ccd500f6bb952u},
+    {0xd097ad07a71f26b2u, 0x7e2000a41346a7a7u},
+    {0x825ecc24c873782fu, 0x8ed400668c0c28c8u},
+    {0xa2f67f2dfa90563bu, 0x728900802f0f32fau},
+    {0xcbb41ef979346bcau, 0x4f2b40a03ad2ffb9u},
+    {0xfea126b7d78186bcu, 0xe2f610c84987bfa8u},
+    {0x9f24b832e6b0f436u, 0x0dd9ca7d2df4d7c9u},
+    {0xc6ede63fa05d3143u, 0x91503d1c79720dbbu},
+    {0xf8a95fcf88747d94u, 0x75a44c6397ce912au},
+    {0x9b69dbe1b548ce7cu, 0xc986afbe3ee11abau},
+    {0xc24452da229b021bu, 0xfbe85badce996168u},
+    {0xf2d56790ab41c2a2u, 0xfae27299423fb9c3u},
+    {0x97c560ba6b0919a5u, 0xdccd879fc967d41au},
+    {0xbdb6b8e905cb600fu, 0x5400e987bbc1c920u},
+    {0xed246723473e3813u, 0x290123e9aab23b68u},
+    {0x9436c0760c86e30bu, 0xf9a0b6720aaf6521u},
+    {0xb94470938fa89bceu, 0xf808e40e8d5b3e69u},
+    {0xe7958cb87392c2c2u, 0xb60b1d1230b20e04u},
+    {0x90bd77f3483bb9b9u, 0xb1c6f22b5e6f48c2u},
+    {0xb4ecd5f01a4aa828u, 0x1e38aeb6360b1af3u},
+    {0xe2280b6c20dd5232u, 0x25c6da63c38de1b0u},
+    {0x8d590723948a535fu, 0x579c487e5a38ad0eu},
+    {0xb0af48ec79ace837u, 0x2d835a9df0c6d851u},
+    {0xdcdb1b2798182244u, 0xf8e431456cf88e65u},
+    {0x8a08f0f8bf0f156bu, 0x1b8e9ecb641b58ffu},
+    {0xac8b2d36eed2dac5u, 0xe272467e3d222f3fu},
+    {0xd7adf884aa879177u, 0x5b0ed81dcc6abb0fu},
+    {0x86ccbb52ea94baeau, 0x98e947129fc2b4e9u},
+    {0xa87fea27a539e9a5u, 0x3f2398d747b36224u},
+    {0xd29fe4b18e88640eu, 0x8eec7f0d19a03aadu},
+    {0x83a3eeeef9153e89u, 0x1953cf68300424acu},
+    {0xa48ceaaab75a8e2bu, 0x5fa8c3423c052dd7u},
+    {0xcdb02555653131b6u, 0x3792f412cb06794du},
+    {0x808e17555f3ebf11u, 0xe2bbd88bbee40bd0u},
+    {0xa0b19d2ab70e6ed6u, 0x5b6aceaeae9d0ec4u},
+    {0xc8de047564d20a8bu, 0xf245825a5a445275u},
+    {0xfb158592be068d2eu, 0xeed6e2f0f0d56712u},
+    {0x9ced737bb6c4183du, 0x55464dd69685606bu},
+    {0xc428d05aa4751e4cu, 0xaa97e14c3c26b886u},
+    {0xf53304714d9265dfu, 0xd53dd99f4b3066a8u},
+    {0x993fe2c6d07b7fabu, 0xe546a8038efe4029u},
+    {0xbf8fdb78849a5f96u, 0xde98520472bdd033u},
+    {0xef73d256a5c0f77cu, 0x963e66858f6d4440u},
+    {0x95a8637627989aadu, 0xdde7001379a44aa8u},
+    {0xbb127c53b17ec159u, 0x5560c018580d5d52u},
+    {0xe9d71b689dde71afu, 0xaab8f01e6e10b4a6u},
+    {0x9226712162ab070du, 0xcab3961304ca70e8u},
+    {0xb6b00d69bb55c8d1u, 0x3d607b97c5fd0d22u},
+    {0xe45c10c42a2b3b05u, 0x8cb89a7db77c506au},
+    {0x8eb98a7a9a5b04e3u, 0x77f3608e92adb242u},
+    {0xb267ed1940f1c61cu, 0x55f038b237591ed3u},
+    {0xdf01e85f912e37a3u, 0x6b6c46dec52f6688u},
+    {0x8b61313bbabce2c6u, 0x2323ac4b3b3da015u},
+    {0xae397d8aa96c1b77u, 0xabec975e0a0d081au},
+    {0xd9c7dced53c72255u, 0x96e7bd358c904a21u},
+    {0x881cea14545c7575u, 0x7e50d64177da2e54u},
+    {0xaa242499697392d2u, 0xdde50bd1d5d0b9e9u},
+    {0xd4ad2dbfc3d07787u, 0x955e4ec64b44e864u},
+    {0x84ec3c97da624ab4u, 0xbd5af13bef0b113eu},
+    {0xa6274bbdd0fadd61u, 0xecb1ad8aeacdd58eu},
+    {0xcfb11ead453994bau, 0x67de18eda5814af2u},
+    {0x81ceb32c4b43fcf4u, 0x80eacf948770ced7u},
+    {0xa2425ff75e14fc31u, 0xa1258379a94d028du},
+    {0xcad2f7f5359a3b3eu, 0x096ee45813a04330u},
+    {0xfd87b5f28300ca0du, 0x8bca9d6e188853fcu},
+    {0x9e74d1b791e07e48u, 0x775ea264cf55347eu},
+    {0xc612062576589ddau, 0x95364afe032a819eu},
+    {0xf79687aed3eec551u, 0x3a83ddbd83f52205u},
+    {0x9abe14cd44753b52u, 0xc4926a9672793543u},
+    {0xc16d9a0095928a27u, 0x75b7053c0f178294u},
+    {0xf1c90080baf72cb1u, 0x5324c68b12dd6339u},
+    {0x971da05074da7beeu, 0xd3f6fc16ebca5e04u},
+    {0xbce5086492111aeau, 0x88f4bb1ca6bcf585u},
+    {0xec1e4a7db69561a5u, 0x2b31e9e3d06c32e6u},
+    {0x9392ee8e921d5d07u, 0x3aff322e62439fd0u},
+    {0xb877aa3236a4b449u, 0x09befeb9fad487c3u},
+    {0xe69594bec44de15bu, 0x4c2ebe687989a9b4u},
+    {0x901d7cf73ab0acd9u, 0x0f9d37014bf60a11u},
+    {0xb424dc35095cd80fu, 0x538484c19ef38c95u},
+    {0xe12e13424bb40e13u, 0x2865a5f206b06fbau},
+    {0x8cbccc096f5088cbu, 0xf93f87b7442e45d4u},
+    {0xafebff0bcb24aafeu, 0xf78f69a51539d749u},
+    {0xdbe6fecebdedd5beu, 0xb573440e5a884d1cu},
+    {0x89705f4136b4a597u, 0x31680a88f8953031u},
+    {0xabcc77118461cefcu, 0xfdc20d2b36ba7c3eu},
+    {0xd6bf94d5e57a42bcu, 0x3d32907604691b4du},
+    {0x8637bd05af6c69b5u, 0xa63f9a49c2c1b110u},
+    {0xa7c5ac471b478423u, 0x0fcf80dc33721d54u},
+    {0xd1b71758e219652bu, 0xd3c36113404ea4a9u},
+    {0x83126e978d4fdf3bu, 0x645a1cac083126eau},
+    {0xa3d70a3d70a3d70au, 0x3d70a3d70a3d70a4u},
+    {0xccccccccccccccccu, 0xcccccccccccccccdu},
+    {0x8000000000000000u, 0x0000000000000000u},
+    {0xa000000000000000u, 0x0000000000000000u},
+    {0xc800000000000000u, 0x0000000000000000u},
+    {0xfa00000000000000u, 0x0000000000000000u},
+    {0x9c40000000000000u, 0x0000000000000000u},
+    {0xc350000000000000u, 0x0000000000000000u},
+    {0xf424000000000000u, 0x0000000000000000u},
+    {0x9896800000000000u, 0x0000000000000000u},
+    {0xbebc200000000000u, 0x0000000000000000u},
+    {0xee6b280000000000u, 0x0000000000000000u},
+    {0x9502f90000000000u, 0x0000000000000000u},
+    {0xba43b74000000000u, 0x0000000000000000u},
+    {0xe8d4a51000000000u, 0x0000000000000000u},
+    {0x9184e72a00000000u, 0x0000000000000000u},
+    {0xb5e620f480000000u, 0x0000000000000000u},
+    {0xe35fa931a0000000u, 0x0000000000000000u},
+    {0x8e1bc9bf04000000u, 0x0000000000000000u},
+    {0xb1a2bc2ec5000000u, 0x0000000000000000u},
+    {0xde0b6b3a76400000u, 0x0000000000000000u},
+    {0x8ac7230489e80000u, 0x0000000000000000u},
+    {0xad78ebc5ac620000u, 0x0000000000000000u},
+    {0xd8d726b7177a8000u, 0x0000000000000000u},
+    {0x878678326eac9000u, 0x0000000000000000u},
+    {0xa968163f0a57b400u, 0x0000000000000000u},
+    {0xd3c21bcecceda100u, 0x0000000000000000u},
+    {0x84595161401484a0u, 0x0000000000000000u},
+    {0xa56fa5b99019a5c8u, 0x0000000000000000u},
+    {0xcecb8f27f4200f3au, 0x0000000000000000u},
+    {0x813f3978f8940984u, 0x4000000000000000u},
+    {0xa18f07d736b90be5u, 0x5000000000000000u},
+    {0xc9f2c9cd04674edeu, 0xa400000000000000u},
+    {0xfc6f7c4045812296u, 0x4d00000000000000u},
+    {0x9dc5ada82b70b59du, 0xf020000000000000u},
+    {0xc5371912364ce305u, 0x6c28000000000000u},
+    {0xf684df56c3e01bc6u, 0xc732000000000000u},
+    {0x9a130b963a6c115cu, 0x3c7f400000000000u},
+    {0xc097ce7bc90715b3u, 0x4b9f100000000000u},
+    {0xf0bdc21abb48db20u, 0x1e86d40000000000u},
+    {0x96769950b50d88f4u, 0x1314448000000000u},
+    {0xbc143fa4e250eb31u, 0x17d955a000000000u},
+    {0xeb194f8e1ae525fdu, 0x5dcfab0800000000u},
+    {0x92efd1b8d0cf37beu, 0x5aa1cae500000000u},
+    {0xb7abc627050305adu, 0xf14a3d9e40000000u},
+    {0xe596b7b0c643c719u, 0x6d9ccd05d0000000u},
+    {0x8f7e32ce7bea5c6fu, 0xe4820023a2000000u},
+    {0xb35dbf821ae4f38bu, 0xdda2802c8a800000u},
+    {0xe0352f62a19e306eu, 0xd50b2037ad200000u},
+    {0x8c213d9da502de45u, 0x4526f422cc340000u},
+    {0xaf298d050e4395d6u, 0x9670b12b7f410000u},
+    {0xdaf3f04651d47b4cu, 0x3c0cdd765f114000u},
+    {0x88d8762bf324cd0fu, 0xa5880a69fb6ac800u},
+    {0xab0e93b6efee0053u, 0x8eea0d047a457a00u},
+    {0xd5d238a4abe98068u, 0x72a4904598d6d880u},
+    {0x85a36366eb71f041u, 0x47a6da2b7f864750u},
+    {0xa70c3c40a64e6c51u, 0x999090b65f67d924u},
+    {0xd0cf4b50cfe20765u, 0xfff4b4e3f741cf6du},
+    {0x82818f1281ed449fu, 0xbff8f10e7a8921a4u},
+    {0xa321f2d7226895c7u, 0xaff72d52192b6a0du},
+    {0xcbea6f8ceb02bb39u, 0x9bf4f8a69f764490u},
+    {0xfee50b7025c36a08u, 0x02f236d04753d5b4u},
+    {0x9f4f2726179a2245u, 0x01d762422c946590u},
+    {0xc722f0ef9d80aad6u, 0x424d3ad2b7b97ef5u},
+    {0xf8ebad2b84e0d58bu, 0xd2e0898765a7deb2u},
+    {0x9b934c3b330c8577u, 0x63cc55f49f88eb2fu},
+    {0xc2781f49ffcfa6d5u, 0x3cbf6b71c76b25fbu},
+    {0xf316271c7fc3908au, 0x8bef464e3945ef7au},
+    {0x97edd871cfda3a56u, 0x97758bf0e3cbb5acu},
+    {0xbde94e8e43d0c8ecu, 0x3d52eeed1cbea317u},
+    {0xed63a231d4c4fb27u, 0x4ca7aaa863ee4bddu},
+    {0x945e455f24fb1cf8u, 0x8fe8caa93e74ef6au},
+    {0xb975d6b6ee39e436u, 0xb3e2fd538e122b44u},
+    {0xe7d34c64a9c85d44u, 0x60dbbca87196b616u},
+    {0x90e40fbeea1d3a4au, 0xbc8955e946fe31cdu},
+    {0xb51d13aea4a488ddu, 0x6babab6398bdbe41u},
+    {0xe264589a4dcdab14u, 0xc696963c7eed2dd1u},
+    {0x8d7eb76070a08aecu, 0xfc1e1de5cf543ca2u},
+    {0xb0de65388cc8ada8u, 0x3b25a55f43294bcbu},
+    {0xdd15fe86affad912u, 0x49ef0eb713f39ebeu},
+    {0x8a2dbf142dfcc7abu, 0x6e3569326c784337u},
+    {0xacb92ed9397bf996u, 0x49c2c37f07965404u},
+    {0xd7e77a8f87daf7fbu, 0xdc33745ec97be906u},
+    {0x86f0ac99b4e8dafdu, 0x69a028bb3ded71a3u},
+    {0xa8acd7c0222311bcu, 0xc40832ea0d68ce0cu},
+    {0xd2d80db02aabd62bu, 0xf50a3fa490c30190u},
+    {0x83c7088e1aab65dbu, 0x792667c6da79e0fau},
+    {0xa4b8cab1a1563f52u, 0x577001b891185938u},
+    {0xcde6fd5e09abcf26u, 0xed4c0226b55e6f86u},
+    {0x80b05e5ac60b6178u, 0x544f8158315b05b4u},
+    {0xa0dc75f1778e39d6u, 0x696361ae3db1c721u},
+    {0xc913936dd571c84cu, 0x03bc3a19cd1e38e9u},
+    {0xfb5878494ace3a5fu, 0x04ab48a04065c723u},
+    {0x9d174b2dcec0e47bu, 0x62eb0d64283f9c76u},
+    {0xc45d1df942711d9au, 0x3ba5d0bd324f8394u},
+    {0xf5746577930d6500u, 0xca8f44ec7ee36479u},
+    {0x9968bf6abbe85f20u, 0x7e998b13cf4e1ecbu},
+    {0xbfc2ef456ae276e8u, 0x9e3fedd8c321a67eu},
+    {0xefb3ab16c59b14a2u, 0xc5cfe94ef3ea101eu},
+    {0x95d04aee3b80ece5u, 0xbba1f1d158724a12u},
+    {0xbb445da9ca61281fu, 0x2a8a6e45ae8edc97u},
+    {0xea1575143cf97226u, 0xf52d09d71a3293bdu},
+    {0x924d692ca61be758u, 0x593c2626705f9c56u},
+    {0xb6e0c377cfa2e12eu, 0x6f8b2fb00c77836cu},
+    {0xe498f455c38b997au, 0x0b6dfb9c0f956447u},
+    {0x8edf98b59a373fecu, 0x4724bd4189bd5eacu},
+    {0xb2977ee300c50fe7u, 0x58edec91ec2cb657u},
+    {0xdf3d5e9bc0f653e1u, 0x2f2967b66737e3edu},
+    {0x8b865b215899f46cu, 0xbd79e0d20082ee74u},
+    {0xae67f1e9aec07187u, 0xecd8590680a3aa11u},
+    {0xda01ee641a708de9u, 0xe80e6f4820cc9495u},
+    {0x884134fe908658b2u, 0x3109058d147fdcddu},
+    {0xaa51823e34a7eedeu, 0xbd4b46f0599fd415u},
+    {0xd4e5e2cdc1d1ea96u, 0x6c9e18ac7007c91au},
+    {0x850fadc09923329eu, 0x03e2cf6bc604ddb0u},
+    {0xa6539930bf6bff45u, 0x84db8346b786151cu},
+    {0xcfe87f7cef46ff16u, 0xe612641865679a63u},
+    {0x81f14fae158c5f6eu, 0x4fcb7e8f3f60c07eu},
+    {0xa26da3999aef7749u, 0xe3be5e330f38f09du},
+    {0xcb090c8001ab551cu, 0x5cadf5bfd3072cc5u},
+    {0xfdcb4fa002162a63u, 0x73d9732fc7c8f7f6u},
+    {0x9e9f11c4014dda7eu, 0x2867e7fddcdd9afau},
+    {0xc646d63501a1511du, 0xb281e1fd541501b8u},
+    {0xf7d88bc24209a565u, 0x1f225a7ca91a4226u},
+    {0x9ae757596946075fu, 0x3375788de9b06958u},
+    {0xc1a12d2fc3978937u, 0x0052d6b1641c83aeu},
+    {0xf209787bb47d6b84u, 0xc0678c5dbd23a49au},
+    {0x9745eb4d50ce6332u, 0xf840b7ba963646e0u},
+    {0xbd176620a501fbffu, 0xb650e5a93bc3d898u},
+    {0xec5d3fa8ce427affu, 0xa3e51f138ab4cebeu},
+    {0x93ba47c980e98cdfu, 0xc66f336c36b10137u},
+    {0xb8a8d9bbe123f017u, 0xb80b0047445d4184u},
+    {0xe6d3102ad96cec1du, 0xa60dc059157491e5u},
+    {0x9043ea1ac7e41392u, 0x87c89837ad68db2fu},
+    {0xb454e4a179dd1877u, 0x29babe4598c311fbu},
+    {0xe16a1dc9d8545e94u, 0xf4296dd6fef3d67au},
+    {0x8ce2529e2734bb1du, 0x1899e4a65f58660cu},
+    {0xb01ae745b101e9e4u, 0x5ec05dcff72e7f8fu},
+    {0xdc21a1171d42645du, 0x76707543f4fa1f73u},
+    {0x899504ae72497ebau, 0x6a06494a791c53a8u},
+    {0xabfa45da0edbde69u, 0x0487db9d17636892u},
+    {0xd6f8d7509292d603u, 0x45a9d2845d3c42b6u},
+    {0x865b86925b9bc5c2u, 0x0b8a2392ba45a9b2u},
+    {0xa7f26836f282b732u, 0x8e6cac7768d7141eu},
+    {0xd1ef0244af2364ffu, 0x3207d795430cd926u},
+    {0x8335616aed761f1fu, 0x7f44e6bd49e807b8u},
+    {0xa402b9c5a8d3a6e7u, 0x5f16206c9c6209a6u},
+    {0xcd036837130890a1u, 0x36dba887c37a8c0fu},
+    {0x802221226be55a64u, 0xc2494954da2c9789u},
+    {0xa02aa96b06deb0fdu, 0xf2db9baa10b7bd6cu},
+    {0xc83553c5c8965d3du, 0x6f92829494e5acc7u},
+    {0xfa42a8b73abbf48cu, 0xcb772339ba1f17f9u},
+    {0x9c69a97284b578d7u, 0xff2a760414536efbu},
+    {0xc38413cf25e2d70du, 0xfef5138519684abau},
+    {0xf46518c2ef5b8cd1u, 0x7eb258665fc25d69u},
+    {0x98bf2f79d5993802u, 0xef2f773ffbd97a61u},
+    {0xbeeefb584aff8603u, 0xaafb550ffacfd8fau},
+    {0xeeaaba2e5dbf6784u, 0x95ba2a53f983cf38u},
+    {0x952ab45cfa97a0b2u, 0xdd945a747bf26183u},
+    {0xba756174393d88dfu, 0x94f971119aeef9e4u},
+    {0xe912b9d1478ceb17u, 0x7a37cd5601aab85du},
+    {0x91abb422ccb812eeu, 0xac62e055c10ab33au},
+    {0xb616a12b7fe617aau, 0x577b986b314d6009u},
+    {0xe39c49765fdf9d94u, 0xed5a7e85fda0b80bu},
+    {0x8e41ade9fbebc27du, 0x14588f13be847307u},
+    {0xb1d219647ae6b31cu, 0x596eb2d8ae258fc8u},
+    {0xde469fbd99a05fe3u, 0x6fca5f8ed9aef3bbu},
+    {0x8aec23d680043beeu, 0x25de7bb9480d5854u},
+    {0xada72ccc20054ae9u, 0xaf561aa79a10ae6au},
+    {0xd910f7ff28069da4u, 0x1b2ba1518094da04u},
+    {0x87aa9aff79042286u, 0x90fb44d2f05d0842u},
+    {0xa99541bf57452b28u, 0x353a1607ac744a53u},
+    {0xd3fa922f2d1675f2u, 0x42889b8997915ce8u},
+    {0x847c9b5d7c2e09b7u, 0x69956135febada11u},
+    {0xa59bc234db398c25u, 0x43fab9837e699095u},
+    {0xcf02b2c21207ef2eu, 0x94f967e45e03f4bbu},
+    {0x8161afb94b44f57du, 0x1d1be0eebac278f5u},
+    {0xa1ba1ba79e1632dcu, 0x6462d92a69731732u},
+    {0xca28a291859bbf93u, 0x7d7b8f7503cfdcfeu},
+    {0xfcb2cb35e702af78u, 0x5cda735244c3d43eu},
+    {0x9defbf01b061adabu, 0x3a0888136afa64a7u},
+    {0xc56baec21c7a1916u, 0x088aaa1845b8fdd0u},
+    {0xf6c69a72a3989f5bu, 0x8aad549e57273d45u},
+    {0x9a3c2087a63f6399u, 0x36ac54e2f678864bu},
+    {0xc0cb28a98fcf3c7fu, 0x84576a1bb416a7ddu},
+    {0xf0fdf2d3f3c30b9fu, 0x656d44a2a11c51d5u},
+    {0x969eb7c47859e743u, 0x9f644ae5a4b1b325u},
+    {0xbc4665b596706114u, 0x873d5d9f0dde1feeu},
+    {0xeb57ff22fc0c7959u, 0xa90cb506d155a7eau},
+    {0x9316ff75dd87cbd8u, 0x09a7f12442d588f2u},
+    {0xb7dcbf5354e9beceu, 0x0c11ed6d538aeb2fu},
+    {0xe5d3ef282a242e81u, 0x8f1668c8a86da5fau},
+    {0x8fa475791a569d10u, 0xf96e017d694487bcu},
+    {0xb38d92d760ec4455u, 0x37c981dcc395a9acu},
+    {0xe070f78d3927556au, 0x85bbe253f47b1417u},
+    {0x8c469ab843b89562u, 0x93956d7478ccec8eu},
+    {0xaf58416654a6babbu, 0x387ac8d1970027b2u},
+    {0xdb2e51bfe9d0696au, 0x06997b05fcc0319eu},
+    {0x88fcf317f22241e2u, 0x441fece3bdf81f03u},
+    {0xab3c2fddeeaad25au, 0xd527e81cad7626c3u},
+    {0xd60b3bd56a5586f1u, 0x8a71e223d8d3b074u},
+    {0x85c7056562757456u, 0xf6872d5667844e49u},
+    {0xa738c6bebb12d16cu, 0xb428f8ac016561dbu},
+    {0xd106f86e69d785c7u, 0xe13336d701beba52u},
+    {0x82a45b450226b39cu, 0xecc0024661173473u},
+    {0xa34d721642b06084u, 0x27f002d7f95d0190u},
+    {0xcc20ce9bd35c78a5u, 0x31ec038df7b441f4u},
+    {0xff290242c83396ceu, 0x7e67047175a15271u},
+    {0x9f79a169bd203e41u, 0x0f0062c6e984d386u},
+    {0xc75809c42c684dd1u, 0x52c07b78a3e60868u},
+    {0xf92e0c3537826145u, 0xa7709a56ccdf8a82u},
+    {0x9bbcc7a142b17ccbu, 0x88a66076400bb691u},
+    {0xc2abf989935ddbfeu, 0x6acff893d00ea435u},
+    {0xf356f7ebf83552feu, 0x0583f6b8c4124d43u},
+    {0x98165af37b2153deu, 0xc3727a337a8b704au},
+    {0xbe1bf1b059e9a8d6u, 0x744f18c0592e4c5cu},
+    {0xeda2ee1c7064130cu, 0x1162def06f79df73u},
+    {0x9485d4d1c63e8be7u, 0x8addcb5645ac2ba8u},
+    {0xb9a74a0637ce2ee1u, 0x6d953e2bd7173692u},
+    {0xe8111c87c5c1ba99u, 0xc8fa8db6ccdd0437u},
+    {0x910ab1d4db9914a0u, 0x1d9c9892400a22a2u},
+    {0xb54d5e4a127f59c8u, 0x2503beb6d00cab4bu},
+    {0xe2a0b5dc971f303au, 0x2e44ae64840fd61du},
+    {0x8da471a9de737e24u, 0x5ceaecfed289e5d2u},
+    {0xb10d8e1456105dadu, 0x7425a83e872c5f47u},
+    {0xdd50f1996b947518u, 0xd12f124e28f77719u},
+    {0x8a5296ffe33cc92fu, 0x82bd6b70d99aaa6fu},
+    {0xace73cbfdc0bfb7bu, 0x636cc64d1001550bu},
+    {0xd8210befd30efa5au, 0x3c47f7e05401aa4eu},
+    {0x8714a775e3e95c78u, 0x65acfaec34810a71u},
+    {0xa8d9d1535ce3b396u, 0x7f1839a741a14d0du},
+    {0xd31045a8341ca07cu, 0x1ede48111209a050u},
+    {0x83ea2b892091e44du, 0x934aed0aab460432u},
+    {0xa4e4b66b68b65d60u, 0xf81da84d5617853fu},
+    {0xce1de40642e3f4b9u, 0x36251260ab9d668eu},
+    {0x80d2ae83e9ce78f3u, 0xc1d72b7c6b426019u},
+    {0xa1075a24e4421730u, 0xb24cf65b8612f81fu},
+    {0xc94930ae1d529cfcu, 0xdee033f26797b627u},
+    {0xfb9b7cd9a4a7443cu, 0x169840ef017da3b1u},
+    {0x9d412e0806e88aa5u, 0x8e1f289560ee864eu},
+    {0xc491798a08a2ad4eu, 0xf1a6f2bab92a27e2u},
+    {0xf5b5d7ec8acb58a2u, 0xae10af696774b1dbu},
+    {0x9991a6f3d6bf1765u, 0xacca6da1e0a8ef29u},
+    {0xbff610b0cc6edd3fu, 0x17fd090a58d32af3u},
+    {0xeff394dcff8a948eu, 0xddfc4b4cef07f5b0u},
+    {0x95f83d0a1fb69cd9u, 0x4abdaf101564f98eu},
+    {0xbb764c4ca7a4440fu, 0x9d6d1ad41abe37f1u},
+    {0xea53df5fd18d5513u, 0x84c86189216dc5edu},
+    {0x92746b9be2f8552cu, 0x32fd3cf5b4e49bb4u},
+    {0xb7118682dbb66a77u, 0x3fbc8c33221dc2a1u},
+    {0xe4d5e82392a40515u, 0x0fabaf3feaa5334au},
+    {0x8f05b1163ba6832du, 0x29cb4d87f2a7400eu},
+    {0xb2c71d5bca9023f8u, 0x743e20e9ef511012u},
+    {0xdf78e4b2bd342cf6u, 0x914da9246b255416u},
+    {0x8bab8eefb6409c1au, 0x1ad089b6c2f7548eu},
+    {0xae9672aba3d0c320u, 0xa184ac2473b529b1u},
+    {0xda3c0f568cc4f3e8u, 0xc9e5d72d90a2741eu},
+    {0x8865899617fb1871u, 0x7e2fa67c7a658892u},
+    {0xaa7eebfb9df9de8du, 0xddbb901b98feeab7u},
+    {0xd51ea6fa85785631u, 0x552a74227f3ea565u},
+    {0x8533285c936b35deu, 0xd53a88958f87275fu},
+    {0xa67ff273b8460356u, 0x8a892abaf368f137u},
+    {0xd01fef10a657842cu, 0x2d2b7569b0432d85u},
+    {0x8213f56a67f6b29bu, 0x9c3b29620e29fc73u},
+    {0xa298f2c501f45f42u, 0x8349f3ba91b47b8fu},
+    {0xcb3f2f7642717713u, 0x241c70a936219a73u},
+    {0xfe0efb53d30dd4d7u, 0xed238cd383aa0110u},
+    {0x9ec95d1463e8a506u, 0xf4363804324a40aau},
+    {0xc67bb4597ce2ce48u, 0xb143c6053edcd0d5u},
+    {0xf81aa16fdc1b81dau, 0xdd94b7868e94050au},
+    {0x9b10a4e5e9913128u, 0xca7cf2b4191c8326u},
+    {0xc1d4ce1f63f57d72u, 0xfd1c2f611f63a3f0u},
+    {0xf24a01a73cf2dccfu, 0xbc633b39673c8cecu},
+    {0x976e41088617ca01u, 0xd5be0503e085d813u},
+    {0xbd49d14aa79dbc82u, 0x4b2d8644d8a74e18u},
+    {0xec9c459d51852ba2u, 0xddf8e7d60ed1219eu},
+    {0x93e1ab8252f33b45u, 0xcabb90e5c942b503u},
+    {0xb8da1662e7b00a17u, 0x3d6a751f3b936243u},
+    {0xe7109bfba19c0c9du, 0x0cc512670a783ad4u},
+    {0x906a617d450187e2u, 0x27fb2b80668b24c5u},
+    {0xb484f9dc9641e9dau, 0xb1f9f660802dedf6u},
+    {0xe1a63853bbd26451u, 0x5e7873f8a0396973u},
+    {0x8d07e33455637eb2u, 0xdb0b487b6423e1e8u},
+    {0xb049dc016abc5e5fu, 0x91ce1a9a3d2cda62u},
+    {0xdc5c5301c56b75f7u, 0x7641a140cc7810fbu},
+    {0x89b9b3e11b6329bau, 0xa9e904c87fcb0a9du},
+    {0xac2820d9623bf429u, 0x546345fa9fbdcd44u},
+    {0xd732290fbacaf133u, 0xa97c177947ad4095u},
+    {0x867f59a9d4bed6c0u, 0x49ed8eabcccc485du},
+    {0xa81f301449ee8c70u, 0x5c68f256bfff5a74u},
+    {0xd226fc195c6a2f8cu, 0x73832eec6fff3111u},
+    {0x83585d8fd9c25db7u, 0xc831fd53c5ff7eabu},
+    {0xa42e74f3d032f525u, 0xba3e7ca8b77f5e55u},
+    {0xcd3a1230c43fb26fu, 0x28ce1bd2e55f35ebu},
+    {0x80444b5e7aa7cf85u, 0x7980d163cf5b81b3u},
+    {0xa0555e361951c366u, 0xd7e105bcc332621fu},
+    {0xc86ab5c39fa63440u, 0x8dd9472bf3fefaa7u},
+    {0xfa856334878fc150u, 0xb14f98f6f0feb951u},
+    {0x9c935e00d4b9d8d2u, 0x6ed1bf9a569f33d3u},
+    {0xc3b8358109e84f07u, 0x0a862f80ec4700c8u},
+    {0xf4a642e14c6262c8u, 0xcd27bb612758c0fau},
+    {0x98e7e9cccfbd7dbdu, 0x8038d51cb897789cu},
+    {0xbf21e44003acdd2cu, 0xe0470a63e6bd56c3u},
+    {0xeeea5d5004981478u, 0x1858ccfce06cac74u},
+    {0x95527a5202df0ccbu, 0x0f37801e0c43ebc8u},
+    {0xbaa718e68396cffdu, 0xd30560258f54e6bau},
+    {0xe950df20247c83fdu, 0x47c6b82ef32a2069u},
+    {0x91d28b7416cdd27eu, 0x4cdc331d57fa5441u},
+    {0xb6472e511c81471du, 0xe0133fe4adf8e952u},
+    {0xe3d8f9e563a198e5u, 0x58180fddd97723a6u},
+    {0x8e679c2f5e44ff8fu, 0x570f09eaa7ea7648u}
+};
+
+/**
+ * @file
+ *
+ * Conversion of many command line words to numbers at once. It is used
+ * internally by `ArgumentParser` when a variadic `DT_INT` or `DT_DOUBLE`
+ * positional receives a run of words. Users of the library never need to
+ * call these functions directly.
+ *
+ * On x86 processors, digit runs are validated and converted using SSE4.1 or
+ * AVX2 kernels, which are chosen at runtime. Each kernel handles short plain
+ * decimal words (an optional sign, at most 15 digits and a decimal point, and
+ * for doubles an exponent). Every other word, and every word on other
+ * processors, is converted by the scalar functions in `number_parsing.h`, so
+ * the results are always identical. The kernels load 16 bytes at a time, so
+ * they only handle words with at least 16 readable bytes before the known end
+ * of the buffer holding them: the words of response files, command strings
+ * and positional input. Other words, including those of `argv`, are converted
+ * by the scalar functions. Defining `CAP_DISABLE_SIMD` before including the
+ * library disables the kernels.
+ */
+
+#if !defined(CAP_DISABLE_SIMD) && defined(__GNUC__) \
+        && (defined(__x86_64__) || defined(__i386__))
+#define _CAP_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+// ============================================================================
+// === BATCH NUMBER PARSING ===================================================
+// ============================================================================
+
+/**
+ * Instruction set used to convert batches of words.
+ */
+typedef enum {
+    _CAP_SIMD_NONE,
+    _CAP_SIMD_SSE41,
+    _CAP_SIMD_AVX2
+} _CapSimdLevel;
+
+/// a run of decimal digits with an optional decimal point, read by a kernel
+typedef struct {
+    /// value of the digits, ignoring the point
+    uint64_t mDigits;
+    /// number of digits
+    int mDigitCount;
+    /// number of digits after the point
+    int mFractionDigits;
+    /// number of bytes of the run, including the point
+    int mLength;
+} _CapDigitRun;
+
+// ============================================================================
+// === BATCH NUMBER PARSING: DECLARATION OF PRIVATE FUNCTIONS =================
+// ============================================================================
+
+static _CapSimdLevel _cap_simd_level();
+static size_t _cap_parse_int_batch(
+    const char * const * words, size_t count, const char * limit,
+    int * values, WordConversionResult * result);
+static size_t _cap_parse_int_batch_with(
+    const char * const * words, size_t count, const char * limit,
+    int * values, WordConversionResult * result, _CapSimdLevel level);
+static size_t _cap_parse_double_batch(
+    const char * const * words, size_t count, const char * limit,
+    double * values, WordConversionResult * result);
+static size_t _cap_parse_double_batch_with(
+    const char * const * words, size_t count, const char * limit,
+    double * values, WordConversionResult * result, _CapSimdLevel level);
+
+static const char * _cap_batch_number_start(
+    const char * word, bool allow_point, bool * negative);
+static WordConversionResult _cap_finish_int(
+    const char * word, const char * start, const _CapDigitRun * run,
+    bool negative, int * value);
+static WordConversionResult _cap_finish_double(
+    const char * word, const char * start, const _CapDigitRun * run,
+    bool negative, double * value);
+static bool _cap_digit_run_layout(
+    unsigned int digit_mask, unsigned int point_mask, _CapDigitRun * run);
+
+#if defined(_CAP_X86_SIMD)
+static int _cap_point_skip_offset(const _CapDigitRun * run);
+static bool _cap_can_load_16(const char * c, const char * limit);
+static bool _cap_scan_digit_run_sse41(
+    const char * c, bool allow_point, const char * limit, _CapDigitRun * run);
+static unsigned int _cap_scan_digit_runs_avx2(
+    const char * const * c, bool allow_point, const char * limit,
+    _CapDigitRun * runs);
+#endif
+
+// ============================================================================
+// === BATCH NUMBER PARSING: IMPLEMENTATION OF PRIVATE FUNCTIONS ==============
+// ============================================================================
+
+static _CapSimdLevel _cap_simd_level() {
+    // the best instruction set supported by the processor
+#if defined(_CAP_X86_SIMD)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return _CAP_SIMD_AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return _CAP_SIMD_SSE41;
+    }
+#endif
+    return _CAP_SIMD_NONE;
+}
+
+static size_t _cap_parse_int_batch(
+        const char * const * words, size_t count, const char * limit,
+        int * values, WordConversionResult * result) {
+    // converts `words` into `values` and returns the number of converted
+    // words. If it is less than `count`, `*result` tells why the next word
+    // could not be converted. Every word must lie in a buffer which is
+    // readable up to `limit`, which is `NULL` if its end is not known.
+    return _cap_parse_int_batch_with(
+        words, count, limit, values, result, _cap_simd_level());
+}
+
+static size_t _cap_parse_int_batch_with(
+        const char * const * words, size_t count, const char * limit,
+        int * values, WordConversionResult * result, _CapSimdLevel level) {
+    *result = WCR_OK;
+    size_t i = 0u;
+#if defined(_CAP_X86_SIMD)
+    for (; level >= _CAP_SIMD_AVX2 && i + 1u < count; i += 2u) {
+        const char * starts[2];
+        bool negative[2];
+        _CapDigitRun runs[2];
+        starts[0] = _cap_batch_number_start(words[i], false, negative);
+        starts[1] = _cap_batch_number_start(words[i + 1u], false, negative + 1);
+        const unsigned int handled = starts[0] && starts[1]
+            ? _cap_scan_digit_runs_avx2(starts, false, limit, runs)
+            : 0u;
+        for (size_t k = 0u; k < 2u; ++k) {
+            *result = handled & (1u << k)
+                ? _cap_finish_int(
+                    words[i + k], starts[k], runs + k, negative[k],
+                    values + i + k)
+                : _cap_parse_int(words[i + k], values + i + k);
+            if (*result != WCR_OK) {
+                return i + k;
+            }
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+#if defined(_CAP_X86_SIMD)
+        bool negative;
+        _CapDigitRun run;
+        const char * start = level >= _CAP_SIMD_SSE41
+            ? _cap_batch_number_start(words[i], false, &negative)
+            : NULL;
+        if (start && _cap_scan_digit_run_sse41(start, false, limit, &run)) {
+            *result = _cap_finish_int(
+                words[i], start, &run, negative, values + i);
+        } else {
+            *result = _cap_parse_int(words[i], values + i);
+        }
+#else
+        (void) level;
+        *result = _cap_parse_int(words[i], values + i);
+#endif
+        if (*result != WCR_OK) {
+            return i;
+        }
+    }
+    return count;
+}
+
+static size_t _cap_parse_double_batch(
+        const char * const * words, size_t count, const char * limit,
+        double * values, WordConversionResult * result) {
+    // the same as `_cap_parse_int_batch`, for doubles
+    return _cap_parse_double_batch_with(
+        words, count, limit, values, result, _cap_simd_level());
+}
+
+static size_t _cap_parse_double_batch_with(
+        const char * const * words, size_t count, const char * limit,
+        double * values, WordConversionResult * result, _CapSimdLevel level) {
+    *result = WCR_OK;
+    size_t i = 0u;
+#if defined(_CAP_X86_SIMD)
+    for (; level >= _CAP_SIMD_AVX2 && i + 1u < count; i += 2u) {
+        const char * starts[2];
+        bool negative[2];
+        _CapDigitRun runs[2];
+        starts[0] = _cap_batch_number_start(words[i], true, negative);
+        starts[1] = _cap_batch_number_start(words[i + 1u], true, negative + 1);
+        const unsigned int handled = starts[0] && starts[1]
+            ? _cap_scan_digit_runs_avx2(starts, true, limit, runs)
+            : 0u;
+        for (size_t k = 0u; k < 2u; ++k) {
+            *result = handled & (1u << k)
+                ? _cap_finish_double(
+                    words[i + k], starts[k], runs + k, negative[k],
+                    values + i + k)
+                : _cap_parse_double(words[i + k], values + i + k);
+            if (*result != WCR_OK) {
+                return i + k;
+            }
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+#if defined(_CAP_X86_SIMD)
+        bool negative;
+        _CapDigitRun run;
+        const char * start = level >= _CAP_SIMD_SSE41
+            ? _cap_batch_number_start(words[i], true, &negative)
+            : NULL;
+        if (start && _cap_scan_digit_run_sse41(start, true, limit, &run)) {
+            *result = _cap_finish_double(
+                words[i], start, &run, negative, values + i);
+        } else {
+            *result = _cap_parse_double(words[i], values + i);
+        }
+#else
+        (void) level;
+        *result = _cap_parse_double(words[i], values + i);
+#endif
+        if (*result != WCR_OK) {
+            return i;
+        }
+    }
+    return count;
+}
+
+static const char * _cap_batch_number_start(
+        const char * word, bool allow_point, bool * negative) {
+    // skips the sign of a word which a kernel can handle, returns `NULL` for
+    // other words. Integers starting with `0` may be octal or hexadecimal.
+    *negative = *word == '-';
+    if (*word == '-' || *word == '+') {
+        ++word;
+    }
+    if (allow_point) {
+        return (*word >= '0' && *word <= '9') || *word == '.' ? word : NULL;
+    }
+    return *word >= '1' && *word <= '9' ? word : NULL;
+}
+
+static WordConversionResult _cap_finish_int(
+        const char * word, const char * start, const _CapDigitRun * run,
+        bool negative, int * value) {
+    // the run must make up the rest of the word
+    if (start[run -> mLength]) {
+        return _cap_parse_int(word, value);
+    }
+    const uint64_t limit = negative
+        ? (uint64_t) INT_MAX + 1u
+        : (uint64_t) INT_MAX;
+    if (run -> mDigits > limit) {
+        return WCR_OUT_OF_RANGE;
+    }
+    *value = negative
+        ? (int) -(long long int) run -> mDigits
+        : (int) run -> mDigits;
+    return WCR_OK;
+}
+
+static WordConversionResult _cap_finish_double(
+        const char * word, const char * start, const _CapDigitRun * run,
+        bool negative, double * value) {
+    // the run may be followed by an exponent, which is read here
+    const char * c = start + run -> mLength;
+    int64_t exponent = 0;
+    if ((*c | 0x20) == 'e') {
+        ++c;
+        const bool negative_exponent = *c == '-';
+        if (*c == '-' || *c == '+') {
+            ++c;
+        }
+        // larger exponents lead to zero or infinity anyway
+        static const int64_t MAX_EXPONENT = 100000;
+        const char * first = c;
+        for (; *c >= '0' && *c <= '9'; ++c) {
+            if (exponent < MAX_EXPONENT) {
+                exponent = exponent * 10 + (*c - '0');
+            }
+        }
+        if (c == first) {
+            return _cap_parse_double(word, value);
+        }
+        exponent = negative_exponent ? -exponent : exponent;
+    }
+    if (*c) {
+        return _cap_parse_double(word, value);
+    }
+    const _CapDecimal decimal = {
+        .mSignificand = run -> mDigits,
+        .mExponent = exponent - run -> mFractionDigits,
+        .mTruncated = false
+    };
+    WordConversionResult result;
+    _cap_decimal_to_double(&decimal, negative, value, &result);
+    return result;
+}
+
+static bool _cap_digit_run_layout(
+        unsigned int digit_mask, unsigned int point_mask, _CapDigitRun * run) {
+    // finds the run of digits with at most one point at the start of a block
+    // of 16 bytes, given bit masks of the bytes which are digits and points.
+    // Returns `false` if the run is empty, or does not end within the block.
+    const unsigned int first_point = point_mask & (0u - point_mask);
+    const unsigned int end_mask = ~(digit_mask | first_point) & 0xFFFFu;
+    if (!end_mask) {
+        return false;
+    }
+    const int length = __builtin_ctz(end_mask);
+    const bool has_point = first_point && first_point < (1u << length);
+    run -> mLength = length;
+    run -> mDigitCount = length - has_point;
+    run -> mFractionDigits = has_point
+        ? length - 1 - __builtin_ctz(first_point)
+        : 0;
+    return run -> mDigitCount > 0;
+}
+
+#if defined(_CAP_X86_SIMD)
+
+/**
+ * Shuffle indices which move `n` digits to the end of a register, loaded from
+ * offset `n`. The indices of unused bytes are negative, so they become zero.
+ */
+static const signed char _CAP_DIGIT_SHUFFLE[32] = {
+    -16, -15, -14, -13, -12, -11, -10, -9, -8, -7, -6, -5, -4, -3, -2, -1,
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15
+};
+
+/**
+ * Subtracted from the shuffle indices of digits after the point, so that they
+ * skip it, loaded from the offset given by `_cap_point_skip_offset`.
+ */
+static const signed char _CAP_POINT_SKIP[32] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+static int _cap_point_skip_offset(const _CapDigitRun * run) {
+    // the last `mFractionDigits` bytes of the register hold digits after the
+    // point
+    return run -> mFractionDigits;
+}
+
+static bool _cap_can_load_16(const char * c, const char * limit) {
+    // 16 bytes can be loaded without reading past the end of the buffer
+    return limit && limit - c >= 16;
+}
+
+__attribute__((target("sse4.1")))
+static bool _cap_scan_digit_run_sse41(
+        const char * c, bool allow_point, const char * limit,
+        _CapDigitRun * run) {
+    if (!_cap_can_load_16(c, limit)) {
+        return false;
+    }
+    const __m128i chars = _mm_loadu_si128((const __m128i *) c);
+    const __m128i digits = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    const __m128i is_digit = _mm_cmpeq_epi8(
+        _mm_min_epu8(digits, _mm_set1_epi8(9)), digits);
+    const unsigned int point_mask = allow_point
+        ? (unsigned int) _mm_movemask_epi8(
+            _mm_cmpeq_epi8(chars, _mm_set1_epi8('.')))
+        : 0u;
+    if (!_cap_digit_run_layout(
+            (unsigned int) _mm_movemask_epi8(is_digit), point_mask, run)) {
+        return false;
+    }
+    // move the digits to the end of the register, skipping the point
+    const __m128i indices = _mm_sub_epi8(
+        _mm_loadu_si128(
+            (const __m128i *) (_CAP_DIGIT_SHUFFLE + run -> mDigitCount)),
+        _mm_loadu_si128(
+            (const __m128i *) (_CAP_POINT_SKIP + _cap_point_skip_offset(run))));
+    const __m128i aligned = _mm_shuffle_epi8(digits, indices);
+    // combine 2, 4 and 8 digits
+    const __m128i pairs = _mm_maddubs_epi16(
+        aligned,
+        _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+    const __m128i quads = _mm_madd_epi16(
+        pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+    const __m128i octets = _mm_madd_epi16(
+        _mm_packus_epi32(quads, quads),
+        _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+    run -> mDigits = (uint64_t) (uint32_t) _mm_cvtsi128_si32(octets)
+        * 100000000u + (uint32_t) _mm_extract_epi32(octets, 1);
+    return true;
+}
+
+__attribute__((target("avx2")))
+static unsigned int _cap_scan_digit_runs_avx2(
+        const char * const * c, bool allow_point, const char * limit,
+        _CapDigitRun * runs) {
+    // the same as `_cap_scan_digit_run_sse41` for two words at once, one in
+    // each 128-bit lane. Returns a bit mask of the words which were handled.
+    if (!_cap_can_load_16(c[0], limit) || !_cap_can_load_16(c[1], limit)) {
+        return 0u;
+    }
+    const __m256i chars = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *) c[0])),
+        _mm_loadu_si128((const __m128i *) c[1]), 1);
+    const __m256i digits = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));
+    const __m256i is_digit = _mm256_cmpeq_epi8(
+        _mm256_min_epu8(digits, _mm256_set1_epi8(9)), digits);
+    const unsigned int digit_mask
+        = (unsigned int) _mm256_movemask_epi8(is_digit);
+    const unsigned int point_mask = allow_point
+        ? (unsigned int) _mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('.')))
+        : 0u;
+    unsigned int handled = 0u;
+    for (int k = 0; k < 2; ++k) {
+        if (_cap_digit_run_layout(
+                (digit_mask >> (16 * k)) & 0xFFFFu,
+                (point_mask >> (16 * k)) & 0xFFFFu, runs + k)) {
+            handled |= 1u << k;
+        }
+    }
+    if (!handled) {
+        return 0u;
+    }
+    // a lane which was not handled uses the indices of an empty run
+    const int counts[2] = {
+        handled & 1u ? runs[0].mDigitCount : 0,
+        handled & 2u ? runs[1].mDigitCount : 0
+    };
+    const int skips[2] = {
+        handled & 1u ? _cap_point_skip_offset(runs) : 0,
+        handled & 2u ? _cap_point_skip_offset(runs + 1) : 0
+    };
+    const __m256i indices = _mm256_sub_epi8(
+        _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128(
+                (const __m128i *) (_CAP_DIGIT_SHUFFLE + counts[0]))),
+            _mm_loadu_si128((const __m128i *) (_CAP_DIGIT_SHUFFLE + counts[1])),
+            1),
+        _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128(
+                (const __m128i *) (_CAP_POINT_SKIP + skips[0]))),
+            _mm_loadu_si128((const __m128i *) (_CAP_POINT_SKIP + skips[1])),
+            1));
+    const __m256i aligned = _mm256_shuffle_epi8(digits, indices);
+    const __m256i pairs = _mm256_maddubs_epi16(
+        aligned, _mm256_set1_epi16(0x010A));
+    const __m256i quads = _mm256_madd_epi16(
+        pairs, _mm256_set1_epi32(0x00010064));
+    const __m256i octets = _mm256_madd_epi16(
+        _mm256_packus_epi32(quads, quads), _mm256_set1_epi32(0x00012710));
+    const __m128i lanes[2] = {
+        _mm256_castsi256_si128(octets),
+        _mm256_extracti128_si256(octets, 1)
+    };
+    for (int k = 0; k < 2; ++k) {
+        runs[k].mDigits = (uint64_t) (uint32_t) _mm_cvtsi128_si32(lanes[k])
+            * 100000000u + (uint32_t) _mm_extract_epi32(lanes[k], 1);
+    }
+    return handled;
+}
+
+#endif
+
+/**
+ * @file
+ *
+ * Conversion of very long runs of numeric words on several threads. It is
+ * used internally by `ArgumentParser` if `cap_parser_set_thread_count` allows
+ * more than one thread. A run is cut into contiguous slices, which are
+ * converted by the functions of `batch_number_parsing.h` into disjoint parts
+ * of the same array, so the values are identical to converting the run on
+ * a single thread.
+ *
+ * Threads are started for each run and joined before it is stored. Threads
+ * are only used if the macro `CAP_ENABLE_THREADS` is defined before the 
+ * library is included, on POSIX systems. Programs doing that must be linked
+ * with `-pthread`. Otherwise, runs are always converted on the calling thread
+ * and the library does not depend on pthreads at all.
+ */
+
+#if defined(CAP_ENABLE_THREADS) && (defined(__unix__) || defined(__APPLE__))
+#define _CAP_THREADS 1
+#include <pthread.h>
+#endif
+
+/// smallest number of words converted by one thread
+#define _CAP_PARALLEL_MIN_WORDS ((size_t) 16384)
+
+// ============================================================================
+// === PARALLEL NUMBER PARSING ================================================
+// ============================================================================
+
+/**
+ * A contiguous part of a run of words, converted by one thread.
+ */
+typedef struct {
+    const char * const * mWords;
+    size_t mCount;
+    /// end of the buffer holding the words, `NULL` if it is not known
+    const char * mLimit;
+    /// DT_INT or DT_DOUBLE
+    DataType mType;
+    /// array of `int` or `double` receiving the values
+    void * mValues;
+    _CapSimdLevel mLevel;
+    /// number of converted words, and why the next one was not converted
+    size_t mConverted;
+    WordConversionResult mResult;
+} _CapConversionSlice;
+
+// ============================================================================
+// === PARALLEL NUMBER PARSING: DECLARATION OF PRIVATE FUNCTIONS ==============
+// ============================================================================
+
+static size_t _cap_parse_number_batch_parallel(
+    const char * const * words, size_t count, const char * limit,
+    DataType type, void * values, size_t thread_count,
+    WordConversionResult * result);
+static void * _cap_convert_slice(void * slice);
+
+// ============================================================================
+// === PARALLEL NUMBER PARSING: IMPLEMENTATION OF PRIVATE FUNCTIONS ===========
+// ============================================================================
+
+static size_t _cap_parse_number_batch_parallel(
+        const char * const * words, size_t count, const char * limit,
+        DataType type, void * values, size_t thread_count,
+        WordConversionResult * result) {
+    // converts `words` of type DT_INT or DT_DOUBLE into `values` using up to
+    // `thread_count` threads (including the calling one), and returns the
+    // number of converted words like `_cap_parse_int_batch`
+    size_t slice_count = count / _CAP_PARALLEL_MIN_WORDS;
+    slice_count = slice_count < thread_count ? slice_count : thread_count;
+#if !defined(_CAP_THREADS)
+    slice_count = 1u;
+#endif
+    slice_count = slice_count ? slice_count : 1u;
+    const size_t value_size = type == DT_INT ? sizeof(int) : sizeof(double);
+    _CapConversionSlice * slices = (_CapConversionSlice *) cap_malloc(
+        slice_count * sizeof(_CapConversionSlice));
+    const _CapSimdLevel level = _cap_simd_level();
+    size_t start = 0u;
+    for (size_t i = 0u; i < slice_count; ++i) {
+        const size_t end = count / slice_count * (i + 1u)
+            + (i + 1u == slice_count ? count % slice_count : 0u);
+        slices[i] = (_CapConversionSlice) {
+            .mWords = words + start,
+            .mCount = end - start,
+            .mLimit = limit,
+            .mType = type,
+            .mValues = (char *) values + start * value_size,
+            .mLevel = level,
+            .mConverted = 0u,
+            .mResult = WCR_OK
+        };
+        start = end;
+    }
+#if defined(_CAP_THREADS)
+    // slice 0 is converted by the calling thread. If a thread cannot be
+    // started, its slice is converted by the calling thread as well.
+    pthread_t * threads = (pthread_t *) cap_malloc(
+        slice_count * sizeof(pthread_t));
+    bool * started = (bool *) cap_malloc(slice_count * sizeof(bool));
+    for (size_t i = 1u; i < slice_count; ++i) {
+        started[i] = pthread_create(
+            threads + i, NULL, _cap_convert_slice, slices + i) == 0;
+    }
+    _cap_convert_slice(slices);
+    for (size_t i = 1u; i < slice_count; ++i) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        }
+        else {
+            _cap_convert_slice(slices + i);
+        }
+    }
+    cap_free(started);
+    cap_free(threads);
+#else
+    _cap_convert_slice(slices);
+#endif
+    // the first word which cannot be converted ends the run
+    size_t converted = 0u;
+    *result = WCR_OK;
+    for (size_t i = 0u; i < slice_count; ++i) {
+        converted += slices[i].mConverted;
+        if (slices[i].mConverted < slices[i].mCount) {
+            *result = slices[i].mResult;
+            break;
+        }
+    }
+    cap_free(slices);
+    return converted;
+}
+
+static void * _cap_convert_slice(void * slice) {
+    _CapConversionSlice * s = (_CapConversionSlice *) slice;
+    s -> mConverted = s -> mType == DT_INT
+        ? _cap_parse_int_batch_with(
+            s -> mWords, s -> mCount, s -> mLimit, (int *) s -> mValues,
+            &(s -> mResult), s -> mLevel)
+        : _cap_parse_double_batch_with(
+            s -> mWords, s -> mCount, s -> mLimit, (double *) s -> mValues,
+            &(s -> mResult), s -> mLevel);
+    return NULL;
+}
+
+/** 
+ * @file 
+ * @defgroup parser Argument Parser, its Configuration, and Usage
+ * 
+ * An `ArgumentParser` is the main interface of the library. It is an object
+ * that can be configured with flags, positionals, program description and other
+ * information. A configured object is then used to parse arguments from the
+ * command line (the `argc` array). On successful parsing, a `ParsedArguments`
+ * object is created which stores all parsed arguments. Functons related to the
+ * `ArgumentParser` type are prefixed with `cap_parser_`.
+ * 
+ * ## Times
+ * There are two important events related to an `ArgumentParser` object:
+ * configuration-time and parse-time. Configuration-time takes place between the
+ * creation of a parser and its use for parsing command line arguments. During
+ * configuration-time, many properties of a parser can be added or changed.
+ * These configurations are explained in more depth in the section
+ * Configuration. If anything goes wrong with the parser (e.g. the user attempts
+ * to create an invalid configuration), a configuration-time error occurs, which
+ * usually forcefully exits the program.
+ * 
+ * Parse-time takes place when command line arguments (i.e. words stored in
+ * `argv`) are given to a parser in order to create an output. No changes happen
+ * to the parser object at this time. If any problems arise, such as not enough
+ * arguments or not being able to parse a word, a parse-time error occurs. This
+ * also usually exits the program.
+ * 
+ * ## Creation
+ * There are two factory functions for parsers: `cap_parser_make_empty` and
+ * `cap_parser_make_default`. The `default` function creates a parser with some
+ * useful initial configuration, e.g. a help flag. Objects returned from these
+ * functions are otherwise functionally identical. When configured, an
+ * `ArgumentParser` stores dynamically allocated data, so it needs to be
+ * properly disposed of when no longer needed. That is done using the
+ * `cap_parser_destroy` function. `ParsedArguments` objects created by this
+ * parser are independent of it and can be used even after the parser has been
+ * destroyed.
+ * 
+ * ## Configuration
+ * The two main ways of configuring a parser are creating flags and positional
+ * arguments (or "positionals"). Other configurations are
+ * - flag prefix characters,
+ * - special flags,
+ * - custom program name,
+ * - program description,
+ * - automatic or manual creation of help and usage messages, and
+ * - enabling or disabling display of help and/or usage, and
+ * - subcommands.
+ * 
+ * Do keep in mind that, in this document, "configuring a parser" is a general
+ * expression used for any of the above listed changes to a parser. "Defining" a
+ * flag is the same as "configuring" it, "configuring a flag in the parser", or
+ * "configuring the parser with a flag". Similar terminology is used for other
+ * configurations, such as positionals, descriptions, or a custom usage message.
+ * 
+ * ### Positional Arguments
+ * Positional arguments are inputs to a program given as words on the command
+ * line. Their meaning and interpretation are decided based on their order on
+ * the command line, hence being positional. In this way, positionals are very
+ * similar to arguments given to a function in a programming language such as C.
+ * This order is decided by the programmer at configuration-time: positinoals
+ * are expected on the command line in the same order as they were defined in
+ * the program. Positionals are configured in a parser using the
+ * `cap_parser_add_positional` function.
+ * 
+ * Positionals are defined using a string name, a data type, their
+ * required-ness, and variadicity. The name is used to find its values in a
+ * created `ParsedArguments`. The data type dictates how to interpret the word
+ * on the command line (i.e. in `argv`) and is one of the primitive types
+ * described in @ref typed_union with exception of the `DT_PRESENCE` type (see
+ * later). Required-ness decides if the argument may be
+ * missing on the command line - if it is required, it may not be missing.
+ * Variadicity decides if the positional is allowed to accept multiple values.
+ * (Normally, all positionals take exactly one value if they are not missing.)
+ * 
+ * Required-ness relates to an important concept: at parse-time, once the parser
+ * decides to skip a positional that is is configured as optional, it also skips
+ * parsing all other positionals that were configured after it. This means that
+ * after configuring one optional positional argument, all following positionals
+ * must be configured as optional as well. In other words, a required positional
+ * may not be configured after an optional one. Attempting that creates a
+ * configuration-time error.
+ * 
+ * Variadicity relates to another concept: at parse-time, once the parser
+ * decides that the positional to parse next is variadic, all words that would
+ * be positional values (i.e. they are not flags, see later) are parsed as
+ * values for this positional. This means that, at configuration time, no more
+ * positionals may be configured after a variadic one. Attempting that creates
+ * a configuration-time error. NB that, a variadic argument can also be
+ * required. 
+ * 
+ * Positionals can also have two optional (but useful) properties: a description
+ * and a meta-var. They are both used in automatically created help messages.
+ * The former is a short text explaining the meaning of the argument. The latter
+ * is an intuitive name that represents the value of the argument in the usage
+ * string.
+ * 
+ * ### Flags
+ * Flags differ from positionals in that they are not identified by their
+ * position on the command line. Instead, they are identified by a string
+ * literal (the flag's name, or sometimes informally called "the flag") found on
+ * the command line, and are sometimes followed by a single value. (In that case
+ * this value is not considered a positional value, of course.) This means that,
+ * flags can appear in any order and can even mix inbetween positionals, without
+ * disrupting their (very important) order.
+ * 
+ * A flag is configured in a parser using the `cap_parser_add_flag` function.
+ * That is done with its name, data type, minimum count and maximum count. 
+ * The name is a string literal which must begin with a flag prefix character.
+ * By default that is '-' (dash), but can be changed, see later. The name serves
+ * two purposes:
+ * 1. it identifies the flag in a `ParsedArguments` object, and
+ * 2. it locates the flag and its value on the command line.
+ * 
+ * The data type identifies how the flag's value should be parsed and stored.
+ * Available types are the ones defined in @ref typed_union . Contrary to
+ * positionals, the `DT_PRESENCE` type is allowed here. It is used to define
+ * flags that are not followed by a value. The flag's presence or absence *is*
+ * the information.
+ * 
+ * The minimum and maximum count define how many times the flag can be present
+ * on the command line. For example, setting the minimum to zero configures a
+ * flag that may be omitted on the command line. Conversely, if a flag is
+ * configured with a minimum count greater than zero, and it is not found at
+ * parse-time, a parse-time error occurs. Similarly, a parse-time error occurs
+ * if a flag is found more times than is its maximum count. The maximum count
+ * can be set to `-1` to allow the flag to be parsed up to any number of times.
+ * 
+ * Flags also have two optional properties: a description and a meta-var. Their
+ * meaning is exactly the same as for positionals. The only difference is that,
+ * configuring a meta-var for a flag of the "presence type" has no effect; those
+ * flags take no values, so they are displayed with no meta-variable in
+ * automatically generated help messages.
+ * 
+ * It is also possible to create aliases for configured flags, e.g. to allow
+ * long and short spelling of the flag. That is done using the
+ * `cap_parser_add_flag_alias` function.
+ * 
+ * ### Flag Prefix Characters
+ * By default '-' (dash), these characters identify a word as a flag name. At
+ * parse-time, the parser treates all words it encounters as flags if they begin
+ * with one of the flag prefix characters. That happens even if the word does
+ * not match any configured flag names or aliases. In that case, a parse-time
+ * error is created (with an error message mentioning an "unknown flag"). There
+ * is a way to allow words that begin with a flag prefix character to be parsed
+ * as positional values (e.g. negative numbers). It is called positional-only
+ * mode and is described later, in the Special Flags section.
+ * 
+ * It is possible to change the set of flag prefix characters using the
+ * `parser_set_flag_prefix` function. It is not allowed to do that after any
+ * flags have been configured, however, so calling the function will create a
+ * configuration-time error. This unfortunately includes the default help flag
+ * ('-h') which is present in the default parser.
+ * 
+ * ### Special Flags
+ * Now is a good time to mention some special flags. Namely, that is the
+ * automatic help flag and the flag separator. At configuratino-time, these
+ * behave largely the same as regular flags, but they are handled differently at
+ * parse-time. The main configuration-time difference is that, to define or
+ * change them, the user must call `cap_parser_set_help_flag` and
+ * `cap_parser_set_flag_separator` respectively, instead of the usual
+ * `cap_parser_add_flag` function.
+ *
+ * The automatic help flag ('-h' by default) is used to invoke help text at
+ * parse-time. This can be either a automatically generated help message (the
+ * default), or a custom help text configured by the user. The flag must indeed
+ * be treated in this special way, so that a help message can be printed even if
+ * the command line is "invalid". As mentioned above, the help flag is
+ * configured using the `cap_parser_set_help_flag` function. Compared to
+ * `cap_parser_add_flag`, this allows the user to replace the help flag with a
+ * new configuration, (for instance if the default is not desirable). Aliases
+ * can be configured exactly the same as for regular flags.
+ * 
+ * The flag separator ('--' by default) is a "command" that instructs the parser
+ * to enter positional-only mode at parse-time. In this mode, all words that
+ * have not yet been consumed are treated as positional arguments, even if they
+ * begin with a flag prefix character (see above section Flag Prefix
+ * Characters). This allows for positional argument values that the parser would
+ * otherwise consider as "unknown flag", such as negative numbers. Again, it is
+ * necessary to treat the flag separator in a special way, because it influences
+ * parser logic at parse-time. The function `cap_parser_set_flag_separator` is
+ * used to configure this special flag instead of the usual
+ * `cap_parser_add_flag`. This, similarly to the help flag, allows the user to
+ * re-configure or disable it. Creating aliases is also allowed.
+ * 
+ * ### Subcommands
+ * Programs such as `git` take a command word, followed by arguments of that
+ * command (`git commit -m text`). Such a subcommand is configured using
+ * `cap_parser_add_subcommand`, which is given a function that configures the
+ * parser of the subcommand. A parser with subcommands takes no positionals:
+ * the first word which is not one of its flags names the subcommand, and all
+ * following words are parsed by the parser of the subcommand.
+ * 
+ * Parsers of subcommands are only built at parse-time, when their subcommand
+ * is given, and the subcommand is found by its name in constant time. A
+ * program with many subcommands therefore only pays for configuring the one
+ * which is used.
+ * 
+ * ### Custom Program Name and Desctiption
+ * The parser sometimes needs to display the program name, e.g. when a value
+ * cannot be parsed as the desired type and an error message is in order. By
+ * default, the parser extracts the program name from the first string in
+ * `argv`. However, it is possible to override this and configure a program name
+ * explicitly. This can be done using the `cap_parser_set_program_name` function.
+ * 
+ * Similarly, a description of the program can be configured. This is a text
+ * displayed at the top of an automatically generated help message (see later).
+ * It is also possible to configure an epilogue, a text do be displayed at the
+ * very end of the help message. These texts are empty by default and can be
+ * configured using `cap_parser_set_description` and `cap_parser_set_epilogue`
+ * functions respectively.
+ * 
+ * ### Automatic and Manual Help Texts
+ * When encountering a parse-time error, the parser is able to print a help message before exiting the program. By default, this message is automatically generated on-demand based on configured flags and positionals, but it can be explicitly changed to anything the user wants. That is done using `cap_parser_set_custom_help`. The automatic help looks similar to this.
+ * ```
+ * usage:
+ *     prog.exe [ -f FORMAT ] INPUT_FILE [ OUTPUT_FILE ]
+ * 
+ * Prog is a simple tool for doing useful things.
+ * 
+ * Available Flags:
+ * -f FORMAT
+ *     A c-style format string
+ * 
+ * Positional Arguments:
+ * INPUT_FILE
+ *     Read input from this file
+ * OUTPUT_FILE
+ *     Write output to this file. If missing, print to standard output.
+ * ```
+ * 
+ * TODO
+ * 
+ * ## Parsing
+ * 
+ * TODO
+ * 
+ * ### Threads and Reentrancy
+ * Parsing does not modify the configuration of a parser, so all parsing
+ * functions take a `const ArgumentParser *`. Apart from the installed
+ * allocator (see `cap_allocator_set`), the library keeps no global state that
+ * parsing could change. Functions which take a `const` parser never write to
+ * it, so they need no locks:
+ * - the parsers of subcommands are built either by
+ *   `cap_parser_build_subcommands`, or for each parse which needs them and
+ *   then owned by its result,
+ * - help and usage messages are rendered for each print, unless
+ *   `cap_parser_prepare_help` rendered them beforehand,
+ * - the names offered by shell completion are sorted by the configuration
+ *   functions, see `cap_parser_enable_completion`.
+ *
+ * A configured parser can therefore be used by any number of threads at the
+ * same time, also without `CAP_ENABLE_THREADS` (which only enables the
+ * parallel number parsing of `cap_parser_set_thread_count`), provided that
+ * - no thread configures it (or destroys it) meanwhile,
+ * - each thread parses into its own `ParsedArguments` or `ParserIterator`,
+ * - the installed allocator is thread-safe, like the default one, and it is
+ *   not replaced while parsing.
+ *
+ * Reading a `ParsedArguments` never changes it, so a parse result can always
+ * be read by several threads at once.
+ *
+ * Effects outside the parser are not synchronized: `cap_parser_parse` prints
+ * errors and exits, and the records of `cap_parser_set_positional_input` are
+ * consumed from a file descriptor which is shared by all parses. Response
+ * files are only read.
+ * 
+ */
+
+// ============================================================================
+// === PARSER: DEFINITION OF TYPES ============================================
+// ============================================================================
+
+/**
+ * @addtogroup parser
+ * @{
+ */
+
+/**
+ * Main object for parsing given command line arguments.
+ * 
+ * This object contains all information about configured flags and positional 
+ * arguments, including their types, names, and (for flags) how many times they 
+ * may be present. Once configured, this object is passed to the
+ * `cap_parser_parse` function to parse given command line arguments. That
+ * produces a `ParsedArguments` object, or exits the program if an error 
+ * occurs, e.g. if a given argument cannot be converted to the required type.
+ * It is safe to reuse a configured parser for multiple arrays of arguments.
+ * 
+ * Objects of this type should be created using the factory function
+ * `cap_parser_make_empty`. Configuration is done using functions such as 
+ * `cap_parser_add_flag` and `cap_parser_add_positional`. If an error occurs
+ * when configuring the parser (e.g. the same flag name is used in multiple
+ * calls to `cap_parser_add_flag`) the program exits with an error message.
+ * 
+ * This object can be disposed of using `cap_parser_destroy` when it is no 
+ * longer needed. Any produced `ParsedArguments` objects are not affected by 
+ * this and can be used even after the parser is destroyed.
+ * 
+ * @see cap_parser_make_empty
+ * @see cap_parser_destroy
+ * @see cap_parser_add_flag
+ * @see cap_parser_add_positional
+ * @see cap_parser_parse
+ */
+typedef struct {
+    char * mProgramName;
+    char * mDescription;
+    char * mEpilogue;
+    char * mCustomHelp;
+    char * mCustomUsage;
+
+    bool mEnableHelp;
+    bool mEnableUsage;
+    /// if `true`, DT_STRING values point into the parsed words instead of 
+    /// being copied, see `cap_parser_enable_borrowed_strings`
+    bool mBorrowStrings;
+    /// if `true`, parse results are allocated at their exact size, see
+    /// `cap_parser_enable_exact_allocation`
+    bool mExactAllocation;
+    /// if `true`, values are stored in packed arrays of their type, see
+    /// `cap_parser_enable_packed_values`
+    bool mPackValues;
+    /// if `true`, words `@path` are replaced by the words of the file at
+    /// `path`, see `cap_parser_enable_response_files`
+    bool mExpandResponseFiles;
+    /// file descriptor from which the positional with id `mInputPositional`
+    /// takes more values, or -1, see `cap_parser_set_positional_input`
+    int mInputFd;
+    size_t mInputPositional;
+    char mInputDelimiter;
+    /// number of threads converting long runs of numeric words, see
+    /// `cap_parser_set_thread_count`
+    size_t mThreadCount;
+    /// if `true`, strings given to configuration functions are stored without
+    /// being copied, see `cap_parser_enable_static_strings`
+    bool mStaticStrings;
+    /// which of the strings of the parser itself (`mProgramName` to
+    /// `mCustomUsage`) are borrowed, a combination of `_CAP_STATIC_*` bits
+    unsigned mStaticProperties;
+    /// supply the description and the epilogue instead of `mDescription` and
+    /// `mEpilogue`, or `NULL`
+    DescriptionProvider mDescriptionProvider;
+    void * mDescriptionContext;
+    DescriptionProvider mEpilogueProvider;
+    void * mEpilogueContext;
+    /// if `true`, the words `--cap-complete INDEX WORDS...` request shell
+    /// completion, see `cap_parser_enable_completion`
+    bool mEnableCompletion;
+
+    FlagInfo ** mFlags;
+    size_t mFlagCount;
+    size_t mFlagAlloc;
+
+    PositionalInfo ** mPositionals;
+    size_t mPositionalCount;
+    size_t mPositionalAlloc;
+
+    char * mFlagPrefixChars;
+    /// `mIsFlagPrefix[c]` is `true` iff `c` is one of `mFlagPrefixChars`
+    bool mIsFlagPrefix[256];
+    FlagInfo * mFlagSeparatorInfo;
+    FlagInfo * mHelpFlagInfo;
+
+    /// maps names and aliases of all flags (including the help flag and the 
+    /// flag separator) to their position in `mFlags`, or to one of the 
+    /// special values `_CAP_HELP_FLAG_ID` and `_CAP_FLAG_SEPARATOR_ID`
+    StringIndex * mFlagIndex;
+
+    /// subcommands in the order in which they were added, see
+    /// `cap_parser_add_subcommand`
+    struct _CapSubcommand * mSubcommands;
+    size_t mSubcommandCount;
+    size_t mSubcommandAlloc;
+    /// maps names of subcommands to their position in `mSubcommands`, `NULL`
+    /// until the first subcommand is added
+    StringIndex * mSubcommandIndex;
+
+    /// help message and usage string (without the program name) rendered
+    /// by `cap_parser_prepare_help`, empty until then and again after the
+    /// configuration changes. The help message is not kept if it uses
+    /// description providers.
+    TextBuffer mHelpText;
+    TextBuffer mUsageText;
+    /// names and aliases of all flags and names of subcommands in ascending
+    /// order, kept up to date by configuration functions while shell
+    /// completion is enabled, see `cap_parser_complete`
+    const char ** mCompletionNames;
+    size_t mCompletionNameCount;
+    size_t mCompletionNameAlloc;
+} ArgumentParser;
+
+/**
+ * Configures the parser of a subcommand.
+ * 
+ * A function of this type is given to `cap_parser_add_subcommand`. It is
+ * called at most once, when the subcommand is parsed for the first time, and
+ * configures `parser` like any other parser is configured, e.g. using
+ * `cap_parser_add_flag`. `parser` is a default parser (see
+ * `cap_parser_make_default`), owned by the parser of the main command.
+ * 
+ * @param parser new parser of the subcommand
+ * @param context the pointer given to `cap_parser_add_subcommand`
+ */
+typedef void (* SubparserBuilder)(ArgumentParser * parser, void * context);
+
+/**
+ * Identifies a parse-time error.
+ * 
+ * Identifies a parse-time error for the purpose of noexit parsing. The 
+ * function `cap_parser_parse` constructs an error message depending on the 
+ * error type. Each error can supply up to two other words to be insreted into 
+ * the message, such as the name of a flag. If an error type expects any 
+ * additional words, it is written in a comment block above it.
+ */
+typedef enum {
+    /** 
+     * No error.
+     * 
+     * This value is given when parsing was successful.
+     */
+    PER_NO_ERROR,
+    /**
+     * Help flag was encountered.
+     */
+    PER_HELP,
+    /**
+     * Some required positionals were omitted.
+     */
+    PER_NOT_ENOUGH_POSITIONALS,
+    /**
+     * Too many positionals were given.
+     */
+    PER_TOO_MANY_POSITIONALS,
+    /**
+     * Cannot parse a value given for a positional.
+     * 
+     * Cannot parse a value that was given for a positional argument, with respect to its type. Additional words are the name of the positional and the problematic value.
+     */
+    PER_CANNOT_PARSE_POSITIONAL,
+    /**
+     * An unknown flag was encountered.
+     * 
+     * The parser found an unknown flag. Additional word is the name of the unknown flag.
+     */
+    PER_UNKNOWN_FLAG,
+    /**
+     * No value was given for a flag.
+     * 
+     * A flag with a type other than `DT_PRESENCE` is missing a value. Additional word is the name of the flag.
+     */
+    PER_MISSING_FLAG_VALUE,
+    /**
+     * Cannot parse a value given to a flag.
+     * 
+     * Cannot parse a value that was given for a flag with respect to the flag's type. Additional words are the name of the flag and the problematic value.
+     */
+    PER_CANNOT_PARSE_FLAG,
+    /**
+     * A flag was not given enough times.
+     * 
+     * A flag was given less times than is required by the parser configuration. Additional word is the name of the flag.
+     */
+    PER_NOT_ENOUGH_FLAGS,
+
+    /**
+     * A flag was given too many times.
+     * 
+     * A flag was given more times than is required by the parser configuration. Additional word is the name of the flag.
+     * Parsing stops at the first occurrence which exceeds the limit.
+     */
+    PER_TOO_MANY_FLAGS,
+    /**
+     * A value given for a positional does not fit into its type.
+     * 
+     * A value of a numeric positional argument is well-formed, but it is out of the range of its type. Additional words are the name of the positional and the problematic value.
+     */
+    PER_POSITIONAL_OUT_OF_RANGE,
+    /**
+     * A value given to a flag does not fit into its type.
+     * 
+     * A value of a numeric flag is well-formed, but it is out of the range of the flag's type. Additional words are the name of the flag and the problematic value.
+     */
+    PER_FLAG_OUT_OF_RANGE,
+    /**
+     * A response file cannot be read.
+     * 
+     * A response file given as `@path` does not exist or cannot be read. Additional word is the path of the file.
+     */
+    PER_CANNOT_READ_RESPONSE_FILE,
+    /**
+     * A response file cannot be split into words.
+     * 
+     * A quote in a response file given as `@path` is not closed. Additional word is the path of the file.
+     */
+    PER_INVALID_RESPONSE_FILE,
+    /**
+     * Values of a positional cannot be read from its input.
+     * 
+     * Reading the file descriptor set by `cap_parser_set_positional_input` failed. Additional word is the name of the positional.
+     */
+    PER_CANNOT_READ_INPUT,
+    /**
+     * A command string cannot be split into words.
+     * 
+     * A quote in the string given to `cap_parser_parse_string` is not closed.
+     */
+    PER_UNTERMINATED_QUOTE,
+    /**
+     * An unknown subcommand was given.
+     * 
+     * The word in place of the subcommand is not the name of any subcommand configured by `cap_parser_add_subcommand`. Additional word is the unknown word.
+     */
+    PER_UNKNOWN_SUBCOMMAND,
+    /**
+     * No subcommand was given.
+     * 
+     * The parser has subcommands, but the command line ended before one was given.
+     */
+    PER_MISSING_SUBCOMMAND,
+    /**
+     * The index of a completed word is not a number.
+     * 
+     * The word after `--cap-complete` is not a non-negative integer, see `cap_parser_enable_completion`. Additional word is the invalid index.
+     */
+    PER_INVALID_COMPLETION_INDEX
+} ParsingError;
+
+/**
+ * Result of argument parsing.
+ * 
+ * Represents the result of processing command line arguments using
+ * a configured parser. This object is returned by the
+ * `cap_parser_parse_noexit` function, which does not exit the running program 
+ * when an error is encountered. The success, result, and error message for
+ * that parsing operation are stored in this object.
+ * 
+ * Error words are words of the command line or names from the parser
+ * configuration. If `cap_parser_parse_noexit` fails, a word read from
+ * a response file is replaced by the argument `@path` which named the file,
+ * because the file is released together with the `ParsedArguments`.
+ * 
+ * @note `cap_parser_parse_noexit` and by extension `ParsingResult` exist
+ * mainly for unit testing purposes. Users should primarily use
+ * `cap_parser_parse`.
+ * 
+ * @see cap_parser_parser_noexit
+ * @see cap_parser_parse
+ */
+typedef struct {
+    /// Result of argument parsing, or `NULL` if an error occured
+    ParsedArguments * mArguments;
+    
+    /// first word to be inserted into an error message. 
+    /// The nmeaning of this word depends on `mError`.
+    const char * mFirstErrorWord;
+    
+    /// second word to be inserted into an error message.
+    /// The nmeaning of this word depends on `mError`.
+    const char * mSecondErrorWord;
+   
+    /// Type of a parsing error that occured.
+    /// This value indicates to the caller of `cap_parser_parse_noexit` what 
+    /// error message should be created, if any. It also indicates the meaning 
+    /// of `mFirstErrorWord` and `mSecondErrorWord`. `PER_NO_ERROR` indicates 
+    /// successful parsing.
+    ParsingError mError;
+} ParsingResult;
+
+/**
+ * Identifies a shell for which a completion script is generated.
+ *
+ * @see cap_parser_print_completion_script
+ */
+typedef enum {
+    CS_BASH,
+    CS_ZSH,
+    CS_FISH
+} CompletionShell;
+
+// ============================================================================
+// === PARSER: DEFINITION OF PRIVATE TYPES ====================================
+// ============================================================================
+
+typedef enum {
+    AFE_OK,
+    AFE_MISSING_PARSER,
+    AFE_MISSING_NAME,
+    AFE_INVALID_PREFIX,
+    AFE_DUPLICATE,
+    AFE_MIN_COUNT_NEGATIVE,
+    AFE_MAX_COUNT_VIOLATION,
+    AFE_MAX_COUNT_ZERO
+} AddFlagError;
+
+typedef enum {
+    AFAE_OK,
+    AFAE_MISSING_PARSER,
+    AFAE_MISSING_NAME,
+    AFAE_MISSING_ALIAS,
+    AFAE_INVALID_PREFIX,
+    AFAE_FLAG_DOES_NOT_EXIST,
+    AFAE_DUPLICATE_ALIAS
+} AddFlagAliasError;
+
+typedef enum {
+    APE_ANYTHING_AFTER_VARIADIC,
+    APE_DUPLICATE,
+    APE_MISSING_NAME,
+    APE_MISSING_PARSER,
+    APE_NOT_IMPLEMENTED,
+    APE_OK,
+    APE_PRESENCE,
+    APE_REQUIRED_AFTER_OPTIONAL,
+    APE_SUBCOMMANDS,
+} AddPositionalError;
+
+typedef enum {
+    ASE_OK,
+    ASE_MISSING_PARSER,
+    ASE_MISSING_NAME,
+    ASE_MISSING_BUILDER,
+    ASE_INVALID_PREFIX,
+    ASE_DUPLICATE,
+    ASE_POSITIONALS
+} AddSubcommandError;
+
+typedef enum {
+    OFPE_NO_ERROR,
+    OFPE_UNKNOWN_FLAG,
+    OFPE_MISSING_FLAG_VALUE,
+    OFPE_CANNOT_PARSE_FLAG,
+    OFPE_FLAG_OUT_OF_RANGE
+} OneFlagParsingError;
+
+typedef struct {
+    const FlagInfo * mFlag;
+    size_t mFlagId;
+    TypedUnion mValue;
+    int mWordsConsumed;
+    OneFlagParsingError mError;
+} OneFlagParsingResult;
+
+typedef enum {
+    OPPE_NO_ERROR,
+    OPPE_TOO_MANY,
+    OPPE_CANNOT_PARSE,
+    OPPE_OUT_OF_RANGE
+} OnePositionalParsingError;
+
+typedef struct {
+    const PositionalInfo * mPositional;
+    TypedUnion mValue;
+    int mWordsConsumed;
+    OnePositionalParsingError mError;
+} OnePositionalParsingResult;
+
+typedef enum {
+    TOO_FEW,
+    GOOD
+} BoundsCheckingResult;
+
+typedef struct {
+    const FlagInfo * mFlag;
+    BoundsCheckingResult mCount;
+} FlagCountCheckResult;
+
+/// subcommand of a parser. Its parser is built by
+/// `cap_parser_build_subcommands`, or for each parse which needs it.
+typedef struct _CapSubcommand {
+    char * mName;
+    char * mDescription;
+    SubparserBuilder mBuilder;
+    void * mContext;
+    /// parser of the subcommand, `NULL` until it is built by
+    /// `cap_parser_build_subcommands`
+    ArgumentParser * mParser;
+    /// if `true`, `mName` and `mDescription` are borrowed
+    bool mStaticStrings;
+} _CapSubcommand;
+
+/// cursor over the words of a command line, in which the words of response
+/// files are read in place of the arguments naming them
+typedef struct {
+    const char * const * mArgv;
+    int mArgc;
+    /// index of the current word, or of the argument naming the response file
+    /// which contains it
+    int mIndex;
+    /// response files which were not entered yet, ordered by `mIndex`
+    const ResponseFile * mFiles;
+    size_t mFileCount;
+    /// current word, `NULL` after the last word
+    const char * mWord;
+    /// end of the words of the current response file, `NULL` if the current
+    /// word is on the command line
+    const char * mFileEnd;
+} _CapWords;
+
+/// reader of delimited records from a file descriptor. The records are read
+/// in large chunks, and handed out as null-terminated words in place.
+typedef struct {
+    int mFd;
+    char mDelimiter;
+    /// `mSize` bytes, and one more for a null character after the last record
+    char * mBuffer;
+    size_t mSize;
+    /// number of bytes in `mBuffer`
+    size_t mUsed;
+    /// number of bytes of records which were handed out, a partial record
+    /// follows them
+    size_t mConsumed;
+    bool mEnd;
+    bool mFailed;
+} _CapInput;
+
+/// value stored in `ArgumentParser::mFlagIndex` for names of the help flag
+static const size_t _CAP_HELP_FLAG_ID = (size_t) -1;
+/// value stored in `ArgumentParser::mFlagIndex` for names of the flag separator
+static const size_t _CAP_FLAG_SEPARATOR_ID = (size_t) -2;
+/// bits of `ArgumentParser::mStaticProperties`
+static const unsigned _CAP_STATIC_PROGRAM_NAME = 1u << 0;
+static const unsigned _CAP_STATIC_DESCRIPTION = 1u << 1;
+static const unsigned _CAP_STATIC_EPILOGUE = 1u << 2;
+static const unsigned _CAP_STATIC_CUSTOM_HELP = 1u << 3;
+static const unsigned _CAP_STATIC_CUSTOM_USAGE = 1u << 4;
+/// number of numeric positional words converted at once
+#define _CAP_NUMERIC_CHUNK_SIZE 256
+/// number of bytes of positional input read at once
+#define _CAP_INPUT_CHUNK_SIZE ((size_t) 1 << 20)
+/// replaces words of positional input in errors of `cap_parser_parse_noexit`
+static const char * const _CAP_INPUT_ERROR_WORD = "(input)";
+/// program name in messages of `cap_parser_parse_string` if none is configured
+static const char * const _CAP_STRING_PROGRAM_NAME = "command";
+
+// ============================================================================
+// === PARSER: DECLARATION OF PRIVATE FUNCTIONS ===============================
+// ============================================================================
+
+static WordConversionResult _cap_parse_word_as_type(
+    const char * word, DataType type, TypedUnion * uninitialized_tu);
+static bool _cap_parser_find_flag_id(
+    const ArgumentParser * parser, const char * flag, size_t * id);
+static FlagInfo * _cap_parser_find_flag(
+    const ArgumentParser * parser, const char * flag);
+static void _cap_parser_index_flag(
+    ArgumentParser * parser, const FlagInfo * flag_info, size_t id);
+static void _cap_parser_unindex_flag(
+    ArgumentParser * parser, const FlagInfo * flag_info);
+static const char * _cap_get_shortest_flag_name(const FlagInfo * flag_info);
+static void _cap_parser_set_string(
+    ArgumentParser * parser, char ** property, unsigned static_bit,
+    const char * value);
+static void _cap_parser_index_subcommands(ArgumentParser * parser);
+static ArgumentParser * _cap_parser_build_subparser(
+    const ArgumentParser * parser, size_t id);
+static const ArgumentParser * _cap_parser_get_subparser(
+    const ArgumentParser * parser, size_t id, ArgumentParser ** built);
+static void _cap_parser_release_subparser(void * parser);
+static void _cap_parser_release_subparsers(ArgumentParser * parser);
+static bool _cap_parser_has_name(
+    const ArgumentParser * parser, const char * name);
+static void _cap_parser_init_texts(ArgumentParser * parser);
+static void _cap_parser_forget_texts(ArgumentParser * parser);
+static void _cap_parser_release_texts(ArgumentParser * parser);
+static const TextBuffer * _cap_parser_get_text(
+    const ArgumentParser * parser, bool help, TextBuffer * rendered);
+static bool _cap_parser_has_providers(const ArgumentParser * parser);
+static void _cap_parser_render_usage(
+    const ArgumentParser * parser, TextBuffer * text);
+static void _cap_parser_render_help(
+    const ArgumentParser * parser, TextBuffer * text);
+static size_t _cap_copy_text(
+    char * buffer, size_t size, size_t offset, const char * text,
+    size_t length);
+static const char ** _cap_parser_sort_names(
+    const ArgumentParser * parser, size_t * count);
+static void _cap_parser_build_completion_names(ArgumentParser * parser);
+static void _cap_parser_insert_completion_name(
+    ArgumentParser * parser, const char * name);
+static void _cap_parser_remove_completion_name(
+    ArgumentParser * parser, const char * name);
+static int _cap_compare_names(const void * a, const void * b);
+static void _cap_parser_check_completion(
+    const ArgumentParser * parser, int argc, const char ** argv);
+
+static OnePositionalParsingResult _cap_parser_parse_one_positional(
+    const ArgumentParser * parser, const char * arg, 
+    size_t positional_index);
+static OneFlagParsingResult _cap_parser_parse_one_flag(
+    const ArgumentParser * parser, _CapWords * words);
+static bool _cap_parser_parse_numeric_run(
+    const ArgumentParser * parser, _CapWords * words, size_t positional_index,
+    bool positional_only, ParsingResult * result);
+static bool _cap_parser_store_numeric_words(
+    const ArgumentParser * parser, size_t positional_index,
+    const char * const * words, size_t count, const char * limit,
+    ParsingResult * result);
+static void _cap_parser_parse_flags_and_positionals(
+    const ArgumentParser * parser, _CapWords words, ParsingResult * result);
+static void _cap_parser_parse_subcommand(
+    const ArgumentParser * parser, _CapWords words, ParsingResult * result);
+static size_t _cap_parser_count_values(
+    const ArgumentParser * parser, _CapWords words, size_t * flag_counts,
+    size_t * positional_counts);
+static void _cap_parser_count_to_size(
+    const ArgumentParser * parser, size_t * flag_counts,
+    size_t * positional_counts);
+static ParsedArguments * _cap_parser_make_exact_arguments(
+    const ArgumentParser * parser, _CapWords words);
+static ParsedArguments * _cap_parser_make_arguments(
+    const ArgumentParser * parser, _CapWords words);
+
+static _CapWords _cap_words_make(
+    int argc, const char * const * argv, const ResponseFile * files,
+    size_t file_count);
+static void _cap_words_load(_CapWords * words);
+static void _cap_words_advance(_CapWords * words);
+static ParsingResult _cap_parser_open_response_files(
+    const ArgumentParser * parser, int argc, const char * const * argv,
+    ResponseFile ** files, size_t * file_count);
+static void _cap_parser_detach_error_words(ParsingResult * result);
+static void _cap_input_init(_CapInput * input, int fd, char delimiter);
+static bool _cap_input_next(_CapInput * input, _CapWords * words);
+static char * _cap_input_detach(_CapInput * input);
+static void _cap_input_destroy(_CapInput * input);
+static void _cap_parser_parse_input(
+    const ArgumentParser * parser, ParsingResult * result);
+
+static FlagCountCheckResult _cap_parser_check_flag_counts(
+    const ArgumentParser * parser, const ParsedArguments * parsed_arguments);
+static void _cap_parser_check_flag_and_positional_counts(
+    const ArgumentParser * parser, ParsingResult * result);
+
+static ParsingResult _cap_parser_parse_noexit(
+    const ArgumentParser * parser, int argc, const char ** argv);
+static ParsingResult _cap_parser_parse_all(
+    const ArgumentParser * parser, int argc, const char ** argv);
+static ParsingResult _cap_parser_parse_into(
+    const ArgumentParser * parser, ParsedArguments * args, _CapWords words);
+static ParsingResult _cap_parser_parse_string(
+    const ArgumentParser * parser, char * buffer, size_t length);
+static ParsedArguments * _cap_parser_finish_parsing(
+    const ArgumentParser * parser, ParsingResult result, const char ** argv);
+
+// ============================================================================
+// === PARSER: DECLARATION OF PUBLIC FUNCTIONS ================================
+// ============================================================================
+
+void cap_parser_set_help_flag(
+        ArgumentParser * parser, const char * name, const char * description);
+void cap_parser_set_flag_separator(
+    ArgumentParser * parser, const char * separator, const char * description);
+void cap_parser_enable_help(ArgumentParser * parser, bool enable);
+void cap_parser_enable_usage(ArgumentParser * parser, bool enable);
+bool cap_parser_get_positional_id(
+    const ArgumentParser * parser, const char * name, size_t * id);
+
+// ============================================================================
+// === PARSER: CREATION AND DESTRUCTION =======================================
+// ============================================================================
+
+/**
+ * Creates a new empty parser.
+ * 
+ * Creates a new parser with no configured flags or positional arguments. 
+ * The caller becomes the owner of this new object and should dispose of it 
+ * using `cap_parser_destroy` when it is no longer needed.
+ * 
+ * @return new object
+ * 
+ * @see cap_parser_destroy
+ * @see cap_parser_make_default
+ */
+ArgumentParser * cap_parser_make_empty() {
+    ArgumentParser * p = (ArgumentParser *) cap_malloc(sizeof(ArgumentParser));
+    *p = (ArgumentParser) {
+        .mProgramName = NULL,
+        .mDescription = NULL,
+        .mEpilogue = NULL,
+        .mCustomHelp = NULL,
+        .mCustomUsage = NULL,
+        .mEnableHelp = false,
+        .mEnableUsage = false,
+        .mBorrowStrings = false,
+        .mExactAllocation = false,
+        .mPackValues = false,
+        .mExpandResponseFiles = false,
+        .mInputFd = -1,
+        .mInputPositional = 0u,
+        .mInputDelimiter = '\0',
+        .mThreadCount = 1u,
+        .mStaticStrings = false,
+        .mStaticProperties = 0u,
+        .mDescriptionProvider = NULL,
+        .mDescriptionContext = NULL,
+        .mEpilogueProvider = NULL,
+        .mEpilogueContext = NULL,
+        .mEnableCompletion = false,
+
+        .mFlags = NULL,
+        .mFlagCount = 0u,
+        .mFlagAlloc = 0u,
+
+        .mPositionals = NULL,
+        .mPositionalCount = 0u,
+        .mPositionalAlloc = 0u,
+        
+        .mFlagPrefixChars = copy_string("-"),
+        .mIsFlagPrefix = { false },
+        .mFlagSeparatorInfo = NULL,
+        .mHelpFlagInfo = NULL,
+
+        .mFlagIndex = cap_si_make_empty(),
+
+        .mSubcommands = NULL,
+        .mSubcommandCount = 0u,
+        .mSubcommandAlloc = 0u,
+        .mSubcommandIndex = NULL
+    };
+    p -> mIsFlagPrefix['-'] = true;
+    _cap_parser_init_texts(p);
+    return p;
+}
+
+/**
+ * Creates a new default parser.
+ * 
+ * Creates a new parser with default configuration. It differs from an empty 
+ * parser in that it contains the automatic help flag "-h" and the flag 
+ * separator "--" that switches the parser to positional-only mode.
+ * 
+ * @see cap_parser_make_empty
+ * @see cap_parser_destroy
+ */
+ArgumentParser * cap_parser_make_default() {
+    ArgumentParser * parser = cap_parser_make_empty();
+    cap_parser_set_help_flag(parser, "-h", NULL);
+    cap_parser_set_flag_separator(parser, "--", NULL);
+    cap_parser_enable_help(parser, true);
+    cap_parser_enable_usage(parser, true);
+    return parser;
+}
+
+/**
+ * Destroys an `ArgumentParser` object.
+ * 
+ * Destroys an `ArgumentParser` object and all data stored in it. 
+ * `ParsedArgument` objects created using this parser are not owned by it 
+ * and can be used after a parser is destroyed.
+ * 
+ * @param parser object to destroy. If it is `NULL`, nothing happens.
+ */
+void cap_parser_destroy(ArgumentParser * parser) {
+    if (!parser) return;
+    _cap_parser_set_string(
+        parser, &(parser -> mProgramName), _CAP_STATIC_PROGRAM_NAME, NULL);
+    _cap_parser_set_string(
+        parser, &(parser -> mDescription), _CAP_STATIC_DESCRIPTION, NULL);
+    _cap_parser_set_string(
+        parser, &(parser -> mEpilogue), _CAP_STATIC_EPILOGUE, NULL);
+    _cap_parser_set_string(
+        parser, &(parser -> mCustomHelp), _CAP_STATIC_CUSTOM_HELP, NULL);
+    _cap_parser_set_string(
+        parser, &(parser -> mCustomUsage), _CAP_STATIC_CUSTOM_USAGE, NULL);
+    for (size_t i = 0; i < parser -> mFlagCount; ++i) {
+        cap_flag_info_destroy(parser -> mFlags[i]);
+    }
+    for (size_t i = 0; i < parser -> mPositionalCount; ++i) {
+        cap_positional_info_destroy(parser -> mPositionals[i]);
+    }
+    cap_free(parser -> mFlags);
+    cap_free(parser -> mPositionals);
+    parser -> mFlags = NULL;
+    parser -> mPositionals = NULL;
+    parser -> mFlagCount = parser -> mFlagAlloc = 0u;
+    parser -> mPositionalCount = parser -> mPositionalAlloc = 0;
+
+    delete_string_property(&(parser -> mFlagPrefixChars));
+
+    if (parser -> mHelpFlagInfo) {
+        cap_flag_info_destroy(parser -> mHelpFlagInfo);
+        parser -> mHelpFlagInfo = NULL;
+    }
+    if (parser -> mFlagSeparatorInfo) {
+        cap_flag_info_destroy(parser -> mFlagSeparatorInfo);
+        parser -> mFlagSeparatorInfo = NULL;
+    }
+    cap_si_destroy(parser -> mFlagIndex);
+    parser -> mFlagIndex = NULL;
+
+    _cap_parser_release_subparsers(parser);
+    for (size_t i = 0; i < parser -> mSubcommandCount; ++i) {
+        if (!parser -> mSubcommands[i].mStaticStrings) {
+            cap_free(parser -> mSubcommands[i].mName);
+            delete_string_property(&(parser -> mSubcommands[i].mDescription));
+        }
+    }
+    cap_free(parser -> mSubcommands);
+    parser -> mSubcommands = NULL;
+    parser -> mSubcommandCount = parser -> mSubcommandAlloc = 0u;
+
+    _cap_parser_release_texts(parser);
+    cap_free(parser);
+}
+
+// ============================================================================
+// === PARSER: GENERAL CONFIGURATION ==========================================
+// ============================================================================
+
+/**
+ * Sets characters to be considered flag-prefix characters.
+ * 
+ * Configures a set of characters to be considered flag-prefixes by the parser.
+ * Any command line word that begins with one of these characters is considered 
+ * a flag unless parsing in positional-only mode, see below. By default, 
+ * '-' (dash) is considered the only prefix character.
+ * 
+ * If `parser` is `NULL`, nothing happens. If `prefix_chars` is `NULL` or
+ * empty, the program exits with an error.
+ * 
+ * Note that, this configuration must be done before adding any flags, because 
+ * added flags are required to begin with a flag prefix character. If any flags 
+ * are present when calling this function, the program exits with an error.
+ * 
+ * @param parser parser object to configure
+ * @param prefix_chars null-terminated string of characters that should be 
+ *        considered flag prefixes.
+ */
+void cap_parser_set_flag_prefix(
+        ArgumentParser * parser, const char * prefix_chars) {
+    if (!parser) return;
+    if (!prefix_chars || strlen(prefix_chars) == 0) {
+        fprintf(stderr, "cap: missing flag prefix characters\n");
+        exit(-1);
+    }
+    if (parser -> mFlagCount || parser -> mHelpFlagInfo) {
+        fprintf(
+            stderr, "cap: cannot set flag prefix characters when flags "
+            "already exist\n");
+        exit(-1);
+    }
+    set_string_property(&(parser -> mFlagPrefixChars), prefix_chars);
+    memset(parser -> mIsFlagPrefix, 0, sizeof(parser -> mIsFlagPrefix));
+    for (const char * c = prefix_chars; *c; ++c) {
+        parser -> mIsFlagPrefix[(unsigned char) *c] = true;
+    }
+    return;
+}
+
+/**
+ * Sets a flag separator.
+ * 
+ * Configures a parser to recognize a flag separator, or to not have one. A 
+ * flag separator is a special flag that, when found on the command line, puts 
+ * the parser in positional only mode. In this mode all command line words are 
+ * used as positionals even if they begin with a flag prefix character.
+ * By default the flag separator is '--' (double dash). 
+ * 
+ * If the given string is empty or a flag already exists with the same name, 
+ * the program exits with an error. This string is copied into the parser and
+ * the caller remains the owner of the given pointer.
+ * 
+ * The `description` parameter allows to set a short description of this 
+ * separator which appears in help messages. If `NULL` is given, a default
+ * description is used. If the description should be blank, an empty string 
+ * should be passed to this function.
+ * 
+ * @param parser parser object to configure
+ * @param separator null-terminated string containing the new flag separator.
+ *        If `NULL` is given, the flag separator is explicitly disabled.
+ * @param description short description of this symbol for use in help mesages.
+ */
+void cap_parser_set_flag_separator(
+        ArgumentParser * parser, const char * separator, 
+        const char * description) {
+    static const char * const DEFAULT_FLAG_SEPARATOR_DESCRIPTION 
+        = "Treat all following command line arguments as positionals";
+
+    if (!parser) return;
+    if (separator && strlen(separator) == 0) {
+        fprintf(stderr, "cap: missing flag separator\n");
+        exit(-1);
+    }
+    _cap_parser_forget_texts(parser);
+    if (parser -> mFlagSeparatorInfo) {
+        _cap_parser_unindex_flag(parser, parser -> mFlagSeparatorInfo);
+        cap_flag_info_destroy(parser -> mFlagSeparatorInfo);
+        parser -> mFlagSeparatorInfo = NULL;
+    }
+    if (_cap_parser_find_flag(parser, separator)) {
+        fprintf(
+            stderr, "cap: cannot set '%s' as flag separator - this flag"
+            " already exists\n", separator);
+        exit(-1);
+    }
+    if (!separator) {
+        return;
+    }
+    FlagInfo * separator_info = cap_flag_info_make(
+        separator, NULL, 
+	description ? description : DEFAULT_FLAG_SEPARATOR_DESCRIPTION,
+       	DT_PRESENCE, 0, -1, parser -> mStaticStrings);
+    parser -> mFlagSeparatorInfo = separator_info;
+    _cap_parser_index_flag(parser, separator_info, _CAP_FLAG_SEPARATOR_ID);
+}
+
+/**
+ * Sets the name of the program.
+ * 
+ * Sets the display name of the program for use in help and usage messages.
+ * By default, the program name is constructed from the first command line 
+ * argument.
+ * 
+ * @param parser parser object to configure
+ * @param name null-terminated name of the program. If NULL, the parser is 
+ *        reset to default behaviour (described above).
+ */
+void cap_parser_set_program_name(ArgumentParser * parser, const char * name) {
+    if (!parser) {
+        return;
+    }
+    _cap_parser_set_string(
+        parser, &(parser -> mProgramName), _CAP_STATIC_PROGRAM_NAME, name);
+}
+
+/**
+ * Sets the program's description.
+ * 
+ * Sets the description of the program that is displayed at the beginning of 
+ * the automatically generated help message. By default no description is 
+ * printed. A previously configured description can be removed using this 
+ * function by giving `NULL` as the second parameter.
+ * 
+ * If `description` is not `NULL`, a copy of it is created and `parser` becomes
+ * the owner of that copy, unless static strings are enabled (see
+ * `cap_parser_enable_static_strings`).
+ * 
+ * @param parser parser object to configure
+ * @param description null-terminated description of the program, or NULL
+ */
+void cap_parser_set_description(
+        ArgumentParser * parser, const char * description) {
+    if (!parser) {
+        return;
+    }
+    _cap_parser_set_string(
+        parser, &(parser -> mDescription), _CAP_STATIC_DESCRIPTION,
+        description);
+}
+
+/**
+ * Sets the epilogue of the program's help.
+ * 
+ * Sets an epilogue of the program's description which is displayed at the end 
+ * of the automatically generated help message. By default no epilogue is 
+ * printed and a previously configured epilogue can be removed by giving `NULL` 
+ * as the second parameter.
+ * 
+ * If `epilogue` is not `NULL`, a copy of it is created and `parser` becomes 
+ * the owner of that copy, unless static strings are enabled (see
+ * `cap_parser_enable_static_strings`).
+ * 
+ * @param parser object to configure
+ * @param epilogue epilogue of the help message, or `NULL`
+ */
+void cap_parser_set_epilogue(ArgumentParser * parser, const char * epilogue) {
+    if (!parser) {
+        return;
+    }
+    _cap_parser_set_string(
+        parser, &(parser -> mEpilogue), _CAP_STATIC_EPILOGUE, epilogue);
+}
+
+/**
+ * Sets a custom help message.
+ * 
+ * Sets a custom help message to displays instead of an automatically generated 
+ * one. The given text is displayed verbatim whenever a help message is 
+ * printed. This configuration overrides the configuration done using 
+ * `cap_parser_set_description`, `cap_parser_set_epilogue` and setting metavars 
+ * for flags and arguments for the purposes of displaying a help message. Those
+ * configurations are not removed by calling this function, however.
+ * 
+ * Unlike `cap_parser_set_description`, `cap_parser_set_epilogue`, 
+ * or `cap_parser_set_program_name`, if `help` is `NULL`, the parser is 
+ * configured to automatically generate help messages. An empty help can be
+ * configured by passing an empty string to this function.
+ * 
+ * If `help` is not `NULL`, a copy of it is created and `parser` becomes the 
+ * owner of that copy, unless static strings are enabled (see
+ * `cap_parser_enable_static_strings`).
+ * 
+ * @param parser object to configure
+ * @param help custom help message, or `NULL`
+ */
+void cap_parser_set_custom_help(ArgumentParser * parser, const char * help) {
+    if (!parser) {
+        return;
+    }
+    _cap_parser_set_string(
+        parser, &(parser -> mCustomHelp), _CAP_STATIC_CUSTOM_HELP, help);
+}
+
+/**
+ * Sets a custom usage string.
+ * 
+ * Sets a custom usage message to display instead of an automatically generated 
+ * one. The given text is displayed verbatim whenever a help message is to be 
+ * printed. If `usage` is `NULL`, the parser reverts to generating usage 
+ * automatically. 
+ * 
+ * An empty string should be used if usage should be blank. 
+ * Alternately, usage can be suppressed by calling `cap_parser_enable_usage`.
+ * If usage was previously disabled using `cap_parser_enable_usage(false)`,
+ * it does not get re-enabled by calling this function.
+ * 
+ * @param parser object to configure
+ * @param usage null-terminated verbatim usgage string, or `NULL` to revert to 
+ *        automatic.
+ */
+void cap_parser_set_custom_usage(ArgumentParser * parser, const char * usage) {
+    if (!parser) {
+        return;
+    }
+    _cap_parser_set_string(
+        parser, &(parser -> mCustomUsage), _CAP_STATIC_CUSTOM_USAGE, usage);
+}
+
+/**
+ * Enables or disable displaying help.
+ * 
+ * Temporarily enables or disables displaying help messages. When disabling 
+ * help by setting `enable` to `false`, information such as program description 
+ * is not removed. Note that, changing any help configuration when displaying 
+ * help is disabled does not re-enable it. Help must be manually re-enabled 
+ * using this function.  
+ * 
+ * @param parser object to configure
+ * @param enable `true` if help should be displayed, `false` if not
+ */
+void cap_parser_enable_help(ArgumentParser * parser, bool enable) {
+    if (!parser) return;
+    parser -> mEnableHelp = enable;
+}
+
+/**
+ * Enables or disable displaying usage.
+ * 
+ * Temporarily enables or disables displaying usage messages. When disabling 
+ * usage by setting `enable` to `false`, information such as custom usage 
+ * is not removed. Note that, changing any related configuration when displaying 
+ * usage is disabled does not re-enable it. Usage must be manually re-enabled 
+ * using this function.  
+ * 
+ * @param parser object to configure
+ * @param enable `true` if usage should be displayed, `false` if not
+ */
+void cap_parser_enable_usage(ArgumentParser * parser, bool enable) {
+    if (!parser) {
+        return;
+    }
+    parser -> mEnableUsage = enable;
+}
+
+/**
+ * Enables or disables borrowing of string values.
+ * 
+ * By default, values of DT_STRING flags and positionals are copied into the 
+ * resulting `ParsedArguments`. When borrowing is enabled, the `TypedUnion`s
+ * point straight into the array of words given to `cap_parser_parse` and no
+ * strings are copied. They are also never freed by `cap_pa_destroy`.
+ * 
+ * Only enable this if the words outlive every `ParsedArguments` produced by
+ * the parser. That is the case when parsing `argv` given to `main`.
+ * 
+ * @param parser object to configure
+ * @param enable `true` if string values should be borrowed, `false` if they
+ *        should be copied
+ */
+void cap_parser_enable_borrowed_strings(ArgumentParser * parser, bool enable) {
+    if (!parser) {
+        return;
+    }
+    parser -> mBorrowStrings = enable;
+}
+
+/**
+ * Enables or disables exact allocation of parse results.
+ * 
+ * When enabled, parsing is done in two passes. The first pass classifies the
+ * words without converting any values and counts how many values each flag 
+ * and positional argument receives. The resulting `ParsedArguments` is then 
+ * allocated at its exact final size, and the second pass stores the values
+ * without growing any buffers. This pays off when there are many values, e.g.
+ * a variadic positional receiving thousands of words. For short command 
+ * lines, the extra pass is usually not worth it.
+ * 
+ * @param parser object to configure
+ * @param enable `true` if results should be allocated at their exact size
+ */
+void cap_parser_enable_exact_allocation(ArgumentParser * parser, bool enable) {
+    if (!parser) {
+        return;
+    }
+    parser -> mExactAllocation = enable;
+}
+
+/**
+ * Enables or disables packed storage of values.
+ * 
+ * By default, the values of each flag and positional argument are stored as
+ * an array of `TypedUnion`s. When packing is enabled, values of one type are
+ * stored in an array of that type instead, e.g. `int[]` for `DT_INT`, which
+ * takes a quarter of the memory for many integers. Such arrays are returned
+ * by functions such as `cap_pa_get_positional_ints`, which return `NULL` for
+ * values which are not packed.
+ * 
+ * Values stored in a packed array have no `TypedUnion`, so functions such as
+ * `cap_pa_get_positional_i` return `NULL` for them. The value of a flag or
+ * positional which receives only a single value is still accessible that 
+ * way. Packing is disabled by default.
+ * 
+ * @param parser object to configure
+ * @param enable `true` if values should be stored packed
+ */
+void cap_parser_enable_packed_values(ArgumentParser * parser, bool enable) {
+    if (!parser) {
+        return;
+    }
+    parser -> mPackValues = enable;
+}
+
+/**
+ * Enables or disables response files.
+ *
+ * When enabled, each command line word `@path` (except words after the flag
+ * separator) is replaced by the words contained in the file at `path`. This
+ * lets callers pass more words than the system allows on a command line, e.g.
+ * long lists of files. See @ref response_file for how files are split into
+ * words. Words read from a file are never expanded again.
+ *
+ * The file is mapped into memory and split in place, so its words are not
+ * copied. They stay valid as long as the `ParsedArguments` produced from
+ * them, also when `cap_parser_enable_borrowed_strings` is enabled.
+ *
+ * If a file cannot be read, parsing fails with
+ * `PER_CANNOT_READ_RESPONSE_FILE`. If a quote in it is not closed, it fails
+ * with `PER_INVALID_RESPONSE_FILE`. Response files are disabled by default.
+ *
+ * @param parser object to configure
+ * @param enable `true` if words `@path` should be replaced by the words of
+ *        files
+ */
+void cap_parser_enable_response_files(ArgumentParser * parser, bool enable) {
+    if (!parser) {
+        return;
+    }
+    parser -> mExpandResponseFiles = enable;
+}
+
+/**
+ * Enables or disables the shell completion mode.
+ *
+ * When enabled, `cap_parser_parse` checks whether the command line is
+ * `PROGRAM --cap-complete INDEX WORDS...`. If it is, it prints the candidates
+ * for the word `INDEX` of `WORDS` (see `cap_parser_complete`) and exits the
+ * program. The word `--cap-complete` is not a flag of the parser, so it is
+ * not shown by help messages. The scripts printed by
+ * `cap_parser_print_completion_script` run the program this way.
+ *
+ * Nothing but the configuration of the parser is needed to complete a word,
+ * so the program should parse its command line before anything else which
+ * takes time. Only the parsers of subcommands which are on the completed
+ * command line are built (see `cap_parser_add_subcommand`). If the index is
+ * not a number, the program exits with an error message. The completion
+ * mode is disabled by default.
+ *
+ * While the completion mode is enabled, the parser keeps the names of its
+ * flags, their aliases, and its subcommands sorted, so that completing a word
+ * only looks them up.
+ *
+ * @param parser object to configure
+ * @param enable `true` if `--cap-complete` should request completion
+ */
+void cap_parser_enable_completion(ArgumentParser * parser, bool enable) {
+    if (!parser || parser -> mEnableCompletion == enable) {
+        return;
+    }
+    parser -> mEnableCompletion = enable;
+    _cap_parser_build_completion_names(parser);
+}
+
+/**
+ * Reads further values of a variadic positional from a file descriptor.
+ *
+ * After the command line has been parsed, the records read from `fd` until
+ * its end are appended to the values of the positional `name`, the same way
+ * as `xargs -0` appends its input to a command. Records are separated by
+ * `delimiter`, typically `'\0'` (as written by `find -print0`) or `'\n'`.
+ * A delimiter after the last record is optional, empty records are kept.
+ * Records are never taken for flags, and are converted to the type of the
+ * positional like command line words.
+ *
+ * The input is read in chunks, so it is never held in memory at once unless
+ * its values are borrowed strings (see `cap_parser_enable_borrowed_strings`),
+ * which then stay valid as long as the `ParsedArguments`. A `ParserIterator`
+ * yields the records one at a time, a yielded string is valid until the next
+ * item is requested.
+ *
+ * If `fd` cannot be read, parsing fails with `PER_CANNOT_READ_INPUT`. Errors
+ * in a record name the word "(input)" instead of the record. The descriptor
+ * is neither closed nor rewound by the parser. Input is only supported on
+ * POSIX systems.
+ *
+ * @param parser object to configure
+ * @param name name of a variadic positional
+ * @param fd file descriptor to read from (e.g. `STDIN_FILENO`), or a negative
+ *        number to disable reading input
+ * @param delimiter character separating the records
+ */
+void cap_parser_set_positional_input(
+        ArgumentParser * parser, const char * name, int fd, char delimiter) {
+    if (!parser) {
+        return;
+    }
+    if (fd < 0) {
+        parser -> mInputFd = -1;
+        return;
+    }
+#if !defined(_CAP_POSIX)
+    (void) name;
+    (void) delimiter;
+    fprintf(stderr, "cap: positional input is not supported on this system\n");
+    exit(-1);
+#else
+    size_t id;
+    if (!name) {
+        fprintf(stderr, "cap: missing positional name\n");
+        exit(-1);
+    }
+    if (!cap_parser_get_positional_id(parser, name, &id)) {
+        fprintf(stderr, "cap: unknown positional argument %s\n", name);
+        exit(-1);
+    }
+    if (!parser -> mPositionals[id] -> mVariadic) {
+        fprintf(stderr, "cap: positional argument %s is not variadic\n", name);
+        exit(-1);
+    }
+    parser -> mInputFd = fd;
+    parser -> mInputPositional = id;
+    parser -> mInputDelimiter = delimiter;
+#endif
+}
+
+/**
+ * Sets the number of threads converting values.
+ *
+ * Words are always classified as flags, flag values and positionals on the
+ * calling thread, because the meaning of a word depends on the words before
+ * it. With more than one thread, a long run of words of a variadic `DT_INT`
+ * or `DT_DOUBLE` positional is then cut into slices which are converted on
+ * up to `count` threads at once (including the calling one), each storing
+ * its values into its own part of the result. The parsed values and errors
+ * are identical to parsing on one thread.
+ *
+ * Threads are started for each run of at least 32768 words and joined
+ * before the run is stored, so parsers hold no threads. This pays off for
+ * command lines (or response files, or input) with millions of numbers.
+ * Threads are only used if `CAP_ENABLE_THREADS` is defined before including
+ * the library, on POSIX systems, and the program must then be linked with
+ * `-pthread`. Otherwise values are always converted on the calling thread.
+ * One thread is used by default.
+ *
+ * @param parser object to configure
+ * @param count maximum number of threads, 0 and 1 both mean the calling
+ *        thread only
+ */
+void cap_parser_set_thread_count(ArgumentParser * parser, size_t count) {
+    if (!parser) {
+        return;
+    }
+    parser -> mThreadCount = count ? count : 1u;
+}
+
+/**
+ * Enables or disables static configuration strings.
+ * 
+ * By default, the parser stores copies of all strings given to configuration
+ * functions, so that the caller may release them right away. Most programs
+ * pass string literals, which need not be copied. When static strings are
+ * enabled, the parser stores the given pointers instead of copies, which
+ * saves an allocation and a copy for each name, alias, metavar, and
+ * description.
+ * 
+ * This affects the strings given to the functions called while static strings
+ * are enabled (including aliases of flags added while they were enabled):
+ * flags, positionals and subcommands, the program name, the description, the
+ * epilogue, and custom help and usage. These strings must not be modified and
+ * must remain valid until the parser is destroyed. Compiled parsers (see
+ * `cap_parser_compile`) still copy all strings.
+ * 
+ * ``` c
+ * ArgumentParser * parser = cap_parser_make_default();
+ * cap_parser_enable_static_strings(parser, true);
+ * cap_parser_add_flag(parser, "-v", DT_PRESENCE, 0, 1, NULL, "Be verbose");
+ * ```
+ * 
+ * @param parser object to configure
+ * @param enable `true` to store the given strings themselves, `false` to
+ *        store copies
+ */
+void cap_parser_enable_static_strings(ArgumentParser * parser, bool enable) {
+    if (!parser) {
+        return;
+    }
+    parser -> mStaticStrings = enable;
+}
+
+// ============================================================================
+// === PARSER: DESCRIPTION PROVIDERS ==========================================
+// ============================================================================
+
+/**
+ * Sets a function which supplies the description of the program.
+ * 
+ * Instead of the description configured using `cap_parser_set_description`,
+ * the text returned by `provider` is displayed in the automatically generated
+ * help message. `provider` is only called when the help message is printed,
+ * so a description which is costly to produce costs nothing otherwise.
+ * 
+ * @param parser object to configure
+ * @param provider function returning the description, or `NULL` to use the
+ *        configured description again
+ * @param context pointer passed to `provider`
+ */
+void cap_parser_set_description_provider(
+        ArgumentParser * parser, DescriptionProvider provider, void * context) {
+    if (!parser) {
+        return;
+    }
+    parser -> mDescriptionProvider = provider;
+    parser -> mDescriptionContext = context;
+    _cap_parser_forget_texts(parser);
+}
+
+/**
+ * Sets a function which supplies the epilogue of the help message.
+ * 
+ * Like `cap_parser_set_description_provider`, but supplies the epilogue (see
+ * `cap_parser_set_epilogue`).
+ * 
+ * @param parser object to configure
+ * @param provider function returning the epilogue, or `NULL` to use the
+ *        configured epilogue again
+ * @param context pointer passed to `provider`
+ */
+void cap_parser_set_epilogue_provider(
+        ArgumentParser * parser, DescriptionProvider provider, void * context) {
+    if (!parser) {
+        return;
+    }
+    parser -> mEpilogueProvider = provider;
+    parser -> mEpilogueContext = context;
+    _cap_parser_forget_texts(parser);
+}
+
+/**
+ * Sets a function which supplies the description of a flag.
+ * 
+ * Like `cap_parser_set_description_provider`, but supplies the description of
+ * the flag with the name or alias `name`, which may also be the help flag or
+ * the flag separator. If there is no such flag, the program exits with an
+ * error.
+ * 
+ * @param parser object to configure
+ * @param name name or alias of the flag
+ * @param provider function returning the description, or `NULL` to use the
+ *        description given when the flag was added
+ * @param context pointer passed to `provider`
+ */
+void cap_parser_set_flag_description_provider(
+        ArgumentParser * parser, const char * name,
+        DescriptionProvider provider, void * context) {
+    if (!parser) {
+        return;
+    }
+    FlagInfo * flag_info = _cap_parser_find_flag(parser, name);
+    if (!flag_info) {
+        fprintf(stderr, "cap: unknown flag %s\n", name ? name : "(null)");
+        exit(-1);
+    }
+    flag_info -> mDescriptionProvider = provider;
+    flag_info -> mDescriptionContext = context;
+    _cap_parser_forget_texts(parser);
+}
+
+/**
+ * Sets a function which supplies the description of a positional argument.
+ * 
+ * Like `cap_parser_set_description_provider`, but supplies the description of
+ * the positional argument `name`. If there is no such positional, the program
+ * exits with an error.
+ * 
+ * @param parser object to configure
+ * @param name name of the positional argument
+ * @param provider function returning the description, or `NULL` to use the
+ *        description given when the positional was added
+ * @param context pointer passed to `provider`
+ */
+void cap_parser_set_positional_description_provider(
+        ArgumentParser * parser, const char * name,
+        DescriptionProvider provider, void * context) {
+    if (!parser) {
+        return;
+    }
+    size_t id;
+    if (!cap_parser_get_positional_id(parser, name, &id)) {
+        fprintf(
+            stderr, "cap: unknown positional argument %s\n",
+            name ? name : "(null)");
+        exit(-1);
+    }
+    parser -> mPositionals[id] -> mDescriptionProvider = provider;
+    parser -> mPositionals[id] -> mDescriptionContext = context;
+    _cap_parser_forget_texts(parser);
+}
+
+// ============================================================================
+// === PARSER: ADDING FLAGS ===================================================
+// ============================================================================
+
+/**
+ * Registers a flag in an argument parser.
+ * 
+ * Behaves the same as cap_parser_add_flag but returns an error code instead of
+ * exiting when an error is encountered.
+ * 
+ * Registers a new flag in `parser` under the name `flag`. The flag's name must 
+ * be unique and must be different from the flag separator (if one is 
+ * configured). Do note that, 
+ * the `cap_parser_make_default` factory returns a parser containg the default 
+ * flag separator and the default help falg '-h'. Additionally, the flag name 
+ * must begin with a flag prefix character, either the default '-' or one of 
+ * the characters previously configured using  `cap_parser_set_flag_prefix`.
+ * 
+ * The `type` parameter specifies the type of the value stored in this flag. 
+ * The type `DT_PRESENCE` should be used if a flag should not store any 
+ * explicit values (i.e. the flag's presence or absence is the only information 
+ * associated with it). For all other types the next word on the command line 
+ * is used as the flag's value. If it cannot be parsed at parse-time, the 
+ * program exits with an error message.
+ * 
+ * The `min_count` and `max_count` parameters specify the minimum and maximum 
+ * times the flag can be present on the command line. If a flag is found less 
+ * than `min_count` times or more than `max_count` times, the program exits 
+ * with an error at parse-time. This pair of parameters can be used to create 
+ * required flags, flags that may be given up to once, and similar constructs.
+ * If `max_count` is negative, the flag can be read up to any number of times.
+ * 
+ * The `metavar` parameter specifies how the value of the flag should be
+ * displayed in usage and help messages. If `NULL` is given, the flag's data 
+ * type is used instead. The `description` parameter provides a short 
+ * explanation of the flag that will be displayd in help messages automatically 
+ * generated by the  parser. If `NULL` is given, no  description is displayed.
+ * 
+ * @param parser object to create the flag in
+ * @param flag null-terminated name of the new flag, including flag prefix 
+ *        charactes (e.g. '-')
+ * @param type data type of the flag's values
+ * @param min_count minimum number of times the flag must be given on the 
+ *        command line. Must be at least zero.
+ * @param max_count maximum number of times the flag may be given on the 
+ *        command line. Must be either negative or at least `min_count`.
+ * @param metavar display name of the flag's value in help messages
+ * @param description short description of the flag's meaning to display in 
+ *        automatically generated help messages.
+ * @return error code representing the kind of error that occurs, or AFE_OK if 
+ *        a flag was added successfully
+ */
+AddFlagError cap_parser_add_flag_noexit(
+    ArgumentParser * parser, const char * flag, DataType type, 
+    int min_count, int max_count, const char * metavar,
+    const char * description) 
+{
+    if (!parser) {
+        return AFE_MISSING_PARSER;
+    }
+    if (!flag || !strlen(flag)) {
+        return AFE_MISSING_NAME;
+    }
+    if (!parser -> mIsFlagPrefix[(unsigned char) *flag]) {
+        return AFE_INVALID_PREFIX;
+    }
+    // this also checks agains the help flag and flag separator if they exist
+    if (_cap_parser_find_flag(parser, flag)) {
+        return AFE_DUPLICATE;
+    }
+    if (min_count < 0) {
+        return AFE_MIN_COUNT_NEGATIVE;
+    }
+    if (max_count >= 0 && max_count < min_count) {
+        return AFE_MAX_COUNT_VIOLATION;
+    }
+    if (min_count == 0 && max_count == 0) {
+        return AFE_MAX_COUNT_ZERO;
+    }
+    if (parser -> mFlagCount >= parser -> mFlagAlloc) {
+        size_t alloc_size = parser -> mFlagAlloc;
+        alloc_size = alloc_size ? alloc_size * 2 : 1;
+        parser -> mFlagAlloc = alloc_size;
+        parser -> mFlags = (FlagInfo **) cap_realloc(
+            parser -> mFlags, alloc_size * sizeof(FlagInfo *));
+    }
+    FlagInfo * new_flag = cap_flag_info_make(
+        flag, metavar, description, type, min_count, max_count,
+        parser -> mStaticStrings);
+    _cap_parser_index_flag(parser, new_flag, parser -> mFlagCount);
+    parser -> mFlags[parser -> mFlagCount++] = new_flag;
+    _cap_parser_forget_texts(parser);
+
+    return AFE_OK;
+}
+
+/**
+ * Registers a flag in an argument parser.
+ * 
+ * Behaves the same as cap_parser_add_flag_noexit but prints an error message 
+ * and exits the program if an error is encountered.
+ * 
+ * Registers a new flag in `parser` under the name `flag`. The flag's name must 
+ * be unique and the program exits with an error if a duplicate flag name is 
+ * given. Flag names may not be identical to the flag separator. Do note that, 
+ * the `cap_parser_make_default` factory returns a parser containg the default 
+ * flag separator and the default help falg '-h'. Additionally, the flag name 
+ * must begin with a flag prefix character, either the default '-' or one of 
+ * the characters previously configured using  `cap_parser_set_flag_prefix`.
+ * 
+ * The `type` parameter specifies the type of the value stored in this flag. 
+ * The type `DT_PRESENCE` should be used if a flag should not store any 
+ * explicit values (i.e. the flag's presence or absence is the only information 
+ * associated with it). For all other types the next word on the command line 
+ * is used as the flag's value. If it cannot be parsed at parse-time, the 
+ * program exits with an error message.
+ * 
+ * The `min_count` and `max_count` parameters specify the minimum and maximum 
+ * times the flag can be present on the command line. If a flag is found less 
+ * than `min_count` times or more than `max_count` times, the program exits 
+ * with an error at parse-time. This pair of parameters can be used to create 
+ * required flags, flags that may be given up to once, and similar constructs.
+ * If `max_count` is negative, the flag can be read up to any number of times.
+ * 
+ * The `metavar` parameter specifies how the value of the flag should be
+ * displayed in usage and help messages. If `NULL` is given, the flag's data 
+ * type is used instead. The `description` parameter provides a short 
+ * explanation of the flag that will be displayd in help messages automatically 
+ * generated by the  parser. If `NULL` is given, no  description is displayed.
+ * 
+ * @param parser object to create the flag in
+ * @param flag null-terminated name of the new flag, including flag prefix 
+ *        charactes (e.g. '-')
+ * @param type data type of the flag's values
+ * @param min_count minimum number of times the flag must be given on the 
+ *        command line. Must be at least zero.
+ * @param max_count maximum number of times the flag may be given on the 
+ *        command line. Must be either negative or at least `min_count`.
+ * @param meta_var display name of the flag's value in help messages
+ * @param description short description of the flag's meaning to display in 
+ *        automatically generated help messages.
+ * @return id of the new flag. Flags are numbered in the order in which they 
+ *         are added, starting at zero. The id can be used to access the flag 
+ *         in a `ParsedArguments` using e.g. `cap_pa_get_flag_by_id`.
+ */
+size_t cap_parser_add_flag(
+    ArgumentParser * parser, const char * flag, DataType type, 
+    int min_count, int max_count, const char * meta_var,
+    const char * description) 
+{
+    AddFlagError error = cap_parser_add_flag_noexit(
+        parser, flag, type, min_count, max_count, meta_var, description);
+    switch (error) {
+        case AFE_OK:
+            return parser -> mFlagCount - 1u;
+        case AFE_MISSING_PARSER:
+            fprintf(stderr, "cap: missing parser\n");
+            break;
+        case AFE_MISSING_NAME:
+            fprintf(stderr, "cap: missing flag name");
+            break;
+        case AFE_INVALID_PREFIX:
+            fprintf(
+                stderr, "cap: invalid flag name - must begin with one"
+                " of \"%s\"\n", parser -> mFlagPrefixChars);
+            break;
+        case AFE_DUPLICATE:
+            fprintf(stderr, "cap: duplicate flag definition %s\n", flag);
+            break;
+        case AFE_MIN_COUNT_NEGATIVE:
+            fprintf(
+                stderr, "cap: min_count requirement must not be"
+                " negative\n");
+            break;
+        case AFE_MAX_COUNT_VIOLATION:
+            fprintf(
+                stderr, "cap: max_count requirement must not be less than"
+                " min_count\n");
+            break;
+        case AFE_MAX_COUNT_ZERO:
+            fprintf(
+                stderr, "cap: min_count and max_count cannot be both zero\n");
+            break;
+        default:
+            assert(false && "unreachable in cap_parser_add_flag_noexit");
+    }
+    exit(-1);
+}
+
+/**
+ * Creates an alias for an existing flag.
+ * 
+ * Behaves the same as cap_parser_add_flag_alias but returns an error code 
+ * instead of exiting when an error is encountered.
+ * 
+ * Adds a new flag to the parser which functions as an alias for an existing 
+ * flag. When parsing, this alias is parsed the same way as the original flag,
+ * and any value parsed for the alias is stored with the original flag's name
+ * (not under the alias.)
+ * 
+ * @param parser object to configure
+ * @param name original flag name. Must be an existing flag.
+ * @param alias alias for 'name'. Must be a new, unique flag name.
+ */
+AddFlagAliasError cap_parser_add_flag_alias_noexit(
+    ArgumentParser * parser, const char * name, const char * alias) 
+{
+    if (!parser) {
+        return AFAE_MISSING_PARSER;
+    }
+    if (!name || !strlen(name)) {
+        return AFAE_MISSING_NAME;
+    }
+    if (!alias || !strlen(alias)) {
+        return AFAE_MISSING_ALIAS;
+    }
+    if (!parser -> mIsFlagPrefix[(unsigned char) *alias]) {
+        return AFAE_INVALID_PREFIX;
+    }
+    FlagInfo * fi = _cap_parser_find_flag(parser, name);
+    if (!fi) {
+        return AFAE_FLAG_DOES_NOT_EXIST;
+    }
+    if (_cap_parser_find_flag(parser, alias)) {
+        return AFAE_DUPLICATE_ALIAS;
+    }
+    size_t id;
+    cap_si_find(parser -> mFlagIndex, name, &id);
+
+    // register the alias
+    const char * alias_copy = cap_flag_info_add_alias(fi, alias);
+    cap_si_insert(parser -> mFlagIndex, alias_copy, id);
+    _cap_parser_insert_completion_name(parser, alias_copy);
+    _cap_parser_forget_texts(parser);
+    return AFAE_OK;
+}
+
+/**
+ * Creates an alias for an existing flag.
+ * 
+ * Adds a new flag to the parser which functions as an alias for an existing 
+ * flag. When parsing, this alias is parsed the same way as the original flag,
+ * and any value parsed for the alias is stored with the original flag's name
+ * (not under the alias.)
+ * 
+ * @param parser object to configure
+ * @param name original flag name. Must be an existing flag.
+ * @param alias alias for 'name'. Must be a new, unique flag name.
+ */
+void cap_parser_add_flag_alias(
+    ArgumentParser * parser, const char * name, const char * alias) 
+{
+    AddFlagAliasError error = cap_parser_add_flag_alias_noexit(
+        parser, name, alias);
+    switch (error) {
+        case AFAE_OK:
+            return;
+        case AFAE_MISSING_PARSER:
+            fprintf(stderr, "cap: missing parser\n");
+            break;
+        case AFAE_MISSING_NAME:
+            fprintf(stderr, "cap: missing flag name\n");
+            break;
+        case AFAE_MISSING_ALIAS:
+            fprintf(stderr, "cap: missing flag alias\n");
+            break;
+        case AFAE_INVALID_PREFIX:
+            fprintf(stderr, "cap: invalid flag alias prefix: must be one of"
+            " '%s'", parser -> mFlagPrefixChars);
+            break;
+        case AFAE_FLAG_DOES_NOT_EXIST:
+            fprintf(
+                stderr, "cap: flag '%s' does not exist, cannot set alias"
+                " for it\n", name);
+            break;
+        case AFAE_DUPLICATE_ALIAS:
+            fprintf(
+                stderr, "cap: cannot set alias '%s', this flag already"
+                " exists\n", alias);
+            break;
+        default:
+            assert(false && "unreachable in cap_parser_add_flag");
+    }
+    exit(-1);
+}
+
+/**
+ * Sets a flag for displaying help.
+ * 
+ * Sets a flag that makes the program immediately display help information 
+ * and exit. By default, this flag is "-h", but can be overriden using this 
+ * function.
+ * 
+ * If `name` is `NULL` and a help flag is already configured, it is removed. 
+ * If a duplicate or otherwise invalid `name` is given, the program exits with
+ * an error.
+ * 
+ * If `description` is `NULL`, a default is used. If the help flag should have
+ * no description, an empty string should be used instead.
+ * 
+ * @param parser object to configure
+ * @param name name of the custom help flag
+ * @param description description of the help flag. If it is `NULL`, a default 
+ *        is used.
+ */
+void cap_parser_set_help_flag(
+        ArgumentParser * parser, const char * name, const char * description) {
+    static const char * const DEFAULT_HELP_DESCRIPTION 
+        = "Display this help message and exit";
+
+    if (!parser) {
+        return;
+    }
+    _cap_parser_forget_texts(parser);
+    if (parser -> mHelpFlagInfo) {
+        // name is identical -> there's nothing to do
+        if (name && !strcmp(name, parser -> mHelpFlagInfo -> mName)) {
+            return;
+        }
+        // now we un-configure the existing help flag
+        _cap_parser_unindex_flag(parser, parser -> mHelpFlagInfo);
+        cap_flag_info_destroy(parser -> mHelpFlagInfo);
+        parser -> mHelpFlagInfo = NULL;
+    }
+    
+    // at this moment, the help flag is definitely not configured: either it 
+    // did not exist, or it just got removed.
+
+    // if the goal was to remove the help flag, we end here
+    if (!name) {
+        return;
+    }
+
+    if (_cap_parser_find_flag(parser, name)) {
+        fprintf(
+            stderr, "cap: cannot add help flag '%s' because an identical flag"
+            " already exists\n", name);
+        exit(-1);
+    }
+    if (!parser -> mIsFlagPrefix[(unsigned char) *name]) {
+        fprintf(stderr, "cap: invalid flag name '%s'\n", name);
+        exit(-1);
+    }
+    FlagInfo * fi = cap_flag_info_make(
+        name, NULL, description ? description : DEFAULT_HELP_DESCRIPTION,
+       	DT_PRESENCE, 0, 1, parser -> mStaticStrings);
+    parser -> mHelpFlagInfo = fi;
+    _cap_parser_index_flag(parser, fi, _CAP_HELP_FLAG_ID);
+}
+
+// ============================================================================
+// === PARSER: ADDING POSITIONALS =============================================
+// ============================================================================
+
+/**
+ * Configures a new positional argument.
+ * 
+ * Configures a new positional argument in `parser` with the name `name`. If a 
+ * positional argument with the same name already exists, returns an 
+ * appropriate error code.
+ * 
+ * The data type of the argument's value is given by the `type` parameter. If 
+ * the type `DT_PRESENCE` is used, an error code is returned. The 
+ * positional argument's type is used to parse a value at parse-time. If the 
+ * word given on the command line cannot be parsed as that type, parsing 
+ * terminates with an error.
+ * 
+ * If `required` is false, this argument will be configured as optional. 
+ * Required positionals may not be configured after any number of optional 
+ * ones. At parse-time, optional positionals may be missing on the command 
+ * line.
+ * 
+ * If `variadic` is true, this argument can take multiple values. After one 
+ * variadic argument, no other arguments may be configured. Note that, 
+ * a variadic argument can also be required. At parse-time, all available 
+ * command line words that are not flags are used as values for the variadic 
+ * argument. If it is also required, at least one such word must be found.
+ * 
+ * The `metavar` parameter specifies the display name of this argument in help 
+ * and usage messages. If `NULL` is given, the argument's `name` is used 
+ * instead. The `description` parameter specifies a short explanation of the 
+ * argument that will be displayed in help messages automatically generated by 
+ * the parser. If `NULL` is given, no description is displayed.
+ * 
+ * @param parser object to configure
+ * @param name name of the new argument
+ * @param type data type of the new argument
+ * @param required required-ness of the argument, see above for constraints
+ * @param variadic variadicity of the argument, see above for the constraints
+ * @param metavar display name for this argument in help messages
+ * @param description short description of the argument's meaning to display 
+ *        in automatically generated help messages
+ * @return TODO
+ */
+AddPositionalError cap_parser_add_positional_noexit(
+    ArgumentParser * parser, const char * name, DataType type, bool required, 
+    bool variadic, const char * metavar, const char * description)
+{
+    if (!parser) {
+        return APE_MISSING_PARSER;
+    }
+    if (!name || strlen(name) == 0) {
+        return APE_MISSING_NAME;
+    }
+    if (type == DT_PRESENCE) {
+        return APE_PRESENCE;
+    }
+    if (parser -> mSubcommandCount) {
+        return APE_SUBCOMMANDS;
+    }
+    for (size_t i = 0; i < parser -> mPositionalCount; ++i) {
+        const PositionalInfo * pi = parser -> mPositionals[i];
+        if (!strcmp(pi -> mName, name)) {
+            return APE_DUPLICATE;
+        }
+    }
+    if (parser -> mPositionalCount >= 1u) {
+        const PositionalInfo * last
+            = parser -> mPositionals[parser -> mPositionalCount - 1u];
+        if (last -> mVariadic) {
+            return APE_ANYTHING_AFTER_VARIADIC;
+        }
+        if (required && !last -> mRequired) {
+            return APE_REQUIRED_AFTER_OPTIONAL;
+        }
+    }
+    if (parser -> mPositionalCount >= parser -> mPositionalAlloc) {
+        size_t alloc_size = parser -> mPositionalAlloc;
+        alloc_size = alloc_size ? alloc_size * 2 : 1;
+        parser -> mPositionalAlloc = alloc_size;
+        parser -> mPositionals = (PositionalInfo **) cap_realloc(
+            parser -> mPositionals, alloc_size * sizeof(PositionalInfo *));
+    }
+    PositionalInfo * new_positional = cap_positional_info_make(
+	name, metavar, description, type, required, variadic,
+        parser -> mStaticStrings);
+    parser -> mPositionals[parser -> mPositionalCount++] = new_positional;
+    _cap_parser_forget_texts(parser);
+
+    return APE_OK;
+}
+
+/**
+ * Configures a new positional argument.
+ * 
+ * Configures a new positional argument in `parser` with the name `name`. If a 
+ * positional argument with the same name already exists, the program exits 
+ * with an error.
+ * 
+ * The data type of the argument's value is given by the `type` parameter. If 
+ * the type `DT_PRESENCE` is used, the program exits with an error. The 
+ * positional argument's type is used to parse a value at parse-time. If the 
+ * word given on the command line cannot be parsed as that type, parsing 
+ * terminates with an error.
+ * 
+ * If `required` is false, this argument will be configured as optional. 
+ * Required positionals may not be configured after any number of optional 
+ * ones. At parse-time, optional positionals may be missing on the command 
+ * line.
+ * 
+ * If `variadic` is true, this argument can take multiple values. After one 
+ * variadic argument, no other arguments may be configured. Note that, 
+ * a variadic argument can also be required. At parse-time, all available 
+ * command line words that are not flags are used as values for the variadic 
+ * argument. If it is also required, at least one such word must be found.
+ * 
+ * The `metavar` parameter specifies the display name of this argument in help 
+ * and usage messages. If `NULL` is given, the argument's `name` is used 
+ * instead. The `description` parameter specifies a short explanation of the 
+ * argument that will be displayed in help messages automatically generated by 
+ * the parser. If `NULL` is given, no description is displayed.
+ * 
+ * @param parser object to configure
+ * @param name name of the new argument
+ * @param type data type of the new argument
+ * @param required if the argument is required
+ * @param variadic variadicity of the argument, see above for the constraints
+ * @param metavar display name for this argument in help messages
+ * @param description short description of the argument's meaning to display 
+ *        in automatically generated help messages
+ * @return id of the new argument. Positionals are numbered in the order in 
+ *         which they are added, starting at zero. The id can be used to access
+ *         the argument in a `ParsedArguments` using e.g.
+ *         `cap_pa_get_positional_by_id`.
+ */
+size_t cap_parser_add_positional(
+    ArgumentParser * parser, const char * name, DataType type, 
+    bool required, bool variadic, const char * metavar,
+    const char * description)
+{
+    AddPositionalError error = cap_parser_add_positional_noexit(
+        parser, name, type, required, variadic, metavar, description);
+    switch (error) {
+        case APE_ANYTHING_AFTER_VARIADIC:
+            fprintf(stderr, "cap: cannot add positional after variadic\n");
+            break;
+        case APE_DUPLICATE:
+            fprintf(stderr, "cap: duplicate positional argument %s\n", name);
+            break;
+        case APE_MISSING_NAME:
+            fprintf(stderr, "cap: invalid argument name\n");
+            break;
+        case APE_MISSING_PARSER:
+            fprintf(stderr, "cap: missing parser\n");
+            break;
+        case APE_OK:
+            return parser -> mPositionalCount - 1u;
+        case APE_PRESENCE:
+            fprintf(
+                stderr, "cap: data type DT_PRESENCE is invalid for positional"
+                " arguments\n");
+            break;
+        case APE_REQUIRED_AFTER_OPTIONAL:
+            fprintf(
+                stderr, "cap: cannot add required positional after"
+                " optional\n");
+            break;
+        case APE_SUBCOMMANDS:
+            fprintf(
+                stderr, "cap: cannot add positional to a parser with"
+                " subcommands\n");
+            break;
+        default:
+            assert(false && "unreachable in cap_parser_add_positional");
+    }
+    exit(-1);
+}
+
+// ============================================================================
+// === PARSER: ADDING SUBCOMMANDS =============================================
+// ============================================================================
+
+/**
+ * Configures a new subcommand.
+ * 
+ * Configures a subcommand `name` in `parser`, like the commands of `git`
+ * (e.g. `git commit -m text`). If a subcommand with the same name already
+ * exists, returns an appropriate error code. Subcommands and positional
+ * arguments exclude each other, so if `parser` has any positionals, an error
+ * code is returned as well. The name may not begin with a flag prefix
+ * character.
+ * 
+ * At parse-time, flags of `parser` may precede the subcommand. The first word
+ * which is not a flag must be the name of a subcommand, and the words after it
+ * are parsed by the parser of the subcommand. Its name and arguments are
+ * retrieved using `cap_pa_get_subcommand` and
+ * `cap_pa_get_subcommand_arguments`. If no subcommand is given, parsing fails
+ * with `PER_MISSING_SUBCOMMAND`.
+ * 
+ * The parser of the subcommand is not created now. It is built by `builder`
+ * when the subcommand is parsed, and destroyed together with the parsed
+ * arguments, unless `cap_parser_build_subcommands` built it beforehand, in
+ * which case `parser` keeps it for all parses. Subcommands are found by their names in constant time, so
+ * the cost of parsing does not grow with the number of configured
+ * subcommands, nor with the size of the parsers of the subcommands which are
+ * not given. The parser of a subcommand starts with the options of `parser`
+ * (static and borrowed strings, exact allocation, packed values, the thread
+ * count, and the completion mode),
+ * which `builder` may change.
+ * 
+ * @param parser object to configure
+ * @param name name of the subcommand
+ * @param builder function which configures the parser of the subcommand
+ * @param context pointer passed to `builder`, may be `NULL`
+ * @param description short description of the subcommand to display in
+ *        automatically generated help messages, may be `NULL`
+ * @return `ASE_OK` on success, or the reason why the subcommand was not added
+ */
+AddSubcommandError cap_parser_add_subcommand_noexit(
+        ArgumentParser * parser, const char * name, SubparserBuilder builder,
+        void * context, const char * description) {
+    if (!parser) {
+        return ASE_MISSING_PARSER;
+    }
+    if (!name || !*name) {
+        return ASE_MISSING_NAME;
+    }
+    if (!builder) {
+        return ASE_MISSING_BUILDER;
+    }
+    if (parser -> mIsFlagPrefix[(unsigned char) *name]) {
+        return ASE_INVALID_PREFIX;
+    }
+    if (cap_si_find(parser -> mSubcommandIndex, name, NULL)) {
+        return ASE_DUPLICATE;
+    }
+    if (parser -> mPositionalCount) {
+        return ASE_POSITIONALS;
+    }
+    if (!parser -> mSubcommandIndex) {
+        parser -> mSubcommandIndex = cap_si_make_empty();
+    }
+    if (parser -> mSubcommandCount >= parser -> mSubcommandAlloc) {
+        size_t alloc_size = parser -> mSubcommandAlloc;
+        alloc_size = alloc_size ? alloc_size * 2 : 4;
+        parser -> mSubcommandAlloc = alloc_size;
+        parser -> mSubcommands = (_CapSubcommand *) cap_realloc(
+            parser -> mSubcommands, alloc_size * sizeof(_CapSubcommand));
+    }
+    _CapSubcommand * subcommand
+        = parser -> mSubcommands + parser -> mSubcommandCount;
+    const bool borrow = parser -> mStaticStrings;
+    *subcommand = (_CapSubcommand) {
+        .mName = borrow ? (char *) name : copy_string(name),
+        .mDescription = borrow
+            ? (char *) description : copy_string(description),
+        .mBuilder = builder,
+        .mContext = context,
+        .mParser = NULL,
+        .mStaticStrings = borrow
+    };
+    cap_si_insert(
+        parser -> mSubcommandIndex, subcommand -> mName,
+        parser -> mSubcommandCount++);
+    _cap_parser_insert_completion_name(parser, subcommand -> mName);
+    _cap_parser_forget_texts(parser);
+    return ASE_OK;
+}
+
+/**
+ * Configures a new subcommand.
+ * 
+ * Behaves like `cap_parser_add_subcommand_noexit`, except that the program
+ * exits with an error if the subcommand cannot be added.
+ * 
+ * ``` c
+ * static void make_commit(ArgumentParser * parser, void * context) {
+ *     cap_parser_add_flag(parser, "-m", DT_STRING, 1, 1, "TEXT", NULL);
+ * }
+ * 
+ * cap_parser_add_subcommand(
+ *     parser, "commit", make_commit, NULL, "Record changes");
+ * ```
+ * 
+ * @param parser object to configure
+ * @param name name of the subcommand
+ * @param builder function which configures the parser of the subcommand
+ * @param context pointer passed to `builder`, may be `NULL`
+ * @param description short description of the subcommand to display in
+ *        automatically generated help messages, may be `NULL`
+ * @return id of the new subcommand. Subcommands are numbered in the order in
+ *         which they are added, starting at zero.
+ */
+size_t cap_parser_add_subcommand(
+        ArgumentParser * parser, const char * name, SubparserBuilder builder,
+        void * context, const char * description) {
+    AddSubcommandError error = cap_parser_add_subcommand_noexit(
+        parser, name, builder, context, description);
+    switch (error) {
+        case ASE_OK:
+            return parser -> mSubcommandCount - 1u;
+        case ASE_MISSING_PARSER:
+            fprintf(stderr, "cap: missing parser\n");
+            break;
+        case ASE_MISSING_NAME:
+            fprintf(stderr, "cap: missing subcommand name\n");
+            break;
+        case ASE_MISSING_BUILDER:
+            fprintf(stderr, "cap: missing builder of subcommand %s\n", name);
+            break;
+        case ASE_INVALID_PREFIX:
+            fprintf(
+                stderr, "cap: subcommand %s begins with a flag prefix\n",
+                name);
+            break;
+        case ASE_DUPLICATE:
+            fprintf(stderr, "cap: duplicate subcommand %s\n", name);
+            break;
+        case ASE_POSITIONALS:
+            fprintf(
+                stderr, "cap: cannot add subcommand to a parser with"
+                " positional arguments\n");
+            break;
+        default:
+            assert(false && "unreachable in cap_parser_add_subcommand");
+    }
+    exit(-1);
+}
+
+/**
+ * Builds the parsers of all subcommands.
+ * 
+ * Runs the builders of all subcommands of `parser` which were not built yet,
+ * and of their subcommands, recursively. `parser` keeps the built parsers
+ * until it is destroyed and uses them for all later parses.
+ * 
+ * Without this call, the parser of a subcommand is built whenever the
+ * subcommand is parsed (or completed, see `cap_parser_complete`), and is
+ * destroyed together with the parsed arguments. That is cheapest for programs
+ * which parse once. A parser which parses many command lines should build its
+ * subcommands once using this function, after it is configured. Parsing never
+ * changes a parser, so building them beforehand is not needed for parsing
+ * from several threads.
+ * 
+ * @param parser parser whose subcommands to build. If it is `NULL`, this
+ *        function does nothing.
+ */
+void cap_parser_build_subcommands(ArgumentParser * parser) {
+    if (!parser) {
+        return;
+    }
+    for (size_t i = 0u; i < parser -> mSubcommandCount; ++i) {
+        _CapSubcommand * subcommand = parser -> mSubcommands + i;
+        if (!subcommand -> mParser) {
+            subcommand -> mParser = _cap_parser_build_subparser(parser, i);
+        }
+        cap_parser_build_subcommands(subcommand -> mParser);
+    }
+}
+
+// ============================================================================
+// === PARSER: IDS OF FLAGS AND POSITIONALS ===================================
+// ============================================================================
+
+/**
+ * Finds the id of a flag.
+ * 
+ * Looks up a configured flag by its name or any of its aliases and stores its 
+ * id into `*id`. This is the same id that was returned by 
+ * `cap_parser_add_flag`. The help flag and the flag separator have no ids.
+ * 
+ * @param parser object to search
+ * @param name name or alias of the flag
+ * @param id output parameter for the id of the flag
+ * @return `true` if the flag was found
+ */
+bool cap_parser_get_flag_id(
+    const ArgumentParser * parser, const char * name, size_t * id)
+{
+    size_t found;
+    if (!parser || !_cap_parser_find_flag_id(parser, name, &found)) {
+        return false;
+    }
+    if (found == _CAP_HELP_FLAG_ID || found == _CAP_FLAG_SEPARATOR_ID) {
+        return false;
+    }
+    if (id) {
+        *id = found;
+    }
+    return true;
+}
+
+/**
+ * Finds the id of a positional argument.
+ * 
+ * Looks up a configured positional argument by its name and stores its id 
+ * into `*id`. This is the same id that was returned by 
+ * `cap_parser_add_positional`.
+ * 
+ * @param parser object to search
+ * @param name name of the positional argument
+ * @param id output parameter for the id of the argument
+ * @return `true` if the argument was found
+ */
+bool cap_parser_get_positional_id(
+    const ArgumentParser * parser, const char * name, size_t * id)
+{
+    if (!parser || !name) {
+        return false;
+    }
+    for (size_t i = 0; i < parser -> mPositionalCount; ++i) {
+        if (!strcmp(parser -> mPositionals[i] -> mName, name)) {
+            if (id) {
+                *id = i;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================================================
+// === PARSER: HELP ===========================================================
+// ============================================================================
+
+/**
+ * Retrieves the program name for this parser.
+ * 
+ * Obtains the custom program name configured in `parser` or guesses the 
+ * executable's name from `argv0` if not name has been configured. If `parser`
+ * has no program name, the part of `argv0' after the right-most path separator
+ * is used. On Windows, both '\' and '/' are considered path separators.
+ * 
+ * @param parser parser object to consult
+ * @param argv0 first word on the command line
+ * @return configured or estimated program name
+ */
+const char * cap_parser_get_program_name(
+        const ArgumentParser * parser, const char * argv0) {
+    if (parser -> mProgramName) {
+        return parser -> mProgramName;
+    }
+    const char * program_name = argv0;
+    const char * slash = strrchr(argv0, '/');
+    if (slash) {
+        program_name = slash + 1;
+    }
+#ifdef _WIN32
+    const char * backslash = strrchr(argv0, '\\');
+    if (backslash && backslash > slash) {
+        program_name = backslash + 1;
+    }
+#endif
+    return program_name;
+}
+
+/**
+ * Prepares the help message and the usage string.
+ *
+ * Renders the messages which `cap_parser_print_help` and
+ * `cap_parser_print_usage` print, and keeps them in `parser` until its
+ * configuration changes, so that printing or formatting them later only
+ * copies them. Without this call, they are rendered for each print. A help
+ * message which uses description providers (see
+ * `cap_parser_set_description_provider`) is not kept, so that the providers
+ * are called for each print.
+ *
+ * Printing never changes a parser, this is the only function which fills the
+ * kept messages.
+ *
+ * @param parser parser whose messages to prepare. If it is `NULL`, this
+ *        function does nothing.
+ */
+void cap_parser_prepare_help(ArgumentParser * parser) {
+    if (!parser) {
+        return;
+    }
+    _cap_parser_forget_texts(parser);
+    // an empty message is still rendered, so that it is not `NULL`
+    _cap_parser_render_usage(parser, &(parser -> mUsageText));
+    cap_text_append(&(parser -> mUsageText), "", 0u);
+    if (!_cap_parser_has_providers(parser)) {
+        _cap_parser_render_help(parser, &(parser -> mHelpText));
+        cap_text_append(&(parser -> mHelpText), "", 0u);
+    }
+}
+
+/**
+ * Formats a usage string.
+ *
+ * Writes the usage string which `cap_parser_print_usage` prints into `buffer`,
+ * like `snprintf` does: at most `size - 1` characters are written, followed
+ * by a terminating null character. The string is rendered from the
+ * configuration for each call, unless `cap_parser_prepare_help` prepared it.
+ *
+ * @param parser parser to generate or extract the usage string from
+ * @param argv0 the first command line word, see
+ *        `cap_parser_get_program_name`
+ * @param buffer write the string here, may be `NULL` if `size` is zero
+ * @param size size of `buffer`
+ * @return length of the whole usage string, without the terminating null
+ *         character. If it is at least `size`, the string was truncated.
+ *         If `parser` is `NULL` or usage is disabled, zero is returned.
+ *
+ * @see cap_parser_print_usage
+ */
+size_t cap_parser_format_usage(
+        const ArgumentParser * parser, const char * argv0, char * buffer,
+        size_t size) {
+    size_t length = 0u;
+    if (parser && parser -> mEnableUsage && parser -> mCustomUsage) {
+        length = _cap_copy_text(
+            buffer, size, length, parser -> mCustomUsage,
+            strlen(parser -> mCustomUsage));
+        length = _cap_copy_text(buffer, size, length, "\n", 1u);
+    }
+    else if (parser && parser -> mEnableUsage) {
+        const char * program = cap_parser_get_program_name(parser, argv0);
+        TextBuffer rendered = { NULL, 0u, 0u };
+        const TextBuffer * text = _cap_parser_get_text(
+            parser, false, &rendered);
+        length = _cap_copy_text(buffer, size, length, "usage:\n\t", 8u);
+        length = _cap_copy_text(
+            buffer, size, length, program, strlen(program));
+        length = _cap_copy_text(
+            buffer, size, length, text -> mData, text -> mLength);
+        cap_free(rendered.mData);
+    }
+    if (size) {
+        buffer[length < size ? length : size - 1u] = '\0';
+    }
+    return length;
+}
+
+/**
+ * Prints a usage string.
+ * 
+ * Prints a usage string to `file` based on the flags and arguments configured
+ * in `parser`. If a flag has aliases, the shortest available name is picked.
+ * The string is written using a single call, see `cap_parser_format_usage`.
+ */
+void cap_parser_print_usage(
+        const ArgumentParser * parser, FILE * file,
+        const char * argv0) {
+    if (!parser || !file) {
+        return;
+    }
+
+    if (!parser -> mEnableUsage) {
+        return;
+    }
+    if (parser -> mCustomUsage) {
+        fprintf(file, "%s\n", parser -> mCustomUsage);
+        return;
+    }
+    TextBuffer rendered = { NULL, 0u, 0u };
+    const TextBuffer * text = _cap_parser_get_text(parser, false, &rendered);
+    fprintf(
+        file, "usage:\n\t%s%s", cap_parser_get_program_name(parser, argv0),
+        text -> mData);
+    cap_free(rendered.mData);
+}
+
+/**
+ * Formats a help message.
+ *
+ * Writes the help message which `cap_parser_print_help` prints into `buffer`,
+ * like `snprintf` does: at most `size - 1` characters are written, followed
+ * by a terminating null character. Unless a custom help message is set, the
+ * message is rendered from the configuration for each call, unless
+ * `cap_parser_prepare_help` prepared it. Description providers are therefore
+ * called for each call.
+ *
+ * @param parser parser to generate or extract the help message from
+ * @param buffer write the message here, may be `NULL` if `size` is zero
+ * @param size size of `buffer`
+ * @return length of the whole help message, without the terminating null
+ *         character. If it is at least `size`, the message was truncated.
+ *         If `parser` is `NULL` or help is disabled, zero is returned.
+ *
+ * @see cap_parser_print_help
+ */
+size_t cap_parser_format_help(
+        const ArgumentParser * parser, char * buffer, size_t size) {
+    size_t length = 0u;
+    if (parser && parser -> mEnableHelp && parser -> mCustomHelp) {
+        length = _cap_copy_text(
+            buffer, size, length, parser -> mCustomHelp,
+            strlen(parser -> mCustomHelp));
+        length = _cap_copy_text(buffer, size, length, "\n", 1u);
+    }
+    else if (parser && parser -> mEnableHelp) {
+        TextBuffer rendered = { NULL, 0u, 0u };
+        const TextBuffer * text = _cap_parser_get_text(
+            parser, true, &rendered);
+        length = _cap_copy_text(
+            buffer, size, length, text -> mData, text -> mLength);
+        cap_free(rendered.mData);
+    }
+    if (size) {
+        buffer[length < size ? length : size - 1u] = '\0';
+    }
+    return length;
+}
+
+/**
+ * Prints a help message.
+ * 
+ * Prints a help message to `file`. This message is either set explicitly using
+ * `cap_parser_set_custom_help`, or generated based on flag/argument 
+ * configuration of `parser`. The message is written using a single call, see
+ * `cap_parser_format_help`.
+ * 
+ * @param parser parser to generate or extract the help message from
+ * @param file write the message here
+ * 
+ * @see cap_parser_set_custom_help
+ * @see cap_parser_set_description
+ * @see cap_parser_set_epilogue
+ * @see cap_parser_add_flag
+ * @see cap_parser_add_positional
+ */
+void cap_parser_print_help(const ArgumentParser * parser, FILE* file) {
+    if (!parser || !file) {
+        return;
+    }
+    if (!parser -> mEnableHelp) {
+        return;
+    }
+    if (parser -> mCustomHelp) {
+        fprintf(file, "%s\n", parser -> mCustomHelp);
+        return;
+    }
+    TextBuffer rendered = { NULL, 0u, 0u };
+    const TextBuffer * text = _cap_parser_get_text(parser, true, &rendered);
+    fwrite(text -> mData, 1u, text -> mLength, file);
+    cap_free(rendered.mData);
+}
+
+// ============================================================================
+// === PARSER: SHELL COMPLETION ===============================================
+// ============================================================================
+
+/**
+ * Completes a command line word.
+ *
+ * Prints the names of flags, their aliases, and subcommands which begin with
+ * the word `argv[index]`, one per line. The words before it decide which
+ * parser completes it: a subcommand switches to the parser of the
+ * subcommand. Nothing is printed for a value of a flag, for words after the
+ * flag separator, and for positionals, so the shell can complete them as file
+ * names. If the word is empty, only the subcommands are printed.
+ *
+ * Names are looked up by their prefix in a sorted array, which the parser
+ * keeps while its completion mode is enabled (see
+ * `cap_parser_enable_completion`), otherwise they are sorted for each call.
+ * The candidates are
+ * written using a single call.
+ *
+ * @param parser parser to complete a word of
+ * @param argc number of words on the command line, including the program
+ *        name
+ * @param argv the words on the command line
+ * @param index position of the completed word in `argv`. If it is `argc`,
+ *        an empty word is completed.
+ * @param file write the candidates here
+ * @return number of printed candidates
+ *
+ * @see cap_parser_enable_completion
+ */
+size_t cap_parser_complete(
+        const ArgumentParser * parser, int argc, const char ** argv,
+        size_t index, FILE * file) {
+    if (!parser || !argv || !file || argc < 1 || index < 1u
+            || index > (size_t) argc) {
+        return 0u;
+    }
+    const ArgumentParser * current = parser;
+    // parser of the current subcommand, if it is built just for this call
+    ArgumentParser * built = NULL;
+    bool positional_only = false;
+    for (size_t i = 1u; i < index; ++i) {
+        const char * word = argv[i];
+        if (!positional_only
+                && current -> mIsFlagPrefix[(unsigned char) *word]) {
+            const FlagInfo * flag = _cap_parser_find_flag(current, word);
+            if (flag && flag == current -> mFlagSeparatorInfo) {
+                positional_only = true;
+            }
+            else if (flag && flag -> mType != DT_PRESENCE && ++i == index) {
+                // the completed word is the value of the flag
+                cap_parser_destroy(built);
+                return 0u;
+            }
+            continue;
+        }
+        if (current -> mSubcommandCount) {
+            size_t id;
+            if (!cap_si_find(current -> mSubcommandIndex, word, &id)) {
+                cap_parser_destroy(built);
+                return 0u;
+            }
+            ArgumentParser * previous = built;
+            current = _cap_parser_get_subparser(current, id, &built);
+            cap_parser_destroy(previous);
+            positional_only = false;
+        }
+    }
+    if (positional_only) {
+        cap_parser_destroy(built);
+        return 0u;
+    }
+
+    const char * prefix = index < (size_t) argc ? argv[index] : "";
+    TextBuffer text = { NULL, 0u, 0u };
+    size_t count = 0u;
+    if (!*prefix) {
+        for (size_t i = 0u; i < current -> mSubcommandCount; ++i) {
+            cap_text_append_string(&text, current -> mSubcommands[i].mName);
+            cap_text_append_char(&text, '\n');
+            ++count;
+        }
+    }
+    else {
+        // a parser whose completion mode is disabled keeps no sorted names
+        size_t name_count = current -> mCompletionNameCount;
+        const char ** sorted = current -> mEnableCompletion
+            ? NULL : _cap_parser_sort_names(current, &name_count);
+        const char * const * names = current -> mEnableCompletion
+            ? current -> mCompletionNames : sorted;
+        // the names beginning with `prefix` follow the first name which is
+        // not less than it
+        size_t low = 0u;
+        size_t high = name_count;
+        while (low < high) {
+            const size_t middle = low + (high - low) / 2u;
+            if (strcmp(names[middle], prefix) < 0) {
+                low = middle + 1u;
+            }
+            else {
+                high = middle;
+            }
+        }
+        const size_t length = strlen(prefix);
+        for (size_t i = low;
+                i < name_count && !strncmp(names[i], prefix, length); ++i) {
+            cap_text_append_string(&text, names[i]);
+            cap_text_append_char(&text, '\n');
+            ++count;
+        }
+        cap_free(sorted);
+    }
+    if (text.mLength) {
+        fwrite(text.mData, 1u, text.mLength, file);
+    }
+    cap_free(text.mData);
+    cap_parser_destroy(built);
+    return count;
+}
+
+/**
+ * Prints a shell completion script.
+ *
+ * Prints a script which makes `shell` complete the command line words of the
+ * program by running it as `PROGRAM --cap-complete INDEX WORDS...`, see
+ * `cap_parser_enable_completion`. When the program prints no candidates,
+ * the shell completes file names instead. Bash and zsh run the script when
+ * it is sourced, fish loads it from its `completions` directory.
+ *
+ * @param parser parser of the program
+ * @param shell shell which runs the script
+ * @param argv0 the first command line word, see
+ *        `cap_parser_get_program_name`
+ * @param file write the script here
+ */
+void cap_parser_print_completion_script(
+        const ArgumentParser * parser, CompletionShell shell,
+        const char * argv0, FILE * file) {
+    if (!parser || !file) {
+        return;
+    }
+    const char * program = cap_parser_get_program_name(parser, argv0);
+    // names of shell functions may only contain some characters
+    TextBuffer function = { NULL, 0u, 0u };
+    cap_text_append_string(&function, "_cap_complete_");
+    for (const char * c = program; *c; ++c) {
+        const bool valid = (*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z')
+            || (*c >= '0' && *c <= '9');
+        cap_text_append_char(&function, valid ? *c : '_');
+    }
+    const char * name = function.mData;
+    switch (shell) {
+        case CS_BASH:
+            fprintf(
+                file,
+                "%s() {\n"
+                "    local IFS=$'\\n'\n"
+                "    COMPREPLY=($(\"${COMP_WORDS[0]}\" --cap-complete"
+                " \"$COMP_CWORD\" \"${COMP_WORDS[@]}\" 2>/dev/null))\n"
+                "}\n"
+                "complete -o default -F %s '%s'\n",
+                name, name, program);
+            break;
+        case CS_ZSH:
+            fprintf(
+                file,
+                "#compdef %s\n"
+                "%s() {\n"
+                "    local -a candidates\n"
+                "    candidates=(${(f)\"$(\"${words[1]}\" --cap-complete"
+                " $((CURRENT - 1)) \"${words[@]}\" 2>/dev/null)\"})\n"
+                "    if (( ${#candidates} )); then\n"
+                "        compadd -a candidates\n"
+                "    else\n"
+                "        _files\n"
+                "    fi\n"
+                "}\n"
+                "compdef %s '%s'\n",
+                program, name, name, program);
+            break;
+        case CS_FISH:
+            fprintf(
+                file,
+                "function %s\n"
+                "    set -l words (commandline -opc)\n"
+                "    $words[1] --cap-complete (count $words) $words"
+                " (commandline -ct) 2>/dev/null\n"
+                "end\n"
+                "complete -c '%s' -a '(%s)'\n",
+                name, program, name);
+            break;
+        default:
+            break;
+    }
+    cap_free(function.mData);
+}
+
+// ============================================================================
+// === PARSER: PARSING ARGUMENTS ==============================================
+// ============================================================================
+
+/**
+ * Parse comand line arguments without exiting when an error is encountered.
+ * 
+ * Parses given command line words using the given parser. When a parsing error 
+ * occurs, parsing terminates and an appropriate result is returned. This 
+ * function should not be called directly by the user, `cap_parser_parse`
+ * should be used instead.
+ * 
+ * If the error is reported by the parser of a subcommand which was not built
+ * using `cap_parser_build_subcommands`, that parser is destroyed together with
+ * the parsed arguments, so an error word which would name one of its flags or
+ * positionals is `NULL`.
+ * 
+ * @param parser parser object to use
+ * @param argc number of command line arguments
+ * @param argv array of command line arguments
+ * @return result of the parsing, containing a `ParsedArguments` if parsing was 
+ *         successful.
+ */
+ParsingResult cap_parser_parse_noexit(
+        const ArgumentParser * parser, int argc, const char ** argv) {
+    return _cap_parser_parse_noexit(parser, argc, argv);
+}
+
+/**
+ * Parses command line arguments into an existing `ParsedArguments`.
+ * 
+ * Behaves like `cap_parser_parse_noexit`, but instead of creating a new 
+ * `ParsedArguments`, the result is stored into `args`, which is emptied first
+ * using `cap_pa_reset`. Memory owned by `args` is reused, so in a long-lived
+ * process parsing similar command lines repeatedly, this does not allocate any
+ * memory once `args` has grown large enough.
+ * 
+ * `args` may be created using `cap_pa_make_empty` or returned by an earlier 
+ * parse. It remains owned by the caller, also when an error occurs. In that
+ * case its contents are unspecified, but it can still be reused or destroyed.
+ * Response files read by the parse are owned by `args` as well, so error words
+ * taken from them stay valid until `args` is reset or destroyed.
+ * 
+ * @param parser parser object to use
+ * @param args object to store the result into
+ * @param argc number of command line arguments
+ * @param argv array of command line arguments
+ * @return result of the parsing. If parsing was successful, the result 
+ *         contains `args`.
+ */
+ParsingResult cap_parser_parse_into_noexit(
+        const ArgumentParser * parser, ParsedArguments * args, int argc,
+        const char ** argv) {
+    const size_t flag_count = parser -> mFlagCount;
+    _cap_pa_reset_reserved(args, flag_count, parser -> mPositionalCount);
+    _cap_pa_enable_packing(args, parser -> mPackValues);
+    ResponseFile * files;
+    size_t file_count;
+    ParsingResult result = _cap_parser_open_response_files(
+        parser, argc, argv, &files, &file_count);
+    if (result.mError != PER_NO_ERROR) {
+        return result;
+    }
+    _cap_pa_adopt_response_files(args, files, file_count);
+    const _CapWords words = _cap_words_make(argc, argv, files, file_count);
+    if (parser -> mExactAllocation) {
+        // the counts live in the arena until the next reset, so that the
+        // first pass does not allocate either
+        const size_t count = flag_count + parser -> mPositionalCount + 1u;
+        size_t * counts = (size_t *) cap_arena_alloc(
+            args -> mArena, count * sizeof(size_t));
+        memset(counts, 0, count * sizeof(size_t));
+        _cap_parser_count_values(
+            parser, words, counts, counts + flag_count);
+        _cap_parser_count_to_size(parser, counts, counts + flag_count);
+        _cap_pa_reserve_values(args, counts, counts + flag_count);
+    }
+    result = _cap_parser_parse_into(parser, args, words);
+    if (result.mError != PER_NO_ERROR) {
+        result.mArguments = NULL;
+    }
+    return result;
+}
+
+/**
+ * Parses command line arguments.
+ * 
+ * Parses command line words using a given parser. If a parsing error occurs, 
+ * the program exits with an error message.
+ * 
+ * On successful parsing returns a pointer to a `ParsedArguments` object 
+ * containing all parsed flags and positional arguments. The caller is the owner
+ * of this object - it can be used even after the parser is destroyed using 
+ * `cap_parser_destroy` and needs to be destroyed using `cap_pa_destroy` and a 
+ * subsequent call to `free`.
+ * 
+ * @param parser parser object to use
+ * @param argc number of command line words
+ * @param argv array of command line words
+ * @return pointer to a new `ParsedArguments` object containing information on 
+ *         parsed flags and positional arguments.
+ */
+ParsedArguments * cap_parser_parse(
+        const ArgumentParser * parser, int argc, const char ** argv) {
+    _cap_parser_check_completion(parser, argc, argv);
+    // error words may point into response files, which are released only
+    // after the error message is printed
+    ParsingResult result = _cap_parser_parse_all(parser, argc, argv);
+    return _cap_parser_finish_parsing(parser, result, argv);
+}
+
+/**
+ * Parses a command string without exiting when an error is encountered.
+ *
+ * Splits the `length` characters at `buffer` into words and parses them like
+ * `cap_parser_parse_noexit` parses command line words. This suits programs
+ * which receive commands as text, e.g. `resize --pool a --size 10` read from
+ * a socket. Unlike `argv`, the string does not start with a program name, its
+ * first word is already an argument.
+ *
+ * Words are delimited by whitespace, and quotes and backslashes are applied
+ * the same way as in response files (see @ref response_file), similar to
+ * a POSIX shell. No variables, globs, or other expansions are performed, and
+ * words `@path` are not replaced by response files.
+ *
+ * The string is split in place: quotes and backslashes are removed and each
+ * word is terminated by a null character, so that the parser reads the words
+ * straight from `buffer`, without allocating memory for them. `buffer` must
+ * therefore be writable and hold `length + 1` characters (e.g. a
+ * null-terminated string of length `length`); its contents are unspecified
+ * afterwards. Error words, and string values if borrowed strings are enabled
+ * (see `cap_parser_enable_borrowed_strings`), point into `buffer`.
+ *
+ * The command ends at the first null character if there is one among the
+ * `length` characters. If a quote is not closed, parsing fails with
+ * `PER_UNTERMINATED_QUOTE`.
+ *
+ * @param parser parser object to use
+ * @param buffer characters of the command, followed by one more writable
+ *        character
+ * @param length number of characters of the command
+ * @return result of the parsing, containing a `ParsedArguments` if parsing was
+ *         successful.
+ */
+ParsingResult cap_parser_parse_string_noexit(
+        const ArgumentParser * parser, char * buffer, size_t length) {
+    ParsingResult result = _cap_parser_parse_string(parser, buffer, length);
+    if (result.mError != PER_NO_ERROR) {
+        _cap_parser_detach_error_words(&result);
+        cap_pa_destroy(result.mArguments);
+        result.mArguments = NULL;
+    }
+    return result;
+}
+
+/**
+ * Parses a command string.
+ *
+ * Behaves like `cap_parser_parse_string_noexit`, except that when an error
+ * occurs, the program exits with an error message, or prints help and exits
+ * if the help flag is given, exactly like `cap_parser_parse`. Messages use the
+ * program name configured using `cap_parser_set_program_name`, or "command"
+ * if there is none, since a command string has no program name.
+ *
+ * @param parser parser object to use
+ * @param buffer characters of the command, followed by one more writable
+ *        character
+ * @param length number of characters of the command
+ * @return pointer to a new `ParsedArguments` object containing information on
+ *         parsed flags and positional arguments.
+ */
+ParsedArguments * cap_parser_parse_string(
+        const ArgumentParser * parser, char * buffer, size_t length) {
+    ParsingResult result = _cap_parser_parse_string(parser, buffer, length);
+    // the configured program name takes precedence over this one
+    const char * argv[1] = { _CAP_STRING_PROGRAM_NAME };
+    return _cap_parser_finish_parsing(parser, result, argv);
+}
+
+// ============================================================================
+// === PARSER: IMPLEMENTATION OF PRIVATE FUNCTIONS ============================
+// ============================================================================
+
+static ParsingResult _cap_parser_parse_noexit(
+        const ArgumentParser * parser, int argc, const char ** argv) {
+    ParsingResult result = _cap_parser_parse_all(parser, argc, argv);
+    if (result.mError != PER_NO_ERROR) {
+        _cap_parser_detach_error_words(&result);
+        cap_pa_destroy(result.mArguments);
+        result.mArguments = NULL;
+    }
+    return result;
+}
+
+static ParsingResult _cap_parser_parse_all(
+        const ArgumentParser * parser, int argc, const char ** argv) {
+    // parses into a new ParsedArguments, which is kept (in `mArguments`) also
+    // when an error occurs after the response files are opened
+    ResponseFile * files;
+    size_t file_count;
+    ParsingResult result = _cap_parser_open_response_files(
+        parser, argc, argv, &files, &file_count);
+    if (result.mError != PER_NO_ERROR) {
+        return result;
+    }
+    const _CapWords words = _cap_words_make(argc, argv, files, file_count);
+    ParsedArguments * parsed_arguments = _cap_parser_make_arguments(
+        parser, words);
+    _cap_pa_adopt_response_files(parsed_arguments, files, file_count);
+    return _cap_parser_parse_into(parser, parsed_arguments, words);
+}
+
+static ParsingResult _cap_parser_parse_string(
+        const ArgumentParser * parser, char * buffer, size_t length) {
+    // splits the command string in place, and parses its words like the
+    // words of a response file which makes up the whole command line
+    // the command ends at its first null character
+    char * words_end = buffer;
+    const char * null_char;
+    if (!_cap_rf_split_quoted(buffer, length, &words_end, &null_char)) {
+        return (ParsingResult) {
+            .mArguments = NULL,
+            .mFirstErrorWord = NULL,
+            .mSecondErrorWord = NULL,
+            .mError = PER_UNTERMINATED_QUOTE
+        };
+    }
+    const _CapWords words = (_CapWords) {
+        .mArgv = NULL,
+        .mArgc = 0,
+        .mIndex = 0,
+        .mFiles = NULL,
+        .mFileCount = 0u,
+        .mWord = buffer < words_end ? buffer : NULL,
+        .mFileEnd = buffer < words_end ? words_end : NULL
+    };
+    ParsedArguments * parsed_arguments = _cap_parser_make_arguments(
+        parser, words);
+    return _cap_parser_parse_into(parser, parsed_arguments, words);
+}
+
+static ParsingResult _cap_parser_parse_into(
+        const ArgumentParser * parser, ParsedArguments * args,
+        _CapWords words) {
+    ParsingResult result = (ParsingResult) {
+        .mArguments = args,
+        .mFirstErrorWord = NULL,
+        .mSecondErrorWord = NULL,
+        .mError = PER_NO_ERROR
+    };
+
+    _cap_parser_parse_flags_and_positionals(parser, words, &result);   
+    if (result.mError != PER_NO_ERROR) {
+	return result;
+    }
+    _cap_parser_parse_input(parser, &result);
+    if (result.mError != PER_NO_ERROR) {
+        return result;
+    }
+    
+    _cap_parser_check_flag_and_positional_counts(parser, &result);
+    return result;
+}
+
+static ParsedArguments * _cap_parser_finish_parsing(
+        const ArgumentParser * parser, ParsingResult result,
+        const char ** argv) {
+    if (result.mError == PER_NO_ERROR) {
+        return result.mArguments;
+    }
+    // an error after a subcommand is reported by the parser of the (innermost)
+    // subcommand, named by the program name and the subcommands, e.g.
+    // "git commit"
+    const char * program = *argv;
+    char * subcommand_program = NULL;
+    for (const ParsedArguments * args = result.mArguments;
+            args && args -> mSubcommand;
+            args = args -> mSubcommandArguments) {
+        size_t id;
+        cap_si_find(parser -> mSubcommandIndex, args -> mSubcommand, &id);
+        const char * name = cap_parser_get_program_name(parser, program);
+        const size_t length = strlen(name);
+        const size_t size = length + strlen(args -> mSubcommand) + 2u;
+        char * joined = (char *) cap_malloc(size);
+        snprintf(joined, size, "%s %s", name, args -> mSubcommand);
+        cap_free(subcommand_program);
+        program = subcommand_program = joined;
+        // the parser of the subcommand lives as long as `result.mArguments`
+        parser = args -> mSubparser
+            ? (const ArgumentParser *) args -> mSubparser
+            : parser -> mSubcommands[id].mParser;
+    }
+    if (result.mError == PER_HELP) {
+        cap_parser_print_usage(parser, stdout, program);
+        putchar('\n');
+        cap_parser_print_help(parser, stdout);
+        cap_free(subcommand_program);
+        cap_pa_destroy(result.mArguments);
+        exit(0);
+    }
+    fprintf(stderr, "%s: ", cap_parser_get_program_name(parser, program));
+    switch (result.mError) {
+        case PER_NOT_ENOUGH_POSITIONALS:
+            fprintf(stderr, "not enough arguments");
+            break;
+        case PER_TOO_MANY_POSITIONALS:
+            fprintf(stderr, "too many arguments");
+            break;
+        case PER_CANNOT_PARSE_POSITIONAL:
+            fprintf(
+                stderr, "cannot parse value '%s' for argument '%s'",
+	       	result.mSecondErrorWord, result.mFirstErrorWord);
+            break;
+        case PER_UNKNOWN_FLAG:
+            fprintf(stderr, "unknown flag '%s'", result.mFirstErrorWord);
+            break;
+        case PER_MISSING_FLAG_VALUE:
+            fprintf(
+                stderr, "missing value for flag '%s'", result.mFirstErrorWord);
+            break;
+        case PER_CANNOT_PARSE_FLAG:
+            fprintf(
+                stderr, "cannot parse value '%s' for flag '%s'",
+	       	result.mSecondErrorWord, result.mFirstErrorWord);
+            break;
+        case PER_NOT_ENOUGH_FLAGS:
+            fprintf(
+                stderr, "not enough instances of flag '%s'", 
+		result.mFirstErrorWord);
+            break;
+        case PER_TOO_MANY_FLAGS:
+            fprintf(
+                stderr, "too many instances of flag '%s'", 
+		result.mFirstErrorWord);
+            break;
+        case PER_POSITIONAL_OUT_OF_RANGE:
+            fprintf(
+                stderr, "value '%s' for argument '%s' is out of range",
+	       	result.mSecondErrorWord, result.mFirstErrorWord);
+            break;
+        case PER_FLAG_OUT_OF_RANGE:
+            fprintf(
+                stderr, "value '%s' for flag '%s' is out of range",
+	       	result.mSecondErrorWord, result.mFirstErrorWord);
+            break;
+        case PER_CANNOT_READ_RESPONSE_FILE:
+            fprintf(
+                stderr, "cannot read response file '%s'",
+                result.mFirstErrorWord);
+            break;
+        case PER_INVALID_RESPONSE_FILE:
+            fprintf(
+                stderr, "unterminated quote in response file '%s'",
+                result.mFirstErrorWord);
+            break;
+        case PER_CANNOT_READ_INPUT:
+            fprintf(
+                stderr, "cannot read values of argument '%s'",
+                result.mFirstErrorWord);
+            break;
+        case PER_UNTERMINATED_QUOTE:
+            fprintf(stderr, "unterminated quote");
+            break;
+        case PER_UNKNOWN_SUBCOMMAND:
+            fprintf(stderr, "unknown command '%s'", result.mFirstErrorWord);
+            break;
+        case PER_MISSING_SUBCOMMAND:
+            fprintf(stderr, "missing command");
+            break;
+        case PER_INVALID_COMPLETION_INDEX:
+            fprintf(
+                stderr, "invalid completion index '%s'",
+                result.mFirstErrorWord);
+            break;
+        case PER_HELP:
+        case PER_NO_ERROR:
+        default:
+            assert(false && "unreachable in parsing error checking");
+
+    }
+    fprintf(stderr, "\n\n");
+    cap_parser_print_usage(parser, stderr, program);
+    cap_free(subcommand_program);
+    cap_pa_destroy(result.mArguments);
+    exit(-1);
+}
+
+static WordConversionResult _cap_parse_word_as_type(
+        const char * word, DataType type, TypedUnion * uninitialized_tu) {
+    switch (type) {
+        case DT_DOUBLE: {
+            double v;
+            const WordConversionResult result = _cap_parse_double(word, &v);
+            if (result == WCR_OK) {
+                *uninitialized_tu = cap_tu_make_double(v);
+            }
+            return result;
+        }
+        case DT_INT: {
+            int v;
+            const WordConversionResult result = _cap_parse_int(word, &v);
+            if (result == WCR_OK) {
+                *uninitialized_tu = cap_tu_make_int(v);
+            }
+            return result;
+        }
+        case DT_STRING: {
+            // the string is borrowed from the command line, it is copied when
+            // the value is stored in a ParsedArguments
+            *uninitialized_tu = (TypedUnion) {
+                .mType = DT_STRING,
+                .mValue = { .asString = (char *) word }
+            };
+            return WCR_OK;
+        }
+        default:
+            break;
+    }
+    return WCR_INVALID;
+}
+
+static bool _cap_parser_find_flag_id(
+        const ArgumentParser * parser, const char * flag, size_t * id) {
+    return cap_si_find(parser -> mFlagIndex, flag, id);
+}
+
+static FlagInfo * _cap_parser_find_flag(
+        const ArgumentParser * parser, const char * flag) {
+    size_t id;
+    if (!_cap_parser_find_flag_id(parser, flag, &id)) {
+        return NULL;
+    }
+    if (id == _CAP_HELP_FLAG_ID) {
+        return parser -> mHelpFlagInfo;
+    }
+    if (id == _CAP_FLAG_SEPARATOR_ID) {
+        return parser -> mFlagSeparatorInfo;
+    }
+    return parser -> mFlags[id];
+}
+
+static void _cap_parser_index_flag(
+        ArgumentParser * parser, const FlagInfo * flag_info, size_t id) {
+    cap_si_insert(parser -> mFlagIndex, flag_info -> mName, id);
+    _cap_parser_insert_completion_name(parser, flag_info -> mName);
+    for (size_t i = 0; i < flag_info -> mAliasCount; ++i) {
+        cap_si_insert(parser -> mFlagIndex, flag_info -> mAliases[i], id);
+        _cap_parser_insert_completion_name(parser, flag_info -> mAliases[i]);
+    }
+}
+
+static void _cap_parser_unindex_flag(
+        ArgumentParser * parser, const FlagInfo * flag_info) {
+    cap_si_remove(parser -> mFlagIndex, flag_info -> mName);
+    _cap_parser_remove_completion_name(parser, flag_info -> mName);
+    for (size_t i = 0; i < flag_info -> mAliasCount; ++i) {
+        cap_si_remove(parser -> mFlagIndex, flag_info -> mAliases[i]);
+        _cap_parser_remove_completion_name(parser, flag_info -> mAliases[i]);
+    }
+}
+
+static void _cap_parser_set_string(
+        ArgumentParser * parser, char ** property, unsigned static_bit,
+        const char * value) {
+    // replaces one of the strings of the parser itself. It is released only
+    // if it is a copy, the new value is copied unless strings are static.
+    _cap_parser_forget_texts(parser);
+    if (!(parser -> mStaticProperties & static_bit)) {
+        cap_free(*property);
+    }
+    if (parser -> mStaticStrings) {
+        // borrowed strings are never modified, nor released
+        *property = (char *) value;
+        parser -> mStaticProperties |= static_bit;
+    }
+    else {
+        *property = copy_string(value);
+        parser -> mStaticProperties &= ~static_bit;
+    }
+}
+
+static void _cap_parser_index_subcommands(ArgumentParser * parser) {
+    // creates the index of subcommands which were copied from another parser,
+    // e.g. by `cap_parser_compile`
+    parser -> mSubcommandIndex = NULL;
+    if (!parser -> mSubcommandCount) {
+        return;
+    }
+    parser -> mSubcommandIndex = cap_si_make_empty();
+    cap_si_reserve(parser -> mSubcommandIndex, parser -> mSubcommandCount);
+    for (size_t i = 0u; i < parser -> mSubcommandCount; ++i) {
+        cap_si_insert(
+            parser -> mSubcommandIndex, parser -> mSubcommands[i].mName, i);
+    }
+}
+
+static ArgumentParser * _cap_parser_build_subparser(
+        const ArgumentParser * parser, size_t id) {
+    // runs the builder of a subcommand on a new parser, which starts with the
+    // options of `parser`
+    const _CapSubcommand * subcommand = parser -> mSubcommands + id;
+    ArgumentParser * subparser = cap_parser_make_default();
+    subparser -> mBorrowStrings = parser -> mBorrowStrings;
+    subparser -> mExactAllocation = parser -> mExactAllocation;
+    subparser -> mPackValues = parser -> mPackValues;
+    subparser -> mThreadCount = parser -> mThreadCount;
+    subparser -> mStaticStrings = parser -> mStaticStrings;
+    cap_parser_enable_completion(subparser, parser -> mEnableCompletion);
+    subcommand -> mBuilder(subparser, subcommand -> mContext);
+    return subparser;
+}
+
+static const ArgumentParser * _cap_parser_get_subparser(
+        const ArgumentParser * parser, size_t id, ArgumentParser ** built) {
+    // returns the parser built by `cap_parser_build_subcommands`, or builds a
+    // new one which the caller owns, and which is also stored to `built`.
+    // Parsing never changes `parser`, so it needs no lock.
+    ArgumentParser * subparser = parser -> mSubcommands[id].mParser;
+    *built = subparser ? NULL : _cap_parser_build_subparser(parser, id);
+    return subparser ? subparser : *built;
+}
+
+static void _cap_parser_release_subparser(void * parser) {
+    // destroys a parser owned by a `ParsedArguments`, see
+    // `_cap_pa_set_subcommand`
+    cap_parser_destroy((ArgumentParser *) parser);
+}
+
+static void _cap_parser_release_subparsers(ArgumentParser * parser) {
+    // destroys the parsers which were built and the index, but not the
+    // subcommands themselves
+    for (size_t i = 0u; i < parser -> mSubcommandCount; ++i) {
+        cap_parser_destroy(parser -> mSubcommands[i].mParser);
+        parser -> mSubcommands[i].mParser = NULL;
+    }
+    cap_si_destroy(parser -> mSubcommandIndex);
+    parser -> mSubcommandIndex = NULL;
+}
+
+static bool _cap_parser_has_name(
+        const ArgumentParser * parser, const char * name) {
+    // checks if `name` points to a name of a flag or a positional of
+    // `parser` (and not just to an equal string)
+    const FlagInfo * special[2] = {
+        parser -> mHelpFlagInfo, parser -> mFlagSeparatorInfo
+    };
+    for (size_t i = 0u; i < 2u; ++i) {
+        if (special[i] && special[i] -> mName == name) {
+            return true;
+        }
+    }
+    for (size_t i = 0u; i < parser -> mFlagCount; ++i) {
+        if (parser -> mFlags[i] -> mName == name) {
+            return true;
+        }
+    }
+    for (size_t i = 0u; i < parser -> mPositionalCount; ++i) {
+        if (parser -> mPositionals[i] -> mName == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void _cap_parser_init_texts(ArgumentParser * parser) {
+    // the texts are not copied, e.g. by `cap_parser_compile`, since they can
+    // be rendered again
+    parser -> mHelpText = (TextBuffer) { NULL, 0u, 0u };
+    parser -> mUsageText = (TextBuffer) { NULL, 0u, 0u };
+    parser -> mCompletionNames = NULL;
+    parser -> mCompletionNameCount = 0u;
+    parser -> mCompletionNameAlloc = 0u;
+}
+
+static void _cap_parser_forget_texts(ArgumentParser * parser) {
+    // called by every configuration function which changes the texts
+    cap_free(parser -> mHelpText.mData);
+    cap_free(parser -> mUsageText.mData);
+    parser -> mHelpText = (TextBuffer) { NULL, 0u, 0u };
+    parser -> mUsageText = (TextBuffer) { NULL, 0u, 0u };
+}
+
+static void _cap_parser_release_texts(ArgumentParser * parser) {
+    _cap_parser_forget_texts(parser);
+    cap_free(parser -> mCompletionNames);
+    parser -> mCompletionNames = NULL;
+    parser -> mCompletionNameCount = 0u;
+    parser -> mCompletionNameAlloc = 0u;
+}
+
+static const TextBuffer * _cap_parser_get_text(
+        const ArgumentParser * parser, bool help, TextBuffer * rendered) {
+    // returns the help message or the usage string prepared by
+    // `cap_parser_prepare_help`, or renders it into the empty `rendered`,
+    // which the caller releases. The parser is never changed.
+    const TextBuffer * text = help
+        ? &(parser -> mHelpText)
+        : &(parser -> mUsageText);
+    if (text -> mData) {
+        return text;
+    }
+    if (help) {
+        _cap_parser_render_help(parser, rendered);
+    }
+    else {
+        _cap_parser_render_usage(parser, rendered);
+    }
+    // an empty message is still rendered
+    cap_text_append(rendered, "", 0u);
+    return rendered;
+}
+
+static bool _cap_parser_has_providers(const ArgumentParser * parser) {
+    // checks if the help message calls any description provider
+    if (parser -> mDescriptionProvider || parser -> mEpilogueProvider) {
+        return true;
+    }
+    const FlagInfo * special[2] = {
+        parser -> mHelpFlagInfo, parser -> mFlagSeparatorInfo
+    };
+    for (size_t i = 0u; i < 2u; ++i) {
+        if (special[i] && special[i] -> mDescriptionProvider) {
+            return true;
+        }
+    }
+    for (size_t i = 0u; i < parser -> mFlagCount; ++i) {
+        if (parser -> mFlags[i] -> mDescriptionProvider) {
+            return true;
+        }
+    }
+    for (size_t i = 0u; i < parser -> mPositionalCount; ++i) {
+        if (parser -> mPositionals[i] -> mDescriptionProvider) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void _cap_parser_render_usage(
+        const ArgumentParser * parser, TextBuffer * text) {
+    // renders everything after the program name
+    if (parser -> mHelpFlagInfo) {
+        cap_text_append_string(text, " [");
+        cap_text_append_string(
+            text, _cap_get_shortest_flag_name(parser -> mHelpFlagInfo));
+        cap_text_append_char(text, ']');
+    }
+
+    for (size_t i = 0; i < parser -> mFlagCount; ++i) {
+        const FlagInfo * fi = parser -> mFlags[i];
+        cap_text_append_char(text, ' ');
+        if (fi -> mMinCount == 0) {
+            cap_text_append_char(text, '[');
+        }
+        cap_text_append_string(text, _cap_get_shortest_flag_name(fi));
+        if (fi -> mType != DT_PRESENCE) {
+            cap_text_append_char(text, ' ');
+            cap_text_append_string(text, cap_get_flag_metavar(fi));
+        }
+        if (fi -> mMinCount == 0) {
+            cap_text_append_char(text, ']');
+        }
+    }
+
+    if (parser -> mSubcommandCount) {
+        cap_text_append_string(text, " <command> ...");
+    }
+    if (parser -> mPositionalCount > 0u && parser -> mFlagSeparatorInfo) {
+        cap_text_append_string(text, " [");
+        cap_text_append_string(
+            text, _cap_get_shortest_flag_name(parser -> mFlagSeparatorInfo));
+        cap_text_append_char(text, ']');
+    }
+    size_t optionals = 0u;
+    for (size_t i = 0; i < parser -> mPositionalCount; ++i) {
+        const PositionalInfo * pi = parser -> mPositionals[i];
+        cap_text_append_char(text, ' ');
+        if (!pi -> mRequired) {
+            cap_text_append_char(text, '[');
+            ++optionals;
+        }
+        if (pi -> mMetaVar) {
+            cap_text_append_string(text, pi -> mMetaVar);
+            continue;
+        }
+        cap_text_append_char(text, '<');
+        cap_text_append_string(text, pi -> mName);
+        cap_text_append_char(text, '>');
+    }
+    for (size_t i = 0; i < optionals; ++i) {
+        cap_text_append_char(text, ']');
+    }
+    cap_text_append_char(text, '\n');
+}
+
+static void _cap_parser_render_help(
+        const ArgumentParser * parser, TextBuffer * text) {
+    const char * description = cap_describe(
+        parser -> mDescription, parser -> mDescriptionProvider,
+        parser -> mDescriptionContext);
+    if (description) {
+        cap_text_append_string(text, description);
+        cap_text_append_char(text, '\n');
+    }
+    if (parser -> mFlagCount || parser -> mHelpFlagInfo || parser -> mFlagSeparatorInfo) {
+        cap_text_append_string(text, "\nAvailable flags:\n");
+    }
+    if (parser -> mHelpFlagInfo) {
+        cap_format_flag_info(text, parser -> mHelpFlagInfo);
+    }
+    if (parser -> mFlagSeparatorInfo) {
+        cap_format_flag_info(text, parser -> mFlagSeparatorInfo);
+    }
+    for (size_t i = 0; i < parser -> mFlagCount; ++i) {
+        cap_format_flag_info(text, parser -> mFlags[i]);
+    }
+
+    if (parser -> mPositionalCount) {
+        cap_text_append_string(text, "\nPositional Arguments:\n");
+    }
+    for (size_t i = 0; i < parser -> mPositionalCount; ++i) {
+        cap_format_positional_info(text, parser -> mPositionals[i]);
+    }
+
+    if (parser -> mSubcommandCount) {
+        cap_text_append_string(text, "\nCommands:\n");
+    }
+    for (size_t i = 0; i < parser -> mSubcommandCount; ++i) {
+        const _CapSubcommand * subcommand = parser -> mSubcommands + i;
+        cap_text_append_string(text, subcommand -> mName);
+        cap_text_append_char(text, '\n');
+        if (subcommand -> mDescription) {
+            cap_text_append_char(text, '\t');
+            cap_text_append_string(text, subcommand -> mDescription);
+            cap_text_append_char(text, '\n');
+        }
+    }
+
+    const char * epilogue = cap_describe(
+        parser -> mEpilogue, parser -> mEpilogueProvider,
+        parser -> mEpilogueContext);
+    if (epilogue) {
+        cap_text_append_string(text, "\n");
+        cap_text_append_string(text, epilogue);
+        cap_text_append_char(text, '\n');
+    }
+}
+
+static size_t _cap_copy_text(
+        char * buffer, size_t size, size_t offset, const char * text,
+        size_t length) {
+    // copies as much of `text` to `buffer + offset` as fits before the
+    // terminating null character, and returns the offset after all of it
+    if (offset + 1u < size) {
+        const size_t room = size - 1u - offset;
+        memcpy(buffer + offset, text, length < room ? length : room);
+    }
+    return offset + length;
+}
+
+static const char ** _cap_parser_sort_names(
+        const ArgumentParser * parser, size_t * count) {
+    // collects the names offered by shell completion into a new array, in
+    // ascending order
+    const FlagInfo * special[2] = {
+        parser -> mHelpFlagInfo, parser -> mFlagSeparatorInfo
+    };
+    size_t name_count = parser -> mSubcommandCount;
+    for (size_t i = 0u; i < parser -> mFlagCount; ++i) {
+        name_count += 1u + parser -> mFlags[i] -> mAliasCount;
+    }
+    for (size_t i = 0u; i < 2u; ++i) {
+        name_count += special[i] ? 1u + special[i] -> mAliasCount : 0u;
+    }
+    const char ** names = name_count
+        ? (const char **) cap_malloc(name_count * sizeof(const char *))
+        : NULL;
+    size_t n = 0u;
+    for (size_t i = 0u; i < parser -> mFlagCount; ++i) {
+        const FlagInfo * flag = parser -> mFlags[i];
+        names[n++] = flag -> mName;
+        for (size_t j = 0u; j < flag -> mAliasCount; ++j) {
+            names[n++] = flag -> mAliases[j];
+        }
+    }
+    for (size_t i = 0u; i < 2u; ++i) {
+        if (!special[i]) {
+            continue;
+        }
+        names[n++] = special[i] -> mName;
+        for (size_t j = 0u; j < special[i] -> mAliasCount; ++j) {
+            names[n++] = special[i] -> mAliases[j];
+        }
+    }
+    for (size_t i = 0u; i < parser -> mSubcommandCount; ++i) {
+        names[n++] = parser -> mSubcommands[i].mName;
+    }
+    if (name_count) {
+        qsort(names, name_count, sizeof(const char *), _cap_compare_names);
+    }
+    *count = name_count;
+    return names;
+}
+
+static void _cap_parser_build_completion_names(ArgumentParser * parser) {
+    // sorts all names when the completion mode is enabled, and releases them
+    // when it is disabled
+    cap_free(parser -> mCompletionNames);
+    parser -> mCompletionNames = NULL;
+    parser -> mCompletionNameCount = 0u;
+    parser -> mCompletionNameAlloc = 0u;
+    if (parser -> mEnableCompletion) {
+        parser -> mCompletionNames = _cap_parser_sort_names(
+            parser, &(parser -> mCompletionNameCount));
+        parser -> mCompletionNameAlloc = parser -> mCompletionNameCount;
+    }
+}
+
+static void _cap_parser_insert_completion_name(
+        ArgumentParser * parser, const char * name) {
+    // keeps the names sorted while names are configured one by one
+    if (!parser -> mEnableCompletion) {
+        return;
+    }
+    const size_t count = parser -> mCompletionNameCount;
+    if (count >= parser -> mCompletionNameAlloc) {
+        size_t alloc_size = parser -> mCompletionNameAlloc;
+        alloc_size = alloc_size ? alloc_size * 2 : 8;
+        parser -> mCompletionNameAlloc = alloc_size;
+        parser -> mCompletionNames = (const char **) cap_realloc(
+            parser -> mCompletionNames, alloc_size * sizeof(const char *));
+    }
+    const char ** names = parser -> mCompletionNames;
+    size_t low = 0u;
+    size_t high = count;
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2u;
+        if (strcmp(names[middle], name) < 0) {
+            low = middle + 1u;
+        }
+        else {
+            high = middle;
+        }
+    }
+    memmove(names + low + 1u, names + low, (count - low) * sizeof(*names));
+    names[low] = name;
+    parser -> mCompletionNameCount = count + 1u;
+}
+
+static void _cap_parser_remove_completion_name(
+        ArgumentParser * parser, const char * name) {
+    // removes the very string `name`, before it is released
+    const char ** names = parser -> mCompletionNames;
+    const size_t count = parser -> mCompletionNameCount;
+    for (size_t i = 0u; i < count; ++i) {
+        if (names[i] == name) {
+            memmove(
+                names + i, names + i + 1u, (count - i - 1u) * sizeof(*names));
+            parser -> mCompletionNameCount = count - 1u;
+            return;
+        }
+    }
+}
+
+static int _cap_compare_names(const void * a, const void * b) {
+    return strcmp(*(const char * const *) a, *(const char * const *) b);
+}
+
+static void _cap_parser_check_completion(
+        const ArgumentParser * parser, int argc, const char ** argv) {
+    // handles the command line `PROGRAM --cap-complete INDEX WORDS...`
+    if (!parser || !parser -> mEnableCompletion || argc < 3
+            || strcmp(argv[1], "--cap-complete")) {
+        return;
+    }
+    char * end;
+    const unsigned long index = strtoul(argv[2], &end, 10);
+    if (*end || end == argv[2] || *argv[2] == '-') {
+        const ParsingResult result = (ParsingResult) {
+            .mArguments = NULL,
+            .mFirstErrorWord = argv[2],
+            .mSecondErrorWord = NULL,
+            .mError = PER_INVALID_COMPLETION_INDEX
+        };
+        _cap_parser_finish_parsing(parser, result, argv);
+    }
+    cap_parser_complete(parser, argc - 3, argv + 3, (size_t) index, stdout);
+    exit(0);
+}
+
+static const char * _cap_get_shortest_flag_name(const FlagInfo * flag_info) {
+    return flag_info -> mShortestName;
+}
+
+static OnePositionalParsingResult _cap_parser_parse_one_positional(
+        const ArgumentParser * parser, const char * arg, 
+        size_t positional_index) {
+    OnePositionalParsingResult res;
+    res.mPositional = NULL;
+    res.mWordsConsumed = 0;
+    res.mError = OPPE_NO_ERROR;
+     
+    if (positional_index >= parser -> mPositionalCount) {
+        res.mError = OPPE_TOO_MANY;
+        return res;
+    }
+    const PositionalInfo * posit_info 
+        = parser -> mPositionals[positional_index];
+    res.mPositional = posit_info;
+    switch (_cap_parse_word_as_type(
+            arg, posit_info -> mType, &(res.mValue))) {
+        case WCR_OK:
+            break;
+        case WCR_OUT_OF_RANGE:
+            res.mError = OPPE_OUT_OF_RANGE;
+            return res;
+        default:
+            res.mError = OPPE_CANNOT_PARSE;
+            return res;
+    }
+
+    res.mWordsConsumed = 1;
+    return res;
+}
+
+static OneFlagParsingResult _cap_parser_parse_one_flag(
+        const ArgumentParser * parser, _CapWords * words) {
+    // advances `words` past the consumed words. If the value cannot be
+    // parsed, `words` is left at it.
+    OneFlagParsingResult result;
+    result.mWordsConsumed = 0;
+    result.mError = OFPE_NO_ERROR;
+
+    const char * arg = words -> mWord;
+
+    // 1. is this a flag that exists?
+    const FlagInfo * flag_info = NULL;
+    if (_cap_parser_find_flag_id(parser, arg, &(result.mFlagId))) {
+        if (result.mFlagId == _CAP_HELP_FLAG_ID) {
+            flag_info = parser -> mHelpFlagInfo;
+        }
+        else if (result.mFlagId == _CAP_FLAG_SEPARATOR_ID) {
+            flag_info = parser -> mFlagSeparatorInfo;
+        }
+        else {
+            flag_info = parser -> mFlags[result.mFlagId];
+        }
+    }
+    result.mFlag = flag_info;
+    if (!flag_info) {  // no such flag was found
+        result.mError = OFPE_UNKNOWN_FLAG;
+       	return result;
+    }
+    // skip arg because it is being consumed right now
+    _cap_words_advance(words);
+    ++result.mWordsConsumed;
+   
+    // 3. check data type and try to parse it
+    if (flag_info -> mType == DT_PRESENCE) {
+	result.mValue = cap_tu_make_presence();
+	return result;
+    }
+    // parse the next argument according to dtype
+    const char * value_arg = words -> mWord;
+    if (!value_arg) {
+        result.mError = OFPE_MISSING_FLAG_VALUE;
+        return result;
+    }
+    // This is a bit messy but it should work.
+    // Generally, it is bad practice to use uninitialized objects.
+    // What's even funnier is, I made factory functions for typed unions
+    // but this code isn't directly using them lol.
+    switch (_cap_parse_word_as_type(
+            value_arg, flag_info -> mType, &(result.mValue))) {
+        case WCR_OK:
+            break;
+        case WCR_OUT_OF_RANGE:
+            result.mError = OFPE_FLAG_OUT_OF_RANGE;
+            return result;
+        default:
+            result.mError = OFPE_CANNOT_PARSE_FLAG;
+            return result;
+    }
+    // very important! must skip extra the word that was consumed here
+    _cap_words_advance(words);
+    ++result.mWordsConsumed;
+    return result;
+} 
+
+static bool _cap_parser_parse_numeric_run(
+        const ArgumentParser * parser, _CapWords * words,
+        size_t positional_index, bool positional_only,
+        ParsingResult * result) {
+    // converts the run of positional words starting at the current word for
+    // a variadic DT_INT or DT_DOUBLE positional at once, and advances `words`
+    // past it. Returns `false` if a word cannot be converted.
+    if (parser -> mThreadCount > 1u) {
+        // the whole run is collected, so that it can be split between
+        // threads. Its end is only known if it lies in a single buffer.
+        size_t alloc = _CAP_NUMERIC_CHUNK_SIZE;
+        size_t count = 0u;
+        const char ** run = (const char **) cap_malloc(
+            alloc * sizeof(const char *));
+        const char * limit = words -> mFileEnd;
+        while (words -> mWord
+                && (positional_only
+                    || !parser -> mIsFlagPrefix[
+                        (unsigned char) *words -> mWord])) {
+            if (count == alloc) {
+                alloc *= 2u;
+                run = (const char **) cap_realloc(
+                    run, alloc * sizeof(const char *));
+            }
+            if (words -> mFileEnd != limit) {
+                limit = NULL;
+            }
+            run[count++] = words -> mWord;
+            _cap_words_advance(words);
+        }
+        const bool stored = _cap_parser_store_numeric_words(
+            parser, positional_index, run, count, limit, result);
+        cap_free(run);
+        return stored;
+    }
+    const char * chunk[_CAP_NUMERIC_CHUNK_SIZE];
+    while (true) {
+        // a chunk ends with the buffer holding its words
+        const char * const limit = words -> mFileEnd;
+        size_t count = 0u;
+        while (words -> mWord && count < _CAP_NUMERIC_CHUNK_SIZE
+                && words -> mFileEnd == limit
+                && (positional_only
+                    || !parser -> mIsFlagPrefix[
+                        (unsigned char) *words -> mWord])) {
+            chunk[count++] = words -> mWord;
+            _cap_words_advance(words);
+        }
+        if (!count) {
+            break;
+        }
+        if (!_cap_parser_store_numeric_words(
+                parser, positional_index, chunk, count, limit, result)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool _cap_parser_store_numeric_words(
+        const ArgumentParser * parser, size_t positional_index,
+        const char * const * words, size_t count, const char * limit,
+        ParsingResult * result) {
+    // converts `words` and appends them to the values of a variadic DT_INT
+    // or DT_DOUBLE positional. Returns `false` if a word cannot be
+    // converted, the values before it are kept. `limit` is the end of the
+    // buffer holding the words, `NULL` if it is not known.
+    if (!count) {
+        return true;
+    }
+    const PositionalInfo * posit_info
+        = parser -> mPositionals[positional_index];
+    const bool is_int = posit_info -> mType == DT_INT;
+    NamedValues * slot = _cap_pa_positional_slot_at(
+        result -> mArguments, positional_index, posit_info -> mName);
+    // the values are written into the packed array of the positional
+    // if possible. Otherwise a run converted on several threads is first
+    // converted into a temporary array.
+    void * packed = _cap_nv_extend(slot, posit_info -> mType, count);
+    void * buffer = packed;
+    if (!packed && parser -> mThreadCount > 1u) {
+        buffer = cap_malloc(
+            count * (is_int ? sizeof(int) : sizeof(double)));
+    }
+    WordConversionResult conversion = WCR_OK;
+    size_t converted = 0u;
+    if (buffer && parser -> mThreadCount > 1u) {
+        converted = _cap_parse_number_batch_parallel(
+            words, count, limit, posit_info -> mType, buffer,
+            parser -> mThreadCount, &conversion);
+    }
+    else if (packed) {
+        converted = is_int
+            ? _cap_parse_int_batch(
+                words, count, limit, (int *) packed, &conversion)
+            : _cap_parse_double_batch(
+                words, count, limit, (double *) packed, &conversion);
+    }
+    if (packed) {
+        _cap_nv_commit(slot, converted);
+    }
+    else if (buffer) {
+        for (size_t i = 0u; i < converted; ++i) {
+            _cap_nv_append_value_inner(slot, is_int
+                ? cap_tu_make_int(((const int *) buffer)[i])
+                : cap_tu_make_double(((const double *) buffer)[i]));
+        }
+        cap_free(buffer);
+    }
+    union {
+        int asInts[_CAP_NUMERIC_CHUNK_SIZE];
+        double asDoubles[_CAP_NUMERIC_CHUNK_SIZE];
+    } values;
+    while (!buffer && converted < count && conversion == WCR_OK) {
+        const size_t remaining = count - converted;
+        const size_t size = remaining < _CAP_NUMERIC_CHUNK_SIZE
+            ? remaining : _CAP_NUMERIC_CHUNK_SIZE;
+        const size_t chunk_converted = is_int
+            ? _cap_parse_int_batch(
+                words + converted, size, limit, values.asInts, &conversion)
+            : _cap_parse_double_batch(
+                words + converted, size, limit, values.asDoubles,
+                &conversion);
+        for (size_t i = 0u; i < chunk_converted; ++i) {
+            _cap_nv_append_value_inner(slot, is_int
+                ? cap_tu_make_int(values.asInts[i])
+                : cap_tu_make_double(values.asDoubles[i]));
+        }
+        converted += chunk_converted;
+    }
+    if (converted < count) {
+        result -> mError = conversion == WCR_OUT_OF_RANGE
+            ? PER_POSITIONAL_OUT_OF_RANGE
+            : PER_CANNOT_PARSE_POSITIONAL;
+        result -> mFirstErrorWord = posit_info -> mName;
+        result -> mSecondErrorWord = words[converted];
+        return false;
+    }
+    return true;
+}
+
+static void _cap_parser_parse_flags_and_positionals(
+        const ArgumentParser * parser, _CapWords words,
+        ParsingResult * result) {
+    size_t positional_index = 0;
+    bool positional_only = false;
+
+    while (words.mWord) {
+        const char * arg = words.mWord;
+
+        // NB that an empty word is a positional, the terminating null is 
+        // never a flag prefix
+        if (positional_only || !parser -> mIsFlagPrefix[(unsigned char) *arg]) {
+            if (parser -> mSubcommandCount) {
+                // the remaining words belong to the subcommand
+                _cap_parser_parse_subcommand(parser, words, result);
+                return;
+            }
+            if (positional_index < parser -> mPositionalCount
+                    && parser -> mPositionals[positional_index] -> mVariadic
+                    && (parser -> mPositionals[positional_index] -> mType
+                        == DT_INT
+                        || parser -> mPositionals[positional_index] -> mType
+                        == DT_DOUBLE)) {
+                // numeric words of a variadic positional are converted in
+                // batches
+                if (!_cap_parser_parse_numeric_run(
+                        parser, &words, positional_index, positional_only,
+                        result)) {
+                    return;
+                }
+                continue;
+            }
+            // positional
+            OnePositionalParsingResult one_posit_res = 
+                _cap_parser_parse_one_positional(parser, arg, positional_index);
+            const PositionalInfo * posit_info = one_posit_res.mPositional;
+            switch (one_posit_res.mError) {
+                case OPPE_NO_ERROR:
+                    break;
+                case OPPE_TOO_MANY:
+                    result -> mError = PER_TOO_MANY_POSITIONALS;
+                    return;
+                case OPPE_CANNOT_PARSE:
+                    result -> mError = PER_CANNOT_PARSE_POSITIONAL;
+                    result -> mFirstErrorWord = posit_info -> mName;
+                    result -> mSecondErrorWord = arg;
+                    return;
+                case OPPE_OUT_OF_RANGE:
+                    result -> mError = PER_POSITIONAL_OUT_OF_RANGE;
+                    result -> mFirstErrorWord = posit_info -> mName;
+                    result -> mSecondErrorWord = arg;
+                    return;
+                default:
+                    assert(
+                        false && "unreachable in "
+                        "_cap_parser_parse_flags_and_positionals");
+            }
+            _cap_pa_append_parsed_positional_at(
+                result -> mArguments, positional_index, posit_info -> mName, 
+                one_posit_res.mValue, parser -> mBorrowStrings);
+            if (!posit_info -> mVariadic) {
+                // if the current argument is variadic, do not advance
+                // positional_index. That way more words can be consumed by
+                // this.
+                ++positional_index;
+            }
+            _cap_words_advance(&words);
+            continue;
+        }
+	
+        // try to parse a flag
+	OneFlagParsingResult one_flag_res = _cap_parser_parse_one_flag(
+            parser, &words);
+	const FlagInfo * parsed_flag = one_flag_res.mFlag;
+	switch (one_flag_res.mError) {
+	    case OFPE_NO_ERROR:
+	       	break;
+	    case OFPE_UNKNOWN_FLAG:
+            result -> mError = PER_UNKNOWN_FLAG;
+            result -> mFirstErrorWord = arg;
+            return;
+	    case OFPE_MISSING_FLAG_VALUE:
+            result -> mError = PER_MISSING_FLAG_VALUE;
+            result -> mFirstErrorWord = arg;
+            return;
+	    case OFPE_CANNOT_PARSE_FLAG:
+            result -> mError = PER_CANNOT_PARSE_FLAG;
+            result -> mFirstErrorWord = arg;
+            result -> mSecondErrorWord = words.mWord;
+            return;
+	    case OFPE_FLAG_OUT_OF_RANGE:
+            result -> mError = PER_FLAG_OUT_OF_RANGE;
+            result -> mFirstErrorWord = arg;
+            result -> mSecondErrorWord = words.mWord;
+            return;
+	    default:
+            assert(false && "unreachable in cap_parser_parse_noexit");
+	}
+        if (parsed_flag == parser -> mFlagSeparatorInfo) {
+            // switch to positional-only mode
+            positional_only = true;
+            continue;
+        }
+        if (parsed_flag == parser -> mHelpFlagInfo) {
+            result -> mError = PER_HELP;
+            return;
+        }
+        // normal flag -> enforce its maximum count right away, so that a flood
+        // of repeated flags is not accumulated before failing
+        if (parsed_flag -> mMaxCount >= 0
+                && cap_pa_flag_count_by_id(
+                    result -> mArguments, one_flag_res.mFlagId)
+                    >= (size_t) parsed_flag -> mMaxCount) {
+            result -> mError = PER_TOO_MANY_FLAGS;
+            result -> mFirstErrorWord = parsed_flag -> mName;
+            return;
+        }
+	// add its value to parsed_arguments
+	_cap_pa_add_parsed_flag_at(
+	    result -> mArguments, one_flag_res.mFlagId, parsed_flag -> mName,
+	    one_flag_res.mValue, parser -> mBorrowStrings); 
+    }
+}
+
+static void _cap_parser_parse_subcommand(
+        const ArgumentParser * parser, _CapWords words,
+        ParsingResult * result) {
+    // the current word names the subcommand, the words after it are parsed by
+    // its parser into arguments owned by `result -> mArguments`
+    const char * name = words.mWord;
+    size_t id;
+    if (!cap_si_find(parser -> mSubcommandIndex, name, &id)) {
+        result -> mError = PER_UNKNOWN_SUBCOMMAND;
+        result -> mFirstErrorWord = name;
+        return;
+    }
+    // all flags of this parser precede the subcommand, so they are checked
+    // now. Any error reported once a subcommand is stored is then an error of
+    // the subcommand.
+    FlagCountCheckResult count_check = _cap_parser_check_flag_counts(
+        parser, result -> mArguments);
+    if (count_check.mCount == TOO_FEW) {
+        result -> mError = PER_NOT_ENOUGH_FLAGS;
+        result -> mFirstErrorWord = count_check.mFlag -> mName;
+        return;
+    }
+    ArgumentParser * built;
+    const ArgumentParser * subparser = _cap_parser_get_subparser(
+        parser, id, &built);
+    _cap_words_advance(&words);
+    ParsedArguments * subcommand_args = _cap_parser_make_arguments(
+        subparser, words);
+    _cap_pa_set_subcommand(
+        result -> mArguments, name, subcommand_args, built,
+        _cap_parser_release_subparser);
+    const ParsingResult subcommand_result = _cap_parser_parse_into(
+        subparser, subcommand_args, words);
+    result -> mError = subcommand_result.mError;
+    result -> mFirstErrorWord = subcommand_result.mFirstErrorWord;
+    result -> mSecondErrorWord = subcommand_result.mSecondErrorWord;
+}
+
+static size_t _cap_parser_count_values(
+        const ArgumentParser * parser, _CapWords words, size_t * flag_counts,
+        size_t * positional_counts) {
+    // the first pass of exact allocation: classifies words exactly like
+    // _cap_parser_parse_flags_and_positionals, but does not convert values.
+    // Stops at the first word which causes an error, the second pass reports
+    // it. Returns the number of arena bytes needed for names and strings.
+    const bool copy_strings = !parser -> mBorrowStrings;
+    size_t extra_size = 0u;
+    size_t positional_index = 0;
+    bool positional_only = false;
+
+    while (words.mWord) {
+        const char * arg = words.mWord;
+        if (positional_only || !parser -> mIsFlagPrefix[(unsigned char) *arg]) {
+            if (positional_index >= parser -> mPositionalCount) {
+                if (parser -> mSubcommandCount) {
+                    // a copy of the name of the subcommand
+                    extra_size += cap_arena_footprint(strlen(arg) + 1u);
+                }
+                break;
+            }
+            const PositionalInfo * posit_info 
+                = parser -> mPositionals[positional_index];
+            if (!positional_counts[positional_index]++) {
+                extra_size += cap_arena_footprint(
+                    strlen(posit_info -> mName) + 1u);
+            }
+            if (copy_strings && posit_info -> mType == DT_STRING) {
+                extra_size += cap_arena_footprint(strlen(arg) + 1u);
+            }
+            if (!posit_info -> mVariadic) {
+                ++positional_index;
+            }
+            _cap_words_advance(&words);
+            continue;
+        }
+
+        size_t id;
+        if (!_cap_parser_find_flag_id(parser, arg, &id) 
+                || id == _CAP_HELP_FLAG_ID) {
+            break;
+        }
+        _cap_words_advance(&words);
+        if (id == _CAP_FLAG_SEPARATOR_ID) {
+            positional_only = true;
+            continue;
+        }
+        const FlagInfo * flag_info = parser -> mFlags[id];
+        if (flag_info -> mMaxCount >= 0
+                && flag_counts[id] >= (size_t) flag_info -> mMaxCount) {
+            break;
+        }
+        if (!flag_counts[id]++) {
+            extra_size += cap_arena_footprint(strlen(flag_info -> mName) + 1u);
+        }
+        if (flag_info -> mType == DT_PRESENCE) {
+            continue;
+        }
+        if (!words.mWord) {
+            break;
+        }
+        if (copy_strings && flag_info -> mType == DT_STRING) {
+            extra_size += cap_arena_footprint(strlen(words.mWord) + 1u);
+        }
+        _cap_words_advance(&words);
+    }
+    return extra_size;
+}
+
+static void _cap_parser_count_to_size(
+        const ArgumentParser * parser, size_t * flag_counts,
+        size_t * positional_counts) {
+    // replaces the numbers of values by the sizes of their storage
+    for (size_t i = 0u; i < parser -> mFlagCount; ++i) {
+        flag_counts[i] = _cap_nv_reserved_size(
+            parser -> mFlags[i] -> mType, flag_counts[i],
+            parser -> mPackValues);
+    }
+    for (size_t i = 0u; i < parser -> mPositionalCount; ++i) {
+        positional_counts[i] = _cap_nv_reserved_size(
+            parser -> mPositionals[i] -> mType, positional_counts[i],
+            parser -> mPackValues);
+    }
+}
+
+static ParsedArguments * _cap_parser_make_exact_arguments(
+        const ArgumentParser * parser, _CapWords words) {
+    const size_t flag_count = parser -> mFlagCount;
+    const size_t positional_count = parser -> mPositionalCount;
+    const size_t counts_size =
+        (flag_count + positional_count + 1u) * sizeof(size_t);
+    size_t * counts = (size_t *) cap_malloc(counts_size);
+    memset(counts, 0, counts_size);
+    const size_t extra_size = _cap_parser_count_values(
+        parser, words, counts, counts + flag_count);
+    _cap_parser_count_to_size(parser, counts, counts + flag_count);
+    ParsedArguments * parsed_arguments = _cap_pa_make_exact(
+        flag_count, counts, positional_count, counts + flag_count,
+        extra_size, parser -> mPackValues);
+    cap_free(counts);
+    return parsed_arguments;
+}
+
+static ParsedArguments * _cap_parser_make_arguments(
+        const ArgumentParser * parser, _CapWords words) {
+    // an empty object to parse `words` into
+    if (parser -> mExactAllocation) {
+        return _cap_parser_make_exact_arguments(parser, words);
+    }
+    ParsedArguments * parsed_arguments = cap_pa_make_reserved(
+        parser -> mFlagCount, parser -> mPositionalCount);
+    _cap_pa_enable_packing(parsed_arguments, parser -> mPackValues);
+    return parsed_arguments;
+}
+
+static _CapWords _cap_words_make(
+        int argc, const char * const * argv, const ResponseFile * files,
+        size_t file_count) {
+    // the cursor starts at the first word after the program name
+    _CapWords words = (_CapWords) {
+        .mArgv = argv,
+        .mArgc = argc,
+        .mIndex = 1,
+        .mFiles = files,
+        .mFileCount = file_count,
+        .mWord = NULL,
+        .mFileEnd = NULL
+    };
+    _cap_words_load(&words);
+    return words;
+}
+
+static void _cap_words_load(_CapWords * words) {
+    // makes the word at `mIndex` current, entering the response file named
+    // there. Empty files are skipped.
+    while (words -> mIndex < words -> mArgc) {
+        if (words -> mFileCount
+                && words -> mFiles -> mIndex == words -> mIndex) {
+            const ResponseFile * file = words -> mFiles++;
+            --words -> mFileCount;
+            if (file -> mData < file -> mWordsEnd) {
+                words -> mWord = file -> mData;
+                words -> mFileEnd = file -> mWordsEnd;
+                return;
+            }
+            ++words -> mIndex;
+            continue;
+        }
+        words -> mWord = words -> mArgv[words -> mIndex];
+        words -> mFileEnd = NULL;
+        return;
+    }
+    words -> mWord = NULL;
+    words -> mFileEnd = NULL;
+}
+
+static void _cap_words_advance(_CapWords * words) {
+    // words of a response file are stored one after another, each followed
+    // by a null character
+    if (words -> mFileEnd) {
+        words -> mWord += strlen(words -> mWord) + 1u;
+        if (words -> mWord < words -> mFileEnd) {
+            return;
+        }
+    }
+    ++words -> mIndex;
+    _cap_words_load(words);
+}
+
+static ParsingResult _cap_parser_open_response_files(
+        const ArgumentParser * parser, int argc, const char * const * argv,
+        ResponseFile ** files, size_t * file_count) {
+    // opens the response files named before the flag separator. On success,
+    // `files` is an array allocated using `cap_malloc` (or `NULL`), ordered
+    // by position on the command line.
+    ParsingResult result = (ParsingResult) {
+        .mArguments = NULL,
+        .mFirstErrorWord = NULL,
+        .mSecondErrorWord = NULL,
+        .mError = PER_NO_ERROR
+    };
+    *files = NULL;
+    *file_count = 0u;
+    if (!parser -> mExpandResponseFiles) {
+        return result;
+    }
+    size_t alloc = 0u;
+    for (int i = 1; i < argc; ++i) {
+        const char * arg = argv[i];
+        size_t id;
+        if (parser -> mIsFlagPrefix[(unsigned char) *arg]
+                && _cap_parser_find_flag_id(parser, arg, &id)
+                && id == _CAP_FLAG_SEPARATOR_ID) {
+            break;
+        }
+        if (arg[0] != '@' || !arg[1]) {
+            continue;
+        }
+        if (*file_count == alloc) {
+            alloc = alloc ? 2u * alloc : 4u;
+            *files = (ResponseFile *) (*files
+                ? cap_realloc(*files, alloc * sizeof(ResponseFile))
+                : cap_malloc(alloc * sizeof(ResponseFile)));
+        }
+        const ResponseFileError error = _cap_rf_open(
+            *files + *file_count, arg, i);
+        if (error != RFE_NO_ERROR) {
+            for (size_t j = 0u; j < *file_count; ++j) {
+                _cap_rf_close(*files + j);
+            }
+            cap_free(*files);
+            *files = NULL;
+            *file_count = 0u;
+            result.mError = error == RFE_CANNOT_READ
+                ? PER_CANNOT_READ_RESPONSE_FILE
+                : PER_INVALID_RESPONSE_FILE;
+            result.mFirstErrorWord = arg + 1;
+            return result;
+        }
+        ++*file_count;
+    }
+    return result;
+}
+
+static void _cap_parser_detach_error_words(ParsingResult * result) {
+    // error words read from a response file become invalid when the file is
+    // released, they are replaced by the argument which named the file.
+    // Names in a parser built just for this parse are released with it, so
+    // there is nothing to replace them with.
+    for (const ParsedArguments * args = result -> mArguments; args;
+            args = args -> mSubcommandArguments) {
+        const ArgumentParser * subparser
+            = (const ArgumentParser *) args -> mSubparser;
+        if (subparser && _cap_parser_has_name(
+                subparser, result -> mFirstErrorWord)) {
+            result -> mFirstErrorWord = NULL;
+        }
+        for (size_t i = 0u; i < args -> mResponseFileCount; ++i) {
+            const ResponseFile * file = args -> mResponseFiles + i;
+            if (_cap_rf_contains(file, result -> mFirstErrorWord)) {
+                result -> mFirstErrorWord = file -> mArgument;
+            }
+            if (_cap_rf_contains(file, result -> mSecondErrorWord)) {
+                result -> mSecondErrorWord = file -> mArgument;
+            }
+        }
+    }
+}
+
+static void _cap_input_init(_CapInput * input, int fd, char delimiter) {
+    *input = (_CapInput) {
+        .mFd = fd,
+        .mDelimiter = delimiter,
+        .mBuffer = (char *) cap_malloc(_CAP_INPUT_CHUNK_SIZE + 1u),
+        .mSize = _CAP_INPUT_CHUNK_SIZE,
+        .mUsed = 0u,
+        .mConsumed = 0u,
+        .mEnd = false,
+        .mFailed = false
+    };
+}
+
+static bool _cap_input_next(_CapInput * input, _CapWords * words) {
+    // reads the next complete records, and makes `words` a cursor over them.
+    // Records handed out before are overwritten. Returns `false` at the end
+    // of the input, or if it cannot be read (then `mFailed` is set).
+    char * buffer = input -> mBuffer;
+    if (input -> mConsumed) {
+        input -> mUsed -= input -> mConsumed;
+        memmove(buffer, buffer + input -> mConsumed, input -> mUsed);
+        input -> mConsumed = 0u;
+    }
+    size_t complete;
+    while (true) {
+        if (input -> mEnd) {
+            // the last record does not need a delimiter
+            if (!input -> mUsed) {
+                return false;
+            }
+            buffer[input -> mUsed] = input -> mDelimiter;
+            complete = input -> mUsed + 1u;
+            break;
+        }
+        if (input -> mUsed == input -> mSize) {
+            // a single record does not fit
+            input -> mSize *= 2u;
+            buffer = (char *) cap_realloc(buffer, input -> mSize + 1u);
+            input -> mBuffer = buffer;
+        }
+        const long read_size = _cap_rf_read_fd(
+            input -> mFd, buffer + input -> mUsed,
+            input -> mSize - input -> mUsed);
+        if (read_size < 0) {
+            input -> mFailed = true;
+            return false;
+        }
+        if (!read_size) {
+            input -> mEnd = true;
+            continue;
+        }
+        // the data before `start` holds no delimiter
+        const size_t start = input -> mUsed;
+        input -> mUsed += (size_t) read_size;
+        complete = input -> mUsed;
+        while (complete > start
+                && buffer[complete - 1u] != input -> mDelimiter) {
+            --complete;
+        }
+        if (complete > start) {
+            break;
+        }
+    }
+    if (input -> mDelimiter) {
+        for (char * c = buffer; (c = (char *) memchr(
+                c, input -> mDelimiter, (size_t) (buffer + complete - c)));
+                ++c) {
+            *c = '\0';
+        }
+    }
+    input -> mConsumed = input -> mEnd ? input -> mUsed : complete;
+    *words = (_CapWords) {
+        .mArgv = NULL,
+        .mArgc = 0,
+        .mIndex = 0,
+        .mFiles = NULL,
+        .mFileCount = 0u,
+        .mWord = buffer,
+        .mFileEnd = buffer + complete
+    };
+    return true;
+}
+
+static char * _cap_input_detach(_CapInput * input) {
+    // hands the records read last over to the caller (to be released using
+    // `cap_free`), so that they are not overwritten
+    char * records = input -> mBuffer;
+    input -> mBuffer = (char *) cap_malloc(input -> mSize + 1u);
+    input -> mUsed -= input -> mConsumed;
+    memcpy(input -> mBuffer, records + input -> mConsumed, input -> mUsed);
+    input -> mConsumed = 0u;
+    return records;
+}
+
+static void _cap_input_destroy(_CapInput * input) {
+    cap_free(input -> mBuffer);
+    input -> mBuffer = NULL;
+}
+
+static void _cap_parser_parse_input(
+        const ArgumentParser * parser, ParsingResult * result) {
+    // appends the records read from the input of a positional to its values.
+    // If strings are borrowed, or an error word points into the records,
+    // they are kept by the ParsedArguments.
+    if (parser -> mInputFd < 0 || result -> mError != PER_NO_ERROR) {
+        return;
+    }
+    const size_t positional_index = parser -> mInputPositional;
+    const PositionalInfo * posit_info
+        = parser -> mPositionals[positional_index];
+    const bool numeric = posit_info -> mType == DT_INT
+        || posit_info -> mType == DT_DOUBLE;
+    _CapInput input;
+    _cap_input_init(&input, parser -> mInputFd, parser -> mInputDelimiter);
+    _CapWords words;
+    while (result -> mError == PER_NO_ERROR
+            && _cap_input_next(&input, &words)) {
+        const char * const records_end = words.mFileEnd;
+        if (numeric) {
+            _cap_parser_parse_numeric_run(
+                parser, &words, positional_index, true, result);
+        }
+        for (; !numeric && words.mWord; _cap_words_advance(&words)) {
+            OnePositionalParsingResult one_posit_res
+                = _cap_parser_parse_one_positional(
+                    parser, words.mWord, positional_index);
+            if (one_posit_res.mError != OPPE_NO_ERROR) {
+                result -> mError = one_posit_res.mError == OPPE_OUT_OF_RANGE
+                    ? PER_POSITIONAL_OUT_OF_RANGE
+                    : PER_CANNOT_PARSE_POSITIONAL;
+                result -> mFirstErrorWord = posit_info -> mName;
+                result -> mSecondErrorWord = words.mWord;
+                break;
+            }
+            _cap_pa_append_parsed_positional_at(
+                result -> mArguments, positional_index, posit_info -> mName,
+                one_posit_res.mValue, parser -> mBorrowStrings);
+        }
+        if (result -> mError != PER_NO_ERROR
+                || (posit_info -> mType == DT_STRING
+                    && parser -> mBorrowStrings)) {
+            _cap_pa_add_response_file(result -> mArguments, (ResponseFile) {
+                .mArgument = _CAP_INPUT_ERROR_WORD,
+                .mIndex = 0,
+                .mData = _cap_input_detach(&input),
+                .mWordsEnd = records_end,
+                .mMapSize = 0u
+            });
+        }
+    }
+    if (input.mFailed) {
+        result -> mError = PER_CANNOT_READ_INPUT;
+        result -> mFirstErrorWord = posit_info -> mName;
+    }
+    _cap_input_destroy(&input);
+}
+
+static FlagCountCheckResult _cap_parser_check_flag_counts(
+        const ArgumentParser * parser,
+       	const ParsedArguments * parsed_arguments) {
+    
+    // check min count requirements for flags (max counts are enforced while
+    // parsing). Values of each flag are stored in the slot given by its id, so
+    // the number of values is also its occurrence counter.
+    for (size_t i = 0; i < parser -> mFlagCount; ++i) {
+        const FlagInfo * flag_info = parser -> mFlags[i];
+        size_t real_count = cap_pa_flag_count_by_id(parsed_arguments, i);
+        if (real_count < (unsigned int) flag_info -> mMinCount) {
+	    return (FlagCountCheckResult) {
+		.mFlag = flag_info,
+		.mCount = TOO_FEW
+	    };
+        }
+    }
+    return (FlagCountCheckResult) {
+	.mFlag = NULL,
+	.mCount = GOOD
+    };
+}
+
+static void _cap_parser_check_flag_and_positional_counts(
+        const ArgumentParser * parser, ParsingResult * result) {
+    // positional argument presence is checked here
+    //
+    // positionals are parsed in order, so it is enough to find the first one
+    // that was not parsed (NB that a case of too-many-arguments is caught
+    // when actually parsing). If it is required, fail.
+    size_t p_count = 0u;
+    while (p_count < parser -> mPositionalCount
+            && cap_pa_has_positional_by_id(result -> mArguments, p_count)) {
+        ++p_count;
+    }
+    if (p_count < parser -> mPositionalCount) {
+        const PositionalInfo * first_not_parsed = parser -> mPositionals[p_count];
+        if (first_not_parsed -> mRequired) {
+            result -> mError = PER_NOT_ENOUGH_POSITIONALS;
+            return;
+        }
+    }
+    // required flag counts are checked using another function because we also
+    // want to know the name of the flag
+    FlagCountCheckResult count_check = _cap_parser_check_flag_counts(
+        parser, result -> mArguments);
+    switch (count_check.mCount) {
+	case GOOD:
+	    break;
+	case TOO_FEW:
+            result -> mError = PER_NOT_ENOUGH_FLAGS;
+	    result -> mFirstErrorWord = count_check.mFlag -> mName;
+	    return; 
+	default:
+	    assert(false && "unreachable in cap_parser_parse_noexit");
+    }
+    if (parser -> mSubcommandCount
+            && !cap_pa_get_subcommand(result -> mArguments)) {
+        result -> mError = PER_MISSING_SUBCOMMAND;
+    }
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @file
+ * @addtogroup parser
+ *
+ * A `CompiledParser` is an immutable, self-contained snapshot of a configured
+ * `ArgumentParser`. It is created using `cap_parser_compile` once
+ * configuration-time is over, and can then be used to parse command lines any
+ * number of times using `cap_compiled_parser_parse` or
+ * `cap_compiled_parser_parse_noexit`.
+ *
+ * All data of a compiled parser (configured flags and positionals, their
+ * names, aliases, and descriptions, and the flag prefix table) is stored in
+ * a single contiguous block of memory, together with a prepared lookup index
+ * of flag names. A compiled parser is independent of the parser it was
+ * created from, so the original parser can be destroyed or reconfigured
+ * afterwards without affecting it. Everything parsing and printing could
+ * need is prepared by `cap_parser_compile`: the parsers of all subcommands
+ * (see `cap_parser_add_subcommand`) are built recursively, and help and usage
+ * messages are rendered (see `cap_parser_prepare_help`). A compiled parser is
+ * therefore never modified after creation, and a single compiled parser can
+ * be used by several threads at the same time.
+ *
+ * A compiled parser should be disposed of using `cap_compiled_parser_destroy`.
+ * `ParsedArguments` objects created by it are independent of it, just as if
+ * they were created by an `ArgumentParser`.
+ */
+
+/**
+ * @addtogroup parser
+ * @{
+ */
+
+// ============================================================================
+// === COMPILED PARSER ========================================================
+// ============================================================================
+
+/**
+ * Immutable snapshot of a configured `ArgumentParser`.
+ *
+ * Objects of this type are created using `cap_parser_compile` and destroyed
+ * using `cap_compiled_parser_destroy`. Their members should never be accessed
+ * or modified directly.
+ *
+ * @see cap_parser_compile
+ * @see cap_compiled_parser_parse
+ * @see cap_compiled_parser_destroy
+ */
+typedef struct {
+    /// Copy of the original configuration. All of its flags, positionals,
+    /// and strings point into the memory block which also stores this object.
+    /// Only the flag index, the index of subcommands, their built parsers,
+    /// rendered messages, and sorted completion names are allocated
+    /// separately.
+    ArgumentParser mParser;
+} CompiledParser;
+
+// ============================================================================
+// === COMPILED PARSER: DECLARATION OF PRIVATE FUNCTIONS ======================
+// ============================================================================
+
+static size_t _cap_compiled_string_size(const char * string);
+static size_t _cap_compiled_flag_string_size(const FlagInfo * info);
+static void * _cap_compiled_take(char ** cursor, size_t size);
+static char * _cap_compiled_copy_string(char ** cursor, const char * string);
+static void _cap_compiled_copy_flag(
+    FlagInfo * dst, const FlagInfo * src, char *** alias_cursor,
+    char ** string_cursor);
+static void _cap_compiled_prepare_help(ArgumentParser * parser);
+
+// ============================================================================
+// === COMPILED PARSER: CREATION AND DESTRUCTION ==============================
+// ============================================================================
+
+/**
+ * Compiles a configured parser.
+ *
+ * Creates an immutable snapshot of `parser`, which can be used for parsing
+ * instead of the original. The snapshot copies all configuration, so it is
+ * not affected by later changes to `parser`, nor by destroying it. The caller
+ * becomes the owner of the new object and should dispose of it using
+ * `cap_compiled_parser_destroy`.
+ *
+ * The builders of all subcommands, and of their subcommands, are run now
+ * (see `cap_parser_build_subcommands`), and the help messages and usage
+ * strings of all these parsers are rendered. Only help messages which use
+ * description providers are still rendered for each print.
+ *
+ * @param parser configured parser to compile
+ * @return new compiled parser, or `NULL` if `parser` is `NULL`
+ */
+CompiledParser * cap_parser_compile(const ArgumentParser * parser) {
+    if (!parser) {
+        return NULL;
+    }
+    const size_t flag_count = parser -> mFlagCount;
+    const size_t positional_count = parser -> mPositionalCount;
+    const size_t subcommand_count = parser -> mSubcommandCount;
+    const size_t special_count = (parser -> mHelpFlagInfo ? 1u : 0u)
+        + (parser -> mFlagSeparatorInfo ? 1u : 0u);
+
+    // measure everything so that a single allocation is enough
+    size_t alias_count = 0u;
+    size_t string_size = _cap_compiled_string_size(parser -> mProgramName)
+        + _cap_compiled_string_size(parser -> mDescription)
+        + _cap_compiled_string_size(parser -> mEpilogue)
+        + _cap_compiled_string_size(parser -> mCustomHelp)
+        + _cap_compiled_string_size(parser -> mCustomUsage)
+        + _cap_compiled_string_size(parser -> mFlagPrefixChars);
+    for (size_t i = 0u; i < flag_count; ++i) {
+        alias_count += parser -> mFlags[i] -> mAliasCount;
+        string_size += _cap_compiled_flag_string_size(parser -> mFlags[i]);
+    }
+    if (parser -> mHelpFlagInfo) {
+        alias_count += parser -> mHelpFlagInfo -> mAliasCount;
+        string_size += _cap_compiled_flag_string_size(parser -> mHelpFlagInfo);
+    }
+    if (parser -> mFlagSeparatorInfo) {
+        alias_count += parser -> mFlagSeparatorInfo -> mAliasCount;
+        string_size += _cap_compiled_flag_string_size(
+            parser -> mFlagSeparatorInfo);
+    }
+    for (size_t i = 0u; i < positional_count; ++i) {
+        const PositionalInfo * pi = parser -> mPositionals[i];
+        string_size += _cap_compiled_string_size(pi -> mName)
+            + _cap_compiled_string_size(pi -> mMetaVar)
+            + _cap_compiled_string_size(pi -> mDescription);
+    }
+    for (size_t i = 0u; i < subcommand_count; ++i) {
+        const _CapSubcommand * sc = parser -> mSubcommands + i;
+        string_size += _cap_compiled_string_size(sc -> mName)
+            + _cap_compiled_string_size(sc -> mDescription);
+    }
+
+    // all types stored before the strings have sizes that are multiples of
+    // their alignment, so carving them in this order keeps them aligned
+    const size_t block_size = sizeof(CompiledParser)
+        + (flag_count + special_count) * sizeof(FlagInfo)
+        + flag_count * sizeof(FlagInfo *)
+        + positional_count * sizeof(PositionalInfo)
+        + positional_count * sizeof(PositionalInfo *)
+        + subcommand_count * sizeof(_CapSubcommand)
+        + alias_count * sizeof(char *)
+        + string_size;
+    char * cursor = (char *) cap_malloc(block_size);
+    CompiledParser * cp = (CompiledParser *) _cap_compiled_take(
+        &cursor, sizeof(CompiledParser));
+    FlagInfo * flags = (FlagInfo *) _cap_compiled_take(
+        &cursor, (flag_count + special_count) * sizeof(FlagInfo));
+    FlagInfo ** flag_pointers = (FlagInfo **) _cap_compiled_take(
+        &cursor, flag_count * sizeof(FlagInfo *));
+    PositionalInfo * positionals = (PositionalInfo *) _cap_compiled_take(
+        &cursor, positional_count * sizeof(PositionalInfo));
+    PositionalInfo ** positional_pointers = (PositionalInfo **)
+        _cap_compiled_take(&cursor, positional_count * sizeof(PositionalInfo *));
+    _CapSubcommand * subcommands = (_CapSubcommand *) _cap_compiled_take(
+        &cursor, subcommand_count * sizeof(_CapSubcommand));
+    char ** aliases = (char **) _cap_compiled_take(
+        &cursor, alias_count * sizeof(char *));
+
+    ArgumentParser * p = &(cp -> mParser);
+    *p = *parser;
+    // the sorted names are not shared, they are sorted once all names are
+    // copied
+    _cap_parser_init_texts(p);
+    p -> mEnableCompletion = false;
+    p -> mProgramName = _cap_compiled_copy_string(
+        &cursor, parser -> mProgramName);
+    p -> mDescription = _cap_compiled_copy_string(
+        &cursor, parser -> mDescription);
+    p -> mEpilogue = _cap_compiled_copy_string(&cursor, parser -> mEpilogue);
+    p -> mCustomHelp = _cap_compiled_copy_string(
+        &cursor, parser -> mCustomHelp);
+    p -> mCustomUsage = _cap_compiled_copy_string(
+        &cursor, parser -> mCustomUsage);
+    p -> mFlagPrefixChars = _cap_compiled_copy_string(
+        &cursor, parser -> mFlagPrefixChars);
+    p -> mFlagIndex = cap_si_make_empty();
+
+    p -> mFlags = flag_pointers;
+    p -> mFlagAlloc = flag_count;
+    for (size_t i = 0u; i < flag_count; ++i) {
+        _cap_compiled_copy_flag(
+            flags + i, parser -> mFlags[i], &aliases, &cursor);
+        flag_pointers[i] = flags + i;
+        _cap_parser_index_flag(p, flags + i, i);
+    }
+    FlagInfo * special = flags + flag_count;
+    if (parser -> mHelpFlagInfo) {
+        _cap_compiled_copy_flag(
+            special, parser -> mHelpFlagInfo, &aliases, &cursor);
+        p -> mHelpFlagInfo = special++;
+        _cap_parser_index_flag(p, p -> mHelpFlagInfo, _CAP_HELP_FLAG_ID);
+    }
+    if (parser -> mFlagSeparatorInfo) {
+        _cap_compiled_copy_flag(
+            special, parser -> mFlagSeparatorInfo, &aliases, &cursor);
+        p -> mFlagSeparatorInfo = special++;
+        _cap_parser_index_flag(
+            p, p -> mFlagSeparatorInfo, _CAP_FLAG_SEPARATOR_ID);
+    }
+
+    p -> mPositionals = positional_pointers;
+    p -> mPositionalAlloc = positional_count;
+    for (size_t i = 0u; i < positional_count; ++i) {
+        const PositionalInfo * src = parser -> mPositionals[i];
+        PositionalInfo * dst = positionals + i;
+        *dst = *src;
+        dst -> mName = _cap_compiled_copy_string(&cursor, src -> mName);
+        dst -> mMetaVar = _cap_compiled_copy_string(&cursor, src -> mMetaVar);
+        dst -> mDescription = _cap_compiled_copy_string(
+            &cursor, src -> mDescription);
+        positional_pointers[i] = dst;
+    }
+
+    // parsers of subcommands are built again, for the compiled parser alone
+    p -> mSubcommands = subcommands;
+    p -> mSubcommandAlloc = subcommand_count;
+    for (size_t i = 0u; i < subcommand_count; ++i) {
+        const _CapSubcommand * src = parser -> mSubcommands + i;
+        subcommands[i] = *src;
+        subcommands[i].mName = _cap_compiled_copy_string(&cursor, src -> mName);
+        subcommands[i].mDescription = _cap_compiled_copy_string(
+            &cursor, src -> mDescription);
+        subcommands[i].mParser = NULL;
+    }
+    _cap_parser_index_subcommands(p);
+    cap_parser_enable_completion(p, parser -> mEnableCompletion);
+    cap_parser_build_subcommands(p);
+    _cap_compiled_prepare_help(p);
+    return cp;
+}
+
+/**
+ * Destroys a `CompiledParser` object.
+ *
+ * `ParsedArguments` created using the compiled parser are not affected.
+ *
+ * @param compiled object to destroy. If it is `NULL`, nothing happens.
+ */
+void cap_compiled_parser_destroy(CompiledParser * compiled) {
+    if (!compiled) {
+        return;
+    }
+    cap_si_destroy(compiled -> mParser.mFlagIndex);
+    _cap_parser_release_subparsers(&(compiled -> mParser));
+    _cap_parser_release_texts(&(compiled -> mParser));
+    // everything else lives in the same block as the object itself
+    cap_free(compiled);
+}
+
+// ============================================================================
+// === COMPILED PARSER: IDS OF FLAGS AND POSITIONALS ==========================
+// ============================================================================
+
+/**
+ * Finds the id of a flag.
+ *
+ * Ids are the same as in the parser from which `compiled` was created.
+ *
+ * @see cap_parser_get_flag_id
+ */
+bool cap_compiled_parser_get_flag_id(
+        const CompiledParser * compiled, const char * name, size_t * id) {
+    if (!compiled) {
+        return false;
+    }
+    return cap_parser_get_flag_id(&(compiled -> mParser), name, id);
+}
+
+/**
+ * Finds the id of a positional argument.
+ *
+ * Ids are the same as in the parser from which `compiled` was created.
+ *
+ * @see cap_parser_get_positional_id
+ */
+bool cap_compiled_parser_get_positional_id(
+        const CompiledParser * compiled, const char * name, size_t * id) {
+    if (!compiled) {
+        return false;
+    }
+    return cap_parser_get_positional_id(&(compiled -> mParser), name, id);
+}
+
+// ============================================================================
+// === COMPILED PARSER: PARSING AND HELP ======================================
+// ============================================================================
+
+/**
+ * Parses command line arguments without exiting on error.
+ *
+ * Behaves exactly like `cap_parser_parse_noexit` called with the parser from
+ * which `compiled` was created (at the time of compilation).
+ *
+ * @param compiled compiled parser to use
+ * @param argc number of command line arguments
+ * @param argv array of command line arguments
+ * @return result of the parsing, containing a `ParsedArguments` if parsing was
+ *         successful.
+ */
+ParsingResult cap_compiled_parser_parse_noexit(
+        const CompiledParser * compiled, int argc, const char ** argv) {
+    return _cap_parser_parse_noexit(&(compiled -> mParser), argc, argv);
+}
+
+/**
+ * Parses command line arguments into an existing `ParsedArguments`.
+ *
+ * Behaves exactly like `cap_parser_parse_into_noexit` called with the parser
+ * from which `compiled` was created (at the time of compilation).
+ *
+ * @param compiled compiled parser to use
+ * @param args object to store the result into
+ * @param argc number of command line arguments
+ * @param argv array of command line arguments
+ * @return result of the parsing. If parsing was successful, the result
+ *         contains `args`.
+ */
+ParsingResult cap_compiled_parser_parse_into_noexit(
+        const CompiledParser * compiled, ParsedArguments * args, int argc,
+        const char ** argv) {
+    return cap_parser_parse_into_noexit(
+        &(compiled -> mParser), args, argc, argv);
+}
+
+/**
+ * Parses command line arguments.
+ *
+ * Behaves exactly like `cap_parser_parse` called with the parser from which
+ * `compiled` was created (at the time of compilation). On error, the program
+ * exits with an error message.
+ *
+ * @param compiled compiled parser to use
+ * @param argc number of command line words
+ * @param argv array of command line words
+ * @return pointer to a new `ParsedArguments` object containing information on
+ *         parsed flags and positional arguments.
+ */
+ParsedArguments * cap_compiled_parser_parse(
+        const CompiledParser * compiled, int argc, const char ** argv) {
+    _cap_parser_check_completion(&(compiled -> mParser), argc, argv);
+    ParsingResult result = _cap_parser_parse_all(
+        &(compiled -> mParser), argc, argv);
+    return _cap_parser_finish_parsing(&(compiled -> mParser), result, argv);
+}
+
+/**
+ * Prints a usage string.
+ *
+ * @see cap_parser_print_usage
+ */
+void cap_compiled_parser_print_usage(
+        const CompiledParser * compiled, FILE * file, const char * argv0) {
+    if (!compiled) {
+        return;
+    }
+    cap_parser_print_usage(&(compiled -> mParser), file, argv0);
+}
+
+/**
+ * Prints a help message.
+ *
+ * @see cap_parser_print_help
+ */
+void cap_compiled_parser_print_help(
+        const CompiledParser * compiled, FILE * file) {
+    if (!compiled) {
+        return;
+    }
+    cap_parser_print_help(&(compiled -> mParser), file);
+}
+
+/**
+ * Formats a usage string.
+ *
+ * @see cap_parser_format_usage
+ */
+size_t cap_compiled_parser_format_usage(
+        const CompiledParser * compiled, const char * argv0, char * buffer,
+        size_t size) {
+    return cap_parser_format_usage(
+        compiled ? &(compiled -> mParser) : NULL, argv0, buffer, size);
+}
+
+/**
+ * Formats a help message.
+ *
+ * @see cap_parser_format_help
+ */
+size_t cap_compiled_parser_format_help(
+        const CompiledParser * compiled, char * buffer, size_t size) {
+    return cap_parser_format_help(
+        compiled ? &(compiled -> mParser) : NULL, buffer, size);
+}
+
+// ============================================================================
+// === COMPILED PARSER: IMPLEMENTATION OF PRIVATE FUNCTIONS ===================
+// ============================================================================
+
+static size_t _cap_compiled_string_size(const char * string) {
+    return string ? strlen(string) + 1u : 0u;
+}
+
+static size_t _cap_compiled_flag_string_size(const FlagInfo * info) {
+    size_t size = _cap_compiled_string_size(info -> mName)
+        + _cap_compiled_string_size(info -> mMetaVar)
+        + _cap_compiled_string_size(info -> mDescription);
+    for (size_t i = 0u; i < info -> mAliasCount; ++i) {
+        size += _cap_compiled_string_size(info -> mAliases[i]);
+    }
+    return size;
+}
+
+static void * _cap_compiled_take(char ** cursor, size_t size) {
+    void * taken = *cursor;
+    *cursor += size;
+    return taken;
+}
+
+static char * _cap_compiled_copy_string(char ** cursor, const char * string) {
+    if (!string) {
+        return NULL;
+    }
+    const size_t size = strlen(string) + 1u;
+    char * copy = (char *) _cap_compiled_take(cursor, size);
+    memcpy(copy, string, size);
+    return copy;
+}
+
+static void _cap_compiled_copy_flag(
+        FlagInfo * dst, const FlagInfo * src, char *** alias_cursor,
+        char ** string_cursor) {
+    *dst = *src;
+    dst -> mName = _cap_compiled_copy_string(string_cursor, src -> mName);
+    dst -> mMetaVar = _cap_compiled_copy_string(
+        string_cursor, src -> mMetaVar);
+    dst -> mDescription = _cap_compiled_copy_string(
+        string_cursor, src -> mDescription);
+    dst -> mShortestName = dst -> mName;
+    dst -> mAliases = *alias_cursor;
+    dst -> mAliasAlloc = src -> mAliasCount;
+    for (size_t i = 0u; i < src -> mAliasCount; ++i) {
+        dst -> mAliases[i] = _cap_compiled_copy_string(
+            string_cursor, src -> mAliases[i]);
+        if (src -> mShortestName == src -> mAliases[i]) {
+            dst -> mShortestName = dst -> mAliases[i];
+        }
+    }
+    *alias_cursor += src -> mAliasCount;
+}
+
+static void _cap_compiled_prepare_help(ArgumentParser * parser) {
+    // renders the messages of the parser and of the parsers of all its
+    // subcommands, which are already built
+    cap_parser_prepare_help(parser);
+    for (size_t i = 0u; i < parser -> mSubcommandCount; ++i) {
+        _cap_compiled_prepare_help(parser -> mSubcommands[i].mParser);
+    }
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @file
+ * @addtogroup parser
+ *
+ * A `ParserIterator` parses a command line one value at a time. Each call to
+ * `cap_parser_iter_next` yields the next flag or positional argument with its
+ * converted value, in the order of the command line words. No
+ * `ParsedArguments` is built, so the memory used by the iterator does not
+ * depend on the number of words. This suits programs which stream a long list
+ * of inputs straight into processing.
+ *
+ * Words are classified and values are converted exactly like
+ * `cap_parser_parse` does, and the same errors are reported. Errors which
+ * concern the whole command line (missing required flags and positionals) are
+ * reported when the last word was yielded. Values of a variadic `DT_INT` or
+ * `DT_DOUBLE` positional are still converted in batches, and yielded one by
+ * one. Subcommands (see `cap_parser_add_subcommand`) are not supported,
+ * parsers which have them must be used with `cap_parser_parse`.
+ *
+ * ``` c
+ * ParserIterator * iter = cap_parser_iter_begin(parser, argc, argv);
+ * ParsedItem item;
+ * while (cap_parser_iter_next(iter, &item)) {
+ *     if (!item.mIsFlag && item.mId == files_id) {
+ *         process_file(cap_tu_as_string(&(item.mValue)));
+ *     }
+ * }
+ * cap_parser_iter_end(iter);
+ * ```
+ */
+
+/**
+ * @addtogroup parser
+ * @{
+ */
+
+// ============================================================================
+// === PARSER ITERATOR ========================================================
+// ============================================================================
+
+/**
+ * One flag or positional argument yielded by a `ParserIterator`.
+ */
+typedef struct {
+    /// `true` if this is a flag, `false` if it is a positional argument
+    bool mIsFlag;
+    /// id of the flag or positional argument, the same as given by
+    /// `cap_parser_get_flag_id` or `cap_parser_get_positional_id`
+    size_t mId;
+    /// name of the flag (also if it was given by an alias) or positional
+    const char * mName;
+    /// value of the flag or positional. Flags of type `DT_PRESENCE` have
+    /// a presence value. Strings point into the command line words (or into
+    /// response files), they are not copied. Strings read from the input of
+    /// a positional (see `cap_parser_set_positional_input`) are only valid
+    /// until the next item is requested.
+    TypedUnion mValue;
+} ParsedItem;
+
+/**
+ * State of parsing a command line one value at a time.
+ *
+ * Objects of this type are created using `cap_parser_iter_begin` and
+ * destroyed using `cap_parser_iter_end`. Their members should never be
+ * accessed or modified directly.
+ *
+ * @see cap_parser_iter_begin
+ * @see cap_parser_iter_next
+ * @see cap_parser_iter_end
+ */
+typedef struct {
+    const ArgumentParser * mParser;
+    /// program name, for error messages
+    const char * mProgram;
+    _CapWords mWords;
+    /// response files read by the iterator, released by `cap_parser_iter_end`
+    ResponseFile * mResponseFiles;
+    size_t mResponseFileCount;
+    /// error which stopped the iteration, `mArguments` is always `NULL`
+    ParsingResult mResult;
+    /// `true` once the last value was yielded or an error occurred
+    bool mFinished;
+
+    size_t mPositionalIndex;
+    /// `true` if a value was yielded for the current (variadic) positional
+    bool mPositionalFilled;
+    bool mPositionalOnly;
+    /// number of values yielded for each flag
+    size_t * mFlagCounts;
+
+    /// values of a variadic numeric positional converted at once, and the
+    /// position of the next one to yield
+    union {
+        int asInts[_CAP_NUMERIC_CHUNK_SIZE];
+        double asDoubles[_CAP_NUMERIC_CHUNK_SIZE];
+    } mBatch;
+    size_t mBatchCount;
+    size_t mBatchNext;
+
+    /// input of a positional, read once the command line words are parsed
+    _CapInput mInput;
+    bool mInputStarted;
+} ParserIterator;
+
+// ============================================================================
+// === PARSER ITERATOR: DECLARATION OF PRIVATE FUNCTIONS ======================
+// ============================================================================
+
+static bool _cap_iter_fail(
+    ParserIterator * iter, ParsingError error, const char * first_word,
+    const char * second_word);
+static bool _cap_iter_fill_batch(ParserIterator * iter);
+static bool _cap_iter_yield_positional(
+    ParserIterator * iter, TypedUnion value, ParsedItem * item);
+static bool _cap_iter_next_input(ParserIterator * iter);
+static bool _cap_iter_finish(ParserIterator * iter);
+
+// ============================================================================
+// === PARSER ITERATOR: CREATION AND DESTRUCTION ==============================
+// ============================================================================
+
+/**
+ * Starts parsing command line arguments one value at a time.
+ *
+ * Creates an iterator which yields the flags and positional arguments of the
+ * given command line words using `cap_parser_iter_next`. The parser and the
+ * words must stay unchanged while the iterator is used. The caller becomes
+ * the owner of the iterator and should dispose of it using
+ * `cap_parser_iter_end`.
+ *
+ * The iterator does not enter subcommands, so if `parser` has any, the
+ * program exits with an error.
+ *
+ * @param parser parser object to use
+ * @param argc number of command line words
+ * @param argv array of command line words
+ * @return new iterator
+ */
+ParserIterator * cap_parser_iter_begin(
+        const ArgumentParser * parser, int argc, const char ** argv) {
+    if (parser -> mSubcommandCount) {
+        fprintf(
+            stderr, "cap: cannot iterate over a parser with subcommands, use"
+            " cap_parser_parse\n");
+        exit(-1);
+    }
+    const size_t counts_size = parser -> mFlagCount * sizeof(size_t);
+    ParserIterator * iter = (ParserIterator *) cap_malloc(
+        sizeof(ParserIterator) + counts_size);
+    iter -> mParser = parser;
+    iter -> mProgram = argc > 0 ? *argv : NULL;
+    iter -> mFinished = false;
+    iter -> mPositionalIndex = 0u;
+    iter -> mPositionalFilled = false;
+    iter -> mPositionalOnly = false;
+    iter -> mFlagCounts = (size_t *) (iter + 1);
+    memset(iter -> mFlagCounts, 0, counts_size);
+    iter -> mBatchCount = 0u;
+    iter -> mBatchNext = 0u;
+    iter -> mInputStarted = false;
+    // an error opening response files is reported by the first call to
+    // cap_parser_iter_next
+    iter -> mResult = _cap_parser_open_response_files(
+        parser, argc, argv, &(iter -> mResponseFiles),
+        &(iter -> mResponseFileCount));
+    iter -> mWords = _cap_words_make(
+        argc, argv, iter -> mResponseFiles, iter -> mResponseFileCount);
+    return iter;
+}
+
+/**
+ * Destroys an iterator.
+ *
+ * Strings yielded by the iterator from response files become invalid.
+ *
+ * @param iter iterator to destroy. If it is `NULL`, this function does
+ *        nothing.
+ */
+void cap_parser_iter_end(ParserIterator * iter) {
+    if (!iter) {
+        return;
+    }
+    for (size_t i = 0u; i < iter -> mResponseFileCount; ++i) {
+        _cap_rf_close(iter -> mResponseFiles + i);
+    }
+    cap_free(iter -> mResponseFiles);
+    if (iter -> mInputStarted) {
+        _cap_input_destroy(&(iter -> mInput));
+    }
+    cap_free(iter);
+}
+
+// ============================================================================
+// === PARSER ITERATOR: ITERATION =============================================
+// ============================================================================
+
+/**
+ * Yields the next flag or positional argument without exiting on error.
+ *
+ * Stores the next flag or positional argument into `item` and returns
+ * `true`. Returns `false` once all words are parsed, or when an error
+ * occurs. In both cases `cap_parser_iter_result` tells which, and all further
+ * calls return `false` as well.
+ *
+ * @param iter iterator to advance
+ * @param item object to store the flag or positional argument into
+ * @return `true` if `item` was filled
+ */
+bool cap_parser_iter_next_noexit(ParserIterator * iter, ParsedItem * item) {
+    const ArgumentParser * parser = iter -> mParser;
+    if (iter -> mBatchNext < iter -> mBatchCount) {
+        const size_t i = iter -> mBatchNext++;
+        return _cap_iter_yield_positional(
+            iter, parser -> mPositionals[iter -> mPositionalIndex] -> mType
+                == DT_INT
+                ? cap_tu_make_int(iter -> mBatch.asInts[i])
+                : cap_tu_make_double(iter -> mBatch.asDoubles[i]),
+            item);
+    }
+    if (iter -> mFinished) {
+        return false;
+    }
+    if (iter -> mResult.mError != PER_NO_ERROR) {
+        // reported after the values converted before it were yielded
+        iter -> mFinished = true;
+        return false;
+    }
+    _CapWords * words = &(iter -> mWords);
+    while (words -> mWord) {
+        const char * arg = words -> mWord;
+        if (iter -> mPositionalOnly
+                || !parser -> mIsFlagPrefix[(unsigned char) *arg]) {
+            const size_t positional_index = iter -> mPositionalIndex;
+            if (positional_index < parser -> mPositionalCount
+                    && parser -> mPositionals[positional_index] -> mVariadic
+                    && (parser -> mPositionals[positional_index] -> mType
+                        == DT_INT
+                        || parser -> mPositionals[positional_index] -> mType
+                        == DT_DOUBLE)) {
+                // also returns the pending error if no value was converted
+                _cap_iter_fill_batch(iter);
+                return cap_parser_iter_next_noexit(iter, item);
+            }
+            OnePositionalParsingResult one_posit_res =
+                _cap_parser_parse_one_positional(parser, arg, positional_index);
+            const PositionalInfo * posit_info = one_posit_res.mPositional;
+            switch (one_posit_res.mError) {
+                case OPPE_NO_ERROR:
+                    break;
+                case OPPE_TOO_MANY:
+                    return _cap_iter_fail(
+                        iter, PER_TOO_MANY_POSITIONALS, NULL, NULL);
+                case OPPE_CANNOT_PARSE:
+                    return _cap_iter_fail(
+                        iter, PER_CANNOT_PARSE_POSITIONAL,
+                        posit_info -> mName, arg);
+                case OPPE_OUT_OF_RANGE:
+                    return _cap_iter_fail(
+                        iter, PER_POSITIONAL_OUT_OF_RANGE,
+                        posit_info -> mName, arg);
+                default:
+                    assert(false && "unreachable in cap_parser_iter_next");
+            }
+            _cap_words_advance(words);
+            return _cap_iter_yield_positional(
+                iter, one_posit_res.mValue, item);
+        }
+
+        OneFlagParsingResult one_flag_res = _cap_parser_parse_one_flag(
+            parser, words);
+        const FlagInfo * parsed_flag = one_flag_res.mFlag;
+        switch (one_flag_res.mError) {
+            case OFPE_NO_ERROR:
+                break;
+            case OFPE_UNKNOWN_FLAG:
+                return _cap_iter_fail(iter, PER_UNKNOWN_FLAG, arg, NULL);
+            case OFPE_MISSING_FLAG_VALUE:
+                return _cap_iter_fail(iter, PER_MISSING_FLAG_VALUE, arg, NULL);
+            case OFPE_CANNOT_PARSE_FLAG:
+                return _cap_iter_fail(
+                    iter, PER_CANNOT_PARSE_FLAG, arg, words -> mWord);
+            case OFPE_FLAG_OUT_OF_RANGE:
+                return _cap_iter_fail(
+                    iter, PER_FLAG_OUT_OF_RANGE, arg, words -> mWord);
+            default:
+                assert(false && "unreachable in cap_parser_iter_next");
+        }
+        if (parsed_flag == parser -> mFlagSeparatorInfo) {
+            iter -> mPositionalOnly = true;
+            continue;
+        }
+        if (parsed_flag == parser -> mHelpFlagInfo) {
+            return _cap_iter_fail(iter, PER_HELP, NULL, NULL);
+        }
+        const size_t id = one_flag_res.mFlagId;
+        if (parsed_flag -> mMaxCount >= 0
+                && iter -> mFlagCounts[id] >= (size_t) parsed_flag -> mMaxCount) {
+            return _cap_iter_fail(
+                iter, PER_TOO_MANY_FLAGS, parsed_flag -> mName, NULL);
+        }
+        ++iter -> mFlagCounts[id];
+        *item = (ParsedItem) {
+            .mIsFlag = true,
+            .mId = id,
+            .mName = parsed_flag -> mName,
+            .mValue = one_flag_res.mValue
+        };
+        return true;
+    }
+    if (_cap_iter_next_input(iter)) {
+        return cap_parser_iter_next_noexit(iter, item);
+    }
+    if (iter -> mFinished) {
+        return false;
+    }
+    return _cap_iter_finish(iter);
+}
+
+/**
+ * Yields the next flag or positional argument.
+ *
+ * Behaves like `cap_parser_iter_next_noexit`, except that when an error
+ * occurs, the program exits with an error message, or prints help and exits
+ * if the help flag is given, exactly like `cap_parser_parse`.
+ *
+ * @param iter iterator to advance
+ * @param item object to store the flag or positional argument into
+ * @return `true` if `item` was filled, `false` once all words are parsed
+ */
+bool cap_parser_iter_next(ParserIterator * iter, ParsedItem * item) {
+    if (cap_parser_iter_next_noexit(iter, item)) {
+        return true;
+    }
+    if (iter -> mResult.mError != PER_NO_ERROR) {
+        const char * argv[1] = { iter -> mProgram };
+        _cap_parser_finish_parsing(iter -> mParser, iter -> mResult, argv);
+    }
+    return false;
+}
+
+/**
+ * Gets the error which stopped an iterator.
+ *
+ * @param iter iterator to inspect
+ * @return result whose `mError` is `PER_NO_ERROR` unless an error occurred.
+ *         Its `mArguments` is always `NULL`. Error words may point into
+ *         response files, and stay valid until the iterator is destroyed.
+ */
+ParsingResult cap_parser_iter_result(const ParserIterator * iter) {
+    return iter -> mResult;
+}
+
+// ============================================================================
+// === PARSER ITERATOR: IMPLEMENTATION OF PRIVATE FUNCTIONS ===================
+// ============================================================================
+
+static bool _cap_iter_fail(
+        ParserIterator * iter, ParsingError error, const char * first_word,
+        const char * second_word) {
+    iter -> mResult.mError = error;
+    iter -> mResult.mFirstErrorWord = first_word;
+    iter -> mResult.mSecondErrorWord = second_word;
+    iter -> mFinished = true;
+    return false;
+}
+
+static bool _cap_iter_fill_batch(ParserIterator * iter) {
+    // converts the next chunk of words of the current (variadic, numeric)
+    // positional. If a word cannot be converted, the error is stored and
+    // reported once the values before it are yielded.
+    const ArgumentParser * parser = iter -> mParser;
+    const PositionalInfo * posit_info
+        = parser -> mPositionals[iter -> mPositionalIndex];
+    _CapWords * words = &(iter -> mWords);
+    const char * chunk[_CAP_NUMERIC_CHUNK_SIZE];
+    // a chunk ends with the buffer holding its words
+    const char * const limit = words -> mFileEnd;
+    size_t count = 0u;
+    while (words -> mWord && count < _CAP_NUMERIC_CHUNK_SIZE
+            && words -> mFileEnd == limit
+            && (iter -> mPositionalOnly
+                || !parser -> mIsFlagPrefix[(unsigned char) *words -> mWord])) {
+        chunk[count++] = words -> mWord;
+        _cap_words_advance(words);
+    }
+    WordConversionResult conversion;
+    iter -> mBatchNext = 0u;
+    iter -> mBatchCount = posit_info -> mType == DT_INT
+        ? _cap_parse_int_batch(
+            chunk, count, limit, iter -> mBatch.asInts, &conversion)
+        : _cap_parse_double_batch(
+            chunk, count, limit, iter -> mBatch.asDoubles, &conversion);
+    if (iter -> mBatchCount < count) {
+        iter -> mResult.mError = conversion == WCR_OUT_OF_RANGE
+            ? PER_POSITIONAL_OUT_OF_RANGE
+            : PER_CANNOT_PARSE_POSITIONAL;
+        iter -> mResult.mFirstErrorWord = posit_info -> mName;
+        iter -> mResult.mSecondErrorWord = chunk[iter -> mBatchCount];
+        return false;
+    }
+    return true;
+}
+
+static bool _cap_iter_yield_positional(
+        ParserIterator * iter, TypedUnion value, ParsedItem * item) {
+    const PositionalInfo * posit_info
+        = iter -> mParser -> mPositionals[iter -> mPositionalIndex];
+    *item = (ParsedItem) {
+        .mIsFlag = false,
+        .mId = iter -> mPositionalIndex,
+        .mName = posit_info -> mName,
+        .mValue = value
+    };
+    if (posit_info -> mVariadic) {
+        iter -> mPositionalFilled = true;
+    }
+    else {
+        ++iter -> mPositionalIndex;
+    }
+    return true;
+}
+
+static bool _cap_iter_next_input(ParserIterator * iter) {
+    // makes the next records of the input the current words, once the
+    // command line words are parsed. Returns `false` at the end of the input
+    // or on error.
+    const ArgumentParser * parser = iter -> mParser;
+    if (parser -> mInputFd < 0) {
+        return false;
+    }
+    const size_t id = parser -> mInputPositional;
+    if (!iter -> mInputStarted) {
+        // records are values of the positional reading input, so the
+        // positionals before it are complete
+        for (size_t i = iter -> mPositionalIndex + iter -> mPositionalFilled;
+                i < id; ++i) {
+            if (parser -> mPositionals[i] -> mRequired) {
+                return _cap_iter_fail(
+                    iter, PER_NOT_ENOUGH_POSITIONALS, NULL, NULL);
+            }
+        }
+        if (iter -> mPositionalIndex != id) {
+            iter -> mPositionalIndex = id;
+            iter -> mPositionalFilled = false;
+        }
+        iter -> mPositionalOnly = true;
+        _cap_input_init(
+            &(iter -> mInput), parser -> mInputFd, parser -> mInputDelimiter);
+        iter -> mInputStarted = true;
+    }
+    if (_cap_input_next(&(iter -> mInput), &(iter -> mWords))) {
+        return true;
+    }
+    if (iter -> mInput.mFailed) {
+        return _cap_iter_fail(
+            iter, PER_CANNOT_READ_INPUT, parser -> mPositionals[id] -> mName,
+            NULL);
+    }
+    return false;
+}
+
+static bool _cap_iter_finish(ParserIterator * iter) {
+    // checks the required counts once all words are parsed, like
+    // _cap_parser_check_flag_and_positional_counts
+    const ArgumentParser * parser = iter -> mParser;
+    iter -> mFinished = true;
+    const size_t first_not_parsed
+        = iter -> mPositionalIndex + iter -> mPositionalFilled;
+    if (first_not_parsed < parser -> mPositionalCount
+            && parser -> mPositionals[first_not_parsed] -> mRequired) {
+        return _cap_iter_fail(iter, PER_NOT_ENOUGH_POSITIONALS, NULL, NULL);
+    }
+    for (size_t i = 0u; i < parser -> mFlagCount; ++i) {
+        const FlagInfo * flag_info = parser -> mFlags[i];
+        if (iter -> mFlagCounts[i] < (size_t) flag_info -> mMinCount) {
+            return _cap_iter_fail(
+                iter, PER_NOT_ENOUGH_FLAGS, flag_info -> mName, NULL);
+        }
+    }
+    return false;
+}
+
+/**
+ * @}
+ */
+
+#endif
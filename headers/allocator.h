@@ -0,0 +1,152 @@
+#ifndef __ALLOCATOR_H__
+#define __ALLOCATOR_H__
+
+/**
+ * @file
+ *
+ * All memory used by the library is allocated through a process-wide
+ * `Allocator`. By default, it forwards to `malloc`, `realloc` and `free`. A
+ * custom allocator can be installed using `cap_allocator_set`, e.g. to route
+ * allocations through a pool allocator or to account for the memory used by
+ * the library.
+ *
+ * The allocator should be installed before any object of the library is
+ * created, and it must not be changed while such objects exist, because
+ * memory is always released through the allocator which is installed at that
+ * time. Installing an allocator is not thread-safe.
+ *
+ * Memory returned by functions of the library which the caller is supposed
+ * to release (e.g. strings returned by `copy_string`) must be released using
+ * `cap_free`.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+
+// ============================================================================
+// === ALLOCATOR ==============================================================
+// ============================================================================
+
+/**
+ * Set of functions used by the library to manage memory.
+ *
+ * The functions have the same semantics as `malloc`, `realloc` and `free`,
+ * except that they receive `mContext` as an additional argument.
+ */
+typedef struct {
+    /// allocates `size` bytes
+    void * (* mAlloc)(size_t size, void * context);
+    /// resizes `memory` (which may be `NULL`) to `size` bytes
+    void * (* mRealloc)(void * memory, size_t size, void * context);
+    /// releases `memory`, which may be `NULL`
+    void (* mFree)(void * memory, void * context);
+    /// passed to every call of the functions above
+    void * mContext;
+} Allocator;
+
+// ============================================================================
+// === ALLOCATOR: DECLARATION OF PRIVATE FUNCTIONS ============================
+// ============================================================================
+
+static void * _cap_default_alloc(size_t size, void * context);
+static void * _cap_default_realloc(void * memory, size_t size, void * context);
+static void _cap_default_free(void * memory, void * context);
+
+/// the installed allocator
+static Allocator _cap_allocator = {
+    .mAlloc = _cap_default_alloc,
+    .mRealloc = _cap_default_realloc,
+    .mFree = _cap_default_free,
+    .mContext = NULL
+};
+
+// ============================================================================
+// === ALLOCATOR FUNCTIONS ====================================================
+// ============================================================================
+
+/**
+ * Installs an allocator.
+ *
+ * All memory allocated by the library from now on is managed by `allocator`.
+ * See the description of this file for restrictions.
+ *
+ * @param allocator allocator to install. It is copied. If it is `NULL`, the
+ *        default allocator (using `malloc`, `realloc` and `free`) is
+ *        installed.
+ */
+void cap_allocator_set(const Allocator * allocator) {
+    if (!allocator) {
+        _cap_allocator = (Allocator) {
+            .mAlloc = _cap_default_alloc,
+            .mRealloc = _cap_default_realloc,
+            .mFree = _cap_default_free,
+            .mContext = NULL
+        };
+        return;
+    }
+    _cap_allocator = *allocator;
+}
+
+/**
+ * Gets the installed allocator.
+ *
+ * @return copy of the installed allocator
+ */
+Allocator cap_allocator_get() {
+    return _cap_allocator;
+}
+
+/**
+ * Allocates memory using the installed allocator.
+ *
+ * @param size number of bytes to allocate
+ * @return pointer to the allocated memory
+ */
+void * cap_malloc(size_t size) {
+    return _cap_allocator.mAlloc(size, _cap_allocator.mContext);
+}
+
+/**
+ * Resizes memory using the installed allocator.
+ *
+ * @param memory memory to resize, or `NULL`
+ * @param size required number of bytes
+ * @return pointer to the resized memory
+ */
+void * cap_realloc(void * memory, size_t size) {
+    return _cap_allocator.mRealloc(memory, size, _cap_allocator.mContext);
+}
+
+/**
+ * Releases memory using the installed allocator.
+ *
+ * @param memory memory to release. If it is `NULL`, nothing happens.
+ */
+void cap_free(void * memory) {
+    if (!memory) {
+        return;
+    }
+    _cap_allocator.mFree(memory, _cap_allocator.mContext);
+}
+
+// ============================================================================
+// === ALLOCATOR: IMPLEMENTATION OF PRIVATE FUNCTIONS =========================
+// ============================================================================
+
+static void * _cap_default_alloc(size_t size, void * context) {
+    (void) context;
+    return malloc(size);
+}
+
+static void * _cap_default_realloc(
+        void * memory, size_t size, void * context) {
+    (void) context;
+    return realloc(memory, size);
+}
+
+static void _cap_default_free(void * memory, void * context) {
+    (void) context;
+    free(memory);
+}
+
+#endif
@@ -0,0 +1,423 @@
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+/**
+ * @file
+ *
+ * `Arena` is a bump allocator. Memory is handed out from large chunks by
+ * advancing a pointer, and individual allocations are never freed. Instead,
+ * all memory is released at once when the arena is destroyed. It is used
+ * internally, e.g. by `ParsedArguments`, so that a single parse needs only a
+ * few allocations and a single deallocation (unless the arena grows).
+ * Users of the library never need to interact with it directly. Functions
+ * related to this type are prefixed with `cap_arena_`.
+ *
+ * An arena can also be rewound to a previously taken mark using
+ * `cap_arena_rewind`. Everything allocated after the mark is released, but
+ * the chunks are kept and reused by later allocations. Repeating the same
+ * allocations after rewinding therefore does not allocate any memory.
+ *
+ * Functions which allocate memory accept a `NULL` arena. In that case they
+ * fall back to `cap_malloc`, `cap_realloc` and `cap_free`. This allows
+ * containers to be backed by an arena optionally, using the same code.
+ */
+
+#include "allocator.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// === ARENA ==================================================================
+// ============================================================================
+
+/**
+ * A chunk of memory owned by an `Arena`.
+ *
+ * The usable memory of a chunk follows directly after this header.
+ */
+typedef struct ArenaChunk {
+    /// next chunk, or `NULL`
+    struct ArenaChunk * mNext;
+    /// number of usable bytes in this chunk
+    size_t mSize;
+    /// number of bytes already handed out
+    size_t mUsed;
+} ArenaChunk;
+
+/**
+ * Heap memory adopted by an `Arena`, see `cap_arena_adopt`.
+ */
+typedef struct ArenaAdopted {
+    /// previously adopted memory, or `NULL`
+    struct ArenaAdopted * mPrevious;
+    /// memory to pass to `cap_free` when the arena is destroyed
+    void * mMemory;
+} ArenaAdopted;
+
+/**
+ * Bump allocator.
+ *
+ * The first chunk is allocated in the same block as the arena itself. Chunks
+ * form a list in the order in which they were allocated, chunks after
+ * `mCurrent` are empty and are reused before allocating new ones.
+ */
+typedef struct {
+    /// chunk from which memory is currently handed out
+    ArenaChunk * mCurrent;
+    /// heap memory to free when the arena is destroyed
+    ArenaAdopted * mAdopted;
+    /// most recent allocation, which can be resized in place
+    void * mLast;
+    /// number of bytes of the most recent allocation
+    size_t mLastSize;
+} Arena;
+
+/**
+ * Position in an `Arena`, see `cap_arena_mark`.
+ */
+typedef struct {
+    /// chunk which was current when the mark was taken
+    ArenaChunk * mChunk;
+    /// number of bytes used in `mChunk` at that time
+    size_t mUsed;
+    /// most recently adopted memory at that time
+    ArenaAdopted * mAdopted;
+} ArenaMark;
+
+/// type with the strictest alignment requirement of all fundamental types
+typedef union {
+    long double mLongDouble;
+    long long mLongLong;
+    double mDouble;
+    void * mPointer;
+    void (* mFunction)(void);
+} _CapArenaMaxAlign;
+
+/// alignment of every allocation handed out by an `Arena`
+#define _CAP_ARENA_ALIGN (sizeof(_CapArenaMaxAlign))
+
+// ============================================================================
+// === ARENA: DECLARATION OF PRIVATE FUNCTIONS ================================
+// ============================================================================
+
+static size_t _cap_arena_round_up(size_t size);
+static ArenaChunk * _cap_arena_first_chunk(const Arena * arena);
+static char * _cap_arena_chunk_data(ArenaChunk * chunk);
+static ArenaChunk * _cap_arena_chunk_make(size_t size, void * memory);
+
+// ============================================================================
+// === ARENA FUNCTIONS ========================================================
+// ============================================================================
+
+/**
+ * Creates a new `Arena`.
+ *
+ * Allocates the arena together with its first chunk in a single block. If
+ * more than `size` bytes are requested from the arena, more chunks are
+ * allocated as needed.
+ *
+ * The caller becomes the owner of the new object and should dispose of it
+ * using `cap_arena_destroy`.
+ *
+ * @param size number of usable bytes in the first chunk
+ * @return new object
+ */
+Arena * cap_arena_make(size_t size) {
+    size = _cap_arena_round_up(size);
+    const size_t header = _cap_arena_round_up(sizeof(Arena))
+        + _cap_arena_round_up(sizeof(ArenaChunk));
+    char * block = (char *) cap_malloc(header + size);
+    Arena * arena = (Arena *) block;
+    *arena = (Arena) {
+        .mCurrent = _cap_arena_chunk_make(
+            size, block + _cap_arena_round_up(sizeof(Arena))),
+        .mAdopted = NULL,
+        .mLast = NULL,
+        .mLastSize = 0u
+    };
+    return arena;
+}
+
+/**
+ * Destroys an `Arena`.
+ *
+ * Releases all memory handed out by the arena, memory adopted by it, and the
+ * arena itself.
+ *
+ * @param arena object to destroy. If it is `NULL`, nothing happens.
+ */
+void cap_arena_destroy(Arena * arena) {
+    if (!arena) {
+        return;
+    }
+    for (ArenaAdopted * a = arena -> mAdopted; a; a = a -> mPrevious) {
+        cap_free(a -> mMemory);
+    }
+    // the first chunk lives in the same block as the arena
+    ArenaChunk * chunk = _cap_arena_first_chunk(arena) -> mNext;
+    while (chunk) {
+        ArenaChunk * next = chunk -> mNext;
+        cap_free(chunk);
+        chunk = next;
+    }
+    cap_free(arena);
+}
+
+/**
+ * Allocates memory.
+ *
+ * Returns `size` bytes of uninitialized memory, suitably aligned for any
+ * fundamental type. The memory is valid until the arena is destroyed, or
+ * rewound to a mark taken before this call.
+ *
+ * @param arena arena to allocate from. If it is `NULL`, `cap_malloc` is
+ *        used instead.
+ * @param size number of bytes to allocate
+ * @return pointer to the allocated memory
+ */
+void * cap_arena_alloc(Arena * arena, size_t size) {
+    if (!arena) {
+        return cap_malloc(size);
+    }
+    const size_t rounded = _cap_arena_round_up(size);
+    ArenaChunk * chunk = arena -> mCurrent;
+    while (chunk -> mSize - chunk -> mUsed < rounded) {
+        if (!chunk -> mNext) {
+            // each new chunk is at least twice as large as the previous one
+            size_t chunk_size = chunk -> mSize * 2u;
+            if (chunk_size < rounded) {
+                chunk_size = rounded;
+            }
+            chunk -> mNext = _cap_arena_chunk_make(
+                chunk_size,
+                cap_malloc(
+                    _cap_arena_round_up(sizeof(ArenaChunk)) + chunk_size));
+        }
+        chunk = chunk -> mNext;
+    }
+    arena -> mCurrent = chunk;
+    void * memory = _cap_arena_chunk_data(chunk) + chunk -> mUsed;
+    chunk -> mUsed += rounded;
+    arena -> mLast = memory;
+    arena -> mLastSize = rounded;
+    return memory;
+}
+
+/**
+ * Resizes memory.
+ *
+ * Resizes memory previously returned by `cap_arena_alloc` or
+ * `cap_arena_realloc`. If `memory` is the most recent allocation, it is
+ * resized in place when possible. Otherwise new memory is allocated and the
+ * contents are copied. The old memory is not reused.
+ *
+ * @param arena arena to allocate from. If it is `NULL`, `realloc` is used
+ *        instead.
+ * @param memory memory to resize, or `NULL`
+ * @param old_size number of bytes currently allocated at `memory`
+ * @param new_size required number of bytes
+ * @return pointer to the resized memory
+ */
+void * cap_arena_realloc(
+    Arena * arena, void * memory, size_t old_size, size_t new_size)
+{
+    if (!arena) {
+        return cap_realloc(memory, new_size);
+    }
+    if (memory && memory == arena -> mLast) {
+        ArenaChunk * chunk = arena -> mCurrent;
+        const size_t rounded = _cap_arena_round_up(new_size);
+        const size_t start = chunk -> mUsed - arena -> mLastSize;
+        if (rounded <= chunk -> mSize - start) {
+            chunk -> mUsed = start + rounded;
+            arena -> mLastSize = rounded;
+            return memory;
+        }
+    }
+    void * new_memory = cap_arena_alloc(arena, new_size);
+    if (memory) {
+        memcpy(new_memory, memory, old_size < new_size ? old_size : new_size);
+    }
+    return new_memory;
+}
+
+/**
+ * Releases memory.
+ *
+ * Memory allocated from an arena is only released when the arena is
+ * destroyed, so this function does nothing unless `arena` is `NULL`.
+ *
+ * @param arena arena from which `memory` was allocated. If it is `NULL`,
+ *        `cap_free` is used.
+ * @param memory memory to release
+ */
+void cap_arena_free(Arena * arena, void * memory) {
+    if (!arena) {
+        cap_free(memory);
+    }
+}
+
+/**
+ * Remembers the current position of an arena.
+ *
+ * @param arena object to inspect
+ * @return mark which can be passed to `cap_arena_rewind`
+ */
+ArenaMark cap_arena_mark(const Arena * arena) {
+    return (ArenaMark) {
+        .mChunk = arena -> mCurrent,
+        .mUsed = arena -> mCurrent -> mUsed,
+        .mAdopted = arena -> mAdopted
+    };
+}
+
+/**
+ * Rewinds an arena to a mark.
+ *
+ * Releases everything allocated and adopted since `mark` was taken. Memory
+ * allocated before that remains valid. The chunks of the arena are kept, so
+ * that later allocations can reuse them without allocating memory.
+ *
+ * @param arena object to rewind
+ * @param mark mark previously returned by `cap_arena_mark` for `arena`. The
+ *        arena must not have been rewound to an earlier mark since then.
+ */
+void cap_arena_rewind(Arena * arena, ArenaMark mark) {
+    while (arena -> mAdopted != mark.mAdopted) {
+        ArenaAdopted * adopted = arena -> mAdopted;
+        arena -> mAdopted = adopted -> mPrevious;
+        cap_free(adopted -> mMemory);
+    }
+    for (ArenaChunk * c = mark.mChunk -> mNext; c; c = c -> mNext) {
+        c -> mUsed = 0u;
+    }
+    mark.mChunk -> mUsed = mark.mUsed;
+    arena -> mCurrent = mark.mChunk;
+    arena -> mLast = NULL;
+    arena -> mLastSize = 0u;
+}
+
+/**
+ * Gets the number of bytes an allocation takes from an arena.
+ *
+ * Allocations are padded to keep following allocations aligned. This can be
+ * used to compute the exact size of an arena which is large enough for a
+ * known set of allocations.
+ *
+ * @param size number of bytes requested from `cap_arena_alloc`
+ * @return number of bytes used up in the arena by the allocation
+ */
+size_t cap_arena_footprint(size_t size) {
+    return _cap_arena_round_up(size);
+}
+
+/**
+ * Gets the number of bytes owned by an arena.
+ *
+ * @param arena object to measure
+ * @return total number of usable bytes of all chunks, or zero if `arena` is
+ *         `NULL`
+ */
+size_t cap_arena_size(const Arena * arena) {
+    size_t size = 0u;
+    if (!arena) {
+        return size;
+    }
+    for (const ArenaChunk * c = _cap_arena_first_chunk(arena); c;
+            c = c -> mNext) {
+        size += c -> mSize;
+    }
+    return size;
+}
+
+/**
+ * Gets the number of bytes handed out by an arena.
+ *
+ * @param arena object to measure
+ * @return number of bytes allocated from all chunks (including padding), or
+ *         zero if `arena` is `NULL`
+ */
+size_t cap_arena_used(const Arena * arena) {
+    size_t used = 0u;
+    if (!arena) {
+        return used;
+    }
+    for (const ArenaChunk * c = _cap_arena_first_chunk(arena); c;
+            c = c -> mNext) {
+        used += c -> mUsed;
+    }
+    return used;
+}
+
+/**
+ * Takes ownership of heap memory.
+ *
+ * Makes `arena` the owner of `memory`, which must have been allocated using
+ * `cap_malloc`. It is freed when the arena is destroyed. This is used when
+ * a caller hands over ownership of an existing allocation, so that it does
+ * not need to be copied.
+ *
+ * @param arena new owner of `memory`. If it is `NULL`, nothing happens and 
+ *        the caller remains the owner.
+ * @param memory memory to adopt. If it is `NULL`, nothing happens.
+ */
+void cap_arena_adopt(Arena * arena, void * memory) {
+    if (!arena || !memory) {
+        return;
+    }
+    ArenaAdopted * adopted = (ArenaAdopted *) cap_arena_alloc(
+        arena, sizeof(ArenaAdopted));
+    *adopted = (ArenaAdopted) {
+        .mPrevious = arena -> mAdopted,
+        .mMemory = memory
+    };
+    arena -> mAdopted = adopted;
+}
+
+/**
+ * Creates a copy of a string.
+ *
+ * @param arena arena to allocate the copy from. If it is `NULL`,
+ *        `cap_malloc` is used.
+ * @param string original null-terminated string
+ * @return copy of `string`, or `NULL` if `string` is `NULL`
+ */
+char * cap_arena_copy_string(Arena * arena, const char * string) {
+    if (!string) {
+        return NULL;
+    }
+    const size_t size = strlen(string) + 1u;
+    char * copy = (char *) cap_arena_alloc(arena, size);
+    memcpy(copy, string, size);
+    return copy;
+}
+
+// ============================================================================
+// === ARENA: IMPLEMENTATION OF PRIVATE FUNCTIONS =============================
+// ============================================================================
+
+static size_t _cap_arena_round_up(size_t size) {
+    return (size + _CAP_ARENA_ALIGN - 1u) / _CAP_ARENA_ALIGN * _CAP_ARENA_ALIGN;
+}
+
+static ArenaChunk * _cap_arena_first_chunk(const Arena * arena) {
+    return (ArenaChunk *) ((char *) arena + _cap_arena_round_up(sizeof(Arena)));
+}
+
+static char * _cap_arena_chunk_data(ArenaChunk * chunk) {
+    return (char *) chunk + _cap_arena_round_up(sizeof(ArenaChunk));
+}
+
+static ArenaChunk * _cap_arena_chunk_make(size_t size, void * memory) {
+    ArenaChunk * chunk = (ArenaChunk *) memory;
+    *chunk = (ArenaChunk) {
+        .mNext = NULL,
+        .mSize = size,
+        .mUsed = 0u
+    };
+    return chunk;
+}
+
+#endif
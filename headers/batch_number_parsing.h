@@ -0,0 +1,475 @@
+#ifndef __BATCH_NUMBER_PARSING_H__
+#define __BATCH_NUMBER_PARSING_H__
+
+/**
+ * @file
+ *
+ * Conversion of many command line words to numbers at once. It is used
+ * internally by `ArgumentParser` when a variadic `DT_INT` or `DT_DOUBLE`
+ * positional receives a run of words. Users of the library never need to
+ * call these functions directly.
+ *
+ * On x86 processors, digit runs are validated and converted using SSE4.1 or
+ * AVX2 kernels, which are chosen at runtime. Each kernel handles short plain
+ * decimal words (an optional sign, at most 15 digits and a decimal point, and
+ * for doubles an exponent). Every other word, and every word on other
+ * processors, is converted by the scalar functions in `number_parsing.h`, so
+ * the results are always identical. The kernels load 16 bytes at a time, so
+ * they only handle words with at least 16 readable bytes before the known end
+ * of the buffer holding them: the words of response files, command strings
+ * and positional input. Other words, including those of `argv`, are converted
+ * by the scalar functions. Defining `CAP_DISABLE_SIMD` before including the
+ * library disables the kernels.
+ */
+
+#include "number_parsing.h"
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if !defined(CAP_DISABLE_SIMD) && defined(__GNUC__) \
+        && (defined(__x86_64__) || defined(__i386__))
+#define _CAP_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+// ============================================================================
+// === BATCH NUMBER PARSING ===================================================
+// ============================================================================
+
+/**
+ * Instruction set used to convert batches of words.
+ */
+typedef enum {
+    _CAP_SIMD_NONE,
+    _CAP_SIMD_SSE41,
+    _CAP_SIMD_AVX2
+} _CapSimdLevel;
+
+/// a run of decimal digits with an optional decimal point, read by a kernel
+typedef struct {
+    /// value of the digits, ignoring the point
+    uint64_t mDigits;
+    /// number of digits
+    int mDigitCount;
+    /// number of digits after the point
+    int mFractionDigits;
+    /// number of bytes of the run, including the point
+    int mLength;
+} _CapDigitRun;
+
+// ============================================================================
+// === BATCH NUMBER PARSING: DECLARATION OF PRIVATE FUNCTIONS =================
+// ============================================================================
+
+static _CapSimdLevel _cap_simd_level();
+static size_t _cap_parse_int_batch(
+    const char * const * words, size_t count, const char * limit,
+    int * values, WordConversionResult * result);
+static size_t _cap_parse_int_batch_with(
+    const char * const * words, size_t count, const char * limit,
+    int * values, WordConversionResult * result, _CapSimdLevel level);
+static size_t _cap_parse_double_batch(
+    const char * const * words, size_t count, const char * limit,
+    double * values, WordConversionResult * result);
+static size_t _cap_parse_double_batch_with(
+    const char * const * words, size_t count, const char * limit,
+    double * values, WordConversionResult * result, _CapSimdLevel level);
+
+static const char * _cap_batch_number_start(
+    const char * word, bool allow_point, bool * negative);
+static WordConversionResult _cap_finish_int(
+    const char * word, const char * start, const _CapDigitRun * run,
+    bool negative, int * value);
+static WordConversionResult _cap_finish_double(
+    const char * word, const char * start, const _CapDigitRun * run,
+    bool negative, double * value);
+static bool _cap_digit_run_layout(
+    unsigned int digit_mask, unsigned int point_mask, _CapDigitRun * run);
+
+#if defined(_CAP_X86_SIMD)
+static int _cap_point_skip_offset(const _CapDigitRun * run);
+static bool _cap_can_load_16(const char * c, const char * limit);
+static bool _cap_scan_digit_run_sse41(
+    const char * c, bool allow_point, const char * limit, _CapDigitRun * run);
+static unsigned int _cap_scan_digit_runs_avx2(
+    const char * const * c, bool allow_point, const char * limit,
+    _CapDigitRun * runs);
+#endif
+
+// ============================================================================
+// === BATCH NUMBER PARSING: IMPLEMENTATION OF PRIVATE FUNCTIONS ==============
+// ============================================================================
+
+static _CapSimdLevel _cap_simd_level() {
+    // the best instruction set supported by the processor
+#if defined(_CAP_X86_SIMD)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return _CAP_SIMD_AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return _CAP_SIMD_SSE41;
+    }
+#endif
+    return _CAP_SIMD_NONE;
+}
+
+static size_t _cap_parse_int_batch(
+        const char * const * words, size_t count, const char * limit,
+        int * values, WordConversionResult * result) {
+    // converts `words` into `values` and returns the number of converted
+    // words. If it is less than `count`, `*result` tells why the next word
+    // could not be converted. Every word must lie in a buffer which is
+    // readable up to `limit`, which is `NULL` if its end is not known.
+    return _cap_parse_int_batch_with(
+        words, count, limit, values, result, _cap_simd_level());
+}
+
+static size_t _cap_parse_int_batch_with(
+        const char * const * words, size_t count, const char * limit,
+        int * values, WordConversionResult * result, _CapSimdLevel level) {
+    *result = WCR_OK;
+    size_t i = 0u;
+#if defined(_CAP_X86_SIMD)
+    for (; level >= _CAP_SIMD_AVX2 && i + 1u < count; i += 2u) {
+        const char * starts[2];
+        bool negative[2];
+        _CapDigitRun runs[2];
+        starts[0] = _cap_batch_number_start(words[i], false, negative);
+        starts[1] = _cap_batch_number_start(words[i + 1u], false, negative + 1);
+        const unsigned int handled = starts[0] && starts[1]
+            ? _cap_scan_digit_runs_avx2(starts, false, limit, runs)
+            : 0u;
+        for (size_t k = 0u; k < 2u; ++k) {
+            *result = handled & (1u << k)
+                ? _cap_finish_int(
+                    words[i + k], starts[k], runs + k, negative[k],
+                    values + i + k)
+                : _cap_parse_int(words[i + k], values + i + k);
+            if (*result != WCR_OK) {
+                return i + k;
+            }
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+#if defined(_CAP_X86_SIMD)
+        bool negative;
+        _CapDigitRun run;
+        const char * start = level >= _CAP_SIMD_SSE41
+            ? _cap_batch_number_start(words[i], false, &negative)
+            : NULL;
+        if (start && _cap_scan_digit_run_sse41(start, false, limit, &run)) {
+            *result = _cap_finish_int(
+                words[i], start, &run, negative, values + i);
+        } else {
+            *result = _cap_parse_int(words[i], values + i);
+        }
+#else
+        (void) level;
+        *result = _cap_parse_int(words[i], values + i);
+#endif
+        if (*result != WCR_OK) {
+            return i;
+        }
+    }
+    return count;
+}
+
+static size_t _cap_parse_double_batch(
+        const char * const * words, size_t count, const char * limit,
+        double * values, WordConversionResult * result) {
+    // the same as `_cap_parse_int_batch`, for doubles
+    return _cap_parse_double_batch_with(
+        words, count, limit, values, result, _cap_simd_level());
+}
+
+static size_t _cap_parse_double_batch_with(
+        const char * const * words, size_t count, const char * limit,
+        double * values, WordConversionResult * result, _CapSimdLevel level) {
+    *result = WCR_OK;
+    size_t i = 0u;
+#if defined(_CAP_X86_SIMD)
+    for (; level >= _CAP_SIMD_AVX2 && i + 1u < count; i += 2u) {
+        const char * starts[2];
+        bool negative[2];
+        _CapDigitRun runs[2];
+        starts[0] = _cap_batch_number_start(words[i], true, negative);
+        starts[1] = _cap_batch_number_start(words[i + 1u], true, negative + 1);
+        const unsigned int handled = starts[0] && starts[1]
+            ? _cap_scan_digit_runs_avx2(starts, true, limit, runs)
+            : 0u;
+        for (size_t k = 0u; k < 2u; ++k) {
+            *result = handled & (1u << k)
+                ? _cap_finish_double(
+                    words[i + k], starts[k], runs + k, negative[k],
+                    values + i + k)
+                : _cap_parse_double(words[i + k], values + i + k);
+            if (*result != WCR_OK) {
+                return i + k;
+            }
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+#if defined(_CAP_X86_SIMD)
+        bool negative;
+        _CapDigitRun run;
+        const char * start = level >= _CAP_SIMD_SSE41
+            ? _cap_batch_number_start(words[i], true, &negative)
+            : NULL;
+        if (start && _cap_scan_digit_run_sse41(start, true, limit, &run)) {
+            *result = _cap_finish_double(
+                words[i], start, &run, negative, values + i);
+        } else {
+            *result = _cap_parse_double(words[i], values + i);
+        }
+#else
+        (void) level;
+        *result = _cap_parse_double(words[i], values + i);
+#endif
+        if (*result != WCR_OK) {
+            return i;
+        }
+    }
+    return count;
+}
+
+static const char * _cap_batch_number_start(
+        const char * word, bool allow_point, bool * negative) {
+    // skips the sign of a word which a kernel can handle, returns `NULL` for
+    // other words. Integers starting with `0` may be octal or hexadecimal.
+    *negative = *word == '-';
+    if (*word == '-' || *word == '+') {
+        ++word;
+    }
+    if (allow_point) {
+        return (*word >= '0' && *word <= '9') || *word == '.' ? word : NULL;
+    }
+    return *word >= '1' && *word <= '9' ? word : NULL;
+}
+
+static WordConversionResult _cap_finish_int(
+        const char * word, const char * start, const _CapDigitRun * run,
+        bool negative, int * value) {
+    // the run must make up the rest of the word
+    if (start[run -> mLength]) {
+        return _cap_parse_int(word, value);
+    }
+    const uint64_t limit = negative
+        ? (uint64_t) INT_MAX + 1u
+        : (uint64_t) INT_MAX;
+    if (run -> mDigits > limit) {
+        return WCR_OUT_OF_RANGE;
+    }
+    *value = negative
+        ? (int) -(long long int) run -> mDigits
+        : (int) run -> mDigits;
+    return WCR_OK;
+}
+
+static WordConversionResult _cap_finish_double(
+        const char * word, const char * start, const _CapDigitRun * run,
+        bool negative, double * value) {
+    // the run may be followed by an exponent, which is read here
+    const char * c = start + run -> mLength;
+    int64_t exponent = 0;
+    if ((*c | 0x20) == 'e') {
+        ++c;
+        const bool negative_exponent = *c == '-';
+        if (*c == '-' || *c == '+') {
+            ++c;
+        }
+        // larger exponents lead to zero or infinity anyway
+        static const int64_t MAX_EXPONENT = 100000;
+        const char * first = c;
+        for (; *c >= '0' && *c <= '9'; ++c) {
+            if (exponent < MAX_EXPONENT) {
+                exponent = exponent * 10 + (*c - '0');
+            }
+        }
+        if (c == first) {
+            return _cap_parse_double(word, value);
+        }
+        exponent = negative_exponent ? -exponent : exponent;
+    }
+    if (*c) {
+        return _cap_parse_double(word, value);
+    }
+    const _CapDecimal decimal = {
+        .mSignificand = run -> mDigits,
+        .mExponent = exponent - run -> mFractionDigits,
+        .mTruncated = false
+    };
+    WordConversionResult result;
+    _cap_decimal_to_double(&decimal, negative, value, &result);
+    return result;
+}
+
+static bool _cap_digit_run_layout(
+        unsigned int digit_mask, unsigned int point_mask, _CapDigitRun * run) {
+    // finds the run of digits with at most one point at the start of a block
+    // of 16 bytes, given bit masks of the bytes which are digits and points.
+    // Returns `false` if the run is empty, or does not end within the block.
+    const unsigned int first_point = point_mask & (0u - point_mask);
+    const unsigned int end_mask = ~(digit_mask | first_point) & 0xFFFFu;
+    if (!end_mask) {
+        return false;
+    }
+    const int length = __builtin_ctz(end_mask);
+    const bool has_point = first_point && first_point < (1u << length);
+    run -> mLength = length;
+    run -> mDigitCount = length - has_point;
+    run -> mFractionDigits = has_point
+        ? length - 1 - __builtin_ctz(first_point)
+        : 0;
+    return run -> mDigitCount > 0;
+}
+
+#if defined(_CAP_X86_SIMD)
+
+/**
+ * Shuffle indices which move `n` digits to the end of a register, loaded from
+ * offset `n`. The indices of unused bytes are negative, so they become zero.
+ */
+static const signed char _CAP_DIGIT_SHUFFLE[32] = {
+    -16, -15, -14, -13, -12, -11, -10, -9, -8, -7, -6, -5, -4, -3, -2, -1,
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15
+};
+
+/**
+ * Subtracted from the shuffle indices of digits after the point, so that they
+ * skip it, loaded from the offset given by `_cap_point_skip_offset`.
+ */
+static const signed char _CAP_POINT_SKIP[32] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+static int _cap_point_skip_offset(const _CapDigitRun * run) {
+    // the last `mFractionDigits` bytes of the register hold digits after the
+    // point
+    return run -> mFractionDigits;
+}
+
+static bool _cap_can_load_16(const char * c, const char * limit) {
+    // 16 bytes can be loaded without reading past the end of the buffer
+    return limit && limit - c >= 16;
+}
+
+__attribute__((target("sse4.1")))
+static bool _cap_scan_digit_run_sse41(
+        const char * c, bool allow_point, const char * limit,
+        _CapDigitRun * run) {
+    if (!_cap_can_load_16(c, limit)) {
+        return false;
+    }
+    const __m128i chars = _mm_loadu_si128((const __m128i *) c);
+    const __m128i digits = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    const __m128i is_digit = _mm_cmpeq_epi8(
+        _mm_min_epu8(digits, _mm_set1_epi8(9)), digits);
+    const unsigned int point_mask = allow_point
+        ? (unsigned int) _mm_movemask_epi8(
+            _mm_cmpeq_epi8(chars, _mm_set1_epi8('.')))
+        : 0u;
+    if (!_cap_digit_run_layout(
+            (unsigned int) _mm_movemask_epi8(is_digit), point_mask, run)) {
+        return false;
+    }
+    // move the digits to the end of the register, skipping the point
+    const __m128i indices = _mm_sub_epi8(
+        _mm_loadu_si128(
+            (const __m128i *) (_CAP_DIGIT_SHUFFLE + run -> mDigitCount)),
+        _mm_loadu_si128(
+            (const __m128i *) (_CAP_POINT_SKIP + _cap_point_skip_offset(run))));
+    const __m128i aligned = _mm_shuffle_epi8(digits, indices);
+    // combine 2, 4 and 8 digits
+    const __m128i pairs = _mm_maddubs_epi16(
+        aligned,
+        _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+    const __m128i quads = _mm_madd_epi16(
+        pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+    const __m128i octets = _mm_madd_epi16(
+        _mm_packus_epi32(quads, quads),
+        _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+    run -> mDigits = (uint64_t) (uint32_t) _mm_cvtsi128_si32(octets)
+        * 100000000u + (uint32_t) _mm_extract_epi32(octets, 1);
+    return true;
+}
+
+__attribute__((target("avx2")))
+static unsigned int _cap_scan_digit_runs_avx2(
+        const char * const * c, bool allow_point, const char * limit,
+        _CapDigitRun * runs) {
+    // the same as `_cap_scan_digit_run_sse41` for two words at once, one in
+    // each 128-bit lane. Returns a bit mask of the words which were handled.
+    if (!_cap_can_load_16(c[0], limit) || !_cap_can_load_16(c[1], limit)) {
+        return 0u;
+    }
+    const __m256i chars = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *) c[0])),
+        _mm_loadu_si128((const __m128i *) c[1]), 1);
+    const __m256i digits = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));
+    const __m256i is_digit = _mm256_cmpeq_epi8(
+        _mm256_min_epu8(digits, _mm256_set1_epi8(9)), digits);
+    const unsigned int digit_mask
+        = (unsigned int) _mm256_movemask_epi8(is_digit);
+    const unsigned int point_mask = allow_point
+        ? (unsigned int) _mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('.')))
+        : 0u;
+    unsigned int handled = 0u;
+    for (int k = 0; k < 2; ++k) {
+        if (_cap_digit_run_layout(
+                (digit_mask >> (16 * k)) & 0xFFFFu,
+                (point_mask >> (16 * k)) & 0xFFFFu, runs + k)) {
+            handled |= 1u << k;
+        }
+    }
+    if (!handled) {
+        return 0u;
+    }
+    // a lane which was not handled uses the indices of an empty run
+    const int counts[2] = {
+        handled & 1u ? runs[0].mDigitCount : 0,
+        handled & 2u ? runs[1].mDigitCount : 0
+    };
+    const int skips[2] = {
+        handled & 1u ? _cap_point_skip_offset(runs) : 0,
+        handled & 2u ? _cap_point_skip_offset(runs + 1) : 0
+    };
+    const __m256i indices = _mm256_sub_epi8(
+        _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128(
+                (const __m128i *) (_CAP_DIGIT_SHUFFLE + counts[0]))),
+            _mm_loadu_si128((const __m128i *) (_CAP_DIGIT_SHUFFLE + counts[1])),
+            1),
+        _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128(
+                (const __m128i *) (_CAP_POINT_SKIP + skips[0]))),
+            _mm_loadu_si128((const __m128i *) (_CAP_POINT_SKIP + skips[1])),
+            1));
+    const __m256i aligned = _mm256_shuffle_epi8(digits, indices);
+    const __m256i pairs = _mm256_maddubs_epi16(
+        aligned, _mm256_set1_epi16(0x010A));
+    const __m256i quads = _mm256_madd_epi16(
+        pairs, _mm256_set1_epi32(0x00010064));
+    const __m256i octets = _mm256_madd_epi16(
+        _mm256_packus_epi32(quads, quads), _mm256_set1_epi32(0x00012710));
+    const __m128i lanes[2] = {
+        _mm256_castsi256_si128(octets),
+        _mm256_extracti128_si256(octets, 1)
+    };
+    for (int k = 0; k < 2; ++k) {
+        runs[k].mDigits = (uint64_t) (uint32_t) _mm_cvtsi128_si32(lanes[k])
+            * 100000000u + (uint32_t) _mm_extract_epi32(lanes[k], 1);
+    }
+    return handled;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,480 @@
+#ifndef __COMPILED_PARSER_H__
+#define __COMPILED_PARSER_H__
+
+/**
+ * @file
+ * @addtogroup parser
+ *
+ * A `CompiledParser` is an immutable, self-contained snapshot of a configured
+ * `ArgumentParser`. It is created using `cap_parser_compile` once
+ * configuration-time is over, and can then be used to parse command lines any
+ * number of times using `cap_compiled_parser_parse` or
+ * `cap_compiled_parser_parse_noexit`.
+ *
+ * All data of a compiled parser (configured flags and positionals, their
+ * names, aliases, and descriptions, and the flag prefix table) is stored in
+ * a single contiguous block of memory, together with a prepared lookup index
+ * of flag names. A compiled parser is independent of the parser it was
+ * created from, so the original parser can be destroyed or reconfigured
+ * afterwards without affecting it. Everything parsing and printing could
+ * need is prepared by `cap_parser_compile`: the parsers of all subcommands
+ * (see `cap_parser_add_subcommand`) are built recursively, and help and usage
+ * messages are rendered (see `cap_parser_prepare_help`). A compiled parser is
+ * therefore never modified after creation, and a single compiled parser can
+ * be used by several threads at the same time.
+ *
+ * A compiled parser should be disposed of using `cap_compiled_parser_destroy`.
+ * `ParsedArguments` objects created by it are independent of it, just as if
+ * they were created by an `ArgumentParser`.
+ */
+
+#include "allocator.h"
+#include "flag_info.h"
+#include "parsed_arguments.h"
+#include "parser.h"
+#include "positional_info.h"
+#include "string_index.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @addtogroup parser
+ * @{
+ */
+
+// ============================================================================
+// === COMPILED PARSER ========================================================
+// ============================================================================
+
+/**
+ * Immutable snapshot of a configured `ArgumentParser`.
+ *
+ * Objects of this type are created using `cap_parser_compile` and destroyed
+ * using `cap_compiled_parser_destroy`. Their members should never be accessed
+ * or modified directly.
+ *
+ * @see cap_parser_compile
+ * @see cap_compiled_parser_parse
+ * @see cap_compiled_parser_destroy
+ */
+typedef struct {
+    /// Copy of the original configuration. All of its flags, positionals,
+    /// and strings point into the memory block which also stores this object.
+    /// Only the flag index, the index of subcommands, their built parsers,
+    /// rendered messages, and sorted completion names are allocated
+    /// separately.
+    ArgumentParser mParser;
+} CompiledParser;
+
+// ============================================================================
+// === COMPILED PARSER: DECLARATION OF PRIVATE FUNCTIONS ======================
+// ============================================================================
+
+static size_t _cap_compiled_string_size(const char * string);
+static size_t _cap_compiled_flag_string_size(const FlagInfo * info);
+static void * _cap_compiled_take(char ** cursor, size_t size);
+static char * _cap_compiled_copy_string(char ** cursor, const char * string);
+static void _cap_compiled_copy_flag(
+    FlagInfo * dst, const FlagInfo * src, char *** alias_cursor,
+    char ** string_cursor);
+static void _cap_compiled_prepare_help(ArgumentParser * parser);
+
+// ============================================================================
+// === COMPILED PARSER: CREATION AND DESTRUCTION ==============================
+// ============================================================================
+
+/**
+ * Compiles a configured parser.
+ *
+ * Creates an immutable snapshot of `parser`, which can be used for parsing
+ * instead of the original. The snapshot copies all configuration, so it is
+ * not affected by later changes to `parser`, nor by destroying it. The caller
+ * becomes the owner of the new object and should dispose of it using
+ * `cap_compiled_parser_destroy`.
+ *
+ * The builders of all subcommands, and of their subcommands, are run now
+ * (see `cap_parser_build_subcommands`), and the help messages and usage
+ * strings of all these parsers are rendered. Only help messages which use
+ * description providers are still rendered for each print.
+ *
+ * @param parser configured parser to compile
+ * @return new compiled parser, or `NULL` if `parser` is `NULL`
+ */
+CompiledParser * cap_parser_compile(const ArgumentParser * parser) {
+    if (!parser) {
+        return NULL;
+    }
+    const size_t flag_count = parser -> mFlagCount;
+    const size_t positional_count = parser -> mPositionalCount;
+    const size_t subcommand_count = parser -> mSubcommandCount;
+    const size_t special_count = (parser -> mHelpFlagInfo ? 1u : 0u)
+        + (parser -> mFlagSeparatorInfo ? 1u : 0u);
+
+    // measure everything so that a single allocation is enough
+    size_t alias_count = 0u;
+    size_t string_size = _cap_compiled_string_size(parser -> mProgramName)
+        + _cap_compiled_string_size(parser -> mDescription)
+        + _cap_compiled_string_size(parser -> mEpilogue)
+        + _cap_compiled_string_size(parser -> mCustomHelp)
+        + _cap_compiled_string_size(parser -> mCustomUsage)
+        + _cap_compiled_string_size(parser -> mFlagPrefixChars);
+    for (size_t i = 0u; i < flag_count; ++i) {
+        alias_count += parser -> mFlags[i] -> mAliasCount;
+        string_size += _cap_compiled_flag_string_size(parser -> mFlags[i]);
+    }
+    if (parser -> mHelpFlagInfo) {
+        alias_count += parser -> mHelpFlagInfo -> mAliasCount;
+        string_size += _cap_compiled_flag_string_size(parser -> mHelpFlagInfo);
+    }
+    if (parser -> mFlagSeparatorInfo) {
+        alias_count += parser -> mFlagSeparatorInfo -> mAliasCount;
+        string_size += _cap_compiled_flag_string_size(
+            parser -> mFlagSeparatorInfo);
+    }
+    for (size_t i = 0u; i < positional_count; ++i) {
+        const PositionalInfo * pi = parser -> mPositionals[i];
+        string_size += _cap_compiled_string_size(pi -> mName)
+            + _cap_compiled_string_size(pi -> mMetaVar)
+            + _cap_compiled_string_size(pi -> mDescription);
+    }
+    for (size_t i = 0u; i < subcommand_count; ++i) {
+        const _CapSubcommand * sc = parser -> mSubcommands + i;
+        string_size += _cap_compiled_string_size(sc -> mName)
+            + _cap_compiled_string_size(sc -> mDescription);
+    }
+
+    // all types stored before the strings have sizes that are multiples of
+    // their alignment, so carving them in this order keeps them aligned
+    const size_t block_size = sizeof(CompiledParser)
+        + (flag_count + special_count) * sizeof(FlagInfo)
+        + flag_count * sizeof(FlagInfo *)
+        + positional_count * sizeof(PositionalInfo)
+        + positional_count * sizeof(PositionalInfo *)
+        + subcommand_count * sizeof(_CapSubcommand)
+        + alias_count * sizeof(char *)
+        + string_size;
+    char * cursor = (char *) cap_malloc(block_size);
+    CompiledParser * cp = (CompiledParser *) _cap_compiled_take(
+        &cursor, sizeof(CompiledParser));
+    FlagInfo * flags = (FlagInfo *) _cap_compiled_take(
+        &cursor, (flag_count + special_count) * sizeof(FlagInfo));
+    FlagInfo ** flag_pointers = (FlagInfo **) _cap_compiled_take(
+        &cursor, flag_count * sizeof(FlagInfo *));
+    PositionalInfo * positionals = (PositionalInfo *) _cap_compiled_take(
+        &cursor, positional_count * sizeof(PositionalInfo));
+    PositionalInfo ** positional_pointers = (PositionalInfo **)
+        _cap_compiled_take(&cursor, positional_count * sizeof(PositionalInfo *));
+    _CapSubcommand * subcommands = (_CapSubcommand *) _cap_compiled_take(
+        &cursor, subcommand_count * sizeof(_CapSubcommand));
+    char ** aliases = (char **) _cap_compiled_take(
+        &cursor, alias_count * sizeof(char *));
+
+    ArgumentParser * p = &(cp -> mParser);
+    *p = *parser;
+    // the sorted names are not shared, they are sorted once all names are
+    // copied
+    _cap_parser_init_texts(p);
+    p -> mEnableCompletion = false;
+    p -> mProgramName = _cap_compiled_copy_string(
+        &cursor, parser -> mProgramName);
+    p -> mDescription = _cap_compiled_copy_string(
+        &cursor, parser -> mDescription);
+    p -> mEpilogue = _cap_compiled_copy_string(&cursor, parser -> mEpilogue);
+    p -> mCustomHelp = _cap_compiled_copy_string(
+        &cursor, parser -> mCustomHelp);
+    p -> mCustomUsage = _cap_compiled_copy_string(
+        &cursor, parser -> mCustomUsage);
+    p -> mFlagPrefixChars = _cap_compiled_copy_string(
+        &cursor, parser -> mFlagPrefixChars);
+    p -> mFlagIndex = cap_si_make_empty();
+
+    p -> mFlags = flag_pointers;
+    p -> mFlagAlloc = flag_count;
+    for (size_t i = 0u; i < flag_count; ++i) {
+        _cap_compiled_copy_flag(
+            flags + i, parser -> mFlags[i], &aliases, &cursor);
+        flag_pointers[i] = flags + i;
+        _cap_parser_index_flag(p, flags + i, i);
+    }
+    FlagInfo * special = flags + flag_count;
+    if (parser -> mHelpFlagInfo) {
+        _cap_compiled_copy_flag(
+            special, parser -> mHelpFlagInfo, &aliases, &cursor);
+        p -> mHelpFlagInfo = special++;
+        _cap_parser_index_flag(p, p -> mHelpFlagInfo, _CAP_HELP_FLAG_ID);
+    }
+    if (parser -> mFlagSeparatorInfo) {
+        _cap_compiled_copy_flag(
+            special, parser -> mFlagSeparatorInfo, &aliases, &cursor);
+        p -> mFlagSeparatorInfo = special++;
+        _cap_parser_index_flag(
+            p, p -> mFlagSeparatorInfo, _CAP_FLAG_SEPARATOR_ID);
+    }
+
+    p -> mPositionals = positional_pointers;
+    p -> mPositionalAlloc = positional_count;
+    for (size_t i = 0u; i < positional_count; ++i) {
+        const PositionalInfo * src = parser -> mPositionals[i];
+        PositionalInfo * dst = positionals + i;
+        *dst = *src;
+        dst -> mName = _cap_compiled_copy_string(&cursor, src -> mName);
+        dst -> mMetaVar = _cap_compiled_copy_string(&cursor, src -> mMetaVar);
+        dst -> mDescription = _cap_compiled_copy_string(
+            &cursor, src -> mDescription);
+        positional_pointers[i] = dst;
+    }
+
+    // parsers of subcommands are built again, for the compiled parser alone
+    p -> mSubcommands = subcommands;
+    p -> mSubcommandAlloc = subcommand_count;
+    for (size_t i = 0u; i < subcommand_count; ++i) {
+        const _CapSubcommand * src = parser -> mSubcommands + i;
+        subcommands[i] = *src;
+        subcommands[i].mName = _cap_compiled_copy_string(&cursor, src -> mName);
+        subcommands[i].mDescription = _cap_compiled_copy_string(
+            &cursor, src -> mDescription);
+        subcommands[i].mParser = NULL;
+    }
+    _cap_parser_index_subcommands(p);
+    cap_parser_enable_completion(p, parser -> mEnableCompletion);
+    cap_parser_build_subcommands(p);
+    _cap_compiled_prepare_help(p);
+    return cp;
+}
+
+/**
+ * Destroys a `CompiledParser` object.
+ *
+ * `ParsedArguments` created using the compiled parser are not affected.
+ *
+ * @param compiled object to destroy. If it is `NULL`, nothing happens.
+ */
+void cap_compiled_parser_destroy(CompiledParser * compiled) {
+    if (!compiled) {
+        return;
+    }
+    cap_si_destroy(compiled -> mParser.mFlagIndex);
+    _cap_parser_release_subparsers(&(compiled -> mParser));
+    _cap_parser_release_texts(&(compiled -> mParser));
+    // everything else lives in the same block as the object itself
+    cap_free(compiled);
+}
+
+// ============================================================================
+// === COMPILED PARSER: IDS OF FLAGS AND POSITIONALS ==========================
+// ============================================================================
+
+/**
+ * Finds the id of a flag.
+ *
+ * Ids are the same as in the parser from which `compiled` was created.
+ *
+ * @see cap_parser_get_flag_id
+ */
+bool cap_compiled_parser_get_flag_id(
+        const CompiledParser * compiled, const char * name, size_t * id) {
+    if (!compiled) {
+        return false;
+    }
+    return cap_parser_get_flag_id(&(compiled -> mParser), name, id);
+}
+
+/**
+ * Finds the id of a positional argument.
+ *
+ * Ids are the same as in the parser from which `compiled` was created.
+ *
+ * @see cap_parser_get_positional_id
+ */
+bool cap_compiled_parser_get_positional_id(
+        const CompiledParser * compiled, const char * name, size_t * id) {
+    if (!compiled) {
+        return false;
+    }
+    return cap_parser_get_positional_id(&(compiled -> mParser), name, id);
+}
+
+// ============================================================================
+// === COMPILED PARSER: PARSING AND HELP ======================================
+// ============================================================================
+
+/**
+ * Parses command line arguments without exiting on error.
+ *
+ * Behaves exactly like `cap_parser_parse_noexit` called with the parser from
+ * which `compiled` was created (at the time of compilation).
+ *
+ * @param compiled compiled parser to use
+ * @param argc number of command line arguments
+ * @param argv array of command line arguments
+ * @return result of the parsing, containing a `ParsedArguments` if parsing was
+ *         successful.
+ */
+ParsingResult cap_compiled_parser_parse_noexit(
+        const CompiledParser * compiled, int argc, const char ** argv) {
+    return _cap_parser_parse_noexit(&(compiled -> mParser), argc, argv);
+}
+
+/**
+ * Parses command line arguments into an existing `ParsedArguments`.
+ *
+ * Behaves exactly like `cap_parser_parse_into_noexit` called with the parser
+ * from which `compiled` was created (at the time of compilation).
+ *
+ * @param compiled compiled parser to use
+ * @param args object to store the result into
+ * @param argc number of command line arguments
+ * @param argv array of command line arguments
+ * @return result of the parsing. If parsing was successful, the result
+ *         contains `args`.
+ */
+ParsingResult cap_compiled_parser_parse_into_noexit(
+        const CompiledParser * compiled, ParsedArguments * args, int argc,
+        const char ** argv) {
+    return cap_parser_parse_into_noexit(
+        &(compiled -> mParser), args, argc, argv);
+}
+
+/**
+ * Parses command line arguments.
+ *
+ * Behaves exactly like `cap_parser_parse` called with the parser from which
+ * `compiled` was created (at the time of compilation). On error, the program
+ * exits with an error message.
+ *
+ * @param compiled compiled parser to use
+ * @param argc number of command line words
+ * @param argv array of command line words
+ * @return pointer to a new `ParsedArguments` object containing information on
+ *         parsed flags and positional arguments.
+ */
+ParsedArguments * cap_compiled_parser_parse(
+        const CompiledParser * compiled, int argc, const char ** argv) {
+    _cap_parser_check_completion(&(compiled -> mParser), argc, argv);
+    ParsingResult result = _cap_parser_parse_all(
+        &(compiled -> mParser), argc, argv);
+    return _cap_parser_finish_parsing(&(compiled -> mParser), result, argv);
+}
+
+/**
+ * Prints a usage string.
+ *
+ * @see cap_parser_print_usage
+ */
+void cap_compiled_parser_print_usage(
+        const CompiledParser * compiled, FILE * file, const char * argv0) {
+    if (!compiled) {
+        return;
+    }
+    cap_parser_print_usage(&(compiled -> mParser), file, argv0);
+}
+
+/**
+ * Prints a help message.
+ *
+ * @see cap_parser_print_help
+ */
+void cap_compiled_parser_print_help(
+        const CompiledParser * compiled, FILE * file) {
+    if (!compiled) {
+        return;
+    }
+    cap_parser_print_help(&(compiled -> mParser), file);
+}
+
+/**
+ * Formats a usage string.
+ *
+ * @see cap_parser_format_usage
+ */
+size_t cap_compiled_parser_format_usage(
+        const CompiledParser * compiled, const char * argv0, char * buffer,
+        size_t size) {
+    return cap_parser_format_usage(
+        compiled ? &(compiled -> mParser) : NULL, argv0, buffer, size);
+}
+
+/**
+ * Formats a help message.
+ *
+ * @see cap_parser_format_help
+ */
+size_t cap_compiled_parser_format_help(
+        const CompiledParser * compiled, char * buffer, size_t size) {
+    return cap_parser_format_help(
+        compiled ? &(compiled -> mParser) : NULL, buffer, size);
+}
+
+// ============================================================================
+// === COMPILED PARSER: IMPLEMENTATION OF PRIVATE FUNCTIONS ===================
+// ============================================================================
+
+static size_t _cap_compiled_string_size(const char * string) {
+    return string ? strlen(string) + 1u : 0u;
+}
+
+static size_t _cap_compiled_flag_string_size(const FlagInfo * info) {
+    size_t size = _cap_compiled_string_size(info -> mName)
+        + _cap_compiled_string_size(info -> mMetaVar)
+        + _cap_compiled_string_size(info -> mDescription);
+    for (size_t i = 0u; i < info -> mAliasCount; ++i) {
+        size += _cap_compiled_string_size(info -> mAliases[i]);
+    }
+    return size;
+}
+
+static void * _cap_compiled_take(char ** cursor, size_t size) {
+    void * taken = *cursor;
+    *cursor += size;
+    return taken;
+}
+
+static char * _cap_compiled_copy_string(char ** cursor, const char * string) {
+    if (!string) {
+        return NULL;
+    }
+    const size_t size = strlen(string) + 1u;
+    char * copy = (char *) _cap_compiled_take(cursor, size);
+    memcpy(copy, string, size);
+    return copy;
+}
+
+static void _cap_compiled_copy_flag(
+        FlagInfo * dst, const FlagInfo * src, char *** alias_cursor,
+        char ** string_cursor) {
+    *dst = *src;
+    dst -> mName = _cap_compiled_copy_string(string_cursor, src -> mName);
+    dst -> mMetaVar = _cap_compiled_copy_string(
+        string_cursor, src -> mMetaVar);
+    dst -> mDescription = _cap_compiled_copy_string(
+        string_cursor, src -> mDescription);
+    dst -> mShortestName = dst -> mName;
+    dst -> mAliases = *alias_cursor;
+    dst -> mAliasAlloc = src -> mAliasCount;
+    for (size_t i = 0u; i < src -> mAliasCount; ++i) {
+        dst -> mAliases[i] = _cap_compiled_copy_string(
+            string_cursor, src -> mAliases[i]);
+        if (src -> mShortestName == src -> mAliases[i]) {
+            dst -> mShortestName = dst -> mAliases[i];
+        }
+    }
+    *alias_cursor += src -> mAliasCount;
+}
+
+static void _cap_compiled_prepare_help(ArgumentParser * parser) {
+    // renders the messages of the parser and of the parsers of all its
+    // subcommands, which are already built
+    cap_parser_prepare_help(parser);
+    for (size_t i = 0u; i < parser -> mSubcommandCount; ++i) {
+        _cap_compiled_prepare_help(parser -> mSubcommands[i].mParser);
+    }
+}
+
+/**
+ * @}
+ */
+
+#endif
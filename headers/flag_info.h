@@ -3,12 +3,14 @@
 
 /** @file */
 
+#include "allocator.h"
 #include "data_type.h"
 #include "helper_functions.h"
 #include "typed_union.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 // ============================================================================
 // === FLAG INFO ==============================================================
@@ -27,6 +29,14 @@ typedef struct {
     char ** mAliases;
     size_t mAliasCount;
     size_t mAliasAlloc;
+    /// the shortest of `mName` and `mAliases`, used in usage messages
+    const char * mShortestName;
+    /// if `true`, all strings (including aliases) are borrowed from the
+    /// caller and are not released
+    bool mStaticStrings;
+    /// supplies the description instead of `mDescription`, or `NULL`
+    DescriptionProvider mDescriptionProvider;
+    void * mDescriptionContext;
 } FlagInfo;
 
 /**
@@ -58,7 +68,9 @@ static const char * cap_get_flag_metavar(const FlagInfo * fi) {
  *cap_flag_info_destroy.
  *
  * All strings given to this function are copied into the new object (if they
- * are not NULL).
+ * are not NULL), unless `static_strings` is `true`. In that case, the object
+ * stores the pointers themselves, so the strings must outlive it (e.g. string
+ * literals). Aliases added later are handled the same way.
  *
  * @param name null-terminated name of the flag
  * @param meta_var optional null-terminated representation of the flag's value.
@@ -72,26 +84,62 @@ static const char * cap_get_flag_metavar(const FlagInfo * fi) {
  * @param max_count maximum number of times the flag should be present. Must
  *        not be less than min_count, or a negative number. If a negative 
  *        number is given, there is no upper limit.
+ * @param static_strings if the strings should be borrowed instead of copied
  * @return new FlagInfo object
  */
 static FlagInfo * cap_flag_info_make(
         const char * name, const char * meta_var, const char * description,
-        DataType type, int min_count, int max_count) {
-    FlagInfo * info = (FlagInfo *) malloc(sizeof(FlagInfo));
+        DataType type, int min_count, int max_count, bool static_strings) {
+    FlagInfo * info = (FlagInfo *) cap_malloc(sizeof(FlagInfo));
+    // borrowed strings are never modified, nor released
     *info = (FlagInfo) {
-        .mName = copy_string(name),
-        .mMetaVar = copy_string(meta_var),
-	.mDescription = copy_string(description),
+        .mName = static_strings ? (char *) name : copy_string(name),
+        .mMetaVar = static_strings ? (char *) meta_var : copy_string(meta_var),
+	.mDescription = static_strings
+            ? (char *) description : copy_string(description),
         .mType = type,
         .mMinCount = min_count,
         .mMaxCount = max_count,
         .mAliases = NULL,
         .mAliasCount = 0,
-        .mAliasAlloc = 0
+        .mAliasAlloc = 0,
+        .mShortestName = NULL,
+        .mStaticStrings = static_strings,
+        .mDescriptionProvider = NULL,
+        .mDescriptionContext = NULL
     };
+    info -> mShortestName = info -> mName;
     return info;
 }
 
+/**
+ * Registers an alias of a flag.
+ *
+ * Stores a copy of `alias` among the aliases of `info` (or `alias` itself if
+ * the strings of `info` are static). If the alias is 
+ * shorter than all other names of the flag, it also becomes its shortest name.
+ * Validity of the alias (e.g. uniqueness) is not checked here.
+ *
+ * @param info flag to add the alias to
+ * @param alias null-terminated alias
+ * @return the alias stored in `info`
+ */
+static const char * cap_flag_info_add_alias(
+        FlagInfo * info, const char * alias) {
+    if (info -> mAliasCount >= info -> mAliasAlloc) {
+        info -> mAliasAlloc = info -> mAliasAlloc ? 2 * info -> mAliasAlloc : 1u;
+        info -> mAliases = (char **) cap_realloc(
+            info -> mAliases, info -> mAliasAlloc * sizeof(char *));
+    }
+    char * alias_copy = info -> mStaticStrings
+        ? (char *) alias : copy_string(alias);
+    info -> mAliases[info -> mAliasCount++] = alias_copy;
+    if (strlen(alias_copy) < strlen(info -> mShortestName)) {
+        info -> mShortestName = alias_copy;
+    }
+    return alias_copy;
+}
+
 /**
  * Destructor for FlagInfo objects
  *
@@ -104,34 +152,51 @@ static void cap_flag_info_destroy(FlagInfo * info) {
     if (!info) {
         return;
     }
-    delete_string_property(&(info -> mName));
-    delete_string_property(&(info -> mMetaVar));
-    delete_string_property(&(info -> mDescription));
-    for (size_t i = 0u; i < info -> mAliasCount; ++i) {
-        delete_string_property(info -> mAliases + i);
+    if (!info -> mStaticStrings) {
+        delete_string_property(&(info -> mName));
+        delete_string_property(&(info -> mMetaVar));
+        delete_string_property(&(info -> mDescription));
+        for (size_t i = 0u; i < info -> mAliasCount; ++i) {
+            delete_string_property(info -> mAliases + i);
+        }
     }
-    free(info -> mAliases);
+    cap_free(info -> mAliases);
     info -> mAliases = NULL;
-    free(info);
+    cap_free(info);
 }
 
 /**
  * Displays a FlagInfo object
  *
- * Prints a FlagInfo into a given file. The format is suitable for help 
+ * Appends a FlagInfo to a given text buffer. The format is suitable for help
  * messages.
  *
- * @param file file to display into
+ * @param text buffer to display into
  * @flag object to display
  */
-static void cap_print_flag_info(FILE * file, const FlagInfo * flag) {
+static void cap_format_flag_info(TextBuffer * text, const FlagInfo * flag) {
     const char * metavar = flag -> mType == DT_PRESENCE ? NULL : cap_get_flag_metavar(flag);
-    fprintf(file, "%s %s\n", flag -> mName, metavar ? metavar : "");
+    cap_text_append_string(text, flag -> mName);
+    cap_text_append_char(text, ' ');
+    if (metavar) {
+        cap_text_append_string(text, metavar);
+    }
+    cap_text_append_char(text, '\n');
     for (size_t i = 0u; i < flag -> mAliasCount; ++i) {
-        fprintf(file, "%s %s\n", flag -> mAliases[i], metavar ? metavar : "");
+        cap_text_append_string(text, flag -> mAliases[i]);
+        cap_text_append_char(text, ' ');
+        if (metavar) {
+            cap_text_append_string(text, metavar);
+        }
+        cap_text_append_char(text, '\n');
     }
-    if (flag -> mDescription) {
-        fprintf(file, "\t%s\n", flag -> mDescription);
+    const char * description = cap_describe(
+        flag -> mDescription, flag -> mDescriptionProvider,
+        flag -> mDescriptionContext);
+    if (description) {
+        cap_text_append_char(text, '\t');
+        cap_text_append_string(text, description);
+        cap_text_append_char(text, '\n');
     }
 }
 
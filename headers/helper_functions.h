@@ -3,6 +3,7 @@
 
 /** @file */
 
+#include "allocator.h"
 #include "data_type.h"
 
 #include <stdlib.h>
@@ -17,7 +18,7 @@
  * 
  * Copies the given null-terminated string into newly allocated memory. 
  * The caller becomes the owner of that memoroy and should deallocate it
- * using `free` when it is no longer needed. If `NULL` is given, `NULL` is 
+ * using `cap_free` when it is no longer needed. If `NULL` is given, `NULL` is 
  * also returned.
  * 
  * @param string original null-terminated string
@@ -28,7 +29,7 @@ char * copy_string(const char * string) {
         return NULL;
     }
     const int len = strlen(string);
-    char * copy = (char *) malloc((len + 1) * sizeof(char));
+    char * copy = (char *) cap_malloc((len + 1) * sizeof(char));
     memcpy(copy, string, len + 1);
     return copy;
 }
@@ -39,7 +40,7 @@ char * copy_string(const char * string) {
  * Replaces a string stored in `*property` with a copy of `value`. If 
  * `*property` is a string already, it is first deleted using 
  * `delete_string_property`. The caller must be the owner of the original 
- * string. The original must have been allocated using `malloc`.
+ * string. The original must have been allocated using `cap_malloc`.
  * 
  * The new value must be either `NULL`, or a null-terminated string. If it is 
  * not `NULL`, a copy is created and stored. The owner of `property` becomes 
@@ -53,7 +54,7 @@ void set_string_property(char ** property, const char * value) {
         return;
     }
     if (*property) {
-        free(*property);
+        cap_free(*property);
     }
     // copy_string returns NULL if its argument is NULL
     *property = copy_string(value);
@@ -64,7 +65,7 @@ void set_string_property(char ** property, const char * value) {
  * 
  * Deallocates a string and replaces it with `NULL`. The string in question 
  * must be owned by the caller and it must have been previously allocated 
- * using `malloc`.
+ * using `cap_malloc`.
  * 
  * @param property pointer to a string that should be deleted
  */
@@ -72,6 +73,99 @@ void delete_string_property(char ** property) {
     set_string_property(property, NULL);
 }
 
+// ============================================================================
+// === DESCRIPTION PROVIDERS ==================================================
+// ============================================================================
+
+/**
+ * Supplies a text of a help message on demand.
+ * 
+ * Instead of a description, a function of this type can be configured, e.g.
+ * using `cap_parser_set_flag_description_provider`. It is only called when
+ * a help message is rendered, so texts which are expensive to produce (e.g.
+ * translated ones) cost nothing unless help is requested. It is called each
+ * time the message is printed or formatted, since a help message which uses
+ * providers is never kept by the parser (see `cap_parser_prepare_help`).
+ *
+ * @param context the pointer configured together with the function
+ * @return null-terminated text, or `NULL` if there is none. It is copied into
+ *         the rendered message.
+ */
+typedef const char * (* DescriptionProvider)(void * context);
+
+/**
+ * Gets a text of a help message.
+ * 
+ * @param text configured text, or `NULL`
+ * @param provider configured provider, or `NULL`
+ * @param context pointer passed to `provider`
+ * @return the text given by `provider` if there is one, `text` otherwise
+ */
+static const char * cap_describe(
+        const char * text, DescriptionProvider provider, void * context) {
+    return provider ? provider(context) : text;
+}
+
+// ============================================================================
+// === TEXT BUFFERS ===========================================================
+// ============================================================================
+
+/**
+ * Growing buffer of text.
+ *
+ * Help and usage messages are rendered into objects of this type, so they can
+ * be written with a single call. An object with all members zero is an empty
+ * buffer. Once anything is appended, `mData` is null-terminated and should be
+ * deallocated using `cap_free`.
+ */
+typedef struct {
+    char * mData;
+    size_t mLength;
+    size_t mAlloc;
+} TextBuffer;
+
+/**
+ * Appends characters to a text buffer.
+ *
+ * @param text buffer to append to
+ * @param string characters to append, need not be null-terminated
+ * @param length number of characters to append
+ */
+static void cap_text_append(
+        TextBuffer * text, const char * string, size_t length) {
+    if (text -> mLength + length + 1u > text -> mAlloc) {
+        size_t alloc_size = text -> mAlloc ? text -> mAlloc * 2u : 256u;
+        while (alloc_size < text -> mLength + length + 1u) {
+            alloc_size *= 2u;
+        }
+        text -> mData = (char *) cap_realloc(text -> mData, alloc_size);
+        text -> mAlloc = alloc_size;
+    }
+    memcpy(text -> mData + text -> mLength, string, length);
+    text -> mLength += length;
+    text -> mData[text -> mLength] = '\0';
+}
+
+/**
+ * Appends a null-terminated string to a text buffer.
+ *
+ * @param text buffer to append to
+ * @param string null-terminated string to append
+ */
+static void cap_text_append_string(TextBuffer * text, const char * string) {
+    cap_text_append(text, string, strlen(string));
+}
+
+/**
+ * Appends a single character to a text buffer.
+ *
+ * @param text buffer to append to
+ * @param c character to append
+ */
+static void cap_text_append_char(TextBuffer * text, char c) {
+    cap_text_append(text, &c, 1u);
+}
+
 /**
  * Get an string representation of type.
  *
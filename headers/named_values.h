@@ -17,8 +17,30 @@
  * or `cap_nv_make_empty()` and destroyed using `cap_nv_destroy()`. Calling the
  * destructor function ivalidates all data obtained from the object, e.g.
  * pointers to `TypedUnion`s.
+ * 
+ * A `NamedValues` stored in a `NamedValuesArray` may be backed by an `Arena`. 
+ * Its name, values, and strings stored in the values are then owned by the 
+ * arena and released together with it.
+ * 
+ * Most flags and positionals have a single value, so the first value is stored
+ * inline in the `NamedValues` object itself. A separate array is only
+ * allocated once more values are added.
+ *
+ * Values are normally stored as an array of `TypedUnion`s. If packing is
+ * enabled (it is by parsers configured using
+ * `cap_parser_enable_packed_values`), all values of one flag or positional
+ * normally have the same type, which is then recorded once, and the values
+ * are stored as a packed native array (`int[]`, `double[]` or `char *[]`).
+ * Functions such as `cap_nv_get_ints` return such an array directly. The
+ * first value is kept inline as well, so `cap_nv_get_value` always finds it,
+ * while `cap_nv_get_value_i` fails for the following packed values (except
+ * for `DT_PRESENCE` values, which are all the same). Values of different
+ * types can still be stored in one object, they are then kept as
+ * `TypedUnion`s.
  */
 
+#include "allocator.h"
+#include "arena.h"
 #include "helper_functions.h"
 #include "typed_union.h"
 
@@ -31,6 +53,9 @@
  * @{
  */
 
+/// number of values stored inline in a `NamedValues` before allocating
+#define _CAP_NV_INLINE_VALUES 1u
+
 // ============================================================================
 // === NAMED VALUES ===========================================================
 // ============================================================================
@@ -50,13 +75,27 @@ typedef struct {
     /// Name of the flag or posittional. The object should be considered the
     /// 'owner' of this string.
     char * mName;
-    /// Array of stored values. This object should be considered the owner 
-    /// of these values.
-    TypedUnion * mValues;
+    /// Type of all stored values, valid once a value is stored
+    DataType mType;
+    /// `true` if `mValues` holds `TypedUnion`s, because packing is disabled or
+    /// values of different types were stored
+    bool mMixed;
+    /// `true` if values of one type may be stored in a packed array
+    bool mPack;
+    /// Packed array of stored values, e.g. `int[]` for `DT_INT`, or `NULL`
+    /// while the values fit into `mInline`. This object should be considered
+    /// the owner of these values.
+    void * mValues;
     /// Number of values stored for this flag/positional
     size_t mValueCount;
-    /// Number of values that can currently be stored in `mValues`
+    /// Number of bytes allocated for `mValues`
     size_t mValueAlloc;
+    /// Storage for the first values, used while `mValues` is not allocated.
+    /// Once the values are packed, the first one is still kept here.
+    TypedUnion mInline[_CAP_NV_INLINE_VALUES];
+    /// Arena which owns the name, values, and strings stored in the values, 
+    /// or `NULL` if they are allocated on the heap
+    Arena * mArena;
 } NamedValues;
 
 // ============================================================================
@@ -64,6 +103,24 @@ typedef struct {
 // ============================================================================
 
 static NamedValues * _cap_nv_make_empty_inner(const char * name);
+static size_t _cap_nv_value_size(DataType type);
+static size_t _cap_nv_element_size(const NamedValues * nv);
+static bool _cap_nv_is_packed(const NamedValues * nv);
+static TypedUnion _cap_nv_load(const NamedValues * nv, size_t index);
+static void _cap_nv_store(
+    NamedValues * nv, size_t index, const TypedUnion value);
+static const void * _cap_nv_span(
+    const NamedValues * nv, DataType type, size_t * count);
+static void _cap_nv_enable_packing(NamedValues * nv, bool enable);
+static size_t _cap_nv_reserved_size(DataType type, size_t count, bool pack);
+static void _cap_nv_append_value_inner(
+    NamedValues * nv, const TypedUnion value);
+static void _cap_nv_append_value_copy(NamedValues * nv, const TypedUnion value);
+static void * _cap_nv_extend(NamedValues * nv, DataType type, size_t count);
+static void _cap_nv_commit(NamedValues * nv, size_t count);
+static void _cap_nv_pack(NamedValues * nv);
+static void _cap_nv_mix(NamedValues * nv);
+static void _cap_nv_reserve(NamedValues * nv, size_t size);
 
 // ============================================================================
 // === NAMED VALUES ===========================================================
@@ -104,9 +161,9 @@ NamedValues * cap_nv_make(const char * name, const TypedUnion value) {
         return NULL;
     }
     NamedValues * nv = _cap_nv_make_empty_inner(name);
-    nv -> mValues = (TypedUnion *) malloc(sizeof(TypedUnion));
-    nv -> mValues[0] = value;
-    nv -> mValueAlloc = nv -> mValueCount = 1u;
+    nv -> mType = value.mType;
+    nv -> mInline[0] = value;
+    nv -> mValueCount = 1u;
     return nv;
 }
 
@@ -121,14 +178,18 @@ void cap_nv_clear_values(NamedValues * nv) {
     if (!nv) {
         return;
     }
-    for (size_t i = 0u; i < nv -> mValueCount; ++i) {
-        cap_tu_destroy(nv -> mValues + i);
+    if (!nv -> mArena) {
+        for (size_t i = 0u; i < nv -> mValueCount; ++i) {
+            TypedUnion value = _cap_nv_load(nv, i);
+            cap_tu_destroy(&value);
+        }
     }
     if (nv -> mValues) {
-        free(nv -> mValues);
+        cap_arena_free(nv -> mArena, nv -> mValues);
         nv -> mValues = NULL;
     }
     nv -> mValueCount = nv -> mValueAlloc = 0u;
+    nv -> mMixed = !nv -> mPack;
 }
 
 /**
@@ -145,7 +206,8 @@ void cap_nv_destroy(NamedValues * nv) {
         return;
     }
     cap_nv_clear_values(nv);
-    delete_string_property(&(nv -> mName));
+    cap_arena_free(nv -> mArena, nv -> mName);
+    nv -> mName = NULL;
 }
 
 /**
@@ -157,22 +219,20 @@ void cap_nv_destroy(NamedValues * nv) {
  * 
  * 
  * 
+ * If `nv` is backed by an arena, the arena takes over ownership of a string
+ * stored in `value`.
+ * 
  * @param nv object to append to; if if is `NULL`, nothing happens.
  * @param value value to add
  */
 void cap_nv_append_value(NamedValues * nv, const TypedUnion value) {
-    static const size_t INIT_ALLOC = 1u;
     if (!nv) {
         return;
     }
-    size_t alloc = nv -> mValueAlloc;
-    if (nv -> mValueCount >= alloc) {
-        alloc = alloc ? alloc * 2 : INIT_ALLOC;
-        nv -> mValues = (TypedUnion *) realloc(
-            nv -> mValues, alloc * sizeof(TypedUnion));
-        nv -> mValueAlloc = alloc;
+    if (value.mType == DT_STRING) {
+        cap_arena_adopt(nv -> mArena, value.mValue.asString);
     }
-    nv -> mValues[nv -> mValueCount++] = value;
+    _cap_nv_append_value_inner(nv, value);
 }
 
 /**
@@ -193,7 +253,18 @@ size_t cap_nv_value_count(const NamedValues * nv) {
  * Gets a stored value at a given index.
  * 
  * Returns a pointer to a value stored in `nv` at the positiona `index`.
- * NULL is returned if `nv` is NULL or if `index` is out of range.
+ * NULL is returned if `nv` is NULL or if `index` is out of range. The values
+ * are stored in a contiguous array, so the pointer can be used to access the
+ * following values as well.
+ * 
+ * If packing is enabled and the values are stored in a packed array, there
+ * are no `TypedUnion`s to point to, so only the first value (which is also
+ * kept inline) is returned, and NULL for the other indices. These values are
+ * accessed using functions such as `cap_nv_get_ints` instead. `DT_PRESENCE`
+ * values carry no data, so a pointer to the first one is returned for any
+ * index. The returned pointer can then not be used to access the following
+ * values. This function never modifies `nv`, so it may be called from
+ * several threads at once.
  * 
  * @param nv object to search; if it is NULL, NULL is returned
  * @param index index of the value to return, starting at zero; if it is out of
@@ -204,7 +275,16 @@ const TypedUnion * cap_nv_get_value_i(const NamedValues * nv, size_t index) {
     if (!nv || nv -> mValueCount <= index) {
         return NULL;
     }
-    return nv -> mValues + index;
+    if (!_cap_nv_is_packed(nv)) {
+        return nv -> mInline + index;
+    }
+    if (nv -> mMixed) {
+        return (const TypedUnion *) nv -> mValues + index;
+    }
+    if (!index || nv -> mType == DT_PRESENCE) {
+        return nv -> mInline;
+    }
+    return NULL;
 }
 
 /**
@@ -221,18 +301,289 @@ const TypedUnion * cap_nv_get_value(const NamedValues * nv) {
     return cap_nv_get_value_i(nv, 0u);
 }
 
+/**
+ * Gets all stored values of type `DT_INT` as an array
+ * 
+ * Returns the values stored in `nv` as a contiguous array of `int`, and
+ * stores their number in `count`. Returns `NULL` (and stores zero) if `nv` is
+ * `NULL`, empty, if packing is not enabled for it, or if not all of its 
+ * values have type `DT_INT`. The array is owned by `nv` and valid until 
+ * values are added to it.
+ * 
+ * @param nv object to search
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const int * cap_nv_get_ints(const NamedValues * nv, size_t * count) {
+    return (const int *) _cap_nv_span(nv, DT_INT, count);
+}
+
+/**
+ * Gets all stored values of type `DT_DOUBLE` as an array
+ * 
+ * The same as `cap_nv_get_ints`, for values of type `DT_DOUBLE`.
+ * 
+ * @param nv object to search
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const double * cap_nv_get_doubles(const NamedValues * nv, size_t * count) {
+    return (const double *) _cap_nv_span(nv, DT_DOUBLE, count);
+}
+
+/**
+ * Gets all stored values of type `DT_STRING` as an array
+ * 
+ * The same as `cap_nv_get_ints`, for values of type `DT_STRING`. The strings
+ * are owned by `nv` as well.
+ * 
+ * @param nv object to search
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const char * const * cap_nv_get_strings(
+        const NamedValues * nv, size_t * count) {
+    return (const char * const *) _cap_nv_span(nv, DT_STRING, count);
+}
+
 // ============================================================================
 // === NAMED VALUES: IMPLEMENTATION OF PRIVATE FUNCTIONS ======================
 // ============================================================================
 
 static NamedValues * _cap_nv_make_empty_inner(const char * name) {
-    NamedValues * nv = (NamedValues *) malloc(sizeof(NamedValues));
-    nv -> mName = copy_string(name);
-    nv -> mValues = NULL;
-    nv -> mValueCount = nv -> mValueAlloc = 0u;
+    NamedValues * nv = (NamedValues *) cap_malloc(sizeof(NamedValues));
+    *nv = (NamedValues) {
+        .mName = copy_string(name),
+        .mMixed = true,
+        .mPack = false,
+        .mValues = NULL,
+        .mValueCount = 0u,
+        .mValueAlloc = 0u,
+        .mArena = NULL
+    };
     return nv;
 }
 
+static size_t _cap_nv_value_size(DataType type) {
+    // size of one value in a packed array
+    switch (type) {
+        case DT_INT:
+            return sizeof(int);
+        case DT_DOUBLE:
+            return sizeof(double);
+        case DT_STRING:
+            return sizeof(char *);
+        default:
+            return 0u;
+    }
+}
+
+static size_t _cap_nv_element_size(const NamedValues * nv) {
+    return nv -> mMixed ? sizeof(TypedUnion) : _cap_nv_value_size(nv -> mType);
+}
+
+static bool _cap_nv_is_packed(const NamedValues * nv) {
+    // presence values need no storage, so `mValues` may stay `NULL`
+    return nv -> mValues || nv -> mValueCount > _CAP_NV_INLINE_VALUES;
+}
+
+static TypedUnion _cap_nv_load(const NamedValues * nv, size_t index) {
+    if (!_cap_nv_is_packed(nv)) {
+        return nv -> mInline[index];
+    }
+    if (nv -> mMixed) {
+        return ((const TypedUnion *) nv -> mValues)[index];
+    }
+    switch (nv -> mType) {
+        case DT_INT:
+            return cap_tu_make_int(((const int *) nv -> mValues)[index]);
+        case DT_DOUBLE:
+            return cap_tu_make_double(((const double *) nv -> mValues)[index]);
+        case DT_STRING:
+            return (TypedUnion) {
+                .mType = DT_STRING,
+                .mValue = { .asString = ((char **) nv -> mValues)[index] }
+            };
+        default:
+            return cap_tu_make_presence();
+    }
+}
+
+static void _cap_nv_store(
+        NamedValues * nv, size_t index, const TypedUnion value) {
+    if (!index) {
+        nv -> mInline[0] = value;
+    }
+    if (nv -> mMixed) {
+        ((TypedUnion *) nv -> mValues)[index] = value;
+        return;
+    }
+    switch (nv -> mType) {
+        case DT_INT:
+            ((int *) nv -> mValues)[index] = value.mValue.asInt;
+            break;
+        case DT_DOUBLE:
+            ((double *) nv -> mValues)[index] = value.mValue.asDouble;
+            break;
+        case DT_STRING:
+            ((char **) nv -> mValues)[index] = value.mValue.asString;
+            break;
+        default:
+            break;
+    }
+}
+
+static const void * _cap_nv_span(
+        const NamedValues * nv, DataType type, size_t * count) {
+    const bool found = nv && nv -> mValueCount && !nv -> mMixed
+        && nv -> mType == type;
+    if (count) {
+        *count = found ? nv -> mValueCount : 0u;
+    }
+    if (!found) {
+        return NULL;
+    }
+    if (_cap_nv_is_packed(nv)) {
+        return nv -> mValues;
+    }
+    // a single value is an array as well
+    const TypedUnion * value = nv -> mInline;
+    switch (type) {
+        case DT_INT:
+            return &(value -> mValue.asInt);
+        case DT_DOUBLE:
+            return &(value -> mValue.asDouble);
+        default:
+            return &(value -> mValue.asString);
+    }
+}
+
+static void _cap_nv_enable_packing(NamedValues * nv, bool enable) {
+    // only called for empty objects, their values are not converted
+    nv -> mPack = enable;
+    nv -> mMixed = !enable;
+}
+
+static size_t _cap_nv_reserved_size(DataType type, size_t count, bool pack) {
+    // bytes `_cap_nv_reserve` needs for `count` values of type `type` in an
+    // empty object, packed or as `TypedUnion`s
+    return count > _CAP_NV_INLINE_VALUES 
+        ? count * (pack ? _cap_nv_value_size(type) : sizeof(TypedUnion))
+        : 0u;
+}
+
+static void _cap_nv_append_value_inner(
+        NamedValues * nv, const TypedUnion value) {
+    if (!nv -> mValueCount && !nv -> mMixed) {
+        nv -> mType = value.mType;
+    }
+    else if (value.mType != nv -> mType && !nv -> mMixed) {
+        _cap_nv_mix(nv);
+    }
+    if (!_cap_nv_is_packed(nv)) {
+        if (nv -> mValueCount < _CAP_NV_INLINE_VALUES) {
+            nv -> mInline[nv -> mValueCount++] = value;
+            return;
+        }
+        _cap_nv_pack(nv);
+    }
+    const size_t size = _cap_nv_element_size(nv);
+    if ((nv -> mValueCount + 1u) * size > nv -> mValueAlloc) {
+        const size_t alloc = nv -> mValueAlloc / size;
+        _cap_nv_reserve(
+            nv, (alloc > nv -> mValueCount ? alloc : nv -> mValueCount) 
+                * 2u * size);
+    }
+    _cap_nv_store(nv, nv -> mValueCount++, value);
+}
+
+static void * _cap_nv_extend(NamedValues * nv, DataType type, size_t count) {
+    // makes room for `count` more packed values of type `type` and returns
+    // it, so that they can be written directly. The caller then passes the
+    // number of values it wrote to `_cap_nv_commit`. Returns `NULL` if the
+    // values cannot be packed (or need not be, because they fit inline).
+    if (!nv -> mValueCount && !nv -> mMixed) {
+        nv -> mType = type;
+    }
+    const size_t size = _cap_nv_value_size(type);
+    if (nv -> mMixed || nv -> mType != type || !size) {
+        return NULL;
+    }
+    if (!_cap_nv_is_packed(nv)) {
+        if (nv -> mValueCount + count <= _CAP_NV_INLINE_VALUES) {
+            return NULL;
+        }
+        _cap_nv_pack(nv);
+    }
+    const size_t needed = (nv -> mValueCount + count) * size;
+    if (needed > nv -> mValueAlloc) {
+        const size_t doubled = 2u * nv -> mValueCount * size;
+        _cap_nv_reserve(nv, needed > doubled ? needed : doubled);
+    }
+    return (char *) nv -> mValues + nv -> mValueCount * size;
+}
+
+static void _cap_nv_commit(NamedValues * nv, size_t count) {
+    // adds `count` values written into the array returned by `_cap_nv_extend`
+    const bool first = !nv -> mValueCount && count;
+    nv -> mValueCount += count;
+    if (first) {
+        nv -> mInline[0] = _cap_nv_load(nv, 0u);
+    }
+}
+
+static void _cap_nv_pack(NamedValues * nv) {
+    // moves the inline values into a packed array
+    const size_t size = _cap_nv_element_size(nv);
+    _cap_nv_reserve(nv, 2u * _CAP_NV_INLINE_VALUES * size);
+    if (!nv -> mValues) {
+        // presence values take no space, they are packed once there are
+        // more of them than fit inline
+        return;
+    }
+    for (size_t i = 0u; i < nv -> mValueCount; ++i) {
+        _cap_nv_store(nv, i, nv -> mInline[i]);
+    }
+}
+
+static void _cap_nv_mix(NamedValues * nv) {
+    // converts the values to `TypedUnion`s, so that values of another type
+    // can be added
+    if (_cap_nv_is_packed(nv)) {
+        const size_t count = nv -> mValueCount;
+        TypedUnion * values = (TypedUnion *) cap_arena_alloc(
+            nv -> mArena, (count ? count : 1u) * 2u * sizeof(TypedUnion));
+        for (size_t i = 0u; i < count; ++i) {
+            values[i] = _cap_nv_load(nv, i);
+        }
+        cap_arena_free(nv -> mArena, nv -> mValues);
+        nv -> mValues = values;
+        nv -> mValueAlloc = (count ? count : 1u) * 2u * sizeof(TypedUnion);
+    }
+    nv -> mMixed = true;
+}
+
+static void _cap_nv_reserve(NamedValues * nv, size_t size) {
+    // makes room for exactly `size` bytes of packed values in total
+    if (size <= nv -> mValueAlloc) {
+        return;
+    }
+    nv -> mValues = cap_arena_realloc(
+        nv -> mArena, nv -> mValues, nv -> mValueAlloc, size);
+    nv -> mValueAlloc = size;
+}
+
+static void _cap_nv_append_value_copy(
+        NamedValues * nv, const TypedUnion value) {
+    // appends a value whose string (if any) is not owned by anyone yet
+    TypedUnion copy = value;
+    if (value.mType == DT_STRING) {
+        copy.mValue.asString = cap_arena_copy_string(
+            nv -> mArena, value.mValue.asString);
+    }
+    _cap_nv_append_value_inner(nv, copy);
+}
+
 /**
  * @}
  */
@@ -16,11 +16,19 @@
  * deleted using `cap_nva_destroy()`. After destroying the object, all
  * information obtained from it is invalid. e.g. pointers to stored
  * `TypedUnion`s.
+ * 
+ * A `NamedValuesArray` created using `cap_nva_make_in` is backed by an `Arena`
+ * and so is everything stored in it. Such objects are released together with 
+ * the arena.
  */
 
+#include "allocator.h"
+#include "arena.h"
 #include "named_values.h"
+#include "string_index.h"
 #include "typed_union.h"
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
@@ -37,25 +45,95 @@
 /**
  * List of NamedValues instances.
  * 
- * Stores a list of NamedValues instances.
+ * Stores a list of NamedValues instances in a contiguous array of slots. Each 
+ * slot has a stable position, which does not change when other slots are 
+ * added. Slots can be looked up by name, using an index, or by position.
+ * 
+ * A slot may be empty (i.e. have no name and no values) if it was reserved 
+ * using `cap_nva_make_reserved` and no value has been stored in it yet.
  */
 typedef struct {
-    NamedValues ** mItems;
+    /// slots, each storing values for a single name
+    NamedValues * mItems;
+    /// number of slots, including empty ones
     size_t mCount;
+    /// number of slots that can be stored in `mItems`
     size_t mAlloc;
+    /// maps names of non-empty slots to their position in `mItems`
+    StringIndex * mIndex;
+    /// arena which owns the object and all data stored in it, or `NULL` if
+    /// they are allocated on the heap
+    Arena * mArena;
+    /// `true` if values stored in new slots may be packed, see
+    /// `_cap_nva_enable_packing`
+    bool mPackValues;
 } NamedValuesArray;
 
 // ============================================================================
 // === NAMED VALUES ARRAY: DECLARATION OF PRIVATE FUNCTIONS ===================
 // ============================================================================
 
-static void _cap_nva_append_item(
-    NamedValuesArray * nva, const char * name, const TypedUnion value);
+static size_t _cap_nva_add_slots(NamedValuesArray * nva, size_t count);
+static void _cap_nva_append_parsed_value_at(
+    NamedValuesArray * nva, size_t position, const char * name,
+    const TypedUnion value, bool borrow);
+static NamedValues * _cap_nva_named_slot_at(
+    NamedValuesArray * nva, size_t position, const char * name);
+static void _cap_nva_name_slot(
+    NamedValuesArray * nva, size_t position, const char * name);
+static void _cap_nva_enable_packing(NamedValuesArray * nva, bool enable);
 
 // ============================================================================
 // === NAMED VALUES ARRAY FUNCTIONS ===========================================
 // ============================================================================
 
+/**
+ * Creates a new NamedValuesArray object backed by an arena
+ * 
+ * Behaves like `cap_nva_make_reserved`, but the new object and everything 
+ * stored in it are allocated from `arena`. The arena also takes over 
+ * ownership of strings stored in values added to the object. The object is released when the arena 
+ * is destroyed, `cap_nva_destroy` may still be called but has no effect.
+ * 
+ * @param arena arena to allocate from; if it is NULL, the object is allocated
+ *        on the heap
+ * @param count number of slots to reserve
+ * @return new object
+ */
+NamedValuesArray * cap_nva_make_in(Arena * arena, size_t count) {
+    NamedValuesArray * nva = (NamedValuesArray *) cap_arena_alloc(
+        arena, sizeof(NamedValuesArray));
+    // reserved slots are allocated exactly, so that the size of an arena
+    // for a known number of slots can be computed
+    nva -> mItems = count ? (NamedValues *) cap_arena_alloc(
+        arena, count * sizeof(NamedValues)) : NULL;
+    nva -> mCount = 0u;
+    nva -> mAlloc = count;
+    nva -> mArena = arena;
+    nva -> mPackValues = false;
+    nva -> mIndex = cap_si_make_in(arena);
+    cap_si_reserve(nva -> mIndex, count);
+    _cap_nva_add_slots(nva, count);
+    return nva;
+}
+
+/**
+ * Creates a new NamedValuesArray object with reserved slots
+ * 
+ * Creates and returns a new NamedValuesArray object containing `count` empty 
+ * slots at positions `0` to `count - 1`. These slots can be filled using 
+ * `cap_nva_append_value_at`. Slots for other names can still be added by 
+ * `cap_nva_append_value` and `cap_nva_set_value`, their positions follow 
+ * after the reserved ones. Instances created this way should be disposed of
+ * using `cap_nva_destroy`.
+ * 
+ * @param count number of slots to reserve
+ * @return new object
+ */
+NamedValuesArray * cap_nva_make_reserved(size_t count) {
+    return cap_nva_make_in(NULL, count);
+}
+
 /**
  * Creates a new empty NamedValuesArray object
  * 
@@ -63,11 +141,7 @@ static void _cap_nva_append_item(
  * this way should be disposed of using `cap_nva_destroy`.
  */
 NamedValuesArray * cap_nva_make_empty() {
-    NamedValuesArray * nva = (NamedValuesArray *) malloc(
-        sizeof(NamedValuesArray));
-    nva -> mItems = NULL;
-    nva -> mCount = nva -> mAlloc = 0u;
-    return nva;
+    return cap_nva_make_reserved(0u);
 }
 
 /**
@@ -82,23 +156,26 @@ void cap_nva_destroy(NamedValuesArray * nva) {
     if (!nva) {
         return;
     }
+    if (nva -> mArena) {
+        // everything is released together with the arena
+        return;
+    }
     for (size_t i = 0u; i < nva -> mCount; ++i) {
-        cap_nv_destroy(nva -> mItems[i]);
-        nva -> mItems[i] = NULL;
+        cap_nv_destroy(nva -> mItems + i);
     }
-    free(nva -> mItems);
-    nva -> mItems = NULL;
-    nva -> mAlloc = nva -> mCount = 0u;
+    cap_free(nva -> mItems);
+    cap_si_destroy(nva -> mIndex);
+    cap_free(nva);
 }
 
 /**
- * Gets the number of items in a NamedValuesArray object
+ * Gets the number of slots in a NamedValuesArray object
  * 
- * Returns the number of items (`NamedValues` objects) stored in `nva`. 
- * If `nva` is NULL, always returns zero.
+ * Returns the number of slots (`NamedValues` objects) stored in `nva`, 
+ * including empty reserved slots. If `nva` is NULL, always returns zero.
  * 
  * @param nva object to measure
- * @return number of items, or zero if `nva` is NULL
+ * @return number of slots, or zero if `nva` is NULL
  */
 size_t cap_nva_length(const NamedValuesArray * nva) {
     if (!nva) {
@@ -120,16 +197,30 @@ size_t cap_nva_length(const NamedValuesArray * nva) {
  *         object is stored
  */
 NamedValues * cap_nva_get(const NamedValuesArray * nva, const char * name) {
-    if (!nva || !name) {
+    size_t position;
+    if (!nva || !cap_si_find(nva -> mIndex, name, &position)) {
         return NULL;
     }
-    for (size_t i = 0; i < nva -> mCount; ++i) {
-        NamedValues * item = nva -> mItems[i];
-        if (!strcmp(name, item -> mName)) {
-            return item;
-        }
+    return nva -> mItems + position;
+}
+
+/**
+ * Gets a `NamedValues` at a given position
+ * 
+ * Returns the `NamedValues` object stored in `nva` at `position`. If `nva` is 
+ * NULL, `position` is out of range, or the slot at `position` is empty, 
+ * returns NULL.
+ * 
+ * @param nva object to search
+ * @param position position of the slot
+ * @return pointer to the NamedValues at `position`, or NULL
+ */
+NamedValues * cap_nva_get_at(const NamedValuesArray * nva, size_t position) {
+    if (!nva || position >= nva -> mCount) {
+        return NULL;
     }
-    return NULL;
+    NamedValues * item = nva -> mItems + position;
+    return item -> mName ? item : NULL;
 }
 
 /**
@@ -151,12 +242,42 @@ void cap_nva_append_value(
     if (!nva || !name) {
         return;
     }
-    NamedValues * item = cap_nva_get(nva, name);
-    if (!item) {
+    size_t position;
+    if (!cap_si_find(nva -> mIndex, name, &position)) {
         // insert a new item at the end
-        _cap_nva_append_item(nva, name, value);
+        position = _cap_nva_add_slots(nva, 1u);
+        _cap_nva_name_slot(nva, position, name);
+    }
+    cap_nv_append_value(nva -> mItems + position, value);
+}
+
+/**
+ * Appends a value to a `NamedValues` at a given position
+ * 
+ * Appends `value` to the slot at `position`. If the slot is empty, it is 
+ * given the name `name` first. If the slot already has a name, `name` is 
+ * ignored. 
+ * 
+ * If `nva` or `name` are NULL, or `position` is out of range, nothing 
+ * happens. The caller must make sure that the name of an empty slot is not
+ * already used by another slot.
+ * 
+ * @param nva object to modify
+ * @param position position of the slot
+ * @param name name for the slot if it is empty
+ * @param value value to append
+ */
+void cap_nva_append_value_at(
+    NamedValuesArray * nva, size_t position, const char * name,
+    const TypedUnion value)
+{
+    if (!nva || !name || position >= nva -> mCount) {
         return;
     }
+    NamedValues * item = nva -> mItems + position;
+    if (!item -> mName) {
+        _cap_nva_name_slot(nva, position, name);
+    }
     cap_nv_append_value(item, value);
 }
 
@@ -180,31 +301,85 @@ void cap_nva_set_value(
         return;
     }
     NamedValues * item = cap_nva_get(nva, name);
-    if (!item) {
-        _cap_nva_append_item(nva, name, value);
-        return;
+    if (item) {
+        cap_nv_clear_values(item);
     }
-    cap_nv_clear_values(item);
-    cap_nv_append_value(item, value);
+    cap_nva_append_value(nva, name, value);
 }
 
 // ============================================================================
 // === NAMED VALUES ARRAY: IMPLEMENTATION OF PRIVATE FUNCTIONS ================
 // ============================================================================
 
-static void _cap_nva_append_item(
-    NamedValuesArray * nva, const char * name, const TypedUnion value)
-{
+static size_t _cap_nva_add_slots(NamedValuesArray * nva, size_t count) {
     static const size_t INIT_ALLOC = 4u;
+    const size_t first = nva -> mCount;
     size_t alloc = nva -> mAlloc;
-    if (nva -> mCount >= alloc) {
-        alloc = alloc ? alloc * 2 : INIT_ALLOC;
-        nva -> mItems = (NamedValues **) realloc(
-            nva -> mItems, alloc * sizeof(NamedValues *));
+    if (first + count > alloc) {
+        alloc = alloc ? alloc : INIT_ALLOC;
+        while (first + count > alloc) {
+            alloc *= 2;
+        }
+        nva -> mItems = (NamedValues *) cap_arena_realloc(
+            nva -> mArena, nva -> mItems, 
+            nva -> mAlloc * sizeof(NamedValues), alloc * sizeof(NamedValues));
         nva -> mAlloc = alloc;
     }
-    // since we know that name is not NULL, this will not create NULL
-    nva -> mItems[nva -> mCount++] = cap_nv_make(name, value);
+    for (size_t i = first; i < first + count; ++i) {
+        nva -> mItems[i] = (NamedValues) {
+            .mName = NULL,
+            .mMixed = !nva -> mPackValues,
+            .mPack = nva -> mPackValues,
+            .mValues = NULL,
+            .mValueCount = 0u,
+            .mValueAlloc = 0u,
+            .mArena = nva -> mArena
+        };
+    }
+    nva -> mCount += count;
+    return first;
+}
+
+static void _cap_nva_append_parsed_value_at(
+        NamedValuesArray * nva, size_t position, const char * name,
+        const TypedUnion value, bool borrow) {
+    // like cap_nva_append_value_at, but a string stored in `value` is not
+    // owned by anyone. It is either copied, or borrowed as it is (the caller
+    // guarantees that it outlives `nva` then).
+    NamedValues * item = _cap_nva_named_slot_at(nva, position, name);
+    if (borrow) {
+        _cap_nv_append_value_inner(item, value);
+    }
+    else {
+        _cap_nv_append_value_copy(item, value);
+    }
+}
+
+static NamedValues * _cap_nva_named_slot_at(
+        NamedValuesArray * nva, size_t position, const char * name) {
+    // the reserved slot at `position`, named `name` if it is still unused
+    NamedValues * item = nva -> mItems + position;
+    if (!item -> mName) {
+        _cap_nva_name_slot(nva, position, name);
+    }
+    return item;
+}
+
+static void _cap_nva_name_slot(
+        NamedValuesArray * nva, size_t position, const char * name) {
+    NamedValues * item = nva -> mItems + position;
+    item -> mName = cap_arena_copy_string(nva -> mArena, name);
+    // the index borrows the name owned by the slot
+    cap_si_insert(nva -> mIndex, item -> mName, position);
+}
+
+static void _cap_nva_enable_packing(NamedValuesArray * nva, bool enable) {
+    // applies to all slots, which must still be empty, and to slots added
+    // later
+    nva -> mPackValues = enable;
+    for (size_t i = 0u; i < nva -> mCount; ++i) {
+        _cap_nv_enable_packing(nva -> mItems + i, enable);
+    }
 }
 
 /**
@@ -0,0 +1,156 @@
+#ifndef __PARALLEL_NUMBER_PARSING_H__
+#define __PARALLEL_NUMBER_PARSING_H__
+
+/**
+ * @file
+ *
+ * Conversion of very long runs of numeric words on several threads. It is
+ * used internally by `ArgumentParser` if `cap_parser_set_thread_count` allows
+ * more than one thread. A run is cut into contiguous slices, which are
+ * converted by the functions of `batch_number_parsing.h` into disjoint parts
+ * of the same array, so the values are identical to converting the run on
+ * a single thread.
+ *
+ * Threads are started for each run and joined before it is stored. Threads
+ * are only used if the macro `CAP_ENABLE_THREADS` is defined before the 
+ * library is included, on POSIX systems. Programs doing that must be linked
+ * with `-pthread`. Otherwise, runs are always converted on the calling thread
+ * and the library does not depend on pthreads at all.
+ */
+
+#include "allocator.h"
+#include "batch_number_parsing.h"
+#include "data_type.h"
+#include "number_parsing.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#if defined(CAP_ENABLE_THREADS) && (defined(__unix__) || defined(__APPLE__))
+#define _CAP_THREADS 1
+#include <pthread.h>
+#endif
+
+/// smallest number of words converted by one thread
+#define _CAP_PARALLEL_MIN_WORDS ((size_t) 16384)
+
+// ============================================================================
+// === PARALLEL NUMBER PARSING ================================================
+// ============================================================================
+
+/**
+ * A contiguous part of a run of words, converted by one thread.
+ */
+typedef struct {
+    const char * const * mWords;
+    size_t mCount;
+    /// end of the buffer holding the words, `NULL` if it is not known
+    const char * mLimit;
+    /// DT_INT or DT_DOUBLE
+    DataType mType;
+    /// array of `int` or `double` receiving the values
+    void * mValues;
+    _CapSimdLevel mLevel;
+    /// number of converted words, and why the next one was not converted
+    size_t mConverted;
+    WordConversionResult mResult;
+} _CapConversionSlice;
+
+// ============================================================================
+// === PARALLEL NUMBER PARSING: DECLARATION OF PRIVATE FUNCTIONS ==============
+// ============================================================================
+
+static size_t _cap_parse_number_batch_parallel(
+    const char * const * words, size_t count, const char * limit,
+    DataType type, void * values, size_t thread_count,
+    WordConversionResult * result);
+static void * _cap_convert_slice(void * slice);
+
+// ============================================================================
+// === PARALLEL NUMBER PARSING: IMPLEMENTATION OF PRIVATE FUNCTIONS ===========
+// ============================================================================
+
+static size_t _cap_parse_number_batch_parallel(
+        const char * const * words, size_t count, const char * limit,
+        DataType type, void * values, size_t thread_count,
+        WordConversionResult * result) {
+    // converts `words` of type DT_INT or DT_DOUBLE into `values` using up to
+    // `thread_count` threads (including the calling one), and returns the
+    // number of converted words like `_cap_parse_int_batch`
+    size_t slice_count = count / _CAP_PARALLEL_MIN_WORDS;
+    slice_count = slice_count < thread_count ? slice_count : thread_count;
+#if !defined(_CAP_THREADS)
+    slice_count = 1u;
+#endif
+    slice_count = slice_count ? slice_count : 1u;
+    const size_t value_size = type == DT_INT ? sizeof(int) : sizeof(double);
+    _CapConversionSlice * slices = (_CapConversionSlice *) cap_malloc(
+        slice_count * sizeof(_CapConversionSlice));
+    const _CapSimdLevel level = _cap_simd_level();
+    size_t start = 0u;
+    for (size_t i = 0u; i < slice_count; ++i) {
+        const size_t end = count / slice_count * (i + 1u)
+            + (i + 1u == slice_count ? count % slice_count : 0u);
+        slices[i] = (_CapConversionSlice) {
+            .mWords = words + start,
+            .mCount = end - start,
+            .mLimit = limit,
+            .mType = type,
+            .mValues = (char *) values + start * value_size,
+            .mLevel = level,
+            .mConverted = 0u,
+            .mResult = WCR_OK
+        };
+        start = end;
+    }
+#if defined(_CAP_THREADS)
+    // slice 0 is converted by the calling thread. If a thread cannot be
+    // started, its slice is converted by the calling thread as well.
+    pthread_t * threads = (pthread_t *) cap_malloc(
+        slice_count * sizeof(pthread_t));
+    bool * started = (bool *) cap_malloc(slice_count * sizeof(bool));
+    for (size_t i = 1u; i < slice_count; ++i) {
+        started[i] = pthread_create(
+            threads + i, NULL, _cap_convert_slice, slices + i) == 0;
+    }
+    _cap_convert_slice(slices);
+    for (size_t i = 1u; i < slice_count; ++i) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        }
+        else {
+            _cap_convert_slice(slices + i);
+        }
+    }
+    cap_free(started);
+    cap_free(threads);
+#else
+    _cap_convert_slice(slices);
+#endif
+    // the first word which cannot be converted ends the run
+    size_t converted = 0u;
+    *result = WCR_OK;
+    for (size_t i = 0u; i < slice_count; ++i) {
+        converted += slices[i].mConverted;
+        if (slices[i].mConverted < slices[i].mCount) {
+            *result = slices[i].mResult;
+            break;
+        }
+    }
+    cap_free(slices);
+    return converted;
+}
+
+static void * _cap_convert_slice(void * slice) {
+    _CapConversionSlice * s = (_CapConversionSlice *) slice;
+    s -> mConverted = s -> mType == DT_INT
+        ? _cap_parse_int_batch_with(
+            s -> mWords, s -> mCount, s -> mLimit, (int *) s -> mValues,
+            &(s -> mResult), s -> mLevel)
+        : _cap_parse_double_batch_with(
+            s -> mWords, s -> mCount, s -> mLimit, (double *) s -> mValues,
+            &(s -> mResult), s -> mLevel);
+    return NULL;
+}
+
+#endif
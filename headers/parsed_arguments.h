@@ -21,15 +21,43 @@
  * This way, `ParsedArguments` implements a pair of primitive multi-sets of
  * `string --> TypedUnion` (one such mapping for flags and one for positionals.)
  * 
+ * Besides by name, flags and positionals can also be accessed by their id, 
+ * using functions such as `cap_pa_get_flag_by_id`. When a `ParsedArguments` is
+ * created by a parser, the id of a flag or a positional is the one returned by
+ * `cap_parser_add_flag` or `cap_parser_add_positional` respectively. Access by
+ * id takes constant time and does not compare any strings, so it is preferable
+ * in performance-sensitive code. For objects created using 
+ * `cap_pa_make_empty()` and filled using e.g. `cap_pa_add_flag`, ids are 
+ * assigned in the order in which names were first added, starting at zero.
+ * 
  * An empty `ParsedArguments` object can be created using `cap_pa_make_empty()`.
  * This is normally done at parse-time by the parser so users do not need to
  * create it manually. Objects should be disposed of using `cap_pa_destroy` when
  * no longer needed. This call invalidates all information obtained from the
  * object, e.g. pointers to `TypedUnion`s that were stored as argument values.
+ * 
+ * If the parser was configured using `cap_parser_enable_packed_values`, values
+ * of one flag or positional are stored in a packed array of their native 
+ * type, e.g. `int[]` for `DT_INT`, instead of as `TypedUnion`s. Functions such
+ * as `cap_pa_get_positional_ints` return that array directly, which is the 
+ * most efficient way to access many values. Functions returning a 
+ * `TypedUnion`, such as `cap_pa_get_flag`, still find the first value (and
+ * any `DT_PRESENCE` value), but `cap_pa_get_flag_i` and similar functions
+ * return `NULL` for the following packed values.
+ * 
+ * Functions which only read a `ParsedArguments` never modify it, so one object
+ * may be read from several threads at once.
+ * 
+ * A `ParsedArguments` and everything it owns (names, values, and strings 
+ * stored in values) are allocated from a single `Arena`. A parse therefore 
+ * needs only a few allocations, and `cap_pa_destroy` releases everything at
+ * once.
  */
 
+#include "arena.h"
 #include "named_values.h"
 #include "named_values_array.h"
+#include "response_file.h"
 #include "typed_union.h"
 
 #include <assert.h>
@@ -60,11 +88,10 @@
  * 
  * Once created using the `cap_parser_parse` or `cap_pa_make_empty` functions,
  * the caller owns this object and should dispose of it using `cap_pa_destroy`
- * once it is no longer needed. When created by `cap_parser_parse`, the pointer
- * returned by this function must also be freed. (this is an unfortunate
- * technical limitation.) `cap_pa_destroy` also deletes all data contained in
- * it, including names of flags, and `TypedUnion`s and strings contained
- * in them. If any data obtained from a `ParsedArguments` should be usable 
+ * once it is no longer needed. The object itself lives in its own arena, so
+ * the pointer must not be passed to `free`. `cap_pa_destroy` also deletes all
+ * data contained in it, including names of flags, and `TypedUnion`s and
+ * strings contained in them. If any data obtained from a `ParsedArguments` should be usable 
  * after destroying the object, it must be properly copied.
  * 
  * @see ParsedFlag
@@ -78,11 +105,31 @@
  * @see cap_pa_has_positional
  * @see cap_pa_get_positional
  */
-typedef struct {
-    /// Information about individual parsed flags
+typedef struct ParsedArguments {
+    /// Information about individual parsed flags, the position of each flag 
+    /// is its id
     NamedValuesArray * mFlags;
-    /// Information about individual positional arguments
+    /// Information about individual positional arguments, the position of each
+    /// positional is its id
     NamedValuesArray * mPositionals;
+    /// Arena from which this object and all data stored in it are allocated
+    Arena * mArena;
+    /// Position of `mArena` right after this object, `cap_pa_reset` rewinds
+    /// the arena to it
+    ArenaMark mResetMark;
+    /// Response files whose words were parsed into this object. Values may
+    /// point into them, so they are released together with the values.
+    ResponseFile * mResponseFiles;
+    size_t mResponseFileCount;
+    /// Name of the subcommand which was parsed, or `NULL`
+    char * mSubcommand;
+    /// Arguments of the subcommand, owned by this object, or `NULL`
+    struct ParsedArguments * mSubcommandArguments;
+    /// Parser of the subcommand if it was built only for this parse (see
+    /// `cap_parser_build_subcommands`), or `NULL`. It is owned by this object
+    /// and destroyed using `mReleaseSubparser`.
+    void * mSubparser;
+    void (* mReleaseSubparser)(void * parser);
 } ParsedArguments;
 
 // ============================================================================
@@ -92,25 +139,78 @@ typedef struct {
 NamedValues * _cap_pa_get_flag(const ParsedArguments * args, const char * flag);
 NamedValues * _cap_pa_get_positional(
     const ParsedArguments * args, const char * name);
-void _cap_named_values_destroy(NamedValues * nv);
-void _cap_named_values_array_destroy(NamedValuesArray * nva);
+static const NamedValues * _cap_pa_flag_at(
+    const ParsedArguments * args, size_t id);
+static const NamedValues * _cap_pa_positional_at(
+    const ParsedArguments * args, size_t id);
+static ParsedArguments * _cap_pa_make_in(
+    Arena * arena, size_t flag_count, size_t positional_count);
+static void _cap_pa_make_containers(
+    ParsedArguments * args, size_t flag_count, size_t positional_count);
+static void _cap_pa_reset_reserved(
+    ParsedArguments * args, size_t flag_count, size_t positional_count);
+static void _cap_pa_adopt_response_files(
+    ParsedArguments * args, ResponseFile * files, size_t count);
+static void _cap_pa_add_response_file(
+    ParsedArguments * args, ResponseFile file);
+static void _cap_pa_release_response_files(ParsedArguments * args);
+static void _cap_pa_set_subcommand(
+    ParsedArguments * args, const char * name,
+    ParsedArguments * subcommand_args, void * subparser,
+    void (* release_subparser)(void * parser));
+static void _cap_pa_release_subcommand(ParsedArguments * args);
+static void _cap_pa_reserve_values(
+    ParsedArguments * args, const size_t * flag_value_sizes,
+    const size_t * positional_value_sizes);
+static size_t _cap_pa_container_size(
+    size_t flag_count, size_t positional_count);
+static size_t _cap_pa_arena_size(size_t flag_count, size_t positional_count);
+static void _cap_pa_enable_packing(ParsedArguments * args, bool enable);
+static ParsedArguments * _cap_pa_make_exact(
+    size_t flag_count, const size_t * flag_value_sizes,
+    size_t positional_count, const size_t * positional_value_sizes,
+    size_t extra_size, bool pack);
+static void _cap_pa_add_parsed_flag_at(
+    ParsedArguments * args, size_t id, const char * flag, TypedUnion value,
+    bool borrow);
+static NamedValues * _cap_pa_positional_slot_at(
+    ParsedArguments * args, size_t id, const char * name);
+static void _cap_pa_append_parsed_positional_at(
+    ParsedArguments * args, size_t id, const char * name, TypedUnion value,
+    bool borrow);
 
 // ============================================================================
-// === FACTORY FUNCTION =======================================================
+// === FACTORY FUNCTIONS ======================================================
 // ============================================================================
 
+/**
+ * Creates an empty `ParsedArguments` object with reserved ids
+ * 
+ * Creates a `ParsedArguments` containing no flags or positionals, in which 
+ * flag ids `0` to `flag_count - 1` and positional ids `0` to 
+ * `positional_count - 1` are reserved. Values for them can be stored using 
+ * `cap_pa_add_flag_at` and `cap_pa_append_positional_at`. This is done by 
+ * parsers, users normally do not need to call this function.
+ * 
+ * @param flag_count number of flag ids to reserve
+ * @param positional_count number of positional ids to reserve
+ * @return new object
+ */
+ParsedArguments * cap_pa_make_reserved(
+    size_t flag_count, size_t positional_count)
+{
+    Arena * arena = cap_arena_make(
+        _cap_pa_arena_size(flag_count, positional_count));
+    return _cap_pa_make_in(arena, flag_count, positional_count);
+}
+
 /**
  * Creates an empty `ParsedArguments` object
  * 
  * Creates a `ParsedArguments` containing no flags or positionals.
  */
 ParsedArguments * cap_pa_make_empty() {
-    ParsedArguments * pa = (ParsedArguments *) malloc(sizeof(ParsedArguments));
-    *pa = (ParsedArguments) {
-        .mFlags = cap_nva_make_empty(),
-        .mPositionals = cap_nva_make_empty(),
-    };
-    return pa;
+    return cap_pa_make_reserved(0u, 0u);
 }
 
 // ============================================================================
@@ -127,15 +227,34 @@ ParsedArguments * cap_pa_make_empty() {
  */
 void cap_pa_destroy(ParsedArguments * args) {
     if (!args) return;
-    if (args -> mFlags) {
-        cap_nva_destroy(args -> mFlags);
-        args -> mFlags = NULL;
-    }
-    if (args -> mPositionals) {
-        cap_nva_destroy(args -> mPositionals);
-        args -> mPositionals = NULL;
+    _cap_pa_release_response_files(args);
+    _cap_pa_release_subcommand(args);
+    // the object itself and everything it owns live in the arena
+    cap_arena_destroy(args -> mArena);
+}
+
+// ============================================================================
+// === REUSE ==================================================================
+// ============================================================================
+
+/**
+ * Removes all flags and positionals from a `ParsedArguments` object
+ * 
+ * Empties `args`, so that it can be filled again, e.g. by 
+ * `cap_parser_parse_into_noexit`. Reserved ids stay reserved. Memory owned by
+ * `args` is kept and reused, so filling it with a similar amount of data again
+ * does not allocate any memory. All pointers obtained from `args` before this
+ * call become invalid.
+ * 
+ * @param args object to empty. If it is `NULL`, this function does nothing.
+ */
+void cap_pa_reset(ParsedArguments * args) {
+    if (!args) {
+        return;
     }
-    free(args);
+    _cap_pa_reset_reserved(
+        args, cap_nva_length(args -> mFlags), 
+        cap_nva_length(args -> mPositionals));
 }
 
 // ============================================================================
@@ -230,6 +349,85 @@ void cap_pa_add_flag(
     cap_nva_append_value(args -> mFlags, flag, value);
 }
 
+/**
+ * Inserts a new value for the flag with the given id.
+ * 
+ * Behaves like `cap_pa_add_flag`, but the flag is identified by `id`. If no 
+ * value has been stored for `id` yet, the flag is given the name `flag`. 
+ * Otherwise `flag` is ignored. The id must have been reserved by
+ * `cap_pa_make_reserved`, or created by adding a flag by name.
+ * 
+ * @param args `ParsedArguments` object to add the flag into. If it is `NULL`,
+ *        the function does nothing.
+ * @param id id of the flag
+ * @param flag null-terminated name of the flag
+ * @param value value to store for the flag
+ */
+void cap_pa_add_flag_at(
+        ParsedArguments * args, size_t id, const char * flag,
+        TypedUnion value) {
+    if (!args) return;
+    cap_nva_append_value_at(args -> mFlags, id, flag, value);
+}
+
+// ============================================================================
+// === ACCESS TO PARSED FLAGS BY ID ===========================================
+// ============================================================================
+
+/**
+ * Checks if the flag with the given id is present.
+ * 
+ * @param args `ParsedArguments` object to search
+ * @param id id of the flag
+ * @return `true` if the flag is present
+ */
+bool cap_pa_has_flag_by_id(const ParsedArguments * args, size_t id) {
+    return args && cap_nva_get_at(args -> mFlags, id);
+}
+
+/**
+ * Returns the number of times the flag with the given id was given.
+ * 
+ * @param args `ParsedArguments` object to search
+ * @param id id of the flag
+ * @return number of values stored for the flag, or zero if it is absent
+ */
+size_t cap_pa_flag_count_by_id(const ParsedArguments * args, size_t id) {
+    if (!args) return 0u;
+    return cap_nv_value_count(cap_nva_get_at(args -> mFlags, id));
+}
+
+/**
+ * Retrieves the first value stored for the flag with the given id.
+ * 
+ * Same as `cap_pa_get_flag`, but the flag is identified by its id.
+ * 
+ * @param args `ParsedArguments` object to search
+ * @param id id of the flag
+ * @return pointer to the first value for this flag, or `NULL`.
+ */
+const TypedUnion * cap_pa_get_flag_by_id(
+        const ParsedArguments * args, size_t id) {
+    if (!args) return NULL;
+    return cap_nv_get_value(cap_nva_get_at(args -> mFlags, id));
+}
+
+/**
+ * Retrieves a value stored for the flag with the given id at a position.
+ * 
+ * Same as `cap_pa_get_flag_i`, but the flag is identified by its id.
+ * 
+ * @param args `ParsedArguments` object to search
+ * @param id id of the flag
+ * @param index position of the value
+ * @return pointer to the value for this flag indicated by `index`, or `NULL`.
+ */
+const TypedUnion * cap_pa_get_flag_i_by_id(
+        const ParsedArguments * args, size_t id, size_t index) {
+    if (!args) return NULL;
+    return cap_nv_get_value_i(cap_nva_get_at(args -> mFlags, id), index);
+}
+
 // ============================================================================
 // === ACCESS TO PARSED POSITIONAL ARGUMENTS ==================================
 // ============================================================================
@@ -358,6 +556,327 @@ void cap_pa_append_positional(
     cap_nva_append_value(args -> mPositionals, name, value);
 }
 
+/**
+ * Adds a value for the positional with the given id
+ * 
+ * Behaves like `cap_pa_append_positional`, but the positional is identified by
+ * `id`. If no value has been stored for `id` yet, the positional is given the 
+ * name `name`. Otherwise `name` is ignored. The id must have been reserved by
+ * `cap_pa_make_reserved`, or created by adding a positional by name.
+ * 
+ * @param args object to add a value to
+ * @param id id of the positional
+ * @param name null-terminated name of the positional
+ * @param value value to store for this positional
+ */
+void cap_pa_append_positional_at(
+    ParsedArguments * args, size_t id, const char * name,
+    const TypedUnion value)
+{
+    if (!args) {
+        return;
+    }
+    cap_nva_append_value_at(args -> mPositionals, id, name, value);
+}
+
+// ============================================================================
+// === ACCESS TO PARSED POSITIONAL ARGUMENTS BY ID ============================
+// ============================================================================
+
+/**
+ * Checks if the positional with the given id is present.
+ * 
+ * @param args object to search
+ * @param id id of the positional
+ * @return `true` if at least one value is stored for the positional
+ */
+bool cap_pa_has_positional_by_id(const ParsedArguments * args, size_t id) {
+    return args && cap_nva_get_at(args -> mPositionals, id);
+}
+
+/**
+ * Get the number of values stored for the positional with the given id.
+ * 
+ * @param args object to search
+ * @param id id of the positional
+ * @return number of values stored for the positional
+ */
+size_t cap_pa_positional_count_by_id(
+    const ParsedArguments * args, size_t id)
+{
+    if (!args) {
+        return 0u;
+    }
+    return cap_nv_value_count(cap_nva_get_at(args -> mPositionals, id));
+}
+
+/**
+ * Retrieves the value of the positional with the given id.
+ * 
+ * Same as `cap_pa_get_positional`, but the positional is identified by its id.
+ * 
+ * @param args object to search
+ * @param id id of the positional
+ * @returns pointer to the argument's value, or `NULL` if it is not found.
+ */
+const TypedUnion * cap_pa_get_positional_by_id(
+    const ParsedArguments * args, size_t id)
+{
+    if (!args) {
+        return NULL;
+    }
+    return cap_nv_get_value(cap_nva_get_at(args -> mPositionals, id));
+}
+
+/**
+ * Retrieves a value of the positional with the given id at the given index.
+ * 
+ * Same as `cap_pa_get_positional_i`, but the positional is identified by its
+ * id.
+ * 
+ * @param args object to search
+ * @param id id of the positional
+ * @param index index of the requested value
+ * @return pointer to the argument's value at `index`, or `NULL` if it is
+ *         not found.
+ */
+const TypedUnion * cap_pa_get_positional_i_by_id(
+    const ParsedArguments * args, size_t id, size_t index) 
+{
+    if (!args) {
+        return NULL;
+    }
+    return cap_nv_get_value_i(
+        cap_nva_get_at(args -> mPositionals, id), index);
+}
+
+// ============================================================================
+// === PARSED ARGUMENTS: VALUES AS ARRAYS =====================================
+// ============================================================================
+
+/**
+ * Retrieves all values of the given flag as an array of `int`.
+ * 
+ * If `args` contains the flag `flag` and all of its values have type 
+ * `DT_INT`, returns them as a contiguous array and stores their number in 
+ * `count`. Otherwise returns `NULL` and stores zero. The values must be 
+ * stored packed (see `cap_parser_enable_packed_values`), so no copies are 
+ * made, otherwise `NULL` is returned as well. `args` remains the owner of the
+ * array, which is valid until values are added to the flag.
+ * 
+ * @param args object to search
+ * @param flag null-terminated name of the flag
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const int * cap_pa_get_flag_ints(
+        const ParsedArguments * args, const char * flag, size_t * count) {
+    return cap_nv_get_ints(_cap_pa_get_flag(args, flag), count);
+}
+
+/**
+ * Retrieves all values of the given flag as an array of `double`.
+ * 
+ * Same as `cap_pa_get_flag_ints`, for values of type `DT_DOUBLE`.
+ * 
+ * @param args object to search
+ * @param flag null-terminated name of the flag
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const double * cap_pa_get_flag_doubles(
+        const ParsedArguments * args, const char * flag, size_t * count) {
+    return cap_nv_get_doubles(_cap_pa_get_flag(args, flag), count);
+}
+
+/**
+ * Retrieves all values of the given flag as an array of strings.
+ * 
+ * Same as `cap_pa_get_flag_ints`, for values of type `DT_STRING`.
+ * 
+ * @param args object to search
+ * @param flag null-terminated name of the flag
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const char * const * cap_pa_get_flag_strings(
+        const ParsedArguments * args, const char * flag, size_t * count) {
+    return cap_nv_get_strings(_cap_pa_get_flag(args, flag), count);
+}
+
+/**
+ * Retrieves all values of the flag with the given id as an array.
+ * 
+ * Same as `cap_pa_get_flag_ints`, but the flag is identified by its id.
+ * 
+ * @param args object to search
+ * @param id id of the flag
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const int * cap_pa_get_flag_ints_by_id(
+        const ParsedArguments * args, size_t id, size_t * count) {
+    return cap_nv_get_ints(_cap_pa_flag_at(args, id), count);
+}
+
+/**
+ * Retrieves all values of the flag with the given id as an array.
+ * 
+ * Same as `cap_pa_get_flag_doubles`, but the flag is identified by its id.
+ * 
+ * @param args object to search
+ * @param id id of the flag
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const double * cap_pa_get_flag_doubles_by_id(
+        const ParsedArguments * args, size_t id, size_t * count) {
+    return cap_nv_get_doubles(_cap_pa_flag_at(args, id), count);
+}
+
+/**
+ * Retrieves all values of the flag with the given id as an array.
+ * 
+ * Same as `cap_pa_get_flag_strings`, but the flag is identified by its id.
+ * 
+ * @param args object to search
+ * @param id id of the flag
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const char * const * cap_pa_get_flag_strings_by_id(
+        const ParsedArguments * args, size_t id, size_t * count) {
+    return cap_nv_get_strings(_cap_pa_flag_at(args, id), count);
+}
+
+/**
+ * Retrieves all values of the given positional argument as an array of `int`.
+ * 
+ * If `args` contains the positional argument `name` and all of its values have type 
+ * `DT_INT`, returns them as a contiguous array and stores their number in 
+ * `count`. Otherwise returns `NULL` and stores zero. The values must be 
+ * stored packed (see `cap_parser_enable_packed_values`), so no copies are 
+ * made, otherwise `NULL` is returned as well. `args` remains the owner of the
+ * array, which is valid until values are added to the positional.
+ * 
+ * @param args object to search
+ * @param name null-terminated name of the positional
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const int * cap_pa_get_positional_ints(
+        const ParsedArguments * args, const char * name, size_t * count) {
+    return cap_nv_get_ints(_cap_pa_get_positional(args, name), count);
+}
+
+/**
+ * Retrieves all values of the given positional argument as an array of `double`.
+ * 
+ * Same as `cap_pa_get_positional_ints`, for values of type `DT_DOUBLE`.
+ * 
+ * @param args object to search
+ * @param name null-terminated name of the positional
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const double * cap_pa_get_positional_doubles(
+        const ParsedArguments * args, const char * name, size_t * count) {
+    return cap_nv_get_doubles(_cap_pa_get_positional(args, name), count);
+}
+
+/**
+ * Retrieves all values of the given positional argument as an array of strings.
+ * 
+ * Same as `cap_pa_get_positional_ints`, for values of type `DT_STRING`.
+ * 
+ * @param args object to search
+ * @param name null-terminated name of the positional
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const char * const * cap_pa_get_positional_strings(
+        const ParsedArguments * args, const char * name, size_t * count) {
+    return cap_nv_get_strings(_cap_pa_get_positional(args, name), count);
+}
+
+/**
+ * Retrieves all values of the positional argument with the given id as an array.
+ * 
+ * Same as `cap_pa_get_positional_ints`, but the positional is identified by its id.
+ * 
+ * @param args object to search
+ * @param id id of the positional
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const int * cap_pa_get_positional_ints_by_id(
+        const ParsedArguments * args, size_t id, size_t * count) {
+    return cap_nv_get_ints(_cap_pa_positional_at(args, id), count);
+}
+
+/**
+ * Retrieves all values of the positional argument with the given id as an array.
+ * 
+ * Same as `cap_pa_get_positional_doubles`, but the positional is identified by its id.
+ * 
+ * @param args object to search
+ * @param id id of the positional
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const double * cap_pa_get_positional_doubles_by_id(
+        const ParsedArguments * args, size_t id, size_t * count) {
+    return cap_nv_get_doubles(_cap_pa_positional_at(args, id), count);
+}
+
+/**
+ * Retrieves all values of the positional argument with the given id as an array.
+ * 
+ * Same as `cap_pa_get_positional_strings`, but the positional is identified by its id.
+ * 
+ * @param args object to search
+ * @param id id of the positional
+ * @param count set to the number of values, may be `NULL`
+ * @return array of values, or `NULL`
+ */
+const char * const * cap_pa_get_positional_strings_by_id(
+        const ParsedArguments * args, size_t id, size_t * count) {
+    return cap_nv_get_strings(_cap_pa_positional_at(args, id), count);
+}
+
+// ============================================================================
+// === PARSED ARGUMENTS: SUBCOMMANDS ==========================================
+// ============================================================================
+
+/**
+ * Retrieves the name of the parsed subcommand.
+ * 
+ * If the parser has subcommands (see `cap_parser_add_subcommand`), the
+ * subcommand given on the command line is stored together with the flags
+ * which preceded it.
+ * 
+ * @param args object to search
+ * @return name of the subcommand, or `NULL` if `args` has none
+ */
+const char * cap_pa_get_subcommand(const ParsedArguments * args) {
+    return args ? args -> mSubcommand : NULL;
+}
+
+/**
+ * Retrieves the arguments of the parsed subcommand.
+ * 
+ * The returned object holds the flags and positionals which followed the
+ * subcommand, as parsed by its parser. It is owned by `args` and destroyed
+ * together with it, so it must not be passed to `cap_pa_destroy`.
+ * 
+ * @param args object to search
+ * @return arguments of the subcommand, or `NULL` if `args` has none
+ */
+const ParsedArguments * cap_pa_get_subcommand_arguments(
+        const ParsedArguments * args) {
+    return args ? args -> mSubcommandArguments : NULL;
+}
+
 // ============================================================================
 // === IMPLEMENTATION OF PRIVATE FUNCTIONS ====================================
 // ============================================================================
@@ -380,6 +899,197 @@ NamedValues * _cap_pa_get_positional(
     return cap_nva_get(args -> mPositionals, name);
 }
 
+static const NamedValues * _cap_pa_flag_at(
+        const ParsedArguments * args, size_t id) {
+    return args ? cap_nva_get_at(args -> mFlags, id) : NULL;
+}
+
+static const NamedValues * _cap_pa_positional_at(
+        const ParsedArguments * args, size_t id) {
+    return args ? cap_nva_get_at(args -> mPositionals, id) : NULL;
+}
+
+static ParsedArguments * _cap_pa_make_in(
+        Arena * arena, size_t flag_count, size_t positional_count) {
+    ParsedArguments * pa = (ParsedArguments *) cap_arena_alloc(
+        arena, sizeof(ParsedArguments));
+    *pa = (ParsedArguments) {
+        .mFlags = NULL,
+        .mPositionals = NULL,
+        .mArena = arena,
+        .mResetMark = cap_arena_mark(arena),
+        .mResponseFiles = NULL,
+        .mResponseFileCount = 0u,
+        .mSubcommand = NULL,
+        .mSubcommandArguments = NULL,
+        .mSubparser = NULL,
+        .mReleaseSubparser = NULL
+    };
+    _cap_pa_make_containers(pa, flag_count, positional_count);
+    return pa;
+}
+
+static void _cap_pa_make_containers(
+        ParsedArguments * args, size_t flag_count, size_t positional_count) {
+    args -> mFlags = cap_nva_make_in(args -> mArena, flag_count);
+    args -> mPositionals = cap_nva_make_in(args -> mArena, positional_count);
+}
+
+static void _cap_pa_reset_reserved(
+        ParsedArguments * args, size_t flag_count, size_t positional_count) {
+    // everything except the object itself is allocated after the mark, so
+    // the containers are rebuilt in memory the arena already owns
+    _cap_pa_release_response_files(args);
+    _cap_pa_release_subcommand(args);
+    const bool pack = args -> mFlags -> mPackValues;
+    cap_arena_rewind(args -> mArena, args -> mResetMark);
+    _cap_pa_make_containers(args, flag_count, positional_count);
+    _cap_pa_enable_packing(args, pack);
+}
+
+static void _cap_pa_adopt_response_files(
+        ParsedArguments * args, ResponseFile * files, size_t count) {
+    // takes ownership of `files`, an array allocated using `cap_malloc`
+    _cap_pa_release_response_files(args);
+    args -> mResponseFiles = files;
+    args -> mResponseFileCount = count;
+}
+
+static void _cap_pa_add_response_file(
+        ParsedArguments * args, ResponseFile file) {
+    // takes ownership of the data of one more file
+    const size_t count = args -> mResponseFileCount;
+    args -> mResponseFiles = (ResponseFile *) (args -> mResponseFiles
+        ? cap_realloc(
+            args -> mResponseFiles, (count + 1u) * sizeof(ResponseFile))
+        : cap_malloc(sizeof(ResponseFile)));
+    args -> mResponseFiles[count] = file;
+    args -> mResponseFileCount = count + 1u;
+}
+
+static void _cap_pa_release_response_files(ParsedArguments * args) {
+    for (size_t i = 0u; i < args -> mResponseFileCount; ++i) {
+        _cap_rf_close(args -> mResponseFiles + i);
+    }
+    cap_free(args -> mResponseFiles);
+    args -> mResponseFiles = NULL;
+    args -> mResponseFileCount = 0u;
+}
+
+static void _cap_pa_set_subcommand(
+        ParsedArguments * args, const char * name,
+        ParsedArguments * subcommand_args, void * subparser,
+        void (* release_subparser)(void * parser)) {
+    // takes ownership of `subcommand_args` and of `subparser` (if it is not
+    // `NULL`), the name is copied so that `args` stays independent of the
+    // parser
+    _cap_pa_release_subcommand(args);
+    const size_t size = strlen(name) + 1u;
+    args -> mSubcommand = (char *) memcpy(
+        cap_arena_alloc(args -> mArena, size), name, size);
+    args -> mSubcommandArguments = subcommand_args;
+    args -> mSubparser = subparser;
+    args -> mReleaseSubparser = release_subparser;
+}
+
+static void _cap_pa_release_subcommand(ParsedArguments * args) {
+    // the arguments of the subcommand do not point into its parser, so they
+    // may be destroyed in any order
+    cap_pa_destroy(args -> mSubcommandArguments);
+    if (args -> mSubparser) {
+        args -> mReleaseSubparser(args -> mSubparser);
+    }
+    args -> mSubcommand = NULL;
+    args -> mSubcommandArguments = NULL;
+    args -> mSubparser = NULL;
+    args -> mReleaseSubparser = NULL;
+}
+
+static void _cap_pa_reserve_values(
+        ParsedArguments * args, const size_t * flag_value_sizes,
+        const size_t * positional_value_sizes) {
+    for (size_t i = 0u; i < cap_nva_length(args -> mFlags); ++i) {
+        _cap_nv_reserve(args -> mFlags -> mItems + i, flag_value_sizes[i]);
+    }
+    for (size_t i = 0u; i < cap_nva_length(args -> mPositionals); ++i) {
+        _cap_nv_reserve(
+            args -> mPositionals -> mItems + i, positional_value_sizes[i]);
+    }
+}
+
+static void _cap_pa_enable_packing(ParsedArguments * args, bool enable) {
+    // used by parsers before any values are stored
+    _cap_nva_enable_packing(args -> mFlags, enable);
+    _cap_nva_enable_packing(args -> mPositionals, enable);
+}
+
+static size_t _cap_pa_container_size(
+        size_t flag_count, size_t positional_count) {
+    // exact number of arena bytes used by _cap_pa_make_in
+    const size_t counts[2] = { flag_count, positional_count };
+    size_t size = cap_arena_footprint(sizeof(ParsedArguments));
+    for (size_t i = 0u; i < 2u; ++i) {
+        size += cap_arena_footprint(sizeof(NamedValuesArray))
+            + cap_arena_footprint(sizeof(StringIndex))
+            + cap_arena_footprint(counts[i] * sizeof(NamedValues))
+            + cap_arena_footprint(cap_si_reserved_size(counts[i]));
+    }
+    return size;
+}
+
+static size_t _cap_pa_arena_size(size_t flag_count, size_t positional_count) {
+    // a guess that fits typical command lines into the first chunk: the
+    // containers, and some room for names and values of each id
+    static const size_t PER_ID = 2u * sizeof(TypedUnion) + 32u;
+    static const size_t BASE = 512u;
+    return BASE + _cap_pa_container_size(flag_count, positional_count)
+        + (flag_count + positional_count) * PER_ID;
+}
+
+static ParsedArguments * _cap_pa_make_exact(
+        size_t flag_count, const size_t * flag_value_sizes,
+        size_t positional_count, const size_t * positional_value_sizes,
+        size_t extra_size, bool pack) {
+    // creates an object whose arena fits the containers, the given number
+    // of bytes of values for each id (see `_cap_nv_reserved_size`), and 
+    // `extra_size` more bytes (for names and strings), so that storing them
+    // does not need any allocations
+    size_t size = _cap_pa_container_size(flag_count, positional_count)
+        + extra_size;
+    for (size_t i = 0u; i < flag_count; ++i) {
+        size += cap_arena_footprint(flag_value_sizes[i]);
+    }
+    for (size_t i = 0u; i < positional_count; ++i) {
+        size += cap_arena_footprint(positional_value_sizes[i]);
+    }
+    ParsedArguments * pa = _cap_pa_make_in(
+        cap_arena_make(size), flag_count, positional_count);
+    _cap_pa_enable_packing(pa, pack);
+    _cap_pa_reserve_values(pa, flag_value_sizes, positional_value_sizes);
+    return pa;
+}
+
+static void _cap_pa_add_parsed_flag_at(
+        ParsedArguments * args, size_t id, const char * flag,
+        TypedUnion value, bool borrow) {
+    // used by parsers, `value` may point to a word of the command line
+    _cap_nva_append_parsed_value_at(args -> mFlags, id, flag, value, borrow);
+}
+
+static NamedValues * _cap_pa_positional_slot_at(
+        ParsedArguments * args, size_t id, const char * name) {
+    // used by parsers to store values directly
+    return _cap_nva_named_slot_at(args -> mPositionals, id, name);
+}
+
+static void _cap_pa_append_parsed_positional_at(
+        ParsedArguments * args, size_t id, const char * name,
+        TypedUnion value, bool borrow) {
+    // used by parsers, `value` may point to a word of the command line
+    _cap_nva_append_parsed_value_at(
+        args -> mPositionals, id, name, value, borrow);
+}
+
 /**
  * @}
  */
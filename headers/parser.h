@@ -47,7 +47,8 @@
  * - custom program name,
  * - program description,
  * - automatic or manual creation of help and usage messages, and
- * - enabling or disabling display of help and/or usage.
+ * - enabling or disabling display of help and/or usage, and
+ * - subcommands.
  * 
  * Do keep in mind that, in this document, "configuring a parser" is a general
  * expression used for any of the above listed changes to a parser. "Defining" a
@@ -185,6 +186,19 @@
  * `cap_parser_add_flag`. This, similarly to the help flag, allows the user to
  * re-configure or disable it. Creating aliases is also allowed.
  * 
+ * ### Subcommands
+ * Programs such as `git` take a command word, followed by arguments of that
+ * command (`git commit -m text`). Such a subcommand is configured using
+ * `cap_parser_add_subcommand`, which is given a function that configures the
+ * parser of the subcommand. A parser with subcommands takes no positionals:
+ * the first word which is not one of its flags names the subcommand, and all
+ * following words are parsed by the parser of the subcommand.
+ * 
+ * Parsers of subcommands are only built at parse-time, when their subcommand
+ * is given, and the subcommand is found by its name in constant time. A
+ * program with many subcommands therefore only pays for configuring the one
+ * which is used.
+ * 
  * ### Custom Program Name and Desctiption
  * The parser sometimes needs to display the program name, e.g. when a value
  * cannot be parsed as the desired type and an error message is in order. By
@@ -224,14 +238,49 @@
  * 
  * TODO
  * 
+ * ### Threads and Reentrancy
+ * Parsing does not modify the configuration of a parser, so all parsing
+ * functions take a `const ArgumentParser *`. Apart from the installed
+ * allocator (see `cap_allocator_set`), the library keeps no global state that
+ * parsing could change. Functions which take a `const` parser never write to
+ * it, so they need no locks:
+ * - the parsers of subcommands are built either by
+ *   `cap_parser_build_subcommands`, or for each parse which needs them and
+ *   then owned by its result,
+ * - help and usage messages are rendered for each print, unless
+ *   `cap_parser_prepare_help` rendered them beforehand,
+ * - the names offered by shell completion are sorted by the configuration
+ *   functions, see `cap_parser_enable_completion`.
+ *
+ * A configured parser can therefore be used by any number of threads at the
+ * same time, also without `CAP_ENABLE_THREADS` (which only enables the
+ * parallel number parsing of `cap_parser_set_thread_count`), provided that
+ * - no thread configures it (or destroys it) meanwhile,
+ * - each thread parses into its own `ParsedArguments` or `ParserIterator`,
+ * - the installed allocator is thread-safe, like the default one, and it is
+ *   not replaced while parsing.
+ *
+ * Reading a `ParsedArguments` never changes it, so a parse result can always
+ * be read by several threads at once.
+ *
+ * Effects outside the parser are not synchronized: `cap_parser_parse` prints
+ * errors and exits, and the records of `cap_parser_set_positional_input` are
+ * consumed from a file descriptor which is shared by all parses. Response
+ * files are only read.
+ * 
  */
 
+#include "allocator.h"
+#include "batch_number_parsing.h"
 #include "data_type.h"
 #include "flag_info.h"
 #include "helper_functions.h"
+#include "number_parsing.h"
+#include "parallel_number_parsing.h"
 #include "typed_union.h"
 #include "parsed_arguments.h"
 #include "positional_info.h"
+#include "string_index.h"
 
 #include <assert.h>
 #include <stddef.h>
@@ -285,6 +334,41 @@ typedef struct {
 
     bool mEnableHelp;
     bool mEnableUsage;
+    /// if `true`, DT_STRING values point into the parsed words instead of 
+    /// being copied, see `cap_parser_enable_borrowed_strings`
+    bool mBorrowStrings;
+    /// if `true`, parse results are allocated at their exact size, see
+    /// `cap_parser_enable_exact_allocation`
+    bool mExactAllocation;
+    /// if `true`, values are stored in packed arrays of their type, see
+    /// `cap_parser_enable_packed_values`
+    bool mPackValues;
+    /// if `true`, words `@path` are replaced by the words of the file at
+    /// `path`, see `cap_parser_enable_response_files`
+    bool mExpandResponseFiles;
+    /// file descriptor from which the positional with id `mInputPositional`
+    /// takes more values, or -1, see `cap_parser_set_positional_input`
+    int mInputFd;
+    size_t mInputPositional;
+    char mInputDelimiter;
+    /// number of threads converting long runs of numeric words, see
+    /// `cap_parser_set_thread_count`
+    size_t mThreadCount;
+    /// if `true`, strings given to configuration functions are stored without
+    /// being copied, see `cap_parser_enable_static_strings`
+    bool mStaticStrings;
+    /// which of the strings of the parser itself (`mProgramName` to
+    /// `mCustomUsage`) are borrowed, a combination of `_CAP_STATIC_*` bits
+    unsigned mStaticProperties;
+    /// supply the description and the epilogue instead of `mDescription` and
+    /// `mEpilogue`, or `NULL`
+    DescriptionProvider mDescriptionProvider;
+    void * mDescriptionContext;
+    DescriptionProvider mEpilogueProvider;
+    void * mEpilogueContext;
+    /// if `true`, the words `--cap-complete INDEX WORDS...` request shell
+    /// completion, see `cap_parser_enable_completion`
+    bool mEnableCompletion;
 
     FlagInfo ** mFlags;
     size_t mFlagCount;
@@ -295,10 +379,53 @@ typedef struct {
     size_t mPositionalAlloc;
 
     char * mFlagPrefixChars;
+    /// `mIsFlagPrefix[c]` is `true` iff `c` is one of `mFlagPrefixChars`
+    bool mIsFlagPrefix[256];
     FlagInfo * mFlagSeparatorInfo;
     FlagInfo * mHelpFlagInfo;
+
+    /// maps names and aliases of all flags (including the help flag and the 
+    /// flag separator) to their position in `mFlags`, or to one of the 
+    /// special values `_CAP_HELP_FLAG_ID` and `_CAP_FLAG_SEPARATOR_ID`
+    StringIndex * mFlagIndex;
+
+    /// subcommands in the order in which they were added, see
+    /// `cap_parser_add_subcommand`
+    struct _CapSubcommand * mSubcommands;
+    size_t mSubcommandCount;
+    size_t mSubcommandAlloc;
+    /// maps names of subcommands to their position in `mSubcommands`, `NULL`
+    /// until the first subcommand is added
+    StringIndex * mSubcommandIndex;
+
+    /// help message and usage string (without the program name) rendered
+    /// by `cap_parser_prepare_help`, empty until then and again after the
+    /// configuration changes. The help message is not kept if it uses
+    /// description providers.
+    TextBuffer mHelpText;
+    TextBuffer mUsageText;
+    /// names and aliases of all flags and names of subcommands in ascending
+    /// order, kept up to date by configuration functions while shell
+    /// completion is enabled, see `cap_parser_complete`
+    const char ** mCompletionNames;
+    size_t mCompletionNameCount;
+    size_t mCompletionNameAlloc;
 } ArgumentParser;
 
+/**
+ * Configures the parser of a subcommand.
+ * 
+ * A function of this type is given to `cap_parser_add_subcommand`. It is
+ * called at most once, when the subcommand is parsed for the first time, and
+ * configures `parser` like any other parser is configured, e.g. using
+ * `cap_parser_add_flag`. `parser` is a default parser (see
+ * `cap_parser_make_default`), owned by the parser of the main command.
+ * 
+ * @param parser new parser of the subcommand
+ * @param context the pointer given to `cap_parser_add_subcommand`
+ */
+typedef void (* SubparserBuilder)(ArgumentParser * parser, void * context);
+
 /**
  * Identifies a parse-time error.
  * 
@@ -362,8 +489,63 @@ typedef enum {
      * A flag was given too many times.
      * 
      * A flag was given more times than is required by the parser configuration. Additional word is the name of the flag.
+     * Parsing stops at the first occurrence which exceeds the limit.
+     */
+    PER_TOO_MANY_FLAGS,
+    /**
+     * A value given for a positional does not fit into its type.
+     * 
+     * A value of a numeric positional argument is well-formed, but it is out of the range of its type. Additional words are the name of the positional and the problematic value.
+     */
+    PER_POSITIONAL_OUT_OF_RANGE,
+    /**
+     * A value given to a flag does not fit into its type.
+     * 
+     * A value of a numeric flag is well-formed, but it is out of the range of the flag's type. Additional words are the name of the flag and the problematic value.
+     */
+    PER_FLAG_OUT_OF_RANGE,
+    /**
+     * A response file cannot be read.
+     * 
+     * A response file given as `@path` does not exist or cannot be read. Additional word is the path of the file.
+     */
+    PER_CANNOT_READ_RESPONSE_FILE,
+    /**
+     * A response file cannot be split into words.
+     * 
+     * A quote in a response file given as `@path` is not closed. Additional word is the path of the file.
+     */
+    PER_INVALID_RESPONSE_FILE,
+    /**
+     * Values of a positional cannot be read from its input.
+     * 
+     * Reading the file descriptor set by `cap_parser_set_positional_input` failed. Additional word is the name of the positional.
+     */
+    PER_CANNOT_READ_INPUT,
+    /**
+     * A command string cannot be split into words.
+     * 
+     * A quote in the string given to `cap_parser_parse_string` is not closed.
      */
-    PER_TOO_MANY_FLAGS
+    PER_UNTERMINATED_QUOTE,
+    /**
+     * An unknown subcommand was given.
+     * 
+     * The word in place of the subcommand is not the name of any subcommand configured by `cap_parser_add_subcommand`. Additional word is the unknown word.
+     */
+    PER_UNKNOWN_SUBCOMMAND,
+    /**
+     * No subcommand was given.
+     * 
+     * The parser has subcommands, but the command line ended before one was given.
+     */
+    PER_MISSING_SUBCOMMAND,
+    /**
+     * The index of a completed word is not a number.
+     * 
+     * The word after `--cap-complete` is not a non-negative integer, see `cap_parser_enable_completion`. Additional word is the invalid index.
+     */
+    PER_INVALID_COMPLETION_INDEX
 } ParsingError;
 
 /**
@@ -375,6 +557,11 @@ typedef enum {
  * when an error is encountered. The success, result, and error message for
  * that parsing operation are stored in this object.
  * 
+ * Error words are words of the command line or names from the parser
+ * configuration. If `cap_parser_parse_noexit` fails, a word read from
+ * a response file is replaced by the argument `@path` which named the file,
+ * because the file is released together with the `ParsedArguments`.
+ * 
  * @note `cap_parser_parse_noexit` and by extension `ParsingResult` exist
  * mainly for unit testing purposes. Users should primarily use
  * `cap_parser_parse`.
@@ -402,6 +589,17 @@ typedef struct {
     ParsingError mError;
 } ParsingResult;
 
+/**
+ * Identifies a shell for which a completion script is generated.
+ *
+ * @see cap_parser_print_completion_script
+ */
+typedef enum {
+    CS_BASH,
+    CS_ZSH,
+    CS_FISH
+} CompletionShell;
+
 // ============================================================================
 // === PARSER: DEFINITION OF PRIVATE TYPES ====================================
 // ============================================================================
@@ -436,17 +634,30 @@ typedef enum {
     APE_OK,
     APE_PRESENCE,
     APE_REQUIRED_AFTER_OPTIONAL,
+    APE_SUBCOMMANDS,
 } AddPositionalError;
 
+typedef enum {
+    ASE_OK,
+    ASE_MISSING_PARSER,
+    ASE_MISSING_NAME,
+    ASE_MISSING_BUILDER,
+    ASE_INVALID_PREFIX,
+    ASE_DUPLICATE,
+    ASE_POSITIONALS
+} AddSubcommandError;
+
 typedef enum {
     OFPE_NO_ERROR,
     OFPE_UNKNOWN_FLAG,
     OFPE_MISSING_FLAG_VALUE,
-    OFPE_CANNOT_PARSE_FLAG
+    OFPE_CANNOT_PARSE_FLAG,
+    OFPE_FLAG_OUT_OF_RANGE
 } OneFlagParsingError;
 
 typedef struct {
     const FlagInfo * mFlag;
+    size_t mFlagId;
     TypedUnion mValue;
     int mWordsConsumed;
     OneFlagParsingError mError;
@@ -455,7 +666,8 @@ typedef struct {
 typedef enum {
     OPPE_NO_ERROR,
     OPPE_TOO_MANY,
-    OPPE_CANNOT_PARSE
+    OPPE_CANNOT_PARSE,
+    OPPE_OUT_OF_RANGE
 } OnePositionalParsingError;
 
 typedef struct {
@@ -466,7 +678,6 @@ typedef struct {
 } OnePositionalParsingResult;
 
 typedef enum {
-    TOO_MANY,
     TOO_FEW,
     GOOD
 } BoundsCheckingResult;
@@ -476,35 +687,184 @@ typedef struct {
     BoundsCheckingResult mCount;
 } FlagCountCheckResult;
 
+/// subcommand of a parser. Its parser is built by
+/// `cap_parser_build_subcommands`, or for each parse which needs it.
+typedef struct _CapSubcommand {
+    char * mName;
+    char * mDescription;
+    SubparserBuilder mBuilder;
+    void * mContext;
+    /// parser of the subcommand, `NULL` until it is built by
+    /// `cap_parser_build_subcommands`
+    ArgumentParser * mParser;
+    /// if `true`, `mName` and `mDescription` are borrowed
+    bool mStaticStrings;
+} _CapSubcommand;
+
+/// cursor over the words of a command line, in which the words of response
+/// files are read in place of the arguments naming them
+typedef struct {
+    const char * const * mArgv;
+    int mArgc;
+    /// index of the current word, or of the argument naming the response file
+    /// which contains it
+    int mIndex;
+    /// response files which were not entered yet, ordered by `mIndex`
+    const ResponseFile * mFiles;
+    size_t mFileCount;
+    /// current word, `NULL` after the last word
+    const char * mWord;
+    /// end of the words of the current response file, `NULL` if the current
+    /// word is on the command line
+    const char * mFileEnd;
+} _CapWords;
+
+/// reader of delimited records from a file descriptor. The records are read
+/// in large chunks, and handed out as null-terminated words in place.
+typedef struct {
+    int mFd;
+    char mDelimiter;
+    /// `mSize` bytes, and one more for a null character after the last record
+    char * mBuffer;
+    size_t mSize;
+    /// number of bytes in `mBuffer`
+    size_t mUsed;
+    /// number of bytes of records which were handed out, a partial record
+    /// follows them
+    size_t mConsumed;
+    bool mEnd;
+    bool mFailed;
+} _CapInput;
+
+/// value stored in `ArgumentParser::mFlagIndex` for names of the help flag
+static const size_t _CAP_HELP_FLAG_ID = (size_t) -1;
+/// value stored in `ArgumentParser::mFlagIndex` for names of the flag separator
+static const size_t _CAP_FLAG_SEPARATOR_ID = (size_t) -2;
+/// bits of `ArgumentParser::mStaticProperties`
+static const unsigned _CAP_STATIC_PROGRAM_NAME = 1u << 0;
+static const unsigned _CAP_STATIC_DESCRIPTION = 1u << 1;
+static const unsigned _CAP_STATIC_EPILOGUE = 1u << 2;
+static const unsigned _CAP_STATIC_CUSTOM_HELP = 1u << 3;
+static const unsigned _CAP_STATIC_CUSTOM_USAGE = 1u << 4;
+/// number of numeric positional words converted at once
+#define _CAP_NUMERIC_CHUNK_SIZE 256
+/// number of bytes of positional input read at once
+#define _CAP_INPUT_CHUNK_SIZE ((size_t) 1 << 20)
+/// replaces words of positional input in errors of `cap_parser_parse_noexit`
+static const char * const _CAP_INPUT_ERROR_WORD = "(input)";
+/// program name in messages of `cap_parser_parse_string` if none is configured
+static const char * const _CAP_STRING_PROGRAM_NAME = "command";
+
 // ============================================================================
 // === PARSER: DECLARATION OF PRIVATE FUNCTIONS ===============================
 // ============================================================================
 
-static bool _cap_parse_double(const char * word, double * value);
-static bool _cap_parse_int(const char * word, int * value);
-static bool _cap_parse_word_as_type(
+static WordConversionResult _cap_parse_word_as_type(
     const char * word, DataType type, TypedUnion * uninitialized_tu);
+static bool _cap_parser_find_flag_id(
+    const ArgumentParser * parser, const char * flag, size_t * id);
 static FlagInfo * _cap_parser_find_flag(
     const ArgumentParser * parser, const char * flag);
-static bool _cap_flag_matches_name_or_alias(
-    const FlagInfo * flag_info, const char * name_or_alias);
+static void _cap_parser_index_flag(
+    ArgumentParser * parser, const FlagInfo * flag_info, size_t id);
+static void _cap_parser_unindex_flag(
+    ArgumentParser * parser, const FlagInfo * flag_info);
 static const char * _cap_get_shortest_flag_name(const FlagInfo * flag_info);
+static void _cap_parser_set_string(
+    ArgumentParser * parser, char ** property, unsigned static_bit,
+    const char * value);
+static void _cap_parser_index_subcommands(ArgumentParser * parser);
+static ArgumentParser * _cap_parser_build_subparser(
+    const ArgumentParser * parser, size_t id);
+static const ArgumentParser * _cap_parser_get_subparser(
+    const ArgumentParser * parser, size_t id, ArgumentParser ** built);
+static void _cap_parser_release_subparser(void * parser);
+static void _cap_parser_release_subparsers(ArgumentParser * parser);
+static bool _cap_parser_has_name(
+    const ArgumentParser * parser, const char * name);
+static void _cap_parser_init_texts(ArgumentParser * parser);
+static void _cap_parser_forget_texts(ArgumentParser * parser);
+static void _cap_parser_release_texts(ArgumentParser * parser);
+static const TextBuffer * _cap_parser_get_text(
+    const ArgumentParser * parser, bool help, TextBuffer * rendered);
+static bool _cap_parser_has_providers(const ArgumentParser * parser);
+static void _cap_parser_render_usage(
+    const ArgumentParser * parser, TextBuffer * text);
+static void _cap_parser_render_help(
+    const ArgumentParser * parser, TextBuffer * text);
+static size_t _cap_copy_text(
+    char * buffer, size_t size, size_t offset, const char * text,
+    size_t length);
+static const char ** _cap_parser_sort_names(
+    const ArgumentParser * parser, size_t * count);
+static void _cap_parser_build_completion_names(ArgumentParser * parser);
+static void _cap_parser_insert_completion_name(
+    ArgumentParser * parser, const char * name);
+static void _cap_parser_remove_completion_name(
+    ArgumentParser * parser, const char * name);
+static int _cap_compare_names(const void * a, const void * b);
+static void _cap_parser_check_completion(
+    const ArgumentParser * parser, int argc, const char ** argv);
 
 static OnePositionalParsingResult _cap_parser_parse_one_positional(
     const ArgumentParser * parser, const char * arg, 
     size_t positional_index);
 static OneFlagParsingResult _cap_parser_parse_one_flag(
-    const ArgumentParser * parser, int argc, const char * const * argv,
-    int index); 
+    const ArgumentParser * parser, _CapWords * words);
+static bool _cap_parser_parse_numeric_run(
+    const ArgumentParser * parser, _CapWords * words, size_t positional_index,
+    bool positional_only, ParsingResult * result);
+static bool _cap_parser_store_numeric_words(
+    const ArgumentParser * parser, size_t positional_index,
+    const char * const * words, size_t count, const char * limit,
+    ParsingResult * result);
 static void _cap_parser_parse_flags_and_positionals(
+    const ArgumentParser * parser, _CapWords words, ParsingResult * result);
+static void _cap_parser_parse_subcommand(
+    const ArgumentParser * parser, _CapWords words, ParsingResult * result);
+static size_t _cap_parser_count_values(
+    const ArgumentParser * parser, _CapWords words, size_t * flag_counts,
+    size_t * positional_counts);
+static void _cap_parser_count_to_size(
+    const ArgumentParser * parser, size_t * flag_counts,
+    size_t * positional_counts);
+static ParsedArguments * _cap_parser_make_exact_arguments(
+    const ArgumentParser * parser, _CapWords words);
+static ParsedArguments * _cap_parser_make_arguments(
+    const ArgumentParser * parser, _CapWords words);
+
+static _CapWords _cap_words_make(
+    int argc, const char * const * argv, const ResponseFile * files,
+    size_t file_count);
+static void _cap_words_load(_CapWords * words);
+static void _cap_words_advance(_CapWords * words);
+static ParsingResult _cap_parser_open_response_files(
     const ArgumentParser * parser, int argc, const char * const * argv,
-    ParsingResult * result);
+    ResponseFile ** files, size_t * file_count);
+static void _cap_parser_detach_error_words(ParsingResult * result);
+static void _cap_input_init(_CapInput * input, int fd, char delimiter);
+static bool _cap_input_next(_CapInput * input, _CapWords * words);
+static char * _cap_input_detach(_CapInput * input);
+static void _cap_input_destroy(_CapInput * input);
+static void _cap_parser_parse_input(
+    const ArgumentParser * parser, ParsingResult * result);
 
 static FlagCountCheckResult _cap_parser_check_flag_counts(
     const ArgumentParser * parser, const ParsedArguments * parsed_arguments);
 static void _cap_parser_check_flag_and_positional_counts(
     const ArgumentParser * parser, ParsingResult * result);
 
+static ParsingResult _cap_parser_parse_noexit(
+    const ArgumentParser * parser, int argc, const char ** argv);
+static ParsingResult _cap_parser_parse_all(
+    const ArgumentParser * parser, int argc, const char ** argv);
+static ParsingResult _cap_parser_parse_into(
+    const ArgumentParser * parser, ParsedArguments * args, _CapWords words);
+static ParsingResult _cap_parser_parse_string(
+    const ArgumentParser * parser, char * buffer, size_t length);
+static ParsedArguments * _cap_parser_finish_parsing(
+    const ArgumentParser * parser, ParsingResult result, const char ** argv);
+
 // ============================================================================
 // === PARSER: DECLARATION OF PUBLIC FUNCTIONS ================================
 // ============================================================================
@@ -515,6 +875,8 @@ void cap_parser_set_flag_separator(
     ArgumentParser * parser, const char * separator, const char * description);
 void cap_parser_enable_help(ArgumentParser * parser, bool enable);
 void cap_parser_enable_usage(ArgumentParser * parser, bool enable);
+bool cap_parser_get_positional_id(
+    const ArgumentParser * parser, const char * name, size_t * id);
 
 // ============================================================================
 // === PARSER: CREATION AND DESTRUCTION =======================================
@@ -533,7 +895,7 @@ void cap_parser_enable_usage(ArgumentParser * parser, bool enable);
  * @see cap_parser_make_default
  */
 ArgumentParser * cap_parser_make_empty() {
-    ArgumentParser * p = (ArgumentParser *) malloc(sizeof(ArgumentParser));
+    ArgumentParser * p = (ArgumentParser *) cap_malloc(sizeof(ArgumentParser));
     *p = (ArgumentParser) {
         .mProgramName = NULL,
         .mDescription = NULL,
@@ -542,6 +904,21 @@ ArgumentParser * cap_parser_make_empty() {
         .mCustomUsage = NULL,
         .mEnableHelp = false,
         .mEnableUsage = false,
+        .mBorrowStrings = false,
+        .mExactAllocation = false,
+        .mPackValues = false,
+        .mExpandResponseFiles = false,
+        .mInputFd = -1,
+        .mInputPositional = 0u,
+        .mInputDelimiter = '\0',
+        .mThreadCount = 1u,
+        .mStaticStrings = false,
+        .mStaticProperties = 0u,
+        .mDescriptionProvider = NULL,
+        .mDescriptionContext = NULL,
+        .mEpilogueProvider = NULL,
+        .mEpilogueContext = NULL,
+        .mEnableCompletion = false,
 
         .mFlags = NULL,
         .mFlagCount = 0u,
@@ -552,9 +929,19 @@ ArgumentParser * cap_parser_make_empty() {
         .mPositionalAlloc = 0u,
         
         .mFlagPrefixChars = copy_string("-"),
+        .mIsFlagPrefix = { false },
         .mFlagSeparatorInfo = NULL,
-        .mHelpFlagInfo = NULL
+        .mHelpFlagInfo = NULL,
+
+        .mFlagIndex = cap_si_make_empty(),
+
+        .mSubcommands = NULL,
+        .mSubcommandCount = 0u,
+        .mSubcommandAlloc = 0u,
+        .mSubcommandIndex = NULL
     };
+    p -> mIsFlagPrefix['-'] = true;
+    _cap_parser_init_texts(p);
     return p;
 }
 
@@ -588,21 +975,24 @@ ArgumentParser * cap_parser_make_default() {
  */
 void cap_parser_destroy(ArgumentParser * parser) {
     if (!parser) return;
-    if (parser -> mProgramName) {
-        free(parser -> mProgramName);
-        parser -> mProgramName = NULL;
-    }
-    delete_string_property(&(parser -> mDescription));
-    delete_string_property(&(parser -> mEpilogue));
-    delete_string_property(&(parser -> mCustomHelp));
+    _cap_parser_set_string(
+        parser, &(parser -> mProgramName), _CAP_STATIC_PROGRAM_NAME, NULL);
+    _cap_parser_set_string(
+        parser, &(parser -> mDescription), _CAP_STATIC_DESCRIPTION, NULL);
+    _cap_parser_set_string(
+        parser, &(parser -> mEpilogue), _CAP_STATIC_EPILOGUE, NULL);
+    _cap_parser_set_string(
+        parser, &(parser -> mCustomHelp), _CAP_STATIC_CUSTOM_HELP, NULL);
+    _cap_parser_set_string(
+        parser, &(parser -> mCustomUsage), _CAP_STATIC_CUSTOM_USAGE, NULL);
     for (size_t i = 0; i < parser -> mFlagCount; ++i) {
         cap_flag_info_destroy(parser -> mFlags[i]);
     }
     for (size_t i = 0; i < parser -> mPositionalCount; ++i) {
         cap_positional_info_destroy(parser -> mPositionals[i]);
     }
-    free(parser -> mFlags);
-    free(parser -> mPositionals);
+    cap_free(parser -> mFlags);
+    cap_free(parser -> mPositionals);
     parser -> mFlags = NULL;
     parser -> mPositionals = NULL;
     parser -> mFlagCount = parser -> mFlagAlloc = 0u;
@@ -618,8 +1008,22 @@ void cap_parser_destroy(ArgumentParser * parser) {
         cap_flag_info_destroy(parser -> mFlagSeparatorInfo);
         parser -> mFlagSeparatorInfo = NULL;
     }
+    cap_si_destroy(parser -> mFlagIndex);
+    parser -> mFlagIndex = NULL;
+
+    _cap_parser_release_subparsers(parser);
+    for (size_t i = 0; i < parser -> mSubcommandCount; ++i) {
+        if (!parser -> mSubcommands[i].mStaticStrings) {
+            cap_free(parser -> mSubcommands[i].mName);
+            delete_string_property(&(parser -> mSubcommands[i].mDescription));
+        }
+    }
+    cap_free(parser -> mSubcommands);
+    parser -> mSubcommands = NULL;
+    parser -> mSubcommandCount = parser -> mSubcommandAlloc = 0u;
 
-    free(parser);
+    _cap_parser_release_texts(parser);
+    cap_free(parser);
 }
 
 // ============================================================================
@@ -659,6 +1063,10 @@ void cap_parser_set_flag_prefix(
         exit(-1);
     }
     set_string_property(&(parser -> mFlagPrefixChars), prefix_chars);
+    memset(parser -> mIsFlagPrefix, 0, sizeof(parser -> mIsFlagPrefix));
+    for (const char * c = prefix_chars; *c; ++c) {
+        parser -> mIsFlagPrefix[(unsigned char) *c] = true;
+    }
     return;
 }
 
@@ -696,7 +1104,9 @@ void cap_parser_set_flag_separator(
         fprintf(stderr, "cap: missing flag separator\n");
         exit(-1);
     }
+    _cap_parser_forget_texts(parser);
     if (parser -> mFlagSeparatorInfo) {
+        _cap_parser_unindex_flag(parser, parser -> mFlagSeparatorInfo);
         cap_flag_info_destroy(parser -> mFlagSeparatorInfo);
         parser -> mFlagSeparatorInfo = NULL;
     }
@@ -712,8 +1122,9 @@ void cap_parser_set_flag_separator(
     FlagInfo * separator_info = cap_flag_info_make(
         separator, NULL, 
 	description ? description : DEFAULT_FLAG_SEPARATOR_DESCRIPTION,
-       	DT_PRESENCE, 0, -1);
+       	DT_PRESENCE, 0, -1, parser -> mStaticStrings);
     parser -> mFlagSeparatorInfo = separator_info;
+    _cap_parser_index_flag(parser, separator_info, _CAP_FLAG_SEPARATOR_ID);
 }
 
 /**
@@ -731,7 +1142,8 @@ void cap_parser_set_program_name(ArgumentParser * parser, const char * name) {
     if (!parser) {
         return;
     }
-    set_string_property(&(parser -> mProgramName), name);
+    _cap_parser_set_string(
+        parser, &(parser -> mProgramName), _CAP_STATIC_PROGRAM_NAME, name);
 }
 
 /**
@@ -743,7 +1155,8 @@ void cap_parser_set_program_name(ArgumentParser * parser, const char * name) {
  * function by giving `NULL` as the second parameter.
  * 
  * If `description` is not `NULL`, a copy of it is created and `parser` becomes
- * the owner of that copy.
+ * the owner of that copy, unless static strings are enabled (see
+ * `cap_parser_enable_static_strings`).
  * 
  * @param parser parser object to configure
  * @param description null-terminated description of the program, or NULL
@@ -753,7 +1166,9 @@ void cap_parser_set_description(
     if (!parser) {
         return;
     }
-    set_string_property(&(parser -> mDescription), description);
+    _cap_parser_set_string(
+        parser, &(parser -> mDescription), _CAP_STATIC_DESCRIPTION,
+        description);
 }
 
 /**
@@ -765,7 +1180,8 @@ void cap_parser_set_description(
  * as the second parameter.
  * 
  * If `epilogue` is not `NULL`, a copy of it is created and `parser` becomes 
- * the owner of that copy.
+ * the owner of that copy, unless static strings are enabled (see
+ * `cap_parser_enable_static_strings`).
  * 
  * @param parser object to configure
  * @param epilogue epilogue of the help message, or `NULL`
@@ -774,7 +1190,8 @@ void cap_parser_set_epilogue(ArgumentParser * parser, const char * epilogue) {
     if (!parser) {
         return;
     }
-    set_string_property(&(parser -> mEpilogue), epilogue);
+    _cap_parser_set_string(
+        parser, &(parser -> mEpilogue), _CAP_STATIC_EPILOGUE, epilogue);
 }
 
 /**
@@ -793,7 +1210,8 @@ void cap_parser_set_epilogue(ArgumentParser * parser, const char * epilogue) {
  * configured by passing an empty string to this function.
  * 
  * If `help` is not `NULL`, a copy of it is created and `parser` becomes the 
- * owner of that copy.
+ * owner of that copy, unless static strings are enabled (see
+ * `cap_parser_enable_static_strings`).
  * 
  * @param parser object to configure
  * @param help custom help message, or `NULL`
@@ -802,7 +1220,8 @@ void cap_parser_set_custom_help(ArgumentParser * parser, const char * help) {
     if (!parser) {
         return;
     }
-    set_string_property(&(parser -> mCustomHelp), help);
+    _cap_parser_set_string(
+        parser, &(parser -> mCustomHelp), _CAP_STATIC_CUSTOM_HELP, help);
 }
 
 /**
@@ -826,7 +1245,8 @@ void cap_parser_set_custom_usage(ArgumentParser * parser, const char * usage) {
     if (!parser) {
         return;
     }
-    set_string_property(&(parser -> mCustomUsage), usage);
+    _cap_parser_set_string(
+        parser, &(parser -> mCustomUsage), _CAP_STATIC_CUSTOM_USAGE, usage);
 }
 
 /**
@@ -865,6 +1285,369 @@ void cap_parser_enable_usage(ArgumentParser * parser, bool enable) {
     parser -> mEnableUsage = enable;
 }
 
+/**
+ * Enables or disables borrowing of string values.
+ * 
+ * By default, values of DT_STRING flags and positionals are copied into the 
+ * resulting `ParsedArguments`. When borrowing is enabled, the `TypedUnion`s
+ * point straight into the array of words given to `cap_parser_parse` and no
+ * strings are copied. They are also never freed by `cap_pa_destroy`.
+ * 
+ * Only enable this if the words outlive every `ParsedArguments` produced by
+ * the parser. That is the case when parsing `argv` given to `main`.
+ * 
+ * @param parser object to configure
+ * @param enable `true` if string values should be borrowed, `false` if they
+ *        should be copied
+ */
+void cap_parser_enable_borrowed_strings(ArgumentParser * parser, bool enable) {
+    if (!parser) {
+        return;
+    }
+    parser -> mBorrowStrings = enable;
+}
+
+/**
+ * Enables or disables exact allocation of parse results.
+ * 
+ * When enabled, parsing is done in two passes. The first pass classifies the
+ * words without converting any values and counts how many values each flag 
+ * and positional argument receives. The resulting `ParsedArguments` is then 
+ * allocated at its exact final size, and the second pass stores the values
+ * without growing any buffers. This pays off when there are many values, e.g.
+ * a variadic positional receiving thousands of words. For short command 
+ * lines, the extra pass is usually not worth it.
+ * 
+ * @param parser object to configure
+ * @param enable `true` if results should be allocated at their exact size
+ */
+void cap_parser_enable_exact_allocation(ArgumentParser * parser, bool enable) {
+    if (!parser) {
+        return;
+    }
+    parser -> mExactAllocation = enable;
+}
+
+/**
+ * Enables or disables packed storage of values.
+ * 
+ * By default, the values of each flag and positional argument are stored as
+ * an array of `TypedUnion`s. When packing is enabled, values of one type are
+ * stored in an array of that type instead, e.g. `int[]` for `DT_INT`, which
+ * takes a quarter of the memory for many integers. Such arrays are returned
+ * by functions such as `cap_pa_get_positional_ints`, which return `NULL` for
+ * values which are not packed.
+ * 
+ * Values stored in a packed array have no `TypedUnion`, so functions such as
+ * `cap_pa_get_positional_i` return `NULL` for them. The value of a flag or
+ * positional which receives only a single value is still accessible that 
+ * way. Packing is disabled by default.
+ * 
+ * @param parser object to configure
+ * @param enable `true` if values should be stored packed
+ */
+void cap_parser_enable_packed_values(ArgumentParser * parser, bool enable) {
+    if (!parser) {
+        return;
+    }
+    parser -> mPackValues = enable;
+}
+
+/**
+ * Enables or disables response files.
+ *
+ * When enabled, each command line word `@path` (except words after the flag
+ * separator) is replaced by the words contained in the file at `path`. This
+ * lets callers pass more words than the system allows on a command line, e.g.
+ * long lists of files. See @ref response_file for how files are split into
+ * words. Words read from a file are never expanded again.
+ *
+ * The file is mapped into memory and split in place, so its words are not
+ * copied. They stay valid as long as the `ParsedArguments` produced from
+ * them, also when `cap_parser_enable_borrowed_strings` is enabled.
+ *
+ * If a file cannot be read, parsing fails with
+ * `PER_CANNOT_READ_RESPONSE_FILE`. If a quote in it is not closed, it fails
+ * with `PER_INVALID_RESPONSE_FILE`. Response files are disabled by default.
+ *
+ * @param parser object to configure
+ * @param enable `true` if words `@path` should be replaced by the words of
+ *        files
+ */
+void cap_parser_enable_response_files(ArgumentParser * parser, bool enable) {
+    if (!parser) {
+        return;
+    }
+    parser -> mExpandResponseFiles = enable;
+}
+
+/**
+ * Enables or disables the shell completion mode.
+ *
+ * When enabled, `cap_parser_parse` checks whether the command line is
+ * `PROGRAM --cap-complete INDEX WORDS...`. If it is, it prints the candidates
+ * for the word `INDEX` of `WORDS` (see `cap_parser_complete`) and exits the
+ * program. The word `--cap-complete` is not a flag of the parser, so it is
+ * not shown by help messages. The scripts printed by
+ * `cap_parser_print_completion_script` run the program this way.
+ *
+ * Nothing but the configuration of the parser is needed to complete a word,
+ * so the program should parse its command line before anything else which
+ * takes time. Only the parsers of subcommands which are on the completed
+ * command line are built (see `cap_parser_add_subcommand`). If the index is
+ * not a number, the program exits with an error message. The completion
+ * mode is disabled by default.
+ *
+ * While the completion mode is enabled, the parser keeps the names of its
+ * flags, their aliases, and its subcommands sorted, so that completing a word
+ * only looks them up.
+ *
+ * @param parser object to configure
+ * @param enable `true` if `--cap-complete` should request completion
+ */
+void cap_parser_enable_completion(ArgumentParser * parser, bool enable) {
+    if (!parser || parser -> mEnableCompletion == enable) {
+        return;
+    }
+    parser -> mEnableCompletion = enable;
+    _cap_parser_build_completion_names(parser);
+}
+
+/**
+ * Reads further values of a variadic positional from a file descriptor.
+ *
+ * After the command line has been parsed, the records read from `fd` until
+ * its end are appended to the values of the positional `name`, the same way
+ * as `xargs -0` appends its input to a command. Records are separated by
+ * `delimiter`, typically `'\0'` (as written by `find -print0`) or `'\n'`.
+ * A delimiter after the last record is optional, empty records are kept.
+ * Records are never taken for flags, and are converted to the type of the
+ * positional like command line words.
+ *
+ * The input is read in chunks, so it is never held in memory at once unless
+ * its values are borrowed strings (see `cap_parser_enable_borrowed_strings`),
+ * which then stay valid as long as the `ParsedArguments`. A `ParserIterator`
+ * yields the records one at a time, a yielded string is valid until the next
+ * item is requested.
+ *
+ * If `fd` cannot be read, parsing fails with `PER_CANNOT_READ_INPUT`. Errors
+ * in a record name the word "(input)" instead of the record. The descriptor
+ * is neither closed nor rewound by the parser. Input is only supported on
+ * POSIX systems.
+ *
+ * @param parser object to configure
+ * @param name name of a variadic positional
+ * @param fd file descriptor to read from (e.g. `STDIN_FILENO`), or a negative
+ *        number to disable reading input
+ * @param delimiter character separating the records
+ */
+void cap_parser_set_positional_input(
+        ArgumentParser * parser, const char * name, int fd, char delimiter) {
+    if (!parser) {
+        return;
+    }
+    if (fd < 0) {
+        parser -> mInputFd = -1;
+        return;
+    }
+#if !defined(_CAP_POSIX)
+    (void) name;
+    (void) delimiter;
+    fprintf(stderr, "cap: positional input is not supported on this system\n");
+    exit(-1);
+#else
+    size_t id;
+    if (!name) {
+        fprintf(stderr, "cap: missing positional name\n");
+        exit(-1);
+    }
+    if (!cap_parser_get_positional_id(parser, name, &id)) {
+        fprintf(stderr, "cap: unknown positional argument %s\n", name);
+        exit(-1);
+    }
+    if (!parser -> mPositionals[id] -> mVariadic) {
+        fprintf(stderr, "cap: positional argument %s is not variadic\n", name);
+        exit(-1);
+    }
+    parser -> mInputFd = fd;
+    parser -> mInputPositional = id;
+    parser -> mInputDelimiter = delimiter;
+#endif
+}
+
+/**
+ * Sets the number of threads converting values.
+ *
+ * Words are always classified as flags, flag values and positionals on the
+ * calling thread, because the meaning of a word depends on the words before
+ * it. With more than one thread, a long run of words of a variadic `DT_INT`
+ * or `DT_DOUBLE` positional is then cut into slices which are converted on
+ * up to `count` threads at once (including the calling one), each storing
+ * its values into its own part of the result. The parsed values and errors
+ * are identical to parsing on one thread.
+ *
+ * Threads are started for each run of at least 32768 words and joined
+ * before the run is stored, so parsers hold no threads. This pays off for
+ * command lines (or response files, or input) with millions of numbers.
+ * Threads are only used if `CAP_ENABLE_THREADS` is defined before including
+ * the library, on POSIX systems, and the program must then be linked with
+ * `-pthread`. Otherwise values are always converted on the calling thread.
+ * One thread is used by default.
+ *
+ * @param parser object to configure
+ * @param count maximum number of threads, 0 and 1 both mean the calling
+ *        thread only
+ */
+void cap_parser_set_thread_count(ArgumentParser * parser, size_t count) {
+    if (!parser) {
+        return;
+    }
+    parser -> mThreadCount = count ? count : 1u;
+}
+
+/**
+ * Enables or disables static configuration strings.
+ * 
+ * By default, the parser stores copies of all strings given to configuration
+ * functions, so that the caller may release them right away. Most programs
+ * pass string literals, which need not be copied. When static strings are
+ * enabled, the parser stores the given pointers instead of copies, which
+ * saves an allocation and a copy for each name, alias, metavar, and
+ * description.
+ * 
+ * This affects the strings given to the functions called while static strings
+ * are enabled (including aliases of flags added while they were enabled):
+ * flags, positionals and subcommands, the program name, the description, the
+ * epilogue, and custom help and usage. These strings must not be modified and
+ * must remain valid until the parser is destroyed. Compiled parsers (see
+ * `cap_parser_compile`) still copy all strings.
+ * 
+ * ``` c
+ * ArgumentParser * parser = cap_parser_make_default();
+ * cap_parser_enable_static_strings(parser, true);
+ * cap_parser_add_flag(parser, "-v", DT_PRESENCE, 0, 1, NULL, "Be verbose");
+ * ```
+ * 
+ * @param parser object to configure
+ * @param enable `true` to store the given strings themselves, `false` to
+ *        store copies
+ */
+void cap_parser_enable_static_strings(ArgumentParser * parser, bool enable) {
+    if (!parser) {
+        return;
+    }
+    parser -> mStaticStrings = enable;
+}
+
+// ============================================================================
+// === PARSER: DESCRIPTION PROVIDERS ==========================================
+// ============================================================================
+
+/**
+ * Sets a function which supplies the description of the program.
+ * 
+ * Instead of the description configured using `cap_parser_set_description`,
+ * the text returned by `provider` is displayed in the automatically generated
+ * help message. `provider` is only called when the help message is printed,
+ * so a description which is costly to produce costs nothing otherwise.
+ * 
+ * @param parser object to configure
+ * @param provider function returning the description, or `NULL` to use the
+ *        configured description again
+ * @param context pointer passed to `provider`
+ */
+void cap_parser_set_description_provider(
+        ArgumentParser * parser, DescriptionProvider provider, void * context) {
+    if (!parser) {
+        return;
+    }
+    parser -> mDescriptionProvider = provider;
+    parser -> mDescriptionContext = context;
+    _cap_parser_forget_texts(parser);
+}
+
+/**
+ * Sets a function which supplies the epilogue of the help message.
+ * 
+ * Like `cap_parser_set_description_provider`, but supplies the epilogue (see
+ * `cap_parser_set_epilogue`).
+ * 
+ * @param parser object to configure
+ * @param provider function returning the epilogue, or `NULL` to use the
+ *        configured epilogue again
+ * @param context pointer passed to `provider`
+ */
+void cap_parser_set_epilogue_provider(
+        ArgumentParser * parser, DescriptionProvider provider, void * context) {
+    if (!parser) {
+        return;
+    }
+    parser -> mEpilogueProvider = provider;
+    parser -> mEpilogueContext = context;
+    _cap_parser_forget_texts(parser);
+}
+
+/**
+ * Sets a function which supplies the description of a flag.
+ * 
+ * Like `cap_parser_set_description_provider`, but supplies the description of
+ * the flag with the name or alias `name`, which may also be the help flag or
+ * the flag separator. If there is no such flag, the program exits with an
+ * error.
+ * 
+ * @param parser object to configure
+ * @param name name or alias of the flag
+ * @param provider function returning the description, or `NULL` to use the
+ *        description given when the flag was added
+ * @param context pointer passed to `provider`
+ */
+void cap_parser_set_flag_description_provider(
+        ArgumentParser * parser, const char * name,
+        DescriptionProvider provider, void * context) {
+    if (!parser) {
+        return;
+    }
+    FlagInfo * flag_info = _cap_parser_find_flag(parser, name);
+    if (!flag_info) {
+        fprintf(stderr, "cap: unknown flag %s\n", name ? name : "(null)");
+        exit(-1);
+    }
+    flag_info -> mDescriptionProvider = provider;
+    flag_info -> mDescriptionContext = context;
+    _cap_parser_forget_texts(parser);
+}
+
+/**
+ * Sets a function which supplies the description of a positional argument.
+ * 
+ * Like `cap_parser_set_description_provider`, but supplies the description of
+ * the positional argument `name`. If there is no such positional, the program
+ * exits with an error.
+ * 
+ * @param parser object to configure
+ * @param name name of the positional argument
+ * @param provider function returning the description, or `NULL` to use the
+ *        description given when the positional was added
+ * @param context pointer passed to `provider`
+ */
+void cap_parser_set_positional_description_provider(
+        ArgumentParser * parser, const char * name,
+        DescriptionProvider provider, void * context) {
+    if (!parser) {
+        return;
+    }
+    size_t id;
+    if (!cap_parser_get_positional_id(parser, name, &id)) {
+        fprintf(
+            stderr, "cap: unknown positional argument %s\n",
+            name ? name : "(null)");
+        exit(-1);
+    }
+    parser -> mPositionals[id] -> mDescriptionProvider = provider;
+    parser -> mPositionals[id] -> mDescriptionContext = context;
+    _cap_parser_forget_texts(parser);
+}
+
 // ============================================================================
 // === PARSER: ADDING FLAGS ===================================================
 // ============================================================================
@@ -922,14 +1705,13 @@ AddFlagError cap_parser_add_flag_noexit(
     int min_count, int max_count, const char * metavar,
     const char * description) 
 {
-    const char * const flag_prefix = parser -> mFlagPrefixChars;
     if (!parser) {
         return AFE_MISSING_PARSER;
     }
     if (!flag || !strlen(flag)) {
         return AFE_MISSING_NAME;
     }
-    if (!strchr(flag_prefix, *flag)) {
+    if (!parser -> mIsFlagPrefix[(unsigned char) *flag]) {
         return AFE_INVALID_PREFIX;
     }
     // this also checks agains the help flag and flag separator if they exist
@@ -949,12 +1731,15 @@ AddFlagError cap_parser_add_flag_noexit(
         size_t alloc_size = parser -> mFlagAlloc;
         alloc_size = alloc_size ? alloc_size * 2 : 1;
         parser -> mFlagAlloc = alloc_size;
-        parser -> mFlags = (FlagInfo **) realloc(
+        parser -> mFlags = (FlagInfo **) cap_realloc(
             parser -> mFlags, alloc_size * sizeof(FlagInfo *));
     }
     FlagInfo * new_flag = cap_flag_info_make(
-        flag, metavar, description, type, min_count, max_count);
+        flag, metavar, description, type, min_count, max_count,
+        parser -> mStaticStrings);
+    _cap_parser_index_flag(parser, new_flag, parser -> mFlagCount);
     parser -> mFlags[parser -> mFlagCount++] = new_flag;
+    _cap_parser_forget_texts(parser);
 
     return AFE_OK;
 }
@@ -1004,8 +1789,11 @@ AddFlagError cap_parser_add_flag_noexit(
  * @param meta_var display name of the flag's value in help messages
  * @param description short description of the flag's meaning to display in 
  *        automatically generated help messages.
+ * @return id of the new flag. Flags are numbered in the order in which they 
+ *         are added, starting at zero. The id can be used to access the flag 
+ *         in a `ParsedArguments` using e.g. `cap_pa_get_flag_by_id`.
  */
-void cap_parser_add_flag(
+size_t cap_parser_add_flag(
     ArgumentParser * parser, const char * flag, DataType type, 
     int min_count, int max_count, const char * meta_var,
     const char * description) 
@@ -1014,7 +1802,7 @@ void cap_parser_add_flag(
         parser, flag, type, min_count, max_count, meta_var, description);
     switch (error) {
         case AFE_OK:
-            return;
+            return parser -> mFlagCount - 1u;
         case AFE_MISSING_PARSER:
             fprintf(stderr, "cap: missing parser\n");
             break;
@@ -1076,7 +1864,7 @@ AddFlagAliasError cap_parser_add_flag_alias_noexit(
     if (!alias || !strlen(alias)) {
         return AFAE_MISSING_ALIAS;
     }
-    if (!strchr(parser -> mFlagPrefixChars, *alias)) {
+    if (!parser -> mIsFlagPrefix[(unsigned char) *alias]) {
         return AFAE_INVALID_PREFIX;
     }
     FlagInfo * fi = _cap_parser_find_flag(parser, name);
@@ -1086,13 +1874,14 @@ AddFlagAliasError cap_parser_add_flag_alias_noexit(
     if (_cap_parser_find_flag(parser, alias)) {
         return AFAE_DUPLICATE_ALIAS;
     }
+    size_t id;
+    cap_si_find(parser -> mFlagIndex, name, &id);
 
     // register the alias
-    if (fi -> mAliasCount >= fi -> mAliasAlloc) {
-        fi -> mAliasAlloc = fi -> mAliasAlloc ? 2 * fi -> mAliasAlloc : 1u;
-        fi -> mAliases = (char **) realloc(fi -> mAliases, fi -> mAliasAlloc * sizeof(char *));
-    }
-    fi -> mAliases[fi -> mAliasCount++] = copy_string(alias);
+    const char * alias_copy = cap_flag_info_add_alias(fi, alias);
+    cap_si_insert(parser -> mFlagIndex, alias_copy, id);
+    _cap_parser_insert_completion_name(parser, alias_copy);
+    _cap_parser_forget_texts(parser);
     return AFAE_OK;
 }
 
@@ -1172,12 +1961,14 @@ void cap_parser_set_help_flag(
     if (!parser) {
         return;
     }
+    _cap_parser_forget_texts(parser);
     if (parser -> mHelpFlagInfo) {
         // name is identical -> there's nothing to do
         if (name && !strcmp(name, parser -> mHelpFlagInfo -> mName)) {
             return;
         }
         // now we un-configure the existing help flag
+        _cap_parser_unindex_flag(parser, parser -> mHelpFlagInfo);
         cap_flag_info_destroy(parser -> mHelpFlagInfo);
         parser -> mHelpFlagInfo = NULL;
     }
@@ -1196,14 +1987,15 @@ void cap_parser_set_help_flag(
             " already exists\n", name);
         exit(-1);
     }
-    if (*name == '\0' || !strchr(parser -> mFlagPrefixChars, *name)) {
+    if (!parser -> mIsFlagPrefix[(unsigned char) *name]) {
         fprintf(stderr, "cap: invalid flag name '%s'\n", name);
         exit(-1);
     }
     FlagInfo * fi = cap_flag_info_make(
         name, NULL, description ? description : DEFAULT_HELP_DESCRIPTION,
-       	DT_PRESENCE, 0, 1);
+       	DT_PRESENCE, 0, 1, parser -> mStaticStrings);
     parser -> mHelpFlagInfo = fi;
+    _cap_parser_index_flag(parser, fi, _CAP_HELP_FLAG_ID);
 }
 
 // ============================================================================
@@ -1263,6 +2055,9 @@ AddPositionalError cap_parser_add_positional_noexit(
     if (type == DT_PRESENCE) {
         return APE_PRESENCE;
     }
+    if (parser -> mSubcommandCount) {
+        return APE_SUBCOMMANDS;
+    }
     for (size_t i = 0; i < parser -> mPositionalCount; ++i) {
         const PositionalInfo * pi = parser -> mPositionals[i];
         if (!strcmp(pi -> mName, name)) {
@@ -1283,12 +2078,14 @@ AddPositionalError cap_parser_add_positional_noexit(
         size_t alloc_size = parser -> mPositionalAlloc;
         alloc_size = alloc_size ? alloc_size * 2 : 1;
         parser -> mPositionalAlloc = alloc_size;
-        parser -> mPositionals = (PositionalInfo **) realloc(
+        parser -> mPositionals = (PositionalInfo **) cap_realloc(
             parser -> mPositionals, alloc_size * sizeof(PositionalInfo *));
     }
     PositionalInfo * new_positional = cap_positional_info_make(
-	name, metavar, description, type, required, variadic);
+	name, metavar, description, type, required, variadic,
+        parser -> mStaticStrings);
     parser -> mPositionals[parser -> mPositionalCount++] = new_positional;
+    _cap_parser_forget_texts(parser);
 
     return APE_OK;
 }
@@ -1331,8 +2128,12 @@ AddPositionalError cap_parser_add_positional_noexit(
  * @param metavar display name for this argument in help messages
  * @param description short description of the argument's meaning to display 
  *        in automatically generated help messages
+ * @return id of the new argument. Positionals are numbered in the order in 
+ *         which they are added, starting at zero. The id can be used to access
+ *         the argument in a `ParsedArguments` using e.g.
+ *         `cap_pa_get_positional_by_id`.
  */
-void cap_parser_add_positional(
+size_t cap_parser_add_positional(
     ArgumentParser * parser, const char * name, DataType type, 
     bool required, bool variadic, const char * metavar,
     const char * description)
@@ -1353,7 +2154,7 @@ void cap_parser_add_positional(
             fprintf(stderr, "cap: missing parser\n");
             break;
         case APE_OK:
-            return;
+            return parser -> mPositionalCount - 1u;
         case APE_PRESENCE:
             fprintf(
                 stderr, "cap: data type DT_PRESENCE is invalid for positional"
@@ -1364,6 +2165,11 @@ void cap_parser_add_positional(
                 stderr, "cap: cannot add required positional after"
                 " optional\n");
             break;
+        case APE_SUBCOMMANDS:
+            fprintf(
+                stderr, "cap: cannot add positional to a parser with"
+                " subcommands\n");
+            break;
         default:
             assert(false && "unreachable in cap_parser_add_positional");
     }
@@ -1371,45 +2177,367 @@ void cap_parser_add_positional(
 }
 
 // ============================================================================
-// === PARSER: HELP ===========================================================
+// === PARSER: ADDING SUBCOMMANDS =============================================
 // ============================================================================
 
 /**
- * Retrieves the program name for this parser.
+ * Configures a new subcommand.
  * 
- * Obtains the custom program name configured in `parser` or guesses the 
- * executable's name from `argv0` if not name has been configured. If `parser`
- * has no program name, the part of `argv0' after the right-most path separator
- * is used. On Windows, both '\' and '/' are considered path separators.
+ * Configures a subcommand `name` in `parser`, like the commands of `git`
+ * (e.g. `git commit -m text`). If a subcommand with the same name already
+ * exists, returns an appropriate error code. Subcommands and positional
+ * arguments exclude each other, so if `parser` has any positionals, an error
+ * code is returned as well. The name may not begin with a flag prefix
+ * character.
  * 
- * @param parser parser object to consult
- * @param argv0 first word on the command line
- * @return configured or estimated program name
+ * At parse-time, flags of `parser` may precede the subcommand. The first word
+ * which is not a flag must be the name of a subcommand, and the words after it
+ * are parsed by the parser of the subcommand. Its name and arguments are
+ * retrieved using `cap_pa_get_subcommand` and
+ * `cap_pa_get_subcommand_arguments`. If no subcommand is given, parsing fails
+ * with `PER_MISSING_SUBCOMMAND`.
+ * 
+ * The parser of the subcommand is not created now. It is built by `builder`
+ * when the subcommand is parsed, and destroyed together with the parsed
+ * arguments, unless `cap_parser_build_subcommands` built it beforehand, in
+ * which case `parser` keeps it for all parses. Subcommands are found by their names in constant time, so
+ * the cost of parsing does not grow with the number of configured
+ * subcommands, nor with the size of the parsers of the subcommands which are
+ * not given. The parser of a subcommand starts with the options of `parser`
+ * (static and borrowed strings, exact allocation, packed values, the thread
+ * count, and the completion mode),
+ * which `builder` may change.
+ * 
+ * @param parser object to configure
+ * @param name name of the subcommand
+ * @param builder function which configures the parser of the subcommand
+ * @param context pointer passed to `builder`, may be `NULL`
+ * @param description short description of the subcommand to display in
+ *        automatically generated help messages, may be `NULL`
+ * @return `ASE_OK` on success, or the reason why the subcommand was not added
  */
-const char * cap_parser_get_program_name(
-        const ArgumentParser * parser, const char * argv0) {
-    if (parser -> mProgramName) {
-        return parser -> mProgramName;
+AddSubcommandError cap_parser_add_subcommand_noexit(
+        ArgumentParser * parser, const char * name, SubparserBuilder builder,
+        void * context, const char * description) {
+    if (!parser) {
+        return ASE_MISSING_PARSER;
     }
-    const char * program_name = argv0;
-    const char * slash = strrchr(argv0, '/');
-    if (slash) {
-        program_name = slash + 1;
+    if (!name || !*name) {
+        return ASE_MISSING_NAME;
     }
-#ifdef _WIN32
-    const char * backslash = strrchr(argv0, '\\');
-    if (backslash && backslash > slash) {
-        program_name = backslash + 1;
+    if (!builder) {
+        return ASE_MISSING_BUILDER;
     }
-#endif
-    return program_name;
-}
-
-/**
+    if (parser -> mIsFlagPrefix[(unsigned char) *name]) {
+        return ASE_INVALID_PREFIX;
+    }
+    if (cap_si_find(parser -> mSubcommandIndex, name, NULL)) {
+        return ASE_DUPLICATE;
+    }
+    if (parser -> mPositionalCount) {
+        return ASE_POSITIONALS;
+    }
+    if (!parser -> mSubcommandIndex) {
+        parser -> mSubcommandIndex = cap_si_make_empty();
+    }
+    if (parser -> mSubcommandCount >= parser -> mSubcommandAlloc) {
+        size_t alloc_size = parser -> mSubcommandAlloc;
+        alloc_size = alloc_size ? alloc_size * 2 : 4;
+        parser -> mSubcommandAlloc = alloc_size;
+        parser -> mSubcommands = (_CapSubcommand *) cap_realloc(
+            parser -> mSubcommands, alloc_size * sizeof(_CapSubcommand));
+    }
+    _CapSubcommand * subcommand
+        = parser -> mSubcommands + parser -> mSubcommandCount;
+    const bool borrow = parser -> mStaticStrings;
+    *subcommand = (_CapSubcommand) {
+        .mName = borrow ? (char *) name : copy_string(name),
+        .mDescription = borrow
+            ? (char *) description : copy_string(description),
+        .mBuilder = builder,
+        .mContext = context,
+        .mParser = NULL,
+        .mStaticStrings = borrow
+    };
+    cap_si_insert(
+        parser -> mSubcommandIndex, subcommand -> mName,
+        parser -> mSubcommandCount++);
+    _cap_parser_insert_completion_name(parser, subcommand -> mName);
+    _cap_parser_forget_texts(parser);
+    return ASE_OK;
+}
+
+/**
+ * Configures a new subcommand.
+ * 
+ * Behaves like `cap_parser_add_subcommand_noexit`, except that the program
+ * exits with an error if the subcommand cannot be added.
+ * 
+ * ``` c
+ * static void make_commit(ArgumentParser * parser, void * context) {
+ *     cap_parser_add_flag(parser, "-m", DT_STRING, 1, 1, "TEXT", NULL);
+ * }
+ * 
+ * cap_parser_add_subcommand(
+ *     parser, "commit", make_commit, NULL, "Record changes");
+ * ```
+ * 
+ * @param parser object to configure
+ * @param name name of the subcommand
+ * @param builder function which configures the parser of the subcommand
+ * @param context pointer passed to `builder`, may be `NULL`
+ * @param description short description of the subcommand to display in
+ *        automatically generated help messages, may be `NULL`
+ * @return id of the new subcommand. Subcommands are numbered in the order in
+ *         which they are added, starting at zero.
+ */
+size_t cap_parser_add_subcommand(
+        ArgumentParser * parser, const char * name, SubparserBuilder builder,
+        void * context, const char * description) {
+    AddSubcommandError error = cap_parser_add_subcommand_noexit(
+        parser, name, builder, context, description);
+    switch (error) {
+        case ASE_OK:
+            return parser -> mSubcommandCount - 1u;
+        case ASE_MISSING_PARSER:
+            fprintf(stderr, "cap: missing parser\n");
+            break;
+        case ASE_MISSING_NAME:
+            fprintf(stderr, "cap: missing subcommand name\n");
+            break;
+        case ASE_MISSING_BUILDER:
+            fprintf(stderr, "cap: missing builder of subcommand %s\n", name);
+            break;
+        case ASE_INVALID_PREFIX:
+            fprintf(
+                stderr, "cap: subcommand %s begins with a flag prefix\n",
+                name);
+            break;
+        case ASE_DUPLICATE:
+            fprintf(stderr, "cap: duplicate subcommand %s\n", name);
+            break;
+        case ASE_POSITIONALS:
+            fprintf(
+                stderr, "cap: cannot add subcommand to a parser with"
+                " positional arguments\n");
+            break;
+        default:
+            assert(false && "unreachable in cap_parser_add_subcommand");
+    }
+    exit(-1);
+}
+
+/**
+ * Builds the parsers of all subcommands.
+ * 
+ * Runs the builders of all subcommands of `parser` which were not built yet,
+ * and of their subcommands, recursively. `parser` keeps the built parsers
+ * until it is destroyed and uses them for all later parses.
+ * 
+ * Without this call, the parser of a subcommand is built whenever the
+ * subcommand is parsed (or completed, see `cap_parser_complete`), and is
+ * destroyed together with the parsed arguments. That is cheapest for programs
+ * which parse once. A parser which parses many command lines should build its
+ * subcommands once using this function, after it is configured. Parsing never
+ * changes a parser, so building them beforehand is not needed for parsing
+ * from several threads.
+ * 
+ * @param parser parser whose subcommands to build. If it is `NULL`, this
+ *        function does nothing.
+ */
+void cap_parser_build_subcommands(ArgumentParser * parser) {
+    if (!parser) {
+        return;
+    }
+    for (size_t i = 0u; i < parser -> mSubcommandCount; ++i) {
+        _CapSubcommand * subcommand = parser -> mSubcommands + i;
+        if (!subcommand -> mParser) {
+            subcommand -> mParser = _cap_parser_build_subparser(parser, i);
+        }
+        cap_parser_build_subcommands(subcommand -> mParser);
+    }
+}
+
+// ============================================================================
+// === PARSER: IDS OF FLAGS AND POSITIONALS ===================================
+// ============================================================================
+
+/**
+ * Finds the id of a flag.
+ * 
+ * Looks up a configured flag by its name or any of its aliases and stores its 
+ * id into `*id`. This is the same id that was returned by 
+ * `cap_parser_add_flag`. The help flag and the flag separator have no ids.
+ * 
+ * @param parser object to search
+ * @param name name or alias of the flag
+ * @param id output parameter for the id of the flag
+ * @return `true` if the flag was found
+ */
+bool cap_parser_get_flag_id(
+    const ArgumentParser * parser, const char * name, size_t * id)
+{
+    size_t found;
+    if (!parser || !_cap_parser_find_flag_id(parser, name, &found)) {
+        return false;
+    }
+    if (found == _CAP_HELP_FLAG_ID || found == _CAP_FLAG_SEPARATOR_ID) {
+        return false;
+    }
+    if (id) {
+        *id = found;
+    }
+    return true;
+}
+
+/**
+ * Finds the id of a positional argument.
+ * 
+ * Looks up a configured positional argument by its name and stores its id 
+ * into `*id`. This is the same id that was returned by 
+ * `cap_parser_add_positional`.
+ * 
+ * @param parser object to search
+ * @param name name of the positional argument
+ * @param id output parameter for the id of the argument
+ * @return `true` if the argument was found
+ */
+bool cap_parser_get_positional_id(
+    const ArgumentParser * parser, const char * name, size_t * id)
+{
+    if (!parser || !name) {
+        return false;
+    }
+    for (size_t i = 0; i < parser -> mPositionalCount; ++i) {
+        if (!strcmp(parser -> mPositionals[i] -> mName, name)) {
+            if (id) {
+                *id = i;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================================================
+// === PARSER: HELP ===========================================================
+// ============================================================================
+
+/**
+ * Retrieves the program name for this parser.
+ * 
+ * Obtains the custom program name configured in `parser` or guesses the 
+ * executable's name from `argv0` if not name has been configured. If `parser`
+ * has no program name, the part of `argv0' after the right-most path separator
+ * is used. On Windows, both '\' and '/' are considered path separators.
+ * 
+ * @param parser parser object to consult
+ * @param argv0 first word on the command line
+ * @return configured or estimated program name
+ */
+const char * cap_parser_get_program_name(
+        const ArgumentParser * parser, const char * argv0) {
+    if (parser -> mProgramName) {
+        return parser -> mProgramName;
+    }
+    const char * program_name = argv0;
+    const char * slash = strrchr(argv0, '/');
+    if (slash) {
+        program_name = slash + 1;
+    }
+#ifdef _WIN32
+    const char * backslash = strrchr(argv0, '\\');
+    if (backslash && backslash > slash) {
+        program_name = backslash + 1;
+    }
+#endif
+    return program_name;
+}
+
+/**
+ * Prepares the help message and the usage string.
+ *
+ * Renders the messages which `cap_parser_print_help` and
+ * `cap_parser_print_usage` print, and keeps them in `parser` until its
+ * configuration changes, so that printing or formatting them later only
+ * copies them. Without this call, they are rendered for each print. A help
+ * message which uses description providers (see
+ * `cap_parser_set_description_provider`) is not kept, so that the providers
+ * are called for each print.
+ *
+ * Printing never changes a parser, this is the only function which fills the
+ * kept messages.
+ *
+ * @param parser parser whose messages to prepare. If it is `NULL`, this
+ *        function does nothing.
+ */
+void cap_parser_prepare_help(ArgumentParser * parser) {
+    if (!parser) {
+        return;
+    }
+    _cap_parser_forget_texts(parser);
+    // an empty message is still rendered, so that it is not `NULL`
+    _cap_parser_render_usage(parser, &(parser -> mUsageText));
+    cap_text_append(&(parser -> mUsageText), "", 0u);
+    if (!_cap_parser_has_providers(parser)) {
+        _cap_parser_render_help(parser, &(parser -> mHelpText));
+        cap_text_append(&(parser -> mHelpText), "", 0u);
+    }
+}
+
+/**
+ * Formats a usage string.
+ *
+ * Writes the usage string which `cap_parser_print_usage` prints into `buffer`,
+ * like `snprintf` does: at most `size - 1` characters are written, followed
+ * by a terminating null character. The string is rendered from the
+ * configuration for each call, unless `cap_parser_prepare_help` prepared it.
+ *
+ * @param parser parser to generate or extract the usage string from
+ * @param argv0 the first command line word, see
+ *        `cap_parser_get_program_name`
+ * @param buffer write the string here, may be `NULL` if `size` is zero
+ * @param size size of `buffer`
+ * @return length of the whole usage string, without the terminating null
+ *         character. If it is at least `size`, the string was truncated.
+ *         If `parser` is `NULL` or usage is disabled, zero is returned.
+ *
+ * @see cap_parser_print_usage
+ */
+size_t cap_parser_format_usage(
+        const ArgumentParser * parser, const char * argv0, char * buffer,
+        size_t size) {
+    size_t length = 0u;
+    if (parser && parser -> mEnableUsage && parser -> mCustomUsage) {
+        length = _cap_copy_text(
+            buffer, size, length, parser -> mCustomUsage,
+            strlen(parser -> mCustomUsage));
+        length = _cap_copy_text(buffer, size, length, "\n", 1u);
+    }
+    else if (parser && parser -> mEnableUsage) {
+        const char * program = cap_parser_get_program_name(parser, argv0);
+        TextBuffer rendered = { NULL, 0u, 0u };
+        const TextBuffer * text = _cap_parser_get_text(
+            parser, false, &rendered);
+        length = _cap_copy_text(buffer, size, length, "usage:\n\t", 8u);
+        length = _cap_copy_text(
+            buffer, size, length, program, strlen(program));
+        length = _cap_copy_text(
+            buffer, size, length, text -> mData, text -> mLength);
+        cap_free(rendered.mData);
+    }
+    if (size) {
+        buffer[length < size ? length : size - 1u] = '\0';
+    }
+    return length;
+}
+
+/**
  * Prints a usage string.
  * 
  * Prints a usage string to `file` based on the flags and arguments configured
  * in `parser`. If a flag has aliases, the shortest available name is picked.
+ * The string is written using a single call, see `cap_parser_format_usage`.
  */
 void cap_parser_print_usage(
         const ArgumentParser * parser, FILE * file,
@@ -1425,51 +2553,54 @@ void cap_parser_print_usage(
         fprintf(file, "%s\n", parser -> mCustomUsage);
         return;
     }
+    TextBuffer rendered = { NULL, 0u, 0u };
+    const TextBuffer * text = _cap_parser_get_text(parser, false, &rendered);
+    fprintf(
+        file, "usage:\n\t%s%s", cap_parser_get_program_name(parser, argv0),
+        text -> mData);
+    cap_free(rendered.mData);
+}
 
-    fprintf(file, "usage:\n");
-    fprintf(file, "\t");
-    fprintf(file, "%s", cap_parser_get_program_name(parser, argv0));
-
-    if (parser -> mHelpFlagInfo) {
-        fprintf(file, " [%s]", _cap_get_shortest_flag_name(parser -> mHelpFlagInfo));
-    }
-
-    for (size_t i = 0; i < parser -> mFlagCount; ++i) {
-        const FlagInfo * fi = parser -> mFlags[i];
-        fputc(' ', file);
-        if (fi -> mMinCount == 0) {
-            fputc('[', file);
-        }
-        fprintf(file, "%s", _cap_get_shortest_flag_name(fi));
-        if (fi -> mType != DT_PRESENCE) {
-            fprintf(file, " %s", cap_get_flag_metavar(fi));
-        }
-        if (fi -> mMinCount == 0) {
-            fputc(']', file);
-        }
-    }
-
-    if (parser -> mPositionalCount > 0u && parser -> mFlagSeparatorInfo) {
-        fprintf(file, " [%s]", _cap_get_shortest_flag_name(parser -> mFlagSeparatorInfo));
+/**
+ * Formats a help message.
+ *
+ * Writes the help message which `cap_parser_print_help` prints into `buffer`,
+ * like `snprintf` does: at most `size - 1` characters are written, followed
+ * by a terminating null character. Unless a custom help message is set, the
+ * message is rendered from the configuration for each call, unless
+ * `cap_parser_prepare_help` prepared it. Description providers are therefore
+ * called for each call.
+ *
+ * @param parser parser to generate or extract the help message from
+ * @param buffer write the message here, may be `NULL` if `size` is zero
+ * @param size size of `buffer`
+ * @return length of the whole help message, without the terminating null
+ *         character. If it is at least `size`, the message was truncated.
+ *         If `parser` is `NULL` or help is disabled, zero is returned.
+ *
+ * @see cap_parser_print_help
+ */
+size_t cap_parser_format_help(
+        const ArgumentParser * parser, char * buffer, size_t size) {
+    size_t length = 0u;
+    if (parser && parser -> mEnableHelp && parser -> mCustomHelp) {
+        length = _cap_copy_text(
+            buffer, size, length, parser -> mCustomHelp,
+            strlen(parser -> mCustomHelp));
+        length = _cap_copy_text(buffer, size, length, "\n", 1u);
     }
-    size_t optionals = 0u;
-    for (size_t i = 0; i < parser -> mPositionalCount; ++i) {
-        const PositionalInfo * pi = parser -> mPositionals[i];
-        fputc(' ', file);
-        if (!pi -> mRequired) {
-            fputc('[', file);
-            ++optionals;
-        }
-        if (pi -> mMetaVar) {
-            fprintf(file, "%s", pi -> mMetaVar);
-            continue;
-        }
-        fprintf(file, "<%s>", pi -> mName);
+    else if (parser && parser -> mEnableHelp) {
+        TextBuffer rendered = { NULL, 0u, 0u };
+        const TextBuffer * text = _cap_parser_get_text(
+            parser, true, &rendered);
+        length = _cap_copy_text(
+            buffer, size, length, text -> mData, text -> mLength);
+        cap_free(rendered.mData);
     }
-    for (size_t i = 0; i < optionals; ++i) {
-        fputc(']', file);
+    if (size) {
+        buffer[length < size ? length : size - 1u] = '\0';
     }
-    fputc('\n', file);
+    return length;
 }
 
 /**
@@ -1477,7 +2608,8 @@ void cap_parser_print_usage(
  * 
  * Prints a help message to `file`. This message is either set explicitly using
  * `cap_parser_set_custom_help`, or generated based on flag/argument 
- * configuration of `parser`.
+ * configuration of `parser`. The message is written using a single call, see
+ * `cap_parser_format_help`.
  * 
  * @param parser parser to generate or extract the help message from
  * @param file write the message here
@@ -1499,34 +2631,208 @@ void cap_parser_print_help(const ArgumentParser * parser, FILE* file) {
         fprintf(file, "%s\n", parser -> mCustomHelp);
         return;
     }
-    if (parser -> mDescription) {
-        fprintf(file, "%s\n", parser -> mDescription);
+    TextBuffer rendered = { NULL, 0u, 0u };
+    const TextBuffer * text = _cap_parser_get_text(parser, true, &rendered);
+    fwrite(text -> mData, 1u, text -> mLength, file);
+    cap_free(rendered.mData);
+}
+
+// ============================================================================
+// === PARSER: SHELL COMPLETION ===============================================
+// ============================================================================
+
+/**
+ * Completes a command line word.
+ *
+ * Prints the names of flags, their aliases, and subcommands which begin with
+ * the word `argv[index]`, one per line. The words before it decide which
+ * parser completes it: a subcommand switches to the parser of the
+ * subcommand. Nothing is printed for a value of a flag, for words after the
+ * flag separator, and for positionals, so the shell can complete them as file
+ * names. If the word is empty, only the subcommands are printed.
+ *
+ * Names are looked up by their prefix in a sorted array, which the parser
+ * keeps while its completion mode is enabled (see
+ * `cap_parser_enable_completion`), otherwise they are sorted for each call.
+ * The candidates are
+ * written using a single call.
+ *
+ * @param parser parser to complete a word of
+ * @param argc number of words on the command line, including the program
+ *        name
+ * @param argv the words on the command line
+ * @param index position of the completed word in `argv`. If it is `argc`,
+ *        an empty word is completed.
+ * @param file write the candidates here
+ * @return number of printed candidates
+ *
+ * @see cap_parser_enable_completion
+ */
+size_t cap_parser_complete(
+        const ArgumentParser * parser, int argc, const char ** argv,
+        size_t index, FILE * file) {
+    if (!parser || !argv || !file || argc < 1 || index < 1u
+            || index > (size_t) argc) {
+        return 0u;
+    }
+    const ArgumentParser * current = parser;
+    // parser of the current subcommand, if it is built just for this call
+    ArgumentParser * built = NULL;
+    bool positional_only = false;
+    for (size_t i = 1u; i < index; ++i) {
+        const char * word = argv[i];
+        if (!positional_only
+                && current -> mIsFlagPrefix[(unsigned char) *word]) {
+            const FlagInfo * flag = _cap_parser_find_flag(current, word);
+            if (flag && flag == current -> mFlagSeparatorInfo) {
+                positional_only = true;
+            }
+            else if (flag && flag -> mType != DT_PRESENCE && ++i == index) {
+                // the completed word is the value of the flag
+                cap_parser_destroy(built);
+                return 0u;
+            }
+            continue;
+        }
+        if (current -> mSubcommandCount) {
+            size_t id;
+            if (!cap_si_find(current -> mSubcommandIndex, word, &id)) {
+                cap_parser_destroy(built);
+                return 0u;
+            }
+            ArgumentParser * previous = built;
+            current = _cap_parser_get_subparser(current, id, &built);
+            cap_parser_destroy(previous);
+            positional_only = false;
+        }
     }
-    if (parser -> mFlagCount || parser -> mHelpFlagInfo || parser -> mFlagSeparatorInfo) {
-        fprintf(file, "\nAvailable flags:\n");
+    if (positional_only) {
+        cap_parser_destroy(built);
+        return 0u;
     }
-    if (parser -> mHelpFlagInfo) {
-        cap_print_flag_info(file, parser -> mHelpFlagInfo);
+
+    const char * prefix = index < (size_t) argc ? argv[index] : "";
+    TextBuffer text = { NULL, 0u, 0u };
+    size_t count = 0u;
+    if (!*prefix) {
+        for (size_t i = 0u; i < current -> mSubcommandCount; ++i) {
+            cap_text_append_string(&text, current -> mSubcommands[i].mName);
+            cap_text_append_char(&text, '\n');
+            ++count;
+        }
     }
-    if (parser -> mFlagSeparatorInfo) {
-        cap_print_flag_info(file, parser -> mFlagSeparatorInfo);
+    else {
+        // a parser whose completion mode is disabled keeps no sorted names
+        size_t name_count = current -> mCompletionNameCount;
+        const char ** sorted = current -> mEnableCompletion
+            ? NULL : _cap_parser_sort_names(current, &name_count);
+        const char * const * names = current -> mEnableCompletion
+            ? current -> mCompletionNames : sorted;
+        // the names beginning with `prefix` follow the first name which is
+        // not less than it
+        size_t low = 0u;
+        size_t high = name_count;
+        while (low < high) {
+            const size_t middle = low + (high - low) / 2u;
+            if (strcmp(names[middle], prefix) < 0) {
+                low = middle + 1u;
+            }
+            else {
+                high = middle;
+            }
+        }
+        const size_t length = strlen(prefix);
+        for (size_t i = low;
+                i < name_count && !strncmp(names[i], prefix, length); ++i) {
+            cap_text_append_string(&text, names[i]);
+            cap_text_append_char(&text, '\n');
+            ++count;
+        }
+        cap_free(sorted);
     }
-    for (size_t i = 0; i < parser -> mFlagCount; ++i) {
-        const FlagInfo * fi = parser -> mFlags[i];
-        cap_print_flag_info(file, fi);
+    if (text.mLength) {
+        fwrite(text.mData, 1u, text.mLength, file);
     }
+    cap_free(text.mData);
+    cap_parser_destroy(built);
+    return count;
+}
 
-    if (parser -> mPositionalCount) {
-        fprintf(file, "\nPositional Arguments:\n");
+/**
+ * Prints a shell completion script.
+ *
+ * Prints a script which makes `shell` complete the command line words of the
+ * program by running it as `PROGRAM --cap-complete INDEX WORDS...`, see
+ * `cap_parser_enable_completion`. When the program prints no candidates,
+ * the shell completes file names instead. Bash and zsh run the script when
+ * it is sourced, fish loads it from its `completions` directory.
+ *
+ * @param parser parser of the program
+ * @param shell shell which runs the script
+ * @param argv0 the first command line word, see
+ *        `cap_parser_get_program_name`
+ * @param file write the script here
+ */
+void cap_parser_print_completion_script(
+        const ArgumentParser * parser, CompletionShell shell,
+        const char * argv0, FILE * file) {
+    if (!parser || !file) {
+        return;
     }
-    for (size_t i = 0; i < parser -> mPositionalCount; ++i) {
-        const PositionalInfo * pi = parser -> mPositionals[i];
-	cap_print_positional_info(file, pi);
+    const char * program = cap_parser_get_program_name(parser, argv0);
+    // names of shell functions may only contain some characters
+    TextBuffer function = { NULL, 0u, 0u };
+    cap_text_append_string(&function, "_cap_complete_");
+    for (const char * c = program; *c; ++c) {
+        const bool valid = (*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z')
+            || (*c >= '0' && *c <= '9');
+        cap_text_append_char(&function, valid ? *c : '_');
     }
-
-    if (parser -> mEpilogue) {
-        fprintf(file, "\n%s\n", parser -> mEpilogue);
+    const char * name = function.mData;
+    switch (shell) {
+        case CS_BASH:
+            fprintf(
+                file,
+                "%s() {\n"
+                "    local IFS=$'\\n'\n"
+                "    COMPREPLY=($(\"${COMP_WORDS[0]}\" --cap-complete"
+                " \"$COMP_CWORD\" \"${COMP_WORDS[@]}\" 2>/dev/null))\n"
+                "}\n"
+                "complete -o default -F %s '%s'\n",
+                name, name, program);
+            break;
+        case CS_ZSH:
+            fprintf(
+                file,
+                "#compdef %s\n"
+                "%s() {\n"
+                "    local -a candidates\n"
+                "    candidates=(${(f)\"$(\"${words[1]}\" --cap-complete"
+                " $((CURRENT - 1)) \"${words[@]}\" 2>/dev/null)\"})\n"
+                "    if (( ${#candidates} )); then\n"
+                "        compadd -a candidates\n"
+                "    else\n"
+                "        _files\n"
+                "    fi\n"
+                "}\n"
+                "compdef %s '%s'\n",
+                program, name, name, program);
+            break;
+        case CS_FISH:
+            fprintf(
+                file,
+                "function %s\n"
+                "    set -l words (commandline -opc)\n"
+                "    $words[1] --cap-complete (count $words) $words"
+                " (commandline -ct) 2>/dev/null\n"
+                "end\n"
+                "complete -c '%s' -a '(%s)'\n",
+                name, program, name);
+            break;
+        default:
+            break;
     }
+    cap_free(function.mData);
 }
 
 // ============================================================================
@@ -1541,6 +2847,11 @@ void cap_parser_print_help(const ArgumentParser * parser, FILE* file) {
  * function should not be called directly by the user, `cap_parser_parse`
  * should be used instead.
  * 
+ * If the error is reported by the parser of a subcommand which was not built
+ * using `cap_parser_build_subcommands`, that parser is destroyed together with
+ * the parsed arguments, so an error word which would name one of its flags or
+ * positionals is `NULL`.
+ * 
  * @param parser parser object to use
  * @param argc number of command line arguments
  * @param argv array of command line arguments
@@ -1548,30 +2859,63 @@ void cap_parser_print_help(const ArgumentParser * parser, FILE* file) {
  *         successful.
  */
 ParsingResult cap_parser_parse_noexit(
-        ArgumentParser * parser, int argc, const char ** argv) {
-    ParsedArguments * parsed_arguments = cap_pa_make_empty();
-    ParsingResult result = (ParsingResult) {
-        .mArguments = parsed_arguments,
-        .mFirstErrorWord = NULL,
-        .mSecondErrorWord = NULL,
-        .mError = PER_NO_ERROR
-    };
+        const ArgumentParser * parser, int argc, const char ** argv) {
+    return _cap_parser_parse_noexit(parser, argc, argv);
+}
 
-    _cap_parser_parse_flags_and_positionals(parser, argc, argv, &result);   
+/**
+ * Parses command line arguments into an existing `ParsedArguments`.
+ * 
+ * Behaves like `cap_parser_parse_noexit`, but instead of creating a new 
+ * `ParsedArguments`, the result is stored into `args`, which is emptied first
+ * using `cap_pa_reset`. Memory owned by `args` is reused, so in a long-lived
+ * process parsing similar command lines repeatedly, this does not allocate any
+ * memory once `args` has grown large enough.
+ * 
+ * `args` may be created using `cap_pa_make_empty` or returned by an earlier 
+ * parse. It remains owned by the caller, also when an error occurs. In that
+ * case its contents are unspecified, but it can still be reused or destroyed.
+ * Response files read by the parse are owned by `args` as well, so error words
+ * taken from them stay valid until `args` is reset or destroyed.
+ * 
+ * @param parser parser object to use
+ * @param args object to store the result into
+ * @param argc number of command line arguments
+ * @param argv array of command line arguments
+ * @return result of the parsing. If parsing was successful, the result 
+ *         contains `args`.
+ */
+ParsingResult cap_parser_parse_into_noexit(
+        const ArgumentParser * parser, ParsedArguments * args, int argc,
+        const char ** argv) {
+    const size_t flag_count = parser -> mFlagCount;
+    _cap_pa_reset_reserved(args, flag_count, parser -> mPositionalCount);
+    _cap_pa_enable_packing(args, parser -> mPackValues);
+    ResponseFile * files;
+    size_t file_count;
+    ParsingResult result = _cap_parser_open_response_files(
+        parser, argc, argv, &files, &file_count);
     if (result.mError != PER_NO_ERROR) {
-	goto fail;
+        return result;
     }
-    
-    _cap_parser_check_flag_and_positional_counts(parser, &result);
+    _cap_pa_adopt_response_files(args, files, file_count);
+    const _CapWords words = _cap_words_make(argc, argv, files, file_count);
+    if (parser -> mExactAllocation) {
+        // the counts live in the arena until the next reset, so that the
+        // first pass does not allocate either
+        const size_t count = flag_count + parser -> mPositionalCount + 1u;
+        size_t * counts = (size_t *) cap_arena_alloc(
+            args -> mArena, count * sizeof(size_t));
+        memset(counts, 0, count * sizeof(size_t));
+        _cap_parser_count_values(
+            parser, words, counts, counts + flag_count);
+        _cap_parser_count_to_size(parser, counts, counts + flag_count);
+        _cap_pa_reserve_values(args, counts, counts + flag_count);
+    }
+    result = _cap_parser_parse_into(parser, args, words);
     if (result.mError != PER_NO_ERROR) {
-	goto fail;
+        result.mArguments = NULL;
     }
-
-    return result;
-
-fail:
-    cap_pa_destroy(parsed_arguments);
-    result.mArguments = NULL;
     return result;
 }
 
@@ -1594,18 +2938,204 @@ fail:
  *         parsed flags and positional arguments.
  */
 ParsedArguments * cap_parser_parse(
-        ArgumentParser * parser, int argc, const char ** argv) {
-    ParsingResult result = cap_parser_parse_noexit(parser, argc, argv);
+        const ArgumentParser * parser, int argc, const char ** argv) {
+    _cap_parser_check_completion(parser, argc, argv);
+    // error words may point into response files, which are released only
+    // after the error message is printed
+    ParsingResult result = _cap_parser_parse_all(parser, argc, argv);
+    return _cap_parser_finish_parsing(parser, result, argv);
+}
+
+/**
+ * Parses a command string without exiting when an error is encountered.
+ *
+ * Splits the `length` characters at `buffer` into words and parses them like
+ * `cap_parser_parse_noexit` parses command line words. This suits programs
+ * which receive commands as text, e.g. `resize --pool a --size 10` read from
+ * a socket. Unlike `argv`, the string does not start with a program name, its
+ * first word is already an argument.
+ *
+ * Words are delimited by whitespace, and quotes and backslashes are applied
+ * the same way as in response files (see @ref response_file), similar to
+ * a POSIX shell. No variables, globs, or other expansions are performed, and
+ * words `@path` are not replaced by response files.
+ *
+ * The string is split in place: quotes and backslashes are removed and each
+ * word is terminated by a null character, so that the parser reads the words
+ * straight from `buffer`, without allocating memory for them. `buffer` must
+ * therefore be writable and hold `length + 1` characters (e.g. a
+ * null-terminated string of length `length`); its contents are unspecified
+ * afterwards. Error words, and string values if borrowed strings are enabled
+ * (see `cap_parser_enable_borrowed_strings`), point into `buffer`.
+ *
+ * The command ends at the first null character if there is one among the
+ * `length` characters. If a quote is not closed, parsing fails with
+ * `PER_UNTERMINATED_QUOTE`.
+ *
+ * @param parser parser object to use
+ * @param buffer characters of the command, followed by one more writable
+ *        character
+ * @param length number of characters of the command
+ * @return result of the parsing, containing a `ParsedArguments` if parsing was
+ *         successful.
+ */
+ParsingResult cap_parser_parse_string_noexit(
+        const ArgumentParser * parser, char * buffer, size_t length) {
+    ParsingResult result = _cap_parser_parse_string(parser, buffer, length);
+    if (result.mError != PER_NO_ERROR) {
+        _cap_parser_detach_error_words(&result);
+        cap_pa_destroy(result.mArguments);
+        result.mArguments = NULL;
+    }
+    return result;
+}
+
+/**
+ * Parses a command string.
+ *
+ * Behaves like `cap_parser_parse_string_noexit`, except that when an error
+ * occurs, the program exits with an error message, or prints help and exits
+ * if the help flag is given, exactly like `cap_parser_parse`. Messages use the
+ * program name configured using `cap_parser_set_program_name`, or "command"
+ * if there is none, since a command string has no program name.
+ *
+ * @param parser parser object to use
+ * @param buffer characters of the command, followed by one more writable
+ *        character
+ * @param length number of characters of the command
+ * @return pointer to a new `ParsedArguments` object containing information on
+ *         parsed flags and positional arguments.
+ */
+ParsedArguments * cap_parser_parse_string(
+        const ArgumentParser * parser, char * buffer, size_t length) {
+    ParsingResult result = _cap_parser_parse_string(parser, buffer, length);
+    // the configured program name takes precedence over this one
+    const char * argv[1] = { _CAP_STRING_PROGRAM_NAME };
+    return _cap_parser_finish_parsing(parser, result, argv);
+}
+
+// ============================================================================
+// === PARSER: IMPLEMENTATION OF PRIVATE FUNCTIONS ============================
+// ============================================================================
+
+static ParsingResult _cap_parser_parse_noexit(
+        const ArgumentParser * parser, int argc, const char ** argv) {
+    ParsingResult result = _cap_parser_parse_all(parser, argc, argv);
+    if (result.mError != PER_NO_ERROR) {
+        _cap_parser_detach_error_words(&result);
+        cap_pa_destroy(result.mArguments);
+        result.mArguments = NULL;
+    }
+    return result;
+}
+
+static ParsingResult _cap_parser_parse_all(
+        const ArgumentParser * parser, int argc, const char ** argv) {
+    // parses into a new ParsedArguments, which is kept (in `mArguments`) also
+    // when an error occurs after the response files are opened
+    ResponseFile * files;
+    size_t file_count;
+    ParsingResult result = _cap_parser_open_response_files(
+        parser, argc, argv, &files, &file_count);
+    if (result.mError != PER_NO_ERROR) {
+        return result;
+    }
+    const _CapWords words = _cap_words_make(argc, argv, files, file_count);
+    ParsedArguments * parsed_arguments = _cap_parser_make_arguments(
+        parser, words);
+    _cap_pa_adopt_response_files(parsed_arguments, files, file_count);
+    return _cap_parser_parse_into(parser, parsed_arguments, words);
+}
+
+static ParsingResult _cap_parser_parse_string(
+        const ArgumentParser * parser, char * buffer, size_t length) {
+    // splits the command string in place, and parses its words like the
+    // words of a response file which makes up the whole command line
+    // the command ends at its first null character
+    char * words_end = buffer;
+    const char * null_char;
+    if (!_cap_rf_split_quoted(buffer, length, &words_end, &null_char)) {
+        return (ParsingResult) {
+            .mArguments = NULL,
+            .mFirstErrorWord = NULL,
+            .mSecondErrorWord = NULL,
+            .mError = PER_UNTERMINATED_QUOTE
+        };
+    }
+    const _CapWords words = (_CapWords) {
+        .mArgv = NULL,
+        .mArgc = 0,
+        .mIndex = 0,
+        .mFiles = NULL,
+        .mFileCount = 0u,
+        .mWord = buffer < words_end ? buffer : NULL,
+        .mFileEnd = buffer < words_end ? words_end : NULL
+    };
+    ParsedArguments * parsed_arguments = _cap_parser_make_arguments(
+        parser, words);
+    return _cap_parser_parse_into(parser, parsed_arguments, words);
+}
+
+static ParsingResult _cap_parser_parse_into(
+        const ArgumentParser * parser, ParsedArguments * args,
+        _CapWords words) {
+    ParsingResult result = (ParsingResult) {
+        .mArguments = args,
+        .mFirstErrorWord = NULL,
+        .mSecondErrorWord = NULL,
+        .mError = PER_NO_ERROR
+    };
+
+    _cap_parser_parse_flags_and_positionals(parser, words, &result);   
+    if (result.mError != PER_NO_ERROR) {
+	return result;
+    }
+    _cap_parser_parse_input(parser, &result);
+    if (result.mError != PER_NO_ERROR) {
+        return result;
+    }
+    
+    _cap_parser_check_flag_and_positional_counts(parser, &result);
+    return result;
+}
+
+static ParsedArguments * _cap_parser_finish_parsing(
+        const ArgumentParser * parser, ParsingResult result,
+        const char ** argv) {
     if (result.mError == PER_NO_ERROR) {
         return result.mArguments;
     }
+    // an error after a subcommand is reported by the parser of the (innermost)
+    // subcommand, named by the program name and the subcommands, e.g.
+    // "git commit"
+    const char * program = *argv;
+    char * subcommand_program = NULL;
+    for (const ParsedArguments * args = result.mArguments;
+            args && args -> mSubcommand;
+            args = args -> mSubcommandArguments) {
+        size_t id;
+        cap_si_find(parser -> mSubcommandIndex, args -> mSubcommand, &id);
+        const char * name = cap_parser_get_program_name(parser, program);
+        const size_t length = strlen(name);
+        const size_t size = length + strlen(args -> mSubcommand) + 2u;
+        char * joined = (char *) cap_malloc(size);
+        snprintf(joined, size, "%s %s", name, args -> mSubcommand);
+        cap_free(subcommand_program);
+        program = subcommand_program = joined;
+        // the parser of the subcommand lives as long as `result.mArguments`
+        parser = args -> mSubparser
+            ? (const ArgumentParser *) args -> mSubparser
+            : parser -> mSubcommands[id].mParser;
+    }
     if (result.mError == PER_HELP) {
-        cap_parser_print_usage(parser, stdout, *argv);
+        cap_parser_print_usage(parser, stdout, program);
         putchar('\n');
         cap_parser_print_help(parser, stdout);
+        cap_free(subcommand_program);
+        cap_pa_destroy(result.mArguments);
         exit(0);
     }
-    fprintf(stderr, "%s: ", cap_parser_get_program_name(parser, *argv));
+    fprintf(stderr, "%s: ", cap_parser_get_program_name(parser, program));
     switch (result.mError) {
         case PER_NOT_ENOUGH_POSITIONALS:
             fprintf(stderr, "not enough arguments");
@@ -1640,119 +3170,563 @@ ParsedArguments * cap_parser_parse(
                 stderr, "too many instances of flag '%s'", 
 		result.mFirstErrorWord);
             break;
+        case PER_POSITIONAL_OUT_OF_RANGE:
+            fprintf(
+                stderr, "value '%s' for argument '%s' is out of range",
+	       	result.mSecondErrorWord, result.mFirstErrorWord);
+            break;
+        case PER_FLAG_OUT_OF_RANGE:
+            fprintf(
+                stderr, "value '%s' for flag '%s' is out of range",
+	       	result.mSecondErrorWord, result.mFirstErrorWord);
+            break;
+        case PER_CANNOT_READ_RESPONSE_FILE:
+            fprintf(
+                stderr, "cannot read response file '%s'",
+                result.mFirstErrorWord);
+            break;
+        case PER_INVALID_RESPONSE_FILE:
+            fprintf(
+                stderr, "unterminated quote in response file '%s'",
+                result.mFirstErrorWord);
+            break;
+        case PER_CANNOT_READ_INPUT:
+            fprintf(
+                stderr, "cannot read values of argument '%s'",
+                result.mFirstErrorWord);
+            break;
+        case PER_UNTERMINATED_QUOTE:
+            fprintf(stderr, "unterminated quote");
+            break;
+        case PER_UNKNOWN_SUBCOMMAND:
+            fprintf(stderr, "unknown command '%s'", result.mFirstErrorWord);
+            break;
+        case PER_MISSING_SUBCOMMAND:
+            fprintf(stderr, "missing command");
+            break;
+        case PER_INVALID_COMPLETION_INDEX:
+            fprintf(
+                stderr, "invalid completion index '%s'",
+                result.mFirstErrorWord);
+            break;
         case PER_HELP:
         case PER_NO_ERROR:
         default:
             assert(false && "unreachable in parsing error checking");
 
     }
-    fprintf(stderr, "\n\n");
-    cap_parser_print_usage(parser, stderr, *argv);
-    exit(-1);
-}
+    fprintf(stderr, "\n\n");
+    cap_parser_print_usage(parser, stderr, program);
+    cap_free(subcommand_program);
+    cap_pa_destroy(result.mArguments);
+    exit(-1);
+}
+
+static WordConversionResult _cap_parse_word_as_type(
+        const char * word, DataType type, TypedUnion * uninitialized_tu) {
+    switch (type) {
+        case DT_DOUBLE: {
+            double v;
+            const WordConversionResult result = _cap_parse_double(word, &v);
+            if (result == WCR_OK) {
+                *uninitialized_tu = cap_tu_make_double(v);
+            }
+            return result;
+        }
+        case DT_INT: {
+            int v;
+            const WordConversionResult result = _cap_parse_int(word, &v);
+            if (result == WCR_OK) {
+                *uninitialized_tu = cap_tu_make_int(v);
+            }
+            return result;
+        }
+        case DT_STRING: {
+            // the string is borrowed from the command line, it is copied when
+            // the value is stored in a ParsedArguments
+            *uninitialized_tu = (TypedUnion) {
+                .mType = DT_STRING,
+                .mValue = { .asString = (char *) word }
+            };
+            return WCR_OK;
+        }
+        default:
+            break;
+    }
+    return WCR_INVALID;
+}
+
+static bool _cap_parser_find_flag_id(
+        const ArgumentParser * parser, const char * flag, size_t * id) {
+    return cap_si_find(parser -> mFlagIndex, flag, id);
+}
+
+static FlagInfo * _cap_parser_find_flag(
+        const ArgumentParser * parser, const char * flag) {
+    size_t id;
+    if (!_cap_parser_find_flag_id(parser, flag, &id)) {
+        return NULL;
+    }
+    if (id == _CAP_HELP_FLAG_ID) {
+        return parser -> mHelpFlagInfo;
+    }
+    if (id == _CAP_FLAG_SEPARATOR_ID) {
+        return parser -> mFlagSeparatorInfo;
+    }
+    return parser -> mFlags[id];
+}
+
+static void _cap_parser_index_flag(
+        ArgumentParser * parser, const FlagInfo * flag_info, size_t id) {
+    cap_si_insert(parser -> mFlagIndex, flag_info -> mName, id);
+    _cap_parser_insert_completion_name(parser, flag_info -> mName);
+    for (size_t i = 0; i < flag_info -> mAliasCount; ++i) {
+        cap_si_insert(parser -> mFlagIndex, flag_info -> mAliases[i], id);
+        _cap_parser_insert_completion_name(parser, flag_info -> mAliases[i]);
+    }
+}
+
+static void _cap_parser_unindex_flag(
+        ArgumentParser * parser, const FlagInfo * flag_info) {
+    cap_si_remove(parser -> mFlagIndex, flag_info -> mName);
+    _cap_parser_remove_completion_name(parser, flag_info -> mName);
+    for (size_t i = 0; i < flag_info -> mAliasCount; ++i) {
+        cap_si_remove(parser -> mFlagIndex, flag_info -> mAliases[i]);
+        _cap_parser_remove_completion_name(parser, flag_info -> mAliases[i]);
+    }
+}
+
+static void _cap_parser_set_string(
+        ArgumentParser * parser, char ** property, unsigned static_bit,
+        const char * value) {
+    // replaces one of the strings of the parser itself. It is released only
+    // if it is a copy, the new value is copied unless strings are static.
+    _cap_parser_forget_texts(parser);
+    if (!(parser -> mStaticProperties & static_bit)) {
+        cap_free(*property);
+    }
+    if (parser -> mStaticStrings) {
+        // borrowed strings are never modified, nor released
+        *property = (char *) value;
+        parser -> mStaticProperties |= static_bit;
+    }
+    else {
+        *property = copy_string(value);
+        parser -> mStaticProperties &= ~static_bit;
+    }
+}
+
+static void _cap_parser_index_subcommands(ArgumentParser * parser) {
+    // creates the index of subcommands which were copied from another parser,
+    // e.g. by `cap_parser_compile`
+    parser -> mSubcommandIndex = NULL;
+    if (!parser -> mSubcommandCount) {
+        return;
+    }
+    parser -> mSubcommandIndex = cap_si_make_empty();
+    cap_si_reserve(parser -> mSubcommandIndex, parser -> mSubcommandCount);
+    for (size_t i = 0u; i < parser -> mSubcommandCount; ++i) {
+        cap_si_insert(
+            parser -> mSubcommandIndex, parser -> mSubcommands[i].mName, i);
+    }
+}
+
+static ArgumentParser * _cap_parser_build_subparser(
+        const ArgumentParser * parser, size_t id) {
+    // runs the builder of a subcommand on a new parser, which starts with the
+    // options of `parser`
+    const _CapSubcommand * subcommand = parser -> mSubcommands + id;
+    ArgumentParser * subparser = cap_parser_make_default();
+    subparser -> mBorrowStrings = parser -> mBorrowStrings;
+    subparser -> mExactAllocation = parser -> mExactAllocation;
+    subparser -> mPackValues = parser -> mPackValues;
+    subparser -> mThreadCount = parser -> mThreadCount;
+    subparser -> mStaticStrings = parser -> mStaticStrings;
+    cap_parser_enable_completion(subparser, parser -> mEnableCompletion);
+    subcommand -> mBuilder(subparser, subcommand -> mContext);
+    return subparser;
+}
+
+static const ArgumentParser * _cap_parser_get_subparser(
+        const ArgumentParser * parser, size_t id, ArgumentParser ** built) {
+    // returns the parser built by `cap_parser_build_subcommands`, or builds a
+    // new one which the caller owns, and which is also stored to `built`.
+    // Parsing never changes `parser`, so it needs no lock.
+    ArgumentParser * subparser = parser -> mSubcommands[id].mParser;
+    *built = subparser ? NULL : _cap_parser_build_subparser(parser, id);
+    return subparser ? subparser : *built;
+}
+
+static void _cap_parser_release_subparser(void * parser) {
+    // destroys a parser owned by a `ParsedArguments`, see
+    // `_cap_pa_set_subcommand`
+    cap_parser_destroy((ArgumentParser *) parser);
+}
+
+static void _cap_parser_release_subparsers(ArgumentParser * parser) {
+    // destroys the parsers which were built and the index, but not the
+    // subcommands themselves
+    for (size_t i = 0u; i < parser -> mSubcommandCount; ++i) {
+        cap_parser_destroy(parser -> mSubcommands[i].mParser);
+        parser -> mSubcommands[i].mParser = NULL;
+    }
+    cap_si_destroy(parser -> mSubcommandIndex);
+    parser -> mSubcommandIndex = NULL;
+}
+
+static bool _cap_parser_has_name(
+        const ArgumentParser * parser, const char * name) {
+    // checks if `name` points to a name of a flag or a positional of
+    // `parser` (and not just to an equal string)
+    const FlagInfo * special[2] = {
+        parser -> mHelpFlagInfo, parser -> mFlagSeparatorInfo
+    };
+    for (size_t i = 0u; i < 2u; ++i) {
+        if (special[i] && special[i] -> mName == name) {
+            return true;
+        }
+    }
+    for (size_t i = 0u; i < parser -> mFlagCount; ++i) {
+        if (parser -> mFlags[i] -> mName == name) {
+            return true;
+        }
+    }
+    for (size_t i = 0u; i < parser -> mPositionalCount; ++i) {
+        if (parser -> mPositionals[i] -> mName == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void _cap_parser_init_texts(ArgumentParser * parser) {
+    // the texts are not copied, e.g. by `cap_parser_compile`, since they can
+    // be rendered again
+    parser -> mHelpText = (TextBuffer) { NULL, 0u, 0u };
+    parser -> mUsageText = (TextBuffer) { NULL, 0u, 0u };
+    parser -> mCompletionNames = NULL;
+    parser -> mCompletionNameCount = 0u;
+    parser -> mCompletionNameAlloc = 0u;
+}
+
+static void _cap_parser_forget_texts(ArgumentParser * parser) {
+    // called by every configuration function which changes the texts
+    cap_free(parser -> mHelpText.mData);
+    cap_free(parser -> mUsageText.mData);
+    parser -> mHelpText = (TextBuffer) { NULL, 0u, 0u };
+    parser -> mUsageText = (TextBuffer) { NULL, 0u, 0u };
+}
+
+static void _cap_parser_release_texts(ArgumentParser * parser) {
+    _cap_parser_forget_texts(parser);
+    cap_free(parser -> mCompletionNames);
+    parser -> mCompletionNames = NULL;
+    parser -> mCompletionNameCount = 0u;
+    parser -> mCompletionNameAlloc = 0u;
+}
+
+static const TextBuffer * _cap_parser_get_text(
+        const ArgumentParser * parser, bool help, TextBuffer * rendered) {
+    // returns the help message or the usage string prepared by
+    // `cap_parser_prepare_help`, or renders it into the empty `rendered`,
+    // which the caller releases. The parser is never changed.
+    const TextBuffer * text = help
+        ? &(parser -> mHelpText)
+        : &(parser -> mUsageText);
+    if (text -> mData) {
+        return text;
+    }
+    if (help) {
+        _cap_parser_render_help(parser, rendered);
+    }
+    else {
+        _cap_parser_render_usage(parser, rendered);
+    }
+    // an empty message is still rendered
+    cap_text_append(rendered, "", 0u);
+    return rendered;
+}
+
+static bool _cap_parser_has_providers(const ArgumentParser * parser) {
+    // checks if the help message calls any description provider
+    if (parser -> mDescriptionProvider || parser -> mEpilogueProvider) {
+        return true;
+    }
+    const FlagInfo * special[2] = {
+        parser -> mHelpFlagInfo, parser -> mFlagSeparatorInfo
+    };
+    for (size_t i = 0u; i < 2u; ++i) {
+        if (special[i] && special[i] -> mDescriptionProvider) {
+            return true;
+        }
+    }
+    for (size_t i = 0u; i < parser -> mFlagCount; ++i) {
+        if (parser -> mFlags[i] -> mDescriptionProvider) {
+            return true;
+        }
+    }
+    for (size_t i = 0u; i < parser -> mPositionalCount; ++i) {
+        if (parser -> mPositionals[i] -> mDescriptionProvider) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void _cap_parser_render_usage(
+        const ArgumentParser * parser, TextBuffer * text) {
+    // renders everything after the program name
+    if (parser -> mHelpFlagInfo) {
+        cap_text_append_string(text, " [");
+        cap_text_append_string(
+            text, _cap_get_shortest_flag_name(parser -> mHelpFlagInfo));
+        cap_text_append_char(text, ']');
+    }
+
+    for (size_t i = 0; i < parser -> mFlagCount; ++i) {
+        const FlagInfo * fi = parser -> mFlags[i];
+        cap_text_append_char(text, ' ');
+        if (fi -> mMinCount == 0) {
+            cap_text_append_char(text, '[');
+        }
+        cap_text_append_string(text, _cap_get_shortest_flag_name(fi));
+        if (fi -> mType != DT_PRESENCE) {
+            cap_text_append_char(text, ' ');
+            cap_text_append_string(text, cap_get_flag_metavar(fi));
+        }
+        if (fi -> mMinCount == 0) {
+            cap_text_append_char(text, ']');
+        }
+    }
+
+    if (parser -> mSubcommandCount) {
+        cap_text_append_string(text, " <command> ...");
+    }
+    if (parser -> mPositionalCount > 0u && parser -> mFlagSeparatorInfo) {
+        cap_text_append_string(text, " [");
+        cap_text_append_string(
+            text, _cap_get_shortest_flag_name(parser -> mFlagSeparatorInfo));
+        cap_text_append_char(text, ']');
+    }
+    size_t optionals = 0u;
+    for (size_t i = 0; i < parser -> mPositionalCount; ++i) {
+        const PositionalInfo * pi = parser -> mPositionals[i];
+        cap_text_append_char(text, ' ');
+        if (!pi -> mRequired) {
+            cap_text_append_char(text, '[');
+            ++optionals;
+        }
+        if (pi -> mMetaVar) {
+            cap_text_append_string(text, pi -> mMetaVar);
+            continue;
+        }
+        cap_text_append_char(text, '<');
+        cap_text_append_string(text, pi -> mName);
+        cap_text_append_char(text, '>');
+    }
+    for (size_t i = 0; i < optionals; ++i) {
+        cap_text_append_char(text, ']');
+    }
+    cap_text_append_char(text, '\n');
+}
+
+static void _cap_parser_render_help(
+        const ArgumentParser * parser, TextBuffer * text) {
+    const char * description = cap_describe(
+        parser -> mDescription, parser -> mDescriptionProvider,
+        parser -> mDescriptionContext);
+    if (description) {
+        cap_text_append_string(text, description);
+        cap_text_append_char(text, '\n');
+    }
+    if (parser -> mFlagCount || parser -> mHelpFlagInfo || parser -> mFlagSeparatorInfo) {
+        cap_text_append_string(text, "\nAvailable flags:\n");
+    }
+    if (parser -> mHelpFlagInfo) {
+        cap_format_flag_info(text, parser -> mHelpFlagInfo);
+    }
+    if (parser -> mFlagSeparatorInfo) {
+        cap_format_flag_info(text, parser -> mFlagSeparatorInfo);
+    }
+    for (size_t i = 0; i < parser -> mFlagCount; ++i) {
+        cap_format_flag_info(text, parser -> mFlags[i]);
+    }
+
+    if (parser -> mPositionalCount) {
+        cap_text_append_string(text, "\nPositional Arguments:\n");
+    }
+    for (size_t i = 0; i < parser -> mPositionalCount; ++i) {
+        cap_format_positional_info(text, parser -> mPositionals[i]);
+    }
 
-// ============================================================================
-// === PARSER: IMPLEMENTATION OF PRIVATE FUNCTIONS ============================
-// ============================================================================
+    if (parser -> mSubcommandCount) {
+        cap_text_append_string(text, "\nCommands:\n");
+    }
+    for (size_t i = 0; i < parser -> mSubcommandCount; ++i) {
+        const _CapSubcommand * subcommand = parser -> mSubcommands + i;
+        cap_text_append_string(text, subcommand -> mName);
+        cap_text_append_char(text, '\n');
+        if (subcommand -> mDescription) {
+            cap_text_append_char(text, '\t');
+            cap_text_append_string(text, subcommand -> mDescription);
+            cap_text_append_char(text, '\n');
+        }
+    }
 
-static bool _cap_parse_double(const char * word, double * value) {
-    double v;
-    int c;
-    long long int n;
-    c = sscanf(word, "%lf%lln", &v, &n);
-    if (c != 1 || (unsigned long long int) n != strlen(word)) {
-        return false;
+    const char * epilogue = cap_describe(
+        parser -> mEpilogue, parser -> mEpilogueProvider,
+        parser -> mEpilogueContext);
+    if (epilogue) {
+        cap_text_append_string(text, "\n");
+        cap_text_append_string(text, epilogue);
+        cap_text_append_char(text, '\n');
     }
-    *value = v;
-    return true;
 }
 
-static bool _cap_parse_int(const char * word, int * value) {
-    int v, c;
-    long long int n;
-    c = sscanf(word, "%i%lln", &v, &n);
-    if (c != 1 || (unsigned long long int) n != strlen(word)) {
-        return false;
+static size_t _cap_copy_text(
+        char * buffer, size_t size, size_t offset, const char * text,
+        size_t length) {
+    // copies as much of `text` to `buffer + offset` as fits before the
+    // terminating null character, and returns the offset after all of it
+    if (offset + 1u < size) {
+        const size_t room = size - 1u - offset;
+        memcpy(buffer + offset, text, length < room ? length : room);
     }
-    *value = v;
-    return true;
+    return offset + length;
 }
 
-static bool _cap_parse_word_as_type(
-        const char * word, DataType type, TypedUnion * uninitialized_tu) {
-    switch (type) {
-        case DT_DOUBLE: {
-            double v;
-            if (_cap_parse_double(word, &v)) {
-                *uninitialized_tu = cap_tu_make_double(v);
-                return true;
-            }
-            break;
+static const char ** _cap_parser_sort_names(
+        const ArgumentParser * parser, size_t * count) {
+    // collects the names offered by shell completion into a new array, in
+    // ascending order
+    const FlagInfo * special[2] = {
+        parser -> mHelpFlagInfo, parser -> mFlagSeparatorInfo
+    };
+    size_t name_count = parser -> mSubcommandCount;
+    for (size_t i = 0u; i < parser -> mFlagCount; ++i) {
+        name_count += 1u + parser -> mFlags[i] -> mAliasCount;
+    }
+    for (size_t i = 0u; i < 2u; ++i) {
+        name_count += special[i] ? 1u + special[i] -> mAliasCount : 0u;
+    }
+    const char ** names = name_count
+        ? (const char **) cap_malloc(name_count * sizeof(const char *))
+        : NULL;
+    size_t n = 0u;
+    for (size_t i = 0u; i < parser -> mFlagCount; ++i) {
+        const FlagInfo * flag = parser -> mFlags[i];
+        names[n++] = flag -> mName;
+        for (size_t j = 0u; j < flag -> mAliasCount; ++j) {
+            names[n++] = flag -> mAliases[j];
         }
-        case DT_INT: {
-            int v;
-            if (_cap_parse_int(word, &v)) {
-                *uninitialized_tu = cap_tu_make_int(v);
-                return true;
-            }
-            break;
+    }
+    for (size_t i = 0u; i < 2u; ++i) {
+        if (!special[i]) {
+            continue;
         }
-        case DT_STRING: {
-            *uninitialized_tu = cap_tu_make_string(word);
-            return true;
+        names[n++] = special[i] -> mName;
+        for (size_t j = 0u; j < special[i] -> mAliasCount; ++j) {
+            names[n++] = special[i] -> mAliases[j];
         }
-        default:
-            break;
     }
-    return false;
+    for (size_t i = 0u; i < parser -> mSubcommandCount; ++i) {
+        names[n++] = parser -> mSubcommands[i].mName;
+    }
+    if (name_count) {
+        qsort(names, name_count, sizeof(const char *), _cap_compare_names);
+    }
+    *count = name_count;
+    return names;
 }
 
-static FlagInfo * _cap_parser_find_flag(
-        const ArgumentParser * parser, const char * flag) {
-    if (parser -> mHelpFlagInfo 
-    	    && _cap_flag_matches_name_or_alias(parser -> mHelpFlagInfo, flag)) {
-        return parser -> mHelpFlagInfo;
+static void _cap_parser_build_completion_names(ArgumentParser * parser) {
+    // sorts all names when the completion mode is enabled, and releases them
+    // when it is disabled
+    cap_free(parser -> mCompletionNames);
+    parser -> mCompletionNames = NULL;
+    parser -> mCompletionNameCount = 0u;
+    parser -> mCompletionNameAlloc = 0u;
+    if (parser -> mEnableCompletion) {
+        parser -> mCompletionNames = _cap_parser_sort_names(
+            parser, &(parser -> mCompletionNameCount));
+        parser -> mCompletionNameAlloc = parser -> mCompletionNameCount;
     }
-    if (parser -> mFlagSeparatorInfo 
-	        && _cap_flag_matches_name_or_alias(
-                parser -> mFlagSeparatorInfo, flag)) {
-        return parser -> mFlagSeparatorInfo;
+}
+
+static void _cap_parser_insert_completion_name(
+        ArgumentParser * parser, const char * name) {
+    // keeps the names sorted while names are configured one by one
+    if (!parser -> mEnableCompletion) {
+        return;
     }
-    for (size_t i = 0; i < parser -> mFlagCount; ++i) {
-        FlagInfo * fi = parser -> mFlags[i];
-        if (_cap_flag_matches_name_or_alias(fi, flag)) {
-            return fi;
+    const size_t count = parser -> mCompletionNameCount;
+    if (count >= parser -> mCompletionNameAlloc) {
+        size_t alloc_size = parser -> mCompletionNameAlloc;
+        alloc_size = alloc_size ? alloc_size * 2 : 8;
+        parser -> mCompletionNameAlloc = alloc_size;
+        parser -> mCompletionNames = (const char **) cap_realloc(
+            parser -> mCompletionNames, alloc_size * sizeof(const char *));
+    }
+    const char ** names = parser -> mCompletionNames;
+    size_t low = 0u;
+    size_t high = count;
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2u;
+        if (strcmp(names[middle], name) < 0) {
+            low = middle + 1u;
+        }
+        else {
+            high = middle;
         }
     }
-    return NULL;
+    memmove(names + low + 1u, names + low, (count - low) * sizeof(*names));
+    names[low] = name;
+    parser -> mCompletionNameCount = count + 1u;
 }
 
-static bool _cap_flag_matches_name_or_alias(
-    const FlagInfo * flag_info, const char * name_or_alias) 
-{
-    if (!strcmp(name_or_alias, flag_info -> mName)) {
-        return true;
-    }
-    for (size_t j = 0; j < flag_info -> mAliasCount; ++j) {
-        if (!strcmp(name_or_alias, flag_info -> mAliases[j])) {
-            return true;
+static void _cap_parser_remove_completion_name(
+        ArgumentParser * parser, const char * name) {
+    // removes the very string `name`, before it is released
+    const char ** names = parser -> mCompletionNames;
+    const size_t count = parser -> mCompletionNameCount;
+    for (size_t i = 0u; i < count; ++i) {
+        if (names[i] == name) {
+            memmove(
+                names + i, names + i + 1u, (count - i - 1u) * sizeof(*names));
+            parser -> mCompletionNameCount = count - 1u;
+            return;
         }
     }
-    return false;
 }
 
-static const char * _cap_get_shortest_flag_name(const FlagInfo * flag_info) {
-    const char * shortest = flag_info -> mName;
-    size_t shortest_length = strlen(shortest);
-    for (size_t i = 0; i < flag_info -> mAliasCount; ++i) {
-        size_t len = strlen(flag_info -> mAliases[i]);
-        if (len >= shortest_length) {
-            continue;
-        }
-        shortest = flag_info -> mAliases[i];
-        shortest_length = len;
+static int _cap_compare_names(const void * a, const void * b) {
+    return strcmp(*(const char * const *) a, *(const char * const *) b);
+}
+
+static void _cap_parser_check_completion(
+        const ArgumentParser * parser, int argc, const char ** argv) {
+    // handles the command line `PROGRAM --cap-complete INDEX WORDS...`
+    if (!parser || !parser -> mEnableCompletion || argc < 3
+            || strcmp(argv[1], "--cap-complete")) {
+        return;
+    }
+    char * end;
+    const unsigned long index = strtoul(argv[2], &end, 10);
+    if (*end || end == argv[2] || *argv[2] == '-') {
+        const ParsingResult result = (ParsingResult) {
+            .mArguments = NULL,
+            .mFirstErrorWord = argv[2],
+            .mSecondErrorWord = NULL,
+            .mError = PER_INVALID_COMPLETION_INDEX
+        };
+        _cap_parser_finish_parsing(parser, result, argv);
     }
-    return shortest;
+    cap_parser_complete(parser, argc - 3, argv + 3, (size_t) index, stdout);
+    exit(0);
+}
+
+static const char * _cap_get_shortest_flag_name(const FlagInfo * flag_info) {
+    return flag_info -> mShortestName;
 }
 
 static OnePositionalParsingResult _cap_parser_parse_one_positional(
@@ -1770,9 +3744,16 @@ static OnePositionalParsingResult _cap_parser_parse_one_positional(
     const PositionalInfo * posit_info 
         = parser -> mPositionals[positional_index];
     res.mPositional = posit_info;
-    if (!_cap_parse_word_as_type(arg, posit_info -> mType, &(res.mValue))) {
-        res.mError = OPPE_CANNOT_PARSE;
-        return res;
+    switch (_cap_parse_word_as_type(
+            arg, posit_info -> mType, &(res.mValue))) {
+        case WCR_OK:
+            break;
+        case WCR_OUT_OF_RANGE:
+            res.mError = OPPE_OUT_OF_RANGE;
+            return res;
+        default:
+            res.mError = OPPE_CANNOT_PARSE;
+            return res;
     }
 
     res.mWordsConsumed = 1;
@@ -1780,23 +3761,35 @@ static OnePositionalParsingResult _cap_parser_parse_one_positional(
 }
 
 static OneFlagParsingResult _cap_parser_parse_one_flag(
-        const ArgumentParser * parser, int argc, const char * const * argv,
-        int index) {
+        const ArgumentParser * parser, _CapWords * words) {
+    // advances `words` past the consumed words. If the value cannot be
+    // parsed, `words` is left at it.
     OneFlagParsingResult result;
     result.mWordsConsumed = 0;
     result.mError = OFPE_NO_ERROR;
 
-    const char * arg = argv[index];
+    const char * arg = words -> mWord;
 
     // 1. is this a flag that exists?
-    const FlagInfo * flag_info = _cap_parser_find_flag(parser, arg);
+    const FlagInfo * flag_info = NULL;
+    if (_cap_parser_find_flag_id(parser, arg, &(result.mFlagId))) {
+        if (result.mFlagId == _CAP_HELP_FLAG_ID) {
+            flag_info = parser -> mHelpFlagInfo;
+        }
+        else if (result.mFlagId == _CAP_FLAG_SEPARATOR_ID) {
+            flag_info = parser -> mFlagSeparatorInfo;
+        }
+        else {
+            flag_info = parser -> mFlags[result.mFlagId];
+        }
+    }
     result.mFlag = flag_info;
     if (!flag_info) {  // no such flag was found
         result.mError = OFPE_UNKNOWN_FLAG;
        	return result;
     }
     // skip arg because it is being consumed right now
-    ++index;
+    _cap_words_advance(words);
     ++result.mWordsConsumed;
    
     // 3. check data type and try to parse it
@@ -1805,38 +3798,205 @@ static OneFlagParsingResult _cap_parser_parse_one_flag(
 	return result;
     }
     // parse the next argument according to dtype
-    if (index >= argc) {
+    const char * value_arg = words -> mWord;
+    if (!value_arg) {
         result.mError = OFPE_MISSING_FLAG_VALUE;
         return result;
     }
-    const char * value_arg = argv[index];
     // This is a bit messy but it should work.
     // Generally, it is bad practice to use uninitialized objects.
     // What's even funnier is, I made factory functions for typed unions
     // but this code isn't directly using them lol.
-    if (!_cap_parse_word_as_type(
+    switch (_cap_parse_word_as_type(
             value_arg, flag_info -> mType, &(result.mValue))) {
-        result.mError = OFPE_CANNOT_PARSE_FLAG;
-        return result;
+        case WCR_OK:
+            break;
+        case WCR_OUT_OF_RANGE:
+            result.mError = OFPE_FLAG_OUT_OF_RANGE;
+            return result;
+        default:
+            result.mError = OFPE_CANNOT_PARSE_FLAG;
+            return result;
     }
     // very important! must skip extra the word that was consumed here
-    ++index;
+    _cap_words_advance(words);
     ++result.mWordsConsumed;
     return result;
 } 
 
+static bool _cap_parser_parse_numeric_run(
+        const ArgumentParser * parser, _CapWords * words,
+        size_t positional_index, bool positional_only,
+        ParsingResult * result) {
+    // converts the run of positional words starting at the current word for
+    // a variadic DT_INT or DT_DOUBLE positional at once, and advances `words`
+    // past it. Returns `false` if a word cannot be converted.
+    if (parser -> mThreadCount > 1u) {
+        // the whole run is collected, so that it can be split between
+        // threads. Its end is only known if it lies in a single buffer.
+        size_t alloc = _CAP_NUMERIC_CHUNK_SIZE;
+        size_t count = 0u;
+        const char ** run = (const char **) cap_malloc(
+            alloc * sizeof(const char *));
+        const char * limit = words -> mFileEnd;
+        while (words -> mWord
+                && (positional_only
+                    || !parser -> mIsFlagPrefix[
+                        (unsigned char) *words -> mWord])) {
+            if (count == alloc) {
+                alloc *= 2u;
+                run = (const char **) cap_realloc(
+                    run, alloc * sizeof(const char *));
+            }
+            if (words -> mFileEnd != limit) {
+                limit = NULL;
+            }
+            run[count++] = words -> mWord;
+            _cap_words_advance(words);
+        }
+        const bool stored = _cap_parser_store_numeric_words(
+            parser, positional_index, run, count, limit, result);
+        cap_free(run);
+        return stored;
+    }
+    const char * chunk[_CAP_NUMERIC_CHUNK_SIZE];
+    while (true) {
+        // a chunk ends with the buffer holding its words
+        const char * const limit = words -> mFileEnd;
+        size_t count = 0u;
+        while (words -> mWord && count < _CAP_NUMERIC_CHUNK_SIZE
+                && words -> mFileEnd == limit
+                && (positional_only
+                    || !parser -> mIsFlagPrefix[
+                        (unsigned char) *words -> mWord])) {
+            chunk[count++] = words -> mWord;
+            _cap_words_advance(words);
+        }
+        if (!count) {
+            break;
+        }
+        if (!_cap_parser_store_numeric_words(
+                parser, positional_index, chunk, count, limit, result)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool _cap_parser_store_numeric_words(
+        const ArgumentParser * parser, size_t positional_index,
+        const char * const * words, size_t count, const char * limit,
+        ParsingResult * result) {
+    // converts `words` and appends them to the values of a variadic DT_INT
+    // or DT_DOUBLE positional. Returns `false` if a word cannot be
+    // converted, the values before it are kept. `limit` is the end of the
+    // buffer holding the words, `NULL` if it is not known.
+    if (!count) {
+        return true;
+    }
+    const PositionalInfo * posit_info
+        = parser -> mPositionals[positional_index];
+    const bool is_int = posit_info -> mType == DT_INT;
+    NamedValues * slot = _cap_pa_positional_slot_at(
+        result -> mArguments, positional_index, posit_info -> mName);
+    // the values are written into the packed array of the positional
+    // if possible. Otherwise a run converted on several threads is first
+    // converted into a temporary array.
+    void * packed = _cap_nv_extend(slot, posit_info -> mType, count);
+    void * buffer = packed;
+    if (!packed && parser -> mThreadCount > 1u) {
+        buffer = cap_malloc(
+            count * (is_int ? sizeof(int) : sizeof(double)));
+    }
+    WordConversionResult conversion = WCR_OK;
+    size_t converted = 0u;
+    if (buffer && parser -> mThreadCount > 1u) {
+        converted = _cap_parse_number_batch_parallel(
+            words, count, limit, posit_info -> mType, buffer,
+            parser -> mThreadCount, &conversion);
+    }
+    else if (packed) {
+        converted = is_int
+            ? _cap_parse_int_batch(
+                words, count, limit, (int *) packed, &conversion)
+            : _cap_parse_double_batch(
+                words, count, limit, (double *) packed, &conversion);
+    }
+    if (packed) {
+        _cap_nv_commit(slot, converted);
+    }
+    else if (buffer) {
+        for (size_t i = 0u; i < converted; ++i) {
+            _cap_nv_append_value_inner(slot, is_int
+                ? cap_tu_make_int(((const int *) buffer)[i])
+                : cap_tu_make_double(((const double *) buffer)[i]));
+        }
+        cap_free(buffer);
+    }
+    union {
+        int asInts[_CAP_NUMERIC_CHUNK_SIZE];
+        double asDoubles[_CAP_NUMERIC_CHUNK_SIZE];
+    } values;
+    while (!buffer && converted < count && conversion == WCR_OK) {
+        const size_t remaining = count - converted;
+        const size_t size = remaining < _CAP_NUMERIC_CHUNK_SIZE
+            ? remaining : _CAP_NUMERIC_CHUNK_SIZE;
+        const size_t chunk_converted = is_int
+            ? _cap_parse_int_batch(
+                words + converted, size, limit, values.asInts, &conversion)
+            : _cap_parse_double_batch(
+                words + converted, size, limit, values.asDoubles,
+                &conversion);
+        for (size_t i = 0u; i < chunk_converted; ++i) {
+            _cap_nv_append_value_inner(slot, is_int
+                ? cap_tu_make_int(values.asInts[i])
+                : cap_tu_make_double(values.asDoubles[i]));
+        }
+        converted += chunk_converted;
+    }
+    if (converted < count) {
+        result -> mError = conversion == WCR_OUT_OF_RANGE
+            ? PER_POSITIONAL_OUT_OF_RANGE
+            : PER_CANNOT_PARSE_POSITIONAL;
+        result -> mFirstErrorWord = posit_info -> mName;
+        result -> mSecondErrorWord = words[converted];
+        return false;
+    }
+    return true;
+}
+
 static void _cap_parser_parse_flags_and_positionals(
-        const ArgumentParser * parser, int argc, const char * const * argv,
+        const ArgumentParser * parser, _CapWords words,
         ParsingResult * result) {
     size_t positional_index = 0;
-    int index = 1;
     bool positional_only = false;
 
-    while (index < argc) {
-        const char * arg = argv[index];
+    while (words.mWord) {
+        const char * arg = words.mWord;
 
-        if (positional_only || !strlen(arg) 
-		        || !strchr(parser -> mFlagPrefixChars, arg[0])) {
+        // NB that an empty word is a positional, the terminating null is 
+        // never a flag prefix
+        if (positional_only || !parser -> mIsFlagPrefix[(unsigned char) *arg]) {
+            if (parser -> mSubcommandCount) {
+                // the remaining words belong to the subcommand
+                _cap_parser_parse_subcommand(parser, words, result);
+                return;
+            }
+            if (positional_index < parser -> mPositionalCount
+                    && parser -> mPositionals[positional_index] -> mVariadic
+                    && (parser -> mPositionals[positional_index] -> mType
+                        == DT_INT
+                        || parser -> mPositionals[positional_index] -> mType
+                        == DT_DOUBLE)) {
+                // numeric words of a variadic positional are converted in
+                // batches
+                if (!_cap_parser_parse_numeric_run(
+                        parser, &words, positional_index, positional_only,
+                        result)) {
+                    return;
+                }
+                continue;
+            }
             // positional
             OnePositionalParsingResult one_posit_res = 
                 _cap_parser_parse_one_positional(parser, arg, positional_index);
@@ -1852,27 +4012,32 @@ static void _cap_parser_parse_flags_and_positionals(
                     result -> mFirstErrorWord = posit_info -> mName;
                     result -> mSecondErrorWord = arg;
                     return;
+                case OPPE_OUT_OF_RANGE:
+                    result -> mError = PER_POSITIONAL_OUT_OF_RANGE;
+                    result -> mFirstErrorWord = posit_info -> mName;
+                    result -> mSecondErrorWord = arg;
+                    return;
                 default:
                     assert(
                         false && "unreachable in "
                         "_cap_parser_parse_flags_and_positionals");
             }
-            cap_pa_append_positional(
-                result -> mArguments, posit_info -> mName, 
-                one_posit_res.mValue);
+            _cap_pa_append_parsed_positional_at(
+                result -> mArguments, positional_index, posit_info -> mName, 
+                one_posit_res.mValue, parser -> mBorrowStrings);
             if (!posit_info -> mVariadic) {
                 // if the current argument is variadic, do not advance
                 // positional_index. That way more words can be consumed by
                 // this.
                 ++positional_index;
             }
-            index += one_posit_res.mWordsConsumed;
+            _cap_words_advance(&words);
             continue;
         }
 	
         // try to parse a flag
 	OneFlagParsingResult one_flag_res = _cap_parser_parse_one_flag(
-            parser, argc, argv, index);
+            parser, &words);
 	const FlagInfo * parsed_flag = one_flag_res.mFlag;
 	switch (one_flag_res.mError) {
 	    case OFPE_NO_ERROR:
@@ -1888,13 +4053,16 @@ static void _cap_parser_parse_flags_and_positionals(
 	    case OFPE_CANNOT_PARSE_FLAG:
             result -> mError = PER_CANNOT_PARSE_FLAG;
             result -> mFirstErrorWord = arg;
-            result -> mSecondErrorWord 
-                = argv[index + one_flag_res.mWordsConsumed];
+            result -> mSecondErrorWord = words.mWord;
+            return;
+	    case OFPE_FLAG_OUT_OF_RANGE:
+            result -> mError = PER_FLAG_OUT_OF_RANGE;
+            result -> mFirstErrorWord = arg;
+            result -> mSecondErrorWord = words.mWord;
             return;
 	    default:
             assert(false && "unreachable in cap_parser_parse_noexit");
 	}
-	index += one_flag_res.mWordsConsumed;
         if (parsed_flag == parser -> mFlagSeparatorInfo) {
             // switch to positional-only mode
             positional_only = true;
@@ -1904,34 +4072,484 @@ static void _cap_parser_parse_flags_and_positionals(
             result -> mError = PER_HELP;
             return;
         }
-	// normal flag -> add its value to parsed_arguments
-	cap_pa_add_flag(
-	    result -> mArguments, parsed_flag -> mName, one_flag_res.mValue); 
+        // normal flag -> enforce its maximum count right away, so that a flood
+        // of repeated flags is not accumulated before failing
+        if (parsed_flag -> mMaxCount >= 0
+                && cap_pa_flag_count_by_id(
+                    result -> mArguments, one_flag_res.mFlagId)
+                    >= (size_t) parsed_flag -> mMaxCount) {
+            result -> mError = PER_TOO_MANY_FLAGS;
+            result -> mFirstErrorWord = parsed_flag -> mName;
+            return;
+        }
+	// add its value to parsed_arguments
+	_cap_pa_add_parsed_flag_at(
+	    result -> mArguments, one_flag_res.mFlagId, parsed_flag -> mName,
+	    one_flag_res.mValue, parser -> mBorrowStrings); 
+    }
+}
+
+static void _cap_parser_parse_subcommand(
+        const ArgumentParser * parser, _CapWords words,
+        ParsingResult * result) {
+    // the current word names the subcommand, the words after it are parsed by
+    // its parser into arguments owned by `result -> mArguments`
+    const char * name = words.mWord;
+    size_t id;
+    if (!cap_si_find(parser -> mSubcommandIndex, name, &id)) {
+        result -> mError = PER_UNKNOWN_SUBCOMMAND;
+        result -> mFirstErrorWord = name;
+        return;
+    }
+    // all flags of this parser precede the subcommand, so they are checked
+    // now. Any error reported once a subcommand is stored is then an error of
+    // the subcommand.
+    FlagCountCheckResult count_check = _cap_parser_check_flag_counts(
+        parser, result -> mArguments);
+    if (count_check.mCount == TOO_FEW) {
+        result -> mError = PER_NOT_ENOUGH_FLAGS;
+        result -> mFirstErrorWord = count_check.mFlag -> mName;
+        return;
+    }
+    ArgumentParser * built;
+    const ArgumentParser * subparser = _cap_parser_get_subparser(
+        parser, id, &built);
+    _cap_words_advance(&words);
+    ParsedArguments * subcommand_args = _cap_parser_make_arguments(
+        subparser, words);
+    _cap_pa_set_subcommand(
+        result -> mArguments, name, subcommand_args, built,
+        _cap_parser_release_subparser);
+    const ParsingResult subcommand_result = _cap_parser_parse_into(
+        subparser, subcommand_args, words);
+    result -> mError = subcommand_result.mError;
+    result -> mFirstErrorWord = subcommand_result.mFirstErrorWord;
+    result -> mSecondErrorWord = subcommand_result.mSecondErrorWord;
+}
+
+static size_t _cap_parser_count_values(
+        const ArgumentParser * parser, _CapWords words, size_t * flag_counts,
+        size_t * positional_counts) {
+    // the first pass of exact allocation: classifies words exactly like
+    // _cap_parser_parse_flags_and_positionals, but does not convert values.
+    // Stops at the first word which causes an error, the second pass reports
+    // it. Returns the number of arena bytes needed for names and strings.
+    const bool copy_strings = !parser -> mBorrowStrings;
+    size_t extra_size = 0u;
+    size_t positional_index = 0;
+    bool positional_only = false;
+
+    while (words.mWord) {
+        const char * arg = words.mWord;
+        if (positional_only || !parser -> mIsFlagPrefix[(unsigned char) *arg]) {
+            if (positional_index >= parser -> mPositionalCount) {
+                if (parser -> mSubcommandCount) {
+                    // a copy of the name of the subcommand
+                    extra_size += cap_arena_footprint(strlen(arg) + 1u);
+                }
+                break;
+            }
+            const PositionalInfo * posit_info 
+                = parser -> mPositionals[positional_index];
+            if (!positional_counts[positional_index]++) {
+                extra_size += cap_arena_footprint(
+                    strlen(posit_info -> mName) + 1u);
+            }
+            if (copy_strings && posit_info -> mType == DT_STRING) {
+                extra_size += cap_arena_footprint(strlen(arg) + 1u);
+            }
+            if (!posit_info -> mVariadic) {
+                ++positional_index;
+            }
+            _cap_words_advance(&words);
+            continue;
+        }
+
+        size_t id;
+        if (!_cap_parser_find_flag_id(parser, arg, &id) 
+                || id == _CAP_HELP_FLAG_ID) {
+            break;
+        }
+        _cap_words_advance(&words);
+        if (id == _CAP_FLAG_SEPARATOR_ID) {
+            positional_only = true;
+            continue;
+        }
+        const FlagInfo * flag_info = parser -> mFlags[id];
+        if (flag_info -> mMaxCount >= 0
+                && flag_counts[id] >= (size_t) flag_info -> mMaxCount) {
+            break;
+        }
+        if (!flag_counts[id]++) {
+            extra_size += cap_arena_footprint(strlen(flag_info -> mName) + 1u);
+        }
+        if (flag_info -> mType == DT_PRESENCE) {
+            continue;
+        }
+        if (!words.mWord) {
+            break;
+        }
+        if (copy_strings && flag_info -> mType == DT_STRING) {
+            extra_size += cap_arena_footprint(strlen(words.mWord) + 1u);
+        }
+        _cap_words_advance(&words);
+    }
+    return extra_size;
+}
+
+static void _cap_parser_count_to_size(
+        const ArgumentParser * parser, size_t * flag_counts,
+        size_t * positional_counts) {
+    // replaces the numbers of values by the sizes of their storage
+    for (size_t i = 0u; i < parser -> mFlagCount; ++i) {
+        flag_counts[i] = _cap_nv_reserved_size(
+            parser -> mFlags[i] -> mType, flag_counts[i],
+            parser -> mPackValues);
+    }
+    for (size_t i = 0u; i < parser -> mPositionalCount; ++i) {
+        positional_counts[i] = _cap_nv_reserved_size(
+            parser -> mPositionals[i] -> mType, positional_counts[i],
+            parser -> mPackValues);
+    }
+}
+
+static ParsedArguments * _cap_parser_make_exact_arguments(
+        const ArgumentParser * parser, _CapWords words) {
+    const size_t flag_count = parser -> mFlagCount;
+    const size_t positional_count = parser -> mPositionalCount;
+    const size_t counts_size =
+        (flag_count + positional_count + 1u) * sizeof(size_t);
+    size_t * counts = (size_t *) cap_malloc(counts_size);
+    memset(counts, 0, counts_size);
+    const size_t extra_size = _cap_parser_count_values(
+        parser, words, counts, counts + flag_count);
+    _cap_parser_count_to_size(parser, counts, counts + flag_count);
+    ParsedArguments * parsed_arguments = _cap_pa_make_exact(
+        flag_count, counts, positional_count, counts + flag_count,
+        extra_size, parser -> mPackValues);
+    cap_free(counts);
+    return parsed_arguments;
+}
+
+static ParsedArguments * _cap_parser_make_arguments(
+        const ArgumentParser * parser, _CapWords words) {
+    // an empty object to parse `words` into
+    if (parser -> mExactAllocation) {
+        return _cap_parser_make_exact_arguments(parser, words);
+    }
+    ParsedArguments * parsed_arguments = cap_pa_make_reserved(
+        parser -> mFlagCount, parser -> mPositionalCount);
+    _cap_pa_enable_packing(parsed_arguments, parser -> mPackValues);
+    return parsed_arguments;
+}
+
+static _CapWords _cap_words_make(
+        int argc, const char * const * argv, const ResponseFile * files,
+        size_t file_count) {
+    // the cursor starts at the first word after the program name
+    _CapWords words = (_CapWords) {
+        .mArgv = argv,
+        .mArgc = argc,
+        .mIndex = 1,
+        .mFiles = files,
+        .mFileCount = file_count,
+        .mWord = NULL,
+        .mFileEnd = NULL
+    };
+    _cap_words_load(&words);
+    return words;
+}
+
+static void _cap_words_load(_CapWords * words) {
+    // makes the word at `mIndex` current, entering the response file named
+    // there. Empty files are skipped.
+    while (words -> mIndex < words -> mArgc) {
+        if (words -> mFileCount
+                && words -> mFiles -> mIndex == words -> mIndex) {
+            const ResponseFile * file = words -> mFiles++;
+            --words -> mFileCount;
+            if (file -> mData < file -> mWordsEnd) {
+                words -> mWord = file -> mData;
+                words -> mFileEnd = file -> mWordsEnd;
+                return;
+            }
+            ++words -> mIndex;
+            continue;
+        }
+        words -> mWord = words -> mArgv[words -> mIndex];
+        words -> mFileEnd = NULL;
+        return;
+    }
+    words -> mWord = NULL;
+    words -> mFileEnd = NULL;
+}
+
+static void _cap_words_advance(_CapWords * words) {
+    // words of a response file are stored one after another, each followed
+    // by a null character
+    if (words -> mFileEnd) {
+        words -> mWord += strlen(words -> mWord) + 1u;
+        if (words -> mWord < words -> mFileEnd) {
+            return;
+        }
+    }
+    ++words -> mIndex;
+    _cap_words_load(words);
+}
+
+static ParsingResult _cap_parser_open_response_files(
+        const ArgumentParser * parser, int argc, const char * const * argv,
+        ResponseFile ** files, size_t * file_count) {
+    // opens the response files named before the flag separator. On success,
+    // `files` is an array allocated using `cap_malloc` (or `NULL`), ordered
+    // by position on the command line.
+    ParsingResult result = (ParsingResult) {
+        .mArguments = NULL,
+        .mFirstErrorWord = NULL,
+        .mSecondErrorWord = NULL,
+        .mError = PER_NO_ERROR
+    };
+    *files = NULL;
+    *file_count = 0u;
+    if (!parser -> mExpandResponseFiles) {
+        return result;
+    }
+    size_t alloc = 0u;
+    for (int i = 1; i < argc; ++i) {
+        const char * arg = argv[i];
+        size_t id;
+        if (parser -> mIsFlagPrefix[(unsigned char) *arg]
+                && _cap_parser_find_flag_id(parser, arg, &id)
+                && id == _CAP_FLAG_SEPARATOR_ID) {
+            break;
+        }
+        if (arg[0] != '@' || !arg[1]) {
+            continue;
+        }
+        if (*file_count == alloc) {
+            alloc = alloc ? 2u * alloc : 4u;
+            *files = (ResponseFile *) (*files
+                ? cap_realloc(*files, alloc * sizeof(ResponseFile))
+                : cap_malloc(alloc * sizeof(ResponseFile)));
+        }
+        const ResponseFileError error = _cap_rf_open(
+            *files + *file_count, arg, i);
+        if (error != RFE_NO_ERROR) {
+            for (size_t j = 0u; j < *file_count; ++j) {
+                _cap_rf_close(*files + j);
+            }
+            cap_free(*files);
+            *files = NULL;
+            *file_count = 0u;
+            result.mError = error == RFE_CANNOT_READ
+                ? PER_CANNOT_READ_RESPONSE_FILE
+                : PER_INVALID_RESPONSE_FILE;
+            result.mFirstErrorWord = arg + 1;
+            return result;
+        }
+        ++*file_count;
+    }
+    return result;
+}
+
+static void _cap_parser_detach_error_words(ParsingResult * result) {
+    // error words read from a response file become invalid when the file is
+    // released, they are replaced by the argument which named the file.
+    // Names in a parser built just for this parse are released with it, so
+    // there is nothing to replace them with.
+    for (const ParsedArguments * args = result -> mArguments; args;
+            args = args -> mSubcommandArguments) {
+        const ArgumentParser * subparser
+            = (const ArgumentParser *) args -> mSubparser;
+        if (subparser && _cap_parser_has_name(
+                subparser, result -> mFirstErrorWord)) {
+            result -> mFirstErrorWord = NULL;
+        }
+        for (size_t i = 0u; i < args -> mResponseFileCount; ++i) {
+            const ResponseFile * file = args -> mResponseFiles + i;
+            if (_cap_rf_contains(file, result -> mFirstErrorWord)) {
+                result -> mFirstErrorWord = file -> mArgument;
+            }
+            if (_cap_rf_contains(file, result -> mSecondErrorWord)) {
+                result -> mSecondErrorWord = file -> mArgument;
+            }
+        }
+    }
+}
+
+static void _cap_input_init(_CapInput * input, int fd, char delimiter) {
+    *input = (_CapInput) {
+        .mFd = fd,
+        .mDelimiter = delimiter,
+        .mBuffer = (char *) cap_malloc(_CAP_INPUT_CHUNK_SIZE + 1u),
+        .mSize = _CAP_INPUT_CHUNK_SIZE,
+        .mUsed = 0u,
+        .mConsumed = 0u,
+        .mEnd = false,
+        .mFailed = false
+    };
+}
+
+static bool _cap_input_next(_CapInput * input, _CapWords * words) {
+    // reads the next complete records, and makes `words` a cursor over them.
+    // Records handed out before are overwritten. Returns `false` at the end
+    // of the input, or if it cannot be read (then `mFailed` is set).
+    char * buffer = input -> mBuffer;
+    if (input -> mConsumed) {
+        input -> mUsed -= input -> mConsumed;
+        memmove(buffer, buffer + input -> mConsumed, input -> mUsed);
+        input -> mConsumed = 0u;
+    }
+    size_t complete;
+    while (true) {
+        if (input -> mEnd) {
+            // the last record does not need a delimiter
+            if (!input -> mUsed) {
+                return false;
+            }
+            buffer[input -> mUsed] = input -> mDelimiter;
+            complete = input -> mUsed + 1u;
+            break;
+        }
+        if (input -> mUsed == input -> mSize) {
+            // a single record does not fit
+            input -> mSize *= 2u;
+            buffer = (char *) cap_realloc(buffer, input -> mSize + 1u);
+            input -> mBuffer = buffer;
+        }
+        const long read_size = _cap_rf_read_fd(
+            input -> mFd, buffer + input -> mUsed,
+            input -> mSize - input -> mUsed);
+        if (read_size < 0) {
+            input -> mFailed = true;
+            return false;
+        }
+        if (!read_size) {
+            input -> mEnd = true;
+            continue;
+        }
+        // the data before `start` holds no delimiter
+        const size_t start = input -> mUsed;
+        input -> mUsed += (size_t) read_size;
+        complete = input -> mUsed;
+        while (complete > start
+                && buffer[complete - 1u] != input -> mDelimiter) {
+            --complete;
+        }
+        if (complete > start) {
+            break;
+        }
+    }
+    if (input -> mDelimiter) {
+        for (char * c = buffer; (c = (char *) memchr(
+                c, input -> mDelimiter, (size_t) (buffer + complete - c)));
+                ++c) {
+            *c = '\0';
+        }
+    }
+    input -> mConsumed = input -> mEnd ? input -> mUsed : complete;
+    *words = (_CapWords) {
+        .mArgv = NULL,
+        .mArgc = 0,
+        .mIndex = 0,
+        .mFiles = NULL,
+        .mFileCount = 0u,
+        .mWord = buffer,
+        .mFileEnd = buffer + complete
+    };
+    return true;
+}
+
+static char * _cap_input_detach(_CapInput * input) {
+    // hands the records read last over to the caller (to be released using
+    // `cap_free`), so that they are not overwritten
+    char * records = input -> mBuffer;
+    input -> mBuffer = (char *) cap_malloc(input -> mSize + 1u);
+    input -> mUsed -= input -> mConsumed;
+    memcpy(input -> mBuffer, records + input -> mConsumed, input -> mUsed);
+    input -> mConsumed = 0u;
+    return records;
+}
+
+static void _cap_input_destroy(_CapInput * input) {
+    cap_free(input -> mBuffer);
+    input -> mBuffer = NULL;
+}
+
+static void _cap_parser_parse_input(
+        const ArgumentParser * parser, ParsingResult * result) {
+    // appends the records read from the input of a positional to its values.
+    // If strings are borrowed, or an error word points into the records,
+    // they are kept by the ParsedArguments.
+    if (parser -> mInputFd < 0 || result -> mError != PER_NO_ERROR) {
+        return;
+    }
+    const size_t positional_index = parser -> mInputPositional;
+    const PositionalInfo * posit_info
+        = parser -> mPositionals[positional_index];
+    const bool numeric = posit_info -> mType == DT_INT
+        || posit_info -> mType == DT_DOUBLE;
+    _CapInput input;
+    _cap_input_init(&input, parser -> mInputFd, parser -> mInputDelimiter);
+    _CapWords words;
+    while (result -> mError == PER_NO_ERROR
+            && _cap_input_next(&input, &words)) {
+        const char * const records_end = words.mFileEnd;
+        if (numeric) {
+            _cap_parser_parse_numeric_run(
+                parser, &words, positional_index, true, result);
+        }
+        for (; !numeric && words.mWord; _cap_words_advance(&words)) {
+            OnePositionalParsingResult one_posit_res
+                = _cap_parser_parse_one_positional(
+                    parser, words.mWord, positional_index);
+            if (one_posit_res.mError != OPPE_NO_ERROR) {
+                result -> mError = one_posit_res.mError == OPPE_OUT_OF_RANGE
+                    ? PER_POSITIONAL_OUT_OF_RANGE
+                    : PER_CANNOT_PARSE_POSITIONAL;
+                result -> mFirstErrorWord = posit_info -> mName;
+                result -> mSecondErrorWord = words.mWord;
+                break;
+            }
+            _cap_pa_append_parsed_positional_at(
+                result -> mArguments, positional_index, posit_info -> mName,
+                one_posit_res.mValue, parser -> mBorrowStrings);
+        }
+        if (result -> mError != PER_NO_ERROR
+                || (posit_info -> mType == DT_STRING
+                    && parser -> mBorrowStrings)) {
+            _cap_pa_add_response_file(result -> mArguments, (ResponseFile) {
+                .mArgument = _CAP_INPUT_ERROR_WORD,
+                .mIndex = 0,
+                .mData = _cap_input_detach(&input),
+                .mWordsEnd = records_end,
+                .mMapSize = 0u
+            });
+        }
+    }
+    if (input.mFailed) {
+        result -> mError = PER_CANNOT_READ_INPUT;
+        result -> mFirstErrorWord = posit_info -> mName;
     }
+    _cap_input_destroy(&input);
 }
 
 static FlagCountCheckResult _cap_parser_check_flag_counts(
         const ArgumentParser * parser,
        	const ParsedArguments * parsed_arguments) {
     
-    // check min and max count requirements for flags
+    // check min count requirements for flags (max counts are enforced while
+    // parsing). Values of each flag are stored in the slot given by its id, so
+    // the number of values is also its occurrence counter.
     for (size_t i = 0; i < parser -> mFlagCount; ++i) {
         const FlagInfo * flag_info = parser -> mFlags[i];
-        size_t real_count = cap_pa_flag_count(
-            parsed_arguments, flag_info -> mName);
+        size_t real_count = cap_pa_flag_count_by_id(parsed_arguments, i);
         if (real_count < (unsigned int) flag_info -> mMinCount) {
 	    return (FlagCountCheckResult) {
 		.mFlag = flag_info,
 		.mCount = TOO_FEW
 	    };
         }
-        if (flag_info -> mMaxCount >= 0
-	       	&& real_count > (unsigned int) flag_info -> mMaxCount) {
-            return (FlagCountCheckResult) {
-	       .mFlag = flag_info,
-               .mCount = TOO_MANY
-            };		   
-        }
     }
     return (FlagCountCheckResult) {
 	.mFlag = NULL,
@@ -1943,13 +4561,14 @@ static void _cap_parser_check_flag_and_positional_counts(
         const ArgumentParser * parser, ParsingResult * result) {
     // positional argument presence is checked here
     //
-    // if p_count is at least the number of positionals configured in the
-    // parser, it is all good (NB that a case of too-many-arguments is caught
-    // when actually parsing)
-    //
-    // if p_count is less, find the PositionalInfo of the first argument that
-    // was not parsed. If it is required, fail.
-    const size_t p_count = cap_nva_length(result -> mArguments -> mPositionals);
+    // positionals are parsed in order, so it is enough to find the first one
+    // that was not parsed (NB that a case of too-many-arguments is caught
+    // when actually parsing). If it is required, fail.
+    size_t p_count = 0u;
+    while (p_count < parser -> mPositionalCount
+            && cap_pa_has_positional_by_id(result -> mArguments, p_count)) {
+        ++p_count;
+    }
     if (p_count < parser -> mPositionalCount) {
         const PositionalInfo * first_not_parsed = parser -> mPositionals[p_count];
         if (first_not_parsed -> mRequired) {
@@ -1968,13 +4587,13 @@ static void _cap_parser_check_flag_and_positional_counts(
             result -> mError = PER_NOT_ENOUGH_FLAGS;
 	    result -> mFirstErrorWord = count_check.mFlag -> mName;
 	    return; 
-	case TOO_MANY:
-	    result -> mError = PER_TOO_MANY_FLAGS;
-	    result -> mFirstErrorWord = count_check.mFlag -> mName;
-	    return;
 	default:
 	    assert(false && "unreachable in cap_parser_parse_noexit");
     }
+    if (parser -> mSubcommandCount
+            && !cap_pa_get_subcommand(result -> mArguments)) {
+        result -> mError = PER_MISSING_SUBCOMMAND;
+    }
 }
 
 /**
@@ -0,0 +1,505 @@
+#ifndef __PARSER_ITERATOR_H__
+#define __PARSER_ITERATOR_H__
+
+/**
+ * @file
+ * @addtogroup parser
+ *
+ * A `ParserIterator` parses a command line one value at a time. Each call to
+ * `cap_parser_iter_next` yields the next flag or positional argument with its
+ * converted value, in the order of the command line words. No
+ * `ParsedArguments` is built, so the memory used by the iterator does not
+ * depend on the number of words. This suits programs which stream a long list
+ * of inputs straight into processing.
+ *
+ * Words are classified and values are converted exactly like
+ * `cap_parser_parse` does, and the same errors are reported. Errors which
+ * concern the whole command line (missing required flags and positionals) are
+ * reported when the last word was yielded. Values of a variadic `DT_INT` or
+ * `DT_DOUBLE` positional are still converted in batches, and yielded one by
+ * one. Subcommands (see `cap_parser_add_subcommand`) are not supported,
+ * parsers which have them must be used with `cap_parser_parse`.
+ *
+ * ``` c
+ * ParserIterator * iter = cap_parser_iter_begin(parser, argc, argv);
+ * ParsedItem item;
+ * while (cap_parser_iter_next(iter, &item)) {
+ *     if (!item.mIsFlag && item.mId == files_id) {
+ *         process_file(cap_tu_as_string(&(item.mValue)));
+ *     }
+ * }
+ * cap_parser_iter_end(iter);
+ * ```
+ */
+
+#include "allocator.h"
+#include "batch_number_parsing.h"
+#include "flag_info.h"
+#include "parser.h"
+#include "positional_info.h"
+#include "response_file.h"
+#include "typed_union.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @addtogroup parser
+ * @{
+ */
+
+// ============================================================================
+// === PARSER ITERATOR ========================================================
+// ============================================================================
+
+/**
+ * One flag or positional argument yielded by a `ParserIterator`.
+ */
+typedef struct {
+    /// `true` if this is a flag, `false` if it is a positional argument
+    bool mIsFlag;
+    /// id of the flag or positional argument, the same as given by
+    /// `cap_parser_get_flag_id` or `cap_parser_get_positional_id`
+    size_t mId;
+    /// name of the flag (also if it was given by an alias) or positional
+    const char * mName;
+    /// value of the flag or positional. Flags of type `DT_PRESENCE` have
+    /// a presence value. Strings point into the command line words (or into
+    /// response files), they are not copied. Strings read from the input of
+    /// a positional (see `cap_parser_set_positional_input`) are only valid
+    /// until the next item is requested.
+    TypedUnion mValue;
+} ParsedItem;
+
+/**
+ * State of parsing a command line one value at a time.
+ *
+ * Objects of this type are created using `cap_parser_iter_begin` and
+ * destroyed using `cap_parser_iter_end`. Their members should never be
+ * accessed or modified directly.
+ *
+ * @see cap_parser_iter_begin
+ * @see cap_parser_iter_next
+ * @see cap_parser_iter_end
+ */
+typedef struct {
+    const ArgumentParser * mParser;
+    /// program name, for error messages
+    const char * mProgram;
+    _CapWords mWords;
+    /// response files read by the iterator, released by `cap_parser_iter_end`
+    ResponseFile * mResponseFiles;
+    size_t mResponseFileCount;
+    /// error which stopped the iteration, `mArguments` is always `NULL`
+    ParsingResult mResult;
+    /// `true` once the last value was yielded or an error occurred
+    bool mFinished;
+
+    size_t mPositionalIndex;
+    /// `true` if a value was yielded for the current (variadic) positional
+    bool mPositionalFilled;
+    bool mPositionalOnly;
+    /// number of values yielded for each flag
+    size_t * mFlagCounts;
+
+    /// values of a variadic numeric positional converted at once, and the
+    /// position of the next one to yield
+    union {
+        int asInts[_CAP_NUMERIC_CHUNK_SIZE];
+        double asDoubles[_CAP_NUMERIC_CHUNK_SIZE];
+    } mBatch;
+    size_t mBatchCount;
+    size_t mBatchNext;
+
+    /// input of a positional, read once the command line words are parsed
+    _CapInput mInput;
+    bool mInputStarted;
+} ParserIterator;
+
+// ============================================================================
+// === PARSER ITERATOR: DECLARATION OF PRIVATE FUNCTIONS ======================
+// ============================================================================
+
+static bool _cap_iter_fail(
+    ParserIterator * iter, ParsingError error, const char * first_word,
+    const char * second_word);
+static bool _cap_iter_fill_batch(ParserIterator * iter);
+static bool _cap_iter_yield_positional(
+    ParserIterator * iter, TypedUnion value, ParsedItem * item);
+static bool _cap_iter_next_input(ParserIterator * iter);
+static bool _cap_iter_finish(ParserIterator * iter);
+
+// ============================================================================
+// === PARSER ITERATOR: CREATION AND DESTRUCTION ==============================
+// ============================================================================
+
+/**
+ * Starts parsing command line arguments one value at a time.
+ *
+ * Creates an iterator which yields the flags and positional arguments of the
+ * given command line words using `cap_parser_iter_next`. The parser and the
+ * words must stay unchanged while the iterator is used. The caller becomes
+ * the owner of the iterator and should dispose of it using
+ * `cap_parser_iter_end`.
+ *
+ * The iterator does not enter subcommands, so if `parser` has any, the
+ * program exits with an error.
+ *
+ * @param parser parser object to use
+ * @param argc number of command line words
+ * @param argv array of command line words
+ * @return new iterator
+ */
+ParserIterator * cap_parser_iter_begin(
+        const ArgumentParser * parser, int argc, const char ** argv) {
+    if (parser -> mSubcommandCount) {
+        fprintf(
+            stderr, "cap: cannot iterate over a parser with subcommands, use"
+            " cap_parser_parse\n");
+        exit(-1);
+    }
+    const size_t counts_size = parser -> mFlagCount * sizeof(size_t);
+    ParserIterator * iter = (ParserIterator *) cap_malloc(
+        sizeof(ParserIterator) + counts_size);
+    iter -> mParser = parser;
+    iter -> mProgram = argc > 0 ? *argv : NULL;
+    iter -> mFinished = false;
+    iter -> mPositionalIndex = 0u;
+    iter -> mPositionalFilled = false;
+    iter -> mPositionalOnly = false;
+    iter -> mFlagCounts = (size_t *) (iter + 1);
+    memset(iter -> mFlagCounts, 0, counts_size);
+    iter -> mBatchCount = 0u;
+    iter -> mBatchNext = 0u;
+    iter -> mInputStarted = false;
+    // an error opening response files is reported by the first call to
+    // cap_parser_iter_next
+    iter -> mResult = _cap_parser_open_response_files(
+        parser, argc, argv, &(iter -> mResponseFiles),
+        &(iter -> mResponseFileCount));
+    iter -> mWords = _cap_words_make(
+        argc, argv, iter -> mResponseFiles, iter -> mResponseFileCount);
+    return iter;
+}
+
+/**
+ * Destroys an iterator.
+ *
+ * Strings yielded by the iterator from response files become invalid.
+ *
+ * @param iter iterator to destroy. If it is `NULL`, this function does
+ *        nothing.
+ */
+void cap_parser_iter_end(ParserIterator * iter) {
+    if (!iter) {
+        return;
+    }
+    for (size_t i = 0u; i < iter -> mResponseFileCount; ++i) {
+        _cap_rf_close(iter -> mResponseFiles + i);
+    }
+    cap_free(iter -> mResponseFiles);
+    if (iter -> mInputStarted) {
+        _cap_input_destroy(&(iter -> mInput));
+    }
+    cap_free(iter);
+}
+
+// ============================================================================
+// === PARSER ITERATOR: ITERATION =============================================
+// ============================================================================
+
+/**
+ * Yields the next flag or positional argument without exiting on error.
+ *
+ * Stores the next flag or positional argument into `item` and returns
+ * `true`. Returns `false` once all words are parsed, or when an error
+ * occurs. In both cases `cap_parser_iter_result` tells which, and all further
+ * calls return `false` as well.
+ *
+ * @param iter iterator to advance
+ * @param item object to store the flag or positional argument into
+ * @return `true` if `item` was filled
+ */
+bool cap_parser_iter_next_noexit(ParserIterator * iter, ParsedItem * item) {
+    const ArgumentParser * parser = iter -> mParser;
+    if (iter -> mBatchNext < iter -> mBatchCount) {
+        const size_t i = iter -> mBatchNext++;
+        return _cap_iter_yield_positional(
+            iter, parser -> mPositionals[iter -> mPositionalIndex] -> mType
+                == DT_INT
+                ? cap_tu_make_int(iter -> mBatch.asInts[i])
+                : cap_tu_make_double(iter -> mBatch.asDoubles[i]),
+            item);
+    }
+    if (iter -> mFinished) {
+        return false;
+    }
+    if (iter -> mResult.mError != PER_NO_ERROR) {
+        // reported after the values converted before it were yielded
+        iter -> mFinished = true;
+        return false;
+    }
+    _CapWords * words = &(iter -> mWords);
+    while (words -> mWord) {
+        const char * arg = words -> mWord;
+        if (iter -> mPositionalOnly
+                || !parser -> mIsFlagPrefix[(unsigned char) *arg]) {
+            const size_t positional_index = iter -> mPositionalIndex;
+            if (positional_index < parser -> mPositionalCount
+                    && parser -> mPositionals[positional_index] -> mVariadic
+                    && (parser -> mPositionals[positional_index] -> mType
+                        == DT_INT
+                        || parser -> mPositionals[positional_index] -> mType
+                        == DT_DOUBLE)) {
+                // also returns the pending error if no value was converted
+                _cap_iter_fill_batch(iter);
+                return cap_parser_iter_next_noexit(iter, item);
+            }
+            OnePositionalParsingResult one_posit_res =
+                _cap_parser_parse_one_positional(parser, arg, positional_index);
+            const PositionalInfo * posit_info = one_posit_res.mPositional;
+            switch (one_posit_res.mError) {
+                case OPPE_NO_ERROR:
+                    break;
+                case OPPE_TOO_MANY:
+                    return _cap_iter_fail(
+                        iter, PER_TOO_MANY_POSITIONALS, NULL, NULL);
+                case OPPE_CANNOT_PARSE:
+                    return _cap_iter_fail(
+                        iter, PER_CANNOT_PARSE_POSITIONAL,
+                        posit_info -> mName, arg);
+                case OPPE_OUT_OF_RANGE:
+                    return _cap_iter_fail(
+                        iter, PER_POSITIONAL_OUT_OF_RANGE,
+                        posit_info -> mName, arg);
+                default:
+                    assert(false && "unreachable in cap_parser_iter_next");
+            }
+            _cap_words_advance(words);
+            return _cap_iter_yield_positional(
+                iter, one_posit_res.mValue, item);
+        }
+
+        OneFlagParsingResult one_flag_res = _cap_parser_parse_one_flag(
+            parser, words);
+        const FlagInfo * parsed_flag = one_flag_res.mFlag;
+        switch (one_flag_res.mError) {
+            case OFPE_NO_ERROR:
+                break;
+            case OFPE_UNKNOWN_FLAG:
+                return _cap_iter_fail(iter, PER_UNKNOWN_FLAG, arg, NULL);
+            case OFPE_MISSING_FLAG_VALUE:
+                return _cap_iter_fail(iter, PER_MISSING_FLAG_VALUE, arg, NULL);
+            case OFPE_CANNOT_PARSE_FLAG:
+                return _cap_iter_fail(
+                    iter, PER_CANNOT_PARSE_FLAG, arg, words -> mWord);
+            case OFPE_FLAG_OUT_OF_RANGE:
+                return _cap_iter_fail(
+                    iter, PER_FLAG_OUT_OF_RANGE, arg, words -> mWord);
+            default:
+                assert(false && "unreachable in cap_parser_iter_next");
+        }
+        if (parsed_flag == parser -> mFlagSeparatorInfo) {
+            iter -> mPositionalOnly = true;
+            continue;
+        }
+        if (parsed_flag == parser -> mHelpFlagInfo) {
+            return _cap_iter_fail(iter, PER_HELP, NULL, NULL);
+        }
+        const size_t id = one_flag_res.mFlagId;
+        if (parsed_flag -> mMaxCount >= 0
+                && iter -> mFlagCounts[id] >= (size_t) parsed_flag -> mMaxCount) {
+            return _cap_iter_fail(
+                iter, PER_TOO_MANY_FLAGS, parsed_flag -> mName, NULL);
+        }
+        ++iter -> mFlagCounts[id];
+        *item = (ParsedItem) {
+            .mIsFlag = true,
+            .mId = id,
+            .mName = parsed_flag -> mName,
+            .mValue = one_flag_res.mValue
+        };
+        return true;
+    }
+    if (_cap_iter_next_input(iter)) {
+        return cap_parser_iter_next_noexit(iter, item);
+    }
+    if (iter -> mFinished) {
+        return false;
+    }
+    return _cap_iter_finish(iter);
+}
+
+/**
+ * Yields the next flag or positional argument.
+ *
+ * Behaves like `cap_parser_iter_next_noexit`, except that when an error
+ * occurs, the program exits with an error message, or prints help and exits
+ * if the help flag is given, exactly like `cap_parser_parse`.
+ *
+ * @param iter iterator to advance
+ * @param item object to store the flag or positional argument into
+ * @return `true` if `item` was filled, `false` once all words are parsed
+ */
+bool cap_parser_iter_next(ParserIterator * iter, ParsedItem * item) {
+    if (cap_parser_iter_next_noexit(iter, item)) {
+        return true;
+    }
+    if (iter -> mResult.mError != PER_NO_ERROR) {
+        const char * argv[1] = { iter -> mProgram };
+        _cap_parser_finish_parsing(iter -> mParser, iter -> mResult, argv);
+    }
+    return false;
+}
+
+/**
+ * Gets the error which stopped an iterator.
+ *
+ * @param iter iterator to inspect
+ * @return result whose `mError` is `PER_NO_ERROR` unless an error occurred.
+ *         Its `mArguments` is always `NULL`. Error words may point into
+ *         response files, and stay valid until the iterator is destroyed.
+ */
+ParsingResult cap_parser_iter_result(const ParserIterator * iter) {
+    return iter -> mResult;
+}
+
+// ============================================================================
+// === PARSER ITERATOR: IMPLEMENTATION OF PRIVATE FUNCTIONS ===================
+// ============================================================================
+
+static bool _cap_iter_fail(
+        ParserIterator * iter, ParsingError error, const char * first_word,
+        const char * second_word) {
+    iter -> mResult.mError = error;
+    iter -> mResult.mFirstErrorWord = first_word;
+    iter -> mResult.mSecondErrorWord = second_word;
+    iter -> mFinished = true;
+    return false;
+}
+
+static bool _cap_iter_fill_batch(ParserIterator * iter) {
+    // converts the next chunk of words of the current (variadic, numeric)
+    // positional. If a word cannot be converted, the error is stored and
+    // reported once the values before it are yielded.
+    const ArgumentParser * parser = iter -> mParser;
+    const PositionalInfo * posit_info
+        = parser -> mPositionals[iter -> mPositionalIndex];
+    _CapWords * words = &(iter -> mWords);
+    const char * chunk[_CAP_NUMERIC_CHUNK_SIZE];
+    // a chunk ends with the buffer holding its words
+    const char * const limit = words -> mFileEnd;
+    size_t count = 0u;
+    while (words -> mWord && count < _CAP_NUMERIC_CHUNK_SIZE
+            && words -> mFileEnd == limit
+            && (iter -> mPositionalOnly
+                || !parser -> mIsFlagPrefix[(unsigned char) *words -> mWord])) {
+        chunk[count++] = words -> mWord;
+        _cap_words_advance(words);
+    }
+    WordConversionResult conversion;
+    iter -> mBatchNext = 0u;
+    iter -> mBatchCount = posit_info -> mType == DT_INT
+        ? _cap_parse_int_batch(
+            chunk, count, limit, iter -> mBatch.asInts, &conversion)
+        : _cap_parse_double_batch(
+            chunk, count, limit, iter -> mBatch.asDoubles, &conversion);
+    if (iter -> mBatchCount < count) {
+        iter -> mResult.mError = conversion == WCR_OUT_OF_RANGE
+            ? PER_POSITIONAL_OUT_OF_RANGE
+            : PER_CANNOT_PARSE_POSITIONAL;
+        iter -> mResult.mFirstErrorWord = posit_info -> mName;
+        iter -> mResult.mSecondErrorWord = chunk[iter -> mBatchCount];
+        return false;
+    }
+    return true;
+}
+
+static bool _cap_iter_yield_positional(
+        ParserIterator * iter, TypedUnion value, ParsedItem * item) {
+    const PositionalInfo * posit_info
+        = iter -> mParser -> mPositionals[iter -> mPositionalIndex];
+    *item = (ParsedItem) {
+        .mIsFlag = false,
+        .mId = iter -> mPositionalIndex,
+        .mName = posit_info -> mName,
+        .mValue = value
+    };
+    if (posit_info -> mVariadic) {
+        iter -> mPositionalFilled = true;
+    }
+    else {
+        ++iter -> mPositionalIndex;
+    }
+    return true;
+}
+
+static bool _cap_iter_next_input(ParserIterator * iter) {
+    // makes the next records of the input the current words, once the
+    // command line words are parsed. Returns `false` at the end of the input
+    // or on error.
+    const ArgumentParser * parser = iter -> mParser;
+    if (parser -> mInputFd < 0) {
+        return false;
+    }
+    const size_t id = parser -> mInputPositional;
+    if (!iter -> mInputStarted) {
+        // records are values of the positional reading input, so the
+        // positionals before it are complete
+        for (size_t i = iter -> mPositionalIndex + iter -> mPositionalFilled;
+                i < id; ++i) {
+            if (parser -> mPositionals[i] -> mRequired) {
+                return _cap_iter_fail(
+                    iter, PER_NOT_ENOUGH_POSITIONALS, NULL, NULL);
+            }
+        }
+        if (iter -> mPositionalIndex != id) {
+            iter -> mPositionalIndex = id;
+            iter -> mPositionalFilled = false;
+        }
+        iter -> mPositionalOnly = true;
+        _cap_input_init(
+            &(iter -> mInput), parser -> mInputFd, parser -> mInputDelimiter);
+        iter -> mInputStarted = true;
+    }
+    if (_cap_input_next(&(iter -> mInput), &(iter -> mWords))) {
+        return true;
+    }
+    if (iter -> mInput.mFailed) {
+        return _cap_iter_fail(
+            iter, PER_CANNOT_READ_INPUT, parser -> mPositionals[id] -> mName,
+            NULL);
+    }
+    return false;
+}
+
+static bool _cap_iter_finish(ParserIterator * iter) {
+    // checks the required counts once all words are parsed, like
+    // _cap_parser_check_flag_and_positional_counts
+    const ArgumentParser * parser = iter -> mParser;
+    iter -> mFinished = true;
+    const size_t first_not_parsed
+        = iter -> mPositionalIndex + iter -> mPositionalFilled;
+    if (first_not_parsed < parser -> mPositionalCount
+            && parser -> mPositionals[first_not_parsed] -> mRequired) {
+        return _cap_iter_fail(iter, PER_NOT_ENOUGH_POSITIONALS, NULL, NULL);
+    }
+    for (size_t i = 0u; i < parser -> mFlagCount; ++i) {
+        const FlagInfo * flag_info = parser -> mFlags[i];
+        if (iter -> mFlagCounts[i] < (size_t) flag_info -> mMinCount) {
+            return _cap_iter_fail(
+                iter, PER_NOT_ENOUGH_FLAGS, flag_info -> mName, NULL);
+        }
+    }
+    return false;
+}
+
+/**
+ * @}
+ */
+
+#endif
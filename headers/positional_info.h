@@ -3,6 +3,7 @@
 
 /** @file */
 
+#include "allocator.h"
 #include "data_type.h"
 #include "helper_functions.h"
 #include "typed_union.h"
@@ -24,6 +25,12 @@ typedef struct {
     DataType mType;
     bool mRequired;
     bool mVariadic;
+    /// if `true`, all strings are borrowed from the caller and are not
+    /// released
+    bool mStaticStrings;
+    /// supplies the description instead of `mDescription`, or `NULL`
+    DescriptionProvider mDescriptionProvider;
+    void * mDescriptionContext;
 } PositionalInfo;
 
 /**
@@ -64,20 +71,27 @@ const char * cap_get_posit_metavar(const PositionalInfo * pi) {
  * @param type data type of this argument
  * @param required if the positional is required
  * @param variadic if the positional is variadic (can take multiple values)
+ * @param static_strings if `true`, the strings are not copied, the object
+ *        stores the given pointers instead. The strings must then outlive it.
  * @return a new PositionalInfo object
  */
 PositionalInfo * cap_positional_info_make(
     const char * name, const char * meta_var, const char * description,
-    DataType type, bool required, bool variadic)
+    DataType type, bool required, bool variadic, bool static_strings)
 {
-    PositionalInfo * info = (PositionalInfo *) malloc(sizeof(PositionalInfo));
+    PositionalInfo * info = (PositionalInfo *) cap_malloc(sizeof(PositionalInfo));
+    // borrowed strings are never modified, nor released
     *info = (PositionalInfo) {
-        .mName = copy_string(name),
-	.mMetaVar = copy_string(meta_var),
-	.mDescription = copy_string(description),
+        .mName = static_strings ? (char *) name : copy_string(name),
+	.mMetaVar = static_strings ? (char *) meta_var : copy_string(meta_var),
+	.mDescription = static_strings
+            ? (char *) description : copy_string(description),
 	.mType = type,
     .mRequired = required,
     .mVariadic = variadic,
+    .mStaticStrings = static_strings,
+    .mDescriptionProvider = NULL,
+    .mDescriptionContext = NULL
     };
     return info;
 }
@@ -94,10 +108,12 @@ void cap_positional_info_destroy(PositionalInfo * info) {
     if (!info) {
         return;
     }
-    delete_string_property(&(info -> mName));
-    delete_string_property(&(info -> mMetaVar));
-    delete_string_property(&(info -> mDescription));
-    free(info);
+    if (!info -> mStaticStrings) {
+        delete_string_property(&(info -> mName));
+        delete_string_property(&(info -> mMetaVar));
+        delete_string_property(&(info -> mDescription));
+    }
+    cap_free(info);
 }
 
 /**
@@ -112,8 +128,34 @@ void cap_positional_info_destroy(PositionalInfo * info) {
 void cap_print_positional_info(
         FILE * file, const PositionalInfo * info) {
     fprintf(file, "%s\n", cap_get_posit_metavar(info));
-    if (info -> mDescription) {
-        fprintf(file, "\t%s\n", info -> mDescription);
+    const char * description = cap_describe(
+        info -> mDescription, info -> mDescriptionProvider,
+        info -> mDescriptionContext);
+    if (description) {
+        fprintf(file, "\t%s\n", description);
+    }
+}
+
+/**
+ * Display a positional info object.
+ *
+ * Appends a PositionalInfo to a given text buffer, in the same format as
+ * `cap_print_positional_info`.
+ *
+ * @param text buffer to display into
+ * @info object to display
+ */
+void cap_format_positional_info(
+        TextBuffer * text, const PositionalInfo * info) {
+    cap_text_append_string(text, cap_get_posit_metavar(info));
+    cap_text_append_char(text, '\n');
+    const char * description = cap_describe(
+        info -> mDescription, info -> mDescriptionProvider,
+        info -> mDescriptionContext);
+    if (description) {
+        cap_text_append_char(text, '\t');
+        cap_text_append_string(text, description);
+        cap_text_append_char(text, '\n');
     }
 }
 
@@ -0,0 +1,338 @@
+#ifndef __RESPONSE_FILE_H__
+#define __RESPONSE_FILE_H__
+
+/**
+ * @file
+ * @defgroup response_file Response Files
+ *
+ * A response file contains command line words, and is named on the command
+ * line as `@path`. When enabled using `cap_parser_enable_response_files`, the
+ * parser reads the words of such files in place of the `@path` argument.
+ * Users of the library never need to use a `ResponseFile` directly.
+ *
+ * The file is memory-mapped (or read into memory on systems without `mmap`)
+ * and split into words in place, in a single pass over its contents:
+ * - If it contains a null character, words are delimited by null characters,
+ *   like the output of `find -print0`. No quoting is applied then. Splitting
+ *   stops at the first null character, and the bytes before it, which were
+ *   already split, are read from the file again.
+ * - Otherwise words are delimited by whitespace. Single quotes preserve
+ *   everything up to the next single quote, double quotes everything up to
+ *   the next double quote except that `\"` and `\\` are escapes, and
+ *   a backslash outside of quotes escapes the following character.
+ *
+ * The words are stored consecutively, each followed by a null character, in
+ * the private copy-on-write mapping. They are never copied, and the parser
+ * reads them directly from there.
+ */
+
+#include "allocator.h"
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define _CAP_POSIX 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @addtogroup response_file
+ * @{
+ */
+
+// ============================================================================
+// === RESPONSE FILE ==========================================================
+// ============================================================================
+
+/**
+ * Words of a response file, read for one argument of a command line.
+ */
+typedef struct {
+    /// argument which named the file, including the `@`
+    const char * mArgument;
+    /// index of that argument on the command line
+    int mIndex;
+    /// contents of the file, a sequence of null-terminated words once it is
+    /// split
+    char * mData;
+    /// end of the last word (after its terminating null character)
+    const char * mWordsEnd;
+    /// size of the mapping at `mData`, or zero if the contents were read into
+    /// memory allocated using `cap_malloc`
+    size_t mMapSize;
+} ResponseFile;
+
+/**
+ * Reasons why a response file cannot be used.
+ */
+typedef enum {
+    /// the file was read
+    RFE_NO_ERROR,
+    /// the file cannot be opened or read
+    RFE_CANNOT_READ,
+    /// a quote is not closed
+    RFE_UNTERMINATED_QUOTE
+} ResponseFileError;
+
+/// classes of characters when splitting a file: whitespace (the same as
+/// `isspace` in the "C" locale) is 1, quotes, backslashes and null
+/// characters are 2
+static const unsigned char _CAP_RF_CHAR_CLASS[256] = {
+    [' '] = 1u, ['\t'] = 1u, ['\n'] = 1u, ['\v'] = 1u, ['\f'] = 1u,
+    ['\r'] = 1u, ['\''] = 2u, ['"'] = 2u, ['\\'] = 2u, ['\0'] = 2u
+};
+
+// ============================================================================
+// === RESPONSE FILE: DECLARATION OF PRIVATE FUNCTIONS ========================
+// ============================================================================
+
+static ResponseFileError _cap_rf_open(
+    ResponseFile * file, const char * argument, int index);
+static void _cap_rf_close(ResponseFile * file);
+static bool _cap_rf_contains(const ResponseFile * file, const char * word);
+static bool _cap_rf_read(ResponseFile * file, const char * path, size_t * size);
+static ResponseFileError _cap_rf_split(ResponseFile * file, size_t size);
+static bool _cap_rf_split_quoted(
+    char * data, size_t size, char ** words_end, const char ** null_char);
+static bool _cap_rf_restore(const ResponseFile * file, size_t size);
+static long _cap_rf_read_fd(int fd, char * buffer, size_t size);
+
+// ============================================================================
+// === RESPONSE FILE: IMPLEMENTATION OF PRIVATE FUNCTIONS =====================
+// ============================================================================
+
+static ResponseFileError _cap_rf_open(
+        ResponseFile * file, const char * argument, int index) {
+    // reads and splits the file named by `argument` ("@path")
+    *file = (ResponseFile) {
+        .mArgument = argument,
+        .mIndex = index,
+        .mData = NULL,
+        .mWordsEnd = NULL,
+        .mMapSize = 0u
+    };
+    size_t size;
+    if (!_cap_rf_read(file, argument + 1, &size)) {
+        return RFE_CANNOT_READ;
+    }
+    const ResponseFileError error = _cap_rf_split(file, size);
+    if (error != RFE_NO_ERROR) {
+        _cap_rf_close(file);
+    }
+    return error;
+}
+
+static void _cap_rf_close(ResponseFile * file) {
+#if defined(_CAP_POSIX)
+    if (file -> mMapSize) {
+        munmap(file -> mData, file -> mMapSize);
+        file -> mData = NULL;
+        return;
+    }
+#endif
+    cap_free(file -> mData);
+    file -> mData = NULL;
+}
+
+static bool _cap_rf_contains(const ResponseFile * file, const char * word) {
+    // if `word` is one of the words of `file`
+    return file -> mData && word
+        && word >= file -> mData && word < file -> mWordsEnd;
+}
+
+static bool _cap_rf_read(
+        ResponseFile * file, const char * path, size_t * size) {
+    // the contents are followed by at least one null character, so that the
+    // last word can be terminated in place
+#if defined(_CAP_POSIX)
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat status;
+    if (fstat(fd, &status) || !S_ISREG(status.st_mode)) {
+        close(fd);
+        return false;
+    }
+    *size = (size_t) status.st_size;
+    const size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    // the rest of the last page is filled with zeros. If there is no rest,
+    // the file is read instead.
+    if (*size % page) {
+        void * data = mmap(
+            NULL, *size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            close(fd);
+            file -> mData = (char *) data;
+            file -> mMapSize = *size;
+            return true;
+        }
+    }
+    close(fd);
+#endif
+    FILE * stream = fopen(path, "rb");
+    if (!stream) {
+        return false;
+    }
+    size_t alloc = 4096u;
+    char * data = (char *) cap_malloc(alloc);
+    *size = 0u;
+    size_t read;
+    while ((read = fread(data + *size, 1u, alloc - *size - 1u, stream))) {
+        *size += read;
+        if (alloc - *size == 1u) {
+            alloc *= 2u;
+            data = (char *) cap_realloc(data, alloc);
+        }
+    }
+    const bool failed = ferror(stream);
+    fclose(stream);
+    if (failed) {
+        cap_free(data);
+        return false;
+    }
+    data[*size] = '\0';
+    file -> mData = data;
+    return true;
+}
+
+static ResponseFileError _cap_rf_split(ResponseFile * file, size_t size) {
+    // splits the contents into null-terminated words in place
+    char * const data = file -> mData;
+    char * words_end = data;
+    const char * null_char;
+    const bool split = _cap_rf_split_quoted(
+        data, size, &words_end, &null_char);
+    if (!null_char) {
+        file -> mWordsEnd = words_end;
+        return split ? RFE_NO_ERROR : RFE_UNTERMINATED_QUOTE;
+    }
+    // the words are delimited by null characters instead, so quotes do not
+    // matter. They are terminated already, except for the last one which is
+    // followed by the padding, but the ones before the first null character
+    // were split.
+    const size_t split_size = (size_t) (null_char - data);
+    if (split_size && !_cap_rf_restore(file, split_size)) {
+        return RFE_CANNOT_READ;
+    }
+    file -> mWordsEnd = data + size + (data[size - 1u] != '\0');
+    return RFE_NO_ERROR;
+}
+
+static bool _cap_rf_split_quoted(
+        char * data, size_t size, char ** words_end, const char ** null_char) {
+    // splits `size` bytes at `data` into null-terminated words in place, at
+    // whitespace and applying quotes. `data[size]` must be writable. Returns
+    // `false` if a quote is not closed. The data ends early at the first null
+    // character, whose position is stored in `null_char` (`NULL` if there is
+    // none).
+    const char * r = data;
+    const char * end = data + size;
+    char * w = data;
+    *null_char = NULL;
+    while (true) {
+        while (r < end && _CAP_RF_CHAR_CLASS[(unsigned char) *r] == 1u) {
+            ++r;
+        }
+        if (r < end && !*r) {
+            *null_char = end = r;
+        }
+        if (r == end) {
+            break;
+        }
+        while (true) {
+            // runs of plain characters are only moved once a quote or
+            // a backslash was removed before them
+            const char * plain = r;
+            while (r < end && !_CAP_RF_CHAR_CLASS[(unsigned char) *r]) {
+                ++r;
+            }
+            if (w != plain) {
+                memmove(w, plain, (size_t) (r - plain));
+            }
+            w += r - plain;
+            if (r < end && !*r) {
+                *null_char = end = r;
+            }
+            if (r == end || _CAP_RF_CHAR_CLASS[(unsigned char) *r] == 1u) {
+                break;
+            }
+            if (*r == '\\') {
+                if (++r < end && !*r) {
+                    *null_char = end = r;
+                }
+                *w++ = r < end ? *r++ : '\\';
+                continue;
+            }
+            const char quote = *r++;
+            while (r < end && *r != quote) {
+                if (!*r) {
+                    *null_char = end = r;
+                    break;
+                }
+                if (quote == '"' && *r == '\\' && r + 1 < end
+                        && (r[1] == '"' || r[1] == '\\')) {
+                    ++r;
+                }
+                *w++ = *r++;
+            }
+            if (r == end) {
+                return false;
+            }
+            ++r;
+        }
+        // the delimiter is consumed first, `w` may point to it
+        if (r < end) {
+            ++r;
+        }
+        *w++ = '\0';
+    }
+    *words_end = w;
+    return true;
+}
+
+static bool _cap_rf_restore(const ResponseFile * file, size_t size) {
+    // reads the first `size` bytes of the file into `mData` again, after
+    // splitting changed them
+    FILE * stream = fopen(file -> mArgument + 1, "rb");
+    if (!stream) {
+        return false;
+    }
+    const bool restored = fread(file -> mData, 1u, size, stream) == size;
+    fclose(stream);
+    return restored;
+}
+
+static long _cap_rf_read_fd(int fd, char * buffer, size_t size) {
+    // reads up to `size` bytes from a file descriptor. Returns the number of
+    // bytes read, zero at the end of the input, or -1 if it cannot be read.
+#if defined(_CAP_POSIX)
+    while (true) {
+        const ssize_t read_size = read(fd, buffer, size);
+        if (read_size >= 0) {
+            return (long) read_size;
+        }
+        if (errno != EINTR) {
+            return -1;
+        }
+    }
+#else
+    (void) fd;
+    (void) buffer;
+    (void) size;
+    return -1;
+#endif
+}
+
+/**
+ * @}
+ */
+
+#endif
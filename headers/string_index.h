@@ -0,0 +1,332 @@
+#ifndef __STRING_INDEX_H__
+#define __STRING_INDEX_H__
+
+/**
+ * @file
+ *
+ * `StringIndex` is a hash table which maps null-terminated strings to `size_t`
+ * values. It is used internally, e.g. by `ArgumentParser` to look up flags by
+ * their names and aliases in constant time on average. Users of the library
+ * never need to interact with it directly. Functions related to this type are
+ * prefixed with `cap_si_`.
+ *
+ * The index does not own its keys. Every key must remain valid (and must not
+ * be modified) for as long as it is stored in the index. Typically, keys are
+ * strings owned by the same object which owns the index.
+ *
+ * An index can be backed by an `Arena`, in which case it is allocated from
+ * the arena and released together with it.
+ */
+
+#include "arena.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// === STRING INDEX ===========================================================
+// ============================================================================
+
+/**
+ * A single entry of a `StringIndex`.
+ *
+ * A slot is empty if its key is `NULL`.
+ */
+typedef struct {
+    /// borrowed key, or `NULL` if the slot is empty
+    const char * mKey;
+    /// cached hash of `mKey`
+    size_t mHash;
+    /// value associated with `mKey`
+    size_t mValue;
+} StringIndexSlot;
+
+/**
+ * Hash table mapping null-terminated strings to `size_t` values.
+ *
+ * Collisions are resolved using linear probing. The number of slots is always
+ * zero or a power of two.
+ */
+typedef struct {
+    StringIndexSlot * mSlots;
+    size_t mCount;
+    size_t mAlloc;
+    /// arena which owns the index, or `NULL` if it is allocated on the heap
+    Arena * mArena;
+} StringIndex;
+
+// ============================================================================
+// === STRING INDEX: DECLARATION OF PRIVATE FUNCTIONS =========================
+// ============================================================================
+
+static size_t _cap_si_hash(const char * key);
+static size_t _cap_si_find_slot(
+    const StringIndex * si, const char * key, size_t hash);
+static size_t _cap_si_slots_for(size_t alloc, size_t count);
+static void _cap_si_resize(StringIndex * si, size_t alloc);
+
+// ============================================================================
+// === STRING INDEX FUNCTIONS =================================================
+// ============================================================================
+
+/**
+ * Creates a new empty `StringIndex` backed by an arena.
+ *
+ * The index and its slots are allocated from `arena`. The index is released
+ * when the arena is destroyed, `cap_si_destroy` may still be called but has
+ * no effect.
+ *
+ * @param arena arena to allocate from. If it is `NULL`, this is equivalent to
+ *        `cap_si_make_empty()`.
+ * @return new object
+ */
+StringIndex * cap_si_make_in(Arena * arena) {
+    StringIndex * si = (StringIndex *) cap_arena_alloc(
+        arena, sizeof(StringIndex));
+    *si = (StringIndex) {
+        .mSlots = NULL,
+        .mCount = 0u,
+        .mAlloc = 0u,
+        .mArena = arena
+    };
+    return si;
+}
+
+/**
+ * Creates a new empty `StringIndex`.
+ *
+ * The caller becomes the owner of the new object and should dispose of it
+ * using `cap_si_destroy`.
+ *
+ * @return new object
+ */
+StringIndex * cap_si_make_empty() {
+    return cap_si_make_in(NULL);
+}
+
+/**
+ * Destroys a `StringIndex`.
+ *
+ * Deallocates the index. Keys stored in it are not owned by the index, so they
+ * are not affected.
+ *
+ * @param si object to destroy. If it is `NULL`, nothing happens.
+ */
+void cap_si_destroy(StringIndex * si) {
+    if (!si) {
+        return;
+    }
+    cap_arena_free(si -> mArena, si -> mSlots);
+    cap_arena_free(si -> mArena, si);
+}
+
+/**
+ * Reserves space for keys.
+ *
+ * Makes sure that `count` keys can be stored in `si` without growing it. 
+ *
+ * @param si object to modify. If it is `NULL`, nothing happens.
+ * @param count number of keys to make room for
+ */
+void cap_si_reserve(StringIndex * si, size_t count) {
+    if (!si || !count) {
+        return;
+    }
+    const size_t alloc = _cap_si_slots_for(si -> mAlloc, count);
+    if (alloc != si -> mAlloc) {
+        _cap_si_resize(si, alloc);
+    }
+}
+
+/**
+ * Gets the number of bytes allocated for the slots of an index.
+ *
+ * Computes how many bytes are allocated for slots when `cap_si_reserve` is 
+ * called with `count` on an empty index.
+ *
+ * @param count number of keys to make room for
+ * @return size of the slot array in bytes
+ */
+size_t cap_si_reserved_size(size_t count) {
+    if (!count) {
+        return 0u;
+    }
+    return _cap_si_slots_for(0u, count) * sizeof(StringIndexSlot);
+}
+
+/**
+ * Gets the number of keys stored in a `StringIndex`.
+ *
+ * @param si object to measure
+ * @return number of keys, or zero if `si` is `NULL`
+ */
+size_t cap_si_length(const StringIndex * si) {
+    if (!si) {
+        return 0u;
+    }
+    return si -> mCount;
+}
+
+/**
+ * Looks up a key.
+ *
+ * Finds the value associated with `key`. If it is found and `value` is not
+ * `NULL`, the value is stored into `*value`.
+ *
+ * @param si object to search
+ * @param key null-terminated key to look for
+ * @param value output parameter for the found value, may be `NULL`
+ * @return `true` if `key` is stored in `si`. If `si` or `key` are `NULL`,
+ *         returns `false`.
+ */
+bool cap_si_find(const StringIndex * si, const char * key, size_t * value) {
+    if (!si || !key || !si -> mCount) {
+        return false;
+    }
+    const size_t slot = _cap_si_find_slot(si, key, _cap_si_hash(key));
+    const StringIndexSlot * s = si -> mSlots + slot;
+    if (!s -> mKey) {
+        return false;
+    }
+    if (value) {
+        *value = s -> mValue;
+    }
+    return true;
+}
+
+/**
+ * Associates a key with a value.
+ *
+ * Stores `key` in `si` with `value`. If `key` is already present, its value is
+ * replaced. Only the pointer `key` is stored, so the string must outlive its
+ * entry in the index.
+ *
+ * @param si object to insert into. If it is `NULL`, nothing happens.
+ * @param key null-terminated key. If it is `NULL`, nothing happens.
+ * @param value value to associate with `key`
+ */
+void cap_si_insert(StringIndex * si, const char * key, size_t value) {
+    if (!si || !key) {
+        return;
+    }
+    // keep the load factor below 0.7
+    if ((si -> mCount + 1u) * 10u > si -> mAlloc * 7u) {
+        cap_si_reserve(si, si -> mCount + 1u);
+    }
+    const size_t hash = _cap_si_hash(key);
+    StringIndexSlot * s = si -> mSlots + _cap_si_find_slot(si, key, hash);
+    if (!s -> mKey) {
+        ++si -> mCount;
+    }
+    *s = (StringIndexSlot) { .mKey = key, .mHash = hash, .mValue = value };
+}
+
+/**
+ * Removes a key.
+ *
+ * Removes `key` and its value from `si`. If the key is not present, nothing
+ * happens.
+ *
+ * @param si object to remove from
+ * @param key null-terminated key to remove
+ */
+void cap_si_remove(StringIndex * si, const char * key) {
+    if (!si || !key || !si -> mCount) {
+        return;
+    }
+    const size_t mask = si -> mAlloc - 1u;
+    size_t hole = _cap_si_find_slot(si, key, _cap_si_hash(key));
+    if (!si -> mSlots[hole].mKey) {
+        return;
+    }
+    // backward-shift deletion: move following entries of the same probe
+    // sequence into the hole so that no tombstones are needed
+    size_t i = hole;
+    while (true) {
+        i = (i + 1u) & mask;
+        const StringIndexSlot * s = si -> mSlots + i;
+        if (!s -> mKey) {
+            break;
+        }
+        const size_t home = s -> mHash & mask;
+        // the entry may only move if its home slot is not in (hole, i]
+        const bool stays = hole <= i
+            ? (hole < home && home <= i)
+            : (hole < home || home <= i);
+        if (stays) {
+            continue;
+        }
+        si -> mSlots[hole] = *s;
+        hole = i;
+    }
+    si -> mSlots[hole].mKey = NULL;
+    --si -> mCount;
+}
+
+// ============================================================================
+// === STRING INDEX: IMPLEMENTATION OF PRIVATE FUNCTIONS ======================
+// ============================================================================
+
+static size_t _cap_si_hash(const char * key) {
+    // 64-bit FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (const unsigned char * c = (const unsigned char *) key; *c; ++c) {
+        hash ^= *c;
+        hash *= 1099511628211ull;
+    }
+    return (size_t) (hash ^ (hash >> 32));
+}
+
+static size_t _cap_si_find_slot(
+        const StringIndex * si, const char * key, size_t hash) {
+    // returns the slot containing `key`, or the empty slot where it belongs
+    const size_t mask = si -> mAlloc - 1u;
+    size_t i = hash & mask;
+    while (true) {
+        const StringIndexSlot * s = si -> mSlots + i;
+        if (!s -> mKey) {
+            return i;
+        }
+        if (s -> mHash == hash && !strcmp(s -> mKey, key)) {
+            return i;
+        }
+        i = (i + 1u) & mask;
+    }
+}
+
+static size_t _cap_si_slots_for(size_t alloc, size_t count) {
+    static const size_t INIT_ALLOC = 16u;
+    alloc = alloc ? alloc : INIT_ALLOC;
+    // keep the load factor below 0.7
+    while (count * 10u > alloc * 7u) {
+        alloc *= 2u;
+    }
+    return alloc;
+}
+
+static void _cap_si_resize(StringIndex * si, size_t alloc) {
+    const size_t old_alloc = si -> mAlloc;
+    StringIndexSlot * old_slots = si -> mSlots;
+
+    si -> mAlloc = alloc;
+    si -> mSlots = (StringIndexSlot *) cap_arena_alloc(
+        si -> mArena, alloc * sizeof(StringIndexSlot));
+    memset(si -> mSlots, 0, alloc * sizeof(StringIndexSlot));
+    for (size_t i = 0u; i < old_alloc; ++i) {
+        const StringIndexSlot * s = old_slots + i;
+        if (!s -> mKey) {
+            continue;
+        }
+        size_t j = s -> mHash & (si -> mAlloc - 1u);
+        while (si -> mSlots[j].mKey) {
+            j = (j + 1u) & (si -> mAlloc - 1u);
+        }
+        si -> mSlots[j] = *s;
+    }
+    cap_arena_free(si -> mArena, old_slots);
+}
+
+#endif
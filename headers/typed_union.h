@@ -33,6 +33,7 @@
  * `cap_tu_as_double()` (to return the stored `double` value.)
  */
 
+#include "allocator.h"
 #include "data_type.h"
 #include "helper_functions.h"
 
@@ -146,7 +147,7 @@ void cap_tu_destroy(TypedUnion * tu) {
     if (tu -> mType != DT_STRING) {
         return;
     }
-    free(tu -> mValue.asString);
+    cap_free(tu -> mValue.asString);
     tu -> mValue.asString = NULL;
 }
 
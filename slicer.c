@@ -52,7 +52,7 @@ void insert_if_not_present(
     // now we are adding something, so must check allocation size
     if (*i_count >= *i_alloc) {
         *i_alloc = (*i_alloc) * 2;
-        *i_s = (const char **) realloc(*i_s, *i_alloc);
+        *i_s = (const char **) realloc(*i_s, *i_alloc * sizeof(const char *));
     }
     // insert new name into list
     const char * to_insert = i_name;
@@ -77,6 +77,7 @@ void extract_includes(
             exit(-1);
         }
         char line_buffer[LINE_BUFFER_SIZE];
+        int preprocessor_if_depth = 0;
         while (true) {
             // this is a dirty trick, but, since I am dealing with code written
             // by people the length of a line can be assumed less than
@@ -92,6 +93,17 @@ void extract_includes(
                 break;
             }
 
+            if (strncmp("#if", line_buffer, 3) == 0) {
+                ++preprocessor_if_depth;
+            }
+            if (strncmp("#endif", line_buffer, 6) == 0) {
+                --preprocessor_if_depth;
+            }
+            // includes inside of conditional blocks (other than the include
+            // guard) stay where they are
+            if (preprocessor_if_depth > 1) {
+                continue;
+            }
             const char * i_name = obtain_system_include(line_buffer);
             if (!i_name) {
                 continue;
@@ -146,7 +158,8 @@ void dump_files_without_includes(
                 continue;
             }
 
-            if (strncmp("#include", line_buffer, 8) == 0) {
+            if (strncmp("#include", line_buffer, 8) == 0
+                    && preprocessor_if_depth <= 1) {
                 continue;
             }
             if (strncmp("#if", line_buffer, 3) == 0) {
@@ -2,12 +2,33 @@
 #define __COMMON_H__
 
 #include <stdbool.h>
+#include <stddef.h>
 
 #define TEST_GROUP(name, fail_fast, quiet, ...) (test_group((name), (fail_fast), (quiet), __VA_ARGS__, NULL))
 
 #define FB(variable) { variable = true; break; }
 
+/**
+ * An `Allocator` which counts calls into `counters` (a `TestCounters *`),
+ * only usable where cap.h is included.
+ */
+#define TEST_COUNTING_ALLOCATOR(counters) ((Allocator) { \
+    test_counting_alloc, test_counting_realloc, test_counting_free, (counters) })
+
+/**
+ * Statistics gathered by the counting allocator.
+ */
+typedef struct {
+    size_t mAllocations;
+    size_t mFrees;
+    size_t mLiveBytes;
+} TestCounters;
+
 bool test_group(const char * name, bool fail_fast, bool quiet, ...);
 bool test_single(bool quiet, bool (*test_function)());
 
+void * test_counting_alloc(size_t size, void * context);
+void * test_counting_realloc(void * memory, size_t size, void * context);
+void test_counting_free(void * memory, void * context);
+
 #endif
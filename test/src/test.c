@@ -3,6 +3,13 @@
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
+
+// every block is prefixed with its size, so that freed bytes can be counted
+typedef union {
+    size_t mSize;
+    long double mAlign;
+} BlockHeader;
 
 bool test_group(const char * name, bool fail_fast, bool quiet,  ...) {
     if (!quiet) {
@@ -46,3 +53,34 @@ bool test_single(bool quiet, bool (*test_function)()) {
     }
     return s;
 }
+
+void * test_counting_alloc(size_t size, void * context) {
+    TestCounters * counters = (TestCounters *) context;
+    BlockHeader * block = (BlockHeader *) malloc(sizeof(BlockHeader) + size);
+    block -> mSize = size;
+    ++counters -> mAllocations;
+    counters -> mLiveBytes += size;
+    return block + 1;
+}
+
+void * test_counting_realloc(void * memory, size_t size, void * context) {
+    TestCounters * counters = (TestCounters *) context;
+    if (!memory) {
+        return test_counting_alloc(size, context);
+    }
+    BlockHeader * block = (BlockHeader *) memory - 1;
+    counters -> mLiveBytes -= block -> mSize;
+    block = (BlockHeader *) realloc(block, sizeof(BlockHeader) + size);
+    block -> mSize = size;
+    ++counters -> mAllocations;
+    counters -> mLiveBytes += size;
+    return block + 1;
+}
+
+void test_counting_free(void * memory, void * context) {
+    TestCounters * counters = (TestCounters *) context;
+    BlockHeader * block = (BlockHeader *) memory - 1;
+    ++counters -> mFrees;
+    counters -> mLiveBytes -= block -> mSize;
+    free(block);
+}
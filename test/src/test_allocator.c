@@ -0,0 +1,113 @@
+#include "cap.h"
+#include "test.h"
+
+#include <string.h>
+
+static void _install(TestCounters * counters) {
+    *counters = (TestCounters) { 0u, 0u, 0u };
+    const Allocator allocator = TEST_COUNTING_ALLOCATOR(counters);
+    cap_allocator_set(&allocator);
+}
+
+static ArgumentParser * _make_parser(bool exact) {
+    ArgumentParser * p = cap_parser_make_default();
+    cap_parser_enable_exact_allocation(p, exact);
+    cap_parser_set_description(p, "counts allocations");
+    cap_parser_add_flag(p, "--name", DT_STRING, 0, -1, NULL, NULL);
+    cap_parser_add_flag_alias(p, "--name", "-n");
+    cap_parser_add_flag(p, "--level", DT_INT, 0, 1, NULL, NULL);
+    cap_parser_add_positional(p, "files", DT_STRING, true, true, NULL, NULL);
+    return p;
+}
+
+/**
+ * Test that the installed allocator can be queried and reset.
+ */
+bool test_allocator_install() {
+    TestCounters counters;
+    bool failed = false;
+    do {
+        if (cap_allocator_get().mContext) FB(failed);
+        _install(&counters);
+        Allocator allocator = cap_allocator_get();
+        if (allocator.mAlloc != test_counting_alloc) FB(failed);
+        if (allocator.mContext != &counters) FB(failed);
+        cap_allocator_set(NULL);
+        allocator = cap_allocator_get();
+        if (allocator.mAlloc == test_counting_alloc) FB(failed);
+        if (allocator.mContext) FB(failed);
+        // the default allocator still works
+        void * memory = cap_malloc(16u);
+        if (!memory) FB(failed);
+        cap_free(memory);
+    } while (false);
+    cap_allocator_set(NULL);
+    return !failed;
+}
+
+/**
+ * Test that all memory of parsers and parsed arguments goes through the
+ * installed allocator and is released.
+ */
+bool test_allocator_balanced() {
+    const char * a[7] = {"prog", "-n", "x", "--level", "3", "a", "b"};
+    TestCounters counters;
+    bool failed = false;
+    for (int exact = 0; exact < 2 && !failed; ++exact) {
+        _install(&counters);
+        ArgumentParser * p = _make_parser(exact);
+        CompiledParser * c = cap_parser_compile(p);
+        ParsingResult res = cap_parser_parse_noexit(p, 7, a);
+        ParsingResult compiled_res = cap_compiled_parser_parse_noexit(c, 7, a);
+        do {
+            if (res.mError != PER_NO_ERROR) FB(failed);
+            if (compiled_res.mError != PER_NO_ERROR) FB(failed);
+            if (cap_tu_as_int(cap_pa_get_flag(res.mArguments, "--level")) != 3) FB(failed);
+            if (!counters.mAllocations || !counters.mLiveBytes) FB(failed);
+        } while (false);
+        cap_pa_destroy(res.mArguments);
+        cap_pa_destroy(compiled_res.mArguments);
+        cap_compiled_parser_destroy(c);
+        cap_parser_destroy(p);
+        cap_allocator_set(NULL);
+        if (counters.mLiveBytes != 0u) FB(failed);
+        if (counters.mFrees > counters.mAllocations) FB(failed);
+    }
+    return !failed;
+}
+
+/**
+ * Test that reusing parsed arguments does not allocate once they have grown
+ * to their final size.
+ */
+bool test_allocator_reuse() {
+    const char * a[6] = {"prog", "--name", "x", "a", "b", "c"};
+    TestCounters counters;
+    bool failed = false;
+    for (int exact = 0; exact < 2 && !failed; ++exact) {
+        _install(&counters);
+        ArgumentParser * p = _make_parser(exact);
+        ParsedArguments * pa = cap_pa_make_empty();
+        do {
+            cap_parser_parse_into_noexit(p, pa, 6, a);
+            cap_parser_parse_into_noexit(p, pa, 6, a);
+            const size_t allocations = counters.mAllocations;
+            ParsingResult res = cap_parser_parse_into_noexit(p, pa, 6, a);
+            if (res.mError != PER_NO_ERROR) FB(failed);
+            if (counters.mAllocations != allocations) FB(failed);
+        } while (false);
+        cap_pa_destroy(pa);
+        cap_parser_destroy(p);
+        cap_allocator_set(NULL);
+        if (counters.mLiveBytes != 0u) FB(failed);
+    }
+    return !failed;
+}
+
+int main() {
+    bool a;
+    a = TEST_GROUP(
+        "allocator", false, false, test_allocator_install,
+        test_allocator_balanced, test_allocator_reuse);
+    return a ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+#include "cap.h"
+#include "test.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Test that allocations are aligned and do not overlap.
+ */
+bool test_arena_alloc() {
+    Arena * arena = cap_arena_make(64u);
+    bool failed = false;
+    char * previous = NULL;
+    do {
+        // enough allocations to need several chunks
+        for (size_t i = 0; i < 100; ++i) {
+            char * p = (char *) cap_arena_alloc(arena, i + 1u);
+            if ((uintptr_t) p % _CAP_ARENA_ALIGN) FB(failed);
+            memset(p, (int) i, i + 1u);
+            if (previous && previous[0] != (char) (i - 1u)) FB(failed);
+            previous = p;
+        }
+    } while (false);
+    cap_arena_destroy(arena);
+    return !failed;
+}
+
+/**
+ * Test that the most recent allocation grows in place and others are copied.
+ */
+bool test_arena_realloc() {
+    Arena * arena = cap_arena_make(256u);
+    bool failed = false;
+    do {
+        char * a = (char *) cap_arena_alloc(arena, 8u);
+        strcpy(a, "abcdefg");
+        char * grown = (char *) cap_arena_realloc(arena, a, 8u, 64u);
+        if (grown != a) FB(failed);
+        char * b = (char *) cap_arena_alloc(arena, 8u);
+        char * moved = (char *) cap_arena_realloc(arena, a, 64u, 128u);
+        if (moved == a || moved == b) FB(failed);
+        if (strcmp(moved, "abcdefg")) FB(failed);
+        // larger than the remaining space of any chunk
+        char * big = (char *) cap_arena_realloc(arena, moved, 128u, 4096u);
+        if (strcmp(big, "abcdefg")) FB(failed);
+    } while (false);
+    cap_arena_destroy(arena);
+    return !failed;
+}
+
+/**
+ * Test copying strings and adopting heap memory.
+ */
+bool test_arena_strings() {
+    Arena * arena = cap_arena_make(0u);
+    bool failed = false;
+    do {
+        const char * s = "some string";
+        char * copy = cap_arena_copy_string(arena, s);
+        if (copy == s || strcmp(copy, s)) FB(failed);
+        if (cap_arena_copy_string(arena, NULL)) FB(failed);
+        // freed by cap_arena_destroy
+        cap_arena_adopt(arena, copy_string(s));
+        cap_arena_adopt(arena, NULL);
+    } while (false);
+    cap_arena_destroy(arena);
+    return !failed;
+}
+
+/**
+ * Test that a NULL arena falls back to the heap.
+ */
+bool test_arena_null() {
+    char * p = (char *) cap_arena_alloc(NULL, 4u);
+    p = (char *) cap_arena_realloc(NULL, p, 4u, 16u);
+    strcpy(p, "heap");
+    bool failed = strcmp(p, "heap") != 0;
+    cap_arena_free(NULL, p);
+    return !failed;
+}
+
+/**
+ * Test that rewinding keeps older allocations and reuses chunks.
+ */
+bool test_arena_rewind() {
+    Arena * arena = cap_arena_make(64u);
+    bool failed = false;
+    do {
+        char * kept = cap_arena_copy_string(arena, "kept");
+        ArenaMark mark = cap_arena_mark(arena);
+        for (size_t i = 0; i < 50; ++i) {
+            cap_arena_alloc(arena, 100u);
+        }
+        cap_arena_adopt(arena, copy_string("adopted"));
+        const size_t size = cap_arena_size(arena);
+        const size_t used = cap_arena_used(arena);
+        cap_arena_rewind(arena, mark);
+        if (strcmp(kept, "kept")) FB(failed);
+        if (cap_arena_size(arena) != size) FB(failed);
+        if (cap_arena_used(arena) >= used) FB(failed);
+        // the same allocations again fit into the chunks that are kept
+        for (size_t i = 0; i < 50; ++i) {
+            cap_arena_alloc(arena, 100u);
+        }
+        cap_arena_adopt(arena, copy_string("adopted"));
+        if (cap_arena_size(arena) != size) FB(failed);
+        if (cap_arena_used(arena) != used) FB(failed);
+    } while (false);
+    cap_arena_destroy(arena);
+    return !failed;
+}
+
+int main() {
+    bool a;
+    a = TEST_GROUP(
+        "arena", false, false, test_arena_alloc, test_arena_realloc,
+        test_arena_strings, test_arena_null, test_arena_rewind);
+    return a ? 0 : 1;
+}
@@ -0,0 +1,329 @@
+#include "cap.h"
+#include "test.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WORD_COUNT 4096
+#define WORD_SIZE 40u
+
+static uint64_t _random_state = 0x9e3779b97f4a7c15u;
+
+static uint64_t _random() {
+    // xorshift64*
+    _random_state ^= _random_state >> 12;
+    _random_state ^= _random_state << 25;
+    _random_state ^= _random_state >> 27;
+    return _random_state * 2685821657736338717u;
+}
+
+static void _random_word(char * word, bool allow_point) {
+    // mostly words the kernels handle, with some which they do not
+    static const char CHARS[] = "0123456789012345678901234567890.+-eEx ";
+    char * c = word;
+    switch (_random() % 4u) {
+        case 0:
+            *c++ = '-';
+            break;
+        case 1:
+            *c++ = '+';
+            break;
+        default:
+            break;
+    }
+    const int length = 1 + (int) (_random() % 18u);
+    for (int i = 0; i < length; ++i) {
+        const uint64_t k = _random() % 40u;
+        if (k < 30u || (!allow_point && k < 36u)) {
+            *c++ = (char) ('0' + k % 10u);
+        } else if (allow_point && k < 34u) {
+            *c++ = '.';
+        } else {
+            *c++ = CHARS[k % (sizeof(CHARS) - 1u)];
+        }
+    }
+    *c = '\0';
+}
+
+/**
+ * Places every other word at the end of a page, and the others in the middle.
+ * The last word ends at the end of the storage.
+ */
+static void _place_words(
+        const char ** words, char * storage, const char (*sources)[WORD_SIZE],
+        size_t count) {
+    for (size_t i = 0u; i < count; ++i) {
+        const size_t length = strlen(sources[i]) + 1u;
+        char * word = i % 2u
+            ? storage + i * 4096u + 4096u - length
+            : storage + i * 4096u + 100u + i % 16u;
+        memcpy(word, sources[i], length);
+        words[i] = word;
+    }
+}
+
+/**
+ * Test that every available instruction set converts random words exactly
+ * like the scalar functions.
+ */
+bool test_batch_agrees_with_scalar() {
+    static char sources[WORD_COUNT][WORD_SIZE];
+    const size_t count = 64u;
+    char * buffer = (char *) malloc((count + 1u) * 4096u);
+    char * storage = buffer + (4096u - (uintptr_t) buffer % 4096u);
+    const char * const limit = storage + count * 4096u;
+    const char * words[64];
+    bool failed = false;
+    for (int round = 0; round < WORD_COUNT / 64 * 16 && !failed; ++round) {
+        const bool doubles = round % 2;
+        for (size_t i = 0u; i < count; ++i) {
+            _random_word(sources[i], doubles);
+        }
+        _place_words(words, storage, (const char (*)[WORD_SIZE]) sources, count);
+        for (int level = 0; level <= (int) _cap_simd_level() && !failed;
+                ++level) {
+            size_t i = 0u;
+            while (i < count && !failed) {
+                int ints[64];
+                double reals[64];
+                WordConversionResult result;
+                const size_t converted = doubles
+                    ? _cap_parse_double_batch_with(
+                        words + i, count - i, limit, reals, &result,
+                        (_CapSimdLevel) level)
+                    : _cap_parse_int_batch_with(
+                        words + i, count - i, limit, ints, &result,
+                        (_CapSimdLevel) level);
+                for (size_t j = 0u; j <= converted && i + j < count; ++j) {
+                    int v = 0;
+                    double d = 0.0;
+                    const WordConversionResult expected = doubles
+                        ? _cap_parse_double(words[i + j], &d)
+                        : _cap_parse_int(words[i + j], &v);
+                    if (j == converted) {
+                        if (expected != result || result == WCR_OK) {
+                            failed = true;
+                        }
+                    } else if (expected != WCR_OK || (doubles
+                            ? memcmp(&d, reals + j, sizeof(d))
+                            : v != ints[j])) {
+                        failed = true;
+                    }
+                    if (failed) {
+                        printf(
+                            "\nlevel %d, '%s' differs from the scalar "
+                            "conversion\n", level, words[i + j]);
+                        break;
+                    }
+                }
+                i += converted + 1u;
+            }
+        }
+    }
+    free(buffer);
+    return !failed;
+}
+
+/**
+ * Test words at the limits of what the kernels handle.
+ */
+bool test_batch_edge_cases() {
+    static const char * INTS[] = {
+        "1", "-1", "+1", "2147483647", "-2147483648", "2147483648",
+        "-2147483649", "999999999999999", "9999999999999999", "0", "007",
+        "0x10", "1x", "12 ", " 12", "", "-", "1-", "123456789012345"
+    };
+    static const char * DOUBLES[] = {
+        "1", ".5", "5.", ".", "-.5e1", "1.5e", "1.5e+", "1.5e-3", "1e999",
+        "1e-999", "123456789012345.", "1234567890.12345", "0.000000000000001",
+        "1.2.3", "1..2", "9007199254740993", "1.5x", "0x1p3", "inf", "1E+2",
+        "-0", "-0.0e5", "1e100000000000"
+    };
+    // the words are copied into a buffer in which the kernels can load them
+    char word[32];
+    const char * const words[1] = {word};
+    bool failed = false;
+    for (int level = 0; level <= (int) _cap_simd_level() && !failed;
+            ++level) {
+        for (size_t i = 0u; i < sizeof(INTS) / sizeof(*INTS); ++i) {
+            int v = 0, expected_value = 0;
+            WordConversionResult result;
+            strcpy(word, INTS[i]);
+            const size_t converted = _cap_parse_int_batch_with(
+                words, 1u, word + sizeof(word), &v, &result,
+                (_CapSimdLevel) level);
+            const WordConversionResult expected
+                = _cap_parse_int(INTS[i], &expected_value);
+            if (result != expected || (converted == 1u) != (result == WCR_OK)
+                    || (result == WCR_OK && v != expected_value)) {
+                printf("\nlevel %d, int '%s'\n", level, INTS[i]);
+                FB(failed);
+            }
+        }
+        for (size_t i = 0u; i < sizeof(DOUBLES) / sizeof(*DOUBLES); ++i) {
+            double v = 0.0, expected_value = 0.0;
+            WordConversionResult result;
+            strcpy(word, DOUBLES[i]);
+            const size_t converted = _cap_parse_double_batch_with(
+                words, 1u, word + sizeof(word), &v, &result,
+                (_CapSimdLevel) level);
+            const WordConversionResult expected
+                = _cap_parse_double(DOUBLES[i], &expected_value);
+            if (result != expected || (converted == 1u) != (result == WCR_OK)
+                    || (result == WCR_OK
+                        && memcmp(&v, &expected_value, sizeof(v)))) {
+                printf("\nlevel %d, double '%s'\n", level, DOUBLES[i]);
+                FB(failed);
+            }
+        }
+    }
+    return !failed;
+}
+
+/**
+ * Test that words stored one after another, like those of a response file,
+ * are converted up to the end of a buffer which has no room to spare.
+ */
+bool test_batch_buffer_end() {
+    static const char DATA[] =
+        "1234567890\0-98765\0+2147483647\0" "42\0" "7\0" "1234567\0";
+    static const int VALUES[] = {
+        1234567890, -98765, 2147483647, 42, 7, 1234567
+    };
+    const size_t count = sizeof(VALUES) / sizeof(*VALUES);
+    const size_t size = sizeof(DATA) - 1u;
+    char * data = (char *) malloc(size);
+    memcpy(data, DATA, size);
+    const char * words[6];
+    const char * c = data;
+    for (size_t i = 0u; i < count; ++i) {
+        words[i] = c;
+        c += strlen(c) + 1u;
+    }
+    bool failed = false;
+    for (int level = 0; level <= (int) _cap_simd_level() && !failed;
+            ++level) {
+        int ints[6];
+        double reals[6];
+        WordConversionResult result;
+        if (_cap_parse_int_batch_with(
+                words, count, data + size, ints, &result,
+                (_CapSimdLevel) level) != count) {
+            FB(failed);
+        }
+        if (_cap_parse_double_batch_with(
+                words, count, data + size, reals, &result,
+                (_CapSimdLevel) level) != count) {
+            FB(failed);
+        }
+        for (size_t i = 0u; i < count && !failed; ++i) {
+            if (ints[i] != VALUES[i] || reals[i] != VALUES[i]) FB(failed);
+        }
+    }
+    free(data);
+    return !failed;
+}
+
+/**
+ * Test that variadic numeric positionals are parsed in batches, across chunk
+ * boundaries and between flags.
+ */
+bool test_batch_parser() {
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_add_flag(p, "-s", DT_INT, 0, -1, NULL, NULL);
+    cap_parser_add_positional(p, "first", DT_STRING, true, false, NULL, NULL);
+    cap_parser_add_positional(p, "nums", DT_INT, true, true, NULL, NULL);
+    static char storage[1000][16];
+    const char * a[1004];
+    a[0] = "prog";
+    a[1] = "name";
+    for (int i = 0; i < 1000; ++i) {
+        snprintf(storage[i], sizeof(storage[i]), "%d", i * 7 - 300);
+        a[i + 2] = storage[i];
+    }
+    bool failed = false;
+    ParsingResult res;
+    res.mArguments = NULL;
+    do {
+        // words starting with `-` are flags
+        a[502] = "-s";
+        a[503] = "5";
+        res = cap_parser_parse_noexit(p, 1002, a);
+        if (res.mError != PER_UNKNOWN_FLAG) FB(failed);
+        if (strcmp(res.mFirstErrorWord, "-300")) FB(failed);
+        a[2] = "300";
+        res = cap_parser_parse_noexit(p, 1002, a);
+        if (res.mError != PER_UNKNOWN_FLAG) FB(failed);
+        for (int i = 0; i < 1000; ++i) {
+            if (*storage[i] == '-') {
+                storage[i][0] = '+';
+            }
+        }
+        res = cap_parser_parse_noexit(p, 1002, a);
+        if (res.mError != PER_NO_ERROR) FB(failed);
+        if (cap_pa_positional_count(res.mArguments, "nums") != 998u) FB(failed);
+        if (cap_tu_as_int(cap_pa_get_flag(res.mArguments, "-s")) != 5) {
+            FB(failed);
+        }
+        const TypedUnion * nums = cap_pa_get_positional(res.mArguments, "nums");
+        if (cap_tu_as_int(nums) != 300) FB(failed);
+        if (cap_tu_as_int(nums + 499) != 3193) FB(failed);
+        if (cap_tu_as_int(nums + 500) != 3214) FB(failed);
+        if (cap_tu_as_int(nums + 997) != 6693) FB(failed);
+        cap_pa_destroy(res.mArguments);
+        res.mArguments = NULL;
+        // errors are reported for the right word, also after a chunk
+        a[800] = "12x";
+        res = cap_parser_parse_noexit(p, 1002, a);
+        if (res.mError != PER_CANNOT_PARSE_POSITIONAL) FB(failed);
+        if (strcmp(res.mFirstErrorWord, "nums")) FB(failed);
+        if (res.mSecondErrorWord != a[800]) FB(failed);
+        a[700] = "99999999999";
+        res = cap_parser_parse_noexit(p, 1002, a);
+        if (res.mError != PER_POSITIONAL_OUT_OF_RANGE) FB(failed);
+        if (res.mSecondErrorWord != a[700]) FB(failed);
+    } while (false);
+    cap_pa_destroy(res.mArguments);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+/**
+ * Test that words after the flag separator are positionals, even if they
+ * start with `-`.
+ */
+bool test_batch_after_separator() {
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_set_flag_separator(p, "--", NULL);
+    cap_parser_add_positional(p, "values", DT_DOUBLE, true, true, NULL, NULL);
+    const char * a[6] = {"prog", "1.5", "--", "-2.25", "-1e-3", "--"};
+    bool failed = false;
+    ParsingResult res = cap_parser_parse_noexit(p, 5, a);
+    do {
+        if (res.mError != PER_NO_ERROR) FB(failed);
+        const TypedUnion * v = cap_pa_get_positional(res.mArguments, "values");
+        if (cap_pa_positional_count(res.mArguments, "values") != 3u) {
+            FB(failed);
+        }
+        if (cap_tu_as_double(v) != 1.5) FB(failed);
+        if (cap_tu_as_double(v + 1) != -2.25) FB(failed);
+        if (cap_tu_as_double(v + 2) != -1e-3) FB(failed);
+        cap_pa_destroy(res.mArguments);
+        res = cap_parser_parse_noexit(p, 6, a);
+        if (res.mError != PER_CANNOT_PARSE_POSITIONAL) FB(failed);
+        if (res.mSecondErrorWord != a[5]) FB(failed);
+    } while (false);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+int main() {
+    bool a;
+    a = TEST_GROUP(
+        "batch number parsing", false, false, test_batch_agrees_with_scalar,
+        test_batch_edge_cases, test_batch_buffer_end, test_batch_parser,
+        test_batch_after_separator);
+    return a ? 0 : 1;
+}
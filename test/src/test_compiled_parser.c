@@ -0,0 +1,124 @@
+#include "cap.h"
+#include "test.h"
+
+#include <string.h>
+
+static ArgumentParser * _make_parser() {
+    ArgumentParser * p = cap_parser_make_default();
+    cap_parser_enable_help(p, false);
+    cap_parser_enable_usage(p, false);
+    cap_parser_set_description(p, "a program");
+    cap_parser_add_flag(p, "--count", DT_INT, 0, 2, "N", "how many");
+    cap_parser_add_flag_alias(p, "--count", "-c");
+    cap_parser_add_flag(p, "--verbose", DT_PRESENCE, 0, -1, NULL, NULL);
+    cap_parser_add_flag_alias(p, "--verbose", "-v");
+    cap_parser_add_flag_alias(p, "-h", "--help");
+    cap_parser_add_positional(p, "input", DT_STRING, true, false, NULL, NULL);
+    cap_parser_add_positional(p, "ratio", DT_DOUBLE, false, false, NULL, NULL);
+    return p;
+}
+
+/**
+ * Test that a compiled parser parses like the original.
+ *
+ * The original parser is destroyed before the compiled one is used, to check
+ * that the compiled parser does not depend on it.
+ */
+bool test_compiled_parse() {
+    ArgumentParser * p = _make_parser();
+    CompiledParser * cp = cap_parser_compile(p);
+    cap_parser_destroy(p);
+
+    const char * a[8] = {"prog", "-c", "3", "in.txt", "-v", "--count", "4", "0.5"};
+    ParsingResult res = cap_compiled_parser_parse_noexit(cp, 8, a);
+    ParsedArguments * pa = res.mArguments;
+    bool failed = false;
+    do {
+        if (res.mError != PER_NO_ERROR) FB(failed);
+        if (cap_pa_flag_count(pa, "--count") != 2u) FB(failed);
+        if (cap_tu_as_int(cap_pa_get_flag_i(pa, "--count", 0)) != 3) FB(failed);
+        if (cap_tu_as_int(cap_pa_get_flag_i(pa, "--count", 1)) != 4) FB(failed);
+        if (cap_pa_flag_count(pa, "--verbose") != 1u) FB(failed);
+        if (cap_pa_has_flag(pa, "-v")) FB(failed);
+        if (strcmp(cap_tu_as_string(cap_pa_get_positional(pa, "input")), "in.txt")) FB(failed);
+        if (cap_tu_as_double(cap_pa_get_positional(pa, "ratio")) != 0.5) FB(failed);
+    } while (false);
+
+    cap_pa_destroy(pa);
+    cap_compiled_parser_destroy(cp);
+    return !failed;
+}
+
+/**
+ * Test that a compiled parser can be reused and reports errors.
+ */
+bool test_compiled_errors() {
+    ArgumentParser * p = _make_parser();
+    CompiledParser * cp = cap_parser_compile(p);
+    cap_parser_destroy(p);
+
+    const char * a1[3] = {"prog", "x", "--help"};
+    const char * a2[3] = {"prog", "x", "-q"};
+    const char * a3[6] = {"prog", "x", "-c", "1", "-c", "2"};
+    const char * a4[4] = {"prog", "--", "-x", "-2.5"};
+    const char * a5[2] = {"prog", "-v"};
+    bool failed = false;
+    do {
+        ParsingResult res = cap_compiled_parser_parse_noexit(cp, 3, a1);
+        if (res.mError != PER_HELP) FB(failed);
+        res = cap_compiled_parser_parse_noexit(cp, 3, a2);
+        if (res.mError != PER_UNKNOWN_FLAG) FB(failed);
+        if (strcmp(res.mFirstErrorWord, "-q")) FB(failed);
+        res = cap_compiled_parser_parse_noexit(cp, 6, a3);
+        if (res.mError != PER_NO_ERROR) FB(failed);
+        cap_pa_destroy(res.mArguments);
+        res = cap_compiled_parser_parse_noexit(cp, 4, a4);
+        if (res.mError != PER_NO_ERROR) FB(failed);
+        if (strcmp(cap_tu_as_string(cap_pa_get_positional(res.mArguments, "input")), "-x")) FB(failed);
+        cap_pa_destroy(res.mArguments);
+        res = cap_compiled_parser_parse_noexit(cp, 2, a5);
+        if (res.mError != PER_NOT_ENOUGH_POSITIONALS) FB(failed);
+    } while (false);
+
+    cap_compiled_parser_destroy(cp);
+    return !failed;
+}
+
+/**
+ * Test that a compiled parser is not affected by changes to the original.
+ */
+bool test_compiled_independent() {
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_set_flag_prefix(p, "+");
+    cap_parser_add_flag(p, "+a", DT_PRESENCE, 0, 1, NULL, NULL);
+    CompiledParser * cp = cap_parser_compile(p);
+    cap_parser_add_flag(p, "+b", DT_PRESENCE, 0, 1, NULL, NULL);
+    cap_parser_add_flag_alias(p, "+a", "+x");
+
+    const char * a1[2] = {"prog", "+a"};
+    const char * a2[2] = {"prog", "+b"};
+    const char * a3[2] = {"prog", "+x"};
+    bool failed = false;
+    do {
+        ParsingResult res = cap_compiled_parser_parse_noexit(cp, 2, a1);
+        if (res.mError != PER_NO_ERROR) FB(failed);
+        if (!cap_pa_has_flag(res.mArguments, "+a")) FB(failed);
+        cap_pa_destroy(res.mArguments);
+        res = cap_compiled_parser_parse_noexit(cp, 2, a2);
+        if (res.mError != PER_UNKNOWN_FLAG) FB(failed);
+        res = cap_compiled_parser_parse_noexit(cp, 2, a3);
+        if (res.mError != PER_UNKNOWN_FLAG) FB(failed);
+    } while (false);
+
+    cap_compiled_parser_destroy(cp);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+int main() {
+    bool a;
+    a = TEST_GROUP(
+        "compiled parser", false, false, test_compiled_parse,
+        test_compiled_errors, test_compiled_independent);
+    return a ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+#include "cap.h"
+#include "test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Test that a single value is stored inline and more values spill to an
+ * allocated array.
+ */
+bool test_nv_inline_spill() {
+    NamedValues * nv = cap_nv_make("--level", cap_tu_make_int(1));
+    bool failed = false;
+    do {
+        if (nv -> mValues) FB(failed);
+        if (cap_tu_as_int(cap_nv_get_value(nv)) != 1) FB(failed);
+        for (int i = 2; i <= 9; ++i) {
+            cap_nv_append_value(nv, cap_tu_make_int(i));
+        }
+        if (!nv -> mValues) FB(failed);
+        if (cap_nv_value_count(nv) != 9u) FB(failed);
+        for (size_t i = 0u; i < 9u; ++i) {
+            if (cap_tu_as_int(cap_nv_get_value_i(nv, i)) != (int) i + 1) FB(failed);
+        }
+        if (failed) break;
+        cap_nv_clear_values(nv);
+        if (nv -> mValues || cap_nv_get_value(nv)) FB(failed);
+        cap_nv_append_value(nv, cap_tu_make_string("abc"));
+        if (nv -> mValues) FB(failed);
+        if (strcmp(cap_tu_as_string(cap_nv_get_value(nv)), "abc")) FB(failed);
+    } while (false);
+    cap_nv_destroy(nv);
+    cap_free(nv);
+    return !failed;
+}
+
+/**
+ * Test that inline values survive growing the array which contains them.
+ */
+bool test_nv_inline_moved() {
+    NamedValuesArray * nva = cap_nva_make_empty();
+    char name[16];
+    bool failed = false;
+    for (int i = 0; i < 64; ++i) {
+        sprintf(name, "--flag-%d", i);
+        cap_nva_append_value(nva, name, cap_tu_make_int(i));
+    }
+    for (int i = 0; i < 64 && !failed; ++i) {
+        sprintf(name, "--flag-%d", i);
+        const NamedValues * nv = cap_nva_get(nva, name);
+        if (!nv || nv -> mValues) FB(failed);
+        if (cap_tu_as_int(cap_nv_get_value(nv)) != i) FB(failed);
+    }
+    cap_nva_destroy(nva);
+    return !failed;
+}
+
+int main() {
+    bool a;
+    a = TEST_GROUP(
+        "named values", false, false, test_nv_inline_spill,
+        test_nv_inline_moved);
+    return a ? 0 : 1;
+}
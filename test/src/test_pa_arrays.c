@@ -0,0 +1,179 @@
+#include "cap.h"
+#include "test.h"
+
+#include <string.h>
+
+/**
+ * Test that values of a variadic positional are returned as packed arrays of
+ * their type when packing is enabled.
+ */
+bool test_arrays_positionals() {
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_enable_packed_values(p, true);
+    cap_parser_add_positional(p, "n", DT_INT, true, false, NULL, NULL);
+    cap_parser_add_positional(p, "values", DT_DOUBLE, true, true, NULL, NULL);
+    const char * a[6] = {"prog", "7", "1.5", "2.5", "3", "4e2"};
+    ParsingResult res = cap_parser_parse_noexit(p, 6, a);
+    bool failed = false;
+    do {
+        if (res.mError != PER_NO_ERROR) FB(failed);
+        size_t count = 99u;
+        const double * values = cap_pa_get_positional_doubles(
+            res.mArguments, "values", &count);
+        if (!values || count != 4u) FB(failed);
+        if (values[0] != 1.5 || values[1] != 2.5) FB(failed);
+        if (values[2] != 3.0 || values[3] != 400.0) FB(failed);
+        if (values != cap_pa_get_positional_doubles_by_id(
+                res.mArguments, 1u, NULL)) FB(failed);
+        // a single value is an array as well
+        const int * n = cap_pa_get_positional_ints(res.mArguments, "n", &count);
+        if (!n || count != 1u || *n != 7) FB(failed);
+        // other types and missing arguments
+        if (cap_pa_get_positional_ints(res.mArguments, "values", &count)) {
+            FB(failed);
+        }
+        if (count) FB(failed);
+        if (cap_pa_get_positional_strings(res.mArguments, "x", &count)) {
+            FB(failed);
+        }
+        if (cap_pa_get_positional_ints_by_id(res.mArguments, 5u, &count)) {
+            FB(failed);
+        }
+        // only the first of the packed values is kept as a TypedUnion
+        const TypedUnion * v = cap_pa_get_positional(res.mArguments, "values");
+        if (!cap_tu_is_double(v) || cap_tu_as_double(v) != 1.5) FB(failed);
+        if (cap_pa_get_positional_i(res.mArguments, "values", 1u)) FB(failed);
+        v = cap_pa_get_positional(res.mArguments, "n");
+        if (!cap_tu_is_int(v) || cap_tu_as_int(v) != 7) FB(failed);
+        cap_pa_append_positional(
+            res.mArguments, "values", cap_tu_make_double(8.0));
+        values = cap_pa_get_positional_doubles(
+            res.mArguments, "values", &count);
+        if (count != 5u || values[4] != 8.0) FB(failed);
+    } while (false);
+    cap_pa_destroy(res.mArguments);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+/**
+ * Test arrays of flag values, including strings and values of mixed types.
+ */
+bool test_arrays_flags() {
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_enable_packed_values(p, true);
+    cap_parser_add_flag(p, "-s", DT_STRING, 0, -1, NULL, NULL);
+    cap_parser_add_flag(p, "-v", DT_PRESENCE, 0, -1, NULL, NULL);
+    const char * a[9] = {
+        "prog", "-s", "a", "-v", "-s", "bc", "-v", "-s", "def"};
+    ParsingResult res = cap_parser_parse_noexit(p, 9, a);
+    ParsedArguments * pa = res.mArguments;
+    bool failed = false;
+    do {
+        if (res.mError != PER_NO_ERROR) FB(failed);
+        size_t count;
+        const char * const * s = cap_pa_get_flag_strings(pa, "-s", &count);
+        if (!s || count != 3u) FB(failed);
+        if (strcmp(s[0], "a") || strcmp(s[1], "bc") || strcmp(s[2], "def")) {
+            FB(failed);
+        }
+        if (s != cap_pa_get_flag_strings_by_id(pa, 0u, NULL)) FB(failed);
+        cap_pa_add_flag(pa, "-v", cap_tu_make_presence());
+        if (cap_pa_flag_count(pa, "-v") != 3u) FB(failed);
+        // presence values carry no data, any of them is the first one
+        const TypedUnion * flag = cap_pa_get_flag(pa, "-v");
+        if (!flag || !cap_tu_is_presence(flag)) FB(failed);
+        if (cap_pa_get_flag_i(pa, "-v", 2u) != flag) FB(failed);
+        if (cap_pa_get_flag_i(pa, "-v", 3u)) FB(failed);
+        if (strcmp(cap_tu_as_string(cap_pa_get_flag(pa, "-s")), "a")) {
+            FB(failed);
+        }
+        if (cap_pa_get_flag_i(pa, "-s", 1u)) FB(failed);
+        // values of different types are kept as TypedUnions
+        cap_pa_add_flag(pa, "-s", cap_tu_make_int(5));
+        if (cap_pa_get_flag_strings(pa, "-s", &count) || count) FB(failed);
+        if (cap_pa_flag_count(pa, "-s") != 4u) FB(failed);
+        const TypedUnion * v = cap_pa_get_flag(pa, "-s");
+        if (strcmp(cap_tu_as_string(v + 2), "def")) FB(failed);
+        if (cap_tu_as_int(v + 3) != 5) FB(failed);
+    } while (false);
+    cap_pa_destroy(pa);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+/**
+ * Test that values are stored as `TypedUnion`s unless packing is enabled.
+ */
+bool test_arrays_not_packed() {
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_add_positional(p, "n", DT_INT, true, true, NULL, NULL);
+    const char * a[4] = {"prog", "1", "2", "3"};
+    ParsingResult res = cap_parser_parse_noexit(p, 4, a);
+    bool failed = false;
+    do {
+        if (res.mError != PER_NO_ERROR) FB(failed);
+        size_t count = 99u;
+        if (cap_pa_get_positional_ints(res.mArguments, "n", &count)) {
+            FB(failed);
+        }
+        if (count) FB(failed);
+        const TypedUnion * v = cap_pa_get_positional(res.mArguments, "n");
+        if (!v || cap_tu_as_int(v) != 1 || cap_tu_as_int(v + 2) != 3) {
+            FB(failed);
+        }
+        if (v + 1 != cap_pa_get_positional_i(res.mArguments, "n", 1u)) {
+            FB(failed);
+        }
+        ParsedArguments * pa = cap_pa_make_empty();
+        cap_pa_add_flag(pa, "-s", cap_tu_make_string("a"));
+        cap_pa_add_flag(pa, "-s", cap_tu_make_string("b"));
+        if (cap_pa_get_flag_strings(pa, "-s", NULL)) FB(failed);
+        if (strcmp(cap_tu_as_string(cap_pa_get_flag_i(pa, "-s", 1u)), "b")) {
+            FB(failed);
+        }
+        cap_pa_destroy(pa);
+    } while (false);
+    cap_pa_destroy(res.mArguments);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+/**
+ * Test that integers take the size of an `int` with exact allocation.
+ */
+bool test_arrays_packed_size() {
+    enum { COUNT = 10000 };
+    static const char * a[COUNT + 1];
+    a[0] = "prog";
+    for (size_t i = 1u; i <= COUNT; ++i) {
+        a[i] = "42";
+    }
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_enable_exact_allocation(p, true);
+    cap_parser_enable_packed_values(p, true);
+    cap_parser_add_positional(p, "nums", DT_INT, true, true, NULL, NULL);
+    ParsingResult res = cap_parser_parse_noexit(p, COUNT + 1, a);
+    bool failed = false;
+    do {
+        if (res.mError != PER_NO_ERROR) FB(failed);
+        const size_t size = cap_arena_size(res.mArguments -> mArena);
+        if (size < COUNT * sizeof(int)) FB(failed);
+        if (size >= COUNT * sizeof(int) + 1024u) FB(failed);
+        size_t count;
+        const int * nums = cap_pa_get_positional_ints(
+            res.mArguments, "nums", &count);
+        if (count != COUNT || nums[COUNT - 1] != 42) FB(failed);
+    } while (false);
+    cap_pa_destroy(res.mArguments);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+int main() {
+    bool a;
+    a = TEST_GROUP(
+        "pa: arrays", false, false, test_arrays_positionals,
+        test_arrays_flags, test_arrays_not_packed, test_arrays_packed_size);
+    return a ? 0 : 1;
+}
@@ -704,6 +704,34 @@ bool test_flags_positionals_fail_10() {
     return !failed;
 }
 
+/**
+ * Test parsing error.
+ * 
+ * A flag was given too many times. Parsing fails as soon as the maximum count
+ * is exceeded, before later words are looked at.
+ */
+bool test_flags_positionals_fail_11() {
+    ArgumentParser * p = cap_parser_make_default();
+    const char * c = "-c";
+
+    cap_parser_add_flag(p, c, DT_STRING, 0, 2, "P", NULL);
+
+    const char * args[8] = {"prog", c, "x", c, "y", c, "z", "--unknown"};
+
+    ParsingResult res = cap_parser_parse_noexit(p, 8, args);
+    ParsedArguments * pa = res.mArguments;
+    bool failed = false;
+    do {
+        if (res.mError != PER_TOO_MANY_FLAGS) FB(failed)
+        if (strcmp(res.mFirstErrorWord, c)) FB(failed)
+        if (pa) FB(failed)
+    } while(false);
+
+    cap_parser_destroy(p);
+    cap_pa_destroy(pa);
+    return !failed;
+}
+
 int main() {
     bool a, b;
     a = TEST_GROUP(
@@ -716,6 +744,6 @@ int main() {
         test_flags_positionals_fail_4, test_flags_positionals_fail_5,
         test_flags_positionals_fail_6, test_flags_positionals_fail_7,
         test_flags_positionals_fail_8, test_flags_positionals_fail_9,
-        test_flags_positionals_fail_10);
+        test_flags_positionals_fail_10, test_flags_positionals_fail_11);
     return a && b ? 0 : 1;
 }
\ No newline at end of file
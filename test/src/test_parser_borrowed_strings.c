@@ -0,0 +1,81 @@
+#include "cap.h"
+#include "test.h"
+
+#include <string.h>
+
+static ArgumentParser * _make_parser(bool borrow) {
+    ArgumentParser * p = cap_parser_make_default();
+    cap_parser_enable_borrowed_strings(p, borrow);
+    cap_parser_add_flag(p, "--name", DT_STRING, 0, 2, NULL, NULL);
+    cap_parser_add_flag(p, "--count", DT_INT, 0, 1, NULL, NULL);
+    cap_parser_add_positional(p, "files", DT_STRING, true, true, NULL, NULL);
+    return p;
+}
+
+/**
+ * Test that string values point into the parsed words when borrowing.
+ */
+bool test_borrowed_strings() {
+    ArgumentParser * p = _make_parser(true);
+    const char * a[7] = {"prog", "--name", "x", "a.txt", "--count", "3", "b.txt"};
+    ParsingResult res = cap_parser_parse_noexit(p, 7, a);
+    cap_parser_destroy(p);
+    ParsedArguments * pa = res.mArguments;
+    bool failed = false;
+    do {
+        if (res.mError != PER_NO_ERROR) FB(failed);
+        if (cap_tu_as_string(cap_pa_get_flag(pa, "--name")) != a[2]) FB(failed);
+        if (cap_tu_as_string(cap_pa_get_positional_i(pa, "files", 0)) != a[3]) FB(failed);
+        if (cap_tu_as_string(cap_pa_get_positional_i(pa, "files", 1)) != a[6]) FB(failed);
+        if (cap_tu_as_int(cap_pa_get_flag(pa, "--count")) != 3) FB(failed);
+    } while (false);
+    cap_pa_destroy(pa);
+    return !failed;
+}
+
+/**
+ * Test that string values are copied by default.
+ */
+bool test_copied_strings() {
+    ArgumentParser * p = _make_parser(false);
+    char word[6] = "a.txt";
+    const char * a[4] = {"prog", "--name", "x", word};
+    ParsingResult res = cap_parser_parse_noexit(p, 4, a);
+    cap_parser_destroy(p);
+    ParsedArguments * pa = res.mArguments;
+    bool failed = false;
+    do {
+        if (res.mError != PER_NO_ERROR) FB(failed);
+        const char * file = cap_tu_as_string(cap_pa_get_positional(pa, "files"));
+        if (file == word) FB(failed);
+        word[0] = 'b';
+        if (strcmp(file, "a.txt")) FB(failed);
+        if (cap_tu_as_string(cap_pa_get_flag(pa, "--name")) == a[2]) FB(failed);
+    } while (false);
+    cap_pa_destroy(pa);
+    return !failed;
+}
+
+/**
+ * Test that a compiled parser keeps the borrowing mode.
+ */
+bool test_borrowed_strings_compiled() {
+    ArgumentParser * p = _make_parser(true);
+    CompiledParser * cp = cap_parser_compile(p);
+    cap_parser_destroy(p);
+    const char * a[2] = {"prog", "file"};
+    ParsingResult res = cap_compiled_parser_parse_noexit(cp, 2, a);
+    bool failed = res.mError != PER_NO_ERROR
+        || cap_tu_as_string(cap_pa_get_positional(res.mArguments, "files")) != a[1];
+    cap_pa_destroy(res.mArguments);
+    cap_compiled_parser_destroy(cp);
+    return !failed;
+}
+
+int main() {
+    bool a;
+    a = TEST_GROUP(
+        "parser: borrowed strings", false, false, test_borrowed_strings,
+        test_copied_strings, test_borrowed_strings_compiled);
+    return a ? 0 : 1;
+}
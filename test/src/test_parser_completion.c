@@ -0,0 +1,149 @@
+#include "cap.h"
+#include "test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/// number of times the parser of the subcommand "run" was built
+static int _built;
+
+static void _make_run(ArgumentParser * parser, void * context) {
+    (void) context;
+    ++_built;
+    cap_parser_add_flag(parser, "--jobs", DT_INT, 0, 1, NULL, NULL);
+    cap_parser_add_flag(parser, "--json", DT_PRESENCE, 0, 1, NULL, NULL);
+    cap_parser_add_positional(
+        parser, "files", DT_STRING, false, true, NULL, NULL);
+}
+
+static ArgumentParser * _make_parser() {
+    _built = 0;
+    ArgumentParser * p = cap_parser_make_default();
+    cap_parser_enable_completion(p, true);
+    cap_parser_add_flag(p, "--verbose", DT_PRESENCE, 0, 1, NULL, NULL);
+    cap_parser_add_flag_alias(p, "--verbose", "-v");
+    cap_parser_add_flag(p, "--config", DT_STRING, 0, 1, NULL, NULL);
+    cap_parser_add_flag(p, "--version", DT_PRESENCE, 0, 1, NULL, NULL);
+    cap_parser_add_subcommand(p, "run", _make_run, NULL, NULL);
+    cap_parser_add_subcommand(p, "remove", _make_run, NULL, NULL);
+    cap_parser_add_subcommand(p, "list", _make_run, NULL, NULL);
+    return p;
+}
+
+static bool _complete(
+        const ArgumentParser * p, int argc, const char ** argv, size_t index,
+        const char * expected) {
+    FILE * file = tmpfile();
+    if (!file) {
+        return false;
+    }
+    const size_t count = cap_parser_complete(p, argc, argv, index, file);
+    char printed[256] = { 0 };
+    rewind(file);
+    fread(printed, 1u, sizeof(printed) - 1u, file);
+    fclose(file);
+    size_t lines = 0u;
+    for (const char * c = printed; *c; ++c) {
+        lines += *c == '\n';
+    }
+    return !strcmp(printed, expected) && count == lines;
+}
+
+/**
+ * Test completing names of flags, aliases, and subcommands, also after the
+ * configuration changes.
+ */
+bool test_complete_names() {
+    ArgumentParser * p = _make_parser();
+    bool failed = false;
+    do {
+        const char * flag[2] = { "prog", "--ver" };
+        if (!_complete(p, 2, flag, 1u, "--verbose\n--version\n")) FB(failed);
+        const char * all[2] = { "prog", "-" };
+        if (!_complete(p, 2, all, 1u,
+                "--\n--config\n--verbose\n--version\n-h\n-v\n")) {
+            FB(failed);
+        }
+        const char * command[3] = { "prog", "-v", "r" };
+        if (!_complete(p, 3, command, 2u, "remove\nrun\n")) FB(failed);
+        // an empty word is completed by subcommands only
+        if (!_complete(p, 2, command, 2u, "run\nremove\nlist\n")) FB(failed);
+        if (_built) FB(failed);
+        const char * sub[4] = { "prog", "run", "a.c", "--j" };
+        if (!_complete(p, 4, sub, 3u, "--jobs\n--json\n")) FB(failed);
+        if (_built != 1) FB(failed);
+        // later configuration is completed too
+        cap_parser_add_flag(p, "--color", DT_PRESENCE, 0, 1, NULL, NULL);
+        const char * added[2] = { "prog", "--co" };
+        if (!_complete(p, 2, added, 1u, "--color\n--config\n")) FB(failed);
+        cap_parser_set_help_flag(p, "--help", NULL);
+        const char * help[2] = { "prog", "-" };
+        if (!_complete(p, 2, help, 1u,
+                "--\n--color\n--config\n--help\n--verbose\n--version\n-v\n")) {
+            FB(failed);
+        }
+        // without the completion mode, the names are sorted for each call
+        cap_parser_enable_completion(p, false);
+        if (!_complete(p, 2, added, 1u, "--color\n--config\n")) FB(failed);
+    } while (false);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+/**
+ * Test that nothing is completed where names cannot be.
+ */
+bool test_complete_nothing() {
+    ArgumentParser * p = _make_parser();
+    bool failed = false;
+    do {
+        const char * value[3] = { "prog", "--config", "--v" };
+        if (!_complete(p, 3, value, 2u, "")) FB(failed);
+        const char * unknown[4] = { "prog", "pull", "--v" };
+        if (!_complete(p, 3, unknown, 2u, "")) FB(failed);
+        const char * separated[5] = { "prog", "run", "--", "--j" };
+        if (!_complete(p, 4, separated, 3u, "")) FB(failed);
+        const char * positional[4] = { "prog", "run", "--jobs", "2" };
+        if (!_complete(p, 4, positional, 4u, "")) FB(failed);
+        if (!_complete(p, 4, positional, 5u, "")) FB(failed);
+        if (!_complete(p, 4, positional, 0u, "")) FB(failed);
+    } while (false);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+/**
+ * Test that completion scripts run the program in the completion mode.
+ */
+bool test_completion_scripts() {
+    ArgumentParser * p = _make_parser();
+    bool failed = false;
+    static const CompletionShell SHELLS[3] = { CS_BASH, CS_ZSH, CS_FISH };
+    for (size_t i = 0u; i < 3u && !failed; ++i) {
+        FILE * file = tmpfile();
+        if (!file) {
+            FB(failed);
+        }
+        cap_parser_print_completion_script(
+            p, SHELLS[i], "/usr/bin/my-prog", file);
+        char script[1024] = { 0 };
+        rewind(file);
+        fread(script, 1u, sizeof(script) - 1u, file);
+        fclose(file);
+        if (!strstr(script, "--cap-complete")
+                || !strstr(script, "_cap_complete_my_prog")
+                || !strstr(script, "'my-prog'")) {
+            FB(failed);
+        }
+    }
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+int main() {
+    bool a;
+    a = TEST_GROUP(
+        "parser completion", false, false, test_complete_names,
+        test_complete_nothing, test_completion_scripts);
+    return a ? 0 : 1;
+}
@@ -0,0 +1,361 @@
+#include "cap.h"
+#include "test.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * Parses random command lines against shared parsers from several threads
+ * at once, and compares each result with the one of a sequential parse. The
+ * threads also parse subcommands whose parsers are built for each parse, and
+ * print help messages. The library is used in its default configuration,
+ * without `CAP_ENABLE_THREADS`.
+ *
+ * A mismatch only shows the effects of some races. `make test.tsan` runs this
+ * test under ThreadSanitizer, with and without `CAP_ENABLE_THREADS`, and fails
+ * on any data race.
+ */
+
+#define LINE_COUNT 1500
+#define MAX_WORDS 16
+#define LONG_LINE_WORDS 40000
+#define THREAD_COUNT 8
+#define MODE_COUNT 6
+
+typedef struct {
+    int mArgc;
+    const char ** mArgv;
+    /// signature of the sequential result of each mode of parsing
+    uint64_t mExpected[MODE_COUNT];
+} _Line;
+
+typedef struct {
+    size_t mThread;
+    size_t mMismatches;
+} _Worker;
+
+static const char * const _VOCABULARY[] = {
+    "-n", "--name", "-x", "-q", "--quiet", "--", "-z", "fast", "slow", "12",
+    "0", "-7", "3.5", "1e3", "abc", "99999999999", "", "2.5e-3", "7", "-h"
+};
+
+static const ArgumentParser * _parser;
+static const CompiledParser * _compiled;
+/// parser whose subcommands "fast" and "slow" take the positionals of
+/// `_parser`, never built by `cap_parser_build_subcommands`
+static const ArgumentParser * _commands;
+static size_t _flag_ids[4];
+static _Line _lines[LINE_COUNT];
+static char _long_words[LONG_LINE_WORDS][16];
+
+static uint64_t _mix(uint64_t hash, const void * data, size_t size) {
+    // FNV-1a
+    const unsigned char * bytes = (const unsigned char *) data;
+    for (size_t i = 0u; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211u;
+    }
+    return hash;
+}
+
+static uint64_t _mix_string(uint64_t hash, const char * string) {
+    return string ? _mix(hash, string, strlen(string) + 1u) : hash;
+}
+
+static uint64_t _mix_value(uint64_t hash, const TypedUnion * value) {
+    if (cap_tu_is_int(value)) {
+        const int i = cap_tu_as_int(value);
+        return _mix(_mix(hash, "i", 1u), &i, sizeof(i));
+    }
+    if (cap_tu_is_double(value)) {
+        const double d = cap_tu_as_double(value);
+        return _mix(_mix(hash, "d", 1u), &d, sizeof(d));
+    }
+    if (cap_tu_is_string(value)) {
+        return _mix_string(_mix(hash, "s", 1u), cap_tu_as_string(value));
+    }
+    return _mix(hash, "p", 1u);
+}
+
+static uint64_t _sign_arguments(uint64_t hash, const ParsedArguments * args) {
+    for (size_t i = 0u; i < 4u; ++i) {
+        const size_t count = cap_pa_flag_count_by_id(args, _flag_ids[i]);
+        hash = _mix(hash, &count, sizeof(count));
+        for (size_t j = 0u; j < count; ++j) {
+            hash = _mix_value(
+                hash, cap_pa_get_flag_i_by_id(args, _flag_ids[i], j));
+        }
+    }
+    for (size_t i = 0u; i < 3u; ++i) {
+        const size_t count = cap_pa_positional_count_by_id(args, i);
+        hash = _mix(hash, &count, sizeof(count));
+        for (size_t j = 0u; j < count; ++j) {
+            hash = _mix_value(
+                hash, cap_pa_get_positional_i_by_id(args, i, j));
+        }
+    }
+    hash = _mix_string(hash, cap_pa_get_subcommand(args));
+    const ParsedArguments * sub = cap_pa_get_subcommand_arguments(args);
+    return sub ? _sign_arguments(hash, sub) : hash;
+}
+
+static uint64_t _sign_result(ParsingResult res) {
+    uint64_t hash = 14695981039346656037u;
+    hash = _mix(hash, &(res.mError), sizeof(res.mError));
+    hash = _mix_string(hash, res.mFirstErrorWord);
+    hash = _mix_string(hash, res.mSecondErrorWord);
+    if (res.mError != PER_NO_ERROR) {
+        return hash;
+    }
+    return _sign_arguments(hash, res.mArguments);
+}
+
+static uint64_t _sign_messages(const _Line * line) {
+    // the help message calls a description provider, the usage string names
+    // the program after the first word of the line
+    char buffer[1024];
+    uint64_t hash = 14695981039346656037u;
+    cap_parser_format_help(_commands, buffer, sizeof(buffer));
+    hash = _mix_string(hash, buffer);
+    cap_parser_format_usage(
+        _commands, line -> mArgv[1 % line -> mArgc], buffer, sizeof(buffer));
+    return _mix_string(hash, buffer);
+}
+
+static uint64_t _parse(const _Line * line, int mode, ParsedArguments * args) {
+    // parses `line` in one of the ways which share a parser, and returns
+    // a signature of the result
+    ParsingResult res;
+    switch (mode) {
+        case 0:
+            res = cap_parser_parse_noexit(
+                _parser, line -> mArgc, line -> mArgv);
+            break;
+        case 1:
+            res = cap_parser_parse_into_noexit(
+                _parser, args, line -> mArgc, line -> mArgv);
+            return _sign_result(res);
+        case 2:
+            res = cap_compiled_parser_parse_noexit(
+                _compiled, line -> mArgc, line -> mArgv);
+            break;
+        case 4:
+            res = cap_parser_parse_noexit(
+                _commands, line -> mArgc, line -> mArgv);
+            break;
+        case 5:
+            return _sign_messages(line);
+        default: {
+            ParserIterator * iter = cap_parser_iter_begin(
+                _parser, line -> mArgc, line -> mArgv);
+            ParsedItem item;
+            uint64_t hash = 14695981039346656037u;
+            while (cap_parser_iter_next_noexit(iter, &item)) {
+                hash = _mix(hash, &(item.mIsFlag), sizeof(item.mIsFlag));
+                hash = _mix(hash, &(item.mId), sizeof(item.mId));
+                hash = _mix_value(hash, &(item.mValue));
+            }
+            res = cap_parser_iter_result(iter);
+            hash = _mix(hash, &(res.mError), sizeof(res.mError));
+            cap_parser_iter_end(iter);
+            return hash;
+        }
+    }
+    const uint64_t hash = _sign_result(res);
+    cap_pa_destroy(res.mArguments);
+    return hash;
+}
+
+static void * _work(void * worker) {
+    _Worker * w = (_Worker *) worker;
+    ParsedArguments * args = cap_pa_make_empty();
+    // each thread starts at a different line, and uses each mode in turn
+    for (size_t i = 0u; i < LINE_COUNT; ++i) {
+        const size_t index = (i + w -> mThread * LINE_COUNT / THREAD_COUNT)
+            % LINE_COUNT;
+        const int mode = (int) ((i + w -> mThread) % MODE_COUNT);
+        const _Line * line = _lines + index;
+        if (_parse(line, mode, args) != line -> mExpected[mode]) {
+            ++w -> mMismatches;
+        }
+    }
+    cap_pa_destroy(args);
+    return NULL;
+}
+
+static void _make_lines() {
+    // a fixed linear congruential generator, so that runs are repeatable
+    uint64_t state = 12345u;
+    const size_t vocabulary_size = sizeof(_VOCABULARY) / sizeof(*_VOCABULARY);
+    for (int i = 0; i < LONG_LINE_WORDS; ++i) {
+        snprintf(_long_words[i], sizeof(_long_words[i]), "%d.%d", i, i % 9);
+    }
+    for (size_t i = 0u; i < LINE_COUNT; ++i) {
+        _Line * line = _lines + i;
+        if (i % 100u == 0u) {
+            // long runs of numbers are converted on several threads
+            line -> mArgc = LONG_LINE_WORDS;
+            line -> mArgv = (const char **) cap_malloc(
+                LONG_LINE_WORDS * sizeof(const char *));
+            for (int j = 0; j < LONG_LINE_WORDS; ++j) {
+                line -> mArgv[j] = _long_words[j];
+            }
+            line -> mArgv[0] = "prog";
+            line -> mArgv[1] = "fast";
+            line -> mArgv[2] = "3";
+            if (i % 200u) {
+                line -> mArgv[30000] = "abc";
+            }
+            continue;
+        }
+        state = state * 6364136223846793005u + 1442695040888963407u;
+        line -> mArgc = 1 + (int) ((state >> 33) % MAX_WORDS);
+        line -> mArgv = (const char **) cap_malloc(
+            (size_t) line -> mArgc * sizeof(const char *));
+        line -> mArgv[0] = "prog";
+        for (int j = 1; j < line -> mArgc; ++j) {
+            state = state * 6364136223846793005u + 1442695040888963407u;
+            line -> mArgv[j] = _VOCABULARY[(state >> 33) % vocabulary_size];
+        }
+    }
+}
+
+static void _make_command(ArgumentParser * parser, void * context) {
+    (void) context;
+    cap_parser_add_positional(
+        parser, "level", DT_INT, false, false, NULL, NULL);
+    cap_parser_add_positional(
+        parser, "rest", DT_DOUBLE, false, true, NULL, NULL);
+}
+
+static const char * _describe(void * context) {
+    return (const char *) context;
+}
+
+static ArgumentParser * _make_commands() {
+    ArgumentParser * p = cap_parser_make_default();
+    cap_parser_add_flag(p, "-n", DT_INT, 0, 3, NULL, NULL);
+    cap_parser_add_flag(p, "--name", DT_STRING, 0, -1, NULL, NULL);
+    cap_parser_add_flag(p, "-x", DT_DOUBLE, 0, 1, NULL, NULL);
+    cap_parser_add_flag(p, "-q", DT_PRESENCE, 0, 2, NULL, NULL);
+    cap_parser_add_subcommand(p, "fast", _make_command, NULL, "Go fast");
+    cap_parser_add_subcommand(p, "slow", _make_command, NULL, NULL);
+    cap_parser_set_description_provider(p, _describe, "Provided");
+    return p;
+}
+
+/**
+ * Test that parsers shared by several threads give the same results as when
+ * they are used by one thread.
+ */
+bool test_concurrent_parsing() {
+    ArgumentParser * p = cap_parser_make_default();
+    _flag_ids[0] = cap_parser_add_flag(p, "-n", DT_INT, 0, 3, NULL, NULL);
+    _flag_ids[1] = cap_parser_add_flag(
+        p, "--name", DT_STRING, 0, -1, NULL, NULL);
+    _flag_ids[2] = cap_parser_add_flag(p, "-x", DT_DOUBLE, 0, 1, NULL, NULL);
+    _flag_ids[3] = cap_parser_add_flag(p, "-q", DT_PRESENCE, 0, 2, NULL, NULL);
+    cap_parser_add_flag_alias(p, "-q", "--quiet");
+    cap_parser_add_positional(p, "mode", DT_STRING, true, false, NULL, NULL);
+    cap_parser_add_positional(p, "level", DT_INT, false, false, NULL, NULL);
+    cap_parser_add_positional(p, "rest", DT_DOUBLE, false, true, NULL, NULL);
+    cap_parser_set_thread_count(p, 2u);
+    _parser = p;
+    CompiledParser * compiled = cap_parser_compile(p);
+    _compiled = compiled;
+    ArgumentParser * commands = _make_commands();
+    _commands = commands;
+    _make_lines();
+    ParsedArguments * args = cap_pa_make_empty();
+    for (size_t i = 0u; i < LINE_COUNT; ++i) {
+        for (int mode = 0; mode < MODE_COUNT; ++mode) {
+            _lines[i].mExpected[mode] = _parse(_lines + i, mode, args);
+        }
+    }
+    cap_pa_destroy(args);
+    pthread_t threads[THREAD_COUNT];
+    _Worker workers[THREAD_COUNT];
+    bool failed = false;
+    for (size_t i = 0u; i < THREAD_COUNT; ++i) {
+        workers[i] = (_Worker) { .mThread = i, .mMismatches = 0u };
+        if (pthread_create(threads + i, NULL, _work, workers + i)) {
+            failed = true;
+            workers[i].mThread = (size_t) -1;
+        }
+    }
+    for (size_t i = 0u; i < THREAD_COUNT; ++i) {
+        if (workers[i].mThread == (size_t) -1) {
+            continue;
+        }
+        pthread_join(threads[i], NULL);
+        if (workers[i].mMismatches) {
+            failed = true;
+        }
+    }
+    for (size_t i = 0u; i < LINE_COUNT; ++i) {
+        cap_free(_lines[i].mArgv);
+    }
+    cap_compiled_parser_destroy(compiled);
+    cap_parser_destroy(commands);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+static ParsingResult _shared_result;
+static uint64_t _shared_signature;
+
+static void * _read(void * mismatches) {
+    for (size_t i = 0u; i < 200u; ++i) {
+        if (_sign_result(_shared_result) != _shared_signature) {
+            ++*(size_t *) mismatches;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Test that one result can be read by several threads at once.
+ */
+bool test_concurrent_reading() {
+    ArgumentParser * p = cap_parser_make_default();
+    _flag_ids[0] = cap_parser_add_flag(p, "-n", DT_INT, 0, -1, NULL, NULL);
+    _flag_ids[1] = cap_parser_add_flag(
+        p, "--name", DT_STRING, 0, -1, NULL, NULL);
+    _flag_ids[2] = cap_parser_add_flag(p, "-x", DT_DOUBLE, 0, 1, NULL, NULL);
+    _flag_ids[3] = cap_parser_add_flag(p, "-q", DT_PRESENCE, 0, 2, NULL, NULL);
+    cap_parser_add_positional(p, "mode", DT_STRING, true, false, NULL, NULL);
+    cap_parser_add_positional(p, "level", DT_INT, false, false, NULL, NULL);
+    cap_parser_add_positional(p, "rest", DT_DOUBLE, false, true, NULL, NULL);
+    const char * a[16] = {
+        "prog", "-n", "1", "-n", "2", "--name", "a", "--name", "b", "-q",
+        "-q", "fast", "3", "1.5", "2.5", "3.5"
+    };
+    _shared_result = cap_parser_parse_noexit(p, 16, a);
+    _shared_signature = _sign_result(_shared_result);
+    pthread_t threads[THREAD_COUNT];
+    size_t mismatches[THREAD_COUNT] = { 0u };
+    bool started[THREAD_COUNT];
+    bool failed = _shared_result.mError != PER_NO_ERROR;
+    for (size_t i = 0u; i < THREAD_COUNT; ++i) {
+        started[i] = !pthread_create(threads + i, NULL, _read, mismatches + i);
+        failed = failed || !started[i];
+    }
+    for (size_t i = 0u; i < THREAD_COUNT; ++i) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        }
+        failed = failed || mismatches[i];
+    }
+    cap_pa_destroy(_shared_result.mArguments);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+int main() {
+    bool a;
+    a = TEST_GROUP(
+        "parser concurrency", false, false, test_concurrent_parsing,
+        test_concurrent_reading);
+    return a ? 0 : 1;
+}
@@ -0,0 +1,203 @@
+#include "cap.h"
+#include "test.h"
+
+#include <errno.h>
+#include <float.h>
+#include <locale.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static uint64_t _random_state = 0x9e3779b97f4a7c15u;
+
+static uint64_t _random() {
+    // xorshift64*
+    _random_state ^= _random_state >> 12;
+    _random_state ^= _random_state << 25;
+    _random_state ^= _random_state >> 27;
+    return _random_state * 2685821657736338717u;
+}
+
+static bool _same_bits(double a, double b) {
+    return !memcmp(&a, &b, sizeof(double));
+}
+
+/**
+ * Compares `_cap_parse_double` to `strtod` in the "C" locale. Out of range
+ * results must be reported as such, valid results must be identical.
+ */
+static bool _agrees_with_strtod(const char * word) {
+    char * end;
+    errno = 0;
+    const double expected = strtod(word, &end);
+    const bool range_error = errno == ERANGE
+        && (expected == 0.0 || expected > DBL_MAX || expected < -DBL_MAX);
+    double v = 0.0;
+    const WordConversionResult result = _cap_parse_double(word, &v);
+    bool agrees;
+    if (*end || end == word) {
+        agrees = result == WCR_INVALID;
+    } else if (range_error) {
+        agrees = result == WCR_OUT_OF_RANGE;
+    } else {
+        agrees = result == WCR_OK
+            && (_same_bits(v, expected) || (v != v && expected != expected));
+    }
+    if (!agrees) {
+        printf(
+            "\n'%s': got %d %.17g, expected %.17g\n",
+            word, result, v, expected);
+    }
+    return agrees;
+}
+
+/**
+ * Test the conversion of doubles printed with various precisions.
+ */
+bool test_double_printed() {
+    static const char * FORMATS[] = {
+        "%.17g", "%.16g", "%.15g", "%.6e", "%.25e"
+    };
+    char word[64];
+    for (int i = 0; i < 200000; ++i) {
+        uint64_t bits = _random();
+        double d;
+        memcpy(&d, &bits, sizeof(d));
+        if (d != d || d > DBL_MAX || d < -DBL_MAX) {
+            continue;
+        }
+        snprintf(word, sizeof(word), FORMATS[i % 5], d);
+        if (!_agrees_with_strtod(word)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Test the conversion of random decimal strings, including long significands
+ * and exponents which are out of range.
+ */
+bool test_double_random_decimal() {
+    char word[128];
+    for (int i = 0; i < 200000; ++i) {
+        char * c = word;
+        const uint64_t r = _random();
+        if (r & 1u) {
+            *c++ = '-';
+        }
+        const int length = 1 + (int) (_random() % 40u);
+        const int point = (int) (_random() % (uint64_t) (length + 1));
+        for (int j = 0; j < length; ++j) {
+            if (j == point) {
+                *c++ = '.';
+            }
+            // many zeros and nines make ties and carries more likely
+            const uint64_t k = _random() % 12u;
+            *c++ = k >= 10u ? (k == 10u ? '0' : '9') : (char) ('0' + k);
+        }
+        if (r & 2u) {
+            c += sprintf(c, "e%d", (int) (_random() % 700u) - 350);
+        }
+        *c = '\0';
+        if (!_agrees_with_strtod(word)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Test known difficult cases.
+ */
+bool test_double_hard_cases() {
+    static const char * CASES[] = {
+        "0", "-0", "0.0e999", "1", "0.1", "1e23", "8.98846567431158e307",
+        "2.2250738585072011e-308", "2.2250738585072014e-308",
+        "4.9406564584124654e-324", "2.4703282292062327e-324",
+        "2.4703282292062328e-324", "1.7976931348623157e308",
+        "1.7976931348623158e308", "1.7976931348623159e308", "1e309",
+        "1e-400", "9007199254740993", "9007199254740992.9999999999999999999",
+        "1.00000000000000011102230246251565404236316680908203125",
+        "1.00000000000000011102230246251565404236316680908203124",
+        "1.00000000000000011102230246251565404236316680908203126",
+        "9007199254740993.0000000000000000000000001",
+        "179769313486231580793728971405301e276",
+        "7.0420557077594588669468784357561207962098443483187940792729600000e59",
+        "123456789012345678901234567890", "000000000000000000000000001.5",
+        "  42.5", "+.5", "5.", "1E5", "1e+05", "0x1.8p3", "-0X.8", "0x1p-1074",
+        "inf", "-Infinity", "nan", "NAN(123_abc)",
+        "", ".", "e5", "1e", "1e+", "1.2.3", "1,5", "0x", "0xp1", "nan(",
+        "infx", "1 ", "--1", "1e5.0", "0x1.8p"
+    };
+    for (size_t i = 0u; i < sizeof(CASES) / sizeof(*CASES); ++i) {
+        if (!_agrees_with_strtod(CASES[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Test that the decimal separator is `.` regardless of the locale.
+ */
+bool test_double_locale() {
+    static const char * LOCALES[] = {
+        "de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "fr_FR.utf8", "de_DE",
+        "fr_FR"
+    };
+    bool failed = false;
+    for (size_t i = 0u; i < sizeof(LOCALES) / sizeof(*LOCALES); ++i) {
+        if (!setlocale(LC_NUMERIC, LOCALES[i])) {
+            continue;
+        }
+        double v = 0.0;
+        do {
+            if (_cap_parse_double("1.5", &v) != WCR_OK || v != 1.5) FB(failed);
+            if (_cap_parse_double("1,5", &v) != WCR_INVALID) FB(failed);
+            // handled by strtod
+            if (_cap_parse_double("0x1.8p1", &v) != WCR_OK) FB(failed);
+            if (v != 3.0) FB(failed);
+            if (_cap_parse_double(
+                    "1.00000000000000011102230246251565404236316680908203126",
+                    &v) != WCR_OK || v <= 1.0) FB(failed);
+        } while (false);
+        break;
+    }
+    setlocale(LC_NUMERIC, "C");
+    return !failed;
+}
+
+/**
+ * Test that doubles out of range are reported by the parser.
+ */
+bool test_double_parser_errors() {
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_add_flag(p, "-x", DT_DOUBLE, 0, 1, NULL, NULL);
+    cap_parser_add_positional(p, "values", DT_DOUBLE, true, true, NULL, NULL);
+    const char * a1[5] = {"prog", "-x", "2.5", "1e-3", "1e999"};
+    const char * a2[4] = {"prog", "-x", "1e-999", "1"};
+    const char * a3[4] = {"prog", "-x", "1,5", "1"};
+    bool failed = false;
+    do {
+        ParsingResult res = cap_parser_parse_noexit(p, 5, a1);
+        if (res.mError != PER_POSITIONAL_OUT_OF_RANGE) FB(failed);
+        if (strcmp(res.mSecondErrorWord, "1e999")) FB(failed);
+        res = cap_parser_parse_noexit(p, 4, a2);
+        if (res.mError != PER_FLAG_OUT_OF_RANGE) FB(failed);
+        res = cap_parser_parse_noexit(p, 4, a3);
+        if (res.mError != PER_CANNOT_PARSE_FLAG) FB(failed);
+    } while (false);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+int main() {
+    bool a;
+    a = TEST_GROUP(
+        "parser double", false, false, test_double_printed,
+        test_double_random_decimal, test_double_hard_cases, test_double_locale,
+        test_double_parser_errors);
+    return a ? 0 : 1;
+}
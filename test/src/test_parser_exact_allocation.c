@@ -0,0 +1,140 @@
+#include "cap.h"
+#include "test.h"
+
+#include <string.h>
+
+static ArgumentParser * _make_parser(bool exact, bool borrow) {
+    ArgumentParser * p = cap_parser_make_default();
+    cap_parser_enable_exact_allocation(p, exact);
+    cap_parser_enable_borrowed_strings(p, borrow);
+    cap_parser_add_flag(p, "--name", DT_STRING, 0, 3, NULL, NULL);
+    cap_parser_add_flag_alias(p, "--name", "-n");
+    cap_parser_add_flag(p, "--verbose", DT_PRESENCE, 0, -1, NULL, NULL);
+    cap_parser_add_flag(p, "--ratio", DT_DOUBLE, 0, 1, NULL, NULL);
+    cap_parser_add_positional(p, "mode", DT_INT, true, false, NULL, NULL);
+    cap_parser_add_positional(p, "files", DT_STRING, false, true, NULL, NULL);
+    return p;
+}
+
+static bool _same_values(
+        const ParsedArguments * a, const ParsedArguments * b) {
+    for (size_t i = 0u; i < cap_nva_length(a -> mFlags); ++i) {
+        if (cap_pa_flag_count_by_id(a, i) != cap_pa_flag_count_by_id(b, i)) {
+            return false;
+        }
+    }
+    for (size_t i = 0u; i < cap_nva_length(a -> mPositionals); ++i) {
+        const size_t count = cap_pa_positional_count_by_id(a, i);
+        if (count != cap_pa_positional_count_by_id(b, i)) {
+            return false;
+        }
+        for (size_t j = 0u; j < count; ++j) {
+            const TypedUnion * x = cap_pa_get_positional_i_by_id(a, i, j);
+            const TypedUnion * y = cap_pa_get_positional_i_by_id(b, i, j);
+            if (x -> mType != y -> mType) {
+                return false;
+            }
+            if (cap_tu_is_string(x) 
+                    && strcmp(cap_tu_as_string(x), cap_tu_as_string(y))) {
+                return false;
+            }
+            if (cap_tu_is_int(x) && cap_tu_as_int(x) != cap_tu_as_int(y)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Test that exact allocation gives the same results in a single full chunk.
+ */
+bool test_exact_allocation_results() {
+    const char * a[12] = {
+        "prog", "-n", "first", "--verbose", "3", "a.txt", "--name", "second",
+        "b.txt", "--", "--verbose", "-n"
+    };
+    bool failed = false;
+    for (int borrow = 0; borrow < 2 && !failed; ++borrow) {
+        ArgumentParser * p = _make_parser(false, borrow);
+        ArgumentParser * q = _make_parser(true, borrow);
+        ParsingResult r1 = cap_parser_parse_noexit(p, 12, a);
+        ParsingResult r2 = cap_parser_parse_noexit(q, 12, a);
+        do {
+            if (r1.mError != PER_NO_ERROR) FB(failed);
+            if (r2.mError != PER_NO_ERROR) FB(failed);
+            if (!_same_values(r1.mArguments, r2.mArguments)) FB(failed);
+            if (cap_pa_positional_count(r2.mArguments, "files") != 4u) FB(failed);
+            if (strcmp(cap_tu_as_string(
+                    cap_pa_get_flag_i(r2.mArguments, "--name", 1)), "second")) FB(failed);
+            const Arena * arena = r2.mArguments -> mArena;
+            if (cap_arena_used(arena) != cap_arena_size(arena)) FB(failed);
+        } while (false);
+        cap_pa_destroy(r1.mArguments);
+        cap_pa_destroy(r2.mArguments);
+        cap_parser_destroy(p);
+        cap_parser_destroy(q);
+    }
+    return !failed;
+}
+
+/**
+ * Test that many values of a variadic positional are allocated exactly.
+ */
+bool test_exact_allocation_many_values() {
+    enum { COUNT = 10000 };
+    static const char * a[COUNT + 2];
+    a[0] = "prog";
+    a[1] = "1";
+    for (size_t i = 2u; i < COUNT + 2; ++i) {
+        a[i] = (i % 2u) ? "odd.txt" : "even.txt";
+    }
+    ArgumentParser * p = _make_parser(true, false);
+    ParsingResult res = cap_parser_parse_noexit(p, COUNT + 2, a);
+    cap_parser_destroy(p);
+    bool failed = false;
+    do {
+        if (res.mError != PER_NO_ERROR) FB(failed);
+        if (cap_pa_positional_count(res.mArguments, "files") != COUNT) FB(failed);
+        const Arena * arena = res.mArguments -> mArena;
+        if (cap_arena_used(arena) != cap_arena_size(arena)) FB(failed);
+    } while (false);
+    cap_pa_destroy(res.mArguments);
+    return !failed;
+}
+
+/**
+ * Test that errors are reported as without exact allocation.
+ */
+bool test_exact_allocation_errors() {
+    ArgumentParser * p = _make_parser(true, false);
+    const char * a1[4] = {"prog", "1", "--unknown", "x"};
+    const char * a2[6] = {"prog", "1", "--ratio", "1", "--ratio", "2"};
+    const char * a3[3] = {"prog", "1", "--name"};
+    const char * a4[3] = {"prog", "1", "-h"};
+    const char * a5[2] = {"prog", "x"};
+    bool failed = false;
+    do {
+        ParsingResult res = cap_parser_parse_noexit(p, 4, a1);
+        if (res.mError != PER_UNKNOWN_FLAG) FB(failed);
+        res = cap_parser_parse_noexit(p, 6, a2);
+        if (res.mError != PER_TOO_MANY_FLAGS) FB(failed);
+        res = cap_parser_parse_noexit(p, 3, a3);
+        if (res.mError != PER_MISSING_FLAG_VALUE) FB(failed);
+        res = cap_parser_parse_noexit(p, 3, a4);
+        if (res.mError != PER_HELP) FB(failed);
+        res = cap_parser_parse_noexit(p, 2, a5);
+        if (res.mError != PER_CANNOT_PARSE_POSITIONAL) FB(failed);
+    } while (false);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+int main() {
+    bool a;
+    a = TEST_GROUP(
+        "parser: exact allocation", false, false,
+        test_exact_allocation_results, test_exact_allocation_many_values,
+        test_exact_allocation_errors);
+    return a ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+#include "cap.h"
+#include "test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static ArgumentParser * _make_parser() {
+    ArgumentParser * p = cap_parser_make_default();
+    cap_parser_set_description(p, "Resizes things");
+    cap_parser_add_flag(p, "--size", DT_INT, 1, 1, NULL, "New size");
+    cap_parser_add_flag_alias(p, "--size", "-s");
+    cap_parser_add_flag(p, "--quiet", DT_PRESENCE, 0, 1, NULL, NULL);
+    cap_parser_add_positional(p, "file", DT_STRING, true, false, NULL, NULL);
+    cap_parser_add_positional(p, "rest", DT_STRING, false, true, "...", NULL);
+    return p;
+}
+
+static const char USAGE[] = "usage:\n\tprog [-h] -s INT [--quiet] [--] <file>"
+    " [...]\n";
+
+static const char HELP[] = "Resizes things\n"
+    "\nAvailable flags:\n"
+    "-h \n\tDisplay this help message and exit\n"
+    "-- \n\tTreat all following command line arguments as positionals\n"
+    "--size INT\n-s INT\n\tNew size\n"
+    "--quiet \n"
+    "\nPositional Arguments:\n"
+    "file\n...\n";
+
+static size_t _print(const ArgumentParser * p, bool help, char * buffer) {
+    FILE * file = tmpfile();
+    if (!file) {
+        return 0u;
+    }
+    if (help) {
+        cap_parser_print_help(p, file);
+    }
+    else {
+        cap_parser_print_usage(p, file, "/bin/prog");
+    }
+    rewind(file);
+    const size_t length = fread(buffer, 1u, 1023u, file);
+    buffer[length] = '\0';
+    fclose(file);
+    return length;
+}
+
+/**
+ * Test that formatted and printed messages are the same, and that they are
+ * truncated like `snprintf` truncates.
+ */
+bool test_format_messages() {
+    ArgumentParser * p = _make_parser();
+    char buffer[1024];
+    char printed[1024];
+    bool failed = false;
+    do {
+        size_t length = cap_parser_format_usage(
+            p, "/bin/prog", buffer, sizeof(buffer));
+        if (length != strlen(USAGE) || strcmp(buffer, USAGE)) FB(failed);
+        if (_print(p, false, printed) != length || strcmp(printed, USAGE)) {
+            FB(failed);
+        }
+        length = cap_parser_format_help(p, buffer, sizeof(buffer));
+        if (length != strlen(HELP) || strcmp(buffer, HELP)) FB(failed);
+        if (_print(p, true, printed) != length || strcmp(printed, HELP)) {
+            FB(failed);
+        }
+        if (cap_parser_format_help(p, NULL, 0u) != length) FB(failed);
+        if (cap_parser_format_usage(p, "prog", buffer, 10u) != strlen(USAGE)
+                || strcmp(buffer, "usage:\n\tp")) {
+            FB(failed);
+        }
+        if (cap_parser_format_help(p, buffer, 1u) != length || *buffer) {
+            FB(failed);
+        }
+        cap_parser_set_custom_usage(p, "prog FILE");
+        cap_parser_enable_help(p, false);
+        if (cap_parser_format_usage(p, "prog", buffer, sizeof(buffer)) != 10u
+                || strcmp(buffer, "prog FILE\n")
+                || cap_parser_format_help(p, buffer, sizeof(buffer))
+                || *buffer) {
+            FB(failed);
+        }
+    } while (false);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+static const char * _describe(void * context) {
+    ++*(int *) context;
+    return "Provided";
+}
+
+/**
+ * Test that messages are rendered for each print unless they are prepared,
+ * that prepared messages are kept until the configuration changes, and that
+ * description providers are called for each print.
+ */
+bool test_format_cache() {
+    ArgumentParser * p = _make_parser();
+    char buffer[1024];
+    char prepared[1024];
+    bool failed = false;
+    int calls = 0;
+    do {
+        cap_parser_format_help(p, buffer, sizeof(buffer));
+        cap_parser_prepare_help(p);
+        cap_parser_format_help(p, prepared, sizeof(prepared));
+        if (strcmp(buffer, prepared) || strcmp(prepared, HELP)) FB(failed);
+        cap_parser_add_flag(p, "--level", DT_DOUBLE, 0, 1, "L", NULL);
+        cap_parser_format_help(p, buffer, sizeof(buffer));
+        if (!strstr(buffer, "--level L\n")) FB(failed);
+        cap_parser_format_usage(p, "prog", buffer, sizeof(buffer));
+        if (!strstr(buffer, "[--quiet] [--level L]")) FB(failed);
+
+        cap_parser_set_epilogue_provider(p, _describe, &calls);
+        cap_parser_prepare_help(p);
+        cap_parser_format_help(p, buffer, sizeof(buffer));
+        cap_parser_format_help(p, buffer, sizeof(buffer));
+        if (calls != 2 || !strstr(buffer, "\nProvided\n")) FB(failed);
+
+        CompiledParser * cp = cap_parser_compile(p);
+        char compiled[1024];
+        cap_compiled_parser_format_help(cp, compiled, sizeof(compiled));
+        if (calls != 3 || strcmp(buffer, compiled)) FB(failed);
+        cap_compiled_parser_destroy(cp);
+    } while (false);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+int main() {
+    bool a;
+    a = TEST_GROUP(
+        "parser format", false, false, test_format_messages,
+        test_format_cache);
+    return a ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+#include "cap.h"
+#include "test.h"
+
+#include <string.h>
+
+/**
+ * Test that ids are returned by the parser and can be looked up.
+ */
+bool test_ids_config() {
+    ArgumentParser * p = cap_parser_make_default();
+    size_t f0 = cap_parser_add_flag(p, "--alpha", DT_INT, 0, 1, NULL, NULL);
+    size_t f1 = cap_parser_add_flag(p, "--beta", DT_PRESENCE, 0, -1, NULL, NULL);
+    cap_parser_add_flag_alias(p, "--beta", "-b");
+    size_t p0 = cap_parser_add_positional(p, "in", DT_STRING, true, false, NULL, NULL);
+    size_t p1 = cap_parser_add_positional(p, "out", DT_STRING, false, false, NULL, NULL);
+    bool failed = false;
+    size_t id = 42u;
+    do {
+        if (f0 != 0u || f1 != 1u) FB(failed);
+        if (p0 != 0u || p1 != 1u) FB(failed);
+        if (!cap_parser_get_flag_id(p, "--beta", &id) || id != 1u) FB(failed);
+        if (!cap_parser_get_flag_id(p, "-b", &id) || id != 1u) FB(failed);
+        if (cap_parser_get_flag_id(p, "--help", &id)) FB(failed);
+        if (cap_parser_get_flag_id(p, "--gamma", &id)) FB(failed);
+        if (!cap_parser_get_positional_id(p, "out", &id) || id != 1u) FB(failed);
+        if (cap_parser_get_positional_id(p, "--alpha", &id)) FB(failed);
+    } while (false);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+/**
+ * Test that parsed values can be accessed by id.
+ */
+bool test_ids_access() {
+    ArgumentParser * p = cap_parser_make_default();
+    size_t alpha = cap_parser_add_flag(p, "--alpha", DT_INT, 0, 1, NULL, NULL);
+    size_t beta = cap_parser_add_flag(p, "--beta", DT_PRESENCE, 0, -1, NULL, NULL);
+    size_t gamma = cap_parser_add_flag(p, "--gamma", DT_PRESENCE, 0, 1, NULL, NULL);
+    cap_parser_add_flag_alias(p, "--beta", "-b");
+    size_t in = cap_parser_add_positional(p, "in", DT_STRING, true, false, NULL, NULL);
+    size_t nums = cap_parser_add_positional(p, "nums", DT_INT, false, true, NULL, NULL);
+
+    const char * a[7] = {"prog", "-b", "file", "--alpha", "7", "1", "2"};
+    ParsingResult res = cap_parser_parse_noexit(p, 7, a);
+    ParsedArguments * pa = res.mArguments;
+    bool failed = false;
+    do {
+        if (res.mError != PER_NO_ERROR) FB(failed);
+        if (!cap_pa_has_flag_by_id(pa, alpha)) FB(failed);
+        if (cap_tu_as_int(cap_pa_get_flag_by_id(pa, alpha)) != 7) FB(failed);
+        if (cap_pa_flag_count_by_id(pa, beta) != 1u) FB(failed);
+        if (cap_pa_has_flag_by_id(pa, gamma)) FB(failed);
+        if (cap_pa_get_flag_by_id(pa, gamma)) FB(failed);
+        if (cap_pa_has_flag_by_id(pa, 100u)) FB(failed);
+        if (cap_pa_get_flag_i_by_id(pa, beta, 1u)) FB(failed);
+        if (strcmp(cap_tu_as_string(cap_pa_get_positional_by_id(pa, in)), "file")) FB(failed);
+        if (cap_pa_positional_count_by_id(pa, nums) != 2u) FB(failed);
+        if (cap_tu_as_int(cap_pa_get_positional_i_by_id(pa, nums, 1u)) != 2) FB(failed);
+        if (cap_pa_has_positional_by_id(pa, 2u)) FB(failed);
+        // access by name still works
+        if (cap_tu_as_int(cap_pa_get_flag(pa, "--alpha")) != 7) FB(failed);
+        if (cap_pa_positional_count(pa, "nums") != 2u) FB(failed);
+    } while (false);
+    cap_pa_destroy(pa);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+/**
+ * Test that a missing required positional is detected after optional ones.
+ */
+bool test_ids_missing_positional() {
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_add_positional(p, "a", DT_STRING, true, false, NULL, NULL);
+    cap_parser_add_positional(p, "b", DT_STRING, true, false, NULL, NULL);
+    const char * a[2] = {"prog", "x"};
+    ParsingResult res = cap_parser_parse_noexit(p, 2, a);
+    bool failed = res.mError != PER_NOT_ENOUGH_POSITIONALS;
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+int main() {
+    bool a;
+    a = TEST_GROUP(
+        "parser ids", false, false, test_ids_config, test_ids_access,
+        test_ids_missing_positional);
+    return a ? 0 : 1;
+}
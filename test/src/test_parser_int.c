@@ -0,0 +1,118 @@
+#include "cap.h"
+#include "test.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+static ParsingResult _parse_int_flag(
+        ArgumentParser ** parser, const char * word) {
+    *parser = cap_parser_make_empty();
+    cap_parser_add_flag(*parser, "-n", DT_INT, 0, 1, NULL, NULL);
+    const char * a[3] = {"prog", "-n", word};
+    return cap_parser_parse_noexit(*parser, 3, a);
+}
+
+/**
+ * Test that valid integers in all bases are accepted, including the limits.
+ */
+bool test_int_valid() {
+    static const struct {
+        const char * mWord;
+        int mValue;
+    } CASES[] = {
+        {"0", 0}, {"7", 7}, {"-7", -7}, {"+7", 7}, {"010", 8}, {"-010", -8},
+        {"0x1f", 31}, {"0X1F", 31}, {"-0xA", -10}, {"  42", 42},
+        {"2147483647", INT_MAX}, {"-2147483648", INT_MIN},
+        {"0x7fffffff", INT_MAX}, {"-0x80000000", INT_MIN},
+        {"017777777777", INT_MAX}, {"000000000000000000000012", 10}
+    };
+    bool failed = false;
+    for (size_t i = 0u; i < sizeof(CASES) / sizeof(*CASES) && !failed; ++i) {
+        ArgumentParser * p;
+        ParsingResult res = _parse_int_flag(&p, CASES[i].mWord);
+        if (res.mError != PER_NO_ERROR) {
+            failed = true;
+        } else if (cap_tu_as_int(cap_pa_get_flag(res.mArguments, "-n"))
+                != CASES[i].mValue) {
+            failed = true;
+        }
+        // agrees with sscanf for values which fit
+        int v = 0;
+        if (!failed && (sscanf(CASES[i].mWord, "%i", &v) != 1
+                || v != CASES[i].mValue)) {
+            failed = true;
+        }
+        cap_pa_destroy(res.mArguments);
+        cap_parser_destroy(p);
+    }
+    return !failed;
+}
+
+/**
+ * Test that malformed integers are rejected.
+ */
+bool test_int_invalid() {
+    static const char * CASES[] = {
+        "", "-", "+", "0x", "08", "12a", "1 ", "- 1", "--1", "0xg", "1.0",
+        "abc", "0x-1", "99999999999999999999x"
+    };
+    bool failed = false;
+    for (size_t i = 0u; i < sizeof(CASES) / sizeof(*CASES) && !failed; ++i) {
+        ArgumentParser * p;
+        ParsingResult res = _parse_int_flag(&p, CASES[i]);
+        if (res.mError != PER_CANNOT_PARSE_FLAG) FB(failed);
+        if (strcmp(res.mSecondErrorWord, CASES[i])) FB(failed);
+        cap_parser_destroy(p);
+    }
+    return !failed;
+}
+
+/**
+ * Test that integers which do not fit into `int` are reported as out of
+ * range for flags.
+ */
+bool test_int_flag_out_of_range() {
+    static const char * CASES[] = {
+        "2147483648", "-2147483649", "0x80000000", "-0x80000001",
+        "020000000000", "99999999999999999999999999"
+    };
+    bool failed = false;
+    for (size_t i = 0u; i < sizeof(CASES) / sizeof(*CASES) && !failed; ++i) {
+        ArgumentParser * p;
+        ParsingResult res = _parse_int_flag(&p, CASES[i]);
+        if (res.mError != PER_FLAG_OUT_OF_RANGE) FB(failed);
+        if (strcmp(res.mFirstErrorWord, "-n")) FB(failed);
+        if (strcmp(res.mSecondErrorWord, CASES[i])) FB(failed);
+        if (res.mArguments) FB(failed);
+        cap_parser_destroy(p);
+    }
+    return !failed;
+}
+
+/**
+ * Test that integers which do not fit into `int` are reported as out of
+ * range for positionals.
+ */
+bool test_int_positional_out_of_range() {
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_add_positional(p, "nums", DT_INT, true, true, NULL, NULL);
+    const char * a[4] = {"prog", "1", "3000000000", "2"};
+    ParsingResult res = cap_parser_parse_noexit(p, 4, a);
+    bool failed = false;
+    do {
+        if (res.mError != PER_POSITIONAL_OUT_OF_RANGE) FB(failed);
+        if (strcmp(res.mFirstErrorWord, "nums")) FB(failed);
+        if (strcmp(res.mSecondErrorWord, "3000000000")) FB(failed);
+    } while (false);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+int main() {
+    bool a;
+    a = TEST_GROUP(
+        "parser int", false, false, test_int_valid, test_int_invalid,
+        test_int_flag_out_of_range, test_int_positional_out_of_range);
+    return a ? 0 : 1;
+}
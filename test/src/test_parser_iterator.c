@@ -0,0 +1,232 @@
+#include "cap.h"
+#include "test.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static ArgumentParser * _make_parser() {
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_set_help_flag(p, "-h", NULL);
+    cap_parser_set_flag_separator(p, "--", NULL);
+    cap_parser_add_flag(p, "-v", DT_PRESENCE, 0, 2, NULL, NULL);
+    cap_parser_add_flag_alias(p, "-v", "--verbose");
+    cap_parser_add_flag(p, "-s", DT_DOUBLE, 1, -1, NULL, NULL);
+    cap_parser_add_positional(p, "name", DT_STRING, true, false, NULL, NULL);
+    cap_parser_add_positional(p, "nums", DT_INT, true, true, NULL, NULL);
+    return p;
+}
+
+/**
+ * Test that flags and positionals are yielded in the order of the words,
+ * with the same values as stored by `cap_parser_parse_noexit`.
+ */
+bool test_iter_order() {
+    ArgumentParser * p = _make_parser();
+    const char * a[10] = {
+        "prog", "--verbose", "file", "-s", "1.5", "3", "4", "-v", "--", "-5"
+    };
+    ParserIterator * iter = cap_parser_iter_begin(p, 10, a);
+    ParsingResult res = cap_parser_parse_noexit(p, 10, a);
+    bool failed = false;
+    do {
+        if (res.mError != PER_NO_ERROR) FB(failed);
+        static const bool IS_FLAG[7] = {
+            true, false, true, false, false, true, false
+        };
+        static const char * NAMES[7] = {
+            "-v", "name", "-s", "nums", "nums", "-v", "nums"
+        };
+        ParsedItem item;
+        size_t nums = 0u;
+        for (size_t i = 0u; i < 7u; ++i) {
+            if (!cap_parser_iter_next_noexit(iter, &item)) FB(failed);
+            if (item.mIsFlag != IS_FLAG[i] || strcmp(item.mName, NAMES[i])) {
+                FB(failed);
+            }
+            size_t id;
+            if (item.mIsFlag
+                    ? !cap_parser_get_flag_id(p, item.mName, &id)
+                    : !cap_parser_get_positional_id(p, item.mName, &id)) {
+                FB(failed);
+            }
+            if (id != item.mId) FB(failed);
+            if (item.mIsFlag) {
+                continue;
+            }
+            const TypedUnion * expected = cap_pa_get_positional_i(
+                res.mArguments, item.mName, item.mId ? nums++ : 0u);
+            if (item.mId ? cap_tu_as_int(expected)
+                    != cap_tu_as_int(&(item.mValue))
+                    : strcmp(cap_tu_as_string(expected),
+                        cap_tu_as_string(&(item.mValue)))) {
+                FB(failed);
+            }
+        }
+        if (failed) {
+            break;
+        }
+        if (cap_tu_as_double(cap_pa_get_flag(res.mArguments, "-s")) != 1.5) {
+            FB(failed);
+        }
+        if (cap_parser_iter_next_noexit(iter, &item)) FB(failed);
+        if (cap_parser_iter_next_noexit(iter, &item)) FB(failed);
+        if (cap_parser_iter_result(iter).mError != PER_NO_ERROR) FB(failed);
+    } while (false);
+    cap_parser_iter_end(iter);
+    cap_pa_destroy(res.mArguments);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+/**
+ * Test that numeric values of a variadic positional are yielded one by one
+ * across chunks, and that a word which cannot be converted is reported after
+ * the values before it.
+ */
+bool test_iter_batches() {
+    ArgumentParser * p = _make_parser();
+    static char storage[1000][16];
+    const char * a[1005];
+    a[0] = "prog";
+    a[1] = "-s";
+    a[2] = "2";
+    a[3] = "name";
+    for (int i = 0; i < 1000; ++i) {
+        snprintf(storage[i], sizeof(storage[i]), "%d", i * 3);
+        a[i + 4] = storage[i];
+    }
+    bool failed = false;
+    for (int round = 0; round < 2 && !failed; ++round) {
+        if (round) {
+            a[700] = "12x";
+        }
+        ParserIterator * iter = cap_parser_iter_begin(p, 1004, a);
+        ParsedItem item;
+        int count = 0;
+        while (cap_parser_iter_next_noexit(iter, &item)) {
+            if (item.mIsFlag || item.mId != 1u) {
+                continue;
+            }
+            if (cap_tu_as_int(&(item.mValue)) != count * 3) {
+                failed = true;
+                break;
+            }
+            ++count;
+        }
+        const ParsingResult res = cap_parser_iter_result(iter);
+        if (!round && (res.mError != PER_NO_ERROR || count != 1000)) {
+            failed = true;
+        }
+        if (round && (res.mError != PER_CANNOT_PARSE_POSITIONAL
+                || res.mSecondErrorWord != a[700] || count != 696)) {
+            failed = true;
+        }
+        cap_parser_iter_end(iter);
+    }
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+/**
+ * Test errors, including the ones reported after the last value.
+ */
+bool test_iter_errors() {
+    ArgumentParser * p = _make_parser();
+    const char * a[6] = {"prog", "-s", "1", "name", "-v", "-x"};
+    bool failed = false;
+    ParsedItem item;
+    ParserIterator * iter = NULL;
+    do {
+        // an unknown flag
+        iter = cap_parser_iter_begin(p, 6, a);
+        int count = 0;
+        while (cap_parser_iter_next_noexit(iter, &item)) {
+            ++count;
+        }
+        if (count != 3) FB(failed);
+        ParsingResult res = cap_parser_iter_result(iter);
+        if (res.mError != PER_UNKNOWN_FLAG || res.mFirstErrorWord != a[5]) {
+            FB(failed);
+        }
+        if (res.mArguments) FB(failed);
+        cap_parser_iter_end(iter);
+        // a required positional is missing
+        iter = cap_parser_iter_begin(p, 5, a);
+        while (cap_parser_iter_next_noexit(iter, &item)) {
+        }
+        if (cap_parser_iter_result(iter).mError != PER_NOT_ENOUGH_POSITIONALS) {
+            FB(failed);
+        }
+        cap_parser_iter_end(iter);
+        // a flag is given too many times
+        const char * c[4] = {"prog", "-v", "--verbose", "-v"};
+        iter = cap_parser_iter_begin(p, 4, c);
+        while (cap_parser_iter_next_noexit(iter, &item)) {
+        }
+        if (cap_parser_iter_result(iter).mError != PER_TOO_MANY_FLAGS) {
+            FB(failed);
+        }
+        cap_parser_iter_end(iter);
+        // a flag is missing and the help flag
+        const char * b[4] = {"prog", "name", "7", "-h"};
+        iter = cap_parser_iter_begin(p, 3, b);
+        while (cap_parser_iter_next_noexit(iter, &item)) {
+        }
+        res = cap_parser_iter_result(iter);
+        if (res.mError != PER_NOT_ENOUGH_FLAGS
+                || strcmp(res.mFirstErrorWord, "-s")) {
+            FB(failed);
+        }
+        cap_parser_iter_end(iter);
+        iter = cap_parser_iter_begin(p, 4, b);
+        while (cap_parser_iter_next_noexit(iter, &item)) {
+        }
+        if (cap_parser_iter_result(iter).mError != PER_HELP) FB(failed);
+        cap_parser_iter_end(iter);
+        iter = NULL;
+    } while (false);
+    cap_parser_iter_end(iter);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+static void _make_command(ArgumentParser * parser, void * context) {
+    (void) parser;
+    (void) context;
+}
+
+/**
+ * Test that a parser with subcommands is rejected, instead of reporting
+ * the subcommand as a positional.
+ */
+bool test_iter_subcommands() {
+    ArgumentParser * q = cap_parser_make_default();
+    cap_parser_add_subcommand(q, "run", _make_command, NULL, NULL);
+    const char * a[2] = {"prog", "run"};
+    bool failed = false;
+    fflush(stdout);
+    const pid_t child = fork();
+    if (!child) {
+        // the error message is expected
+        freopen("/dev/null", "w", stderr);
+        cap_parser_iter_end(cap_parser_iter_begin(q, 2, a));
+        _exit(0);
+    }
+    int status = 0;
+    if (child < 0 || waitpid(child, &status, 0) != child
+            || !WIFEXITED(status) || !WEXITSTATUS(status)) {
+        failed = true;
+    }
+    cap_parser_destroy(q);
+    return !failed;
+}
+
+int main() {
+    bool a;
+    a = TEST_GROUP(
+        "parser iterator", false, false, test_iter_order, test_iter_batches,
+        test_iter_errors, test_iter_subcommands);
+    return a ? 0 : 1;
+}
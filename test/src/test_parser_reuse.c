@@ -0,0 +1,119 @@
+#include "cap.h"
+#include "test.h"
+
+#include <string.h>
+
+static ArgumentParser * _make_parser(bool exact) {
+    ArgumentParser * p = cap_parser_make_default();
+    cap_parser_enable_exact_allocation(p, exact);
+    cap_parser_add_flag(p, "--name", DT_STRING, 0, -1, NULL, NULL);
+    cap_parser_add_flag(p, "--level", DT_INT, 0, 1, NULL, NULL);
+    cap_parser_add_positional(p, "files", DT_STRING, true, true, NULL, NULL);
+    return p;
+}
+
+/**
+ * Test that repeated parsing into the same object gives correct results and
+ * stops growing its memory.
+ */
+bool test_reuse_repeated() {
+    const char * a1[6] = {"prog", "--name", "x", "a", "b", "c"};
+    const char * a2[4] = {"prog", "--level", "7", "d"};
+    bool failed = false;
+    for (int exact = 0; exact < 2 && !failed; ++exact) {
+        ArgumentParser * p = _make_parser(exact);
+        ParsedArguments * pa = cap_pa_make_empty();
+        size_t size = 0u;
+        for (int i = 0; i < 10 && !failed; ++i) {
+            ParsingResult res = cap_parser_parse_into_noexit(p, pa, 6, a1);
+            if (res.mError != PER_NO_ERROR || res.mArguments != pa) FB(failed);
+            if (cap_pa_positional_count(pa, "files") != 3u) FB(failed);
+            if (strcmp(cap_tu_as_string(cap_pa_get_flag(pa, "--name")), "x")) FB(failed);
+            if (cap_pa_has_flag(pa, "--level")) FB(failed);
+
+            res = cap_parser_parse_into_noexit(p, pa, 4, a2);
+            if (res.mError != PER_NO_ERROR) FB(failed);
+            if (cap_pa_positional_count(pa, "files") != 1u) FB(failed);
+            if (cap_pa_has_flag(pa, "--name")) FB(failed);
+            if (cap_tu_as_int(cap_pa_get_flag_by_id(pa, 1u)) != 7) FB(failed);
+            if (i == 1) {
+                size = cap_arena_size(pa -> mArena);
+            }
+            if (i > 1 && cap_arena_size(pa -> mArena) != size) FB(failed);
+        }
+        cap_pa_destroy(pa);
+        cap_parser_destroy(p);
+    }
+    return !failed;
+}
+
+/**
+ * Test that an object can be reused after a parsing error.
+ */
+bool test_reuse_after_error() {
+    ArgumentParser * p = _make_parser(false);
+    ParsedArguments * pa = cap_pa_make_empty();
+    const char * a1[4] = {"prog", "a", "--level", "x"};
+    const char * a2[2] = {"prog", "b"};
+    bool failed = false;
+    do {
+        ParsingResult res = cap_parser_parse_into_noexit(p, pa, 4, a1);
+        if (res.mError != PER_CANNOT_PARSE_FLAG || res.mArguments) FB(failed);
+        res = cap_parser_parse_into_noexit(p, pa, 2, a2);
+        if (res.mError != PER_NO_ERROR) FB(failed);
+        if (strcmp(cap_tu_as_string(cap_pa_get_positional(pa, "files")), "b")) FB(failed);
+    } while (false);
+    cap_pa_destroy(pa);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+/**
+ * Test resetting an object filled by hand.
+ */
+bool test_reset() {
+    ParsedArguments * pa = cap_pa_make_reserved(1u, 0u);
+    bool failed = false;
+    do {
+        cap_pa_add_flag_at(pa, 0u, "-a", cap_tu_make_string("owned"));
+        cap_pa_add_flag(pa, "-b", cap_tu_make_int(1));
+        cap_pa_append_positional(pa, "p", cap_tu_make_string("value"));
+        cap_pa_reset(pa);
+        if (cap_pa_has_flag(pa, "-a") || cap_pa_has_flag(pa, "-b")) FB(failed);
+        if (cap_pa_has_positional(pa, "p")) FB(failed);
+        // all ids stay reserved
+        if (cap_nva_length(pa -> mFlags) != 2u) FB(failed);
+        cap_pa_add_flag(pa, "-b", cap_tu_make_int(2));
+        if (!cap_pa_has_flag_by_id(pa, 2u)) FB(failed);
+        if (cap_tu_as_int(cap_pa_get_flag(pa, "-b")) != 2) FB(failed);
+        cap_pa_add_flag_at(pa, 1u, "-c", cap_tu_make_int(3));
+        if (cap_tu_as_int(cap_pa_get_flag(pa, "-c")) != 3) FB(failed);
+    } while (false);
+    cap_pa_destroy(pa);
+    return !failed;
+}
+
+/**
+ * Test that a compiled parser can parse into an existing object.
+ */
+bool test_reuse_compiled() {
+    ArgumentParser * p = _make_parser(true);
+    CompiledParser * cp = cap_parser_compile(p);
+    cap_parser_destroy(p);
+    ParsedArguments * pa = cap_pa_make_empty();
+    const char * a[3] = {"prog", "a", "b"};
+    ParsingResult res = cap_compiled_parser_parse_into_noexit(cp, pa, 3, a);
+    bool failed = res.mError != PER_NO_ERROR 
+        || cap_pa_positional_count(pa, "files") != 2u;
+    cap_pa_destroy(pa);
+    cap_compiled_parser_destroy(cp);
+    return !failed;
+}
+
+int main() {
+    bool a;
+    a = TEST_GROUP(
+        "parser: reuse", false, false, test_reuse_repeated,
+        test_reuse_after_error, test_reset, test_reuse_compiled);
+    return a ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+#include "cap.h"
+#include "test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static void _configure(ArgumentParser * p) {
+    cap_parser_set_description(p, "A program with a description");
+    cap_parser_set_epilogue(p, "And an epilogue");
+    cap_parser_add_flag(p, "--size", DT_INT, 0, 1, "SIZE", "Size of a thing");
+    cap_parser_add_flag_alias(p, "--size", "-s");
+    cap_parser_add_positional(p, "file", DT_STRING, true, false, "FILE", "");
+}
+
+static size_t _count_allocations(bool static_strings) {
+    TestCounters counters = { 0u, 0u, 0u };
+    const Allocator counting = TEST_COUNTING_ALLOCATOR(&counters);
+    const Allocator previous = cap_allocator_get();
+    cap_allocator_set(&counting);
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_enable_static_strings(p, static_strings);
+    _configure(p);
+    const size_t allocations = counters.mAllocations;
+    cap_parser_destroy(p);
+    cap_allocator_set(&previous);
+    return allocations;
+}
+
+/**
+ * Test that static strings are stored without copying them, and that strings
+ * copied before they were enabled are still released.
+ */
+bool test_static_strings() {
+    ArgumentParser * p = cap_parser_make_default();
+    cap_parser_set_description(p, "copied");
+    cap_parser_enable_static_strings(p, true);
+    static const char DESCRIPTION[] = "borrowed";
+    static const char FLAG[] = "--level";
+    cap_parser_set_description(p, DESCRIPTION);
+    cap_parser_set_custom_usage(p, "usage");
+    cap_parser_add_flag(p, FLAG, DT_INT, 0, 1, NULL, NULL);
+    cap_parser_enable_static_strings(p, false);
+    char alias[] = "-l";
+    cap_parser_add_flag_alias(p, FLAG, alias);
+    cap_parser_set_custom_usage(p, "copied usage");
+    bool failed = false;
+    if (p -> mDescription != DESCRIPTION || p -> mFlags[0] -> mName != FLAG) {
+        failed = true;
+    }
+    // the flag keeps its strings static
+    if (p -> mFlags[0] -> mAliases[0] != alias) {
+        failed = true;
+    }
+    const char * argv[3] = { "prog", "-l", "4" };
+    ParsingResult res = cap_parser_parse_noexit(p, 3, argv);
+    if (res.mError != PER_NO_ERROR
+            || cap_tu_as_int(cap_pa_get_flag(res.mArguments, FLAG)) != 4) {
+        failed = true;
+    }
+    cap_pa_destroy(res.mArguments);
+    cap_parser_destroy(p);
+    if (_count_allocations(true) >= _count_allocations(false)) {
+        failed = true;
+    }
+    return !failed;
+}
+
+static const char * _describe(void * context) {
+    ++*(int *) context;
+    return "provided";
+}
+
+/**
+ * Test that description providers are only called when help is printed.
+ */
+bool test_description_providers() {
+    ArgumentParser * p = cap_parser_make_default();
+    _configure(p);
+    int calls = 0;
+    cap_parser_set_description_provider(p, _describe, &calls);
+    cap_parser_set_epilogue_provider(p, _describe, &calls);
+    cap_parser_set_flag_description_provider(p, "-s", _describe, &calls);
+    cap_parser_set_flag_description_provider(p, "-h", _describe, &calls);
+    cap_parser_set_positional_description_provider(
+        p, "file", _describe, &calls);
+    bool failed = false;
+    const char * argv[4] = { "prog", "-s", "3", "a" };
+    ParsingResult res = cap_parser_parse_noexit(p, 4, argv);
+    if (res.mError != PER_NO_ERROR || calls) {
+        failed = true;
+    }
+    cap_pa_destroy(res.mArguments);
+    FILE * file = tmpfile();
+    char help[1024] = { 0 };
+    if (file) {
+        cap_parser_print_help(p, file);
+        rewind(file);
+        fread(help, 1u, sizeof(help) - 1u, file);
+        fclose(file);
+    }
+    if (calls != 5 || strstr(help, "Size of a thing") || strstr(help, "epi")) {
+        failed = true;
+    }
+    size_t count = 0u;
+    for (const char * h = strstr(help, "provided"); h;
+            h = strstr(h + 1, "provided")) {
+        ++count;
+    }
+    if (count != 5u) {
+        failed = true;
+    }
+    // without a provider, the configured description is used again
+    cap_parser_set_flag_description_provider(p, "--size", NULL, NULL);
+    if (strcmp(cap_describe(
+            p -> mFlags[0] -> mDescription,
+            p -> mFlags[0] -> mDescriptionProvider, NULL),
+            "Size of a thing")) {
+        failed = true;
+    }
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+int main() {
+    bool a;
+    a = TEST_GROUP(
+        "parser static strings", false, false, test_static_strings,
+        test_description_providers);
+    return a ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+#include "cap.h"
+#include "test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static ArgumentParser * _make_parser() {
+    ArgumentParser * p = cap_parser_make_default();
+    cap_parser_enable_packed_values(p, true);
+    cap_parser_add_flag(p, "--pool", DT_STRING, 1, 1, NULL, NULL);
+    cap_parser_add_flag(p, "--size", DT_INT, 0, 1, NULL, NULL);
+    cap_parser_add_positional(p, "command", DT_STRING, true, false, NULL, NULL);
+    cap_parser_add_positional(p, "rest", DT_STRING, false, true, NULL, NULL);
+    return p;
+}
+
+/**
+ * Test that a command string is split at whitespace, that quotes and
+ * backslashes are applied, and that only `length` characters are parsed.
+ */
+bool test_string_words() {
+    ArgumentParser * p = _make_parser();
+    char buffer[] = "  resize --pool 'a b'\t--size 10 \"c\\\"d\" e\\ f ''\n"
+        " -- -g ignored";
+    ParsingResult res = cap_parser_parse_string_noexit(
+        p, buffer, strlen(buffer) - strlen(" ignored"));
+    bool failed = false;
+    do {
+        if (res.mError != PER_NO_ERROR) FB(failed);
+        if (strcmp(cap_tu_as_string(
+                cap_pa_get_positional(res.mArguments, "command")), "resize")) {
+            FB(failed);
+        }
+        if (strcmp(cap_tu_as_string(
+                cap_pa_get_flag(res.mArguments, "--pool")), "a b")) {
+            FB(failed);
+        }
+        if (cap_tu_as_int(cap_pa_get_flag(res.mArguments, "--size")) != 10) {
+            FB(failed);
+        }
+        static const char * EXPECTED[4] = { "c\"d", "e f", "", "-g" };
+        size_t count;
+        const char * const * rest = cap_pa_get_positional_strings(
+            res.mArguments, "rest", &count);
+        if (!rest || count != 4u) FB(failed);
+        for (size_t i = 0u; i < count; ++i) {
+            if (strcmp(rest[i], EXPECTED[i])) FB(failed);
+        }
+    } while (false);
+    cap_pa_destroy(res.mArguments);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+/**
+ * Test that borrowed strings and error words point into the buffer.
+ */
+bool test_string_in_place() {
+    ArgumentParser * p = _make_parser();
+    cap_parser_enable_borrowed_strings(p, true);
+    char buffer[64];
+    bool failed = false;
+    ParsingResult res;
+    do {
+        snprintf(buffer, sizeof(buffer), "run --pool x");
+        res = cap_parser_parse_string_noexit(p, buffer, strlen(buffer));
+        if (res.mError != PER_NO_ERROR) FB(failed);
+        const char * pool = cap_tu_as_string(
+            cap_pa_get_flag(res.mArguments, "--pool"));
+        if (pool != buffer + 11 || strcmp(pool, "x")) FB(failed);
+        cap_pa_destroy(res.mArguments);
+        snprintf(buffer, sizeof(buffer), "run --pool x --size 1x");
+        res = cap_parser_parse_string_noexit(p, buffer, strlen(buffer));
+        if (res.mError != PER_CANNOT_PARSE_FLAG
+                || res.mFirstErrorWord != buffer + 13
+                || res.mSecondErrorWord != buffer + 20) {
+            FB(failed);
+        }
+        if (res.mArguments) FB(failed);
+    } while (false);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+/**
+ * Test errors of command strings.
+ */
+bool test_string_errors() {
+    ArgumentParser * p = _make_parser();
+    cap_parser_enable_exact_allocation(p, true);
+    bool failed = false;
+    char unterminated[] = "run --pool 'x";
+    ParsingResult res = cap_parser_parse_string_noexit(
+        p, unterminated, strlen(unterminated));
+    if (res.mError != PER_UNTERMINATED_QUOTE || res.mArguments) {
+        failed = true;
+    }
+    char empty[] = " \t ";
+    res = cap_parser_parse_string_noexit(p, empty, strlen(empty));
+    if (res.mError != PER_NOT_ENOUGH_POSITIONALS) {
+        failed = true;
+    }
+    char help[] = "run -h";
+    res = cap_parser_parse_string_noexit(p, help, strlen(help));
+    if (res.mError != PER_HELP) {
+        failed = true;
+    }
+    char exact[] = "run --pool y a b";
+    res = cap_parser_parse_string_noexit(p, exact, strlen(exact));
+    if (res.mError != PER_NO_ERROR
+            || cap_pa_positional_count(res.mArguments, "rest") != 2u) {
+        failed = true;
+    }
+    cap_pa_destroy(res.mArguments);
+    // the command ends at a null character
+    char ended[] = "run --pool y\0 a b";
+    res = cap_parser_parse_string_noexit(p, ended, sizeof(ended) - 1u);
+    if (res.mError != PER_NO_ERROR
+            || cap_pa_positional_count(res.mArguments, "rest") != 0u) {
+        failed = true;
+    }
+    cap_pa_destroy(res.mArguments);
+    char quoted[] = "run --pool 'y\0' a";
+    res = cap_parser_parse_string_noexit(p, quoted, sizeof(quoted) - 1u);
+    if (res.mError != PER_UNTERMINATED_QUOTE || res.mArguments) {
+        failed = true;
+    }
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+int main() {
+    bool a;
+    a = TEST_GROUP(
+        "parser string", false, false, test_string_words,
+        test_string_in_place, test_string_errors);
+    return a ? 0 : 1;
+}
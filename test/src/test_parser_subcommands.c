@@ -0,0 +1,217 @@
+#include "cap.h"
+#include "test.h"
+
+#include <string.h>
+
+/// number of times each subcommand parser was built
+static int _built[3];
+
+static void _make_commit(ArgumentParser * parser, void * context) {
+    ++*(int *) context;
+    cap_parser_add_flag(parser, "-m", DT_STRING, 1, 1, NULL, NULL);
+    cap_parser_add_positional(
+        parser, "files", DT_STRING, false, true, NULL, NULL);
+}
+
+static void _make_push(ArgumentParser * parser, void * context) {
+    ++*(int *) context;
+    cap_parser_add_flag(parser, "--force", DT_PRESENCE, 0, 1, NULL, NULL);
+    cap_parser_add_positional(
+        parser, "count", DT_INT, false, false, NULL, NULL);
+}
+
+static void _make_remote(ArgumentParser * parser, void * context) {
+    ++*(int *) context;
+    cap_parser_add_subcommand(parser, "add", _make_push, _built + 1, NULL);
+}
+
+static ArgumentParser * _make_parser() {
+    memset(_built, 0, sizeof(_built));
+    ArgumentParser * p = cap_parser_make_default();
+    cap_parser_add_flag(p, "-v", DT_PRESENCE, 0, 1, NULL, NULL);
+    cap_parser_add_subcommand(p, "commit", _make_commit, _built, "Record");
+    cap_parser_add_subcommand(p, "push", _make_push, _built + 1, NULL);
+    cap_parser_add_subcommand(p, "remote", _make_remote, _built + 2, NULL);
+    return p;
+}
+
+/**
+ * Test that words after a subcommand are parsed by its parser, which is built
+ * for each parse, or once by `cap_parser_build_subcommands`.
+ */
+bool test_subcommand_dispatch() {
+    ArgumentParser * p = _make_parser();
+    const char * argv[6] = { "prog", "-v", "commit", "-m", "text", "a.c" };
+    bool failed = false;
+    for (int i = 0; i < 4 && !failed; ++i) {
+        if (i == 2) {
+            if (_built[0] != 2 || _built[1] || _built[2]) {
+                failed = true;
+            }
+            cap_parser_build_subcommands(p);
+        }
+        ParsingResult res = cap_parser_parse_noexit(p, 6, argv);
+        const ParsedArguments * sub = cap_pa_get_subcommand_arguments(
+            res.mArguments);
+        if (res.mError != PER_NO_ERROR || !sub) {
+            failed = true;
+        }
+        else if (!cap_pa_has_flag(res.mArguments, "-v")
+                || strcmp(cap_pa_get_subcommand(res.mArguments), "commit")
+                || strcmp(cap_tu_as_string(cap_pa_get_flag(sub, "-m")), "text")
+                || strcmp(cap_tu_as_string(
+                    cap_pa_get_positional(sub, "files")), "a.c")
+                || cap_pa_get_subcommand(sub)) {
+            failed = true;
+        }
+        cap_pa_destroy(res.mArguments);
+    }
+    // "push" and "add" of "remote" share a builder
+    if (_built[0] != 3 || _built[1] != 2 || _built[2] != 1) {
+        failed = true;
+    }
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+/**
+ * Test errors before, at, and after the subcommand.
+ */
+bool test_subcommand_errors() {
+    ArgumentParser * p = _make_parser();
+    cap_parser_add_flag(p, "-C", DT_STRING, 0, 1, NULL, NULL);
+    bool failed = false;
+    const char * unknown[3] = { "prog", "-v", "pull" };
+    ParsingResult res = cap_parser_parse_noexit(p, 3, unknown);
+    if (res.mError != PER_UNKNOWN_SUBCOMMAND
+            || strcmp(res.mFirstErrorWord, "pull") || _built[0] + _built[1]) {
+        failed = true;
+    }
+    res = cap_parser_parse_noexit(p, 2, unknown);
+    if (res.mError != PER_MISSING_SUBCOMMAND) {
+        failed = true;
+    }
+    // the name of a positional of a parser which was built for the parse is
+    // released together with it
+    const char * bad_value[4] = { "prog", "push", "--force", "x" };
+    res = cap_parser_parse_noexit(p, 4, bad_value);
+    if (res.mError != PER_CANNOT_PARSE_POSITIONAL || res.mFirstErrorWord) {
+        failed = true;
+    }
+    cap_parser_build_subcommands(p);
+    const char * missing_flag[3] = { "prog", "commit", "a.c" };
+    res = cap_parser_parse_noexit(p, 3, missing_flag);
+    if (res.mError != PER_NOT_ENOUGH_FLAGS || strcmp(res.mFirstErrorWord, "-m")
+            || res.mArguments) {
+        failed = true;
+    }
+    res = cap_parser_parse_noexit(p, 4, bad_value);
+    if (res.mError != PER_CANNOT_PARSE_POSITIONAL
+            || strcmp(res.mFirstErrorWord, "count")) {
+        failed = true;
+    }
+    // the main parser has no flag --force, the subcommand has no flag -v
+    const char * misplaced[4] = { "prog", "--force", "push", "-v" };
+    res = cap_parser_parse_noexit(p, 4, misplaced);
+    if (res.mError != PER_UNKNOWN_FLAG) {
+        failed = true;
+    }
+    res = cap_parser_parse_noexit(p, 3, misplaced + 1);
+    if (res.mError != PER_UNKNOWN_FLAG || strcmp(res.mFirstErrorWord, "-v")) {
+        failed = true;
+    }
+    const char * help[3] = { "prog", "push", "-h" };
+    res = cap_parser_parse_noexit(p, 3, help);
+    if (res.mError != PER_HELP) {
+        failed = true;
+    }
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+/**
+ * Test nested subcommands, compiled parsers, reused and exactly allocated
+ * results.
+ */
+bool test_subcommand_nested() {
+    ArgumentParser * p = _make_parser();
+    cap_parser_enable_exact_allocation(p, true);
+    CompiledParser * cp = cap_parser_compile(p);
+    const char * argv[5] = { "prog", "remote", "add", "--force", "7" };
+    // the compiled parser built all parsers, "push" and "add" share a builder
+    bool failed = _built[0] != 1 || _built[1] != 2 || _built[2] != 1;
+    ParsingResult res = cap_compiled_parser_parse_noexit(cp, 5, argv);
+    const ParsedArguments * sub = cap_pa_get_subcommand_arguments(
+        cap_pa_get_subcommand_arguments(res.mArguments));
+    if (res.mError != PER_NO_ERROR || !sub
+            || strcmp(cap_pa_get_subcommand(res.mArguments), "remote")
+            || cap_tu_as_int(cap_pa_get_positional(sub, "count")) != 7
+            || !cap_pa_has_flag(sub, "--force")) {
+        failed = true;
+    }
+    cap_pa_destroy(res.mArguments);
+    // and parsing did not build them again
+    if (_built[0] != 1 || _built[1] != 2 || _built[2] != 1) {
+        failed = true;
+    }
+    ParsedArguments * args = cap_pa_make_empty();
+    res = cap_parser_parse_into_noexit(p, args, 5, argv);
+    res = cap_parser_parse_into_noexit(p, args, 2, argv);
+    if (res.mError != PER_MISSING_SUBCOMMAND
+            || strcmp(cap_pa_get_subcommand(args), "remote")
+            || cap_pa_get_subcommand(cap_pa_get_subcommand_arguments(args))) {
+        failed = true;
+    }
+    const char * push[3] = { "prog", "push", "3" };
+    res = cap_parser_parse_into_noexit(p, args, 3, push);
+    if (res.mError != PER_NO_ERROR
+            || strcmp(cap_pa_get_subcommand(args), "push")
+            || cap_tu_as_int(cap_pa_get_positional(
+                cap_pa_get_subcommand_arguments(args), "count")) != 3) {
+        failed = true;
+    }
+    cap_pa_destroy(args);
+    cap_compiled_parser_destroy(cp);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+/**
+ * Test that invalid subcommands are not configured.
+ */
+bool test_subcommand_config() {
+    ArgumentParser * p = _make_parser();
+    bool failed = false;
+    if (cap_parser_add_subcommand_noexit(p, "push", _make_push, NULL, NULL)
+            != ASE_DUPLICATE
+            || cap_parser_add_subcommand_noexit(p, "-x", _make_push, NULL, NULL)
+            != ASE_INVALID_PREFIX
+            || cap_parser_add_subcommand_noexit(p, "", _make_push, NULL, NULL)
+            != ASE_MISSING_NAME
+            || cap_parser_add_subcommand_noexit(p, "tag", NULL, NULL, NULL)
+            != ASE_MISSING_BUILDER) {
+        failed = true;
+    }
+    if (cap_parser_add_positional_noexit(
+            p, "file", DT_STRING, true, false, NULL, NULL) != APE_SUBCOMMANDS) {
+        failed = true;
+    }
+    ArgumentParser * q = cap_parser_make_default();
+    cap_parser_add_positional(q, "file", DT_STRING, true, false, NULL, NULL);
+    if (cap_parser_add_subcommand_noexit(q, "tag", _make_push, NULL, NULL)
+            != ASE_POSITIONALS) {
+        failed = true;
+    }
+    cap_parser_destroy(q);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+int main() {
+    bool a;
+    a = TEST_GROUP(
+        "parser subcommands", false, false, test_subcommand_dispatch,
+        test_subcommand_errors, test_subcommand_nested,
+        test_subcommand_config);
+    return a ? 0 : 1;
+}
@@ -0,0 +1,152 @@
+#include "cap.h"
+#include "test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define WORD_COUNT 100000
+#define WORD_SIZE 24
+
+static char _storage[WORD_COUNT][WORD_SIZE];
+static const char * _words[WORD_COUNT];
+
+static ArgumentParser * _make_parser(DataType type, bool pack) {
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_enable_packed_values(p, pack);
+    cap_parser_add_flag(p, "-n", DT_PRESENCE, 0, -1, NULL, NULL);
+    cap_parser_add_positional(p, "values", type, true, true, NULL, NULL);
+    return p;
+}
+
+static void _make_words(bool doubles) {
+    // runs of numbers of different lengths, separated by flags
+    _words[0] = "prog";
+    for (int i = 1; i < WORD_COUNT; ++i) {
+        if (i % 40000 == 0) {
+            _words[i] = "-n";
+            continue;
+        }
+        if (doubles) {
+            snprintf(_storage[i], WORD_SIZE, "%d.%de%d", i, i % 7, i % 5 - 2);
+        }
+        else {
+            snprintf(_storage[i], WORD_SIZE, "%d", i * (i % 3 * 9000 + 1));
+        }
+        _words[i] = _storage[i];
+    }
+}
+
+static bool _same_results(
+        ParsingResult expected, ParsingResult actual, DataType type) {
+    if (expected.mError != actual.mError
+            || expected.mSecondErrorWord != actual.mSecondErrorWord) {
+        return false;
+    }
+    size_t expected_count;
+    size_t actual_count;
+    if (!cap_pa_get_positional_ints(expected.mArguments, "values", NULL)
+            && !cap_pa_get_positional_doubles(
+                expected.mArguments, "values", NULL)) {
+        // not packed
+        expected_count = cap_pa_positional_count(
+            expected.mArguments, "values");
+        actual_count = cap_pa_positional_count(actual.mArguments, "values");
+        if (expected_count != actual_count) {
+            return false;
+        }
+        const TypedUnion * e = cap_pa_get_positional(
+            expected.mArguments, "values");
+        const TypedUnion * a = cap_pa_get_positional(
+            actual.mArguments, "values");
+        for (size_t i = 0u; i < expected_count; ++i) {
+            if (type == DT_INT
+                    ? cap_tu_as_int(e + i) != cap_tu_as_int(a + i)
+                    : cap_tu_as_double(e + i) != cap_tu_as_double(a + i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (type == DT_INT) {
+        const int * e = cap_pa_get_positional_ints(
+            expected.mArguments, "values", &expected_count);
+        const int * a = cap_pa_get_positional_ints(
+            actual.mArguments, "values", &actual_count);
+        return expected_count == actual_count
+            && (!expected_count || !memcmp(e, a, expected_count * sizeof(int)));
+    }
+    const double * e = cap_pa_get_positional_doubles(
+        expected.mArguments, "values", &expected_count);
+    const double * a = cap_pa_get_positional_doubles(
+        actual.mArguments, "values", &actual_count);
+    return expected_count == actual_count
+        && (!expected_count || !memcmp(e, a, expected_count * sizeof(double)));
+}
+
+static bool _compare_thread_counts(DataType type, int argc, bool pack) {
+    ArgumentParser * p = _make_parser(type, pack);
+    bool failed = false;
+    ParsingResult expected = cap_parser_parse_noexit(p, argc, _words);
+    if (expected.mError != PER_NO_ERROR
+            && expected.mError != PER_CANNOT_PARSE_POSITIONAL
+            && expected.mError != PER_POSITIONAL_OUT_OF_RANGE) {
+        failed = true;
+    }
+    static const size_t THREAD_COUNTS[4] = { 2u, 3u, 4u, 16u };
+    for (size_t i = 0u; i < 4u && !failed; ++i) {
+        cap_parser_set_thread_count(p, THREAD_COUNTS[i]);
+        ParsingResult actual = cap_parser_parse_noexit(p, argc, _words);
+        failed = !_same_results(expected, actual, type);
+        cap_pa_destroy(actual.mArguments);
+    }
+    cap_pa_destroy(expected.mArguments);
+    cap_parser_destroy(p);
+    return !failed;
+}
+
+/**
+ * Test that values converted on several threads are identical to the ones
+ * converted on one thread.
+ */
+bool test_threads_values() {
+    _make_words(false);
+    if (!_compare_thread_counts(DT_INT, WORD_COUNT, true)
+            || !_compare_thread_counts(DT_INT, WORD_COUNT, false)) {
+        return false;
+    }
+    _make_words(true);
+    return _compare_thread_counts(DT_DOUBLE, WORD_COUNT, true)
+        && _compare_thread_counts(DT_DOUBLE, WORD_COUNT, false)
+        && _compare_thread_counts(DT_DOUBLE, 100, true);
+}
+
+/**
+ * Test that the first word which cannot be converted is reported, wherever it
+ * is in a run.
+ */
+bool test_threads_errors() {
+    _make_words(false);
+    static const int BAD_INDICES[4] = { 39999, 50000, 70001, 99999 };
+    for (size_t i = 0u; i < 4u; ++i) {
+        const int bad = BAD_INDICES[i];
+        const int later = (bad + 20000) % WORD_COUNT;
+        _words[bad] = i % 2 ? "99999999999" : "1x";
+        // a second error in another slice
+        _words[later] = "2x";
+        const bool same = _compare_thread_counts(DT_INT, WORD_COUNT, i < 2u);
+        _words[bad] = _storage[bad];
+        _words[later] = _storage[later];
+        if (!same) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    bool a;
+    a = TEST_GROUP(
+        "parser threads", false, false, test_threads_values,
+        test_threads_errors);
+    return a ? 0 : 1;
+}
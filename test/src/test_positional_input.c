@@ -0,0 +1,223 @@
+#include "cap.h"
+#include "test.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PATH "test/bin/positional_input.txt"
+#define NUMBER_COUNT 300000
+
+static int _open_input(const char * contents, size_t size) {
+    FILE * file = fopen(PATH, "wb");
+    fwrite(contents, 1u, size, file);
+    fclose(file);
+    return open(PATH, O_RDONLY);
+}
+
+static int _open_numbers(int bad_index) {
+    // more than one chunk of newline-delimited numbers, without a final
+    // delimiter
+    FILE * file = fopen(PATH, "wb");
+    for (int i = 0; i < NUMBER_COUNT; ++i) {
+        fprintf(file, i == bad_index ? "12x" : "%d", i * 3);
+        if (i + 1 < NUMBER_COUNT) {
+            fputc('\n', file);
+        }
+    }
+    fclose(file);
+    return open(PATH, O_RDONLY);
+}
+
+/**
+ * Test that null-delimited records are appended after the command line
+ * values, that they are never flags, that empty records are kept and that
+ * borrowed strings stay valid.
+ */
+bool test_input_null_delimited() {
+    static const char CONTENTS[] = "a b\0-v\0\0last";
+    const int fd = _open_input(CONTENTS, sizeof(CONTENTS) - 1u);
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_enable_packed_values(p, true);
+    cap_parser_add_flag(p, "-v", DT_PRESENCE, 0, 1, NULL, NULL);
+    cap_parser_add_positional(p, "first", DT_STRING, true, false, NULL, NULL);
+    cap_parser_add_positional(p, "words", DT_STRING, false, true, NULL, NULL);
+    cap_parser_set_positional_input(p, "words", fd, '\0');
+    const char * a[4] = {"prog", "one", "-v", "two"};
+    bool failed = false;
+    for (int borrow = 0; borrow < 2 && !failed; ++borrow) {
+        cap_parser_enable_borrowed_strings(p, borrow);
+        lseek(fd, 0, SEEK_SET);
+        ParsingResult res = cap_parser_parse_noexit(p, 4, a);
+        do {
+            if (res.mError != PER_NO_ERROR) FB(failed);
+            if (!cap_pa_has_flag(res.mArguments, "-v")) FB(failed);
+            static const char * EXPECTED[5] = {
+                "two", "a b", "-v", "", "last"
+            };
+            size_t count;
+            const char * const * words = cap_pa_get_positional_strings(
+                res.mArguments, "words", &count);
+            if (!words || count != 5u) FB(failed);
+            for (size_t i = 0u; i < count; ++i) {
+                if (strcmp(words[i], EXPECTED[i])) FB(failed);
+            }
+        } while (false);
+        cap_pa_destroy(res.mArguments);
+    }
+    cap_parser_destroy(p);
+    close(fd);
+    remove(PATH);
+    return !failed;
+}
+
+/**
+ * Test that numeric records are converted across chunks of the input, and
+ * that a record which cannot be converted is reported as "(input)".
+ */
+bool test_input_numbers() {
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_enable_packed_values(p, true);
+    cap_parser_add_positional(p, "nums", DT_INT, true, true, NULL, NULL);
+    const char * a[2] = {"prog", "5"};
+    bool failed = false;
+    for (int exact = 0; exact < 2 && !failed; ++exact) {
+        cap_parser_enable_exact_allocation(p, exact);
+        const int fd = _open_numbers(-1);
+        cap_parser_set_positional_input(p, "nums", fd, '\n');
+        ParsingResult res = cap_parser_parse_noexit(p, 2, a);
+        do {
+            if (res.mError != PER_NO_ERROR) FB(failed);
+            size_t count;
+            const int * nums = cap_pa_get_positional_ints(
+                res.mArguments, "nums", &count);
+            if (!nums || count != NUMBER_COUNT + 1u || nums[0] != 5) {
+                FB(failed);
+            }
+            for (size_t i = 1u; i < count; ++i) {
+                if (nums[i] != (int) (i - 1u) * 3) FB(failed);
+            }
+        } while (false);
+        cap_pa_destroy(res.mArguments);
+        close(fd);
+    }
+    const int fd = _open_numbers(NUMBER_COUNT - 5);
+    cap_parser_set_positional_input(p, "nums", fd, '\n');
+    ParsingResult res = cap_parser_parse_noexit(p, 1, a);
+    if (res.mError != PER_CANNOT_PARSE_POSITIONAL
+            || strcmp(res.mFirstErrorWord, "nums")
+            || strcmp(res.mSecondErrorWord, "(input)")) {
+        failed = true;
+    }
+    close(fd);
+    cap_parser_destroy(p);
+    remove(PATH);
+    return !failed;
+}
+
+/**
+ * Test that an input which cannot be read, and positionals missing before
+ * the one reading input, are reported.
+ */
+bool test_input_errors() {
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_add_positional(p, "first", DT_STRING, true, false, NULL, NULL);
+    cap_parser_add_positional(p, "words", DT_STRING, true, true, NULL, NULL);
+    bool failed = false;
+    const char * a[2] = {"prog", "one"};
+    // a directory cannot be read
+    const int dir = open("test", O_RDONLY);
+    cap_parser_set_positional_input(p, "words", dir, '\0');
+    ParsingResult res = cap_parser_parse_noexit(p, 2, a);
+    if (res.mError != PER_CANNOT_READ_INPUT
+            || strcmp(res.mFirstErrorWord, "words")) {
+        failed = true;
+    }
+    ParserIterator * iter = cap_parser_iter_begin(p, 2, a);
+    ParsedItem item;
+    while (cap_parser_iter_next_noexit(iter, &item)) {
+    }
+    if (cap_parser_iter_result(iter).mError != PER_CANNOT_READ_INPUT) {
+        failed = true;
+    }
+    cap_parser_iter_end(iter);
+    close(dir);
+    // records do not fill the positionals before the one reading input
+    const int fd = _open_input("a\nb\n", 4u);
+    cap_parser_set_positional_input(p, "words", fd, '\n');
+    res = cap_parser_parse_noexit(p, 1, a);
+    if (res.mError != PER_NOT_ENOUGH_POSITIONALS) {
+        failed = true;
+    }
+    iter = cap_parser_iter_begin(p, 1, a);
+    while (cap_parser_iter_next_noexit(iter, &item)) {
+        failed = true;
+    }
+    if (cap_parser_iter_result(iter).mError != PER_NOT_ENOUGH_POSITIONALS) {
+        failed = true;
+    }
+    cap_parser_iter_end(iter);
+    // an empty input gives no values
+    close(fd);
+    const int empty = _open_input("", 0u);
+    cap_parser_set_positional_input(p, "words", empty, '\n');
+    res = cap_parser_parse_noexit(p, 2, a);
+    if (res.mError != PER_NOT_ENOUGH_POSITIONALS) {
+        failed = true;
+    }
+    close(empty);
+    cap_parser_destroy(p);
+    remove(PATH);
+    return !failed;
+}
+
+/**
+ * Test that an iterator yields the records after the command line values,
+ * across chunks of the input.
+ */
+bool test_input_iterator() {
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_add_flag(p, "-v", DT_PRESENCE, 0, 1, NULL, NULL);
+    cap_parser_add_positional(p, "nums", DT_INT, false, true, NULL, NULL);
+    const int fd = _open_numbers(-1);
+    cap_parser_set_positional_input(p, "nums", fd, '\n');
+    const char * a[3] = {"prog", "-v", "7"};
+    ParserIterator * iter = cap_parser_iter_begin(p, 3, a);
+    ParsedItem item;
+    bool failed = false;
+    int count = 0;
+    bool flag = false;
+    while (cap_parser_iter_next_noexit(iter, &item)) {
+        if (item.mIsFlag) {
+            flag = count == 0;
+            continue;
+        }
+        const int expected = count ? (count - 1) * 3 : 7;
+        if (cap_tu_as_int(&(item.mValue)) != expected) {
+            failed = true;
+            break;
+        }
+        ++count;
+    }
+    if (!flag || count != NUMBER_COUNT + 1) {
+        failed = true;
+    }
+    if (cap_parser_iter_result(iter).mError != PER_NO_ERROR) {
+        failed = true;
+    }
+    cap_parser_iter_end(iter);
+    close(fd);
+    cap_parser_destroy(p);
+    remove(PATH);
+    return !failed;
+}
+
+int main() {
+    bool a;
+    a = TEST_GROUP(
+        "positional input", false, false, test_input_null_delimited,
+        test_input_numbers, test_input_errors, test_input_iterator);
+    return a ? 0 : 1;
+}
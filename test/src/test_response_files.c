@@ -0,0 +1,262 @@
+#include "cap.h"
+#include "test.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PATH_1 "test/bin/response_file_1.txt"
+#define PATH_2 "test/bin/response_file_2.txt"
+
+static void _write_file(const char * path, const char * contents, size_t size) {
+    FILE * file = fopen(path, "wb");
+    fwrite(contents, 1u, size, file);
+    fclose(file);
+}
+
+/**
+ * Test that words are delimited by whitespace, and that quotes and
+ * backslashes are applied.
+ */
+bool test_rf_whitespace() {
+    static const char CONTENTS[] =
+        "-n 5\n\t'a  b' \"c \\\"d\\\" \\\\e\" f\\ g\r\n  h'i'\"j\" ''";
+    _write_file(PATH_1, CONTENTS, sizeof(CONTENTS) - 1u);
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_enable_packed_values(p, true);
+    cap_parser_enable_response_files(p, true);
+    cap_parser_add_flag(p, "-n", DT_INT, 0, 1, NULL, NULL);
+    cap_parser_add_positional(p, "words", DT_STRING, true, true, NULL, NULL);
+    const char * a[4] = {"prog", "first", "@" PATH_1, "last"};
+    ParsingResult res = cap_parser_parse_noexit(p, 4, a);
+    bool failed = false;
+    do {
+        if (res.mError != PER_NO_ERROR) FB(failed);
+        if (cap_tu_as_int(cap_pa_get_flag(res.mArguments, "-n")) != 5) {
+            FB(failed);
+        }
+        static const char * EXPECTED[7] = {
+            "first", "a  b", "c \"d\" \\e", "f g", "hij", "", "last"
+        };
+        size_t count;
+        const char * const * words = cap_pa_get_positional_strings(
+            res.mArguments, "words", &count);
+        if (!words || count != 7u) FB(failed);
+        for (size_t i = 0u; i < count; ++i) {
+            if (strcmp(words[i], EXPECTED[i])) FB(failed);
+        }
+    } while (false);
+    cap_pa_destroy(res.mArguments);
+    cap_parser_destroy(p);
+    remove(PATH_1);
+    return !failed;
+}
+
+/**
+ * Test that words are delimited by null characters if there are any, and
+ * that words of several files and of the command line are parsed in order.
+ */
+bool test_rf_null_delimited() {
+    // the words before the first null character are split as if the file
+    // was delimited by whitespace, until it is found
+    static const char CONTENTS[] = " 'a' \"b\\\0-n\0" "7\0'c'";
+    _write_file(PATH_1, CONTENTS, sizeof(CONTENTS) - 1u);
+    _write_file(PATH_2, "d e", 3u);
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_enable_packed_values(p, true);
+    cap_parser_enable_response_files(p, true);
+    cap_parser_enable_borrowed_strings(p, true);
+    cap_parser_add_flag(p, "-n", DT_INT, 0, 1, NULL, NULL);
+    cap_parser_add_positional(p, "words", DT_STRING, true, true, NULL, NULL);
+    const char * a[4] = {"prog", "@" PATH_2, "@" PATH_1, "f"};
+    ParsingResult res = cap_parser_parse_noexit(p, 4, a);
+    bool failed = false;
+    do {
+        if (res.mError != PER_NO_ERROR) FB(failed);
+        if (cap_tu_as_int(cap_pa_get_flag(res.mArguments, "-n")) != 7) {
+            FB(failed);
+        }
+        static const char * EXPECTED[5] = {
+            "d", "e", " 'a' \"b\\", "'c'", "f"
+        };
+        size_t count;
+        const char * const * words = cap_pa_get_positional_strings(
+            res.mArguments, "words", &count);
+        if (!words || count != 5u) FB(failed);
+        for (size_t i = 0u; i < count; ++i) {
+            if (strcmp(words[i], EXPECTED[i])) FB(failed);
+        }
+    } while (false);
+    cap_pa_destroy(res.mArguments);
+    cap_parser_destroy(p);
+    remove(PATH_1);
+    remove(PATH_2);
+    return !failed;
+}
+
+/**
+ * Test that numeric words of a file are converted in batches, across chunk
+ * boundaries and together with words of the command line, also with exact
+ * allocation and when parsing into an existing object.
+ */
+bool test_rf_numbers() {
+    enum { COUNT = 1000 };
+    char * contents = (char *) malloc(COUNT * 8u);
+    size_t size = 0u;
+    for (int i = 0; i < COUNT; ++i) {
+        size += (size_t) sprintf(contents + size, "%d\n", i * 3);
+    }
+    _write_file(PATH_1, contents, size);
+    free(contents);
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_enable_packed_values(p, true);
+    cap_parser_enable_response_files(p, true);
+    cap_parser_add_positional(p, "nums", DT_INT, true, true, NULL, NULL);
+    const char * a[5] = {"prog", "1", "@" PATH_1, "@" PATH_1, "2"};
+    ParsedArguments * reused = cap_pa_make_empty();
+    bool failed = false;
+    for (int round = 0; round < 3 && !failed; ++round) {
+        cap_parser_enable_exact_allocation(p, round == 1);
+        ParsingResult res = round == 2
+            ? cap_parser_parse_into_noexit(p, reused, 5, a)
+            : cap_parser_parse_noexit(p, 5, a);
+        do {
+            if (res.mError != PER_NO_ERROR) FB(failed);
+            size_t count;
+            const int * nums = cap_pa_get_positional_ints(
+                res.mArguments, "nums", &count);
+            if (!nums || count != 2u * COUNT + 2u) FB(failed);
+            if (nums[0] != 1 || nums[count - 1u] != 2) FB(failed);
+            for (size_t i = 0u; i < 2u * COUNT; ++i) {
+                if (nums[i + 1u] != (int) (i % COUNT) * 3) FB(failed);
+            }
+        } while (false);
+        if (round != 2) {
+            cap_pa_destroy(res.mArguments);
+        }
+    }
+    cap_pa_destroy(reused);
+    cap_parser_destroy(p);
+    remove(PATH_1);
+    return !failed;
+}
+
+/**
+ * Test files which are empty, or whose size is a multiple of the page size.
+ */
+bool test_rf_sizes() {
+    enum { SIZE = 65536 };
+    char * contents = (char *) malloc(SIZE);
+    memset(contents, ' ', SIZE);
+    memcpy(contents + SIZE - 3u, "end", 3u);
+    _write_file(PATH_1, contents, SIZE);
+    free(contents);
+    _write_file(PATH_2, "", 0u);
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_enable_packed_values(p, true);
+    cap_parser_enable_response_files(p, true);
+    cap_parser_add_positional(p, "words", DT_STRING, true, true, NULL, NULL);
+    const char * a[3] = {"prog", "@" PATH_2, "@" PATH_1};
+    ParsingResult res = cap_parser_parse_noexit(p, 3, a);
+    bool failed = false;
+    do {
+        if (res.mError != PER_NO_ERROR) FB(failed);
+        size_t count;
+        const char * const * words = cap_pa_get_positional_strings(
+            res.mArguments, "words", &count);
+        if (!words || count != 1u || strcmp(*words, "end")) FB(failed);
+        cap_pa_destroy(res.mArguments);
+        // only empty files
+        res = cap_parser_parse_noexit(p, 2, a);
+        if (res.mError != PER_NOT_ENOUGH_POSITIONALS) FB(failed);
+    } while (false);
+    cap_parser_destroy(p);
+    remove(PATH_1);
+    remove(PATH_2);
+    return !failed;
+}
+
+/**
+ * Test that words are only expanded when response files are enabled, and
+ * only before the flag separator.
+ */
+bool test_rf_not_expanded() {
+    _write_file(PATH_1, "x", 1u);
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_enable_packed_values(p, true);
+    cap_parser_set_flag_separator(p, "--", NULL);
+    cap_parser_add_positional(p, "words", DT_STRING, true, true, NULL, NULL);
+    const char * a[5] = {"prog", "@" PATH_1, "@", "--", "@" PATH_1};
+    bool failed = false;
+    ParsingResult res = cap_parser_parse_noexit(p, 5, a);
+    do {
+        size_t count;
+        const char * const * words = cap_pa_get_positional_strings(
+            res.mArguments, "words", &count);
+        if (!words || count != 3u || strcmp(words[0], a[1])) FB(failed);
+        cap_pa_destroy(res.mArguments);
+        cap_parser_enable_response_files(p, true);
+        res = cap_parser_parse_noexit(p, 5, a);
+        words = cap_pa_get_positional_strings(
+            res.mArguments, "words", &count);
+        if (!words || count != 3u) FB(failed);
+        if (strcmp(words[0], "x") || strcmp(words[1], "@")) FB(failed);
+        if (strcmp(words[2], a[4])) FB(failed);
+    } while (false);
+    cap_pa_destroy(res.mArguments);
+    cap_parser_destroy(p);
+    remove(PATH_1);
+    return !failed;
+}
+
+/**
+ * Test errors caused by files, and errors caused by their words.
+ */
+bool test_rf_errors() {
+    ArgumentParser * p = cap_parser_make_empty();
+    cap_parser_enable_response_files(p, true);
+    cap_parser_add_flag(p, "-n", DT_INT, 0, 1, NULL, NULL);
+    cap_parser_add_positional(p, "nums", DT_DOUBLE, true, true, NULL, NULL);
+    const char * a[3] = {"prog", "1", "@" PATH_1};
+    bool failed = false;
+    ParsedArguments * reused = cap_pa_make_empty();
+    do {
+        remove(PATH_1);
+        ParsingResult res = cap_parser_parse_noexit(p, 3, a);
+        if (res.mError != PER_CANNOT_READ_RESPONSE_FILE) FB(failed);
+        if (strcmp(res.mFirstErrorWord, PATH_1)) FB(failed);
+        if (res.mArguments) FB(failed);
+        _write_file(PATH_1, "2 \"3", 4u);
+        res = cap_parser_parse_noexit(p, 3, a);
+        if (res.mError != PER_INVALID_RESPONSE_FILE) FB(failed);
+        if (strcmp(res.mFirstErrorWord, PATH_1)) FB(failed);
+        // words of a released file are replaced by the argument naming it
+        _write_file(PATH_1, "2 3x", 4u);
+        res = cap_parser_parse_noexit(p, 3, a);
+        if (res.mError != PER_CANNOT_PARSE_POSITIONAL) FB(failed);
+        if (res.mSecondErrorWord != a[2]) FB(failed);
+        _write_file(PATH_1, "2 -n", 4u);
+        res = cap_parser_parse_noexit(p, 3, a);
+        if (res.mError != PER_MISSING_FLAG_VALUE) FB(failed);
+        if (res.mFirstErrorWord != a[2]) FB(failed);
+        // the words stay valid as long as a reused object
+        _write_file(PATH_1, "2 -n 1e3", 8u);
+        res = cap_parser_parse_into_noexit(p, reused, 3, a);
+        if (res.mError != PER_CANNOT_PARSE_FLAG) FB(failed);
+        if (strcmp(res.mFirstErrorWord, "-n")) FB(failed);
+        if (strcmp(res.mSecondErrorWord, "1e3")) FB(failed);
+    } while (false);
+    cap_pa_destroy(reused);
+    cap_parser_destroy(p);
+    remove(PATH_1);
+    return !failed;
+}
+
+int main() {
+    bool a;
+    a = TEST_GROUP(
+        "response files", false, false, test_rf_whitespace,
+        test_rf_null_delimited, test_rf_numbers, test_rf_sizes,
+        test_rf_not_expanded, test_rf_errors);
+    return a ? 0 : 1;
+}
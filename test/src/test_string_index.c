@@ -0,0 +1,117 @@
+#include "cap.h"
+#include "test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Test that an empty index does not contain anything.
+ */
+bool test_si_empty() {
+    StringIndex * si = cap_si_make_empty();
+    bool failed = false;
+    do {
+        if (cap_si_length(si) != 0u) FB(failed);
+        if (cap_si_find(si, "-a", NULL)) FB(failed);
+        if (cap_si_find(si, "", NULL)) FB(failed);
+        if (cap_si_find(si, NULL, NULL)) FB(failed);
+    } while (false);
+    cap_si_destroy(si);
+    return !failed;
+}
+
+/**
+ * Test inserting and finding a few keys, including replacing a value.
+ */
+bool test_si_insert_find() {
+    const char * const keys[4] = {"-a", "--alpha", "-b", "--beta"};
+    StringIndex * si = cap_si_make_empty();
+    bool failed = false;
+    do {
+        for (size_t i = 0; i < 4; ++i) {
+            cap_si_insert(si, keys[i], i);
+        }
+        if (cap_si_length(si) != 4u) FB(failed);
+        for (size_t i = 0; i < 4; ++i) {
+            size_t v = 1000u;
+            if (!cap_si_find(si, keys[i], &v)) FB(failed);
+            if (v != i) FB(failed);
+        }
+        if (failed) break;
+        if (cap_si_find(si, "-c", NULL)) FB(failed);
+
+        cap_si_insert(si, "-a", 42u);
+        size_t v = 0u;
+        if (cap_si_length(si) != 4u) FB(failed);
+        if (!cap_si_find(si, "-a", &v)) FB(failed);
+        if (v != 42u) FB(failed);
+    } while (false);
+    cap_si_destroy(si);
+    return !failed;
+}
+
+/**
+ * Test that many keys survive growing the table.
+ */
+bool test_si_many_keys() {
+    static const size_t COUNT = 5000u;
+    char (* keys)[16] = malloc(COUNT * sizeof(*keys));
+    StringIndex * si = cap_si_make_empty();
+    bool failed = false;
+    for (size_t i = 0; i < COUNT; ++i) {
+        sprintf(keys[i], "--flag-%zu", i);
+        cap_si_insert(si, keys[i], i);
+    }
+    do {
+        if (cap_si_length(si) != COUNT) FB(failed);
+        for (size_t i = 0; i < COUNT; ++i) {
+            size_t v;
+            if (!cap_si_find(si, keys[i], &v) || v != i) FB(failed);
+        }
+        if (cap_si_find(si, "--flag-5000", NULL)) FB(failed);
+    } while (false);
+    cap_si_destroy(si);
+    free(keys);
+    return !failed;
+}
+
+/**
+ * Test removing keys.
+ *
+ * Remove every other key out of many. The remaining keys must still be found
+ * (removal must not break probe sequences of other keys).
+ */
+bool test_si_remove() {
+    static const size_t COUNT = 1000u;
+    char (* keys)[16] = malloc(COUNT * sizeof(*keys));
+    StringIndex * si = cap_si_make_empty();
+    bool failed = false;
+    for (size_t i = 0; i < COUNT; ++i) {
+        sprintf(keys[i], "-%zu", i);
+        cap_si_insert(si, keys[i], i);
+    }
+    for (size_t i = 0; i < COUNT; i += 2) {
+        cap_si_remove(si, keys[i]);
+    }
+    cap_si_remove(si, "not there");
+    do {
+        if (cap_si_length(si) != COUNT / 2u) FB(failed);
+        for (size_t i = 0; i < COUNT; ++i) {
+            size_t v;
+            const bool found = cap_si_find(si, keys[i], &v);
+            if (found != (i % 2u == 1u)) FB(failed);
+            if (found && v != i) FB(failed);
+        }
+    } while (false);
+    cap_si_destroy(si);
+    free(keys);
+    return !failed;
+}
+
+int main() {
+    bool a;
+    a = TEST_GROUP(
+        "si: string index", false, false, test_si_empty,
+        test_si_insert_find, test_si_many_keys, test_si_remove);
+    return a ? 0 : 1;
+}